@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import com.google.caliper.Param;
+import com.google.caliper.SimpleBenchmark;
+
+import java.util.Arrays;
+
+public class ArrayIntrinsicsBenchmark extends SimpleBenchmark {
+  @Param({"8", "64", "4096"})
+  private int size;
+
+  private byte[] bytes1;
+  private byte[] bytes2;
+  private char[] chars1;
+  private char[] chars2;
+  private int[] ints1;
+  private int[] ints2;
+  private long[] longs1;
+  private long[] longs2;
+
+  @Override
+  protected void setUp() {
+    bytes1 = new byte[size];
+    bytes2 = new byte[size];
+    chars1 = new char[size];
+    chars2 = new char[size];
+    ints1 = new int[size];
+    ints2 = new int[size];
+    longs1 = new long[size];
+    longs2 = new long[size];
+    for (int i = 0; i < size; i++) {
+      bytes1[i] = bytes2[i] = (byte) i;
+      chars1[i] = chars2[i] = (char) i;
+      ints1[i] = ints2[i] = i;
+      longs1[i] = longs2[i] = i;
+    }
+  }
+
+  public void timeArrayCopyByte(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      System.arraycopy(bytes1, 0, bytes2, 0, size);
+    }
+  }
+
+  public void timeArrayCopyChar(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      System.arraycopy(chars1, 0, chars2, 0, size);
+    }
+  }
+
+  public void timeArrayCopyInt(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      System.arraycopy(ints1, 0, ints2, 0, size);
+    }
+  }
+
+  public void timeArrayCopyLong(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      System.arraycopy(longs1, 0, longs2, 0, size);
+    }
+  }
+
+  public void timeFillByte(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      Arrays.fill(bytes2, (byte) rep);
+    }
+  }
+
+  public void timeFillChar(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      Arrays.fill(chars2, (char) rep);
+    }
+  }
+
+  public void timeFillInt(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      Arrays.fill(ints2, rep);
+    }
+  }
+
+  public void timeFillLong(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      Arrays.fill(longs2, rep);
+    }
+  }
+
+  public boolean timeEqualsByte(int reps) {
+    boolean result = true;
+    for (int rep = 0; rep < reps; rep++) {
+      result &= Arrays.equals(bytes1, bytes2);
+    }
+    return result;
+  }
+
+  public boolean timeEqualsChar(int reps) {
+    boolean result = true;
+    for (int rep = 0; rep < reps; rep++) {
+      result &= Arrays.equals(chars1, chars2);
+    }
+    return result;
+  }
+
+  public boolean timeEqualsInt(int reps) {
+    boolean result = true;
+    for (int rep = 0; rep < reps; rep++) {
+      result &= Arrays.equals(ints1, ints2);
+    }
+    return result;
+  }
+
+  public boolean timeEqualsLong(int reps) {
+    boolean result = true;
+    for (int rep = 0; rep < reps; rep++) {
+      result &= Arrays.equals(longs1, longs2);
+    }
+    return result;
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.SimpleBenchmark;
+
+public class SchedulingBenchmark extends SimpleBenchmark {
+  private static final int ARRAY_SIZE = 1024;
+
+  private final int[] ints = new int[ARRAY_SIZE];
+  private final double[] doubles = new double[ARRAY_SIZE];
+  private int intField = 3;
+  private double doubleField = 1.5;
+
+  public SchedulingBenchmark() {
+    for (int i = 0; i < ARRAY_SIZE; i++) {
+      ints[i] = i + 1;
+      doubles[i] = i + 0.5;
+    }
+  }
+
+  // The loads of the elements are independent of the arithmetic on the
+  // previous ones.
+  public int timeLoadsAndArithmetic(int reps) {
+    int result = 0;
+    for (int rep = 0; rep < reps; rep++) {
+      int[] array = ints;
+      for (int i = 0; i + 1 < array.length; i += 2) {
+        int x = (result << 1) ^ intField;
+        int a = array[i];
+        int b = array[i + 1];
+        result = x + a * b;
+      }
+    }
+    return result;
+  }
+
+  // The divisions do not depend on each other, nor on the additions.
+  public int timeIntegerDivisions(int reps) {
+    int result = 0;
+    for (int rep = 0; rep < reps; rep++) {
+      for (int i = 1; i < ARRAY_SIZE; i++) {
+        int sum = result + i;
+        sum = sum ^ (sum >>> 3);
+        int quotient1 = 1000000 / i;
+        int quotient2 = 999999 / (i + 1);
+        result = sum + quotient1 + quotient2;
+      }
+    }
+    return result;
+  }
+
+  public double timeDoubleDivisions(int reps) {
+    double result = 0.0;
+    for (int rep = 0; rep < reps; rep++) {
+      double[] array = doubles;
+      for (int i = 0; i < array.length; i++) {
+        double scaled = result * 0.5 + doubleField;
+        double quotient = 1.0 / array[i];
+        result = scaled + quotient;
+      }
+    }
+    return result;
+  }
+
+  // Two independent multiply-add chains, interleaved by the scheduler.
+  public double timeMultiplyAddChains(int reps) {
+    double result = 0.0;
+    for (int rep = 0; rep < reps; rep++) {
+      double[] array = doubles;
+      for (int i = 0; i + 1 < array.length; i += 2) {
+        double a = array[i] * 1.0001 + 0.5;
+        a = a * 0.9999 + 0.25;
+        double b = array[i + 1] * 1.0002 + 0.75;
+        b = b * 0.9998 + 0.125;
+        result += a * b;
+      }
+    }
+    return result;
+  }
+}
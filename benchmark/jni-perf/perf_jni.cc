@@ -34,6 +34,16 @@ extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfSOAUncheckedCall(JNI
   ScopedObjectAccessUnchecked soa(Thread::Current());
 }
 
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfJniStaticCall(JNIEnv*, jclass,
+                                                                         jint a, jint b) {
+  return a ^ b;
+}
+
+// Critical natives take no JNIEnv* and no jclass.
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfJniCriticalCall(jint a, jint b) {
+  return a ^ b;
+}
+
 }  // namespace
 
 }  // namespace art
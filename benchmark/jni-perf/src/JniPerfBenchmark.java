@@ -15,6 +15,7 @@
  */
 
 import com.google.caliper.SimpleBenchmark;
+import dalvik.annotation.optimization.CriticalNative;
 
 public class JniPerfBenchmark extends SimpleBenchmark {
   private static final String MSG = "ABCDE";
@@ -22,6 +23,9 @@ public class JniPerfBenchmark extends SimpleBenchmark {
   native void perfJniEmptyCall();
   native void perfSOACall();
   native void perfSOAUncheckedCall();
+  static native int perfJniStaticCall(int a, int b);
+  @CriticalNative
+  static native int perfJniCriticalCall(int a, int b);
 
   public void timeFastJNI(int N) {
     // TODO: This might be an intrinsic.
@@ -48,6 +52,21 @@ public class JniPerfBenchmark extends SimpleBenchmark {
     }
   }
 
+  // A regular static native, the baseline for the critical native with the same signature.
+  public void timeStaticCall(int N) {
+    int result = 0;
+    for (int i = 0; i < N; i++) {
+      result = perfJniStaticCall(result, i);
+    }
+  }
+
+  public void timeCriticalCall(int N) {
+    int result = 0;
+    for (int i = 0; i < N; i++) {
+      result = perfJniCriticalCall(result, i);
+    }
+  }
+
   {
     System.loadLibrary("artbenchmark");
   }
@@ -33,6 +33,26 @@ extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeAddRemoveLocal(
   }
 }
 
+extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeAddRemoveLocalHole(
+    JNIEnv* env, jobject jobj, jint reps) {
+  ScopedObjectAccess soa(env);
+  mirror::Object* obj = soa.Decode<mirror::Object*>(jobj);
+  CHECK(obj != nullptr);
+  // Delete the bottom reference of a busy segment and add it back, the addition fills the hole.
+  static constexpr size_t kNumRefs = 256;
+  jobject refs[kNumRefs];
+  for (size_t i = 0; i < kNumRefs; ++i) {
+    refs[i] = soa.Env()->AddLocalReference<jobject>(obj);
+  }
+  for (jint i = 0; i < reps; ++i) {
+    soa.Env()->DeleteLocalRef(refs[0]);
+    refs[0] = soa.Env()->AddLocalReference<jobject>(obj);
+  }
+  for (size_t i = 0; i < kNumRefs; ++i) {
+    soa.Env()->DeleteLocalRef(refs[i]);
+  }
+}
+
 extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeDecodeLocal(
     JNIEnv* env, jobject jobj, jint reps) {
   ScopedObjectAccess soa(env);
@@ -21,6 +21,7 @@ public class JObjectBenchmark extends SimpleBenchmark {
     // Make sure to link methods before benchmark starts.
     System.loadLibrary("artbenchmark");
     timeAddRemoveLocal(1);
+    timeAddRemoveLocalHole(1);
     timeDecodeLocal(1);
     timeAddRemoveGlobal(1);
     timeDecodeGlobal(1);
@@ -30,6 +31,7 @@ public class JObjectBenchmark extends SimpleBenchmark {
   }
 
   public native void timeAddRemoveLocal(int reps);
+  public native void timeAddRemoveLocalHole(int reps);
   public native void timeDecodeLocal(int reps);
   public native void timeAddRemoveGlobal(int reps);
   public native void timeDecodeGlobal(int reps);
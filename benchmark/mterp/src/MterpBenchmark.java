@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.SimpleBenchmark;
+
+public class MterpBenchmark extends SimpleBenchmark {
+  private static final int ARRAY_SIZE = 1024;
+
+  private final int[] ints = new int[ARRAY_SIZE];
+  private final long[] longs = new long[ARRAY_SIZE];
+  private int intField;
+  private double doubleField;
+
+  public MterpBenchmark() {
+    for (int i = 0; i < ARRAY_SIZE; i++) {
+      ints[i] = i + 1;
+      longs[i] = (long) i << 20;
+    }
+  }
+
+  private static int identity(int x) {
+    return x;
+  }
+
+  // Only opcodes that mterp runs in assembly.
+  public int timeIntArithmetic(int reps) {
+    int result = 0;
+    for (int rep = 0; rep < reps; rep++) {
+      int[] array = ints;
+      for (int i = 0; i < ARRAY_SIZE; i++) {
+        int x = array[i];
+        result = (result << 1) ^ (x * 3 + (x >> 2)) - i;
+      }
+    }
+    return result;
+  }
+
+  // Only opcodes that mterp runs in assembly.
+  public long timeLongArithmetic(int reps) {
+    long result = 0;
+    for (int rep = 0; rep < reps; rep++) {
+      long[] array = longs;
+      for (int i = 0; i < ARRAY_SIZE; i++) {
+        long x = array[i];
+        result = (result ^ x) + x * 7 - (x | i);
+      }
+    }
+    return result;
+  }
+
+  // An invoke, single-stepped by the C++ interpreter, at every iteration.
+  public int timeStaticInvokes(int reps) {
+    int result = 0;
+    for (int rep = 0; rep < reps; rep++) {
+      for (int i = 0; i < ARRAY_SIZE; i++) {
+        result += identity(i);
+      }
+    }
+    return result;
+  }
+
+  // Instance field accesses, single-stepped by the C++ interpreter, among arithmetic.
+  public int timeFieldAccesses(int reps) {
+    for (int rep = 0; rep < reps; rep++) {
+      for (int i = 0; i < ARRAY_SIZE; i++) {
+        intField = (intField ^ i) + 1;
+      }
+    }
+    return intField;
+  }
+
+  // Floating-point arithmetic, single-stepped by the C++ interpreter.
+  public double timeFloatingPoint(int reps) {
+    double result = 0;
+    for (int rep = 0; rep < reps; rep++) {
+      for (int i = 0; i < ARRAY_SIZE; i++) {
+        result = result * 0.5 + i;
+      }
+    }
+    doubleField = result;
+    return doubleField;
+  }
+}
@@ -56,3 +56,39 @@ extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureLon
   }
   return ret;
 }
+
+extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureStringUTFChars(
+    JNIEnv* env, jclass, int reps, jstring str) {
+  jlong ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    const char* chars = env->GetStringUTFChars(str, nullptr);
+    ret += chars[0];
+    env->ReleaseStringUTFChars(str, chars);
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureStringUTFRegion(
+    JNIEnv* env, jclass, int reps, jstring str) {
+  jlong ret = 0;
+  jsize length = env->GetStringLength(str);
+  // The strings of the benchmark are ASCII, one byte per char.
+  char buf[8192];
+  for (jint i = 0; i < reps; ++i) {
+    env->GetStringUTFRegion(str, 0, length, buf);
+    ret += buf[0] + buf[length - 1];
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureStringCritical(
+    JNIEnv* env, jclass, int reps, jstring str) {
+  jlong ret = 0;
+  jsize length = env->GetStringLength(str);
+  for (jint i = 0; i < reps; ++i) {
+    const jchar* chars = env->GetStringCritical(str, nullptr);
+    ret += chars[0] + chars[length - 1];
+    env->ReleaseStringCritical(str, chars);
+  }
+  return ret;
+}
@@ -22,6 +22,10 @@ public class ScopedPrimitiveArrayBenchmark extends SimpleBenchmark {
   static native long measureShortArray(int reps, short[] arr);
   static native long measureIntArray(int reps, int[] arr);
   static native long measureLongArray(int reps, long[] arr);
+  // Measure getting the chars of a string, converted to modified UTF-8 or in place.
+  static native long measureStringUTFChars(int reps, String str);
+  static native long measureStringUTFRegion(int reps, String str);
+  static native long measureStringCritical(int reps, String str);
 
   static final int smallLength = 16;
   static final int mediumLength = 256;
@@ -38,6 +42,17 @@ public class ScopedPrimitiveArrayBenchmark extends SimpleBenchmark {
   static long[] smallLongs = new long[smallLength];
   static long[] mediumLongs = new long[mediumLength];
   static long[] largeLongs = new long[largeLength];
+  static String smallString = makeString(smallLength);
+  static String mediumString = makeString(mediumLength);
+  static String largeString = makeString(largeLength);
+
+  static String makeString(int length) {
+    StringBuilder sb = new StringBuilder(length);
+    for (int i = 0; i < length; ++i) {
+      sb.append((char) ('a' + i % 26));
+    }
+    return sb.toString();
+  }
 
   public void timeSmallBytes(int reps) {
     measureByteArray(reps, smallBytes);
@@ -87,6 +102,42 @@ public class ScopedPrimitiveArrayBenchmark extends SimpleBenchmark {
     measureLongArray(reps, largeLongs);
   }
 
+  public void timeSmallStringUTFChars(int reps) {
+    measureStringUTFChars(reps, smallString);
+  }
+
+  public void timeMediumStringUTFChars(int reps) {
+    measureStringUTFChars(reps, mediumString);
+  }
+
+  public void timeLargeStringUTFChars(int reps) {
+    measureStringUTFChars(reps, largeString);
+  }
+
+  public void timeSmallStringUTFRegion(int reps) {
+    measureStringUTFRegion(reps, smallString);
+  }
+
+  public void timeMediumStringUTFRegion(int reps) {
+    measureStringUTFRegion(reps, mediumString);
+  }
+
+  public void timeLargeStringUTFRegion(int reps) {
+    measureStringUTFRegion(reps, largeString);
+  }
+
+  public void timeSmallStringCritical(int reps) {
+    measureStringCritical(reps, smallString);
+  }
+
+  public void timeMediumStringCritical(int reps) {
+    measureStringCritical(reps, mediumString);
+  }
+
+  public void timeLargeStringCritical(int reps) {
+    measureStringCritical(reps, largeString);
+  }
+
   {
     System.loadLibrary("artbenchmark");
   }
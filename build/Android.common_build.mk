@@ -322,6 +322,14 @@ ifeq ($(ART_USE_TLAB),true)
   art_cflags += -DART_USE_TLAB=1
 endif
 
+#
+# Used to make mterp, the assembly interpreter, the interpreter of x86-64 and arm64. It leaves
+# many opcodes to the C++ interpreter, see runtime/interpreter/mterp/README.txt.
+#
+ifeq ($(ART_USE_MTERP),true)
+  art_cflags += -DART_USE_MTERP=1
+endif
+
 # Cflags for non-debug ART and ART tools.
 art_non_debug_cflags := \
   $(ART_NDEBUG_OPT_FLAG)
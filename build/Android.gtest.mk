@@ -171,8 +171,10 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/base/time_utils_test.cc \
   runtime/base/timing_logger_test.cc \
   runtime/base/variant_map_test.cc \
+  runtime/base/work_stealing_deque_test.cc \
   runtime/base/unix_file/fd_file_test.cc \
   runtime/class_linker_test.cc \
+  runtime/class_table_test.cc \
   runtime/dex_file_test.cc \
   runtime/dex_file_verifier_test.cc \
   runtime/dex_instruction_test.cc \
@@ -185,6 +187,8 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/gc/accounting/card_table_test.cc \
   runtime/gc/accounting/mod_union_table_test.cc \
   runtime/gc/accounting/space_bitmap_test.cc \
+  runtime/gc/collector/concurrent_copying_test.cc \
+  runtime/gc/collector/semi_space_test.cc \
   runtime/gc/heap_test.cc \
   runtime/gc/reference_queue_test.cc \
   runtime/gc/space/dlmalloc_space_base_test.cc \
@@ -205,6 +209,7 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/interpreter/unstarted_runtime_test.cc \
   runtime/java_vm_ext_test.cc \
   runtime/jit/jit_code_cache_test.cc \
+  runtime/jit/offline_profiling_info_test.cc \
   runtime/lambda/closure_test.cc \
   runtime/lambda/shorty_field_type_test.cc \
   runtime/leb128_test.cc \
@@ -256,6 +261,7 @@ COMPILER_GTEST_COMMON_SRC_FILES := \
   compiler/optimizing/nodes_test.cc \
   compiler/optimizing/parallel_move_test.cc \
   compiler/optimizing/pretty_printer_test.cc \
+  compiler/optimizing/scheduler_test.cc \
   compiler/optimizing/side_effects_test.cc \
   compiler/optimizing/ssa_test.cc \
   compiler/optimizing/stack_map_test.cc \
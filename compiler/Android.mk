@@ -66,6 +66,7 @@ LIBART_COMPILER_SRC_FILES := \
 	optimizing/builder.cc \
 	optimizing/code_generator.cc \
 	optimizing/code_generator_utils.cc \
+	optimizing/code_sinking.cc \
 	optimizing/constant_area_fixups_x86.cc \
 	optimizing/constant_folding.cc \
 	optimizing/dead_code_elimination.cc \
@@ -78,7 +79,9 @@ LIBART_COMPILER_SRC_FILES := \
 	optimizing/instruction_simplifier.cc \
 	optimizing/intrinsics.cc \
 	optimizing/licm.cc \
+	optimizing/load_store_elimination.cc \
 	optimizing/locations.cc \
+	optimizing/loop_optimization.cc \
 	optimizing/nodes.cc \
 	optimizing/optimization.cc \
 	optimizing/optimizing_compiler.cc \
@@ -86,7 +89,12 @@ LIBART_COMPILER_SRC_FILES := \
 	optimizing/prepare_for_register_allocation.cc \
 	optimizing/primitive_type_propagation.cc \
 	optimizing/reference_type_propagation.cc \
+	optimizing/register_allocation_resolver.cc \
 	optimizing/register_allocator.cc \
+	optimizing/register_allocator_graph_color.cc \
+	optimizing/register_allocator_linear_scan.cc \
+	optimizing/scheduler.cc \
+	optimizing/select_generator.cc \
 	optimizing/side_effects_analysis.cc \
 	optimizing/ssa_builder.cc \
 	optimizing/ssa_liveness_analysis.cc \
@@ -140,6 +148,7 @@ LIBART_COMPILER_SRC_FILES_arm64 := \
 	linker/arm64/relative_patcher_arm64.cc \
 	optimizing/code_generator_arm64.cc \
 	optimizing/instruction_simplifier_arm64.cc \
+	optimizing/scheduler_arm64.cc \
 	optimizing/intrinsics_arm64.cc \
 	utils/arm64/assembler_arm64.cc \
 	utils/arm64/managed_register_arm64.cc \
@@ -185,6 +194,7 @@ LIBART_COMPILER_SRC_FILES_x86_64 := \
 	linker/x86_64/relative_patcher_x86_64.cc \
 	optimizing/intrinsics_x86_64.cc \
 	optimizing/code_generator_x86_64.cc \
+	optimizing/scheduler_x86_64.cc \
 	utils/x86_64/assembler_x86_64.cc \
 	utils/x86_64/managed_register_x86_64.cc \
 
@@ -38,6 +38,18 @@ Compiler* Compiler::Create(CompilerDriver* driver, Compiler::Kind kind) {
   }
 }
 
+CompiledMethod* Compiler::CompileOsr(const DexFile::CodeItem* code_item ATTRIBUTE_UNUSED,
+                                     uint32_t access_flags ATTRIBUTE_UNUSED,
+                                     InvokeType invoke_type ATTRIBUTE_UNUSED,
+                                     uint16_t class_def_idx ATTRIBUTE_UNUSED,
+                                     uint32_t method_idx ATTRIBUTE_UNUSED,
+                                     jobject class_loader ATTRIBUTE_UNUSED,
+                                     const DexFile& dex_file ATTRIBUTE_UNUSED,
+                                     Handle<mirror::DexCache> dex_cache ATTRIBUTE_UNUSED,
+                                     const jit::OsrEntry& osr_entry ATTRIBUTE_UNUSED) const {
+  return nullptr;
+}
+
 bool Compiler::IsPathologicalCase(const DexFile::CodeItem& code_item,
                                   uint32_t method_idx,
                                   const DexFile& dex_file) {
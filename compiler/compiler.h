@@ -22,6 +22,10 @@
 
 namespace art {
 
+namespace jit {
+class OsrEntry;
+}  // namespace jit
+
 class ArtMethod;
 class Backend;
 struct CompilationUnit;
@@ -54,6 +58,18 @@ class Compiler {
                                   const DexFile& dex_file,
                                   Handle<mirror::DexCache> dex_cache) const = 0;
 
+  // Compile the on-stack replacement version of a method, entered at the loop header described
+  // by `osr_entry`. Returns null if the compiler does not support it.
+  virtual CompiledMethod* CompileOsr(const DexFile::CodeItem* code_item,
+                                     uint32_t access_flags,
+                                     InvokeType invoke_type,
+                                     uint16_t class_def_idx,
+                                     uint32_t method_idx,
+                                     jobject class_loader,
+                                     const DexFile& dex_file,
+                                     Handle<mirror::DexCache> dex_cache,
+                                     const jit::OsrEntry& osr_entry) const;
+
   virtual CompiledMethod* JniCompile(uint32_t access_flags,
                                      uint32_t method_idx,
                                      const DexFile& dex_file) const = 0;
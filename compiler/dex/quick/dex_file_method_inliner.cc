@@ -74,6 +74,9 @@ static constexpr bool kIntrinsicIsStatic[] = {
     false,  // kIntrinsicUnsafePut
     true,   // kIntrinsicSystemArrayCopyCharArray
     true,   // kIntrinsicSystemArrayCopy
+    true,   // kIntrinsicSystemArrayCopyPrimitiveArray
+    true,   // kIntrinsicArraysFill
+    true,   // kIntrinsicArraysEquals
 };
 static_assert(arraysize(kIntrinsicIsStatic) == kInlineOpNop,
               "arraysize of kIntrinsicIsStatic unexpected");
@@ -124,6 +127,10 @@ static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopyCharArray],
               "SystemArrayCopyCharArray must be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopy],
               "SystemArrayCopy must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopyPrimitiveArray],
+              "SystemArrayCopyPrimitiveArray must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicArraysFill], "ArraysFill must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicArraysEquals], "ArraysEquals must be static");
 
 MIR* AllocReplacementMIR(MIRGraph* mir_graph, MIR* invoke) {
   MIR* insn = mir_graph->NewMIR();
@@ -166,6 +173,11 @@ const char* const DexFileMethodInliner::kClassCacheNames[] = {
     "[B",                      // kClassCacheJavaLangByteArray
     "[C",                      // kClassCacheJavaLangCharArray
     "[I",                      // kClassCacheJavaLangIntArray
+    "[Z",                      // kClassCacheJavaLangBooleanArray
+    "[S",                      // kClassCacheJavaLangShortArray
+    "[J",                      // kClassCacheJavaLangLongArray
+    "[F",                      // kClassCacheJavaLangFloatArray
+    "[D",                      // kClassCacheJavaLangDoubleArray
     "Ljava/lang/Object;",      // kClassCacheJavaLangObject
     "Ljava/lang/ref/Reference;",   // kClassCacheJavaLangRefReference
     "Ljava/lang/String;",      // kClassCacheJavaLangString
@@ -184,6 +196,7 @@ const char* const DexFileMethodInliner::kClassCacheNames[] = {
     "Llibcore/io/Memory;",     // kClassCacheLibcoreIoMemory
     "Lsun/misc/Unsafe;",       // kClassCacheSunMiscUnsafe
     "Ljava/lang/System;",      // kClassCacheJavaLangSystem
+    "Ljava/util/Arrays;",      // kClassCacheJavaUtilArrays
 };
 
 const char* const DexFileMethodInliner::kNameCacheNames[] = {
@@ -245,6 +258,7 @@ const char* const DexFileMethodInliner::kNameCacheNames[] = {
     "numberOfTrailingZeros",  // kNameCacheNumberOfTrailingZeros
     "rotateRight",           // kNameCacheRotateRight
     "rotateLeft",            // kNameCacheRotateLeft
+    "fill",                  // kNameCacheFill
 };
 
 const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
@@ -332,6 +346,47 @@ const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
     // kProtoCacheObjectIObjectII_V
     { kClassCacheVoid, 5, {kClassCacheJavaLangObject, kClassCacheInt,
         kClassCacheJavaLangObject, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheBooleanArrayIBooleanArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangBooleanArray, kClassCacheInt,
+        kClassCacheJavaLangBooleanArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheByteArrayIByteArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangByteArray, kClassCacheInt,
+        kClassCacheJavaLangByteArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheShortArrayIShortArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangShortArray, kClassCacheInt,
+        kClassCacheJavaLangShortArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheIntArrayIIntArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangIntArray, kClassCacheInt,
+        kClassCacheJavaLangIntArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheLongArrayILongArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangLongArray, kClassCacheInt,
+        kClassCacheJavaLangLongArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheFloatArrayIFloatArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangFloatArray, kClassCacheInt,
+        kClassCacheJavaLangFloatArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheDoubleArrayIDoubleArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangDoubleArray, kClassCacheInt,
+        kClassCacheJavaLangDoubleArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheByteArrayB_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangByteArray, kClassCacheByte } },
+    // kProtoCacheCharArrayC_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangCharArray, kClassCacheChar } },
+    // kProtoCacheShortArrayS_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangShortArray, kClassCacheShort } },
+    // kProtoCacheIntArrayI_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangIntArray, kClassCacheInt } },
+    // kProtoCacheLongArrayJ_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangLongArray, kClassCacheLong } },
+    // kProtoCacheByteArrayByteArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangByteArray, kClassCacheJavaLangByteArray } },
+    // kProtoCacheCharArrayCharArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangCharArray, kClassCacheJavaLangCharArray } },
+    // kProtoCacheShortArrayShortArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangShortArray, kClassCacheJavaLangShortArray } },
+    // kProtoCacheIntArrayIntArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangIntArray, kClassCacheJavaLangIntArray } },
+    // kProtoCacheLongArrayLongArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangLongArray, kClassCacheJavaLangLongArray } },
     // kProtoCacheIICharArrayI_V
     { kClassCacheVoid, 4, { kClassCacheInt, kClassCacheInt, kClassCacheJavaLangCharArray,
         kClassCacheInt } },
@@ -489,6 +544,36 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
               0),
     INTRINSIC(JavaLangSystem, ArrayCopy, ObjectIObjectII_V , kIntrinsicSystemArrayCopy,
               0),
+    INTRINSIC(JavaLangSystem, ArrayCopy, BooleanArrayIBooleanArrayII_V,
+              kIntrinsicSystemArrayCopyPrimitiveArray, Primitive::kPrimBoolean),
+    INTRINSIC(JavaLangSystem, ArrayCopy, ByteArrayIByteArrayII_V,
+              kIntrinsicSystemArrayCopyPrimitiveArray, Primitive::kPrimByte),
+    INTRINSIC(JavaLangSystem, ArrayCopy, ShortArrayIShortArrayII_V,
+              kIntrinsicSystemArrayCopyPrimitiveArray, Primitive::kPrimShort),
+    INTRINSIC(JavaLangSystem, ArrayCopy, IntArrayIIntArrayII_V,
+              kIntrinsicSystemArrayCopyPrimitiveArray, Primitive::kPrimInt),
+    INTRINSIC(JavaLangSystem, ArrayCopy, LongArrayILongArrayII_V,
+              kIntrinsicSystemArrayCopyPrimitiveArray, Primitive::kPrimLong),
+    INTRINSIC(JavaLangSystem, ArrayCopy, FloatArrayIFloatArrayII_V,
+              kIntrinsicSystemArrayCopyPrimitiveArray, Primitive::kPrimFloat),
+    INTRINSIC(JavaLangSystem, ArrayCopy, DoubleArrayIDoubleArrayII_V,
+              kIntrinsicSystemArrayCopyPrimitiveArray, Primitive::kPrimDouble),
+
+    INTRINSIC(JavaUtilArrays, Fill, ByteArrayB_V, kIntrinsicArraysFill, Primitive::kPrimByte),
+    INTRINSIC(JavaUtilArrays, Fill, CharArrayC_V, kIntrinsicArraysFill, Primitive::kPrimChar),
+    INTRINSIC(JavaUtilArrays, Fill, ShortArrayS_V, kIntrinsicArraysFill, Primitive::kPrimShort),
+    INTRINSIC(JavaUtilArrays, Fill, IntArrayI_V, kIntrinsicArraysFill, Primitive::kPrimInt),
+    INTRINSIC(JavaUtilArrays, Fill, LongArrayJ_V, kIntrinsicArraysFill, Primitive::kPrimLong),
+    INTRINSIC(JavaUtilArrays, Equals, ByteArrayByteArray_Z, kIntrinsicArraysEquals,
+              Primitive::kPrimByte),
+    INTRINSIC(JavaUtilArrays, Equals, CharArrayCharArray_Z, kIntrinsicArraysEquals,
+              Primitive::kPrimChar),
+    INTRINSIC(JavaUtilArrays, Equals, ShortArrayShortArray_Z, kIntrinsicArraysEquals,
+              Primitive::kPrimShort),
+    INTRINSIC(JavaUtilArrays, Equals, IntArrayIntArray_Z, kIntrinsicArraysEquals,
+              Primitive::kPrimInt),
+    INTRINSIC(JavaUtilArrays, Equals, LongArrayLongArray_Z, kIntrinsicArraysEquals,
+              Primitive::kPrimLong),
 
     INTRINSIC(JavaLangInteger, RotateRight, II_I, kIntrinsicRotateRight, k32),
     INTRINSIC(JavaLangLong, RotateRight, JI_J, kIntrinsicRotateRight, k64),
@@ -662,6 +747,9 @@ bool DexFileMethodInliner::GenIntrinsic(Mir2Lir* backend, CallInfo* info) {
     case kIntrinsicRotateRight:
     case kIntrinsicRotateLeft:
     case kIntrinsicSystemArrayCopy:
+    case kIntrinsicSystemArrayCopyPrimitiveArray:
+    case kIntrinsicArraysFill:
+    case kIntrinsicArraysEquals:
       return false;   // not implemented in quick.
     default:
       LOG(FATAL) << "Unexpected intrinsic opcode: " << intrinsic.opcode;
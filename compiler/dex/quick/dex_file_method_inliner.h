@@ -125,6 +125,11 @@ class DexFileMethodInliner {
       kClassCacheJavaLangByteArray,
       kClassCacheJavaLangCharArray,
       kClassCacheJavaLangIntArray,
+      kClassCacheJavaLangBooleanArray,
+      kClassCacheJavaLangShortArray,
+      kClassCacheJavaLangLongArray,
+      kClassCacheJavaLangFloatArray,
+      kClassCacheJavaLangDoubleArray,
       kClassCacheJavaLangObject,
       kClassCacheJavaLangRefReference,
       kClassCacheJavaLangString,
@@ -143,6 +148,7 @@ class DexFileMethodInliner {
       kClassCacheLibcoreIoMemory,
       kClassCacheSunMiscUnsafe,
       kClassCacheJavaLangSystem,
+      kClassCacheJavaUtilArrays,
       kClassCacheLast
     };
 
@@ -211,6 +217,7 @@ class DexFileMethodInliner {
       kNameCacheNumberOfTrailingZeros,
       kNameCacheRotateRight,
       kNameCacheRotateLeft,
+      kNameCacheFill,
       kNameCacheLast
     };
 
@@ -260,6 +267,23 @@ class DexFileMethodInliner {
       kProtoCacheObjectJObject_V,
       kProtoCacheCharArrayICharArrayII_V,
       kProtoCacheObjectIObjectII_V,
+      kProtoCacheBooleanArrayIBooleanArrayII_V,
+      kProtoCacheByteArrayIByteArrayII_V,
+      kProtoCacheShortArrayIShortArrayII_V,
+      kProtoCacheIntArrayIIntArrayII_V,
+      kProtoCacheLongArrayILongArrayII_V,
+      kProtoCacheFloatArrayIFloatArrayII_V,
+      kProtoCacheDoubleArrayIDoubleArrayII_V,
+      kProtoCacheByteArrayB_V,
+      kProtoCacheCharArrayC_V,
+      kProtoCacheShortArrayS_V,
+      kProtoCacheIntArrayI_V,
+      kProtoCacheLongArrayJ_V,
+      kProtoCacheByteArrayByteArray_Z,
+      kProtoCacheCharArrayCharArray_Z,
+      kProtoCacheShortArrayShortArray_Z,
+      kProtoCacheIntArrayIntArray_Z,
+      kProtoCacheLongArrayLongArray_Z,
       kProtoCacheIICharArrayI_V,
       kProtoCacheByteArrayIII_String,
       kProtoCacheIICharArray_String,
@@ -58,6 +58,8 @@ class QuickCFITest : public CFITest {
       CompilerOptions::kDefaultNumDexMethodsThreshold,
       CompilerOptions::kDefaultInlineDepthLimit,
       CompilerOptions::kDefaultInlineMaxCodeUnits,
+      CompilerOptions::kDefaultLoopUnrollingMaxInstructions,
+      CompilerOptions::kDefaultGraphColoringMaxCodeUnits,
       false,
       CompilerOptions::kDefaultTopKProfileThreshold,
       false,
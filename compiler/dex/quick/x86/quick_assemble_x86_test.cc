@@ -41,6 +41,8 @@ class QuickAssembleX86TestBase : public testing::Test {
         CompilerOptions::kDefaultNumDexMethodsThreshold,
         CompilerOptions::kDefaultInlineDepthLimit,
         CompilerOptions::kDefaultInlineMaxCodeUnits,
+        CompilerOptions::kDefaultLoopUnrollingMaxInstructions,
+        CompilerOptions::kDefaultGraphColoringMaxCodeUnits,
         false,
         CompilerOptions::kDefaultTopKProfileThreshold,
         false,
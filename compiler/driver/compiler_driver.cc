@@ -395,13 +395,20 @@ CompilerDriver::CompilerDriver(const CompilerOptions* compiler_options,
 
   CHECK_EQ(image_, image_classes_.get() != nullptr);
 
-  // Read the profile file if one is provided.
+  // Read the profile file if one is provided. It is either a profile saved by the JIT, or
+  // one in the format of the sampling profiler.
   if (!profile_file.empty()) {
-    profile_present_ = profile_file_.LoadFile(profile_file);
-    if (profile_present_) {
-      LOG(INFO) << "Using profile data form file " << profile_file;
+    std::unique_ptr<ProfileCompilationInfo> info(new ProfileCompilationInfo());
+    if (info->Load(profile_file)) {
+      LOG(INFO) << "Using JIT profile data from file " << profile_file;
+      profile_compilation_info_ = std::move(info);
     } else {
-      LOG(INFO) << "Failed to load profile file " << profile_file;
+      profile_present_ = profile_file_.LoadFile(profile_file);
+      if (profile_present_) {
+        LOG(INFO) << "Using profile data form file " << profile_file;
+      } else {
+        LOG(INFO) << "Failed to load profile file " << profile_file;
+      }
     }
   }
 }
@@ -569,6 +576,16 @@ static bool InstructionSetHasGenericJniStub(InstructionSet isa) {
   }
 }
 
+// Can the JNI compiler for the InstructionSet emit stubs calling critical natives directly?
+// Elsewhere, critical natives are left to the generic JNI stub.
+static bool InstructionSetHasCriticalNativeStub(InstructionSet isa) {
+  switch (isa) {
+    case kArm64:
+    case kX86_64: return true;
+    default: return false;
+  }
+}
+
 static void CompileMethod(Thread* self,
                           CompilerDriver* driver,
                           const DexFile::CodeItem* code_item,
@@ -588,11 +605,21 @@ static void CompileMethod(Thread* self,
   MethodReference method_ref(&dex_file, method_idx);
 
   if ((access_flags & kAccNative) != 0) {
+    // The runtime makes the same decision when loading the method, see ClassLinker::LoadMethod.
+    const bool is_critical_native = ArtMethod::IsCriticalNativeMethod(
+        dex_file, dex_file.GetClassDef(class_def_idx), method_idx, access_flags);
     // Are we interpreting only and have support for generic JNI down calls?
     if (!driver->GetCompilerOptions().IsCompilationEnabled() &&
         InstructionSetHasGenericJniStub(driver->GetInstructionSet())) {
       // Leaving this empty will trigger the generic JNI version
+    } else if (is_critical_native &&
+               !InstructionSetHasCriticalNativeStub(driver->GetInstructionSet())) {
+      // Leaving this empty will trigger the generic JNI version, which knows critical natives.
+      CHECK(InstructionSetHasGenericJniStub(driver->GetInstructionSet()));
     } else {
+      if (is_critical_native) {
+        access_flags |= kAccCriticalNative;
+      }
       compiled_method = driver->GetCompiler()->JniCompile(access_flags, method_idx, dex_file);
       CHECK(compiled_method != nullptr);
     }
@@ -612,7 +639,8 @@ static void CompileMethod(Thread* self,
         (verified_method->GetEncounteredVerificationFailures() &
             (verifier::VERIFY_ERROR_FORCE_INTERPRETER | verifier::VERIFY_ERROR_LOCKING)) == 0 &&
         // Is eligable for compilation by methods-to-compile filter.
-        driver->IsMethodToCompile(method_ref);
+        driver->IsMethodToCompile(method_ref) &&
+        driver->ShouldCompileBasedOnProfile(method_ref);
     if (compile) {
       // NOTE: if compiler declines to compile this method, it will return null.
       compiled_method = driver->GetCompiler()->Compile(code_item, access_flags, invoke_type,
@@ -761,6 +789,43 @@ CompiledMethod* CompilerDriver::CompileArtMethod(Thread* self, ArtMethod* method
   return compiled_method;
 }
 
+CompiledMethod* CompilerDriver::CompileArtMethodForOsr(Thread* self,
+                                                      ArtMethod* method,
+                                                      const jit::OsrEntry& osr_entry) {
+  const uint32_t method_idx = method->GetDexMethodIndex();
+  const uint32_t access_flags = method->GetAccessFlags();
+  const InvokeType invoke_type = method->GetInvokeType();
+  const DexFile* dex_file = method->GetDexFile();
+  MethodReference method_ref(dex_file, method_idx);
+  // Same checks as CompileMethod, without the dex-to-dex fallback which has no use for OSR.
+  const VerifiedMethod* verified_method = GetVerificationResults()->GetVerifiedMethod(method_ref);
+  if (!GetVerificationResults()->IsCandidateForCompilation(method_ref, access_flags) ||
+      verified_method == nullptr ||
+      verified_method->HasRuntimeThrow() ||
+      (verified_method->GetEncounteredVerificationFailures() &
+          (verifier::VERIFY_ERROR_FORCE_INTERPRETER | verifier::VERIFY_ERROR_LOCKING)) != 0) {
+    return nullptr;
+  }
+  StackHandleScope<2> hs(self);
+  Handle<mirror::ClassLoader> class_loader(hs.NewHandle(
+      method->GetDeclaringClass()->GetClassLoader()));
+  Handle<mirror::DexCache> dex_cache(hs.NewHandle(method->GetDexCache()));
+  jobject jclass_loader = class_loader.ToJObject();
+  const uint16_t class_def_idx = method->GetClassDefIndex();
+  const DexFile::CodeItem* code_item = dex_file->GetCodeItem(method->GetCodeItemOffset());
+  // Go to native so that we don't block GC during compilation.
+  ScopedThreadSuspension sts(self, kNative);
+  return GetCompiler()->CompileOsr(code_item,
+                                   access_flags,
+                                   invoke_type,
+                                   class_def_idx,
+                                   method_idx,
+                                   jclass_loader,
+                                   *dex_file,
+                                   dex_cache,
+                                   osr_entry);
+}
+
 void CompilerDriver::Resolve(jobject class_loader, const std::vector<const DexFile*>& dex_files,
                              ThreadPool* thread_pool, TimingLogger* timings) {
   for (size_t i = 0; i != dex_files.size(); ++i) {
@@ -842,6 +907,19 @@ bool CompilerDriver::IsMethodToCompile(const MethodReference& method_ref) const
   return methods_to_compile_->find(tmp.c_str()) != methods_to_compile_->end();
 }
 
+bool CompilerDriver::ShouldCompileBasedOnProfile(const MethodReference& method_ref) const {
+  if (profile_compilation_info_ == nullptr) {
+    // Without a JIT profile, compile everything.
+    return true;
+  }
+  bool result = profile_compilation_info_->ContainsMethod(method_ref);
+  if (kIsDebugBuild) {
+    VLOG(compiler) << "Profile guided compilation " << (result ? "compiles " : "skips ")
+                   << PrettyMethod(method_ref.dex_method_index, *method_ref.dex_file, true);
+  }
+  return result;
+}
+
 class ResolveCatchBlockExceptionsClassVisitor : public ClassVisitor {
  public:
   ResolveCatchBlockExceptionsClassVisitor(
@@ -31,6 +31,7 @@
 #include "compiler.h"
 #include "dex_file.h"
 #include "invoke_type.h"
+#include "jit/offline_profiling_info.h"
 #include "method_reference.h"
 #include "mirror/class.h"  // For mirror::Class::Status.
 #include "os.h"
@@ -112,6 +113,12 @@ class CompilerDriver {
   CompiledMethod* CompileArtMethod(Thread* self, ArtMethod*)
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!compiled_methods_lock_) WARN_UNUSED;
 
+  // Compile the on-stack replacement version of a method. The result is not recorded in the
+  // compiled methods, the caller owns it and must release it with
+  // CompiledMethod::ReleaseSwapAllocatedCompiledMethod.
+  CompiledMethod* CompileArtMethodForOsr(Thread* self, ArtMethod*, const jit::OsrEntry& osr_entry)
+      SHARED_REQUIRES(Locks::mutator_lock_) WARN_UNUSED;
+
   // Compile a single Method.
   void CompileOne(Thread* self, ArtMethod* method, TimingLogger* timings)
       SHARED_REQUIRES(Locks::mutator_lock_)
@@ -145,6 +152,11 @@ class CompilerDriver {
     return profile_present_;
   }
 
+  // The profile saved by the JIT, if dex2oat was given one, or null.
+  const ProfileCompilationInfo* GetProfileCompilationInfo() const {
+    return profile_compilation_info_.get();
+  }
+
   // Are we compiling and creating an image file?
   bool IsImage() const {
     return image_;
@@ -446,6 +458,10 @@ class CompilerDriver {
   // Checks whether the provided method should be compiled, i.e., is in method_to_compile_.
   bool IsMethodToCompile(const MethodReference& method_ref) const;
 
+  // Checks whether profile guided compilation is enabled and if the method should be compiled
+  // according to the profile file.
+  bool ShouldCompileBasedOnProfile(const MethodReference& method_ref) const;
+
   void RecordClassStatus(ClassReference ref, mirror::Class::Status status)
       REQUIRES(!compiled_classes_lock_);
 
@@ -607,6 +623,9 @@ class CompilerDriver {
   ProfileFile profile_file_;
   bool profile_present_;
 
+  // Profile saved by the JIT. When present, only the methods it lists are compiled.
+  std::unique_ptr<ProfileCompilationInfo> profile_compilation_info_;
+
   const CompilerOptions* const compiler_options_;
   VerificationResults* const verification_results_;
   DexFileToMethodInlinerMap* const method_inliner_map_;
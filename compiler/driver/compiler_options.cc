@@ -29,6 +29,8 @@ CompilerOptions::CompilerOptions()
       num_dex_methods_threshold_(kDefaultNumDexMethodsThreshold),
       inline_depth_limit_(kDefaultInlineDepthLimit),
       inline_max_code_units_(kDefaultInlineMaxCodeUnits),
+      loop_unrolling_max_instructions_(kDefaultLoopUnrollingMaxInstructions),
+      graph_coloring_max_code_units_(kDefaultGraphColoringMaxCodeUnits),
       include_patch_information_(kDefaultIncludePatchInformation),
       top_k_profile_threshold_(kDefaultTopKProfileThreshold),
       debuggable_(false),
@@ -56,6 +58,8 @@ CompilerOptions::CompilerOptions(CompilerFilter compiler_filter,
                                  size_t num_dex_methods_threshold,
                                  size_t inline_depth_limit,
                                  size_t inline_max_code_units,
+                                 size_t loop_unrolling_max_instructions,
+                                 size_t graph_coloring_max_code_units,
                                  bool include_patch_information,
                                  double top_k_profile_threshold,
                                  bool debuggable,
@@ -77,6 +81,8 @@ CompilerOptions::CompilerOptions(CompilerFilter compiler_filter,
     num_dex_methods_threshold_(num_dex_methods_threshold),
     inline_depth_limit_(inline_depth_limit),
     inline_max_code_units_(inline_max_code_units),
+    loop_unrolling_max_instructions_(loop_unrolling_max_instructions),
+    graph_coloring_max_code_units_(graph_coloring_max_code_units),
     include_patch_information_(include_patch_information),
     top_k_profile_threshold_(top_k_profile_threshold),
     debuggable_(debuggable),
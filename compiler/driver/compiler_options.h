@@ -53,11 +53,19 @@ class CompilerOptions FINAL {
   static const bool kDefaultIncludePatchInformation = false;
   static const size_t kDefaultInlineDepthLimit = 3;
   static const size_t kDefaultInlineMaxCodeUnits = 20;
+  static const size_t kDefaultLoopUnrollingMaxInstructions = 50;
+  static const size_t kDefaultGraphColoringMaxCodeUnits = 600;
 
   // Default inlining settings when the space filter is used.
   static constexpr size_t kSpaceFilterInlineDepthLimit = 3;
   static constexpr size_t kSpaceFilterInlineMaxCodeUnits = 10;
 
+  // Default loop unrolling settings when the space filter is used.
+  static constexpr size_t kSpaceFilterLoopUnrollingMaxInstructions = 0;
+
+  // The JIT compiles with linear scan, which allocates registers faster.
+  static constexpr size_t kJitGraphColoringMaxCodeUnits = 0;
+
   CompilerOptions();
   ~CompilerOptions();
 
@@ -69,6 +77,8 @@ class CompilerOptions FINAL {
                   size_t num_dex_methods_threshold,
                   size_t inline_depth_limit,
                   size_t inline_max_code_units,
+                  size_t loop_unrolling_max_instructions,
+                  size_t graph_coloring_max_code_units,
                   bool include_patch_information,
                   double top_k_profile_threshold,
                   bool debuggable,
@@ -149,10 +159,24 @@ class CompilerOptions FINAL {
     return inline_depth_limit_;
   }
 
+  // The maximum code units of a callee at a call site with no known benefit. The
+  // inliner scales it with the expected benefit of each call site.
   size_t GetInlineMaxCodeUnits() const {
     return inline_max_code_units_;
   }
 
+  // The maximum number of instructions that unrolling or peeling a loop may
+  // add to a method. Zero disables both.
+  size_t GetLoopUnrollingMaxInstructions() const {
+    return loop_unrolling_max_instructions_;
+  }
+
+  // The maximum code units of a method whose registers are allocated by graph
+  // coloring. Larger methods use linear scan. Zero always uses linear scan.
+  size_t GetGraphColoringMaxCodeUnits() const {
+    return graph_coloring_max_code_units_;
+  }
+
   double GetTopKProfileThreshold() const {
     return top_k_profile_threshold_;
   }
@@ -220,6 +244,8 @@ class CompilerOptions FINAL {
   const size_t num_dex_methods_threshold_;
   const size_t inline_depth_limit_;
   const size_t inline_max_code_units_;
+  const size_t loop_unrolling_max_instructions_;
+  const size_t graph_coloring_max_code_units_;
   const bool include_patch_information_;
   // When using a profile file only the top K% of the profiled samples will be compiled.
   const double top_k_profile_threshold_;
@@ -29,6 +29,7 @@
 #include "driver/compiler_options.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "jit/osr_entry.h"
 #include "oat_file-inl.h"
 #include "oat_quick_method_header.h"
 #include "object_lock.h"
@@ -63,6 +64,16 @@ extern "C" bool jit_compile_method(void* handle, ArtMethod* method, Thread* self
   return jit_compiler->CompileMethod(self, method);
 }
 
+extern "C" bool jit_compile_osr_method(void* handle,
+                                       ArtMethod* method,
+                                       OsrEntry* osr_entry,
+                                       Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  auto* jit_compiler = reinterpret_cast<JitCompiler*>(handle);
+  DCHECK(jit_compiler != nullptr);
+  return jit_compiler->CompileOsrMethod(self, method, osr_entry);
+}
+
 JitCompiler::JitCompiler() : total_time_(0) {
   auto* pass_manager_options = new PassManagerOptions;
   pass_manager_options->SetDisablePassList("GVN,DCE,GVNCleanup");
@@ -75,6 +86,8 @@ JitCompiler::JitCompiler() : total_time_(0) {
       CompilerOptions::kDefaultNumDexMethodsThreshold,
       CompilerOptions::kDefaultInlineDepthLimit,
       CompilerOptions::kDefaultInlineMaxCodeUnits,
+      CompilerOptions::kDefaultLoopUnrollingMaxInstructions,
+      CompilerOptions::kJitGraphColoringMaxCodeUnits,
       /* include_patch_information */ false,
       CompilerOptions::kDefaultTopKProfileThreshold,
       Runtime::Current()->IsDebuggable(),
@@ -217,46 +230,55 @@ bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method) {
   return result;
 }
 
-CompilerCallbacks* JitCompiler::GetCompilerCallbacks() const {
-  return callbacks_.get();
+bool JitCompiler::CompileOsrMethod(Thread* self, ArtMethod* method, OsrEntry* osr_entry) {
+  TimingLogger logger("JIT compiler timing logger", true, VLOG_IS_ON(jit));
+  const uint64_t start_time = NanoTime();
+  self->AssertNoPendingException();
+  Runtime* runtime = Runtime::Current();
+  // The method is running, so unlike CompileMethod there is no class to initialize.
+  const DexFile* dex_file = method->GetDexFile();
+  MethodReference method_ref(dex_file, method->GetDexMethodIndex());
+  if (verification_results_->GetVerifiedMethod(method_ref) == nullptr) {
+    TimingLogger::ScopedTiming t2("Verifying", &logger);
+    std::string error;
+    if (verifier::MethodVerifier::VerifyMethod(method, true, &error) ==
+        verifier::MethodVerifier::kHardFailure) {
+      VLOG(jit) << "Not compile method " << PrettyMethod(method)
+          << " due to verification failure " << error;
+      return false;
+    }
+  }
+  CompiledMethod* compiled_method = nullptr;
+  {
+    TimingLogger::ScopedTiming t2("Compiling", &logger);
+    compiled_method = compiler_driver_->CompileArtMethodForOsr(self, method, *osr_entry);
+  }
+  {
+    TimingLogger::ScopedTiming t2("TrimMaps", &logger);
+    runtime->GetArenaPool()->TrimMaps();
+  }
+  if (compiled_method == nullptr) {
+    return false;
+  }
+  total_time_ += NanoTime() - start_time;
+  bool result = false;
+  if (!runtime->GetInstrumentation()->AreAllMethodsDeoptimized()) {
+    TimingLogger::ScopedTiming t2("MakeExecutable", &logger);
+    result = MakeExecutable(compiled_method, method, osr_entry);
+  }
+  // The compiled method is not recorded in the driver, release it here.
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(compiler_driver_.get(), compiled_method);
+  runtime->GetJit()->AddTimingLogger(logger);
+  return result;
 }
 
-uint8_t* JitCompiler::WriteMethodHeaderAndCode(const CompiledMethod* compiled_method,
-                                               uint8_t* reserve_begin, uint8_t* reserve_end,
-                                               const uint8_t* mapping_table,
-                                               const uint8_t* vmap_table,
-                                               const uint8_t* gc_map) {
-  reserve_begin += sizeof(OatQuickMethodHeader);
-  reserve_begin = reinterpret_cast<uint8_t*>(
-      compiled_method->AlignCode(reinterpret_cast<uintptr_t>(reserve_begin)));
-  const auto* quick_code = compiled_method->GetQuickCode();
-  CHECK_LE(reserve_begin, reserve_end);
-  CHECK_LE(quick_code->size(), static_cast<size_t>(reserve_end - reserve_begin));
-  auto* code_ptr = reserve_begin;
-  OatQuickMethodHeader* method_header = reinterpret_cast<OatQuickMethodHeader*>(code_ptr) - 1;
-  // Construct the header last.
-  const auto frame_size_in_bytes = compiled_method->GetFrameSizeInBytes();
-  const auto core_spill_mask = compiled_method->GetCoreSpillMask();
-  const auto fp_spill_mask = compiled_method->GetFpSpillMask();
-  const auto code_size = quick_code->size();
-  CHECK_NE(code_size, 0U);
-  std::copy(quick_code->data(), quick_code->data() + code_size, code_ptr);
-  // After we are done writing we need to update the method header.
-  // Write out the method header last.
-  method_header = new(method_header) OatQuickMethodHeader(
-      (mapping_table == nullptr) ? 0 : code_ptr - mapping_table,
-      (vmap_table == nullptr) ? 0 : code_ptr - vmap_table,
-      (gc_map == nullptr) ? 0 : code_ptr - gc_map,
-      frame_size_in_bytes,
-      core_spill_mask,
-      fp_spill_mask,
-      code_size);
-  // Return the code ptr.
-  return code_ptr;
+CompilerCallbacks* JitCompiler::GetCompilerCallbacks() const {
+  return callbacks_.get();
 }
 
-bool JitCompiler::AddToCodeCache(ArtMethod* method, const CompiledMethod* compiled_method,
-                                 OatFile::OatMethod* out_method) {
+bool JitCompiler::AddToCodeCache(ArtMethod* method,
+                                 const CompiledMethod* compiled_method,
+                                 OsrEntry* osr_entry) {
   Runtime* runtime = Runtime::Current();
   JitCodeCache* const code_cache = runtime->GetJit()->GetCodeCache();
   const auto* quick_code = compiled_method->GetQuickCode();
@@ -264,8 +286,8 @@ bool JitCompiler::AddToCodeCache(ArtMethod* method, const CompiledMethod* compil
     return false;
   }
   const auto code_size = quick_code->size();
+  CHECK_NE(code_size, 0U);
   Thread* const self = Thread::Current();
-  const uint8_t* base = code_cache->CodeCachePtr();
   auto* const mapping_table = compiled_method->GetMappingTable();
   auto* const vmap_table = compiled_method->GetVmapTable();
   auto* const gc_map = compiled_method->GetGcMap();
@@ -277,64 +299,72 @@ bool JitCompiler::AddToCodeCache(ArtMethod* method, const CompiledMethod* compil
     // Write out pre-header stuff.
     mapping_table_ptr = code_cache->AddDataArray(
         self, mapping_table->data(), mapping_table->data() + mapping_table->size());
-    if (mapping_table_ptr == nullptr) {
-      return false;  // Out of data cache.
-    }
   }
 
   if (vmap_table != nullptr) {
     vmap_table_ptr = code_cache->AddDataArray(
         self, vmap_table->data(), vmap_table->data() + vmap_table->size());
-    if (vmap_table_ptr == nullptr) {
-      return false;  // Out of data cache.
-    }
   }
 
   if (gc_map != nullptr) {
     gc_map_ptr = code_cache->AddDataArray(
         self, gc_map->data(), gc_map->data() + gc_map->size());
-    if (gc_map_ptr == nullptr) {
-      return false;  // Out of data cache.
-    }
   }
 
-  // Don't touch this until you protect / unprotect the code.
-  const size_t reserve_size = sizeof(OatQuickMethodHeader) + quick_code->size() + 32;
-  uint8_t* const code_reserve = code_cache->ReserveCode(self, reserve_size);
-  if (code_reserve == nullptr) {
-    return false;
+  uint8_t* code_ptr = nullptr;
+  if ((mapping_table_ptr != nullptr || mapping_table == nullptr) &&
+      (vmap_table_ptr != nullptr || vmap_table == nullptr) &&
+      (gc_map_ptr != nullptr || gc_map == nullptr)) {
+    code_ptr = code_cache->CommitCode(self,
+                                      method,
+                                      mapping_table_ptr,
+                                      vmap_table_ptr,
+                                      gc_map_ptr,
+                                      compiled_method->GetFrameSizeInBytes(),
+                                      compiled_method->GetCoreSpillMask(),
+                                      compiled_method->GetFpSpillMask(),
+                                      quick_code->data(),
+                                      code_size,
+                                      osr_entry);
   }
-  auto* code_ptr = WriteMethodHeaderAndCode(
-      compiled_method, code_reserve, code_reserve + reserve_size, mapping_table_ptr,
-      vmap_table_ptr, gc_map_ptr);
 
-  __builtin___clear_cache(reinterpret_cast<char*>(code_ptr),
-                          reinterpret_cast<char*>(code_ptr + quick_code->size()));
+  if (code_ptr == nullptr) {
+    // Out of code or data cache, release what we managed to allocate.
+    if (mapping_table_ptr != nullptr) {
+      code_cache->FreeData(self, mapping_table_ptr);
+    }
+    if (vmap_table_ptr != nullptr) {
+      code_cache->FreeData(self, vmap_table_ptr);
+    }
+    if (gc_map_ptr != nullptr) {
+      code_cache->FreeData(self, gc_map_ptr);
+    }
+    return false;
+  }
 
-  const size_t thumb_offset = compiled_method->CodeDelta();
-  const uint32_t code_offset = code_ptr - base + thumb_offset;
-  *out_method = OatFile::OatMethod(base, code_offset);
-  DCHECK_EQ(out_method->GetGcMap(), gc_map_ptr);
-  DCHECK_EQ(out_method->GetMappingTable(), mapping_table_ptr);
-  DCHECK_EQ(out_method->GetVmapTable(), vmap_table_ptr);
-  DCHECK_EQ(out_method->GetFrameSizeInBytes(), compiled_method->GetFrameSizeInBytes());
-  DCHECK_EQ(out_method->GetCoreSpillMask(), compiled_method->GetCoreSpillMask());
-  DCHECK_EQ(out_method->GetFpSpillMask(), compiled_method->GetFpSpillMask());
-  VLOG(jit)  << "JIT added " << PrettyMethod(method) << "@" << method << " ccache_size="
+  VLOG(jit)  << "JIT added " << PrettyMethod(method) << "@" << method
+      << (osr_entry != nullptr ? " (osr)" : "") << " ccache_size="
       << PrettySize(code_cache->CodeCacheSize()) << ": " << reinterpret_cast<void*>(code_ptr)
       << "," << reinterpret_cast<void*>(code_ptr + code_size);
   return true;
 }
 
-bool JitCompiler::MakeExecutable(CompiledMethod* compiled_method, ArtMethod* method) {
+bool JitCompiler::MakeExecutable(CompiledMethod* compiled_method,
+                                 ArtMethod* method,
+                                 OsrEntry* osr_entry) {
   CHECK(method != nullptr);
   CHECK(compiled_method != nullptr);
-  OatFile::OatMethod oat_method(nullptr, 0);
-  if (!AddToCodeCache(method, compiled_method, &oat_method)) {
-    return false;
+  if (!AddToCodeCache(method, compiled_method, osr_entry)) {
+    // The code cache is full, evict the code that is not in use and try again.
+    Runtime::Current()->GetJit()->GetCodeCache()->GarbageCollectCache(Thread::Current());
+    if (!AddToCodeCache(method, compiled_method, osr_entry)) {
+      return false;
+    }
+  }
+  if (osr_entry != nullptr) {
+    // The entrypoint of the method is left alone.
+    return true;
   }
-  // TODO: Flush instruction cache.
-  oat_method.LinkMethod(method);
   CHECK(Runtime::Current()->GetJit()->GetCodeCache()->ContainsMethod(method))
       << PrettyMethod(method);
   return true;
@@ -41,9 +41,10 @@ class JNICFITest : public CFITest {
     // Description of simple method.
     const bool is_static = true;
     const bool is_synchronized = false;
+    const bool is_critical_native = false;
     const char* shorty = "IIFII";
     std::unique_ptr<JniCallingConvention> jni_conv(
-        JniCallingConvention::Create(is_static, is_synchronized, shorty, isa));
+        JniCallingConvention::Create(is_static, is_synchronized, is_critical_native, shorty, isa));
     std::unique_ptr<ManagedRuntimeCallingConvention> mr_conv(
         ManagedRuntimeCallingConvention::Create(is_static, is_synchronized, shorty, isa));
     const int frame_size(jni_conv->FrameSize());
@@ -133,8 +133,13 @@ bool ManagedRuntimeCallingConvention::IsCurrentParamALong() {
 // JNI calling convention
 
 JniCallingConvention* JniCallingConvention::Create(bool is_static, bool is_synchronized,
+                                                   bool is_critical_native,
                                                    const char* shorty,
                                                    InstructionSet instruction_set) {
+  // Only the JNI compilers for these ISAs emit critical native stubs, the others leave them
+  // to the generic JNI stub.
+  DCHECK(!is_critical_native || instruction_set == kArm64 || instruction_set == kX86_64)
+      << instruction_set;
   switch (instruction_set) {
 #ifdef ART_ENABLE_CODEGEN_arm
     case kArm:
@@ -143,7 +148,8 @@ JniCallingConvention* JniCallingConvention::Create(bool is_static, bool is_synch
 #endif
 #ifdef ART_ENABLE_CODEGEN_arm64
     case kArm64:
-      return new arm64::Arm64JniCallingConvention(is_static, is_synchronized, shorty);
+      return new arm64::Arm64JniCallingConvention(is_static, is_synchronized, is_critical_native,
+                                                  shorty);
 #endif
 #ifdef ART_ENABLE_CODEGEN_mips
     case kMips:
@@ -159,7 +165,8 @@ JniCallingConvention* JniCallingConvention::Create(bool is_static, bool is_synch
 #endif
 #ifdef ART_ENABLE_CODEGEN_x86_64
     case kX86_64:
-      return new x86_64::X86_64JniCallingConvention(is_static, is_synchronized, shorty);
+      return new x86_64::X86_64JniCallingConvention(is_static, is_synchronized, is_critical_native,
+                                                    shorty);
 #endif
     default:
       LOG(FATAL) << "Unknown InstructionSet: " << instruction_set;
@@ -168,7 +175,8 @@ JniCallingConvention* JniCallingConvention::Create(bool is_static, bool is_synch
 }
 
 size_t JniCallingConvention::ReferenceCount() const {
-  return NumReferenceArgs() + (IsStatic() ? 1 : 0);
+  // Critical natives do not pass the jclass, and have no reference arguments.
+  return NumReferenceArgs() + ((IsStatic() && !IsCriticalNative()) ? 1 : 0);
 }
 
 FrameOffset JniCallingConvention::SavedLocalReferenceCookieOffset() const {
@@ -182,7 +190,7 @@ FrameOffset JniCallingConvention::ReturnValueSaveLocation() const {
 }
 
 bool JniCallingConvention::HasNext() {
-  if (itr_args_ <= kObjectOrClass) {
+  if (IsCurrentArgJniExtra()) {
     return true;
   } else {
     unsigned int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
@@ -192,7 +200,7 @@ bool JniCallingConvention::HasNext() {
 
 void JniCallingConvention::Next() {
   CHECK(HasNext());
-  if (itr_args_ > kObjectOrClass) {
+  if (!IsCurrentArgJniExtra()) {
     int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
     if (IsParamALongOrDouble(arg_pos)) {
       itr_longs_and_doubles_++;
@@ -209,59 +217,48 @@ void JniCallingConvention::Next() {
   itr_slots_++;
 }
 
+bool JniCallingConvention::IsCurrentArgJniExtra() {
+  // The jobject of instance methods is covered here too, it is passed as a pointer.
+  return !IsCriticalNative() && itr_args_ <= kObjectOrClass;
+}
+
 bool JniCallingConvention::IsCurrentParamAReference() {
-  switch (itr_args_) {
-    case kJniEnv:
-      return false;  // JNIEnv*
-    case kObjectOrClass:
-      return true;   // jobject or jclass
-    default: {
-      int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
-      return IsParamAReference(arg_pos);
-    }
+  if (IsCurrentArgJniExtra()) {
+    return itr_args_ == kObjectOrClass;  // jobject or jclass, not JNIEnv*
+  } else {
+    int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
+    return IsParamAReference(arg_pos);
   }
 }
 
 bool JniCallingConvention::IsCurrentParamJniEnv() {
-  return (itr_args_ == kJniEnv);
+  return !IsCriticalNative() && (itr_args_ == kJniEnv);
 }
 
 bool JniCallingConvention::IsCurrentParamAFloatOrDouble() {
-  switch (itr_args_) {
-    case kJniEnv:
-      return false;  // JNIEnv*
-    case kObjectOrClass:
-      return false;   // jobject or jclass
-    default: {
-      int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
-      return IsParamAFloatOrDouble(arg_pos);
-    }
+  if (IsCurrentArgJniExtra()) {
+    return false;  // JNIEnv*, jobject or jclass
+  } else {
+    int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
+    return IsParamAFloatOrDouble(arg_pos);
   }
 }
 
 bool JniCallingConvention::IsCurrentParamADouble() {
-  switch (itr_args_) {
-    case kJniEnv:
-      return false;  // JNIEnv*
-    case kObjectOrClass:
-      return false;   // jobject or jclass
-    default: {
-      int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
-      return IsParamADouble(arg_pos);
-    }
+  if (IsCurrentArgJniExtra()) {
+    return false;  // JNIEnv*, jobject or jclass
+  } else {
+    int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
+    return IsParamADouble(arg_pos);
   }
 }
 
 bool JniCallingConvention::IsCurrentParamALong() {
-  switch (itr_args_) {
-    case kJniEnv:
-      return false;  // JNIEnv*
-    case kObjectOrClass:
-      return false;   // jobject or jclass
-    default: {
-      int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
-      return IsParamALong(arg_pos);
-    }
+  if (IsCurrentArgJniExtra()) {
+    return false;  // JNIEnv*, jobject or jclass
+  } else {
+    int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
+    return IsParamALong(arg_pos);
   }
 }
 
@@ -276,7 +273,7 @@ FrameOffset JniCallingConvention::CurrentParamHandleScopeEntryOffset() {
 }
 
 size_t JniCallingConvention::CurrentParamSize() {
-  if (itr_args_ <= kObjectOrClass) {
+  if (IsCurrentArgJniExtra()) {
     return frame_pointer_size_;  // JNIEnv or jobject/jclass
   } else {
     int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
@@ -285,6 +282,9 @@ size_t JniCallingConvention::CurrentParamSize() {
 }
 
 size_t JniCallingConvention::NumberOfExtraArgumentsForJni() {
+  if (IsCriticalNative()) {
+    return 0;  // Critical natives take only their own (primitive) arguments.
+  }
   // The first argument is the JNIEnv*.
   // Static methods have an extra argument which is the jclass.
   return IsStatic() ? 2 : 1;
@@ -56,6 +56,124 @@ static void SetNativeParameter(Assembler* jni_asm,
                                JniCallingConvention* jni_conv,
                                ManagedRegister in_reg);
 
+// Generate the JNI bridge for a critical native. The native code takes only primitive
+// arguments and is called as a plain C function: there is no JNIEnv*, no jclass, no handle
+// scope and no transition out of Runnable, so it must neither block nor call back into the
+// runtime. The frame is still a regular JNI frame, written to the thread so that the dlsym
+// lookup stub can find the method on the first call.
+static CompiledMethod* ArtJniCompileCriticalNativeMethod(CompilerDriver* driver,
+                                                         uint32_t method_idx,
+                                                         const DexFile& dex_file) {
+  const char* shorty = dex_file.GetMethodShorty(dex_file.GetMethodId(method_idx));
+  InstructionSet instruction_set = driver->GetInstructionSet();
+  const InstructionSetFeatures* instruction_set_features = driver->GetInstructionSetFeatures();
+  CHECK(Is64BitInstructionSet(instruction_set)) << instruction_set;
+  // Critical natives are static and never synchronized.
+  std::unique_ptr<JniCallingConvention> main_jni_conv(
+      JniCallingConvention::Create(/* is_static */ true,
+                                   /* is_synchronized */ false,
+                                   /* is_critical_native */ true,
+                                   shorty,
+                                   instruction_set));
+  std::unique_ptr<ManagedRuntimeCallingConvention> mr_conv(
+      ManagedRuntimeCallingConvention::Create(/* is_static */ true,
+                                              /* is_synchronized */ false,
+                                              shorty,
+                                              instruction_set));
+
+  std::unique_ptr<Assembler> jni_asm(Assembler::Create(instruction_set, instruction_set_features));
+  jni_asm->cfi().SetEnabled(driver->GetCompilerOptions().GetGenerateDebugInfo());
+
+  // 1. Build the frame saving all callee saves.
+  const size_t frame_size(main_jni_conv->FrameSize());
+  const std::vector<ManagedRegister>& callee_save_regs = main_jni_conv->CalleeSaveRegisters();
+  __ BuildFrame(frame_size, mr_conv->MethodRegister(), callee_save_regs, mr_conv->EntrySpills());
+  DCHECK_EQ(jni_asm->cfi().GetCurrentCFAOffset(), static_cast<int>(frame_size));
+
+  // 2. Write out the end of the quick frames.
+  __ StoreStackPointerToThread64(Thread::TopOfManagedStackOffset<8>());
+
+  // 3. Move frame down to allow space for out going args.
+  const size_t out_arg_size = main_jni_conv->OutArgSize();
+  __ IncreaseFrameSize(out_arg_size);
+
+  // 4. Shuffle the arguments from the managed to the native calling convention, with a
+  //    backward pass as for regular JNI stubs. There is nothing to skip in front of them.
+  mr_conv->ResetIterator(FrameOffset(frame_size + out_arg_size));
+  uint32_t args_count = 0;
+  while (mr_conv->HasNext()) {
+    args_count++;
+    mr_conv->Next();
+  }
+  for (uint32_t i = 0; i < args_count; ++i) {
+    mr_conv->ResetIterator(FrameOffset(frame_size + out_arg_size));
+    main_jni_conv->ResetIterator(FrameOffset(out_arg_size));
+    for (uint32_t j = 0; j < args_count - i - 1; ++j) {
+      mr_conv->Next();
+      main_jni_conv->Next();
+    }
+    CopyParameter(jni_asm.get(), mr_conv.get(), main_jni_conv.get(), frame_size, out_arg_size);
+  }
+
+  // 5. Plant call to native code associated with method.
+  main_jni_conv->ResetIterator(FrameOffset(out_arg_size));
+  MemberOffset jni_entrypoint_offset = ArtMethod::EntryPointFromJniOffset(
+      InstructionSetPointerSize(instruction_set));
+  __ Call(main_jni_conv->MethodStackOffset(), jni_entrypoint_offset,
+          mr_conv->InterproceduralScratchRegister());
+
+  // 6. Fix differences in result widths.
+  if (main_jni_conv->RequiresSmallResultTypeExtension()) {
+    if (main_jni_conv->GetReturnType() == Primitive::kPrimByte ||
+        main_jni_conv->GetReturnType() == Primitive::kPrimShort) {
+      __ SignExtend(main_jni_conv->ReturnRegister(),
+                    Primitive::ComponentSize(main_jni_conv->GetReturnType()));
+    } else if (main_jni_conv->GetReturnType() == Primitive::kPrimBoolean ||
+               main_jni_conv->GetReturnType() == Primitive::kPrimChar) {
+      __ ZeroExtend(main_jni_conv->ReturnRegister(),
+                    Primitive::ComponentSize(main_jni_conv->GetReturnType()));
+    }
+  }
+
+  // 7. Move the result to where managed code expects it, if that differs.
+  if (main_jni_conv->SizeOfReturnValue() != 0 &&
+      !mr_conv->ReturnRegister().Equals(main_jni_conv->ReturnRegister())) {
+    __ Move(mr_conv->ReturnRegister(), main_jni_conv->ReturnRegister(),
+            mr_conv->SizeOfReturnValue());
+  }
+
+  // 8. Move frame up now we're done with the out arg space.
+  __ DecreaseFrameSize(out_arg_size);
+
+  // 9. Process a pending exception, which only the dlsym lookup of the native code can raise.
+  __ ExceptionPoll(main_jni_conv->InterproceduralScratchRegister(), 0);
+
+  // 10. Remove activation.
+  DCHECK_EQ(jni_asm->cfi().GetCurrentCFAOffset(), static_cast<int>(frame_size));
+  __ RemoveFrame(frame_size, callee_save_regs);
+  DCHECK_EQ(jni_asm->cfi().GetCurrentCFAOffset(), static_cast<int>(frame_size));
+
+  // 11. Finalize code generation
+  __ FinalizeCode();
+  size_t cs = __ CodeSize();
+  std::vector<uint8_t> managed_code(cs);
+  MemoryRegion code(&managed_code[0], managed_code.size());
+  __ FinalizeInstructions(code);
+
+  return CompiledMethod::SwapAllocCompiledMethod(driver,
+                                                 instruction_set,
+                                                 ArrayRef<const uint8_t>(managed_code),
+                                                 frame_size,
+                                                 main_jni_conv->CoreSpillMask(),
+                                                 main_jni_conv->FpSpillMask(),
+                                                 nullptr,  // src_mapping_table.
+                                                 ArrayRef<const uint8_t>(),  // mapping_table.
+                                                 ArrayRef<const uint8_t>(),  // vmap_table.
+                                                 ArrayRef<const uint8_t>(),  // native_gc_map.
+                                                 ArrayRef<const uint8_t>(*jni_asm->cfi().data()),
+                                                 ArrayRef<const LinkerPatch>());
+}
+
 // Generate the JNI bridge for the given method, general contract:
 // - Arguments are in the managed runtime format, either on stack or in
 //   registers, a reference to the method object is supplied as part of this
@@ -66,6 +184,9 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
                                             const DexFile& dex_file) {
   const bool is_native = (access_flags & kAccNative) != 0;
   CHECK(is_native);
+  if ((access_flags & kAccCriticalNative) != 0) {
+    return ArtJniCompileCriticalNativeMethod(driver, method_idx, dex_file);
+  }
   const bool is_static = (access_flags & kAccStatic) != 0;
   const bool is_synchronized = (access_flags & kAccSynchronized) != 0;
   const char* shorty = dex_file.GetMethodShorty(dex_file.GetMethodId(method_idx));
@@ -74,7 +195,8 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   const bool is_64_bit_target = Is64BitInstructionSet(instruction_set);
   // Calling conventions used to iterate over parameters to method
   std::unique_ptr<JniCallingConvention> main_jni_conv(
-      JniCallingConvention::Create(is_static, is_synchronized, shorty, instruction_set));
+      JniCallingConvention::Create(is_static, is_synchronized, /* is_critical_native */ false,
+                                   shorty, instruction_set));
   bool reference_return = main_jni_conv->IsReturnAReference();
 
   std::unique_ptr<ManagedRuntimeCallingConvention> mr_conv(
@@ -94,7 +216,8 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   }
 
   std::unique_ptr<JniCallingConvention> end_jni_conv(
-      JniCallingConvention::Create(is_static, is_synchronized, jni_end_shorty, instruction_set));
+      JniCallingConvention::Create(is_static, is_synchronized, /* is_critical_native */ false,
+                                   jni_end_shorty, instruction_set));
 
   // Assembler that holds generated instructions
   std::unique_ptr<Assembler> jni_asm(Assembler::Create(instruction_set, instruction_set_features));
@@ -706,6 +706,12 @@ class MonotonicValueRange : public ValueRange {
       return this;
     }
 
+    if (pre_header->EndsWithTryBoundary()) {
+      // The loop is entered from a try boundary, whose exceptional successors
+      // would be lost when transforming the loop header.
+      return this;
+    }
+
     ArrayAccessInsideLoopFinder finder(induction_variable_);
 
     if (!finder.HasFoundArrayLength()) {
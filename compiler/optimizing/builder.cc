@@ -25,6 +25,7 @@
 #include "dex/verified_method.h"
 #include "driver/compiler_driver-inl.h"
 #include "driver/compiler_options.h"
+#include "jit/osr_entry.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
 #include "nodes.h"
@@ -199,6 +200,51 @@ void HGraphBuilder::InitializeParameters(uint16_t number_of_parameters) {
   }
 }
 
+bool HGraphBuilder::InitializeOsrEntry() {
+  HBasicBlock* loop_header = FindBlockStartingAt(osr_entry_->GetDexPc());
+  if (loop_header == nullptr || loop_header->IsCatchBlock()) {
+    return false;
+  }
+  // The code before the loop header is not reachable anymore, and gets removed when
+  // building the dominator tree.
+  entry_block_->ReplaceSuccessor(entry_block_->GetSuccessors()[0], loop_header);
+
+  // References are typed as Object: the verifier knows better, but does not record it.
+  const DexFile::StringId* object_descriptor = dex_file_->FindStringId("Ljava/lang/Object;");
+  const DexFile::TypeId* object_type_id = (object_descriptor == nullptr)
+      ? nullptr
+      : dex_file_->FindTypeId(dex_file_->GetIndexForStringId(*object_descriptor));
+  int parameter_index = 0;
+  for (size_t i = 0, e = osr_entry_->GetNumberOfArguments(); i < e; ++i) {
+    Primitive::Type type = osr_entry_->GetArgumentType(i);
+    uint16_t type_index = 0;
+    if (type == Primitive::kPrimNot) {
+      if (object_type_id == nullptr) {
+        return false;
+      }
+      type_index = dex_file_->GetIndexForTypeId(*object_type_id);
+    }
+    HParameterValue* parameter =
+        new (arena_) HParameterValue(*dex_file_, type_index, parameter_index++, type, false);
+    entry_block_->AddInstruction(parameter);
+    HLocal* local = GetLocalAt(osr_entry_->GetArgumentVReg(i));
+    entry_block_->AddInstruction(new (arena_) HStoreLocal(local, parameter, local->GetDexPc()));
+    if (Primitive::Is64BitType(type)) {
+      parameter_index++;
+    }
+  }
+
+  for (size_t i = 0, e = osr_entry_->GetNumberOfConstants(); i < e; ++i) {
+    HConstant* constant = osr_entry_->IsWideConstant(i)
+        ? static_cast<HConstant*>(graph_->GetLongConstant(osr_entry_->GetConstantValue(i)))
+        : static_cast<HConstant*>(graph_->GetIntConstant(
+              static_cast<int32_t>(osr_entry_->GetConstantValue(i))));
+    HLocal* local = GetLocalAt(osr_entry_->GetConstantVReg(i));
+    entry_block_->AddInstruction(new (arena_) HStoreLocal(local, constant, local->GetDexPc()));
+  }
+  return true;
+}
+
 template<typename T>
 void HGraphBuilder::If_22t(const Instruction& instruction, uint32_t dex_pc) {
   int32_t target_offset = instruction.GetTargetOffset();
@@ -468,7 +514,17 @@ bool HGraphBuilder::BuildGraph(const DexFile::CodeItem& code_item) {
 
   CreateBlocksForTryCatch(code_item);
 
-  InitializeParameters(code_item.ins_size_);
+  if (osr_entry_ != nullptr) {
+    // The parameters of the method are not the ones of the compiled code, but the graph
+    // still knows how many dex registers the method takes as input.
+    graph_->SetNumberOfInVRegs(code_item.ins_size_);
+    if (!InitializeOsrEntry()) {
+      MaybeRecordStat(MethodCompilationStat::kNotCompiledOsr);
+      return false;
+    }
+  } else {
+    InitializeParameters(code_item.ins_size_);
+  }
 
   size_t dex_pc = 0;
   while (code_ptr < code_end) {
@@ -2575,15 +2631,39 @@ bool HGraphBuilder::AnalyzeDexInstruction(const Instruction& instruction, uint32
         current_block_->AddInstruction(fake_string);
         UpdateLocal(register_index, fake_string, dex_pc);
       } else {
-        QuickEntrypointEnum entrypoint = NeedsAccessCheck(type_index)
+        bool needs_access_check = NeedsAccessCheck(type_index);
+        QuickEntrypointEnum entrypoint = needs_access_check
             ? kQuickAllocObjectWithAccessCheck
             : kQuickAllocObject;
 
+        bool can_throw_other_than_oome = true;
+        bool finalizable = true;
+        {
+          ScopedObjectAccess soa(Thread::Current());
+          StackHandleScope<1> hs(soa.Self());
+          Handle<mirror::DexCache> dex_cache(hs.NewHandle(
+              dex_compilation_unit_->GetClassLinker()->FindDexCache(
+                  soa.Self(), *dex_compilation_unit_->GetDexFile())));
+          mirror::Class* resolved_class = dex_cache->GetResolvedType(type_index);
+          if (resolved_class != nullptr) {
+            finalizable = resolved_class->IsFinalizable();
+            // As for static field accesses, the class is only known to be
+            // initialized if it is also in the dex cache.
+            can_throw_other_than_oome = needs_access_check ||
+                !resolved_class->IsInstantiable() ||
+                !resolved_class->IsInitialized() ||
+                !compiler_driver_->CanAssumeTypeIsPresentInDexCache(
+                    *dex_compilation_unit_->GetDexFile(), type_index);
+          }
+        }
+
         current_block_->AddInstruction(new (arena_) HNewInstance(
             graph_->GetCurrentMethod(),
             dex_pc,
             type_index,
             *dex_compilation_unit_->GetDexFile(),
+            can_throw_other_than_oome,
+            finalizable,
             entrypoint));
         UpdateLocal(instruction.VRegA(), current_block_->GetLastInstruction(), dex_pc);
       }
@@ -29,6 +29,10 @@
 
 namespace art {
 
+namespace jit {
+class OsrEntry;
+}  // namespace jit
+
 class Instruction;
 class SwitchTable;
 
@@ -41,7 +45,8 @@ class HGraphBuilder : public ValueObject {
                 CompilerDriver* driver,
                 OptimizingCompilerStats* compiler_stats,
                 const uint8_t* interpreter_metadata,
-                Handle<mirror::DexCache> dex_cache)
+                Handle<mirror::DexCache> dex_cache,
+                const jit::OsrEntry* osr_entry = nullptr)
       : arena_(graph->GetArena()),
         branch_targets_(graph->GetArena()->Adapter(kArenaAllocGraphBuilder)),
         locals_(graph->GetArena()->Adapter(kArenaAllocGraphBuilder)),
@@ -59,7 +64,8 @@ class HGraphBuilder : public ValueObject {
         can_use_baseline_for_string_init_(true),
         compilation_stats_(compiler_stats),
         interpreter_metadata_(interpreter_metadata),
-        dex_cache_(dex_cache) {}
+        dex_cache_(dex_cache),
+        osr_entry_(osr_entry) {}
 
   // Only for unit testing.
   HGraphBuilder(HGraph* graph, Primitive::Type return_type = Primitive::kPrimInt)
@@ -80,7 +86,8 @@ class HGraphBuilder : public ValueObject {
         can_use_baseline_for_string_init_(true),
         compilation_stats_(nullptr),
         interpreter_metadata_(nullptr),
-        dex_cache_(NullHandle<mirror::DexCache>()) {}
+        dex_cache_(NullHandle<mirror::DexCache>()),
+        osr_entry_(nullptr) {}
 
   bool BuildGraph(const DexFile::CodeItem& code);
 
@@ -138,6 +145,10 @@ class HGraphBuilder : public ValueObject {
   HInstruction* LoadLocal(uint32_t register_index, Primitive::Type type, uint32_t dex_pc) const;
   void PotentiallyAddSuspendCheck(HBasicBlock* target, uint32_t dex_pc);
   void InitializeParameters(uint16_t number_of_parameters);
+  // Make the entry block jump to the loop header of `osr_entry_`, and initialize the dex
+  // registers live there from the parameters and constants it describes. Returns false
+  // if the graph cannot be entered at that loop header.
+  bool InitializeOsrEntry();
   bool NeedsAccessCheck(uint32_t type_index) const;
 
   template<typename T>
@@ -362,6 +373,10 @@ class HGraphBuilder : public ValueObject {
   // Dex cache for dex_file_.
   Handle<mirror::DexCache> dex_cache_;
 
+  // If not null, we are compiling the on-stack replacement version of the method, entered at
+  // the loop header it describes.
+  const jit::OsrEntry* const osr_entry_;
+
   DISALLOW_COPY_AND_ASSIGN(HGraphBuilder);
 };
 
@@ -3236,6 +3236,59 @@ void InstructionCodeGeneratorARM::VisitBooleanNot(HBooleanNot* bool_not) {
   __ eor(out.AsRegister<Register>(), in.AsRegister<Register>(), ShifterOperand(1));
 }
 
+void LocationsBuilderARM::VisitSelect(HSelect* select) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(select, LocationSummary::kNoCall);
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    locations->SetInAt(0, Location::RequiresFpuRegister());
+    locations->SetInAt(1, Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetInAt(1, Location::RequiresRegister());
+  }
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+}
+
+void InstructionCodeGeneratorARM::VisitSelect(HSelect* select) {
+  LocationSummary* locations = select->GetLocations();
+  Location out = locations->Out();
+  Location true_value = locations->InAt(1);
+  Register condition = locations->InAt(2).AsRegister<Register>();
+  DCHECK(locations->InAt(0).Equals(out));
+
+  // The output holds the false value, overwrite it if the condition is true.
+  __ cmp(condition, ShifterOperand(0));
+  switch (select->GetType()) {
+    case Primitive::kPrimLong:
+      __ it(NE, kItThen);
+      __ mov(out.AsRegisterPairLow<Register>(),
+             ShifterOperand(true_value.AsRegisterPairLow<Register>()),
+             NE);
+      __ mov(out.AsRegisterPairHigh<Register>(),
+             ShifterOperand(true_value.AsRegisterPairHigh<Register>()),
+             NE);
+      break;
+
+    case Primitive::kPrimFloat:
+      __ it(NE);
+      __ vmovs(out.AsFpuRegister<SRegister>(), true_value.AsFpuRegister<SRegister>(), NE);
+      break;
+
+    case Primitive::kPrimDouble:
+      __ it(NE);
+      __ vmovd(FromLowSToD(out.AsFpuRegisterPairLow<SRegister>()),
+               FromLowSToD(true_value.AsFpuRegisterPairLow<SRegister>()),
+               NE);
+      break;
+
+    default:
+      __ it(NE);
+      __ mov(out.AsRegister<Register>(), ShifterOperand(true_value.AsRegister<Register>()), NE);
+      break;
+  }
+}
+
 void LocationsBuilderARM::VisitCompare(HCompare* compare) {
   LocationSummary* locations =
       new (GetGraph()->GetArena()) LocationSummary(compare, LocationSummary::kNoCall);
@@ -62,6 +62,7 @@ using helpers::OutputRegister;
 using helpers::RegisterFrom;
 using helpers::StackOperandFrom;
 using helpers::VIXLRegCodeFromART;
+using helpers::VRegisterFrom;
 using helpers::WRegisterFrom;
 using helpers::XRegisterFrom;
 using helpers::ARM64EncodableConstantOrRegister;
@@ -3373,6 +3374,35 @@ void InstructionCodeGeneratorARM64::VisitBooleanNot(HBooleanNot* instruction) {
   __ Eor(OutputRegister(instruction), InputRegisterAt(instruction, 0), vixl::Operand(1));
 }
 
+void LocationsBuilderARM64::VisitSelect(HSelect* select) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(select);
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    locations->SetInAt(0, Location::RequiresFpuRegister());
+    locations->SetInAt(1, Location::RequiresFpuRegister());
+    locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+  } else {
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetInAt(1, Location::RequiresRegister());
+    locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+  }
+  locations->SetInAt(2, Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorARM64::VisitSelect(HSelect* select) {
+  __ Cmp(InputRegisterAt(select, 2), 0);
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    __ Fcsel(OutputFPRegister(select),
+             InputFPRegisterAt(select, 1),
+             InputFPRegisterAt(select, 0),
+             ne);
+  } else {
+    __ Csel(OutputRegister(select),
+            InputRegisterAt(select, 1),
+            InputRegisterAt(select, 0),
+            ne);
+  }
+}
+
 void LocationsBuilderARM64::VisitNullCheck(HNullCheck* instruction) {
   LocationSummary::CallKind call_kind = instruction->CanThrowIntoCatchBlock()
       ? LocationSummary::kCallOnSlowPath
@@ -3699,6 +3729,216 @@ void InstructionCodeGeneratorARM64::VisitSuspendCheck(HSuspendCheck* instruction
   GenerateSuspendCheck(instruction, nullptr);
 }
 
+// Address of the vector of `packed_type` elements of `array` starting at `index`. Loads and
+// stores of Q registers only scale a register offset by 16, so a non-constant index is first
+// added to the array in `temp`.
+MemOperand InstructionCodeGeneratorARM64::VecArrayAddress(Register array,
+                                                          Location index,
+                                                          Primitive::Type packed_type,
+                                                          Register temp) {
+  size_t shift = Primitive::ComponentSizeShift(packed_type);
+  uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(packed_type)).Uint32Value();
+  if (index.IsConstant()) {
+    return HeapOperand(array, (Int64ConstantFrom(index) << shift) + data_offset);
+  }
+  __ Add(temp, array.X(), Operand(XRegisterFrom(index), LSL, shift));
+  return MemOperand(temp, data_offset);
+}
+
+void InstructionCodeGeneratorARM64::GenerateVecBroadcast(const VRegister& dst,
+                                                         Location src,
+                                                         Primitive::Type packed_type) {
+  switch (packed_type) {
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+    case Primitive::kPrimInt:
+      __ Dup(dst, WRegisterFrom(src));
+      break;
+    case Primitive::kPrimLong:
+      __ Dup(dst, XRegisterFrom(src));
+      break;
+    case Primitive::kPrimFloat:
+    case Primitive::kPrimDouble:
+      __ Dup(dst, VRegisterFrom(src, packed_type), 0);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected packed type " << packed_type;
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorARM64::GenerateVecOperation(VecOperationKind kind,
+                                                         Primitive::Type packed_type,
+                                                         const VRegister& dst,
+                                                         const VRegister& src) {
+  bool is_fp = Primitive::IsFloatingPointType(packed_type);
+  switch (kind) {
+    case VecOperationKind::kAdd:
+      if (is_fp) {
+        __ Fadd(dst, dst, src);
+      } else {
+        __ Add(dst, dst, src);
+      }
+      break;
+    case VecOperationKind::kSub:
+      if (is_fp) {
+        __ Fsub(dst, dst, src);
+      } else {
+        __ Sub(dst, dst, src);
+      }
+      break;
+    case VecOperationKind::kMul:
+      if (is_fp) {
+        __ Fmul(dst, dst, src);
+      } else {
+        // There is no multiplication of 64-bit lanes.
+        DCHECK_NE(packed_type, Primitive::kPrimLong);
+        __ Mul(dst, dst, src);
+      }
+      break;
+    case VecOperationKind::kDiv:
+      DCHECK(is_fp);
+      __ Fdiv(dst, dst, src);
+      break;
+    case VecOperationKind::kMin:
+      DCHECK_EQ(packed_type, Primitive::kPrimInt);
+      __ Smin(dst, dst, src);
+      break;
+    case VecOperationKind::kMax:
+      DCHECK_EQ(packed_type, Primitive::kPrimInt);
+      __ Smax(dst, dst, src);
+      break;
+    case VecOperationKind::kAnd:
+      DCHECK(!is_fp);
+      __ And(dst.V16B(), dst.V16B(), src.V16B());
+      break;
+    case VecOperationKind::kOr:
+      DCHECK(!is_fp);
+      __ Orr(dst.V16B(), dst.V16B(), src.V16B());
+      break;
+    case VecOperationKind::kXor:
+      DCHECK(!is_fp);
+      __ Eor(dst.V16B(), dst.V16B(), src.V16B());
+      break;
+  }
+}
+
+void LocationsBuilderARM64::VisitVecArrayOperation(HVecArrayOperation* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RegisterOrConstant(instruction->GetIndex()));
+  locations->SetInAt(2, Location::RequiresRegister());
+  if (Primitive::IsFloatingPointType(instruction->GetRight()->GetType())) {
+    locations->SetInAt(3, Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(3, Location::RequiresRegister());
+  }
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorARM64::VisitVecArrayOperation(HVecArrayOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Primitive::Type packed_type = instruction->GetPackedType();
+  Register array = InputRegisterAt(instruction, 0);
+  Location index = locations->InAt(1);
+  Register left = InputRegisterAt(instruction, 2);
+  Location right = locations->InAt(3);
+  VRegister vector = VRegisterFrom(locations->GetTemp(0), packed_type);
+  VRegister right_vector = VRegisterFrom(locations->GetTemp(1), packed_type);
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register temp = temps.AcquireX();
+
+  // Each address is used before the next one is computed in `temp`.
+  __ Ldr(vector.Q(), VecArrayAddress(left, index, packed_type, temp));
+  if (instruction->IsRightAnArray()) {
+    __ Ldr(right_vector.Q(),
+           VecArrayAddress(RegisterFrom(right, Primitive::kPrimNot), index, packed_type, temp));
+  } else {
+    GenerateVecBroadcast(right_vector, right, packed_type);
+  }
+  GenerateVecOperation(instruction->GetOperationKind(), packed_type, vector, right_vector);
+  __ Str(vector.Q(), VecArrayAddress(array, index, packed_type, temp));
+}
+
+void LocationsBuilderARM64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RegisterOrConstant(instruction->GetIndex()));
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorARM64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Primitive::Type packed_type = instruction->GetPackedType();
+  VecOperationKind kind = instruction->GetOperationKind();
+  Register out = OutputRegister(instruction);
+  Register accumulator = InputRegisterAt(instruction, 0);
+  Register array = InputRegisterAt(instruction, 1);
+  Location index = locations->InAt(2);
+  VRegister vector = VRegisterFrom(locations->GetTemp(0), packed_type);
+  VRegister shuffled = VRegisterFrom(locations->GetTemp(1), packed_type);
+  bool is64bit = packed_type == Primitive::kPrimLong;
+  DCHECK(is64bit || packed_type == Primitive::kPrimInt) << packed_type;
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register temp = temps.AcquireX();
+  Register scalar = temps.AcquireSameSizeAs(out);
+
+  __ Ldr(vector.Q(), VecArrayAddress(array, index, packed_type, temp));
+  if (!is64bit && kind == VecOperationKind::kAdd) {
+    __ Addv(vector.S(), vector);
+  } else if (!is64bit && kind == VecOperationKind::kMin) {
+    __ Sminv(vector.S(), vector);
+  } else if (!is64bit && kind == VecOperationKind::kMax) {
+    __ Smaxv(vector.S(), vector);
+  } else {
+    // There is no across-lanes form of the other reductions. Fold the upper
+    // half of the vector into the lower half, then, for ints, the second lane
+    // into the first one.
+    __ Ext(shuffled.V16B(), vector.V16B(), vector.V16B(), 8);
+    GenerateVecOperation(kind, packed_type, vector, shuffled);
+    if (!is64bit) {
+      __ Ext(shuffled.V16B(), vector.V16B(), vector.V16B(), 4);
+      GenerateVecOperation(kind, packed_type, vector, shuffled);
+    }
+  }
+  __ Fmov(scalar, is64bit ? vector.D() : vector.S());
+
+  switch (kind) {
+    case VecOperationKind::kAdd:
+      __ Add(out, accumulator, scalar);
+      break;
+    case VecOperationKind::kAnd:
+      __ And(out, accumulator, scalar);
+      break;
+    case VecOperationKind::kOr:
+      __ Orr(out, accumulator, scalar);
+      break;
+    case VecOperationKind::kXor:
+      __ Eor(out, accumulator, scalar);
+      break;
+    case VecOperationKind::kMin:
+      __ Cmp(accumulator, scalar);
+      __ Csel(out, accumulator, scalar, lt);
+      break;
+    case VecOperationKind::kMax:
+      __ Cmp(accumulator, scalar);
+      __ Csel(out, accumulator, scalar, gt);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected reduction " << kind;
+      UNREACHABLE();
+  }
+}
+
 void LocationsBuilderARM64::VisitTemporary(HTemporary* temp) {
   temp->SetLocations(nullptr);
 }
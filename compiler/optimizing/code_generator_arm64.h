@@ -180,6 +180,7 @@ class InstructionCodeGeneratorARM64 : public HGraphVisitor {
 
   FOR_EACH_CONCRETE_INSTRUCTION_COMMON(DECLARE_VISIT_INSTRUCTION)
   FOR_EACH_CONCRETE_INSTRUCTION_ARM64(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(DECLARE_VISIT_INSTRUCTION)
 
 #undef DECLARE_VISIT_INSTRUCTION
 
@@ -212,6 +213,18 @@ class InstructionCodeGeneratorARM64 : public HGraphVisitor {
   void GenerateDivRemWithAnyConstant(HBinaryOperation* instruction);
   void GenerateDivRemIntegral(HBinaryOperation* instruction);
   void HandleGoto(HInstruction* got, HBasicBlock* successor);
+  // Returns the address of a vector of array elements, which may be computed in `temp`.
+  vixl::MemOperand VecArrayAddress(vixl::Register array,
+                                   Location index,
+                                   Primitive::Type packed_type,
+                                   vixl::Register temp);
+  // Replicates the scalar in `src` into all the lanes of `dst`.
+  void GenerateVecBroadcast(const vixl::VRegister& dst, Location src, Primitive::Type packed_type);
+  // Computes `dst = dst op src` lane by lane.
+  void GenerateVecOperation(VecOperationKind kind,
+                            Primitive::Type packed_type,
+                            const vixl::VRegister& dst,
+                            const vixl::VRegister& src);
 
   Arm64Assembler* const assembler_;
   CodeGeneratorARM64* const codegen_;
@@ -229,6 +242,7 @@ class LocationsBuilderARM64 : public HGraphVisitor {
 
   FOR_EACH_CONCRETE_INSTRUCTION_COMMON(DECLARE_VISIT_INSTRUCTION)
   FOR_EACH_CONCRETE_INSTRUCTION_ARM64(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(DECLARE_VISIT_INSTRUCTION)
 
 #undef DECLARE_VISIT_INSTRUCTION
 
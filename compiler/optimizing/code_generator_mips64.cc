@@ -2977,6 +2977,56 @@ void InstructionCodeGeneratorMIPS64::VisitBooleanNot(HBooleanNot* instruction) {
           1);
 }
 
+void LocationsBuilderMIPS64::VisitSelect(HSelect* select) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(select);
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    locations->SetInAt(0, Location::RequiresFpuRegister());
+    locations->SetInAt(1, Location::RequiresFpuRegister());
+    locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+  } else {
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetInAt(1, Location::RequiresRegister());
+    locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+  }
+  locations->SetInAt(2, Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorMIPS64::VisitSelect(HSelect* select) {
+  LocationSummary* locations = select->GetLocations();
+  GpuRegister condition = locations->InAt(2).AsRegister<GpuRegister>();
+
+  switch (select->GetType()) {
+    case Primitive::kPrimFloat:
+    case Primitive::kPrimDouble: {
+      // SEL.fmt picks its second source if bit 0 of its destination is set.
+      FpuRegister out = locations->Out().AsFpuRegister<FpuRegister>();
+      FpuRegister false_value = locations->InAt(0).AsFpuRegister<FpuRegister>();
+      FpuRegister true_value = locations->InAt(1).AsFpuRegister<FpuRegister>();
+      __ Mtc1(condition, FTMP);
+      if (select->GetType() == Primitive::kPrimFloat) {
+        __ SelS(FTMP, false_value, true_value);
+        __ MovS(out, FTMP);
+      } else {
+        __ SelD(FTMP, false_value, true_value);
+        __ MovD(out, FTMP);
+      }
+      break;
+    }
+
+    default: {
+      // MOVN is not in MIPS64 R6. Keep each value where the condition picks it
+      // and zero the other, then combine them.
+      GpuRegister out = locations->Out().AsRegister<GpuRegister>();
+      GpuRegister false_value = locations->InAt(0).AsRegister<GpuRegister>();
+      GpuRegister true_value = locations->InAt(1).AsRegister<GpuRegister>();
+      __ Selnez(TMP, true_value, condition);
+      __ Seleqz(out, false_value, condition);
+      __ Or(out, out, TMP);
+      break;
+    }
+  }
+}
+
 void LocationsBuilderMIPS64::VisitNullCheck(HNullCheck* instruction) {
   LocationSummary::CallKind call_kind = instruction->CanThrowIntoCatchBlock()
       ? LocationSummary::kCallOnSlowPath
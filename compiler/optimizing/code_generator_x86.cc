@@ -17,6 +17,7 @@
 
 #include "code_generator_x86.h"
 
+#include "arch/x86/instruction_set_features_x86.h"
 #include "art_method.h"
 #include "code_generator_utils.h"
 #include "compiled_method.h"
@@ -3636,6 +3637,56 @@ void InstructionCodeGeneratorX86::VisitBooleanNot(HBooleanNot* bool_not) {
   __ xorl(out.AsRegister<Register>(), Immediate(1));
 }
 
+void LocationsBuilderX86::VisitSelect(HSelect* select) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(select, LocationSummary::kNoCall);
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    locations->SetInAt(0, Location::RequiresFpuRegister());
+    locations->SetInAt(1, Location::Any());
+  } else {
+    // Cmov only takes a register source.
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetInAt(1, Location::RequiresRegister());
+  }
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+}
+
+void InstructionCodeGeneratorX86::VisitSelect(HSelect* select) {
+  LocationSummary* locations = select->GetLocations();
+  Location out = locations->Out();
+  Location true_value = locations->InAt(1);
+  Register condition = locations->InAt(2).AsRegister<Register>();
+  DCHECK(locations->InAt(0).Equals(out));
+
+  // The output holds the false value, overwrite it if the condition is true.
+  __ testl(condition, condition);
+  switch (select->GetType()) {
+    case Primitive::kPrimLong:
+      __ cmovl(kNotEqual,
+               out.AsRegisterPairLow<Register>(),
+               true_value.AsRegisterPairLow<Register>());
+      __ cmovl(kNotEqual,
+               out.AsRegisterPairHigh<Register>(),
+               true_value.AsRegisterPairHigh<Register>());
+      break;
+
+    case Primitive::kPrimFloat:
+    case Primitive::kPrimDouble: {
+      // There is no conditional move to an XMM register.
+      NearLabel done;
+      __ j(kEqual, &done);
+      codegen_->MoveLocation(out, true_value, select->GetType());
+      __ Bind(&done);
+      break;
+    }
+
+    default:
+      __ cmovl(kNotEqual, out.AsRegister<Register>(), true_value.AsRegister<Register>());
+      break;
+  }
+}
+
 void LocationsBuilderX86::VisitCompare(HCompare* compare) {
   LocationSummary* locations =
       new (GetGraph()->GetArena()) LocationSummary(compare, LocationSummary::kNoCall);
@@ -4750,6 +4801,236 @@ void InstructionCodeGeneratorX86::VisitBoundsCheck(HBoundsCheck* instruction) {
   }
 }
 
+// Address of the vector of `packed_type` elements of `array` starting at `index`.
+static Address VecArrayAddress(Register array, Location index, Primitive::Type packed_type) {
+  ScaleFactor scale = static_cast<ScaleFactor>(Primitive::ComponentSizeShift(packed_type));
+  uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(packed_type)).Uint32Value();
+  if (index.IsConstant()) {
+    return Address(array, (index.GetConstant()->AsIntConstant()->GetValue() << scale) + data_offset);
+  }
+  return Address(array, index.AsRegister<Register>(), scale, data_offset);
+}
+
+void InstructionCodeGeneratorX86::GenerateVecBroadcast(XmmRegister dst,
+                                                          Location src,
+                                                          Primitive::Type packed_type) {
+  switch (packed_type) {
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+      __ movd(dst, src.AsRegister<Register>());
+      __ punpcklbw(dst, dst);
+      __ punpcklwd(dst, dst);
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ movd(dst, src.AsRegister<Register>());
+      __ punpcklwd(dst, dst);
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimInt:
+      __ movd(dst, src.AsRegister<Register>());
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimFloat:
+      __ pshufd(dst, src.AsFpuRegister<XmmRegister>(), Immediate(0));
+      break;
+    case Primitive::kPrimDouble:
+      __ pshufd(dst, src.AsFpuRegister<XmmRegister>(), Immediate(0x44));
+      break;
+    default:
+      LOG(FATAL) << "Unexpected packed type " << packed_type;
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86::GenerateVecOperation(VecOperationKind kind,
+                                                          Primitive::Type packed_type,
+                                                          XmmRegister dst,
+                                                          XmmRegister src) {
+  size_t size = Primitive::ComponentSize(packed_type);
+  bool is_fp = Primitive::IsFloatingPointType(packed_type);
+  switch (kind) {
+    case VecOperationKind::kAdd:
+      if (is_fp) {
+        if (size == 4) {
+          __ addps(dst, src);
+        } else {
+          __ addpd(dst, src);
+        }
+      } else {
+        switch (size) {
+          case 1: __ paddb(dst, src); break;
+          case 2: __ paddw(dst, src); break;
+          case 4: __ paddd(dst, src); break;
+          default: __ paddq(dst, src); break;
+        }
+      }
+      break;
+    case VecOperationKind::kSub:
+      if (is_fp) {
+        if (size == 4) {
+          __ subps(dst, src);
+        } else {
+          __ subpd(dst, src);
+        }
+      } else {
+        switch (size) {
+          case 1: __ psubb(dst, src); break;
+          case 2: __ psubw(dst, src); break;
+          case 4: __ psubd(dst, src); break;
+          default: __ psubq(dst, src); break;
+        }
+      }
+      break;
+    case VecOperationKind::kMul:
+      if (is_fp) {
+        if (size == 4) {
+          __ mulps(dst, src);
+        } else {
+          __ mulpd(dst, src);
+        }
+      } else if (size == 2) {
+        __ pmullw(dst, src);
+      } else {
+        DCHECK_EQ(size, 4u);
+        DCHECK(codegen_->GetInstructionSetFeatures().HasSSE4_1());
+        __ pmulld(dst, src);
+      }
+      break;
+    case VecOperationKind::kDiv:
+      DCHECK(is_fp);
+      if (size == 4) {
+        __ divps(dst, src);
+      } else {
+        __ divpd(dst, src);
+      }
+      break;
+    case VecOperationKind::kMin:
+      DCHECK_EQ(packed_type, Primitive::kPrimInt);
+      DCHECK(codegen_->GetInstructionSetFeatures().HasSSE4_1());
+      __ pminsd(dst, src);
+      break;
+    case VecOperationKind::kMax:
+      DCHECK_EQ(packed_type, Primitive::kPrimInt);
+      DCHECK(codegen_->GetInstructionSetFeatures().HasSSE4_1());
+      __ pmaxsd(dst, src);
+      break;
+    case VecOperationKind::kAnd:
+      DCHECK(!is_fp);
+      __ pand(dst, src);
+      break;
+    case VecOperationKind::kOr:
+      DCHECK(!is_fp);
+      __ por(dst, src);
+      break;
+    case VecOperationKind::kXor:
+      DCHECK(!is_fp);
+      __ pxor(dst, src);
+      break;
+  }
+}
+
+void LocationsBuilderX86::VisitVecArrayOperation(HVecArrayOperation* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RegisterOrConstant(instruction->GetIndex()));
+  locations->SetInAt(2, Location::RequiresRegister());
+  if (Primitive::IsFloatingPointType(instruction->GetRight()->GetType())) {
+    locations->SetInAt(3, Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(3, Location::RequiresRegister());
+  }
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86::VisitVecArrayOperation(HVecArrayOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Register array = locations->InAt(0).AsRegister<Register>();
+  Location index = locations->InAt(1);
+  Register left = locations->InAt(2).AsRegister<Register>();
+  Location right = locations->InAt(3);
+  XmmRegister vector = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister right_vector = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  Primitive::Type packed_type = instruction->GetPackedType();
+
+  // The elements need not be aligned, so they are loaded with movdqu rather
+  // than being used as memory operands.
+  __ movdqu(vector, VecArrayAddress(left, index, packed_type));
+  if (instruction->IsRightAnArray()) {
+    __ movdqu(right_vector,
+              VecArrayAddress(right.AsRegister<Register>(), index, packed_type));
+  } else {
+    GenerateVecBroadcast(right_vector, right, packed_type);
+  }
+  GenerateVecOperation(instruction->GetOperationKind(), packed_type, vector, right_vector);
+  __ movdqu(VecArrayAddress(array, index, packed_type), vector);
+}
+
+void LocationsBuilderX86::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RegisterOrConstant(instruction->GetIndex()));
+  locations->SetOut(Location::SameAsFirstInput());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorX86::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Register out = locations->Out().AsRegister<Register>();
+  Register array = locations->InAt(1).AsRegister<Register>();
+  Location index = locations->InAt(2);
+  XmmRegister vector = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister shuffled = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  Register scalar = locations->GetTemp(2).AsRegister<Register>();
+  Primitive::Type packed_type = instruction->GetPackedType();
+  VecOperationKind kind = instruction->GetOperationKind();
+  // Long reductions would need a register pair for the accumulator.
+  DCHECK_EQ(packed_type, Primitive::kPrimInt);
+
+  // Fold the upper half of the vector into the lower half, then the second
+  // lane into the first one.
+  __ movdqu(vector, VecArrayAddress(array, index, packed_type));
+  __ pshufd(shuffled, vector, Immediate(0x4E));
+  GenerateVecOperation(kind, packed_type, vector, shuffled);
+  __ pshufd(shuffled, vector, Immediate(0xB1));
+  GenerateVecOperation(kind, packed_type, vector, shuffled);
+  __ movd(scalar, vector);
+
+  switch (kind) {
+    case VecOperationKind::kAdd:
+      __ addl(out, scalar);
+      break;
+    case VecOperationKind::kAnd:
+      __ andl(out, scalar);
+      break;
+    case VecOperationKind::kOr:
+      __ orl(out, scalar);
+      break;
+    case VecOperationKind::kXor:
+      __ xorl(out, scalar);
+      break;
+    case VecOperationKind::kMin:
+      __ cmpl(out, scalar);
+      __ cmovl(kGreater, out, scalar);
+      break;
+    case VecOperationKind::kMax:
+      __ cmpl(out, scalar);
+      __ cmovl(kLess, out, scalar);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected reduction " << kind;
+      UNREACHABLE();
+  }
+}
+
 void LocationsBuilderX86::VisitTemporary(HTemporary* temp) {
   temp->SetLocations(nullptr);
 }
@@ -155,6 +155,7 @@ class LocationsBuilderX86 : public HGraphVisitor {
 
   FOR_EACH_CONCRETE_INSTRUCTION_COMMON(DECLARE_VISIT_INSTRUCTION)
   FOR_EACH_CONCRETE_INSTRUCTION_X86(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(DECLARE_VISIT_INSTRUCTION)
 
 #undef DECLARE_VISIT_INSTRUCTION
 
@@ -185,6 +186,7 @@ class InstructionCodeGeneratorX86 : public HGraphVisitor {
 
   FOR_EACH_CONCRETE_INSTRUCTION_COMMON(DECLARE_VISIT_INSTRUCTION)
   FOR_EACH_CONCRETE_INSTRUCTION_X86(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(DECLARE_VISIT_INSTRUCTION)
 
 #undef DECLARE_VISIT_INSTRUCTION
 
@@ -238,6 +240,13 @@ class InstructionCodeGeneratorX86 : public HGraphVisitor {
   void GenerateFPJumps(HCondition* cond, Label* true_label, Label* false_label);
   void GenerateLongComparesAndJumps(HCondition* cond, Label* true_label, Label* false_label);
   void HandleGoto(HInstruction* got, HBasicBlock* successor);
+  // Replicates the scalar in `src` into all the lanes of `dst`.
+  void GenerateVecBroadcast(XmmRegister dst, Location src, Primitive::Type packed_type);
+  // Computes `dst = dst op src` lane by lane.
+  void GenerateVecOperation(VecOperationKind kind,
+                            Primitive::Type packed_type,
+                            XmmRegister dst,
+                            XmmRegister src);
 
   X86Assembler* const assembler_;
   CodeGeneratorX86* const codegen_;
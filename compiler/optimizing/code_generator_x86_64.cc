@@ -16,6 +16,7 @@
 
 #include "code_generator_x86_64.h"
 
+#include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "art_method.h"
 #include "code_generator_utils.h"
 #include "compiled_method.h"
@@ -3632,6 +3633,50 @@ void InstructionCodeGeneratorX86_64::VisitBooleanNot(HBooleanNot* bool_not) {
   __ xorl(out.AsRegister<CpuRegister>(), Immediate(1));
 }
 
+void LocationsBuilderX86_64::VisitSelect(HSelect* select) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(select, LocationSummary::kNoCall);
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    locations->SetInAt(0, Location::RequiresFpuRegister());
+    locations->SetInAt(1, Location::Any());
+  } else {
+    // Cmov only takes a register source.
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetInAt(1, Location::RequiresRegister());
+  }
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+}
+
+void InstructionCodeGeneratorX86_64::VisitSelect(HSelect* select) {
+  LocationSummary* locations = select->GetLocations();
+  Location out = locations->Out();
+  Location true_value = locations->InAt(1);
+  CpuRegister condition = locations->InAt(2).AsRegister<CpuRegister>();
+  DCHECK(locations->InAt(0).Equals(out));
+
+  // The output holds the false value, overwrite it if the condition is true.
+  __ testl(condition, condition);
+  switch (select->GetType()) {
+    case Primitive::kPrimFloat:
+    case Primitive::kPrimDouble: {
+      // There is no conditional move to an XMM register.
+      NearLabel done;
+      __ j(kEqual, &done);
+      codegen_->MoveLocation(out, true_value, select->GetType());
+      __ Bind(&done);
+      break;
+    }
+
+    default:
+      __ cmov(kNotEqual,
+              out.AsRegister<CpuRegister>(),
+              true_value.AsRegister<CpuRegister>(),
+              select->GetType() == Primitive::kPrimLong);
+      break;
+  }
+}
+
 void LocationsBuilderX86_64::VisitPhi(HPhi* instruction) {
   LocationSummary* locations =
       new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
@@ -4462,6 +4507,258 @@ void CodeGeneratorX86_64::MarkGCCard(CpuRegister temp,
   }
 }
 
+// Address of the vector of `packed_type` elements of `array` starting at `index`.
+static Address VecArrayAddress(CpuRegister array, Location index, Primitive::Type packed_type) {
+  ScaleFactor scale = static_cast<ScaleFactor>(Primitive::ComponentSizeShift(packed_type));
+  uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(packed_type)).Uint32Value();
+  if (index.IsConstant()) {
+    return Address(array, (index.GetConstant()->AsIntConstant()->GetValue() << scale) + data_offset);
+  }
+  return Address(array, index.AsRegister<CpuRegister>(), scale, data_offset);
+}
+
+void InstructionCodeGeneratorX86_64::GenerateVecBroadcast(XmmRegister dst,
+                                                          Location src,
+                                                          Primitive::Type packed_type) {
+  switch (packed_type) {
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+      __ movd(dst, src.AsRegister<CpuRegister>(), /* is64bit */ false);
+      __ punpcklbw(dst, dst);
+      __ punpcklwd(dst, dst);
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      __ movd(dst, src.AsRegister<CpuRegister>(), /* is64bit */ false);
+      __ punpcklwd(dst, dst);
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimInt:
+      __ movd(dst, src.AsRegister<CpuRegister>(), /* is64bit */ false);
+      __ pshufd(dst, dst, Immediate(0));
+      break;
+    case Primitive::kPrimLong:
+      __ movd(dst, src.AsRegister<CpuRegister>(), /* is64bit */ true);
+      __ pshufd(dst, dst, Immediate(0x44));
+      break;
+    case Primitive::kPrimFloat:
+      __ pshufd(dst, src.AsFpuRegister<XmmRegister>(), Immediate(0));
+      break;
+    case Primitive::kPrimDouble:
+      __ pshufd(dst, src.AsFpuRegister<XmmRegister>(), Immediate(0x44));
+      break;
+    default:
+      LOG(FATAL) << "Unexpected packed type " << packed_type;
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64::GenerateVecOperation(VecOperationKind kind,
+                                                          Primitive::Type packed_type,
+                                                          XmmRegister dst,
+                                                          XmmRegister src) {
+  size_t size = Primitive::ComponentSize(packed_type);
+  bool is_fp = Primitive::IsFloatingPointType(packed_type);
+  switch (kind) {
+    case VecOperationKind::kAdd:
+      if (is_fp) {
+        if (size == 4) {
+          __ addps(dst, src);
+        } else {
+          __ addpd(dst, src);
+        }
+      } else {
+        switch (size) {
+          case 1: __ paddb(dst, src); break;
+          case 2: __ paddw(dst, src); break;
+          case 4: __ paddd(dst, src); break;
+          default: __ paddq(dst, src); break;
+        }
+      }
+      break;
+    case VecOperationKind::kSub:
+      if (is_fp) {
+        if (size == 4) {
+          __ subps(dst, src);
+        } else {
+          __ subpd(dst, src);
+        }
+      } else {
+        switch (size) {
+          case 1: __ psubb(dst, src); break;
+          case 2: __ psubw(dst, src); break;
+          case 4: __ psubd(dst, src); break;
+          default: __ psubq(dst, src); break;
+        }
+      }
+      break;
+    case VecOperationKind::kMul:
+      if (is_fp) {
+        if (size == 4) {
+          __ mulps(dst, src);
+        } else {
+          __ mulpd(dst, src);
+        }
+      } else if (size == 2) {
+        __ pmullw(dst, src);
+      } else {
+        DCHECK_EQ(size, 4u);
+        DCHECK(codegen_->GetInstructionSetFeatures().HasSSE4_1());
+        __ pmulld(dst, src);
+      }
+      break;
+    case VecOperationKind::kDiv:
+      DCHECK(is_fp);
+      if (size == 4) {
+        __ divps(dst, src);
+      } else {
+        __ divpd(dst, src);
+      }
+      break;
+    case VecOperationKind::kMin:
+      DCHECK_EQ(packed_type, Primitive::kPrimInt);
+      DCHECK(codegen_->GetInstructionSetFeatures().HasSSE4_1());
+      __ pminsd(dst, src);
+      break;
+    case VecOperationKind::kMax:
+      DCHECK_EQ(packed_type, Primitive::kPrimInt);
+      DCHECK(codegen_->GetInstructionSetFeatures().HasSSE4_1());
+      __ pmaxsd(dst, src);
+      break;
+    case VecOperationKind::kAnd:
+      DCHECK(!is_fp);
+      __ pand(dst, src);
+      break;
+    case VecOperationKind::kOr:
+      DCHECK(!is_fp);
+      __ por(dst, src);
+      break;
+    case VecOperationKind::kXor:
+      DCHECK(!is_fp);
+      __ pxor(dst, src);
+      break;
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecArrayOperation(HVecArrayOperation* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RegisterOrConstant(instruction->GetIndex()));
+  locations->SetInAt(2, Location::RequiresRegister());
+  if (Primitive::IsFloatingPointType(instruction->GetRight()->GetType())) {
+    locations->SetInAt(3, Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(3, Location::RequiresRegister());
+  }
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecArrayOperation(HVecArrayOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  Location index = locations->InAt(1);
+  CpuRegister left = locations->InAt(2).AsRegister<CpuRegister>();
+  Location right = locations->InAt(3);
+  XmmRegister vector = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister right_vector = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  Primitive::Type packed_type = instruction->GetPackedType();
+
+  // The elements need not be aligned, so they are loaded with movdqu rather
+  // than being used as memory operands.
+  __ movdqu(vector, VecArrayAddress(left, index, packed_type));
+  if (instruction->IsRightAnArray()) {
+    __ movdqu(right_vector,
+              VecArrayAddress(right.AsRegister<CpuRegister>(), index, packed_type));
+  } else {
+    GenerateVecBroadcast(right_vector, right, packed_type);
+  }
+  GenerateVecOperation(instruction->GetOperationKind(), packed_type, vector, right_vector);
+  __ movdqu(VecArrayAddress(array, index, packed_type), vector);
+}
+
+void LocationsBuilderX86_64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RegisterOrConstant(instruction->GetIndex()));
+  locations->SetOut(Location::SameAsFirstInput());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister array = locations->InAt(1).AsRegister<CpuRegister>();
+  Location index = locations->InAt(2);
+  XmmRegister vector = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister shuffled = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  CpuRegister scalar = locations->GetTemp(2).AsRegister<CpuRegister>();
+  Primitive::Type packed_type = instruction->GetPackedType();
+  VecOperationKind kind = instruction->GetOperationKind();
+  bool is64bit = packed_type == Primitive::kPrimLong;
+  DCHECK(is64bit || packed_type == Primitive::kPrimInt) << packed_type;
+
+  // Fold the upper half of the vector into the lower half, then, for ints,
+  // the second lane into the first one.
+  __ movdqu(vector, VecArrayAddress(array, index, packed_type));
+  __ pshufd(shuffled, vector, Immediate(0x4E));
+  GenerateVecOperation(kind, packed_type, vector, shuffled);
+  if (!is64bit) {
+    __ pshufd(shuffled, vector, Immediate(0xB1));
+    GenerateVecOperation(kind, packed_type, vector, shuffled);
+  }
+  __ movd(scalar, vector, is64bit);
+
+  switch (kind) {
+    case VecOperationKind::kAdd:
+      if (is64bit) {
+        __ addq(out, scalar);
+      } else {
+        __ addl(out, scalar);
+      }
+      break;
+    case VecOperationKind::kAnd:
+      if (is64bit) {
+        __ andq(out, scalar);
+      } else {
+        __ andl(out, scalar);
+      }
+      break;
+    case VecOperationKind::kOr:
+      if (is64bit) {
+        __ orq(out, scalar);
+      } else {
+        __ orl(out, scalar);
+      }
+      break;
+    case VecOperationKind::kXor:
+      if (is64bit) {
+        __ xorq(out, scalar);
+      } else {
+        __ xorl(out, scalar);
+      }
+      break;
+    case VecOperationKind::kMin:
+      __ cmpl(out, scalar);
+      __ cmov(kGreater, out, scalar, /* is64bit */ false);
+      break;
+    case VecOperationKind::kMax:
+      __ cmpl(out, scalar);
+      __ cmov(kLess, out, scalar, /* is64bit */ false);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected reduction " << kind;
+      UNREACHABLE();
+  }
+}
+
 void LocationsBuilderX86_64::VisitTemporary(HTemporary* temp) {
   temp->SetLocations(nullptr);
 }
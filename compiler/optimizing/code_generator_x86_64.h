@@ -154,6 +154,7 @@ class LocationsBuilderX86_64 : public HGraphVisitor {
 
   FOR_EACH_CONCRETE_INSTRUCTION_COMMON(DECLARE_VISIT_INSTRUCTION)
   FOR_EACH_CONCRETE_INSTRUCTION_X86_64(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(DECLARE_VISIT_INSTRUCTION)
 
 #undef DECLARE_VISIT_INSTRUCTION
 
@@ -184,6 +185,7 @@ class InstructionCodeGeneratorX86_64 : public HGraphVisitor {
 
   FOR_EACH_CONCRETE_INSTRUCTION_COMMON(DECLARE_VISIT_INSTRUCTION)
   FOR_EACH_CONCRETE_INSTRUCTION_X86_64(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(DECLARE_VISIT_INSTRUCTION)
 
 #undef DECLARE_VISIT_INSTRUCTION
 
@@ -227,6 +229,13 @@ class InstructionCodeGeneratorX86_64 : public HGraphVisitor {
                                     Label* always_true_target);
   void GenerateFPJumps(HCondition* cond, Label* true_label, Label* false_label);
   void HandleGoto(HInstruction* got, HBasicBlock* successor);
+  // Replicates the scalar in `src` into all the lanes of `dst`.
+  void GenerateVecBroadcast(XmmRegister dst, Location src, Primitive::Type packed_type);
+  // Computes `dst = dst op src` lane by lane.
+  void GenerateVecOperation(VecOperationKind kind,
+                            Primitive::Type packed_type,
+                            XmmRegister dst,
+                            XmmRegister src);
 
   X86_64Assembler* const assembler_;
   CodeGeneratorX86_64* const codegen_;
@@ -199,8 +199,9 @@ static void RunCodeOptimized(CodeGenerator* codegen,
   SsaLivenessAnalysis liveness(graph, codegen);
   liveness.Analyze();
 
-  RegisterAllocator register_allocator(graph->GetArena(), codegen, liveness);
-  register_allocator.AllocateRegisters();
+  RegisterAllocator* register_allocator =
+      RegisterAllocator::Create(graph->GetArena(), codegen, liveness);
+  register_allocator->AllocateRegisters();
   hook_before_codegen(graph);
 
   InternalCodeAllocator allocator;
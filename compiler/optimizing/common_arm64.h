@@ -90,6 +90,20 @@ static inline vixl::FPRegister FPRegisterFrom(Location location, Primitive::Type
   return type == Primitive::kPrimDouble ? DRegisterFrom(location) : SRegisterFrom(location);
 }
 
+// The Q register of `location`, arranged in lanes of `packed_type`.
+static inline vixl::VRegister VRegisterFrom(Location location, Primitive::Type packed_type) {
+  DCHECK(location.IsFpuRegister());
+  vixl::VRegister reg = vixl::VRegister::QRegFromCode(location.reg());
+  switch (Primitive::ComponentSize(packed_type)) {
+    case 1: return reg.V16B();
+    case 2: return reg.V8H();
+    case 4: return reg.V4S();
+    default:
+      DCHECK_EQ(Primitive::ComponentSize(packed_type), 8u);
+      return reg.V2D();
+  }
+}
+
 static inline vixl::FPRegister OutputFPRegister(HInstruction* instr) {
   return FPRegisterFrom(instr->GetLocations()->Out(), instr->GetType());
 }
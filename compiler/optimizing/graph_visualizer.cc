@@ -381,6 +381,15 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
         << array_set->GetValueCanBeNull() << std::noboolalpha;
   }
 
+  void VisitVecArrayOperation(HVecArrayOperation* operation) OVERRIDE {
+    StartAttributeStream("kind") << operation->GetOperationKind();
+    StartAttributeStream("packed_type") << operation->GetPackedType();
+  }
+
+  void VisitVecReduce(HVecReduce* reduce) OVERRIDE {
+    StartAttributeStream("kind") << reduce->GetOperationKind();
+  }
+
   void VisitInvoke(HInvoke* invoke) OVERRIDE {
     StartAttributeStream("dex_file_index") << invoke->GetDexMethodIndex();
     StartAttributeStream("method_name") << PrettyMethod(
@@ -192,7 +192,11 @@ uint32_t HInductionVarAnalysis::VisitDescendant(HLoopInformation* loop, HInstruc
 void HInductionVarAnalysis::ClassifyTrivial(HLoopInformation* loop, HInstruction* instruction) {
   InductionInfo* info = nullptr;
   if (instruction->IsPhi()) {
-    info = TransferPhi(loop, instruction, /* input_index */ 0);
+    // A catch phi takes the value its vreg has at the instruction that threw,
+    // which its inputs only approximate once instructions have been moved.
+    if (!instruction->AsPhi()->IsCatchPhi()) {
+      info = TransferPhi(loop, instruction, /* input_index */ 0);
+    }
   } else if (instruction->IsAdd()) {
     info = TransferAddSub(LookupInfo(loop, instruction->InputAt(0)),
                           LookupInfo(loop, instruction->InputAt(1)), kAdd);
@@ -261,7 +265,9 @@ void HInductionVarAnalysis::ClassifyNonTrivial(HLoopInformation* loop) {
     HInstruction* instruction = scc_[i];
     InductionInfo* update = nullptr;
     if (instruction->IsPhi()) {
-      update = SolvePhiAllInputs(loop, phi, instruction);
+      if (!instruction->AsPhi()->IsCatchPhi()) {  // See ClassifyTrivial().
+        update = SolvePhiAllInputs(loop, phi, instruction);
+      }
     } else if (instruction->IsAdd()) {
       update = SolveAddSub(
           loop, phi, instruction, instruction->InputAt(0), instruction->InputAt(1), kAdd, true);
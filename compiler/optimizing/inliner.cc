@@ -26,6 +26,9 @@
 #include "driver/dex_compilation_unit.h"
 #include "instruction_simplifier.h"
 #include "intrinsics.h"
+#include "jit/jit.h"
+#include "jit/offline_profiling_info.h"
+#include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
 #include "nodes.h"
@@ -40,7 +43,36 @@
 
 namespace art {
 
-static constexpr size_t kMaximumNumberOfHInstructions = 12;
+// The number of HInstructions a callee may have at a call site with no known benefit.
+static constexpr size_t kBaseInstructionBudget = 12;
+// The number of HInstructions a callee may have at a call site the profile says is cold.
+static constexpr size_t kColdCallSiteInstructionBudget = 6;
+// The maximum number of HInstructions a callee may have at any call site.
+static constexpr size_t kMaximumInstructionBudget = 64;
+
+// Additional HInstructions allowed for the expected benefits of inlining at a call site.
+static constexpr size_t kLoopDepthBenefit = 8;
+static constexpr size_t kMaximumBenefitingLoopDepth = 3;
+static constexpr size_t kConstantArgumentBenefit = 2;
+static constexpr size_t kDevirtualizedCallBenefit = 4;
+static constexpr size_t kHotCallSiteBenefit = 16;
+
+// Bounds of the number of HInstructions that inlining may add to a method. Within these
+// bounds, a method may grow by its own size.
+static constexpr size_t kMinimumCodeGrowthBudget = 128;
+static constexpr size_t kMaximumCodeGrowthBudget = 1024;
+
+static size_t CountInstructions(const HGraph& graph) {
+  size_t number_of_instructions = 0;
+  for (HReversePostOrderIterator it(graph); !it.Done(); it.Advance()) {
+    for (HInstructionIterator instr_it(it.Current()->GetInstructions());
+         !instr_it.Done();
+         instr_it.Advance()) {
+      ++number_of_instructions;
+    }
+  }
+  return number_of_instructions;
+}
 
 void HInliner::Run() {
   const CompilerOptions& compiler_options = compiler_driver_->GetCompilerOptions();
@@ -53,6 +85,10 @@ void HInliner::Run() {
     // doing some logic in the runtime to discover if a method could have been inlined.
     return;
   }
+  if (depth_ == 0) {
+    code_growth_budget_ = std::min(
+        std::max(CountInstructions(*graph_), kMinimumCodeGrowthBudget), kMaximumCodeGrowthBudget);
+  }
   const ArenaVector<HBasicBlock*>& blocks = graph_->GetReversePostOrder();
   DCHECK(!blocks.empty());
   HBasicBlock* next_block = blocks[0];
@@ -71,7 +107,9 @@ void HInliner::Run() {
       if (call != nullptr && call->GetIntrinsic() == Intrinsics::kNone) {
         // We use the original invoke type to ensure the resolution of the called method
         // works properly.
+        not_inlined_reason_ = kNotInlinedOther;
         if (!TryInline(call)) {
+          MaybeRecordStat(not_inlined_reason_);
           if (kIsDebugBuild && IsCompilingWithCoreImage()) {
             std::string callee_name =
                 PrettyMethod(call->GetDexMethodIndex(), *outer_compilation_unit_.GetDexFile());
@@ -179,6 +217,7 @@ static uint32_t FindMethodIndexIn(ArtMethod* method,
 
 bool HInliner::TryInline(HInvoke* invoke_instruction) {
   if (invoke_instruction->IsInvokeUnresolved()) {
+    not_inlined_reason_ = kNotInlinedNoTarget;
     return false;  // Don't bother to move further if we know the method is unresolved.
   }
 
@@ -206,17 +245,327 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
     // TODO: Can this still happen?
     // Method cannot be resolved if it is in another dex file we do not have access to.
     VLOG(compiler) << "Method cannot be resolved " << PrettyMethod(method_index, caller_dex_file);
+    not_inlined_reason_ = kNotInlinedNoTarget;
     return false;
   }
 
-  if (!invoke_instruction->IsInvokeStaticOrDirect()) {
-    resolved_method = FindVirtualOrInterfaceTarget(invoke_instruction, resolved_method);
-    if (resolved_method == nullptr) {
-      VLOG(compiler) << "Interface or virtual call to "
-                     << PrettyMethod(method_index, caller_dex_file)
-                     << " could not be statically determined";
-      return false;
+  if (invoke_instruction->IsInvokeStaticOrDirect()) {
+    return TryInlineAndReplace(invoke_instruction, resolved_method);
+  }
+
+  ArtMethod* actual_method = FindVirtualOrInterfaceTarget(invoke_instruction, resolved_method);
+  if (actual_method != nullptr) {
+    return TryInlineAndReplace(invoke_instruction, actual_method);
+  }
+
+  VLOG(compiler) << "Interface or virtual call to "
+                 << PrettyMethod(method_index, caller_dex_file)
+                 << " could not be statically determined";
+  return TryInlineFromInlineCache(invoke_instruction, resolved_method);
+}
+
+static mirror::Class* GetClassRoot(ClassLinker::ClassRoot class_root)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  return Runtime::Current()->GetClassLinker()->GetClassRoot(class_root);
+}
+
+/**
+ * Given the `resolved_method` looked up in the dex cache, return the method
+ * called by `invoke` when the receiver is an instance of `cls`, or nullptr
+ * if that target cannot be inlined.
+ */
+static ArtMethod* FindTargetForReceiverType(HInvoke* invoke,
+                                            ArtMethod* resolved_method,
+                                            mirror::Class* cls)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  if (!resolved_method->GetDeclaringClass()->IsAssignableFrom(cls)) {
+    // Executing the invoke with that receiver threw an IncompatibleClassChangeError.
+    return nullptr;
+  }
+  size_t pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  ArtMethod* target = invoke->IsInvokeInterface()
+      ? cls->FindVirtualMethodForInterface(resolved_method, pointer_size)
+      : cls->FindVirtualMethodForVirtual(resolved_method, pointer_size);
+  if (target == nullptr || target->IsAbstract()) {
+    return nullptr;
+  }
+  return target;
+}
+
+/**
+ * Return the index of the type `cls` in `dex_file`, or DexFile::kDexNoIndex if
+ * the compiled code cannot load `cls` through that index.
+ */
+static uint32_t FindClassIndexIn(mirror::Class* cls,
+                                 const DexFile& dex_file,
+                                 Handle<mirror::DexCache> dex_cache)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  if (cls->IsProxyClass() || cls->IsArrayClass() || cls->IsPrimitive()) {
+    // These classes do not have a type id of their own.
+    return DexFile::kDexNoIndex;
+  }
+  if (cls->GetDexCache() == dex_cache.Get()) {
+    return cls->GetDexTypeIndex();
+  }
+  uint32_t index = cls->FindTypeIndexInOtherDexFile(dex_file);
+  // The descriptor may resolve to a different class in the loader of `dex_file`. Only
+  // use the index if it is known to resolve to `cls`.
+  if (index == DexFile::kDexNoIndex || dex_cache->GetResolvedType(index) != cls) {
+    return DexFile::kDexNoIndex;
+  }
+  return index;
+}
+
+bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction, ArtMethod* resolved_method) {
+  mirror::Class* receiver_types[ProfilingInfo::InlineCache::kIndividualCacheSize];
+  size_t number_of_types = Runtime::Current()->UseJit()
+      ? GetReceiverTypesFromProfilingInfo(invoke_instruction, receiver_types)
+      : GetReceiverTypesFromProfile(invoke_instruction, receiver_types);
+  if (number_of_types == 0) {
+    VLOG(compiler) << "Interface or virtual call to " << PrettyMethod(resolved_method)
+                   << " has no usable inline cache";
+    not_inlined_reason_ = kNotInlinedNoTarget;
+    return false;
+  } else if (number_of_types == 1) {
+    return TryInlineMonomorphicCall(invoke_instruction, resolved_method, receiver_types[0]);
+  } else {
+    return TryInlinePolymorphicCall(
+        invoke_instruction, resolved_method, receiver_types, number_of_types);
+  }
+}
+
+size_t HInliner::GetReceiverTypesFromProfilingInfo(HInvoke* invoke_instruction,
+                                                   mirror::Class** receiver_types) {
+  ArtMethod* caller = graph_->GetArtMethod();
+  if (caller == nullptr || caller->IsNative()) {
+    return 0;
+  }
+
+  size_t pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
+  ProfilingInfo* profiling_info = caller->GetProfilingInfo(pointer_size);
+  if (profiling_info == nullptr) {
+    VLOG(compiler) << "No profiling info for " << PrettyMethod(caller);
+    return 0;
+  }
+
+  const ProfilingInfo::InlineCache* ic =
+      profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
+  if (ic == nullptr || ic->IsUnitialized() || ic->IsMegamorphic()) {
+    return 0;
+  }
+  size_t number_of_types = 0;
+  for (size_t i = 0; i < ProfilingInfo::InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* cls = ic->GetTypeAt(i);
+    if (cls == nullptr) {
+      break;
+    }
+    receiver_types[number_of_types++] = cls;
+  }
+  return number_of_types;
+}
+
+size_t HInliner::GetReceiverTypesFromProfile(HInvoke* invoke_instruction,
+                                             mirror::Class** receiver_types) {
+  static_assert(ProfileCompilationInfo::kMaxNumberOfInlineCacheTypes <=
+                    ProfilingInfo::InlineCache::kIndividualCacheSize,
+                "Profiles have more receiver types than inline caches");
+  const ProfileCompilationInfo* profile = compiler_driver_->GetProfileCompilationInfo();
+  if (profile == nullptr) {
+    return 0;
+  }
+  // The type indices are in the dex file of the method containing the invoke.
+  const std::set<uint16_t>* type_indices = profile->GetInlineCacheTypes(
+      MethodReference(&graph_->GetDexFile(), graph_->GetMethodIdx()),
+      invoke_instruction->GetDexPc());
+  if (type_indices == nullptr) {
+    return 0;
+  }
+  size_t number_of_types = 0;
+  for (uint16_t type_index : *type_indices) {
+    mirror::Class* cls = caller_compilation_unit_.GetDexCache()->GetResolvedType(type_index);
+    if (cls == nullptr) {
+      // The type could not be resolved when compiling, the guard could never pass for it.
+      return 0;
     }
+    receiver_types[number_of_types++] = cls;
+  }
+  // An empty list of types means the call site is megamorphic.
+  return number_of_types;
+}
+
+bool HInliner::TryInlineMonomorphicCall(HInvoke* invoke_instruction,
+                                        ArtMethod* resolved_method,
+                                        mirror::Class* receiver_type) {
+  uint32_t class_index = FindClassIndexIn(receiver_type,
+                                          *outer_compilation_unit_.GetDexFile(),
+                                          outer_compilation_unit_.GetDexCache());
+  if (class_index == DexFile::kDexNoIndex) {
+    VLOG(compiler) << "Call to " << PrettyMethod(resolved_method)
+                   << " from inline cache is not inlined because its class is not"
+                   << " accessible to the caller";
+    return false;
+  }
+
+  ArtMethod* target = FindTargetForReceiverType(invoke_instruction,
+                                                resolved_method,
+                                                receiver_type);
+  if (target == nullptr) {
+    return false;
+  }
+
+  uint16_t class_indices[] = { static_cast<uint16_t>(class_index) };
+  if (!TryInlineWithTypeGuard(invoke_instruction, target, class_indices, 1u)) {
+    return false;
+  }
+  MaybeRecordStat(kInlinedMonomorphicCall);
+  return true;
+}
+
+bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
+                                        ArtMethod* resolved_method,
+                                        mirror::Class* const* receiver_types,
+                                        size_t number_of_types) {
+  // Group the receiver types by target, in the order the targets were first recorded.
+  ArtMethod* targets[ProfilingInfo::InlineCache::kIndividualCacheSize];
+  uint16_t class_indices[ProfilingInfo::InlineCache::kIndividualCacheSize]
+                        [ProfilingInfo::InlineCache::kIndividualCacheSize];
+  size_t number_of_classes[ProfilingInfo::InlineCache::kIndividualCacheSize];
+  size_t number_of_targets = 0;
+  DCHECK_LE(number_of_types, arraysize(targets));
+  for (size_t i = 0; i < number_of_types; ++i) {
+    mirror::Class* cls = receiver_types[i];
+    ArtMethod* method = FindTargetForReceiverType(invoke_instruction, resolved_method, cls);
+    if (method == nullptr) {
+      continue;
+    }
+    uint32_t class_index = FindClassIndexIn(cls,
+                                            *outer_compilation_unit_.GetDexFile(),
+                                            outer_compilation_unit_.GetDexCache());
+    if (class_index == DexFile::kDexNoIndex) {
+      VLOG(compiler) << "Call to " << PrettyMethod(resolved_method)
+                     << " from inline cache is not inlined for " << PrettyClass(cls)
+                     << " because it is not accessible to the caller";
+      continue;
+    }
+    size_t target_index = 0;
+    while (target_index < number_of_targets && targets[target_index] != method) {
+      ++target_index;
+    }
+    if (target_index == number_of_targets) {
+      targets[number_of_targets] = method;
+      number_of_classes[number_of_targets] = 0;
+      ++number_of_targets;
+    }
+    class_indices[target_index][number_of_classes[target_index]++] =
+        static_cast<uint16_t>(class_index);
+  }
+
+  // Each target is inlined in the fallback branch of the previous one, so the receiver
+  // types are checked in order until one matches, or the call dispatches as before.
+  bool inlined = false;
+  for (size_t i = 0; i < number_of_targets; ++i) {
+    if (TryInlineWithTypeGuard(
+            invoke_instruction, targets[i], class_indices[i], number_of_classes[i])) {
+      inlined = true;
+    }
+  }
+  if (!inlined) {
+    return false;
+  }
+  MaybeRecordStat(kInlinedPolymorphicCall);
+  return true;
+}
+
+bool HInliner::TryInlineWithTypeGuard(HInvoke* invoke_instruction,
+                                      ArtMethod* method,
+                                      const uint16_t* class_indices,
+                                      size_t number_of_classes) {
+  ArenaAllocator* arena = graph_->GetArena();
+  HBasicBlock* block = invoke_instruction->GetBlock();
+  HInstruction* cursor = invoke_instruction->GetPrevious();
+  uint32_t dex_pc = invoke_instruction->GetDexPc();
+  const DexFile& outer_dex_file = *outer_compilation_unit_.GetDexFile();
+
+  HInstruction* return_replacement = nullptr;
+  if (!TryInline(invoke_instruction, method, &return_replacement)) {
+    return false;
+  }
+
+  // The guard goes between `cursor` and the inlined body, which starts in `block`.
+  HInstruction* insertion_point = (cursor == nullptr) ? block->GetFirstInstruction()
+                                                      : cursor->GetNext();
+  ArtField* field = GetClassRoot(ClassLinker::kJavaLangObject)->GetInstanceField(0);
+  DCHECK_EQ(std::string(field->GetName()), "shadow$_klass_");
+  ReferenceTypeInfo class_rti = ReferenceTypeInfo::Create(
+      handles_->NewHandle(GetClassRoot(ClassLinker::kJavaLangClass)), /* is_exact */ true);
+  // The receiver has been null checked before the invoke.
+  HInstanceFieldGet* receiver_class = new (arena) HInstanceFieldGet(
+      invoke_instruction->InputAt(0),
+      Primitive::kPrimNot,
+      field->GetOffset(),
+      field->IsVolatile(),
+      field->GetDexFieldIndex(),
+      *field->GetDexFile(),
+      handles_->NewHandle(field->GetDexCache()),
+      dex_pc);
+  receiver_class->SetReferenceTypeInfo(class_rti);
+  block->InsertInstructionBefore(receiver_class, insertion_point);
+
+  HInstruction* compare = nullptr;
+  for (size_t i = 0; i < number_of_classes; ++i) {
+    HLoadClass* load_class = new (arena) HLoadClass(graph_->GetCurrentMethod(),
+                                                    class_indices[i],
+                                                    outer_dex_file,
+                                                    /* is_referrers_class */ false,
+                                                    dex_pc,
+                                                    /* needs_access_check */ false);
+    mirror::Class* cls = outer_compilation_unit_.GetDexCache()->GetResolvedType(class_indices[i]);
+    if (cls != nullptr) {
+      load_class->SetLoadedClassRTI(
+          ReferenceTypeInfo::Create(handles_->NewHandle(cls), /* is_exact */ true));
+    }
+    load_class->SetReferenceTypeInfo(class_rti);
+    block->InsertInstructionBefore(load_class, insertion_point);
+    load_class->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+
+    HNotEqual* not_equal = new (arena) HNotEqual(load_class, receiver_class, dex_pc);
+    block->InsertInstructionBefore(not_equal, insertion_point);
+    if (compare == nullptr) {
+      compare = not_equal;
+    } else {
+      compare = new (arena) HAnd(Primitive::kPrimInt, compare, not_equal, dex_pc);
+      block->InsertInstructionBefore(compare, insertion_point);
+    }
+  }
+
+  // When none of the classes matches, `compare` is true and the invoke executes.
+  HPhi* phi = graph_->CreateDiamondForGuardedInline(
+      compare, return_replacement, invoke_instruction);
+  if (phi != nullptr && phi->GetType() == Primitive::kPrimNot) {
+    // Both inputs are of the declared return type of the invoke.
+    phi->SetReferenceTypeInfo(invoke_instruction->GetReferenceTypeInfo());
+  }
+  return true;
+}
+
+bool HInliner::TryInlineAndReplace(HInvoke* invoke_instruction, ArtMethod* resolved_method) {
+  HInstruction* return_replacement = nullptr;
+  if (!TryInline(invoke_instruction, resolved_method, &return_replacement)) {
+    return false;
+  }
+  if (return_replacement != nullptr) {
+    invoke_instruction->ReplaceWith(return_replacement);
+  }
+  invoke_instruction->GetBlock()->RemoveInstruction(invoke_instruction);
+  return true;
+}
+
+bool HInliner::TryInline(HInvoke* invoke_instruction,
+                         ArtMethod* resolved_method,
+                         HInstruction** return_replacement) {
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  uint32_t method_index = invoke_instruction->GetDexMethodIndex();
+  if (!invoke_instruction->IsInvokeStaticOrDirect()) {
     // We have found a method, but we need to find where that method is for the caller's
     // dex file.
     method_index = FindMethodIndexIn(resolved_method, caller_dex_file, method_index);
@@ -239,10 +588,18 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
     return false;
   }
 
-  size_t inline_max_code_units = compiler_driver_->GetCompilerOptions().GetInlineMaxCodeUnits();
+  // The maximum code units given in the compiler options apply to call sites with no
+  // known benefit, and scale with the instruction budget of the call site.
+  size_t instruction_budget = ComputeInstructionBudget(invoke_instruction, resolved_method);
+  size_t inline_max_code_units = compiler_driver_->GetCompilerOptions().GetInlineMaxCodeUnits()
+      * instruction_budget / kBaseInstructionBudget;
   if (code_item->insns_size_in_code_units_ > inline_max_code_units) {
     VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
-                   << " is too big to inline";
+                   << " is too big to inline at a call site with a budget of "
+                   << instruction_budget << " instructions";
+    not_inlined_reason_ = (instruction_budget < kBaseInstructionBudget)
+        ? kNotInlinedColdCallSite
+        : kNotInlinedTooBig;
     return false;
   }
 
@@ -272,7 +629,11 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
     return false;
   }
 
-  if (!TryBuildAndInline(resolved_method, invoke_instruction, same_dex_file)) {
+  if (!TryBuildAndInline(resolved_method,
+                         invoke_instruction,
+                         same_dex_file,
+                         instruction_budget,
+                         return_replacement)) {
     return false;
   }
 
@@ -281,9 +642,62 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
   return true;
 }
 
+size_t HInliner::ComputeInstructionBudget(HInvoke* invoke_instruction,
+                                          ArtMethod* resolved_method) {
+  // Hotness of the callee: methods the JIT has seen warm up have profiling info, and
+  // dex2oat is given the methods executed when the profile was recorded.
+  bool is_hot = false;
+  bool is_cold = false;
+  if (Runtime::Current()->UseJit()) {
+    size_t pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
+    is_hot = resolved_method->GetProfilingInfo(pointer_size) != nullptr;
+  } else {
+    const ProfileCompilationInfo* profile = compiler_driver_->GetProfileCompilationInfo();
+    if (profile != nullptr) {
+      is_hot = profile->ContainsMethod(
+          MethodReference(resolved_method->GetDexFile(), resolved_method->GetDexMethodIndex()));
+      is_cold = !is_hot;
+    }
+  }
+  if (is_cold) {
+    return kColdCallSiteInstructionBudget;
+  }
+
+  size_t budget = kBaseInstructionBudget;
+  if (is_hot) {
+    budget += kHotCallSiteBenefit;
+  }
+  // Calls in loops are executed more often than the rest of the method.
+  size_t loop_depth = 0;
+  for (HLoopInformationOutwardIterator it(*invoke_instruction->GetBlock());
+       !it.Done() && loop_depth < kMaximumBenefitingLoopDepth;
+       it.Advance()) {
+    ++loop_depth;
+  }
+  budget += loop_depth * kLoopDepthBenefit;
+  // Constant arguments are propagated into the callee, where they fold.
+  for (size_t i = 0, e = invoke_instruction->GetNumberOfArguments(); i < e; ++i) {
+    if (invoke_instruction->InputAt(i)->IsConstant()) {
+      budget += kConstantArgumentBenefit;
+    }
+  }
+  // Inlining a virtual or interface call also removes its dispatch.
+  if (!invoke_instruction->IsInvokeStaticOrDirect()) {
+    budget += kDevirtualizedCallBenefit;
+  }
+  budget = std::min(budget, kMaximumInstructionBudget);
+
+  VLOG(compiler) << "Call to " << PrettyMethod(resolved_method)
+                 << (is_hot ? " (hot)" : "") << " at loop depth " << loop_depth
+                 << " has a budget of " << budget << " instructions";
+  return budget;
+}
+
 bool HInliner::TryBuildAndInline(ArtMethod* resolved_method,
                                  HInvoke* invoke_instruction,
-                                 bool same_dex_file) {
+                                 bool same_dex_file,
+                                 size_t instruction_budget,
+                                 HInstruction** return_replacement) {
   ScopedObjectAccess soa(Thread::Current());
   const DexFile::CodeItem* code_item = resolved_method->GetCodeItem();
   const DexFile& callee_dex_file = *resolved_method->GetDexFile();
@@ -336,6 +750,7 @@ bool HInliner::TryBuildAndInline(ArtMethod* resolved_method,
       invoke_type,
       graph_->IsDebuggable(),
       graph_->GetCurrentInstructionId());
+  callee_graph->SetArtMethod(resolved_method);
 
   OptimizingCompilerStats inline_stats;
   HGraphBuilder builder(callee_graph,
@@ -412,15 +827,18 @@ bool HInliner::TryBuildAndInline(ArtMethod* resolved_method,
     optimization->Run();
   }
 
-  size_t number_of_instructions_budget = kMaximumNumberOfHInstructions;
+  size_t number_of_instructions_budget = instruction_budget;
   if (depth_ + 1 < compiler_driver_->GetCompilerOptions().GetInlineDepthLimit()) {
+    // The calls of the callee draw from the code growth budget of the outer graph. What
+    // they inline counts against that budget only if the callee itself gets inlined.
     HInliner inliner(callee_graph,
                      outer_compilation_unit_,
                      dex_compilation_unit,
                      compiler_driver_,
                      handles_,
                      stats_,
-                     depth_ + 1);
+                     depth_ + 1,
+                     code_growth_budget_);
     inliner.Run();
     number_of_instructions_budget += inliner.number_of_inlined_instructions_;
   }
@@ -465,6 +883,9 @@ bool HInliner::TryBuildAndInline(ArtMethod* resolved_method,
       if (number_of_instructions++ ==  number_of_instructions_budget) {
         VLOG(compiler) << "Method " << PrettyMethod(method_index, callee_dex_file)
                        << " could not be inlined because it is too big.";
+        not_inlined_reason_ = (instruction_budget < kBaseInstructionBudget)
+            ? kNotInlinedColdCallSite
+            : kNotInlinedTooBig;
         return false;
       }
       HInstruction* current = instr_it.Current();
@@ -492,9 +913,17 @@ bool HInliner::TryBuildAndInline(ArtMethod* resolved_method,
       }
     }
   }
+  if (number_of_instructions > code_growth_budget_) {
+    VLOG(compiler) << "Method " << PrettyMethod(method_index, callee_dex_file)
+                   << " could not be inlined because the caller has used up its"
+                   << " code growth budget";
+    not_inlined_reason_ = kNotInlinedCodeGrowthBudget;
+    return false;
+  }
+  code_growth_budget_ -= number_of_instructions;
   number_of_inlined_instructions_ += number_of_instructions;
 
-  HInstruction* return_replacement = callee_graph->InlineInto(graph_, invoke_instruction);
+  HInstruction* return_value = callee_graph->InlineInto(graph_, invoke_instruction);
 
   // When merging the graph we might create a new NullConstant in the caller graph which does
   // not have the chance to be typed. We assign the correct type here so that we can keep the
@@ -507,22 +936,23 @@ bool HInliner::TryBuildAndInline(ArtMethod* resolved_method,
             ReferenceTypeInfo::Create(obj_handle, false /* is_exact */));
   }
 
-  if ((return_replacement != nullptr)
-      && (return_replacement->GetType() == Primitive::kPrimNot)) {
-    if (!return_replacement->GetReferenceTypeInfo().IsValid()) {
+  if ((return_value != nullptr)
+      && (return_value->GetType() == Primitive::kPrimNot)) {
+    if (!return_value->GetReferenceTypeInfo().IsValid()) {
       // Make sure that we have a valid type for the return. We may get an invalid one when
       // we inline invokes with multiple branches and create a Phi for the result.
       // TODO: we could be more precise by merging the phi inputs but that requires
       // some functionality from the reference type propagation.
-      DCHECK(return_replacement->IsPhi());
+      DCHECK(return_value->IsPhi());
       size_t pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
       ReferenceTypeInfo::TypeHandle return_handle =
         handles_->NewHandle(resolved_method->GetReturnType(true /* resolve */, pointer_size));
-      return_replacement->SetReferenceTypeInfo(ReferenceTypeInfo::Create(
+      return_value->SetReferenceTypeInfo(ReferenceTypeInfo::Create(
          return_handle, return_handle->CannotBeAssignedFromOtherTypes() /* is_exact */));
     }
   }
 
+  *return_replacement = return_value;
   return true;
 }
 
@@ -18,6 +18,7 @@
 #define ART_COMPILER_OPTIMIZING_INLINER_H_
 
 #include "invoke_type.h"
+#include "jit/profiling_info.h"
 #include "optimization.h"
 
 namespace art {
@@ -36,13 +37,16 @@ class HInliner : public HOptimization {
            CompilerDriver* compiler_driver,
            StackHandleScopeCollection* handles,
            OptimizingCompilerStats* stats,
-           size_t depth = 0)
+           size_t depth = 0,
+           size_t code_growth_budget = 0)
       : HOptimization(outer_graph, kInlinerPassName, stats),
         outer_compilation_unit_(outer_compilation_unit),
         caller_compilation_unit_(caller_compilation_unit),
         compiler_driver_(compiler_driver),
         depth_(depth),
         number_of_inlined_instructions_(0),
+        code_growth_budget_(code_growth_budget),
+        not_inlined_reason_(kNotInlinedOther),
         handles_(handles) {}
 
   void Run() OVERRIDE;
@@ -51,15 +55,89 @@ class HInliner : public HOptimization {
 
  private:
   bool TryInline(HInvoke* invoke_instruction);
+
+  // Try to inline `resolved_method` in place of `invoke_instruction`. `resolved_method`
+  // must be the actual target of the call.
+  bool TryInlineAndReplace(HInvoke* invoke_instruction, ArtMethod* resolved_method)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Try to inline the body of `resolved_method` just before `invoke_instruction`, which
+  // is left in place. On success, `return_replacement` is set to the instruction computing
+  // the return value of the inlined body, or null if the method returns void.
+  bool TryInline(HInvoke* invoke_instruction,
+                 ArtMethod* resolved_method,
+                 HInstruction** return_replacement)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Try to inline the target of a virtual or interface call whose receiver type is not
+  // statically known, using the receiver types recorded for it: by the interpreter when
+  // compiling with the JIT, or in the profile given to dex2oat otherwise.
+  bool TryInlineFromInlineCache(HInvoke* invoke_instruction, ArtMethod* resolved_method)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Fill `receiver_types` with the receiver types recorded for `invoke_instruction`, which
+  // must have room for ProfilingInfo::InlineCache::kIndividualCacheSize classes. Returns
+  // the number of types, or 0 if the call site is megamorphic or has no usable types.
+  size_t GetReceiverTypesFromProfilingInfo(HInvoke* invoke_instruction,
+                                           mirror::Class** receiver_types)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  size_t GetReceiverTypesFromProfile(HInvoke* invoke_instruction,
+                                     mirror::Class** receiver_types)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Try to inline the target of `invoke_instruction`, guarded by a check that the receiver
+  // has type `receiver_type`.
+  bool TryInlineMonomorphicCall(HInvoke* invoke_instruction,
+                                ArtMethod* resolved_method,
+                                mirror::Class* receiver_type)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Try to inline the targets of `invoke_instruction` for the `number_of_types` types in
+  // `receiver_types`, each behind a check that the receiver has one of the types
+  // dispatching to it. Returns whether at least one target was inlined.
+  bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
+                                ArtMethod* resolved_method,
+                                mirror::Class* const* receiver_types,
+                                size_t number_of_types)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Inline `method` in a branch taken when the class of the receiver is one of the
+  // `number_of_classes` classes in `class_indices`. Other receivers take a branch
+  // executing `invoke_instruction`, which keeps dispatching through the vtable or imt,
+  // so a receiver type not seen when compiling only costs the check. Indices are in
+  // the dex file of the outer method.
+  bool TryInlineWithTypeGuard(HInvoke* invoke_instruction,
+                              ArtMethod* method,
+                              const uint16_t* class_indices,
+                              size_t number_of_classes)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Return the number of HInstructions the body of `resolved_method` may have to be
+  // inlined in place of `invoke_instruction`. The budget grows with the expected benefit
+  // of inlining at this call site: its loop depth, its constant arguments, whether the
+  // call was devirtualized, and how hot the callee is according to the JIT or the profile.
+  size_t ComputeInstructionBudget(HInvoke* invoke_instruction, ArtMethod* resolved_method)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   bool TryBuildAndInline(ArtMethod* resolved_method,
                          HInvoke* invoke_instruction,
-                         bool same_dex_file);
+                         bool same_dex_file,
+                         size_t instruction_budget,
+                         HInstruction** return_replacement);
 
   const DexCompilationUnit& outer_compilation_unit_;
   const DexCompilationUnit& caller_compilation_unit_;
   CompilerDriver* const compiler_driver_;
   const size_t depth_;
   size_t number_of_inlined_instructions_;
+
+  // The number of HInstructions that inlining may still add to the graph. Computed from
+  // the size of the outer graph, and shared with the inliners of nested calls.
+  size_t code_growth_budget_;
+
+  // Why the call site being processed was not inlined, recorded in the stats.
+  MethodCompilationStat not_inlined_reason_;
+
   StackHandleScopeCollection* const handles_;
 
   DISALLOW_COPY_AND_ASSIGN(HInliner);
@@ -213,6 +213,63 @@ static Intrinsics GetIntrinsic(InlineMethod method, InstructionSet instruction_s
     case kIntrinsicSystemArrayCopy:
       return Intrinsics::kSystemArrayCopy;
 
+    case kIntrinsicSystemArrayCopyPrimitiveArray:
+      switch (static_cast<Primitive::Type>(method.d.data)) {
+        case Primitive::kPrimBoolean:
+          return Intrinsics::kSystemArrayCopyBoolean;
+        case Primitive::kPrimByte:
+          return Intrinsics::kSystemArrayCopyByte;
+        case Primitive::kPrimShort:
+          return Intrinsics::kSystemArrayCopyShort;
+        case Primitive::kPrimInt:
+          return Intrinsics::kSystemArrayCopyInt;
+        case Primitive::kPrimLong:
+          return Intrinsics::kSystemArrayCopyLong;
+        case Primitive::kPrimFloat:
+          return Intrinsics::kSystemArrayCopyFloat;
+        case Primitive::kPrimDouble:
+          return Intrinsics::kSystemArrayCopyDouble;
+        default:
+          LOG(FATAL) << "Unknown/unsupported array type " << method.d.data;
+          UNREACHABLE();
+      }
+
+    // Arrays.fill.
+    case kIntrinsicArraysFill:
+      switch (static_cast<Primitive::Type>(method.d.data)) {
+        case Primitive::kPrimByte:
+          return Intrinsics::kArraysFillByte;
+        case Primitive::kPrimChar:
+          return Intrinsics::kArraysFillChar;
+        case Primitive::kPrimShort:
+          return Intrinsics::kArraysFillShort;
+        case Primitive::kPrimInt:
+          return Intrinsics::kArraysFillInt;
+        case Primitive::kPrimLong:
+          return Intrinsics::kArraysFillLong;
+        default:
+          LOG(FATAL) << "Unknown/unsupported array type " << method.d.data;
+          UNREACHABLE();
+      }
+
+    // Arrays.equals.
+    case kIntrinsicArraysEquals:
+      switch (static_cast<Primitive::Type>(method.d.data)) {
+        case Primitive::kPrimByte:
+          return Intrinsics::kArraysEqualsByte;
+        case Primitive::kPrimChar:
+          return Intrinsics::kArraysEqualsChar;
+        case Primitive::kPrimShort:
+          return Intrinsics::kArraysEqualsShort;
+        case Primitive::kPrimInt:
+          return Intrinsics::kArraysEqualsInt;
+        case Primitive::kPrimLong:
+          return Intrinsics::kArraysEqualsLong;
+        default:
+          LOG(FATAL) << "Unknown/unsupported array type " << method.d.data;
+          UNREACHABLE();
+      }
+
     // Thread.currentThread.
     case kIntrinsicCurrentThread:
       return  Intrinsics::kThreadCurrentThread;
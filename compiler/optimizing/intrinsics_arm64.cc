@@ -1450,6 +1450,328 @@ void IntrinsicCodeGeneratorARM64::VisitStringNewStringFromString(HInvoke* invoke
   __ Bind(slow_path->GetExitLabel());
 }
 
+// The number of bytes moved or compared at a time by the main loops of the array intrinsics,
+// as a pair of X registers.
+static constexpr int32_t kPairSize = 2 * kXRegSizeInBytes;
+
+static void CreateSystemArrayCopyPrimitiveLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  // Check to see if we have known failures that will cause us to have to bail out
+  // to the runtime, and just generate the runtime call directly.
+  HIntConstant* src_pos = invoke->InputAt(1)->AsIntConstant();
+  HIntConstant* dest_pos = invoke->InputAt(3)->AsIntConstant();
+  HIntConstant* length = invoke->InputAt(4)->AsIntConstant();
+  if ((src_pos != nullptr && src_pos->GetValue() < 0) ||
+      (dest_pos != nullptr && dest_pos->GetValue() < 0) ||
+      (length != nullptr && length->GetValue() < 0)) {
+    return;
+  }
+
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kCallOnSlowPath,
+                                                           kIntrinsified);
+  // arraycopy(src, src_pos, dest, dest_pos, length).
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->SetInAt(4, Location::RequiresRegister());
+
+  // The source and destination addresses, the byte count, and a pair of registers for the data.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+// Branch to `slow_path` unless [pos, pos + length) is within `array`, which is not null.
+static void CheckArrayRange(vixl::MacroAssembler* masm,
+                            const Register& array,
+                            const Register& pos,
+                            const Register& length,
+                            const Register& temp,
+                            SlowPathCodeARM64* slow_path) {
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  __ Tbnz(pos, kWRegSize - 1, slow_path->GetEntryLabel());
+  __ Ldr(temp, MemOperand(array.X(), length_offset));
+  __ Sub(temp, temp, pos);
+  __ Cmp(temp, length);
+  __ B(slow_path->GetEntryLabel(), lt);
+}
+
+static void GenSystemArrayCopyPrimitive(vixl::MacroAssembler* masm,
+                                        CodeGeneratorARM64* codegen,
+                                        HInvoke* invoke,
+                                        Primitive::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register src = WRegisterFrom(locations->InAt(0));
+  Register src_pos = WRegisterFrom(locations->InAt(1));
+  Register dest = WRegisterFrom(locations->InAt(2));
+  Register dest_pos = WRegisterFrom(locations->InAt(3));
+  Register length = WRegisterFrom(locations->InAt(4));
+  Register src_base = XRegisterFrom(locations->GetTemp(0));
+  Register dest_base = XRegisterFrom(locations->GetTemp(1));
+  Register count = XRegisterFrom(locations->GetTemp(2));
+  Register data1 = XRegisterFrom(locations->GetTemp(3));
+  Register data2 = XRegisterFrom(locations->GetTemp(4));
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  // Bail out if the source and destination are the same (to handle overlap), or null.
+  __ Cmp(src, dest);
+  __ B(slow_path->GetEntryLabel(), eq);
+  __ Cbz(src, slow_path->GetEntryLabel());
+  __ Cbz(dest, slow_path->GetEntryLabel());
+
+  // Bail out if the length is negative, or if a range is out of bounds.
+  __ Tbnz(length, kWRegSize - 1, slow_path->GetEntryLabel());
+  CheckArrayRange(masm, src, src_pos, length, count.W(), slow_path);
+  CheckArrayRange(masm, dest, dest_pos, length, count.W(), slow_path);
+
+  const size_t element_size = Primitive::ComponentSize(type);
+  const size_t element_size_shift = Primitive::ComponentSizeShift(type);
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
+
+  __ Add(src_base, src.X(), data_offset);
+  __ Add(src_base, src_base, Operand(src_pos, UXTW, element_size_shift));
+  __ Add(dest_base, dest.X(), data_offset);
+  __ Add(dest_base, dest_base, Operand(dest_pos, UXTW, element_size_shift));
+  __ Ubfiz(count, length.X(), element_size_shift, kWRegSize);
+
+  // The arrays are different, so they cannot overlap and the copy can go forward,
+  // 16 bytes at a time.
+  vixl::Label loop, tail, tail_loop;
+  __ Bind(&loop);
+  __ Cmp(count, kPairSize);
+  __ B(&tail, lt);
+  __ Ldp(data1, data2, MemOperand(src_base, kPairSize, PostIndex));
+  __ Stp(data1, data2, MemOperand(dest_base, kPairSize, PostIndex));
+  __ Sub(count, count, kPairSize);
+  __ B(&loop);
+
+  // Move the remaining bytes.
+  __ Bind(&tail);
+  __ Cbz(count, slow_path->GetExitLabel());
+  __ Bind(&tail_loop);
+  __ Ldrb(data1.W(), MemOperand(src_base, 1, PostIndex));
+  __ Strb(data1.W(), MemOperand(dest_base, 1, PostIndex));
+  __ Sub(count, count, 1, SetFlags);
+  __ B(&tail_loop, ne);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+#define SYSTEM_ARRAYCOPY_PRIMITIVE(Name)                                                  \
+void IntrinsicLocationsBuilderARM64::VisitSystemArrayCopy ## Name(HInvoke* invoke) {      \
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);                                \
+}                                                                                         \
+void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopy ## Name(HInvoke* invoke) {         \
+  GenSystemArrayCopyPrimitive(                                                            \
+      GetVIXLAssembler(), codegen_, invoke, Primitive::kPrim ## Name);                    \
+}
+
+SYSTEM_ARRAYCOPY_PRIMITIVE(Char)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Boolean)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Byte)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Short)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Int)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Long)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Float)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Double)
+
+#undef SYSTEM_ARRAYCOPY_PRIMITIVE
+
+static void CreateArraysFillLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kCallOnSlowPath,
+                                                           kIntrinsified);
+  // fill(array, value).
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // The destination address, the byte count, and the value repeated over an X register.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+static void GenArraysFill(vixl::MacroAssembler* masm,
+                          CodeGeneratorARM64* codegen,
+                          HInvoke* invoke,
+                          Primitive::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register value = XRegisterFrom(locations->InAt(1));
+  Register dest_base = XRegisterFrom(locations->GetTemp(0));
+  Register count = XRegisterFrom(locations->GetTemp(1));
+  Register pattern = XRegisterFrom(locations->GetTemp(2));
+
+  // Let the library method throw the NullPointerException.
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ Cbz(array, slow_path->GetEntryLabel());
+
+  const size_t element_size = Primitive::ComponentSize(type);
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
+
+  // Repeat the value over the 64 bits of `pattern`.
+  if (element_size == kXRegSizeInBytes) {
+    __ Mov(pattern, value);
+  } else {
+    size_t width = element_size * kBitsPerByte;
+    __ Ubfx(pattern, value, 0, width);
+    for (; width < kXRegSize; width *= 2) {
+      __ Orr(pattern, pattern, Operand(pattern, LSL, width));
+    }
+  }
+
+  __ Ldr(count.W(), MemOperand(array.X(), length_offset));
+  __ Lsl(count, count, Primitive::ComponentSizeShift(type));
+  __ Add(dest_base, array.X(), data_offset);
+
+  vixl::Label loop, tail, tail_loop;
+  __ Bind(&loop);
+  __ Cmp(count, kPairSize);
+  __ B(&tail, lt);
+  __ Stp(pattern, pattern, MemOperand(dest_base, kPairSize, PostIndex));
+  __ Sub(count, count, kPairSize);
+  __ B(&loop);
+
+  // Store the remaining bytes, rotating the pattern so that its low byte is the next one.
+  __ Bind(&tail);
+  __ Cbz(count, slow_path->GetExitLabel());
+  __ Bind(&tail_loop);
+  __ Strb(pattern.W(), MemOperand(dest_base, 1, PostIndex));
+  __ Ror(pattern, pattern, kBitsPerByte);
+  __ Sub(count, count, 1, SetFlags);
+  __ B(&tail_loop, ne);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+#define ARRAYS_FILL(Name)                                                          \
+void IntrinsicLocationsBuilderARM64::VisitArraysFill ## Name(HInvoke* invoke) {    \
+  CreateArraysFillLocations(arena_, invoke);                                       \
+}                                                                                  \
+void IntrinsicCodeGeneratorARM64::VisitArraysFill ## Name(HInvoke* invoke) {       \
+  GenArraysFill(GetVIXLAssembler(), codegen_, invoke, Primitive::kPrim ## Name);   \
+}
+
+ARRAYS_FILL(Byte)
+ARRAYS_FILL(Char)
+ARRAYS_FILL(Short)
+ARRAYS_FILL(Int)
+ARRAYS_FILL(Long)
+
+#undef ARRAYS_FILL
+
+static void CreateArraysEqualsLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // The two addresses, the byte count, and three registers for the data. The output
+  // holds the fourth one.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenArraysEquals(vixl::MacroAssembler* masm, HInvoke* invoke, Primitive::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register lhs = WRegisterFrom(locations->InAt(0));
+  Register rhs = WRegisterFrom(locations->InAt(1));
+  Register lhs_base = XRegisterFrom(locations->GetTemp(0));
+  Register rhs_base = XRegisterFrom(locations->GetTemp(1));
+  Register count = XRegisterFrom(locations->GetTemp(2));
+  Register lhs_data1 = XRegisterFrom(locations->GetTemp(3));
+  Register lhs_data2 = XRegisterFrom(locations->GetTemp(4));
+  Register rhs_data1 = XRegisterFrom(locations->GetTemp(5));
+  Register out = XRegisterFrom(locations->Out());
+  Register rhs_data2 = out;
+
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Uint32Value();
+
+  vixl::Label loop, tail, tail_loop, end, return_true, return_false;
+
+  // The same array, or both null, are equal.
+  __ Cmp(lhs, rhs);
+  __ B(&return_true, eq);
+
+  // Only one of them can be null now.
+  __ Cbz(lhs, &return_false);
+  __ Cbz(rhs, &return_false);
+
+  // Arrays of different lengths are not equal.
+  __ Ldr(count.W(), MemOperand(lhs.X(), length_offset));
+  __ Ldr(lhs_data1.W(), MemOperand(rhs.X(), length_offset));
+  __ Cmp(count.W(), lhs_data1.W());
+  __ B(&return_false, ne);
+
+  // Compare the contents as bytes, 16 at a time.
+  __ Add(lhs_base, lhs.X(), data_offset);
+  __ Add(rhs_base, rhs.X(), data_offset);
+  __ Lsl(count, count, Primitive::ComponentSizeShift(type));
+  __ Bind(&loop);
+  __ Cmp(count, kPairSize);
+  __ B(&tail, lt);
+  __ Ldp(lhs_data1, lhs_data2, MemOperand(lhs_base, kPairSize, PostIndex));
+  __ Ldp(rhs_data1, rhs_data2, MemOperand(rhs_base, kPairSize, PostIndex));
+  __ Cmp(lhs_data1, rhs_data1);
+  __ Ccmp(lhs_data2, rhs_data2, NoFlag, eq);
+  __ B(&return_false, ne);
+  __ Sub(count, count, kPairSize);
+  __ B(&loop);
+
+  // Compare the remaining bytes.
+  __ Bind(&tail);
+  __ Cbz(count, &return_true);
+  __ Bind(&tail_loop);
+  __ Ldrb(lhs_data1.W(), MemOperand(lhs_base, 1, PostIndex));
+  __ Ldrb(rhs_data1.W(), MemOperand(rhs_base, 1, PostIndex));
+  __ Cmp(lhs_data1.W(), rhs_data1.W());
+  __ B(&return_false, ne);
+  __ Sub(count, count, 1, SetFlags);
+  __ B(&tail_loop, ne);
+
+  __ Bind(&return_true);
+  __ Mov(out, 1);
+  __ B(&end);
+
+  __ Bind(&return_false);
+  __ Mov(out, 0);
+  __ Bind(&end);
+}
+
+#define ARRAYS_EQUALS(Name)                                                        \
+void IntrinsicLocationsBuilderARM64::VisitArraysEquals ## Name(HInvoke* invoke) {  \
+  CreateArraysEqualsLocations(arena_, invoke);                                     \
+}                                                                                  \
+void IntrinsicCodeGeneratorARM64::VisitArraysEquals ## Name(HInvoke* invoke) {     \
+  GenArraysEquals(GetVIXLAssembler(), invoke, Primitive::kPrim ## Name);           \
+}
+
+ARRAYS_EQUALS(Byte)
+ARRAYS_EQUALS(Char)
+ARRAYS_EQUALS(Short)
+ARRAYS_EQUALS(Int)
+ARRAYS_EQUALS(Long)
+
+#undef ARRAYS_EQUALS
+
 // Unimplemented intrinsics.
 
 #define UNIMPLEMENTED_INTRINSIC(Name)                                                  \
@@ -1458,7 +1780,6 @@ void IntrinsicLocationsBuilderARM64::Visit ## Name(HInvoke* invoke ATTRIBUTE_UNU
 void IntrinsicCodeGeneratorARM64::Visit ## Name(HInvoke* invoke ATTRIBUTE_UNUSED) {    \
 }
 
-UNIMPLEMENTED_INTRINSIC(SystemArrayCopyChar)
 UNIMPLEMENTED_INTRINSIC(SystemArrayCopy)
 UNIMPLEMENTED_INTRINSIC(ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(StringGetCharsNoCheck)
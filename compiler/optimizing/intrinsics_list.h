@@ -59,6 +59,23 @@
   V(MathRoundFloat, kStatic, kNeedsEnvironmentOrCache) \
   V(SystemArrayCopyChar, kStatic, kNeedsEnvironmentOrCache) \
   V(SystemArrayCopy, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyBoolean, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyByte, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyShort, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyInt, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyLong, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyFloat, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyDouble, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysFillByte, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysFillChar, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysFillShort, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysFillInt, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysFillLong, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysEqualsByte, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysEqualsChar, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysEqualsShort, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysEqualsInt, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysEqualsLong, kStatic, kNeedsEnvironmentOrCache) \
   V(ThreadCurrentThread, kStatic, kNeedsEnvironmentOrCache) \
   V(MemoryPeekByte, kStatic, kNeedsEnvironmentOrCache) \
   V(MemoryPeekIntNative, kStatic, kNeedsEnvironmentOrCache) \
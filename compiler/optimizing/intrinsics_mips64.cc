@@ -1530,6 +1530,23 @@ UNIMPLEMENTED_INTRINSIC(ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(StringGetCharsNoCheck)
 UNIMPLEMENTED_INTRINSIC(SystemArrayCopyChar)
 UNIMPLEMENTED_INTRINSIC(SystemArrayCopy)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyBoolean)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyByte)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyShort)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyInt)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyLong)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyFloat)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyDouble)
+UNIMPLEMENTED_INTRINSIC(ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(ArraysFillChar)
+UNIMPLEMENTED_INTRINSIC(ArraysFillShort)
+UNIMPLEMENTED_INTRINSIC(ArraysFillInt)
+UNIMPLEMENTED_INTRINSIC(ArraysFillLong)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsChar)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsShort)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsLong)
 
 #undef UNIMPLEMENTED_INTRINSIC
 
@@ -818,7 +818,7 @@ void IntrinsicCodeGeneratorX86::VisitStringCharAt(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
-void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
+static void CreateSystemArrayCopyPrimitiveLocations(ArenaAllocator* arena, HInvoke* invoke) {
   // We need at least two of the positions or length to be an integer constant,
   // or else we won't have enough free registers.
   HIntConstant* src_pos = invoke->InputAt(1)->AsIntConstant();
@@ -854,7 +854,7 @@ void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
 
   // Okay, it is safe to generate inline code.
   LocationSummary* locations =
-    new (arena_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+    new (arena) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
   // arraycopy(Object src, int srcPos, Object dest, int destPos, int length).
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RegisterOrConstant(invoke->InputAt(1)));
@@ -862,12 +862,16 @@ void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
   locations->SetInAt(3, Location::RegisterOrConstant(invoke->InputAt(3)));
   locations->SetInAt(4, Location::RegisterOrConstant(invoke->InputAt(4)));
 
-  // And we need some temporaries.  We will use REP MOVSW, so we need fixed registers.
+  // And we need some temporaries.  We will use REP MOVS, so we need fixed registers.
   locations->AddTemp(Location::RegisterLocation(ESI));
   locations->AddTemp(Location::RegisterLocation(EDI));
   locations->AddTemp(Location::RegisterLocation(ECX));
 }
 
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);
+}
+
 static void CheckPosition(X86Assembler* assembler,
                           Location pos,
                           Register input,
@@ -913,8 +917,10 @@ static void CheckPosition(X86Assembler* assembler,
   }
 }
 
-void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
-  X86Assembler* assembler = GetAssembler();
+static void GenSystemArrayCopyPrimitive(X86Assembler* assembler,
+                                        CodeGeneratorX86* codegen,
+                                        HInvoke* invoke,
+                                        Primitive::Type type) {
   LocationSummary* locations = invoke->GetLocations();
 
   Register src = locations->InAt(0).AsRegister<Register>();
@@ -923,7 +929,7 @@ void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
   Location destPos = locations->InAt(3);
   Location length = locations->InAt(4);
 
-  // Temporaries that we need for MOVSW.
+  // Temporaries that we need for MOVS.
   Register src_base = locations->GetTemp(0).AsRegister<Register>();
   DCHECK_EQ(src_base, ESI);
   Register dest_base = locations->GetTemp(1).AsRegister<Register>();
@@ -931,8 +937,9 @@ void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
   Register count = locations->GetTemp(2).AsRegister<Register>();
   DCHECK_EQ(count, ECX);
 
-  SlowPathCode* slow_path = new (GetAllocator()) IntrinsicSlowPathX86(invoke);
-  codegen_->AddSlowPath(slow_path);
+  SlowPathCode* slow_path =
+      new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathX86(invoke);
+  codegen->AddSlowPath(slow_path);
 
   // Bail out if the source and destination are the same (to handle overlap).
   __ cmpl(src, dest);
@@ -967,34 +974,244 @@ void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
   CheckPosition(assembler, destPos, dest, count, slow_path, src_base, dest_base);
 
   // Okay, everything checks out.  Finally time to do the copy.
-  // Check assumption that sizeof(Char) is 2 (used in scaling below).
-  const size_t char_size = Primitive::ComponentSize(Primitive::kPrimChar);
-  DCHECK_EQ(char_size, 2u);
-
-  const uint32_t data_offset = mirror::Array::DataOffset(char_size).Uint32Value();
+  const size_t element_size = Primitive::ComponentSize(type);
+  const ScaleFactor scale_factor = static_cast<ScaleFactor>(Primitive::ComponentSizeShift(type));
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
 
   if (srcPos.IsConstant()) {
     int32_t srcPos_const = srcPos.GetConstant()->AsIntConstant()->GetValue();
-    __ leal(src_base, Address(src, char_size * srcPos_const + data_offset));
+    __ leal(src_base, Address(src, element_size * srcPos_const + data_offset));
   } else {
-    __ leal(src_base, Address(src, srcPos.AsRegister<Register>(),
-                              ScaleFactor::TIMES_2, data_offset));
+    __ leal(src_base, Address(src, srcPos.AsRegister<Register>(), scale_factor, data_offset));
   }
   if (destPos.IsConstant()) {
     int32_t destPos_const = destPos.GetConstant()->AsIntConstant()->GetValue();
 
-    __ leal(dest_base, Address(dest, char_size * destPos_const + data_offset));
+    __ leal(dest_base, Address(dest, element_size * destPos_const + data_offset));
   } else {
-    __ leal(dest_base, Address(dest, destPos.AsRegister<Register>(),
-                               ScaleFactor::TIMES_2, data_offset));
+    __ leal(dest_base, Address(dest, destPos.AsRegister<Register>(), scale_factor, data_offset));
   }
 
   // Do the move.
-  __ rep_movsw();
+  switch (element_size) {
+    case 1:
+      __ rep_movsb();
+      break;
+    case 2:
+      __ rep_movsw();
+      break;
+    case 4:
+      __ rep_movsl();
+      break;
+    case 8:
+      // There is no REP MOVSQ in 32-bit mode, move the elements as pairs of words.
+      __ shll(count, Immediate(1));
+      __ rep_movsl();
+      break;
+    default:
+      LOG(FATAL) << "Unexpected element size " << element_size;
+      UNREACHABLE();
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(GetAssembler(), codegen_, invoke, Primitive::kPrimChar);
+}
+
+#define SYSTEM_ARRAYCOPY_PRIMITIVE(Name)                                                  \
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopy ## Name(HInvoke* invoke) {        \
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);                                \
+}                                                                                         \
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopy ## Name(HInvoke* invoke) {           \
+  GenSystemArrayCopyPrimitive(GetAssembler(), codegen_, invoke, Primitive::kPrim ## Name); \
+}
+
+SYSTEM_ARRAYCOPY_PRIMITIVE(Boolean)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Byte)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Short)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Int)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Long)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Float)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Double)
+
+#undef SYSTEM_ARRAYCOPY_PRIMITIVE
+
+static void CreateArraysFillLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (arena) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  // fill(array, value).
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+
+  // We will use REP STOS, so we need fixed registers.
+  locations->AddTemp(Location::RegisterLocation(EDI));
+  locations->AddTemp(Location::RegisterLocation(ECX));
+  locations->AddTemp(Location::RegisterLocation(EAX));
+}
+
+static void GenArraysFill(X86Assembler* assembler,
+                          CodeGeneratorX86* codegen,
+                          HInvoke* invoke,
+                          Primitive::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register array = locations->InAt(0).AsRegister<Register>();
+  Register value = locations->InAt(1).AsRegister<Register>();
+  Register dest_base = locations->GetTemp(0).AsRegister<Register>();
+  DCHECK_EQ(dest_base, EDI);
+  Register count = locations->GetTemp(1).AsRegister<Register>();
+  DCHECK_EQ(count, ECX);
+  Register pattern = locations->GetTemp(2).AsRegister<Register>();
+  DCHECK_EQ(pattern, EAX);
+
+  // Let the library method throw the NullPointerException.
+  SlowPathCode* slow_path =
+      new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathX86(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ testl(array, array);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  const size_t element_size = Primitive::ComponentSize(type);
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
+
+  __ movl(count, Address(array, length_offset));
+  __ leal(dest_base, Address(array, data_offset));
+  __ movl(pattern, value);
+  switch (element_size) {
+    case 1:
+      __ rep_stosb();
+      break;
+    case 2:
+      __ rep_stosw();
+      break;
+    case 4:
+      __ rep_stosl();
+      break;
+    default:
+      LOG(FATAL) << "Unexpected element size " << element_size;
+      UNREACHABLE();
+  }
 
   __ Bind(slow_path->GetExitLabel());
 }
 
+#define ARRAYS_FILL(Name)                                                          \
+void IntrinsicLocationsBuilderX86::VisitArraysFill ## Name(HInvoke* invoke) {      \
+  CreateArraysFillLocations(arena_, invoke);                                       \
+}                                                                                  \
+void IntrinsicCodeGeneratorX86::VisitArraysFill ## Name(HInvoke* invoke) {         \
+  GenArraysFill(GetAssembler(), codegen_, invoke, Primitive::kPrim ## Name);       \
+}
+
+ARRAYS_FILL(Byte)
+ARRAYS_FILL(Char)
+ARRAYS_FILL(Short)
+ARRAYS_FILL(Int)
+
+#undef ARRAYS_FILL
+
+static void CreateArraysEqualsLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (arena) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+
+  // We will use REPE CMPS, so we need fixed registers.
+  locations->AddTemp(Location::RegisterLocation(ESI));
+  locations->AddTemp(Location::RegisterLocation(EDI));
+  locations->AddTemp(Location::RegisterLocation(ECX));
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenArraysEquals(X86Assembler* assembler, HInvoke* invoke, Primitive::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register lhs = locations->InAt(0).AsRegister<Register>();
+  Register rhs = locations->InAt(1).AsRegister<Register>();
+  Register lhs_base = locations->GetTemp(0).AsRegister<Register>();
+  DCHECK_EQ(lhs_base, ESI);
+  Register rhs_base = locations->GetTemp(1).AsRegister<Register>();
+  DCHECK_EQ(rhs_base, EDI);
+  Register count = locations->GetTemp(2).AsRegister<Register>();
+  DCHECK_EQ(count, ECX);
+  Register out = locations->Out().AsRegister<Register>();
+
+  NearLabel end, return_true, return_false;
+
+  const size_t element_size = Primitive::ComponentSize(type);
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
+
+  // The same array, or both null, are equal.
+  __ cmpl(lhs, rhs);
+  __ j(kEqual, &return_true);
+
+  // Only one of them can be null now.
+  __ testl(lhs, lhs);
+  __ j(kEqual, &return_false);
+  __ testl(rhs, rhs);
+  __ j(kEqual, &return_false);
+
+  // Arrays of different lengths are not equal.
+  __ movl(count, Address(lhs, length_offset));
+  __ cmpl(count, Address(rhs, length_offset));
+  __ j(kNotEqual, &return_false);
+
+  // REPE CMPS does not set the flags when the count is zero.
+  __ testl(count, count);
+  __ j(kEqual, &return_true);
+
+  __ leal(lhs_base, Address(lhs, data_offset));
+  __ leal(rhs_base, Address(rhs, data_offset));
+  switch (element_size) {
+    case 1:
+      __ repe_cmpsb();
+      break;
+    case 2:
+      __ repe_cmpsw();
+      break;
+    case 4:
+      __ repe_cmpsl();
+      break;
+    case 8:
+      // There is no REPE CMPSQ in 32-bit mode, compare the elements as pairs of words.
+      __ shll(count, Immediate(1));
+      __ repe_cmpsl();
+      break;
+    default:
+      LOG(FATAL) << "Unexpected element size " << element_size;
+      UNREACHABLE();
+  }
+  __ j(kNotEqual, &return_false);
+
+  __ Bind(&return_true);
+  __ movl(out, Immediate(1));
+  __ jmp(&end);
+
+  __ Bind(&return_false);
+  __ xorl(out, out);
+  __ Bind(&end);
+}
+
+#define ARRAYS_EQUALS(Name)                                                        \
+void IntrinsicLocationsBuilderX86::VisitArraysEquals ## Name(HInvoke* invoke) {    \
+  CreateArraysEqualsLocations(arena_, invoke);                                     \
+}                                                                                  \
+void IntrinsicCodeGeneratorX86::VisitArraysEquals ## Name(HInvoke* invoke) {       \
+  GenArraysEquals(GetAssembler(), invoke, Primitive::kPrim ## Name);               \
+}
+
+ARRAYS_EQUALS(Byte)
+ARRAYS_EQUALS(Char)
+ARRAYS_EQUALS(Short)
+ARRAYS_EQUALS(Int)
+ARRAYS_EQUALS(Long)
+
+#undef ARRAYS_EQUALS
+
 void IntrinsicLocationsBuilderX86::VisitStringCompareTo(HInvoke* invoke) {
   // The inputs plus one temp.
   LocationSummary* locations = new (arena_) LocationSummary(invoke,
@@ -2309,6 +2526,7 @@ UNIMPLEMENTED_INTRINSIC(ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(LongRotateRight)
 UNIMPLEMENTED_INTRINSIC(LongRotateLeft)
 UNIMPLEMENTED_INTRINSIC(SystemArrayCopy)
+UNIMPLEMENTED_INTRINSIC(ArraysFillLong)
 
 #undef UNIMPLEMENTED_INTRINSIC
 
@@ -730,7 +730,10 @@ void IntrinsicCodeGeneratorX86_64::VisitStringCharAt(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
-void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+// The number of bytes moved or compared at a time by the vector loops of the array intrinsics.
+static constexpr int32_t kVectorSize = 16;
+
+static void CreateSystemArrayCopyPrimitiveLocations(ArenaAllocator* arena, HInvoke* invoke) {
   // Check to see if we have known failures that will cause us to have to bail out
   // to the runtime, and just generate the runtime call directly.
   HIntConstant* src_pos = invoke->InputAt(1)->AsIntConstant();
@@ -753,7 +756,7 @@ void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke)
     }
   }
 
-  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
                                                             LocationSummary::kCallOnSlowPath,
                                                             kIntrinsified);
   // arraycopy(Object src, int src_pos, Object dest, int dest_pos, int length).
@@ -763,10 +766,16 @@ void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke)
   locations->SetInAt(3, Location::RegisterOrConstant(invoke->InputAt(3)));
   locations->SetInAt(4, Location::RegisterOrConstant(invoke->InputAt(4)));
 
-  // And we need some temporaries.  We will use REP MOVSW, so we need fixed registers.
+  // And we need some temporaries.  We will use REP MOVSB for the tail, so we need fixed
+  // registers, and an XMM register for the 16 byte moves.
   locations->AddTemp(Location::RegisterLocation(RSI));
   locations->AddTemp(Location::RegisterLocation(RDI));
   locations->AddTemp(Location::RegisterLocation(RCX));
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);
 }
 
 static void CheckPosition(X86_64Assembler* assembler,
@@ -835,8 +844,10 @@ static void CheckPosition(X86_64Assembler* assembler,
   }
 }
 
-void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
-  X86_64Assembler* assembler = GetAssembler();
+static void GenSystemArrayCopyPrimitive(X86_64Assembler* assembler,
+                                        CodeGeneratorX86_64* codegen,
+                                        HInvoke* invoke,
+                                        Primitive::Type type) {
   LocationSummary* locations = invoke->GetLocations();
 
   CpuRegister src = locations->InAt(0).AsRegister<CpuRegister>();
@@ -845,16 +856,18 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   Location dest_pos = locations->InAt(3);
   Location length = locations->InAt(4);
 
-  // Temporaries that we need for MOVSW.
+  // Temporaries that we need for MOVDQU and MOVSB.
   CpuRegister src_base = locations->GetTemp(0).AsRegister<CpuRegister>();
   DCHECK_EQ(src_base.AsRegister(), RSI);
   CpuRegister dest_base = locations->GetTemp(1).AsRegister<CpuRegister>();
   DCHECK_EQ(dest_base.AsRegister(), RDI);
   CpuRegister count = locations->GetTemp(2).AsRegister<CpuRegister>();
   DCHECK_EQ(count.AsRegister(), RCX);
+  XmmRegister vector = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
 
-  SlowPathCode* slow_path = new (GetAllocator()) IntrinsicSlowPathX86_64(invoke);
-  codegen_->AddSlowPath(slow_path);
+  SlowPathCode* slow_path =
+      new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
 
   // Bail out if the source and destination are the same.
   __ cmpl(src, dest);
@@ -889,33 +902,292 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   }
 
   // Okay, everything checks out.  Finally time to do the copy.
-  // Check assumption that sizeof(Char) is 2 (used in scaling below).
-  const size_t char_size = Primitive::ComponentSize(Primitive::kPrimChar);
-  DCHECK_EQ(char_size, 2u);
-
-  const uint32_t data_offset = mirror::Array::DataOffset(char_size).Uint32Value();
+  const size_t element_size = Primitive::ComponentSize(type);
+  const size_t element_size_shift = Primitive::ComponentSizeShift(type);
+  const ScaleFactor scale_factor = static_cast<ScaleFactor>(element_size_shift);
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
 
   if (src_pos.IsConstant()) {
     int32_t src_pos_const = src_pos.GetConstant()->AsIntConstant()->GetValue();
-    __ leal(src_base, Address(src, char_size * src_pos_const + data_offset));
+    __ leal(src_base, Address(src, element_size * src_pos_const + data_offset));
   } else {
-    __ leal(src_base, Address(src, src_pos.AsRegister<CpuRegister>(),
-                              ScaleFactor::TIMES_2, data_offset));
+    __ leal(src_base, Address(src, src_pos.AsRegister<CpuRegister>(), scale_factor, data_offset));
   }
   if (dest_pos.IsConstant()) {
     int32_t dest_pos_const = dest_pos.GetConstant()->AsIntConstant()->GetValue();
-    __ leal(dest_base, Address(dest, char_size * dest_pos_const + data_offset));
+    __ leal(dest_base, Address(dest, element_size * dest_pos_const + data_offset));
   } else {
-    __ leal(dest_base, Address(dest, dest_pos.AsRegister<CpuRegister>(),
-                               ScaleFactor::TIMES_2, data_offset));
+    __ leal(dest_base,
+            Address(dest, dest_pos.AsRegister<CpuRegister>(), scale_factor, data_offset));
   }
 
-  // Do the move.
-  __ rep_movsw();
+  // Turn the count into bytes. The source and destination are different arrays, so they
+  // cannot overlap and the copy can go forward 16 bytes at a time.
+  if (element_size_shift != 0) {
+    __ shlq(count, Immediate(element_size_shift));
+  }
+  NearLabel loop, tail;
+  __ Bind(&loop);
+  __ cmpq(count, Immediate(kVectorSize));
+  __ j(kLess, &tail);
+  __ movdqu(vector, Address(src_base, 0));
+  __ movdqu(Address(dest_base, 0), vector);
+  __ addq(src_base, Immediate(kVectorSize));
+  __ addq(dest_base, Immediate(kVectorSize));
+  __ subq(count, Immediate(kVectorSize));
+  __ jmp(&loop);
+
+  // Move the remaining bytes.
+  __ Bind(&tail);
+  __ rep_movsb();
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(GetAssembler(), codegen_, invoke, Primitive::kPrimChar);
+}
+
+#define SYSTEM_ARRAYCOPY_PRIMITIVE(Name)                                                  \
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopy ## Name(HInvoke* invoke) {     \
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);                                \
+}                                                                                         \
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopy ## Name(HInvoke* invoke) {        \
+  GenSystemArrayCopyPrimitive(GetAssembler(), codegen_, invoke, Primitive::kPrim ## Name); \
+}
+
+SYSTEM_ARRAYCOPY_PRIMITIVE(Boolean)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Byte)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Short)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Int)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Long)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Float)
+SYSTEM_ARRAYCOPY_PRIMITIVE(Double)
+
+#undef SYSTEM_ARRAYCOPY_PRIMITIVE
+
+static void CreateArraysFillLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kCallOnSlowPath,
+                                                           kIntrinsified);
+  // fill(array, value).
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+
+  // We will use REP STOS for the tail, so we need fixed registers, and an XMM register
+  // holding the value in each element of a vector.
+  locations->AddTemp(Location::RegisterLocation(RDI));
+  locations->AddTemp(Location::RegisterLocation(RCX));
+  locations->AddTemp(Location::RegisterLocation(RAX));
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+static void GenArraysFill(X86_64Assembler* assembler,
+                          CodeGeneratorX86_64* codegen,
+                          HInvoke* invoke,
+                          Primitive::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister dest_base = locations->GetTemp(0).AsRegister<CpuRegister>();
+  DCHECK_EQ(dest_base.AsRegister(), RDI);
+  CpuRegister count = locations->GetTemp(1).AsRegister<CpuRegister>();
+  DCHECK_EQ(count.AsRegister(), RCX);
+  CpuRegister pattern = locations->GetTemp(2).AsRegister<CpuRegister>();
+  DCHECK_EQ(pattern.AsRegister(), RAX);
+  XmmRegister vector = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+
+  // Let the library method throw the NullPointerException.
+  SlowPathCode* slow_path =
+      new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ testl(array, array);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  const size_t element_size = Primitive::ComponentSize(type);
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
+  const int32_t elements_per_vector = kVectorSize / element_size;
+
+  // Broadcast the value to all the elements of the vector.
+  bool is64bit = (type == Primitive::kPrimLong);
+  __ movd(vector, value, is64bit);
+  switch (element_size) {
+    case 1:
+      __ punpcklbw(vector, vector);
+      FALLTHROUGH_INTENDED;
+    case 2:
+      __ punpcklwd(vector, vector);
+      FALLTHROUGH_INTENDED;
+    case 4:
+      __ pshufd(vector, vector, Immediate(0));
+      break;
+    case 8:
+      __ pshufd(vector, vector, Immediate(0x44));
+      break;
+    default:
+      LOG(FATAL) << "Unexpected element size " << element_size;
+      UNREACHABLE();
+  }
+
+  __ movl(count, Address(array, length_offset));
+  __ leal(dest_base, Address(array, data_offset));
+
+  NearLabel loop, tail;
+  __ Bind(&loop);
+  __ cmpl(count, Immediate(elements_per_vector));
+  __ j(kLess, &tail);
+  __ movdqu(Address(dest_base, 0), vector);
+  __ addq(dest_base, Immediate(kVectorSize));
+  __ subl(count, Immediate(elements_per_vector));
+  __ jmp(&loop);
+
+  // Store the remaining elements.
+  __ Bind(&tail);
+  __ movq(pattern, value);
+  switch (element_size) {
+    case 1:
+      __ rep_stosb();
+      break;
+    case 2:
+      __ rep_stosw();
+      break;
+    case 4:
+      __ rep_stosl();
+      break;
+    case 8:
+      __ rep_stosq();
+      break;
+    default:
+      LOG(FATAL) << "Unexpected element size " << element_size;
+      UNREACHABLE();
+  }
 
   __ Bind(slow_path->GetExitLabel());
 }
 
+#define ARRAYS_FILL(Name)                                                          \
+void IntrinsicLocationsBuilderX86_64::VisitArraysFill ## Name(HInvoke* invoke) {   \
+  CreateArraysFillLocations(arena_, invoke);                                       \
+}                                                                                  \
+void IntrinsicCodeGeneratorX86_64::VisitArraysFill ## Name(HInvoke* invoke) {      \
+  GenArraysFill(GetAssembler(), codegen_, invoke, Primitive::kPrim ## Name);       \
+}
+
+ARRAYS_FILL(Byte)
+ARRAYS_FILL(Char)
+ARRAYS_FILL(Short)
+ARRAYS_FILL(Int)
+ARRAYS_FILL(Long)
+
+#undef ARRAYS_FILL
+
+static void CreateArraysEqualsLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+
+  // We will use REPE CMPSB for the tail, so we need fixed registers, and two XMM
+  // registers for the 16 byte comparisons.
+  locations->AddTemp(Location::RegisterLocation(RSI));
+  locations->AddTemp(Location::RegisterLocation(RDI));
+  locations->AddTemp(Location::RegisterLocation(RCX));
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenArraysEquals(X86_64Assembler* assembler, HInvoke* invoke, Primitive::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister lhs = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister rhs = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister lhs_base = locations->GetTemp(0).AsRegister<CpuRegister>();
+  DCHECK_EQ(lhs_base.AsRegister(), RSI);
+  CpuRegister rhs_base = locations->GetTemp(1).AsRegister<CpuRegister>();
+  DCHECK_EQ(rhs_base.AsRegister(), RDI);
+  CpuRegister count = locations->GetTemp(2).AsRegister<CpuRegister>();
+  DCHECK_EQ(count.AsRegister(), RCX);
+  XmmRegister lhs_vector = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs_vector = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  NearLabel loop, tail, end, return_true, return_false;
+
+  const size_t element_size_shift = Primitive::ComponentSizeShift(type);
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Uint32Value();
+
+  // The same array, or both null, are equal.
+  __ cmpl(lhs, rhs);
+  __ j(kEqual, &return_true);
+
+  // Only one of them can be null now.
+  __ testl(lhs, lhs);
+  __ j(kEqual, &return_false);
+  __ testl(rhs, rhs);
+  __ j(kEqual, &return_false);
+
+  // Arrays of different lengths are not equal.
+  __ movl(count, Address(lhs, length_offset));
+  __ cmpl(count, Address(rhs, length_offset));
+  __ j(kNotEqual, &return_false);
+
+  // Compare the contents as bytes, 16 at a time.
+  __ leal(lhs_base, Address(lhs, data_offset));
+  __ leal(rhs_base, Address(rhs, data_offset));
+  if (element_size_shift != 0) {
+    __ shlq(count, Immediate(element_size_shift));
+  }
+  __ Bind(&loop);
+  __ cmpq(count, Immediate(kVectorSize));
+  __ j(kLess, &tail);
+  __ movdqu(lhs_vector, Address(lhs_base, 0));
+  __ movdqu(rhs_vector, Address(rhs_base, 0));
+  __ pcmpeqb(lhs_vector, rhs_vector);
+  __ pmovmskb(out, lhs_vector);
+  __ cmpl(out, Immediate(0xffff));
+  __ j(kNotEqual, &return_false);
+  __ addq(lhs_base, Immediate(kVectorSize));
+  __ addq(rhs_base, Immediate(kVectorSize));
+  __ subq(count, Immediate(kVectorSize));
+  __ jmp(&loop);
+
+  // Compare the remaining bytes. REPE CMPSB does not set the flags when the count is zero.
+  __ Bind(&tail);
+  __ testq(count, count);
+  __ j(kEqual, &return_true);
+  __ repe_cmpsb();
+  __ j(kNotEqual, &return_false);
+
+  __ Bind(&return_true);
+  __ movl(out, Immediate(1));
+  __ jmp(&end);
+
+  __ Bind(&return_false);
+  __ xorl(out, out);
+  __ Bind(&end);
+}
+
+#define ARRAYS_EQUALS(Name)                                                        \
+void IntrinsicLocationsBuilderX86_64::VisitArraysEquals ## Name(HInvoke* invoke) { \
+  CreateArraysEqualsLocations(arena_, invoke);                                     \
+}                                                                                  \
+void IntrinsicCodeGeneratorX86_64::VisitArraysEquals ## Name(HInvoke* invoke) {    \
+  GenArraysEquals(GetAssembler(), invoke, Primitive::kPrim ## Name);               \
+}
+
+ARRAYS_EQUALS(Byte)
+ARRAYS_EQUALS(Char)
+ARRAYS_EQUALS(Short)
+ARRAYS_EQUALS(Int)
+ARRAYS_EQUALS(Long)
+
+#undef ARRAYS_EQUALS
 
 void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopy(HInvoke* invoke) {
   CodeGenerator::CreateSystemArrayCopyLocationSummary(invoke);
@@ -23,6 +23,18 @@ static bool IsPhiOf(HInstruction* instruction, HBasicBlock* block) {
   return instruction->IsPhi() && instruction->GetBlock() == block;
 }
 
+/**
+ * Returns whether an exception thrown in `block` and an exception thrown in
+ * `other` are caught by the same catch blocks, if any.
+ */
+static bool HaveSameExceptionHandlers(HBasicBlock* block, HBasicBlock* other) {
+  if (!block->IsTryBlock() || !other->IsTryBlock()) {
+    return !block->IsTryBlock() && !other->IsTryBlock();
+  }
+  const HTryBoundary& try_entry = block->GetTryCatchInformation()->GetTryEntry();
+  return try_entry.HasSameExceptionHandlersAs(other->GetTryCatchInformation()->GetTryEntry());
+}
+
 /**
  * Returns whether `instruction` has all its inputs and environment defined
  * before the loop it is in.
@@ -93,6 +105,11 @@ void LICM::Run() {
     HLoopInformation* loop_info = block->GetLoopInformation();
     SideEffects loop_effects = side_effects_.GetLoopEffects(block);
     HBasicBlock* pre_header = loop_info->GetPreHeader();
+    // An instruction that can throw can only be hoisted if it still throws into
+    // the same catch blocks, which is not the case when the loop is entered
+    // through a try boundary. Catch phis do not need to be updated, they take
+    // their values from the environment of the throwing instruction.
+    bool can_hoist_throwing_instructions = HaveSameExceptionHandlers(pre_header, block);
 
     for (HBlocksInLoopIterator it_loop(*loop_info); !it_loop.Done(); it_loop.Advance()) {
       HBasicBlock* inner = it_loop.Current();
@@ -108,7 +125,8 @@ void LICM::Run() {
       // throwing instruction in the loop. Note that the first potentially
       // throwing instruction encountered that is not hoisted stops this
       // optimization. Non-throwing instruction can still be hoisted.
-      bool found_first_non_hoisted_throwing_instruction_in_loop = !inner->IsLoopHeader();
+      bool found_first_non_hoisted_throwing_instruction_in_loop =
+          !inner->IsLoopHeader() || !can_hoist_throwing_instructions;
       for (HInstructionIterator inst_it(inner->GetInstructions());
            !inst_it.Done();
            inst_it.Advance()) {
@@ -0,0 +1,958 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "load_store_elimination.h"
+
+#include <algorithm>
+
+#include "base/arena_containers.h"
+#include "side_effects_analysis.h"
+#include "utils/arena_bit_vector.h"
+
+namespace art {
+
+// Beyond this many heap locations, the pairwise aliasing and the per block heap
+// values get too expensive for what the pass usually finds.
+static constexpr size_t kMaxNumberOfHeapLocations = 32;
+
+/**
+ * A ReferenceInfo holds the escape information of a reference used by heap
+ * accesses in the method.
+ */
+class ReferenceInfo : public ArenaObject<kArenaAllocLSE> {
+ public:
+  ReferenceInfo(HInstruction* reference, size_t position)
+      : reference_(reference),
+        position_(position),
+        is_singleton_(true),
+        is_singleton_and_not_returned_(true) {
+    if (!reference_->IsNewInstance() && !reference_->IsNewArray()) {
+      // For references not allocated in the method, don't assume anything.
+      is_singleton_ = false;
+      is_singleton_and_not_returned_ = false;
+      return;
+    }
+
+    // Visit all uses to determine if this reference can spread into the heap,
+    // a method call, etc. Only uses known not to leak the reference keep it
+    // a singleton.
+    for (HUseIterator<HInstruction*> it(reference_->GetUses()); !it.Done(); it.Advance()) {
+      HInstruction* user = it.Current()->GetUser();
+      size_t input_index = it.Current()->GetIndex();
+      if (user->IsReturn()) {
+        is_singleton_and_not_returned_ = false;
+      } else if (!IsNonEscapingUse(user, input_index)) {
+        is_singleton_ = false;
+        is_singleton_and_not_returned_ = false;
+        return;
+      }
+    }
+  }
+
+  HInstruction* GetReference() const { return reference_; }
+
+  // Position of the reference in the order the heap location collector found
+  // it, which follows the reverse post order of the graph.
+  size_t GetPosition() const { return position_; }
+
+  // Returns true if reference_ is the only name that can refer to its value
+  // during the lifetime of the method. So it is guaranteed to not have any
+  // alias in the method, including its callees.
+  bool IsSingleton() const { return is_singleton_; }
+
+  // Returns true if reference_ is a singleton and is not returned to the
+  // caller. The stores into reference_, and reference_ itself, may then be
+  // eliminated.
+  bool IsSingletonAndNotReturned() const { return is_singleton_and_not_returned_; }
+
+ private:
+  static bool IsNonEscapingUse(HInstruction* user, size_t input_index) {
+    if (user->IsInstanceFieldGet() ||
+        user->IsArrayGet() ||
+        user->IsArrayLength() ||
+        user->IsInstanceOf() ||
+        user->IsCheckCast() ||
+        user->IsEqual() ||
+        user->IsNotEqual()) {
+      return true;
+    }
+    // Stores into the reference are fine, storing the reference itself is not.
+    return (user->IsInstanceFieldSet() || user->IsArraySet()) && input_index == 0;
+  }
+
+  HInstruction* const reference_;
+  const size_t position_;
+  bool is_singleton_;
+  bool is_singleton_and_not_returned_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReferenceInfo);
+};
+
+/**
+ * A HeapLocation is an instance field, static field or array element
+ * accessed in the method.
+ */
+class HeapLocation : public ArenaObject<kArenaAllocLSE> {
+ public:
+  static constexpr size_t kInvalidFieldOffset = -1;
+
+  HeapLocation(ReferenceInfo* ref_info, size_t offset, HInstruction* index)
+      : ref_info_(ref_info),
+        offset_(offset),
+        index_(index),
+        value_killed_by_loop_side_effects_(true) {
+    DCHECK(ref_info != nullptr);
+    DCHECK((offset == kInvalidFieldOffset && index != nullptr) ||
+           (offset != kInvalidFieldOffset && index == nullptr));
+    if (ref_info->IsSingleton() && !IsArrayElement()) {
+      // Assume this location's value cannot be killed by loop side effects
+      // until proven otherwise.
+      value_killed_by_loop_side_effects_ = false;
+    }
+  }
+
+  ReferenceInfo* GetReferenceInfo() const { return ref_info_; }
+  size_t GetOffset() const { return offset_; }
+  HInstruction* GetIndex() const { return index_; }
+  bool IsArrayElement() const { return index_ != nullptr; }
+
+  bool IsValueKilledByLoopSideEffects() const { return value_killed_by_loop_side_effects_; }
+  void SetValueKilledByLoopSideEffects(bool value) { value_killed_by_loop_side_effects_ = value; }
+
+ private:
+  ReferenceInfo* const ref_info_;
+  // Offset of the field, or kInvalidFieldOffset for an array element. Fields
+  // are only identified by their offset: two fields at the same offset of
+  // different classes are conservatively considered to alias.
+  const size_t offset_;
+  // Index of the array element, or null for a field.
+  HInstruction* const index_;
+  // Whether the value of the location may be changed by the side effects of a
+  // loop. Always true for locations of non-singletons.
+  bool value_killed_by_loop_side_effects_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapLocation);
+};
+
+static HInstruction* HuntForOriginalReference(HInstruction* ref) {
+  DCHECK(ref != nullptr);
+  while (ref->IsNullCheck() || ref->IsBoundType()) {
+    ref = ref->InputAt(0);
+  }
+  return ref;
+}
+
+/**
+ * A HeapLocationCollector collects all the heap locations of the method and
+ * computes which of them may alias.
+ */
+class HeapLocationCollector : public HGraphVisitor {
+ public:
+  static constexpr size_t kHeapLocationNotFound = -1;
+  // Start with a single uint32_t word. That's enough bits for the pairwise
+  // aliasing matrix of 8 heap locations.
+  static constexpr uint32_t kInitialAliasingMatrixBitVectorSize = 32;
+
+  explicit HeapLocationCollector(HGraph* graph)
+      : HGraphVisitor(graph),
+        ref_info_array_(graph->GetArena()->Adapter(kArenaAllocLSE)),
+        heap_locations_(graph->GetArena()->Adapter(kArenaAllocLSE)),
+        aliasing_matrix_(graph->GetArena(), kInitialAliasingMatrixBitVectorSize, true),
+        has_heap_stores_(false),
+        may_deoptimize_(false) {}
+
+  size_t GetNumberOfHeapLocations() const { return heap_locations_.size(); }
+
+  HeapLocation* GetHeapLocation(size_t index) const { return heap_locations_[index]; }
+
+  ReferenceInfo* FindReferenceInfoOf(HInstruction* ref) const {
+    for (size_t i = 0; i < ref_info_array_.size(); i++) {
+      ReferenceInfo* ref_info = ref_info_array_[i];
+      if (ref_info->GetReference() == ref) {
+        DCHECK_EQ(i, ref_info->GetPosition());
+        return ref_info;
+      }
+    }
+    return nullptr;
+  }
+
+  bool HasHeapStores() const { return has_heap_stores_; }
+
+  // Returns whether the method may be deoptimized. The interpreter would then
+  // need the allocations and stores eliminated by the pass.
+  bool MayDeoptimize() const { return may_deoptimize_; }
+
+  size_t FindHeapLocationIndex(ReferenceInfo* ref_info, size_t offset, HInstruction* index) const {
+    for (size_t i = 0; i < heap_locations_.size(); i++) {
+      HeapLocation* loc = heap_locations_[i];
+      if (loc->GetReferenceInfo() == ref_info &&
+          loc->GetOffset() == offset &&
+          loc->GetIndex() == index) {
+        return i;
+      }
+    }
+    return kHeapLocationNotFound;
+  }
+
+  // Returns true if heap_locations_[index1] and heap_locations_[index2] may alias.
+  bool MayAlias(size_t index1, size_t index2) const {
+    DCHECK_NE(index1, index2);
+    return (index1 < index2)
+        ? aliasing_matrix_.IsBitSet(AliasingMatrixPosition(index1, index2))
+        : aliasing_matrix_.IsBitSet(AliasingMatrixPosition(index2, index1));
+  }
+
+  void BuildAliasingMatrix() {
+    const size_t number_of_locations = heap_locations_.size();
+    if (number_of_locations == 0) {
+      return;
+    }
+    size_t pos = 0;
+    // Compute aliasing info between every pair of different heap locations.
+    // Save the result in a matrix represented as a BitVector.
+    for (size_t i = 0; i < number_of_locations - 1; i++) {
+      for (size_t j = i + 1; j < number_of_locations; j++) {
+        DCHECK_EQ(pos, AliasingMatrixPosition(i, j));
+        if (ComputeMayAlias(i, j)) {
+          aliasing_matrix_.SetBit(pos);
+        }
+        pos++;
+      }
+    }
+  }
+
+ private:
+  // An allocation cannot alias with a name which already exists at the point
+  // of the allocation, such as a parameter or a load happening before it.
+  bool MayAliasWithPreexistenceChecking(ReferenceInfo* ref_info1, ReferenceInfo* ref_info2) const {
+    if (ref_info1->GetReference()->IsNewInstance() || ref_info1->GetReference()->IsNewArray()) {
+      // Any reference that can alias with the allocation must appear after it
+      // in the block or in the block's successors. In reverse post order,
+      // those instructions are visited after the allocation.
+      return ref_info2->GetPosition() >= ref_info1->GetPosition();
+    }
+    return true;
+  }
+
+  bool CanReferencesAlias(ReferenceInfo* ref_info1, ReferenceInfo* ref_info2) const {
+    if (ref_info1 == ref_info2) {
+      return true;
+    } else if (ref_info1->IsSingleton() || ref_info2->IsSingleton()) {
+      return false;
+    }
+    return MayAliasWithPreexistenceChecking(ref_info1, ref_info2) &&
+        MayAliasWithPreexistenceChecking(ref_info2, ref_info1);
+  }
+
+  // `index1` and `index2` are indices in the array of collected heap
+  // locations. Returns the position in the bit vector that tracks whether the
+  // two heap locations may alias.
+  size_t AliasingMatrixPosition(size_t index1, size_t index2) const {
+    DCHECK_GT(index2, index1);
+    const size_t number_of_locations = heap_locations_.size();
+    // It's (num_of_locations - 1) + ... + (num_of_locations - index1) + (index2 - index1 - 1).
+    return (number_of_locations * index1 - (1 + index1) * index1 / 2 + (index2 - index1 - 1));
+  }
+
+  bool ComputeMayAlias(size_t index1, size_t index2) const {
+    HeapLocation* loc1 = heap_locations_[index1];
+    HeapLocation* loc2 = heap_locations_[index2];
+    if (loc1->GetOffset() != loc2->GetOffset()) {
+      // Either two different fields, or a field and an array element.
+      return false;
+    }
+    if (!CanReferencesAlias(loc1->GetReferenceInfo(), loc2->GetReferenceInfo())) {
+      return false;
+    }
+    if (loc1->IsArrayElement() && loc2->IsArrayElement()) {
+      HInstruction* array_index1 = loc1->GetIndex();
+      HInstruction* array_index2 = loc2->GetIndex();
+      if (array_index1->IsIntConstant() &&
+          array_index2->IsIntConstant() &&
+          array_index1->AsIntConstant()->GetValue() != array_index2->AsIntConstant()->GetValue()) {
+        // Different constant indices do not alias.
+        return false;
+      }
+    }
+    return true;
+  }
+
+  ReferenceInfo* GetOrCreateReferenceInfo(HInstruction* ref) {
+    ReferenceInfo* ref_info = FindReferenceInfoOf(ref);
+    if (ref_info == nullptr) {
+      size_t pos = ref_info_array_.size();
+      ref_info = new (GetGraph()->GetArena()) ReferenceInfo(ref, pos);
+      ref_info_array_.push_back(ref_info);
+    }
+    return ref_info;
+  }
+
+  void CreateReferenceInfoForReferenceType(HInstruction* instruction) {
+    if (instruction->GetType() != Primitive::kPrimNot) {
+      return;
+    }
+    DCHECK(FindReferenceInfoOf(instruction) == nullptr);
+    GetOrCreateReferenceInfo(instruction);
+  }
+
+  HeapLocation* GetOrCreateHeapLocation(HInstruction* ref, size_t offset, HInstruction* index) {
+    HInstruction* original_ref = HuntForOriginalReference(ref);
+    ReferenceInfo* ref_info = GetOrCreateReferenceInfo(original_ref);
+    size_t heap_location_idx = FindHeapLocationIndex(ref_info, offset, index);
+    if (heap_location_idx == kHeapLocationNotFound) {
+      HeapLocation* heap_loc = new (GetGraph()->GetArena()) HeapLocation(ref_info, offset, index);
+      heap_locations_.push_back(heap_loc);
+      return heap_loc;
+    }
+    return heap_locations_[heap_location_idx];
+  }
+
+  HeapLocation* VisitFieldAccess(HInstruction* ref, const FieldInfo& field_info) {
+    return GetOrCreateHeapLocation(ref, field_info.GetFieldOffset().SizeValue(), nullptr);
+  }
+
+  void VisitArrayAccess(HInstruction* array, HInstruction* index) {
+    GetOrCreateHeapLocation(array, HeapLocation::kInvalidFieldOffset, index);
+  }
+
+  void VisitInstanceFieldGet(HInstanceFieldGet* instruction) OVERRIDE {
+    VisitFieldAccess(instruction->InputAt(0), instruction->GetFieldInfo());
+    CreateReferenceInfoForReferenceType(instruction);
+  }
+
+  void VisitInstanceFieldSet(HInstanceFieldSet* instruction) OVERRIDE {
+    HeapLocation* location = VisitFieldAccess(instruction->InputAt(0), instruction->GetFieldInfo());
+    has_heap_stores_ = true;
+    if (location->GetReferenceInfo()->IsSingleton()) {
+      // A singleton's location value may be killed by loop side effects if
+      // the singleton is defined before that loop, and stored into inside it.
+      HLoopInformation* loop_info = instruction->GetBlock()->GetLoopInformation();
+      if (loop_info != nullptr) {
+        HInstruction* ref = location->GetReferenceInfo()->GetReference();
+        if (!loop_info->Contains(*ref->GetBlock())) {
+          location->SetValueKilledByLoopSideEffects(true);
+        }
+      }
+    } else {
+      DCHECK(location->IsValueKilledByLoopSideEffects());
+    }
+  }
+
+  void VisitStaticFieldGet(HStaticFieldGet* instruction) OVERRIDE {
+    VisitFieldAccess(instruction->InputAt(0), instruction->GetFieldInfo());
+    CreateReferenceInfoForReferenceType(instruction);
+  }
+
+  void VisitStaticFieldSet(HStaticFieldSet* instruction) OVERRIDE {
+    VisitFieldAccess(instruction->InputAt(0), instruction->GetFieldInfo());
+    has_heap_stores_ = true;
+  }
+
+  // Unresolved field accesses are not collected since the fields they access
+  // are unknown. The LSEVisitor handles them like invokes.
+
+  void VisitArrayGet(HArrayGet* instruction) OVERRIDE {
+    VisitArrayAccess(instruction->InputAt(0), instruction->InputAt(1));
+    CreateReferenceInfoForReferenceType(instruction);
+  }
+
+  void VisitArraySet(HArraySet* instruction) OVERRIDE {
+    VisitArrayAccess(instruction->InputAt(0), instruction->InputAt(1));
+    has_heap_stores_ = true;
+  }
+
+  void VisitNewInstance(HNewInstance* new_instance) OVERRIDE {
+    // Any reference appearing in ref_info_array_ so far cannot alias with new_instance.
+    CreateReferenceInfoForReferenceType(new_instance);
+  }
+
+  void VisitNewArray(HNewArray* new_array) OVERRIDE {
+    CreateReferenceInfoForReferenceType(new_array);
+  }
+
+  void VisitInvokeStaticOrDirect(HInvokeStaticOrDirect* invoke) OVERRIDE {
+    CreateReferenceInfoForReferenceType(invoke);
+  }
+
+  void VisitInvokeVirtual(HInvokeVirtual* invoke) OVERRIDE {
+    CreateReferenceInfoForReferenceType(invoke);
+  }
+
+  void VisitInvokeInterface(HInvokeInterface* invoke) OVERRIDE {
+    CreateReferenceInfoForReferenceType(invoke);
+  }
+
+  void VisitInvokeUnresolved(HInvokeUnresolved* invoke) OVERRIDE {
+    CreateReferenceInfoForReferenceType(invoke);
+  }
+
+  void VisitParameterValue(HParameterValue* instruction) OVERRIDE {
+    CreateReferenceInfoForReferenceType(instruction);
+  }
+
+  void VisitDeoptimize(HDeoptimize* instruction ATTRIBUTE_UNUSED) OVERRIDE {
+    may_deoptimize_ = true;
+  }
+
+  // All references used for heap accesses.
+  ArenaVector<ReferenceInfo*> ref_info_array_;
+  // All heap locations.
+  ArenaVector<HeapLocation*> heap_locations_;
+  // Aliasing info between each pair of heap locations.
+  ArenaBitVector aliasing_matrix_;
+  bool has_heap_stores_;
+  bool may_deoptimize_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapLocationCollector);
+};
+
+// An unknown heap value. Loads with such a value in the heap location cannot
+// be eliminated. A heap location is set to kUnknownHeapValue initially, and
+// when its value is killed due to aliasing, merging, invocations or loop side
+// effects.
+static HInstruction* const kUnknownHeapValue =
+    reinterpret_cast<HInstruction*>(static_cast<uintptr_t>(-1));
+
+// Default heap value of the fields of an allocation, right after it.
+static HInstruction* const kDefaultHeapValue =
+    reinterpret_cast<HInstruction*>(static_cast<uintptr_t>(-2));
+
+class LSEVisitor : public HGraphVisitor {
+ public:
+  LSEVisitor(HGraph* graph,
+             const HeapLocationCollector& heap_locations_collector,
+             const SideEffectsAnalysis& side_effects,
+             bool can_remove_stores_and_allocations)
+      : HGraphVisitor(graph),
+        heap_location_collector_(heap_locations_collector),
+        side_effects_(side_effects),
+        can_remove_stores_and_allocations_(can_remove_stores_and_allocations),
+        heap_values_for_(graph->GetBlocks().size(),
+                         ArenaVector<HInstruction*>(heap_locations_collector.
+                                                    GetNumberOfHeapLocations(),
+                                                    kUnknownHeapValue,
+                                                    graph->GetArena()->Adapter(kArenaAllocLSE)),
+                         graph->GetArena()->Adapter(kArenaAllocLSE)),
+        removed_loads_(graph->GetArena()->Adapter(kArenaAllocLSE)),
+        substitute_instructions_for_loads_(graph->GetArena()->Adapter(kArenaAllocLSE)),
+        possibly_removed_stores_(graph->GetArena()->Adapter(kArenaAllocLSE)),
+        singleton_new_instances_(graph->GetArena()->Adapter(kArenaAllocLSE)) {}
+
+  void VisitBasicBlock(HBasicBlock* block) OVERRIDE {
+    if (block->IsLoopHeader()) {
+      HandleLoopSideEffects(block);
+    } else {
+      MergePredecessorValues(block);
+    }
+    HGraphVisitor::VisitBasicBlock(block);
+  }
+
+  // Remove the instructions found redundant.
+  void RemoveInstructions() {
+    size_t size = removed_loads_.size();
+    DCHECK_EQ(size, substitute_instructions_for_loads_.size());
+    for (size_t i = 0; i < size; i++) {
+      HInstruction* load = removed_loads_[i];
+      DCHECK(load->IsInstanceFieldGet() || load->IsStaticFieldGet() || load->IsArrayGet());
+      // The substitute may itself be a removed load. Follow the chain until
+      // an instruction that stays.
+      HInstruction* substitute = substitute_instructions_for_loads_[i];
+      HInstruction* sub_sub = FindSubstitute(substitute);
+      while (sub_sub != substitute) {
+        substitute = sub_sub;
+        sub_sub = FindSubstitute(substitute);
+      }
+      load->ReplaceWith(substitute);
+      load->GetBlock()->RemoveInstruction(load);
+    }
+
+    // The stores still in possibly_removed_stores_ are not needed by any load.
+    for (HInstruction* store : possibly_removed_stores_) {
+      DCHECK(store->IsInstanceFieldSet() || store->IsStaticFieldSet() || store->IsArraySet());
+      store->GetBlock()->RemoveInstruction(store);
+    }
+
+    // A non-escaping allocation with no use left other than environments is
+    // now dead.
+    for (HNewInstance* new_instance : singleton_new_instances_) {
+      if (!new_instance->HasNonEnvironmentUses()) {
+        new_instance->RemoveEnvironmentUsers();
+        new_instance->GetBlock()->RemoveInstruction(new_instance);
+      }
+    }
+  }
+
+ private:
+  // If `heap_value` is a store that was thought redundant, keep it. This is
+  // needed when a heap value is killed by merging or by loop side effects
+  // (which is essentially merging also), since a later load from the location
+  // won't be eliminated.
+  void KeepIfIsStore(HInstruction* heap_value) {
+    if (heap_value == kDefaultHeapValue ||
+        heap_value == kUnknownHeapValue ||
+        !heap_value->IsInstanceFieldSet()) {
+      return;
+    }
+    auto it = std::find(
+        possibly_removed_stores_.begin(), possibly_removed_stores_.end(), heap_value);
+    if (it != possibly_removed_stores_.end()) {
+      possibly_removed_stores_.erase(it);
+    }
+  }
+
+  void HandleLoopSideEffects(HBasicBlock* block) {
+    DCHECK(block->IsLoopHeader());
+    ArenaVector<HInstruction*>& heap_values = heap_values_for_[block->GetBlockId()];
+    HBasicBlock* pre_header = block->GetLoopInformation()->GetPreHeader();
+    ArenaVector<HInstruction*>& pre_header_heap_values =
+        heap_values_for_[pre_header->GetBlockId()];
+
+    // We do a single pass in reverse post order, so the values at the back
+    // edges are not known yet. Inherit the values of the pre-header, and use
+    // the side effects of the loop to kill those it may change.
+    heap_values = pre_header_heap_values;
+    if (side_effects_.GetLoopEffects(block).DoesAnyWrite()) {
+      for (size_t i = 0; i < heap_values.size(); i++) {
+        HeapLocation* location = heap_location_collector_.GetHeapLocation(i);
+        if (!location->GetReferenceInfo()->IsSingleton() ||
+            location->IsValueKilledByLoopSideEffects()) {
+          KeepIfIsStore(pre_header_heap_values[i]);
+          heap_values[i] = kUnknownHeapValue;
+        }
+        // Otherwise the location is a field of a singleton that is not stored
+        // into inside the loop, so it is invariant throughout the loop.
+      }
+    }
+  }
+
+  void MergePredecessorValues(HBasicBlock* block) {
+    const ArenaVector<HBasicBlock*>& predecessors = block->GetPredecessors();
+    if (predecessors.empty()) {
+      return;
+    }
+    ArenaVector<HInstruction*>& heap_values = heap_values_for_[block->GetBlockId()];
+    if (block->IsCatchBlock()) {
+      // The heap is in the state of the throwing instruction, which is not the
+      // state at the end of the predecessors. Leave all values unknown.
+      return;
+    }
+    for (size_t i = 0; i < heap_values.size(); i++) {
+      HInstruction* pred0_value = heap_values_for_[predecessors[0]->GetBlockId()][i];
+      heap_values[i] = pred0_value;
+      if (pred0_value != kUnknownHeapValue) {
+        for (size_t j = 1; j < predecessors.size(); j++) {
+          HInstruction* pred_value = heap_values_for_[predecessors[j]->GetBlockId()][i];
+          if (pred_value != pred0_value) {
+            heap_values[i] = kUnknownHeapValue;
+            break;
+          }
+        }
+      }
+
+      if (heap_values[i] == kUnknownHeapValue) {
+        // Keep the last store in each predecessor since future loads cannot
+        // be eliminated.
+        for (HBasicBlock* predecessor : predecessors) {
+          KeepIfIsStore(heap_values_for_[predecessor->GetBlockId()][i]);
+        }
+      }
+    }
+  }
+
+  // `instruction` is being removed. Remove its null check too if it is the
+  // only reason for it, which happens when the value loaded is known from
+  // stores on every path but not from a store in a dominator, e.g.:
+  //   int[] a = foo();
+  //   if (...) { a[0] = 2; } else { a[0] = 2; }
+  //   // a[0] is 2 here, and its null check can be removed.
+  void TryRemovingNullCheck(HInstruction* instruction) {
+    HInstruction* prev = instruction->GetPrevious();
+    if ((prev != nullptr) && prev->IsNullCheck() && (prev == instruction->InputAt(0))) {
+      prev->ReplaceWith(prev->InputAt(0));
+      prev->GetBlock()->RemoveInstruction(prev);
+    }
+  }
+
+  HInstruction* GetDefaultValue(Primitive::Type type) {
+    switch (type) {
+      case Primitive::kPrimNot:
+        return GetGraph()->GetNullConstant();
+      case Primitive::kPrimBoolean:
+      case Primitive::kPrimByte:
+      case Primitive::kPrimChar:
+      case Primitive::kPrimShort:
+      case Primitive::kPrimInt:
+        return GetGraph()->GetIntConstant(0);
+      case Primitive::kPrimLong:
+        return GetGraph()->GetLongConstant(0);
+      case Primitive::kPrimFloat:
+        return GetGraph()->GetFloatConstant(0);
+      case Primitive::kPrimDouble:
+        return GetGraph()->GetDoubleConstant(0);
+      default:
+        LOG(FATAL) << "Unexpected type " << type;
+        UNREACHABLE();
+    }
+  }
+
+  size_t FindHeapLocationIndexOf(HInstruction* ref, size_t offset, HInstruction* index) const {
+    ReferenceInfo* ref_info =
+        heap_location_collector_.FindReferenceInfoOf(HuntForOriginalReference(ref));
+    size_t idx = heap_location_collector_.FindHeapLocationIndex(ref_info, offset, index);
+    DCHECK_NE(idx, HeapLocationCollector::kHeapLocationNotFound);
+    return idx;
+  }
+
+  void VisitGetLocation(HInstruction* instruction,
+                        HInstruction* ref,
+                        size_t offset,
+                        HInstruction* index) {
+    size_t idx = FindHeapLocationIndexOf(ref, offset, index);
+    ArenaVector<HInstruction*>& heap_values =
+        heap_values_for_[instruction->GetBlock()->GetBlockId()];
+    HInstruction* heap_value = heap_values[idx];
+    if (heap_value == kDefaultHeapValue) {
+      HInstruction* constant = GetDefaultValue(instruction->GetType());
+      removed_loads_.push_back(instruction);
+      substitute_instructions_for_loads_.push_back(constant);
+      heap_values[idx] = constant;
+      return;
+    }
+    if (heap_value != kUnknownHeapValue && heap_value->IsInstanceFieldSet()) {
+      // The location holds a store that may be removed, which can only happen
+      // for a singleton. Its value is the value stored, and the store is not
+      // needed for this load.
+      DCHECK(heap_location_collector_.GetHeapLocation(idx)->GetReferenceInfo()->IsSingleton());
+      heap_value = heap_value->InputAt(1);
+    }
+    if (heap_value == kUnknownHeapValue) {
+      // The load isn't eliminated, but later loads of the location can use it.
+      // This acts like GVN, with a better aliasing analysis.
+      heap_values[idx] = instruction;
+    } else if (HPhi::ToPhiType(heap_value->GetType()) !=
+               HPhi::ToPhiType(instruction->GetType())) {
+      // A location can be accessed with different types, e.g. through an
+      // array get on an array that can only be null. Stay properly typed by
+      // keeping the load.
+      heap_values[idx] = instruction;
+    } else {
+      removed_loads_.push_back(instruction);
+      substitute_instructions_for_loads_.push_back(heap_value);
+      TryRemovingNullCheck(instruction);
+    }
+  }
+
+  bool Equal(HInstruction* heap_value, HInstruction* value) {
+    if (heap_value == value) {
+      return true;
+    }
+    if (heap_value == kDefaultHeapValue && GetDefaultValue(value->GetType()) == value) {
+      return true;
+    }
+    return false;
+  }
+
+  void VisitSetLocation(HInstruction* instruction,
+                        HInstruction* ref,
+                        size_t offset,
+                        HInstruction* index,
+                        HInstruction* value) {
+    size_t idx = FindHeapLocationIndexOf(ref, offset, index);
+    ReferenceInfo* ref_info = heap_location_collector_.GetHeapLocation(idx)->GetReferenceInfo();
+    ArenaVector<HInstruction*>& heap_values =
+        heap_values_for_[instruction->GetBlock()->GetBlockId()];
+    HInstruction* heap_value = heap_values[idx];
+    bool same_value = false;
+    bool possibly_redundant = false;
+    if (Equal(heap_value, value)) {
+      // Store of the value the location already has.
+      same_value = true;
+    } else if (index != nullptr) {
+      // Stores into array elements are kept, they easily alias with accesses
+      // through non-constant indices.
+    } else if (ref_info->IsSingletonAndNotReturned() && can_remove_stores_and_allocations_) {
+      // Store into a field of a singleton that's not returned. The value
+      // cannot be killed by aliasing or invocations, so later loads can use
+      // the value directly and the store may be redundant. The value can still
+      // be killed by merging or loop side effects, in which case the store is
+      // taken out of possibly_removed_stores_.
+      possibly_redundant = true;
+      HNewInstance* new_instance = ref_info->GetReference()->AsNewInstance();
+      DCHECK(new_instance != nullptr);
+      if (new_instance->IsFinalizable()) {
+        // The finalizer can read the field.
+        possibly_redundant = false;
+      } else {
+        HLoopInformation* loop_info = instruction->GetBlock()->GetLoopInformation();
+        if (loop_info != nullptr && !loop_info->Contains(*new_instance->GetBlock())) {
+          // The value may be needed at the loop header. A singleton created
+          // inside the loop does not exist at the header.
+          possibly_redundant = false;
+        }
+      }
+    }
+    if (same_value || possibly_redundant) {
+      possibly_removed_stores_.push_back(instruction);
+    }
+
+    if (!same_value) {
+      // If the store may be redundant, put the store itself as the heap value,
+      // so that a later load can find it and still use its value.
+      heap_values[idx] = possibly_redundant ? instruction : value;
+    }
+    // This store may kill values in other heap locations due to aliasing.
+    for (size_t i = 0; i < heap_values.size(); i++) {
+      if (i == idx ||
+          heap_values[i] == value ||  // The same value is kept even if the locations alias.
+          heap_values[i] == kUnknownHeapValue) {
+        continue;
+      }
+      if (heap_location_collector_.MayAlias(i, idx)) {
+        heap_values[i] = kUnknownHeapValue;
+      }
+    }
+  }
+
+  void VisitInstanceFieldGet(HInstanceFieldGet* instruction) OVERRIDE {
+    if (instruction->IsVolatile()) {
+      HandleSynchronization(instruction);
+      return;
+    }
+    VisitGetLocation(instruction,
+                     instruction->InputAt(0),
+                     instruction->GetFieldOffset().SizeValue(),
+                     nullptr);
+  }
+
+  void VisitInstanceFieldSet(HInstanceFieldSet* instruction) OVERRIDE {
+    if (instruction->IsVolatile()) {
+      HandleSynchronization(instruction);
+      return;
+    }
+    VisitSetLocation(instruction,
+                     instruction->InputAt(0),
+                     instruction->GetFieldOffset().SizeValue(),
+                     nullptr,
+                     instruction->InputAt(1));
+  }
+
+  void VisitStaticFieldGet(HStaticFieldGet* instruction) OVERRIDE {
+    if (instruction->IsVolatile()) {
+      HandleSynchronization(instruction);
+      return;
+    }
+    VisitGetLocation(instruction,
+                     instruction->InputAt(0),
+                     instruction->GetFieldOffset().SizeValue(),
+                     nullptr);
+  }
+
+  void VisitStaticFieldSet(HStaticFieldSet* instruction) OVERRIDE {
+    if (instruction->IsVolatile()) {
+      HandleSynchronization(instruction);
+      return;
+    }
+    VisitSetLocation(instruction,
+                     instruction->InputAt(0),
+                     instruction->GetFieldOffset().SizeValue(),
+                     nullptr,
+                     instruction->InputAt(1));
+  }
+
+  void VisitArrayGet(HArrayGet* instruction) OVERRIDE {
+    VisitGetLocation(instruction,
+                     instruction->InputAt(0),
+                     HeapLocation::kInvalidFieldOffset,
+                     instruction->InputAt(1));
+  }
+
+  void VisitArraySet(HArraySet* instruction) OVERRIDE {
+    VisitSetLocation(instruction,
+                     instruction->InputAt(0),
+                     HeapLocation::kInvalidFieldOffset,
+                     instruction->InputAt(1),
+                     instruction->InputAt(2));
+  }
+
+  // Kills the values of all the locations the code run by `instruction` can
+  // see, that is all but the locations of singletons.
+  void HandleInvoke(HInstruction* instruction) {
+    ArenaVector<HInstruction*>& heap_values =
+        heap_values_for_[instruction->GetBlock()->GetBlockId()];
+    for (size_t i = 0; i < heap_values.size(); i++) {
+      ReferenceInfo* ref_info = heap_location_collector_.GetHeapLocation(i)->GetReferenceInfo();
+      if (!ref_info->IsSingleton()) {
+        heap_values[i] = kUnknownHeapValue;
+      }
+    }
+  }
+
+  // A volatile access or a monitor operation synchronizes with other threads,
+  // which may have written any location they can see. Like an invocation, it
+  // kills the values of all the locations but those of singletons. Volatile
+  // accesses are neither eliminated nor tracked: a field is volatile for all
+  // its accesses, so no other access reads the value of its location.
+  void HandleSynchronization(HInstruction* instruction) {
+    HandleInvoke(instruction);
+  }
+
+  void VisitMonitorOperation(HMonitorOperation* monitor) OVERRIDE {
+    HandleSynchronization(monitor);
+  }
+
+  void VisitInvokeStaticOrDirect(HInvokeStaticOrDirect* invoke) OVERRIDE {
+    HandleInvoke(invoke);
+  }
+
+  void VisitInvokeVirtual(HInvokeVirtual* invoke) OVERRIDE {
+    HandleInvoke(invoke);
+  }
+
+  void VisitInvokeInterface(HInvokeInterface* invoke) OVERRIDE {
+    HandleInvoke(invoke);
+  }
+
+  void VisitInvokeUnresolved(HInvokeUnresolved* invoke) OVERRIDE {
+    HandleInvoke(invoke);
+  }
+
+  void VisitClinitCheck(HClinitCheck* clinit) OVERRIDE {
+    HandleInvoke(clinit);
+  }
+
+  void VisitVecArrayOperation(HVecArrayOperation* operation) OVERRIDE {
+    // The vector store is not tracked per element, so it is treated like a
+    // call. The array it writes is not a singleton since it is an input.
+    HandleInvoke(operation);
+  }
+
+  void VisitUnresolvedInstanceFieldGet(HUnresolvedInstanceFieldGet* instruction) OVERRIDE {
+    // Conservatively treat it as an invocation.
+    HandleInvoke(instruction);
+  }
+
+  void VisitUnresolvedInstanceFieldSet(HUnresolvedInstanceFieldSet* instruction) OVERRIDE {
+    // Conservatively treat it as an invocation.
+    HandleInvoke(instruction);
+  }
+
+  void VisitUnresolvedStaticFieldGet(HUnresolvedStaticFieldGet* instruction) OVERRIDE {
+    // Conservatively treat it as an invocation.
+    HandleInvoke(instruction);
+  }
+
+  void VisitUnresolvedStaticFieldSet(HUnresolvedStaticFieldSet* instruction) OVERRIDE {
+    // Conservatively treat it as an invocation.
+    HandleInvoke(instruction);
+  }
+
+  void VisitNewInstance(HNewInstance* new_instance) OVERRIDE {
+    if (new_instance->CanThrowOtherThanOOME()) {
+      // The allocation may run the static initializer of the class.
+      HandleInvoke(new_instance);
+    }
+    ReferenceInfo* ref_info = heap_location_collector_.FindReferenceInfoOf(new_instance);
+    if (ref_info == nullptr) {
+      // new_instance isn't used for field accesses. No need to process it.
+      return;
+    }
+    if (can_remove_stores_and_allocations_ &&
+        ref_info->IsSingletonAndNotReturned() &&
+        !new_instance->IsFinalizable() &&
+        !new_instance->CanThrowOtherThanOOME()) {
+      singleton_new_instances_.push_back(new_instance);
+    }
+    ArenaVector<HInstruction*>& heap_values =
+        heap_values_for_[new_instance->GetBlock()->GetBlockId()];
+    for (size_t i = 0; i < heap_values.size(); i++) {
+      HeapLocation* location = heap_location_collector_.GetHeapLocation(i);
+      if (location->GetReferenceInfo()->GetReference() == new_instance &&
+          location->GetOffset() >= mirror::kObjectHeaderSize) {
+        // Instance fields except the header fields are set to default heap values.
+        heap_values[i] = kDefaultHeapValue;
+      }
+    }
+  }
+
+  // Find an instruction's substitute if it should be removed.
+  // Return the same instruction if it should not be removed.
+  HInstruction* FindSubstitute(HInstruction* instruction) {
+    size_t size = removed_loads_.size();
+    for (size_t i = 0; i < size; i++) {
+      if (removed_loads_[i] == instruction) {
+        return substitute_instructions_for_loads_[i];
+      }
+    }
+    return instruction;
+  }
+
+  const HeapLocationCollector& heap_location_collector_;
+  const SideEffectsAnalysis& side_effects_;
+  // Whether stores into singletons and the singletons themselves may be
+  // removed, which is not the case when the values may be needed by the
+  // interpreter or a catch block.
+  const bool can_remove_stores_and_allocations_;
+
+  // One array of heap values for each block.
+  ArenaVector<ArenaVector<HInstruction*>> heap_values_for_;
+
+  // We record the instructions that should be eliminated but may be
+  // used by heap locations. They'll be removed in the end.
+  ArenaVector<HInstruction*> removed_loads_;
+  ArenaVector<HInstruction*> substitute_instructions_for_loads_;
+
+  // Stores in this list may be removed from the list later when it's
+  // found that the store cannot be eliminated.
+  ArenaVector<HInstruction*> possibly_removed_stores_;
+
+  ArenaVector<HNewInstance*> singleton_new_instances_;
+
+  DISALLOW_COPY_AND_ASSIGN(LSEVisitor);
+};
+
+void LoadStoreElimination::Run() {
+  if (graph_->IsDebuggable()) {
+    // The debugger may set heap values or trigger deoptimization of callers.
+    return;
+  }
+  HeapLocationCollector heap_location_collector(graph_);
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    heap_location_collector.VisitBasicBlock(it.Current());
+  }
+  if (heap_location_collector.GetNumberOfHeapLocations() > kMaxNumberOfHeapLocations) {
+    // Bail out if there are too many heap locations to deal with.
+    return;
+  }
+  if (!heap_location_collector.HasHeapStores()) {
+    // Without heap stores, this pass would act mostly as GVN on heap accesses.
+    return;
+  }
+  heap_location_collector.BuildAliasingMatrix();
+  // The interpreter, when deoptimizing, and catch blocks read the heap and the
+  // environments as the unoptimized code left them.
+  bool can_remove_stores_and_allocations =
+      !heap_location_collector.MayDeoptimize() && !graph_->HasTryCatch();
+  LSEVisitor lse_visitor(graph_,
+                         heap_location_collector,
+                         side_effects_,
+                         can_remove_stores_and_allocations);
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    lse_visitor.VisitBasicBlock(it.Current());
+  }
+  lse_visitor.RemoveInstructions();
+}
+
+}  // namespace art
@@ -0,0 +1,1115 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_optimization.h"
+
+#include "arch/x86/instruction_set_features_x86.h"
+#include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "base/stl_util.h"
+#include "driver/compiler_driver.h"
+#include "driver/compiler_options.h"
+#include "induction_var_analysis.h"
+
+namespace art {
+
+// Clones instructions of a loop. The inputs and environment values of a clone
+// are the values mapped to those of the original instruction, if any.
+class LoopCloner : public ValueObject {
+ public:
+  explicit LoopCloner(HGraph* graph)
+      : graph_(graph),
+        map_(std::less<HInstruction*>(),
+             graph->GetArena()->Adapter(kArenaAllocLoopOptimization)) {}
+
+  // Returns whether `instruction` can be cloned. Only instructions without
+  // side effects other than reading memory or storing primitive array
+  // elements can.
+  static bool CanClone(HInstruction* instruction);
+
+  // Makes `copy` stand for `original` in the instructions cloned from now on.
+  void Map(HInstruction* original, HInstruction* copy) {
+    map_.Overwrite(original, copy);
+  }
+
+  HInstruction* Lookup(HInstruction* original) const {
+    auto it = map_.find(original);
+    return (it != map_.end()) ? it->second : original;
+  }
+
+  // Adds a clone of `instruction` at the end of `block` and maps
+  // `instruction` to it.
+  HInstruction* Clone(HInstruction* instruction, HBasicBlock* block);
+
+  // Replaces the mapped values in all the levels of `environment`.
+  void RemapEnvironment(HEnvironment* environment) const;
+
+ private:
+  HInstruction* Create(HInstruction* instruction) const;
+
+  HGraph* const graph_;
+  ArenaSafeMap<HInstruction*, HInstruction*> map_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopCloner);
+};
+
+bool LoopCloner::CanClone(HInstruction* instruction) {
+  if (instruction->IsCondition()) {
+    return true;
+  }
+  switch (instruction->GetKind()) {
+    case HInstruction::kAdd:
+    case HInstruction::kSub:
+    case HInstruction::kMul:
+    case HInstruction::kDiv:
+    case HInstruction::kRem:
+    case HInstruction::kAnd:
+    case HInstruction::kOr:
+    case HInstruction::kXor:
+    case HInstruction::kShl:
+    case HInstruction::kShr:
+    case HInstruction::kUShr:
+    case HInstruction::kNeg:
+    case HInstruction::kNot:
+    case HInstruction::kBooleanNot:
+    case HInstruction::kSelect:
+    case HInstruction::kTypeConversion:
+    case HInstruction::kNullCheck:
+    case HInstruction::kBoundsCheck:
+    case HInstruction::kDivZeroCheck:
+    case HInstruction::kArrayLength:
+    case HInstruction::kArrayGet:
+      return true;
+    case HInstruction::kInstanceFieldGet:
+      return !instruction->AsInstanceFieldGet()->IsVolatile();
+    case HInstruction::kArraySet:
+      return instruction->AsArraySet()->GetValue()->GetType() != Primitive::kPrimNot;
+    default:
+      return false;
+  }
+}
+
+HInstruction* LoopCloner::Create(HInstruction* instruction) const {
+  ArenaAllocator* arena = graph_->GetArena();
+  Primitive::Type type = instruction->GetType();
+  uint32_t dex_pc = instruction->GetDexPc();
+  HInstruction* first = Lookup(instruction->InputAt(0));
+  HInstruction* second =
+      (instruction->InputCount() > 1) ? Lookup(instruction->InputAt(1)) : nullptr;
+
+  if (instruction->IsCondition()) {
+    HCondition* condition = nullptr;
+    switch (instruction->AsCondition()->GetCondition()) {
+      case kCondEQ: condition = new (arena) HEqual(first, second, dex_pc); break;
+      case kCondNE: condition = new (arena) HNotEqual(first, second, dex_pc); break;
+      case kCondLT: condition = new (arena) HLessThan(first, second, dex_pc); break;
+      case kCondLE: condition = new (arena) HLessThanOrEqual(first, second, dex_pc); break;
+      case kCondGT: condition = new (arena) HGreaterThan(first, second, dex_pc); break;
+      case kCondGE: condition = new (arena) HGreaterThanOrEqual(first, second, dex_pc); break;
+      case kCondB:  condition = new (arena) HBelow(first, second, dex_pc); break;
+      case kCondBE: condition = new (arena) HBelowOrEqual(first, second, dex_pc); break;
+      case kCondA:  condition = new (arena) HAbove(first, second, dex_pc); break;
+      case kCondAE: condition = new (arena) HAboveOrEqual(first, second, dex_pc); break;
+    }
+    condition->SetBias(instruction->AsCondition()->GetBias());
+    return condition;
+  }
+
+  switch (instruction->GetKind()) {
+    case HInstruction::kAdd: return new (arena) HAdd(type, first, second, dex_pc);
+    case HInstruction::kSub: return new (arena) HSub(type, first, second, dex_pc);
+    case HInstruction::kMul: return new (arena) HMul(type, first, second, dex_pc);
+    case HInstruction::kDiv: return new (arena) HDiv(type, first, second, dex_pc);
+    case HInstruction::kRem: return new (arena) HRem(type, first, second, dex_pc);
+    case HInstruction::kAnd: return new (arena) HAnd(type, first, second, dex_pc);
+    case HInstruction::kOr: return new (arena) HOr(type, first, second, dex_pc);
+    case HInstruction::kXor: return new (arena) HXor(type, first, second, dex_pc);
+    case HInstruction::kShl: return new (arena) HShl(type, first, second, dex_pc);
+    case HInstruction::kShr: return new (arena) HShr(type, first, second, dex_pc);
+    case HInstruction::kUShr: return new (arena) HUShr(type, first, second, dex_pc);
+    case HInstruction::kNeg: return new (arena) HNeg(type, first, dex_pc);
+    case HInstruction::kNot: return new (arena) HNot(type, first, dex_pc);
+    case HInstruction::kBooleanNot: return new (arena) HBooleanNot(first, dex_pc);
+    case HInstruction::kSelect:
+      return new (arena) HSelect(Lookup(instruction->AsSelect()->GetCondition()),
+                                 second,
+                                 first,
+                                 dex_pc);
+    case HInstruction::kTypeConversion: return new (arena) HTypeConversion(type, first, dex_pc);
+    case HInstruction::kNullCheck: return new (arena) HNullCheck(first, dex_pc);
+    case HInstruction::kBoundsCheck: return new (arena) HBoundsCheck(first, second, dex_pc);
+    case HInstruction::kDivZeroCheck: return new (arena) HDivZeroCheck(first, dex_pc);
+    case HInstruction::kArrayLength: return new (arena) HArrayLength(first, dex_pc);
+    case HInstruction::kArrayGet: return new (arena) HArrayGet(first, second, type, dex_pc);
+    case HInstruction::kArraySet: {
+      HArraySet* array_set = instruction->AsArraySet();
+      return new (arena) HArraySet(first,
+                                   second,
+                                   Lookup(array_set->GetValue()),
+                                   array_set->GetComponentType(),
+                                   dex_pc);
+    }
+    case HInstruction::kInstanceFieldGet: {
+      const FieldInfo& field_info = instruction->AsInstanceFieldGet()->GetFieldInfo();
+      return new (arena) HInstanceFieldGet(first,
+                                           field_info.GetFieldType(),
+                                           field_info.GetFieldOffset(),
+                                           field_info.IsVolatile(),
+                                           field_info.GetFieldIndex(),
+                                           field_info.GetDexFile(),
+                                           field_info.GetDexCache(),
+                                           dex_pc);
+    }
+    default:
+      LOG(FATAL) << "Unexpected instruction " << instruction->DebugName();
+      UNREACHABLE();
+  }
+}
+
+HInstruction* LoopCloner::Clone(HInstruction* instruction, HBasicBlock* block) {
+  DCHECK(CanClone(instruction));
+  HInstruction* copy = Create(instruction);
+  block->AddInstruction(copy);
+  if (instruction->HasEnvironment()) {
+    copy->CopyEnvironmentFrom(instruction->GetEnvironment());
+    RemapEnvironment(copy->GetEnvironment());
+  }
+  if (copy->GetType() == Primitive::kPrimNot &&
+      instruction->GetReferenceTypeInfo().IsValid()) {
+    copy->SetReferenceTypeInfo(instruction->GetReferenceTypeInfo());
+  }
+  Map(instruction, copy);
+  return copy;
+}
+
+void LoopCloner::RemapEnvironment(HEnvironment* environment) const {
+  for (HEnvironment* current = environment; current != nullptr; current = current->GetParent()) {
+    for (size_t i = 0, e = current->Size(); i < e; ++i) {
+      HInstruction* value = current->GetInstructionAt(i);
+      if (value == nullptr) {
+        continue;
+      }
+      HInstruction* replacement = Lookup(value);
+      if (replacement != value) {
+        current->RemoveAsUserOfInput(i);
+        current->SetRawEnvAt(i, replacement);
+        replacement->AddEnvUseAt(current, i);
+      }
+    }
+  }
+}
+
+// Replaces the uses of `value`, defined in the header of `loop`, that are
+// outside of the loop by a phi at its `exit` merging `value` with the
+// `peeled_value` computed by the peeled iteration. The first predecessor of
+// `exit` comes from the loop, and the second one from the peeled iteration.
+static void MergeAtLoopExit(HLoopInformation* loop,
+                            HInstruction* value,
+                            HInstruction* peeled_value,
+                            HBasicBlock* exit) {
+  ArenaAllocator* arena = exit->GetGraph()->GetArena();
+  ArenaVector<std::pair<HInstruction*, size_t>> uses(
+      arena->Adapter(kArenaAllocLoopOptimization));
+  for (HUseIterator<HInstruction*> it(value->GetUses()); !it.Done(); it.Advance()) {
+    HUseListNode<HInstruction*>* use = it.Current();
+    if (!loop->Contains(*use->GetUser()->GetBlock())) {
+      uses.push_back(std::make_pair(use->GetUser(), use->GetIndex()));
+    }
+  }
+  ArenaVector<std::pair<HEnvironment*, size_t>> env_uses(
+      arena->Adapter(kArenaAllocLoopOptimization));
+  for (HUseIterator<HEnvironment*> it(value->GetEnvUses()); !it.Done(); it.Advance()) {
+    HUseListNode<HEnvironment*>* use = it.Current();
+    if (!loop->Contains(*use->GetUser()->GetHolder()->GetBlock())) {
+      env_uses.push_back(std::make_pair(use->GetUser(), use->GetIndex()));
+    }
+  }
+  if (uses.empty() && env_uses.empty()) {
+    return;
+  }
+
+  HPhi* phi = new (arena) HPhi(arena, kNoRegNumber, 0, HPhi::ToPhiType(value->GetType()));
+  exit->AddPhi(phi);
+  phi->AddInput(value);
+  phi->AddInput(peeled_value);
+  if (value->GetType() == Primitive::kPrimNot) {
+    phi->SetCanBeNull(value->CanBeNull() || peeled_value->CanBeNull());
+    if (value->GetReferenceTypeInfo().IsValid()) {
+      phi->SetReferenceTypeInfo(value->GetReferenceTypeInfo());
+    }
+  }
+  for (const std::pair<HInstruction*, size_t>& use : uses) {
+    use.first->ReplaceInput(phi, use.second);
+  }
+  for (const std::pair<HEnvironment*, size_t>& use : env_uses) {
+    use.first->RemoveAsUserOfInput(use.second);
+    use.first->SetRawEnvAt(use.second, phi);
+    phi->AddEnvUseAt(use.first, use.second);
+  }
+}
+
+static bool IsCommutative(VecOperationKind kind) {
+  switch (kind) {
+    case VecOperationKind::kAdd:
+    case VecOperationKind::kMul:
+    case VecOperationKind::kMin:
+    case VecOperationKind::kMax:
+    case VecOperationKind::kAnd:
+    case VecOperationKind::kOr:
+    case VecOperationKind::kXor:
+      return true;
+    case VecOperationKind::kSub:
+    case VecOperationKind::kDiv:
+      return false;
+  }
+  LOG(FATAL) << "Unreachable";
+  UNREACHABLE();
+}
+
+// Sets the kind and the operands of `operation` if it is one the vector
+// instructions can compute.
+static bool MatchOperation(HInstruction* operation,
+                           VecOperationKind* kind,
+                           HInstruction** first,
+                           HInstruction** second) {
+  if (operation->IsAdd()) {
+    *kind = VecOperationKind::kAdd;
+  } else if (operation->IsSub()) {
+    *kind = VecOperationKind::kSub;
+  } else if (operation->IsMul()) {
+    *kind = VecOperationKind::kMul;
+  } else if (operation->IsDiv()) {
+    *kind = VecOperationKind::kDiv;
+  } else if (operation->IsAnd()) {
+    *kind = VecOperationKind::kAnd;
+  } else if (operation->IsOr()) {
+    *kind = VecOperationKind::kOr;
+  } else if (operation->IsXor()) {
+    *kind = VecOperationKind::kXor;
+  } else if (operation->IsInvokeStaticOrDirect() &&
+             operation->AsInvoke()->GetIntrinsic() == Intrinsics::kMathMinIntInt) {
+    *kind = VecOperationKind::kMin;
+  } else if (operation->IsInvokeStaticOrDirect() &&
+             operation->AsInvoke()->GetIntrinsic() == Intrinsics::kMathMaxIntInt) {
+    *kind = VecOperationKind::kMax;
+  } else {
+    return false;
+  }
+  *first = operation->InputAt(0);
+  *second = operation->InputAt(1);
+  return true;
+}
+
+// Matches an operand of a statement of `packed_type`: either a load of an
+// array at the `induction`, whose array is returned, or a loop invariant
+// scalar, which is returned as is. Returns null otherwise.
+static HInstruction* MatchOperand(HLoopInformation* loop,
+                                  HPhi* induction,
+                                  HInstruction* operand,
+                                  Primitive::Type packed_type) {
+  bool is_narrow = Primitive::ComponentSize(packed_type) < 4;
+  if (operand->IsArrayGet()) {
+    HArrayGet* get = operand->AsArrayGet();
+    HInstruction* array = get->GetArray();
+    if (get->GetIndex() != induction ||
+        loop->Contains(*array->GetBlock()) ||
+        !get->GetUses().HasOnlyOneUse()) {
+      return nullptr;
+    }
+    // Narrow lanes only keep the low bits of the computation, which do not
+    // depend on the signedness of the loaded elements.
+    Primitive::Type type = get->GetType();
+    if (is_narrow
+            ? (type == Primitive::kPrimBoolean ||
+               Primitive::ComponentSize(type) != Primitive::ComponentSize(packed_type))
+            : type != packed_type) {
+      return nullptr;
+    }
+    return array;
+  }
+  if (loop->Contains(*operand->GetBlock())) {
+    return nullptr;
+  }
+  Primitive::Type type = operand->GetType();
+  if (is_narrow || packed_type == Primitive::kPrimInt) {
+    // The scalar is broadcast from the low bits of an int register.
+    return (Primitive::IsIntegralType(type) && type != Primitive::kPrimLong) ? operand : nullptr;
+  }
+  return (type == packed_type) ? operand : nullptr;
+}
+
+void HLoopOptimization::Run() {
+  if (graph_->IsDebuggable()) {
+    return;
+  }
+  InstructionSet instruction_set = graph_->GetInstructionSet();
+  bool can_vectorize =
+      (instruction_set == kArm64 || instruction_set == kX86 || instruction_set == kX86_64);
+  instruction_budget_ = driver_->GetCompilerOptions().GetLoopUnrollingMaxInstructions();
+
+  // Collect the loops first, vectorizing or unrolling a loop adds a new one.
+  ArenaVector<HLoopInformation*> loops(
+      graph_->GetArena()->Adapter(kArenaAllocLoopOptimization));
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    if (block->IsLoopHeader()) {
+      loops.push_back(block->GetLoopInformation());
+    }
+  }
+
+  for (HLoopInformation* loop : loops) {
+    if (can_vectorize && TryVectorize(loop)) {
+      MaybeRecordStat(kVectorizedLoop);
+    } else if (TryPeel(loop)) {
+      MaybeRecordStat(kPeeledLoop);
+    } else if (TryUnroll(loop)) {
+      MaybeRecordStat(kUnrolledLoop);
+    }
+  }
+}
+
+bool HLoopOptimization::IsUnitStrideInduction(HLoopInformation* loop, HPhi* phi) {
+  if (phi->InputCount() != 2) {
+    return false;
+  }
+  HInstruction* initial = phi->InputAt(0);
+  HInstruction* update = phi->InputAt(1);
+  if (!initial->IsIntConstant() ||
+      initial->AsIntConstant()->GetValue() != 0 ||
+      !update->IsAdd() ||
+      update->GetBlock() != loop->GetBackEdges()[0] ||
+      update->InputAt(0) != phi ||
+      !update->InputAt(1)->IsIntConstant() ||
+      update->InputAt(1)->AsIntConstant()->GetValue() != 1 ||
+      !update->GetUses().HasOnlyOneUse()) {
+    return false;
+  }
+  // The induction variable analysis must agree: a linear induction 1 * i + 0.
+  HInductionVarAnalysis::InductionInfo* info = induction_analysis_->LookupInfo(loop, phi);
+  int64_t stride = 0;
+  int64_t offset = 0;
+  return info != nullptr &&
+      info->induction_class == HInductionVarAnalysis::kLinear &&
+      HInductionVarAnalysis::IsIntAndGet(info->op_a, &stride) && stride == 1 &&
+      HInductionVarAnalysis::IsIntAndGet(info->op_b, &offset) && offset == 0;
+}
+
+bool HLoopOptimization::IsSupported(VecOperationKind kind,
+                                    Primitive::Type packed_type,
+                                    bool is_reduction) const {
+  InstructionSet instruction_set = graph_->GetInstructionSet();
+  const InstructionSetFeatures* features = driver_->GetInstructionSetFeatures();
+  // NEON multiplies lanes of all the integral types but longs, and has the
+  // minimum and maximum of ints. x86 needs SSE4.1 for those of ints.
+  bool is_arm64 = instruction_set == kArm64;
+  bool has_int_mul_min_max = is_arm64 ||
+      ((instruction_set == kX86_64)
+          ? features->AsX86_64InstructionSetFeatures()->HasSSE4_1()
+          : features->AsX86InstructionSetFeatures()->HasSSE4_1());
+  switch (packed_type) {
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      if (is_reduction) {
+        return false;
+      }
+      switch (kind) {
+        case VecOperationKind::kAdd:
+        case VecOperationKind::kSub:
+        case VecOperationKind::kAnd:
+        case VecOperationKind::kOr:
+        case VecOperationKind::kXor:
+          return true;
+        case VecOperationKind::kMul:
+          return is_arm64 || Primitive::ComponentSize(packed_type) == 2;
+        default:
+          return false;
+      }
+    case Primitive::kPrimInt:
+      switch (kind) {
+        case VecOperationKind::kAdd:
+        case VecOperationKind::kAnd:
+        case VecOperationKind::kOr:
+        case VecOperationKind::kXor:
+          return true;
+        case VecOperationKind::kSub:
+          return !is_reduction;
+        case VecOperationKind::kMul:
+          return !is_reduction && has_int_mul_min_max;
+        case VecOperationKind::kMin:
+        case VecOperationKind::kMax:
+          return has_int_mul_min_max;
+        default:
+          return false;
+      }
+    case Primitive::kPrimLong:
+      // x86 cannot move a long between a register pair and a vector register.
+      if (is_reduction && instruction_set == kX86) {
+        return false;
+      }
+      switch (kind) {
+        case VecOperationKind::kAdd:
+        case VecOperationKind::kAnd:
+        case VecOperationKind::kOr:
+        case VecOperationKind::kXor:
+          return true;
+        case VecOperationKind::kSub:
+          return !is_reduction;
+        default:
+          return false;
+      }
+    case Primitive::kPrimFloat:
+    case Primitive::kPrimDouble:
+      // Reassociating a floating point reduction would change its rounding.
+      if (is_reduction) {
+        return false;
+      }
+      switch (kind) {
+        case VecOperationKind::kAdd:
+        case VecOperationKind::kSub:
+        case VecOperationKind::kMul:
+        case VecOperationKind::kDiv:
+          return true;
+        default:
+          return false;
+      }
+    default:
+      return false;
+  }
+}
+
+size_t HLoopOptimization::MatchStatement(HLoopInformation* loop,
+                                         HPhi* induction,
+                                         HPhi* reduction,
+                                         HInstruction* root,
+                                         VectorStatement* statement) const {
+  VecOperationKind kind;
+  HInstruction* first;
+  HInstruction* second;
+
+  if (reduction != nullptr) {
+    // r = r op b[i], where the update is only used by the phi.
+    Primitive::Type type = reduction->GetType();
+    if (root->GetType() != type ||
+        !root->GetUses().HasOnlyOneUse() ||
+        !MatchOperation(root, &kind, &first, &second)) {
+      return 0;
+    }
+    if (second == reduction && IsCommutative(kind)) {
+      std::swap(first, second);
+    }
+    HInstruction* array = MatchOperand(loop, induction, second, type);
+    if (first != reduction ||
+        array == nullptr ||
+        array->GetType() != Primitive::kPrimNot ||
+        !IsSupported(kind, type, /* is_reduction */ true)) {
+      return 0;
+    }
+    *statement = { kind, type, nullptr, reduction, array, root };
+    return 2;
+  }
+
+  // a[i] = b[i] op c[i], or a[i] = b[i] op x.
+  HArraySet* array_set = root->AsArraySet();
+  Primitive::Type type = array_set->GetComponentType();
+  if (array_set->GetIndex() != induction ||
+      loop->Contains(*array_set->GetArray()->GetBlock()) ||
+      type == Primitive::kPrimNot ||
+      type == Primitive::kPrimBoolean) {
+    return 0;
+  }
+  size_t size = 1;
+  HInstruction* value = array_set->GetValue();
+  if (Primitive::ComponentSize(type) < 4) {
+    // Narrow values are computed as ints and converted before being stored,
+    // which the lanes of the vector do implicitly.
+    if (!value->IsTypeConversion() ||
+        value->GetBlock() != root->GetBlock() ||
+        Primitive::ComponentSize(value->GetType()) != Primitive::ComponentSize(type) ||
+        value->AsTypeConversion()->GetInputType() != Primitive::kPrimInt ||
+        !value->GetUses().HasOnlyOneUse()) {
+      return 0;
+    }
+    value = value->InputAt(0);
+    ++size;
+  } else if (value->GetType() != type) {
+    return 0;
+  }
+  if (value->GetBlock() != root->GetBlock() ||
+      !value->GetUses().HasOnlyOneUse() ||
+      !MatchOperation(value, &kind, &first, &second)) {
+    return 0;
+  }
+  ++size;
+
+  HInstruction* left = MatchOperand(loop, induction, first, type);
+  HInstruction* right = MatchOperand(loop, induction, second, type);
+  if (left == nullptr || right == nullptr) {
+    return 0;
+  }
+  if (left->GetType() != Primitive::kPrimNot) {
+    // The left operand must be loaded, swap a loop invariant one if allowed.
+    if (right->GetType() != Primitive::kPrimNot || !IsCommutative(kind)) {
+      return 0;
+    }
+    std::swap(left, right);
+  }
+  bool is_right_an_array = right->GetType() == Primitive::kPrimNot;
+  if (!IsSupported(kind, type, /* is_reduction */ false) ||
+      // x86 cannot broadcast a long held in a register pair.
+      (type == Primitive::kPrimLong && !is_right_an_array &&
+       graph_->GetInstructionSet() == kX86)) {
+    return 0;
+  }
+  *statement = { kind, type, array_set->GetArray(), left, right, root };
+  return size + (is_right_an_array ? 2 : 1);
+}
+
+HPhi* HLoopOptimization::MatchCountedLoop(HLoopInformation* loop,
+                                          HInstruction** trip_count) {
+  HBasicBlock* header = loop->GetHeader();
+  if (loop->NumberOfBackEdges() != 1 ||
+      !loop->HasSuspendCheck() ||
+      header->IsTryBlock() ||
+      loop->GetPreHeader()->EndsWithTryBoundary()) {
+    return nullptr;
+  }
+
+  // Only handle a loop made of its header and a single body block, which is
+  // then an innermost loop.
+  HBasicBlock* body = loop->GetBackEdges()[0];
+  if (body == header || loop->GetBlocks().NumSetBits() != 2) {
+    return nullptr;
+  }
+
+  // The header only evaluates `i < n`, or `i >= n` exiting the loop.
+  HInstruction* last = header->GetLastInstruction();
+  if (!last->IsIf()) {
+    return nullptr;
+  }
+  HIf* if_instruction = last->AsIf();
+  HInstruction* condition = if_instruction->InputAt(0);
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction != loop->GetSuspendCheck() &&
+        instruction != condition &&
+        instruction != if_instruction) {
+      return nullptr;
+    }
+  }
+  if (condition->IsLessThan()) {
+    if (if_instruction->IfTrueSuccessor() != body) {
+      return nullptr;
+    }
+  } else if (condition->IsGreaterThanOrEqual()) {
+    if (if_instruction->IfFalseSuccessor() != body) {
+      return nullptr;
+    }
+  } else {
+    return nullptr;
+  }
+  HInstruction* induction = condition->InputAt(0);
+  *trip_count = condition->InputAt(1);
+  if (!induction->IsPhi() ||
+      induction->GetBlock() != header ||
+      induction->GetType() != Primitive::kPrimInt ||
+      (*trip_count)->GetType() != Primitive::kPrimInt ||
+      loop->Contains(*(*trip_count)->GetBlock())) {
+    return nullptr;
+  }
+  HPhi* phi = induction->AsPhi();
+  return IsUnitStrideInduction(loop, phi) ? phi : nullptr;
+}
+
+bool HLoopOptimization::TryVectorize(HLoopInformation* loop) {
+  HInstruction* trip_count = nullptr;
+  HPhi* phi = MatchCountedLoop(loop, &trip_count);
+  if (phi == nullptr) {
+    return false;
+  }
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* body = loop->GetBackEdges()[0];
+
+  // Any other phi must be a reduction, only used in the loop by its update.
+  ArenaAllocator* arena = graph_->GetArena();
+  ArenaVector<HPhi*> reductions(arena->Adapter(kArenaAllocLoopOptimization));
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* other = it.Current()->AsPhi();
+    if (other == phi) {
+      continue;
+    }
+    if (other->InputCount() != 2 || other->InputAt(1)->GetBlock() != body) {
+      return false;
+    }
+    for (HUseIterator<HInstruction*> use_it(other->GetUses()); !use_it.Done(); use_it.Advance()) {
+      HInstruction* user = use_it.Current()->GetUser();
+      if (loop->Contains(*user->GetBlock()) && user != other->InputAt(1)) {
+        return false;
+      }
+    }
+    reductions.push_back(other);
+  }
+
+  // Every instruction of the body must belong to a statement, the induction
+  // update, or be the final goto.
+  ArenaVector<VectorStatement> statements(arena->Adapter(kArenaAllocLoopOptimization));
+  size_t matched_instructions = 2;
+  size_t body_instructions = 0;
+  size_t pending_loads = 0;
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    ++body_instructions;
+    if (instruction->IsArrayGet()) {
+      ++pending_loads;
+      continue;
+    }
+    HPhi* reduction = nullptr;
+    for (HPhi* candidate : reductions) {
+      if (candidate->InputAt(1) == instruction) {
+        reduction = candidate;
+      }
+    }
+    if (reduction == nullptr && !instruction->IsArraySet()) {
+      continue;
+    }
+    VectorStatement statement;
+    size_t size = MatchStatement(loop, phi, reduction, instruction, &statement);
+    if (size == 0) {
+      return false;
+    }
+    // The vector instruction loads its operands where the statement stores
+    // its result, so no store may separate the loads from that point.
+    size_t loads = (statement.left->GetType() == Primitive::kPrimNot ? 1u : 0u) +
+                   (statement.right->GetType() == Primitive::kPrimNot ? 1u : 0u);
+    DCHECK_LE(loads, pending_loads);
+    pending_loads -= loads;
+    if (instruction->IsArraySet() && pending_loads != 0) {
+      return false;
+    }
+    if (!statements.empty() &&
+        Primitive::ComponentSize(statement.packed_type) !=
+            Primitive::ComponentSize(statements[0].packed_type)) {
+      return false;
+    }
+    matched_instructions += size;
+    statements.push_back(statement);
+  }
+  if (statements.empty() || matched_instructions != body_instructions) {
+    return false;
+  }
+
+  size_t vector_length =
+      kVectorSizeInBytes / Primitive::ComponentSize(statements[0].packed_type);
+  GenerateVectorLoop(loop, phi, trip_count, vector_length, statements);
+  return true;
+}
+
+void HLoopOptimization::GenerateVectorLoop(HLoopInformation* loop,
+                                           HPhi* phi,
+                                           HInstruction* trip_count,
+                                           size_t vector_length,
+                                           const ArenaVector<VectorStatement>& statements) {
+  ArenaAllocator* arena = graph_->GetArena();
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* pre_header = loop->GetPreHeader();
+  HSuspendCheck* scalar_suspend_check = loop->GetSuspendCheck();
+  uint32_t dex_pc = scalar_suspend_check->GetDexPc();
+
+  // The vector loop executes the first `trip_count & -vector_length`
+  // iterations, the scalar loop the remaining ones.
+  int32_t mask = -static_cast<int32_t>(vector_length);
+  HInstruction* vector_trip_count;
+  if (trip_count->IsIntConstant()) {
+    vector_trip_count = graph_->GetIntConstant(trip_count->AsIntConstant()->GetValue() & mask);
+  } else {
+    vector_trip_count =
+        new (arena) HAnd(Primitive::kPrimInt, trip_count, graph_->GetIntConstant(mask), dex_pc);
+    pre_header->InsertInstructionBefore(vector_trip_count, pre_header->GetLastInstruction());
+  }
+
+  HBasicBlock* vector_header = graph_->InsertEmptyLoopBefore(header);
+  HBasicBlock* vector_body = vector_header->GetSuccessors()[0];
+  HBasicBlock* vector_exit = vector_header->GetSuccessors()[1];
+  HLoopInformation* vector_loop = vector_header->GetLoopInformation();
+
+  // The phis of the vector loop. Their values at its exit are the initial
+  // values of the corresponding phis of the scalar loop.
+  HPhi* vector_phi = new (arena) HPhi(arena, kNoRegNumber, 0, Primitive::kPrimInt);
+  vector_header->AddPhi(vector_phi);
+  vector_phi->AddInput(phi->InputAt(0));
+  ArenaVector<HPhi*> vector_reductions(
+      statements.size(), nullptr, arena->Adapter(kArenaAllocLoopOptimization));
+  for (size_t i = 0; i < statements.size(); ++i) {
+    if (statements[i].array == nullptr) {
+      HInstruction* reduction = statements[i].left;
+      vector_reductions[i] =
+          new (arena) HPhi(arena, kNoRegNumber, 0, reduction->GetType());
+      vector_header->AddPhi(vector_reductions[i]);
+      vector_reductions[i]->AddInput(reduction->InputAt(0));
+    }
+  }
+
+  // At the suspend check of the vector loop, the phis of the scalar loop
+  // hold the values of the vector loop phis.
+  HSuspendCheck* suspend_check = new (arena) HSuspendCheck(dex_pc);
+  vector_header->AddInstruction(suspend_check);
+  suspend_check->CopyEnvironmentFrom(scalar_suspend_check->GetEnvironment());
+  HEnvironment* environment = suspend_check->GetEnvironment();
+  for (size_t i = 0, e = environment->Size(); i < e; ++i) {
+    HInstruction* value = environment->GetInstructionAt(i);
+    HInstruction* replacement = (value == phi) ? vector_phi : nullptr;
+    for (size_t j = 0; j < statements.size(); ++j) {
+      if (value != nullptr && value == statements[j].left && statements[j].array == nullptr) {
+        replacement = vector_reductions[j];
+      }
+    }
+    if (replacement != nullptr) {
+      environment->RemoveAsUserOfInput(i);
+      environment->SetRawEnvAt(i, replacement);
+      replacement->AddEnvUseAt(environment, i);
+    }
+  }
+  vector_loop->SetSuspendCheck(suspend_check);
+  HCondition* condition = new (arena) HLessThan(vector_phi, vector_trip_count, dex_pc);
+  vector_header->AddInstruction(condition);
+  vector_header->AddInstruction(new (arena) HIf(condition, dex_pc));
+
+  // The statements, in the order of the scalar loop.
+  for (size_t i = 0; i < statements.size(); ++i) {
+    const VectorStatement& statement = statements[i];
+    if (statement.array == nullptr) {
+      HVecReduce* reduce = new (arena) HVecReduce(
+          statement.kind, vector_reductions[i], statement.right, vector_phi, dex_pc);
+      vector_body->AddInstruction(reduce);
+      vector_reductions[i]->AddInput(reduce);
+      statement.left->ReplaceInput(vector_reductions[i], 0);
+    } else {
+      vector_body->AddInstruction(new (arena) HVecArrayOperation(statement.kind,
+                                                                 statement.packed_type,
+                                                                 statement.array,
+                                                                 vector_phi,
+                                                                 statement.left,
+                                                                 statement.right,
+                                                                 dex_pc));
+    }
+  }
+  HInstruction* vector_update = new (arena) HAdd(Primitive::kPrimInt,
+                                                 vector_phi,
+                                                 graph_->GetIntConstant(vector_length),
+                                                 dex_pc);
+  vector_body->AddInstruction(vector_update);
+  vector_body->AddInstruction(new (arena) HGoto(dex_pc));
+  vector_phi->AddInput(vector_update);
+  phi->ReplaceInput(vector_phi, 0);
+
+  vector_exit->AddInstruction(new (arena) HGoto(dex_pc));
+}
+
+bool HLoopOptimization::TryPeel(HLoopInformation* loop) {
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* pre_header = loop->GetPreHeader();
+  if (loop->NumberOfBackEdges() != 1 ||
+      !loop->HasSuspendCheck() ||
+      header->IsTryBlock() ||
+      !pre_header->GetLastInstruction()->IsGoto()) {
+    return false;
+  }
+  HBasicBlock* body = loop->GetBackEdges()[0];
+  if (body == header ||
+      loop->GetBlocks().NumSetBits() != 2 ||
+      !header->GetLastInstruction()->IsIf() ||
+      !body->GetLastInstruction()->IsGoto()) {
+    return false;
+  }
+  HSuspendCheck* suspend_check = loop->GetSuspendCheck();
+  HIf* if_instruction = header->GetLastInstruction()->AsIf();
+  bool is_body_true_successor = (if_instruction->IfTrueSuccessor() == body);
+  HBasicBlock* exit = is_body_true_successor
+      ? if_instruction->IfFalseSuccessor()
+      : if_instruction->IfTrueSuccessor();
+  if (exit->GetPredecessors().size() != 1 || !exit->GetPhis().IsEmpty()) {
+    return false;
+  }
+
+  // Every instruction but the control flow ones is cloned.
+  SideEffects loop_effects = SideEffects::None();
+  size_t size = 0;
+  for (HBasicBlock* block : { header, body }) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      loop_effects = loop_effects.Union(instruction->GetSideEffects());
+      if (instruction == suspend_check || instruction == if_instruction || instruction->IsGoto()) {
+        continue;
+      }
+      if (!LoopCloner::CanClone(instruction)) {
+        return false;
+      }
+      ++size;
+    }
+  }
+
+  // The instructions of the loop computing the same value in every iteration
+  // take the value computed by the peeled iteration. Only peel if one of them
+  // may throw, which prevents LICM from hoisting it.
+  ArenaAllocator* arena = graph_->GetArena();
+  ArenaVector<HInstruction*> invariants(arena->Adapter(kArenaAllocLoopOptimization));
+  bool has_throwing_invariant = false;
+  for (HBasicBlock* block : { header, body }) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (!instruction->CanBeMoved() ||
+          instruction->GetSideEffects().MayDependOn(loop_effects)) {
+        continue;
+      }
+      bool is_invariant = true;
+      for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
+        HInstruction* input = instruction->InputAt(i);
+        if (loop->Contains(*input->GetBlock()) && !ContainsElement(invariants, input)) {
+          is_invariant = false;
+          break;
+        }
+      }
+      if (is_invariant) {
+        invariants.push_back(instruction);
+        has_throwing_invariant |= instruction->CanThrow();
+      }
+    }
+  }
+  if (!has_throwing_invariant || size > instruction_budget_) {
+    return false;
+  }
+  instruction_budget_ -= size;
+
+  // The peeled iteration is made of a copy of the header, testing the
+  // condition on the initial values of the phis, and a copy of the body which
+  // becomes the pre-header of the loop. Both the peeled header and the header
+  // of the loop exit to `exit` through a new block, as `exit` gets phis.
+  HBasicBlock* peeled_header = new (arena) HBasicBlock(graph_, header->GetDexPc());
+  HBasicBlock* peeled_body = new (arena) HBasicBlock(graph_, body->GetDexPc());
+  HBasicBlock* peeled_exit = new (arena) HBasicBlock(graph_, exit->GetDexPc());
+  graph_->AddBlock(peeled_header);
+  graph_->AddBlock(peeled_body);
+  graph_->AddBlock(peeled_exit);
+  header->ReplacePredecessor(pre_header, peeled_body);
+  pre_header->AddSuccessor(peeled_header);
+  if (is_body_true_successor) {
+    peeled_header->AddSuccessor(peeled_body);
+    peeled_header->AddSuccessor(peeled_exit);
+  } else {
+    peeled_header->AddSuccessor(peeled_exit);
+    peeled_header->AddSuccessor(peeled_body);
+  }
+  HBasicBlock* loop_exit = graph_->SplitEdge(header, exit);
+  peeled_exit->AddSuccessor(exit);
+
+  LoopCloner cloner(graph_);
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    cloner.Map(it.Current(), it.Current()->InputAt(0));
+  }
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction != suspend_check && instruction != if_instruction) {
+      cloner.Clone(instruction, peeled_header);
+    }
+  }
+  peeled_header->AddInstruction(
+      new (arena) HIf(cloner.Lookup(if_instruction->InputAt(0)), if_instruction->GetDexPc()));
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (!instruction->IsGoto()) {
+      cloner.Clone(instruction, peeled_body);
+    }
+  }
+  peeled_body->AddInstruction(new (arena) HGoto(body->GetLastInstruction()->GetDexPc()));
+  peeled_exit->AddInstruction(new (arena) HGoto(exit->GetDexPc()));
+  loop_exit->AddInstruction(new (arena) HGoto(exit->GetDexPc()));
+
+  // The values of the header are used after the loop with the values they
+  // had when the loop exited, which may now be in the peeled iteration.
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    MergeAtLoopExit(loop, it.Current(), cloner.Lookup(it.Current()), exit);
+  }
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction != suspend_check && instruction != if_instruction) {
+      MergeAtLoopExit(loop, instruction, cloner.Lookup(instruction), exit);
+    }
+  }
+
+  // The loop now starts with the values of the phis after the peeled
+  // iteration. Compute them all first, a phi may be the back edge input of
+  // another one.
+  ArenaVector<HInstruction*> initial_values(arena->Adapter(kArenaAllocLoopOptimization));
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    initial_values.push_back(cloner.Lookup(it.Current()->InputAt(1)));
+  }
+  size_t phi_index = 0;
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    it.Current()->ReplaceInput(initial_values[phi_index++], 0);
+  }
+
+  graph_->UpdateLoopAndTryInformationOfNewBlock(
+      peeled_header, pre_header, /* replace_if_back_edge */ false);
+  graph_->UpdateLoopAndTryInformationOfNewBlock(
+      peeled_body, pre_header, /* replace_if_back_edge */ false);
+  graph_->UpdateLoopAndTryInformationOfNewBlock(
+      peeled_exit, exit, /* replace_if_back_edge */ false);
+  graph_->UpdateLoopAndTryInformationOfNewBlock(
+      loop_exit, exit, /* replace_if_back_edge */ false);
+  graph_->ClearDominanceInformation();
+  graph_->ComputeDominanceInformation();
+
+  // The peeled iteration dominates the loop.
+  for (HInstruction* instruction : invariants) {
+    instruction->ReplaceWith(cloner.Lookup(instruction));
+    instruction->GetBlock()->RemoveInstruction(instruction);
+  }
+  return true;
+}
+
+bool HLoopOptimization::TryUnroll(HLoopInformation* loop) {
+  HInstruction* trip_count = nullptr;
+  HPhi* phi = MatchCountedLoop(loop, &trip_count);
+  if (phi == nullptr) {
+    return false;
+  }
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* body = loop->GetBackEdges()[0];
+  HInstruction* condition = header->GetLastInstruction()->InputAt(0);
+  // The copies of the body cannot use the condition of the original loop.
+  if (!condition->HasOnlyOneNonEnvironmentUse() || !body->GetLastInstruction()->IsGoto()) {
+    return false;
+  }
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    if (it.Current()->InputAt(1)->GetBlock() == header && !it.Current()->InputAt(1)->IsPhi()) {
+      return false;
+    }
+  }
+  size_t size = 0;
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction->IsGoto()) {
+      continue;
+    }
+    if (!LoopCloner::CanClone(instruction)) {
+      return false;
+    }
+    ++size;
+  }
+
+  // Unroll by the largest factor the budget allows, and that does not exceed
+  // a constant trip count.
+  size_t factor = kMaxUnrollingFactor;
+  for (; factor > 1; factor /= 2) {
+    if (factor * size <= instruction_budget_ &&
+        (!trip_count->IsIntConstant() ||
+         trip_count->AsIntConstant()->GetValue() >= static_cast<int32_t>(factor))) {
+      break;
+    }
+  }
+  if (factor == 1) {
+    return false;
+  }
+  instruction_budget_ -= factor * size;
+  GenerateUnrolledLoop(loop, phi, trip_count, factor);
+  return true;
+}
+
+void HLoopOptimization::GenerateUnrolledLoop(HLoopInformation* loop,
+                                             HPhi* phi,
+                                             HInstruction* trip_count,
+                                             size_t factor) {
+  ArenaAllocator* arena = graph_->GetArena();
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* body = loop->GetBackEdges()[0];
+  HBasicBlock* pre_header = loop->GetPreHeader();
+  HSuspendCheck* scalar_suspend_check = loop->GetSuspendCheck();
+  uint32_t dex_pc = scalar_suspend_check->GetDexPc();
+
+  // The unrolled loop executes the first `trip_count & -factor` iterations,
+  // the original loop the remaining ones.
+  int32_t mask = -static_cast<int32_t>(factor);
+  HInstruction* unrolled_trip_count;
+  if (trip_count->IsIntConstant()) {
+    unrolled_trip_count = graph_->GetIntConstant(trip_count->AsIntConstant()->GetValue() & mask);
+  } else {
+    unrolled_trip_count =
+        new (arena) HAnd(Primitive::kPrimInt, trip_count, graph_->GetIntConstant(mask), dex_pc);
+    pre_header->InsertInstructionBefore(unrolled_trip_count, pre_header->GetLastInstruction());
+  }
+
+  HBasicBlock* unrolled_header = graph_->InsertEmptyLoopBefore(header);
+  HBasicBlock* unrolled_body = unrolled_header->GetSuccessors()[0];
+  HBasicBlock* unrolled_exit = unrolled_header->GetSuccessors()[1];
+  HLoopInformation* unrolled_loop = unrolled_header->GetLoopInformation();
+
+  // Every phi of the loop has a copy in the unrolled loop, whose value at its
+  // exit is the initial value of the phi.
+  LoopCloner cloner(graph_);
+  ArenaVector<HPhi*> phis(arena->Adapter(kArenaAllocLoopOptimization));
+  ArenaVector<HPhi*> unrolled_phis(arena->Adapter(kArenaAllocLoopOptimization));
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* original = it.Current()->AsPhi();
+    HPhi* copy = new (arena) HPhi(arena, kNoRegNumber, 0, original->GetType());
+    unrolled_header->AddPhi(copy);
+    copy->AddInput(original->InputAt(0));
+    if (original->GetType() == Primitive::kPrimNot) {
+      copy->SetCanBeNull(original->CanBeNull());
+      if (original->GetReferenceTypeInfo().IsValid()) {
+        copy->SetReferenceTypeInfo(original->GetReferenceTypeInfo());
+      }
+    }
+    phis.push_back(original);
+    unrolled_phis.push_back(copy);
+    cloner.Map(original, copy);
+  }
+
+  HSuspendCheck* suspend_check = new (arena) HSuspendCheck(dex_pc);
+  unrolled_header->AddInstruction(suspend_check);
+  suspend_check->CopyEnvironmentFrom(scalar_suspend_check->GetEnvironment());
+  cloner.RemapEnvironment(suspend_check->GetEnvironment());
+  unrolled_loop->SetSuspendCheck(suspend_check);
+  HCondition* condition = new (arena) HLessThan(cloner.Lookup(phi), unrolled_trip_count, dex_pc);
+  unrolled_header->AddInstruction(condition);
+  unrolled_header->AddInstruction(new (arena) HIf(condition, dex_pc));
+
+  // Each copy of the body starts with the back edge values of the previous
+  // one. Compute them all first, a phi may be the back edge input of another
+  // one.
+  ArenaVector<HInstruction*> next_values(
+      phis.size(), nullptr, arena->Adapter(kArenaAllocLoopOptimization));
+  for (size_t copy = 0; copy < factor; ++copy) {
+    for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+      if (!it.Current()->IsGoto()) {
+        cloner.Clone(it.Current(), unrolled_body);
+      }
+    }
+    for (size_t i = 0; i < phis.size(); ++i) {
+      next_values[i] = cloner.Lookup(phis[i]->InputAt(1));
+    }
+    for (size_t i = 0; i < phis.size(); ++i) {
+      cloner.Map(phis[i], next_values[i]);
+    }
+  }
+  unrolled_body->AddInstruction(new (arena) HGoto(dex_pc));
+  for (size_t i = 0; i < phis.size(); ++i) {
+    unrolled_phis[i]->AddInput(cloner.Lookup(phis[i]));
+    phis[i]->ReplaceInput(unrolled_phis[i], 0);
+  }
+
+  unrolled_exit->AddInstruction(new (arena) HGoto(dex_pc));
+}
+
+}  // namespace art
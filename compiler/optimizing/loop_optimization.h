@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
+#define ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
+
+#include "base/arena_containers.h"
+#include "optimization.h"
+
+namespace art {
+
+class CompilerDriver;
+class HInductionVarAnalysis;
+
+/**
+ * Vectorizes innermost counted loops of the form
+ *
+ *   for (int i = 0; i < n; i++) {
+ *     a[i] = b[i] op c[i];  // or b[i] op x, with x loop invariant
+ *     r = r op d[i];        // reduction
+ *   }
+ *
+ * A vector loop processing kVectorSizeInBytes bytes of every array per
+ * iteration is inserted before the loop, which then only executes the
+ * remaining iterations. Only instruction sets whose code generators implement
+ * the vector instructions are handled.
+ *
+ * Other small innermost loops are peeled or unrolled, within the budget of
+ * CompilerOptions::GetLoopUnrollingMaxInstructions() for the whole method:
+ *  - The first iteration is peeled when the loop has invariant instructions
+ *    that may throw, which then take the values computed by the peeled
+ *    iteration instead of being evaluated again in the loop.
+ *  - A counted loop is unrolled by inserting before it a loop executing
+ *    several copies of its body per iteration, the original loop executing the
+ *    remaining iterations.
+ */
+class HLoopOptimization : public HOptimization {
+ public:
+  HLoopOptimization(HGraph* graph,
+                    HInductionVarAnalysis* induction_analysis,
+                    const CompilerDriver* driver,
+                    OptimizingCompilerStats* stats)
+      : HOptimization(graph, kLoopOptimizationPassName, stats),
+        induction_analysis_(induction_analysis),
+        driver_(driver),
+        instruction_budget_(0) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kLoopOptimizationPassName = "loop_optimization";
+
+ private:
+  // The number of copies of the body of an unrolled loop, halved until its
+  // instructions fit in the budget.
+  static constexpr size_t kMaxUnrollingFactor = 4;
+
+  // A statement of the loop body, computed by a single vector instruction.
+  struct VectorStatement {
+    VecOperationKind kind;
+    Primitive::Type packed_type;
+    // The array stored into, or null for a reduction.
+    HInstruction* array;
+    // The array loaded for the left operand, or the phi of a reduction.
+    HInstruction* left;
+    // The array loaded for the right operand, or a loop invariant scalar.
+    HInstruction* right;
+    // The instruction computing the statement in the loop: the array set,
+    // or the update of the reduction phi.
+    HInstruction* root;
+  };
+
+  // Returns the induction phi of `loop` if it is made of its header and a
+  // single body block, and counts from 0 to a loop invariant `trip_count`,
+  // the header only testing `i < n` or `i >= n`. Returns null otherwise.
+  HPhi* MatchCountedLoop(HLoopInformation* loop, HInstruction** trip_count);
+
+  bool TryVectorize(HLoopInformation* loop);
+  bool TryPeel(HLoopInformation* loop);
+  bool TryUnroll(HLoopInformation* loop);
+
+  // Returns whether `phi` is the basic induction i = 0, 1, 2, ... of `loop`.
+  bool IsUnitStrideInduction(HLoopInformation* loop, HPhi* phi);
+
+  // Returns whether the vector instructions support `kind` on `packed_type`.
+  bool IsSupported(VecOperationKind kind, Primitive::Type packed_type, bool is_reduction) const;
+
+  // Matches the statement computed by `root`, an array set or the update of
+  // the given `reduction` phi. Returns the number of instructions of the
+  // statement, or 0 if it cannot be vectorized.
+  size_t MatchStatement(HLoopInformation* loop,
+                        HPhi* induction,
+                        HPhi* reduction,
+                        HInstruction* root,
+                        VectorStatement* statement) const;
+
+  void GenerateVectorLoop(HLoopInformation* loop,
+                          HPhi* phi,
+                          HInstruction* trip_count,
+                          size_t vector_length,
+                          const ArenaVector<VectorStatement>& statements);
+
+  void GenerateUnrolledLoop(HLoopInformation* loop,
+                            HPhi* phi,
+                            HInstruction* trip_count,
+                            size_t factor);
+
+  HInductionVarAnalysis* induction_analysis_;
+  const CompilerDriver* const driver_;
+
+  // The number of instructions peeling and unrolling may still add.
+  size_t instruction_budget_;
+
+  DISALLOW_COPY_AND_ASSIGN(HLoopOptimization);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
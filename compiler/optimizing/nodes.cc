@@ -1128,6 +1128,21 @@ std::ostream& operator<<(std::ostream& os, const HInstruction::InstructionKind&
   return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const VecOperationKind& rhs) {
+  switch (rhs) {
+    case VecOperationKind::kAdd: return os << "add";
+    case VecOperationKind::kSub: return os << "sub";
+    case VecOperationKind::kMul: return os << "mul";
+    case VecOperationKind::kDiv: return os << "div";
+    case VecOperationKind::kMin: return os << "min";
+    case VecOperationKind::kMax: return os << "max";
+    case VecOperationKind::kAnd: return os << "and";
+    case VecOperationKind::kOr: return os << "or";
+    case VecOperationKind::kXor: return os << "xor";
+  }
+  return os << "Unknown vector operation kind " << static_cast<int>(rhs);
+}
+
 void HInstruction::MoveBefore(HInstruction* cursor) {
   next_->previous_ = previous_;
   if (previous_ != nullptr) {
@@ -1181,6 +1196,36 @@ HBasicBlock* HBasicBlock::SplitBefore(HInstruction* cursor) {
   return new_block;
 }
 
+HBasicBlock* HBasicBlock::SplitBeforeForInlining(HInstruction* cursor) {
+  DCHECK_EQ(cursor->GetBlock(), this);
+
+  HBasicBlock* new_block = new (GetGraph()->GetArena()) HBasicBlock(GetGraph(),
+                                                                    cursor->GetDexPc());
+  new_block->instructions_.first_instruction_ = cursor;
+  new_block->instructions_.last_instruction_ = instructions_.last_instruction_;
+  instructions_.last_instruction_ = cursor->previous_;
+  if (cursor->previous_ == nullptr) {
+    instructions_.first_instruction_ = nullptr;
+  } else {
+    cursor->previous_->next_ = nullptr;
+    cursor->previous_ = nullptr;
+  }
+
+  new_block->instructions_.SetBlockOfInstructions(new_block);
+  for (HBasicBlock* successor : GetSuccessors()) {
+    new_block->successors_.push_back(successor);
+    successor->predecessors_[successor->GetPredecessorIndexOf(this)] = new_block;
+  }
+  successors_.clear();
+
+  for (HBasicBlock* dominated : GetDominatedBlocks()) {
+    dominated->dominator_ = new_block;
+    new_block->dominated_blocks_.push_back(dominated);
+  }
+  dominated_blocks_.clear();
+  return new_block;
+}
+
 HBasicBlock* HBasicBlock::CreateImmediateDominator() {
   DCHECK(!graph_->IsInSsaForm()) << "Support for SSA form not implemented";
   DCHECK(!IsCatchBlock()) << "Support for updating try/catch information not implemented.";
@@ -1330,6 +1375,20 @@ void HInstructionList::AddAfter(HInstruction* cursor, const HInstructionList& in
   }
 }
 
+void HInstructionList::AddBefore(HInstruction* cursor, const HInstructionList& instruction_list) {
+  DCHECK(Contains(cursor));
+  if (!instruction_list.IsEmpty()) {
+    if (cursor == first_instruction_) {
+      first_instruction_ = instruction_list.first_instruction_;
+    } else {
+      cursor->previous_->next_ = instruction_list.first_instruction_;
+    }
+    instruction_list.first_instruction_->previous_ = cursor->previous_;
+    instruction_list.last_instruction_->next_ = cursor;
+    cursor->previous_ = instruction_list.last_instruction_;
+  }
+}
+
 void HInstructionList::Add(const HInstructionList& instruction_list) {
   if (IsEmpty()) {
     first_instruction_ = instruction_list.first_instruction_;
@@ -1585,13 +1644,11 @@ HInstruction* HGraph::InlineInto(HGraph* outer_graph, HInvoke* invoke) {
     DCHECK(!body->IsExitBlock());
     HInstruction* last = body->GetLastInstruction();
 
-    invoke->GetBlock()->instructions_.AddAfter(invoke, body->GetInstructions());
+    invoke->GetBlock()->instructions_.AddBefore(invoke, body->GetInstructions());
     body->GetInstructions().SetBlockOfInstructions(invoke->GetBlock());
 
-    // Replace the invoke with the return value of the inlined graph.
     if (last->IsReturn()) {
       return_value = last->InputAt(0);
-      invoke->ReplaceWith(return_value);
     } else {
       DCHECK(last->IsReturnVoid());
     }
@@ -1599,12 +1656,12 @@ HInstruction* HGraph::InlineInto(HGraph* outer_graph, HInvoke* invoke) {
     invoke->GetBlock()->RemoveInstruction(last);
   } else {
     // Need to inline multiple blocks. We split `invoke`'s block
-    // into two blocks, merge the first block of the inlined graph into
-    // the first half, and replace the exit block of the inlined graph
-    // with the second half.
+    // into two blocks, the second one starting with `invoke`, merge the
+    // first block of the inlined graph into the first half, and replace
+    // the exit block of the inlined graph with the second half.
     ArenaAllocator* allocator = outer_graph->GetArena();
     HBasicBlock* at = invoke->GetBlock();
-    HBasicBlock* to = at->SplitAfter(invoke);
+    HBasicBlock* to = at->SplitBeforeForInlining(invoke);
 
     HBasicBlock* first = entry_block_->GetSuccessors()[0];
     DCHECK(!first->IsInLoop());
@@ -1639,14 +1696,14 @@ HInstruction* HGraph::InlineInto(HGraph* outer_graph, HInvoke* invoke) {
       }
     }
 
-    if (return_value != nullptr) {
-      invoke->ReplaceWith(return_value);
-    }
-
     // Update the meta information surrounding blocks:
     // (1) the graph they are now in,
     // (2) the reverse post order of that graph,
-    // (3) the potential loop information they are now in.
+    // (3) the potential loop information they are now in,
+    // (4) try block membership.
+    // Note that we do not need to update catch phi inputs because they
+    // correspond to the register file of the outer method which the inlinee
+    // cannot modify.
 
     // We don't add the entry block, the exit block, and the first block, which
     // has been merged with `at`.
@@ -1662,41 +1719,28 @@ HInstruction* HGraph::InlineInto(HGraph* outer_graph, HInvoke* invoke) {
     size_t index_of_at = IndexOfElement(outer_graph->reverse_post_order_, at);
     MakeRoomFor(&outer_graph->reverse_post_order_, blocks_added, index_of_at);
 
-    // Do a reverse post order of the blocks in the callee and do (1), (2),
-    // and (3) to the blocks that apply.
-    HLoopInformation* info = at->GetLoopInformation();
+    // Do a reverse post order of the blocks in the callee and do (1), (2), (3)
+    // and (4) to the blocks that apply.
     for (HReversePostOrderIterator it(*this); !it.Done(); it.Advance()) {
       HBasicBlock* current = it.Current();
       if (current != exit_block_ && current != entry_block_ && current != first) {
         DCHECK(!current->IsInLoop());
+        DCHECK(current->GetTryCatchInformation() == nullptr);
         DCHECK(current->GetGraph() == this);
         current->SetGraph(outer_graph);
         outer_graph->AddBlock(current);
         outer_graph->reverse_post_order_[++index_of_at] = current;
-        if (info != nullptr) {
-          current->SetLoopInformation(info);
-          for (HLoopInformationOutwardIterator loop_it(*at); !loop_it.Done(); loop_it.Advance()) {
-            loop_it.Current()->Add(current);
-          }
-        }
+        outer_graph->UpdateLoopAndTryInformationOfNewBlock(
+            current, at, /* replace_if_back_edge */ false);
       }
     }
 
-    // Do (1), (2), and (3) to `to`.
+    // Do (1), (2), (3) and (4) to `to`. Only `to` can become a back edge, as the
+    // inlined blocks are predecessors of `to`.
     to->SetGraph(outer_graph);
     outer_graph->AddBlock(to);
     outer_graph->reverse_post_order_[++index_of_at] = to;
-    if (info != nullptr) {
-      to->SetLoopInformation(info);
-      for (HLoopInformationOutwardIterator loop_it(*at); !loop_it.Done(); loop_it.Advance()) {
-        loop_it.Current()->Add(to);
-      }
-      if (info->IsBackEdge(*at)) {
-        // Only `to` can become a back edge, as the inlined blocks
-        // are predecessors of `to`.
-        info->ReplaceBackEdge(at, to);
-      }
-    }
+    outer_graph->UpdateLoopAndTryInformationOfNewBlock(to, at, /* replace_if_back_edge */ true);
   }
 
   // Update the next instruction id of the outer graph, so that instructions
@@ -1744,12 +1788,83 @@ HInstruction* HGraph::InlineInto(HGraph* outer_graph, HInvoke* invoke) {
     }
   }
 
-  // Finally remove the invoke from the caller.
-  invoke->GetBlock()->RemoveInstruction(invoke);
-
   return return_value;
 }
 
+HPhi* HGraph::CreateDiamondForGuardedInline(HInstruction* condition,
+                                            HInstruction* return_value,
+                                            HInvoke* invoke) {
+  HBasicBlock* cursor_block = condition->GetBlock();
+  HBasicBlock* invoke_block = invoke->GetBlock();
+  uint32_t dex_pc = invoke->GetDexPc();
+
+  // Before:
+  //   cursor_block: ... condition, inlined body ...
+  //   (inlined blocks)
+  //   invoke_block: ... invoke ...
+  //
+  // After:
+  //   cursor_block: ... condition, If(condition)
+  //   then:         inlined body ...                  (false successor)
+  //   (inlined blocks)
+  //   end_then:     ... Goto
+  //   otherwise:    invoke, Goto                      (true successor)
+  //   merge:        Phi(return_value, invoke) ...
+  HBasicBlock* then = cursor_block->SplitAfter(condition);
+  HBasicBlock* end_then = invoke->GetBlock();
+  HBasicBlock* otherwise = end_then->SplitBeforeForInlining(invoke);
+  HBasicBlock* merge = otherwise->SplitAfter(invoke);
+
+  cursor_block->AddInstruction(new (arena_) HIf(condition, dex_pc));
+  end_then->AddInstruction(new (arena_) HGoto(dex_pc));
+  otherwise->AddInstruction(new (arena_) HGoto(dex_pc));
+
+  HPhi* phi = nullptr;
+  if (return_value != nullptr) {
+    phi = new (arena_) HPhi(arena_, kNoRegNumber, 0, HPhi::ToPhiType(invoke->GetType()), dex_pc);
+    merge->AddPhi(phi);
+    invoke->ReplaceWith(phi);
+    // The inputs follow the order of the predecessors of `merge` added below.
+    phi->AddInput(return_value);
+    phi->AddInput(invoke);
+  }
+
+  AddBlock(then);
+  AddBlock(otherwise);
+  AddBlock(merge);
+  // The true successor is the first one.
+  cursor_block->AddSuccessor(otherwise);
+  cursor_block->AddSuccessor(then);
+  end_then->AddSuccessor(merge);
+  otherwise->AddSuccessor(merge);
+
+  // The splits moved the blocks dominated by `cursor_block` and `invoke_block` to
+  // `then` and `merge`. The three new blocks are all dominated by `cursor_block`.
+  then->SetDominator(cursor_block);
+  cursor_block->AddDominatedBlock(then);
+  otherwise->SetDominator(cursor_block);
+  cursor_block->AddDominatedBlock(otherwise);
+  merge->SetDominator(cursor_block);
+  cursor_block->AddDominatedBlock(merge);
+
+  // `then` comes right after `cursor_block` in the reverse post order, followed by
+  // the inlined blocks, if any, then `otherwise` and `merge` follow `end_then`.
+  size_t index = IndexOfElement(reverse_post_order_, cursor_block);
+  MakeRoomFor(&reverse_post_order_, 1, index);
+  reverse_post_order_[++index] = then;
+  index = IndexOfElement(reverse_post_order_, end_then);
+  MakeRoomFor(&reverse_post_order_, 2, index);
+  reverse_post_order_[++index] = otherwise;
+  reverse_post_order_[++index] = merge;
+
+  // Only `merge` can become a back edge, as it ends the diamond.
+  UpdateLoopAndTryInformationOfNewBlock(then, invoke_block, /* replace_if_back_edge */ false);
+  UpdateLoopAndTryInformationOfNewBlock(
+      otherwise, invoke_block, /* replace_if_back_edge */ false);
+  UpdateLoopAndTryInformationOfNewBlock(merge, invoke_block, /* replace_if_back_edge */ true);
+  return phi;
+}
+
 /*
  * Loop will be transformed to:
  *       old_pre_header
@@ -1765,6 +1880,9 @@ HInstruction* HGraph::InlineInto(HGraph* outer_graph, HInvoke* invoke) {
 void HGraph::TransformLoopHeaderForBCE(HBasicBlock* header) {
   DCHECK(header->IsLoopHeader());
   HBasicBlock* pre_header = header->GetDominator();
+  // The successors of `pre_header` are replaced below, which would drop the
+  // exceptional successors of a try boundary.
+  DCHECK(!pre_header->EndsWithTryBoundary());
 
   // Need this to avoid critical edge.
   HBasicBlock* if_block = new (arena_) HBasicBlock(this, header->GetDexPc());
@@ -1805,21 +1923,93 @@ void HGraph::TransformLoopHeaderForBCE(HBasicBlock* header) {
   reverse_post_order_[index_of_header++] = deopt_block;
   reverse_post_order_[index_of_header++] = new_pre_header;
 
-  HLoopInformation* info = pre_header->GetLoopInformation();
+  UpdateLoopAndTryInformationOfNewBlock(if_block, pre_header, /* replace_if_back_edge */ false);
+  UpdateLoopAndTryInformationOfNewBlock(
+      dummy_block, pre_header, /* replace_if_back_edge */ false);
+  UpdateLoopAndTryInformationOfNewBlock(
+      deopt_block, pre_header, /* replace_if_back_edge */ false);
+  UpdateLoopAndTryInformationOfNewBlock(
+      new_pre_header, pre_header, /* replace_if_back_edge */ false);
+}
+
+HBasicBlock* HGraph::InsertEmptyLoopBefore(HBasicBlock* header) {
+  DCHECK(header->IsLoopHeader());
+  HBasicBlock* pre_header = header->GetDominator();
+  // The successors of `pre_header` are replaced below, which would drop the
+  // exceptional successors of a try boundary.
+  DCHECK(!pre_header->EndsWithTryBoundary());
+
+  HBasicBlock* new_header = new (arena_) HBasicBlock(this, header->GetDexPc());
+  HBasicBlock* new_body = new (arena_) HBasicBlock(this, header->GetDexPc());
+  HBasicBlock* new_pre_header = new (arena_) HBasicBlock(this, header->GetDexPc());
+  AddBlock(new_header);
+  AddBlock(new_body);
+  AddBlock(new_pre_header);
+
+  header->ReplacePredecessor(pre_header, new_pre_header);
+  pre_header->successors_.clear();
+  pre_header->dominated_blocks_.clear();
+
+  pre_header->AddSuccessor(new_header);
+  new_header->AddSuccessor(new_body);  // True successor
+  new_header->AddSuccessor(new_pre_header);  // False successor
+  new_body->AddSuccessor(new_header);  // Back edge
+
+  pre_header->dominated_blocks_.push_back(new_header);
+  new_header->SetDominator(pre_header);
+  new_header->dominated_blocks_.push_back(new_body);
+  new_body->SetDominator(new_header);
+  new_header->dominated_blocks_.push_back(new_pre_header);
+  new_pre_header->SetDominator(new_header);
+  new_pre_header->dominated_blocks_.push_back(header);
+  header->SetDominator(new_pre_header);
+
+  size_t index_of_header = IndexOfElement(reverse_post_order_, header);
+  MakeRoomFor(&reverse_post_order_, 3, index_of_header - 1);
+  reverse_post_order_[index_of_header++] = new_header;
+  reverse_post_order_[index_of_header++] = new_body;
+  reverse_post_order_[index_of_header++] = new_pre_header;
+
+  // All three blocks belong to the loops enclosing `header`, if any.
+  UpdateLoopAndTryInformationOfNewBlock(
+      new_header, pre_header, /* replace_if_back_edge */ false);
+  UpdateLoopAndTryInformationOfNewBlock(
+      new_body, pre_header, /* replace_if_back_edge */ false);
+  UpdateLoopAndTryInformationOfNewBlock(
+      new_pre_header, pre_header, /* replace_if_back_edge */ false);
+
+  // The new header and body also form a loop of their own.
+  HLoopInformation* loop_info = new (arena_) HLoopInformation(new_header, this);
+  loop_info->AddBackEdge(new_body);
+  loop_info->Add(new_header);
+  loop_info->Add(new_body);
+  new_header->SetLoopInformation(loop_info);
+  new_body->SetLoopInformation(loop_info);
+  return new_header;
+}
+
+void HGraph::UpdateLoopAndTryInformationOfNewBlock(HBasicBlock* block,
+                                                   HBasicBlock* reference,
+                                                   bool replace_if_back_edge) {
+  HLoopInformation* info = reference->GetLoopInformation();
   if (info != nullptr) {
-    if_block->SetLoopInformation(info);
-    dummy_block->SetLoopInformation(info);
-    deopt_block->SetLoopInformation(info);
-    new_pre_header->SetLoopInformation(info);
-    for (HLoopInformationOutwardIterator loop_it(*pre_header);
+    block->SetLoopInformation(info);
+    for (HLoopInformationOutwardIterator loop_it(*reference);
          !loop_it.Done();
          loop_it.Advance()) {
-      loop_it.Current()->Add(if_block);
-      loop_it.Current()->Add(dummy_block);
-      loop_it.Current()->Add(deopt_block);
-      loop_it.Current()->Add(new_pre_header);
+      loop_it.Current()->Add(block);
+    }
+    if (replace_if_back_edge && info->IsBackEdge(*reference)) {
+      info->ReplaceBackEdge(reference, block);
     }
   }
+
+  // Copy the try membership of `reference`. The new block never contains a
+  // try boundary of `reference`'s try, so it does not need one of its own.
+  TryCatchInformation* try_catch_info = reference->IsTryBlock()
+      ? reference->GetTryCatchInformation()
+      : nullptr;
+  block->SetTryCatchInformation(try_catch_info);
 }
 
 void HInstruction::SetReferenceTypeInfo(ReferenceTypeInfo rti) {
@@ -123,6 +123,7 @@ class HInstructionList : public ValueObject {
   void SetBlockOfInstructions(HBasicBlock* block) const;
 
   void AddAfter(HInstruction* cursor, const HInstructionList& instruction_list);
+  void AddBefore(HInstruction* cursor, const HInstructionList& instruction_list);
   void Add(const HInstructionList& instruction_list);
 
   // Return the number of instructions in the list. This is an expensive operation.
@@ -177,7 +178,8 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         cached_float_constants_(std::less<int32_t>(), arena->Adapter(kArenaAllocConstantsMap)),
         cached_long_constants_(std::less<int64_t>(), arena->Adapter(kArenaAllocConstantsMap)),
         cached_double_constants_(std::less<int64_t>(), arena->Adapter(kArenaAllocConstantsMap)),
-        cached_current_method_(nullptr) {
+        cached_current_method_(nullptr),
+        art_method_(nullptr) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
 
@@ -230,15 +232,40 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // order and loop information.
   void ComputeTryBlockInformation();
 
-  // Inline this graph in `outer_graph`, replacing the given `invoke` instruction.
-  // Returns the instruction used to replace the invoke expression or null if the
-  // invoke is for a void method.
+  // Inline this graph in `outer_graph`, just before the given `invoke` instruction.
+  // The invoke is left in place: the caller either replaces it with the returned
+  // instruction and removes it, or keeps it as the fallback of a guarded inlining.
+  // Returns the instruction computing the return value of the inlined graph or null
+  // if the invoke is for a void method.
   HInstruction* InlineInto(HGraph* outer_graph, HInvoke* invoke);
 
+  // Turns the code following `condition` in its block into a diamond: `invoke` is
+  // moved to a block executed when `condition` is true, and the instructions between
+  // `condition` and `invoke`, the body inlined for `invoke` by InlineInto, into a
+  // block executed when it is false. Returns the phi replacing `invoke` in the block
+  // joining both, merging `return_value` and the result of `invoke`, or null if
+  // `return_value` is null.
+  HPhi* CreateDiamondForGuardedInline(HInstruction* condition,
+                                      HInstruction* return_value,
+                                      HInvoke* invoke);
+
   // Need to add a couple of blocks to test if the loop body is entered and
   // put deoptimization instructions, etc.
   void TransformLoopHeaderForBCE(HBasicBlock* header);
 
+  // Inserts an empty loop (a header and a single body block) between the
+  // pre-header of the loop with the given `header` and the loop itself.
+  // Returns the header of the new loop, whose first successor is the body
+  // and second successor the new pre-header of `header`.
+  HBasicBlock* InsertEmptyLoopBefore(HBasicBlock* header);
+
+  // Sets the loop and try membership of the newly created `block`, which must
+  // be the same as those of `reference`. If `replace_if_back_edge` is true and
+  // `reference` is a back edge of its loop, `block` replaces it as back edge.
+  void UpdateLoopAndTryInformationOfNewBlock(HBasicBlock* block,
+                                             HBasicBlock* reference,
+                                             bool replace_if_back_edge);
+
   // Removes `block` from the graph.
   void DeleteDeadBlock(HBasicBlock* block);
 
@@ -370,6 +397,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   bool HasTryCatch() const { return has_try_catch_; }
   void SetHasTryCatch(bool value) { has_try_catch_ = value; }
 
+  ArtMethod* GetArtMethod() const { return art_method_; }
+  void SetArtMethod(ArtMethod* method) { art_method_ = method; }
+
  private:
   void FindBackEdges(ArenaBitVector* visited);
   void RemoveInstructionsAsUsersFromDeadBlocks(const ArenaBitVector& visited) const;
@@ -473,6 +503,11 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   HCurrentMethod* cached_current_method_;
 
+  // The ArtMethod this graph is for. Note that for AOT, it may be null,
+  // for example for methods whose declaring class could not be resolved
+  // (such as when the superclass could not be found).
+  ArtMethod* art_method_;
+
   friend class SsaBuilder;           // For caching constants.
   friend class SsaLivenessAnalysis;  // For the linear order.
   ART_FRIEND_TEST(GraphTest, IfSuccessorSimpleJoinBlock1);
@@ -823,6 +858,11 @@ class HBasicBlock : public ArenaObject<kArenaAllocBasicBlock> {
   // loop and try/catch information.
   HBasicBlock* SplitBefore(HInstruction* cursor);
 
+  // Same as SplitBefore, but only updates raw block information, like
+  // successors, dominators, and instruction list. It does not add the block to
+  // the graph, nor create a Goto or an edge between the blocks.
+  HBasicBlock* SplitBeforeForInlining(HInstruction* cursor);
+
   // Split the block into two blocks just after `cursor`. Returns the newly
   // created block. Note that this method just updates raw block information,
   // like predecessors, successors, dominators, and instruction list. It does not
@@ -1059,6 +1099,7 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(Rem, BinaryOperation)                                               \
   M(Return, Instruction)                                                \
   M(ReturnVoid, Instruction)                                            \
+  M(Select, Instruction)                                                \
   M(Shl, BinaryOperation)                                               \
   M(Shr, BinaryOperation)                                               \
   M(StaticFieldGet, Instruction)                                        \
@@ -1090,8 +1131,15 @@ class HLoopInformationOutwardIterator : public ValueObject {
 
 #define FOR_EACH_CONCRETE_INSTRUCTION_X86_64(M)
 
+// Vector instructions are only generated for the instruction sets whose code
+// generators implement them, see HLoopOptimization.
+#define FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(M)                         \
+  M(VecArrayOperation, Instruction)                                     \
+  M(VecReduce, Instruction)
+
 #define FOR_EACH_CONCRETE_INSTRUCTION(M)                                \
   FOR_EACH_CONCRETE_INSTRUCTION_COMMON(M)                               \
+  FOR_EACH_CONCRETE_INSTRUCTION_VECTOR(M)                               \
   FOR_EACH_CONCRETE_INSTRUCTION_ARM(M)                                  \
   FOR_EACH_CONCRETE_INSTRUCTION_ARM64(M)                                \
   FOR_EACH_CONCRETE_INSTRUCTION_MIPS64(M)                               \
@@ -2623,6 +2671,8 @@ class HCondition : public HBinaryOperation {
 
   bool IsGtBias() const { return bias_ == ComparisonBias::kGtBias; }
 
+  ComparisonBias GetBias() const { return bias_; }
+
   void SetBias(ComparisonBias bias) { bias_ = bias; }
 
   bool InstructionDataEquals(HInstruction* other) const OVERRIDE {
@@ -3569,10 +3619,14 @@ class HNewInstance : public HExpression<1> {
                uint32_t dex_pc,
                uint16_t type_index,
                const DexFile& dex_file,
+               bool can_throw_other_than_oome,
+               bool finalizable,
                QuickEntrypointEnum entrypoint)
       : HExpression(Primitive::kPrimNot, SideEffects::CanTriggerGC(), dex_pc),
         type_index_(type_index),
         dex_file_(dex_file),
+        can_throw_other_than_oome_(can_throw_other_than_oome),
+        finalizable_(finalizable),
         entrypoint_(entrypoint) {
     SetRawInputAt(0, current_method);
   }
@@ -3580,6 +3634,14 @@ class HNewInstance : public HExpression<1> {
   uint16_t GetTypeIndex() const { return type_index_; }
   const DexFile& GetDexFile() const { return dex_file_; }
 
+  // Returns whether the allocation may do more than allocating memory, that is
+  // resolve or initialize the class, or throw anything else than an
+  // OutOfMemoryError. Such an allocation cannot be removed, even if unused.
+  bool CanThrowOtherThanOOME() const { return can_throw_other_than_oome_; }
+
+  // Returns whether the class may have a finalizer, which can observe the object.
+  bool IsFinalizable() const { return finalizable_; }
+
   // Calls runtime so needs an environment.
   bool NeedsEnvironment() const OVERRIDE { return true; }
   // It may throw when called on:
@@ -3597,6 +3659,8 @@ class HNewInstance : public HExpression<1> {
  private:
   const uint16_t type_index_;
   const DexFile& dex_file_;
+  const bool can_throw_other_than_oome_;
+  const bool finalizable_;
   const QuickEntrypointEnum entrypoint_;
 
   DISALLOW_COPY_AND_ASSIGN(HNewInstance);
@@ -4285,6 +4349,43 @@ class HPhi : public HInstruction {
   DISALLOW_COPY_AND_ASSIGN(HPhi);
 };
 
+// Selects `true_value` if `condition` is true, `false_value` otherwise. Replaces
+// a branch whose only effect is to pick one of two values, so that code
+// generators can use a conditional move.
+class HSelect : public HExpression<3> {
+ public:
+  HSelect(HInstruction* condition,
+          HInstruction* true_value,
+          HInstruction* false_value,
+          uint32_t dex_pc)
+      : HExpression(HPhi::ToPhiType(true_value->GetType()), SideEffects::None(), dex_pc) {
+    DCHECK_EQ(HPhi::ToPhiType(true_value->GetType()), HPhi::ToPhiType(false_value->GetType()));
+    // The false value is the first input, so that code generators can allocate
+    // the output to it and overwrite it when the condition is true.
+    SetRawInputAt(0, false_value);
+    SetRawInputAt(1, true_value);
+    SetRawInputAt(2, condition);
+  }
+
+  HInstruction* GetFalseValue() const { return InputAt(0); }
+  HInstruction* GetTrueValue() const { return InputAt(1); }
+  HInstruction* GetCondition() const { return InputAt(2); }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+  bool InstructionDataEquals(HInstruction* other ATTRIBUTE_UNUSED) const OVERRIDE {
+    return true;
+  }
+
+  bool CanBeNull() const OVERRIDE {
+    return GetTrueValue()->CanBeNull() || GetFalseValue()->CanBeNull();
+  }
+
+  DECLARE_INSTRUCTION(Select);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HSelect);
+};
+
 class HNullCheck : public HExpression<1> {
  public:
   HNullCheck(HInstruction* value, uint32_t dex_pc)
@@ -4590,6 +4691,116 @@ class HBoundsCheck : public HExpression<2> {
   DISALLOW_COPY_AND_ASSIGN(HBoundsCheck);
 };
 
+// Vector instructions operate on the kVectorSizeInBytes bytes of consecutive
+// array elements starting at a given index, that is on GetVectorLength()
+// elements of their packed type at once. The elements are accessed without
+// null or bounds checks: the optimization creating a vector instruction
+// guarantees that all of them are in bounds.
+static constexpr size_t kVectorSizeInBytes = 16;
+
+enum class VecOperationKind {
+  kAdd,
+  kSub,
+  kMul,
+  kDiv,
+  kMin,
+  kMax,
+  kAnd,
+  kOr,
+  kXor,
+};
+
+std::ostream& operator<<(std::ostream& os, const VecOperationKind& rhs);
+
+// Stores `left[index + k] op right[index + k]` into `array[index + k]` for
+// each lane k of the vector. When `right` is not an array, it is a scalar
+// which is combined with every element of `left` instead.
+class HVecArrayOperation : public HTemplateInstruction<4> {
+ public:
+  HVecArrayOperation(VecOperationKind kind,
+                     Primitive::Type packed_type,
+                     HInstruction* array,
+                     HInstruction* index,
+                     HInstruction* left,
+                     HInstruction* right,
+                     uint32_t dex_pc)
+      : HTemplateInstruction(SideEffects::ArrayWriteOfType(packed_type).Union(
+                                 SideEffects::ArrayReadOfType(packed_type)),
+                             dex_pc),
+        kind_(kind),
+        packed_type_(packed_type) {
+    DCHECK_EQ(index->GetType(), Primitive::kPrimInt);
+    SetRawInputAt(0, array);
+    SetRawInputAt(1, index);
+    SetRawInputAt(2, left);
+    SetRawInputAt(3, right);
+  }
+
+  VecOperationKind GetOperationKind() const { return kind_; }
+  Primitive::Type GetPackedType() const { return packed_type_; }
+  size_t GetVectorLength() const {
+    return kVectorSizeInBytes / Primitive::ComponentSize(packed_type_);
+  }
+
+  HInstruction* GetArray() const { return InputAt(0); }
+  HInstruction* GetIndex() const { return InputAt(1); }
+  HInstruction* GetLeft() const { return InputAt(2); }
+  HInstruction* GetRight() const { return InputAt(3); }
+  bool IsRightAnArray() const { return GetRight()->GetType() == Primitive::kPrimNot; }
+
+  DECLARE_INSTRUCTION(VecArrayOperation);
+
+ private:
+  const VecOperationKind kind_;
+  const Primitive::Type packed_type_;
+
+  DISALLOW_COPY_AND_ASSIGN(HVecArrayOperation);
+};
+
+// Combines all the lanes of `array[index + k]` with `accumulator`, using an
+// associative and commutative operation. The packed type is the type of the
+// accumulator.
+class HVecReduce : public HExpression<3> {
+ public:
+  HVecReduce(VecOperationKind kind,
+             HInstruction* accumulator,
+             HInstruction* array,
+             HInstruction* index,
+             uint32_t dex_pc)
+      : HExpression(accumulator->GetType(),
+                    SideEffects::ArrayReadOfType(accumulator->GetType()),
+                    dex_pc),
+        kind_(kind) {
+    DCHECK(kind == VecOperationKind::kAdd ||
+           kind == VecOperationKind::kMin ||
+           kind == VecOperationKind::kMax ||
+           kind == VecOperationKind::kAnd ||
+           kind == VecOperationKind::kOr ||
+           kind == VecOperationKind::kXor) << kind;
+    DCHECK_EQ(index->GetType(), Primitive::kPrimInt);
+    SetRawInputAt(0, accumulator);
+    SetRawInputAt(1, array);
+    SetRawInputAt(2, index);
+  }
+
+  VecOperationKind GetOperationKind() const { return kind_; }
+  Primitive::Type GetPackedType() const { return GetType(); }
+  size_t GetVectorLength() const {
+    return kVectorSizeInBytes / Primitive::ComponentSize(GetType());
+  }
+
+  HInstruction* GetAccumulator() const { return InputAt(0); }
+  HInstruction* GetArray() const { return InputAt(1); }
+  HInstruction* GetIndex() const { return InputAt(2); }
+
+  DECLARE_INSTRUCTION(VecReduce);
+
+ private:
+  const VecOperationKind kind_;
+
+  DISALLOW_COPY_AND_ASSIGN(HVecReduce);
+};
+
 /**
  * Some DEX instructions are folded into multiple HInstructions that need
  * to stay live until the last HInstruction. This class
@@ -38,6 +38,7 @@
 #include "bounds_check_elimination.h"
 #include "builder.h"
 #include "code_generator.h"
+#include "code_sinking.h"
 #include "compiled_method.h"
 #include "compiler.h"
 #include "constant_folding.h"
@@ -64,11 +65,15 @@
 #include "instruction_simplifier.h"
 #include "intrinsics.h"
 #include "licm.h"
+#include "load_store_elimination.h"
+#include "loop_optimization.h"
 #include "jni/quick/jni_compiler.h"
 #include "nodes.h"
 #include "prepare_for_register_allocation.h"
 #include "reference_type_propagation.h"
 #include "register_allocator.h"
+#include "scheduler.h"
+#include "select_generator.h"
 #include "side_effects_analysis.h"
 #include "ssa_builder.h"
 #include "ssa_phi_elimination.h"
@@ -275,6 +280,16 @@ class OptimizingCompiler FINAL : public Compiler {
                           const DexFile& dex_file,
                           Handle<mirror::DexCache> dex_cache) const OVERRIDE;
 
+  CompiledMethod* CompileOsr(const DexFile::CodeItem* code_item,
+                             uint32_t access_flags,
+                             InvokeType invoke_type,
+                             uint16_t class_def_idx,
+                             uint32_t method_idx,
+                             jobject class_loader,
+                             const DexFile& dex_file,
+                             Handle<mirror::DexCache> dex_cache,
+                             const jit::OsrEntry& osr_entry) const OVERRIDE;
+
   CompiledMethod* TryCompile(const DexFile::CodeItem* code_item,
                              uint32_t access_flags,
                              InvokeType invoke_type,
@@ -282,7 +297,8 @@ class OptimizingCompiler FINAL : public Compiler {
                              uint32_t method_idx,
                              jobject class_loader,
                              const DexFile& dex_file,
-                             Handle<mirror::DexCache> dex_cache) const;
+                             Handle<mirror::DexCache> dex_cache,
+                             const jit::OsrEntry* osr_entry = nullptr) const;
 
   CompiledMethod* JniCompile(uint32_t access_flags,
                              uint32_t method_idx,
@@ -436,10 +452,13 @@ static void RunArchOptimizations(InstructionSet instruction_set,
           new (arena) arm64::InstructionSimplifierArm64(graph, stats);
       SideEffectsAnalysis* side_effects = new (arena) SideEffectsAnalysis(graph);
       GVNOptimization* gvn = new (arena) GVNOptimization(graph, *side_effects, "GVN_after_arch");
+      HInstructionScheduling* scheduling =
+          new (arena) HInstructionScheduling(graph, instruction_set, stats);
       HOptimization* arm64_optimizations[] = {
         simplifier,
         side_effects,
-        gvn
+        gvn,
+        scheduling
       };
       RunOptimizations(arm64_optimizations, arraysize(arm64_optimizations), pass_observer);
       break;
@@ -455,6 +474,17 @@ static void RunArchOptimizations(InstructionSet instruction_set,
       RunOptimizations(x86_optimizations, arraysize(x86_optimizations), pass_observer);
       break;
     }
+#endif
+#ifdef ART_ENABLE_CODEGEN_x86_64
+    case kX86_64: {
+      HInstructionScheduling* scheduling =
+          new (arena) HInstructionScheduling(graph, instruction_set, stats);
+      HOptimization* x86_64_optimizations[] = {
+        scheduling
+      };
+      RunOptimizations(x86_64_optimizations, arraysize(x86_64_optimizations), pass_observer);
+      break;
+    }
 #endif
     default:
       break;
@@ -475,18 +505,25 @@ static void RunOptimizations(HGraph* graph,
   HConstantFolding* fold1 = new (arena) HConstantFolding(graph);
   InstructionSimplifier* simplify1 = new (arena) InstructionSimplifier(graph, stats);
   HBooleanSimplifier* boolean_simplify = new (arena) HBooleanSimplifier(graph);
+  HSelectGenerator* select_generator = new (arena) HSelectGenerator(graph, stats);
   HConstantFolding* fold2 = new (arena) HConstantFolding(graph, "constant_folding_after_inlining");
   SideEffectsAnalysis* side_effects = new (arena) SideEffectsAnalysis(graph);
   GVNOptimization* gvn = new (arena) GVNOptimization(graph, *side_effects);
   LICM* licm = new (arena) LICM(graph, *side_effects);
   HInductionVarAnalysis* induction = new (arena) HInductionVarAnalysis(graph);
   BoundsCheckElimination* bce = new (arena) BoundsCheckElimination(graph, induction);
+  HLoopOptimization* loop = new (arena) HLoopOptimization(graph, induction, driver, stats);
   ReferenceTypePropagation* type_propagation =
       new (arena) ReferenceTypePropagation(graph, handles);
   InstructionSimplifier* simplify2 = new (arena) InstructionSimplifier(
       graph, stats, "instruction_simplifier_after_types");
   InstructionSimplifier* simplify3 = new (arena) InstructionSimplifier(
       graph, stats, "instruction_simplifier_after_bce");
+  // BCE and the loop optimization may add blocks, so LSE needs side effects
+  // computed after them.
+  SideEffectsAnalysis* side_effects2 = new (arena) SideEffectsAnalysis(graph);
+  LoadStoreElimination* lse = new (arena) LoadStoreElimination(graph, *side_effects2);
+  CodeSinking* code_sinking = new (arena) CodeSinking(graph, stats);
   InstructionSimplifier* simplify4 = new (arena) InstructionSimplifier(
       graph, stats, "instruction_simplifier_before_codegen");
 
@@ -503,43 +540,35 @@ static void RunOptimizations(HGraph* graph,
 
   RunOptimizations(optimizations1, arraysize(optimizations1), pass_observer);
 
-  // TODO: Update passes incompatible with try/catch so we have the same
-  //       pipeline for all methods.
-  if (graph->HasTryCatch()) {
-    HOptimization* optimizations2[] = {
-      side_effects,
-      gvn,
-      dce2,
-      // The codegen has a few assumptions that only the instruction simplifier
-      // can satisfy. For example, the code generator does not expect to see a
-      // HTypeConversion from a type to the same type.
-      simplify4,
-    };
-
-    RunOptimizations(optimizations2, arraysize(optimizations2), pass_observer);
-  } else {
-    MaybeRunInliner(graph, driver, stats, dex_compilation_unit, pass_observer, handles);
-
-    HOptimization* optimizations2[] = {
-      // BooleanSimplifier depends on the InstructionSimplifier removing
-      // redundant suspend checks to recognize empty blocks.
-      boolean_simplify,
-      fold2,  // TODO: if we don't inline we can also skip fold2.
-      side_effects,
-      gvn,
-      licm,
-      induction,
-      bce,
-      simplify3,
-      dce2,
-      // The codegen has a few assumptions that only the instruction simplifier
-      // can satisfy. For example, the code generator does not expect to see a
-      // HTypeConversion from a type to the same type.
-      simplify4,
-    };
-
-    RunOptimizations(optimizations2, arraysize(optimizations2), pass_observer);
-  }
+  MaybeRunInliner(graph, driver, stats, dex_compilation_unit, pass_observer, handles);
+
+  HOptimization* optimizations2[] = {
+    // BooleanSimplifier and SelectGenerator depend on the InstructionSimplifier
+    // removing redundant suspend checks to recognize empty blocks.
+    boolean_simplify,
+    fold2,    boolean_simplify,
+    select_generator,
+    fold2,  // TODO: if we don't inline we can also skip fold2.
+    side_effects,
+    gvn,
+    licm,
+    induction,
+    bce,
+    loop,
+    simplify3,
+    side_effects2,
+    lse,
+    dce2,
+    // Code sinking runs after LSE and DCE, which remove the loads and the
+    // unused instructions it does not handle.
+    code_sinking,
+    // The codegen has a few assumptions that only the instruction simplifier
+    // can satisfy. For example, the code generator does not expect to see a
+    // HTypeConversion from a type to the same type.
+    simplify4,
+  };
+
+  RunOptimizations(optimizations2, arraysize(optimizations2), pass_observer);
 
   RunArchOptimizations(driver->GetInstructionSet(), graph, stats, pass_observer);
 }
@@ -558,7 +587,8 @@ static ArrayRef<const uint8_t> AlignVectorSize(ArenaVector<uint8_t>& vector) {
 NO_INLINE  // Avoid increasing caller's frame size by large stack-allocated objects.
 static void AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
-                              PassObserver* pass_observer) {
+                              PassObserver* pass_observer,
+                              RegisterAllocator::Strategy strategy) {
   PrepareForRegisterAllocation(graph).Run();
   SsaLivenessAnalysis liveness(graph, codegen);
   {
@@ -567,7 +597,7 @@ static void AllocateRegisters(HGraph* graph,
   }
   {
     PassScope scope(RegisterAllocator::kRegisterAllocatorPassName, pass_observer);
-    RegisterAllocator(graph->GetArena(), codegen, liveness).AllocateRegisters();
+    RegisterAllocator::Create(graph->GetArena(), codegen, liveness, strategy)->AllocateRegisters();
   }
 }
 
@@ -595,7 +625,15 @@ CompiledMethod* OptimizingCompiler::CompileOptimized(HGraph* graph,
   RunOptimizations(graph, compiler_driver, compilation_stats_.get(),
                    dex_compilation_unit, pass_observer, &handles);
 
-  AllocateRegisters(graph, codegen, pass_observer);
+  // Graph coloring allocates better registers than linear scan, but its cost
+  // grows faster with the size of the method.
+  size_t graph_coloring_max_code_units =
+      compiler_driver->GetCompilerOptions().GetGraphColoringMaxCodeUnits();
+  RegisterAllocator::Strategy strategy =
+      dex_compilation_unit.GetCodeItem()->insns_size_in_code_units_ <= graph_coloring_max_code_units
+          ? RegisterAllocator::kRegisterAllocatorGraphColor
+          : RegisterAllocator::kRegisterAllocatorLinearScan;
+  AllocateRegisters(graph, codegen, pass_observer, strategy);
 
   ArenaAllocator* arena = graph->GetArena();
   CodeVectorAllocator allocator(arena);
@@ -684,7 +722,8 @@ CompiledMethod* OptimizingCompiler::TryCompile(const DexFile::CodeItem* code_ite
                                                uint32_t method_idx,
                                                jobject class_loader,
                                                const DexFile& dex_file,
-                                               Handle<mirror::DexCache> dex_cache) const {
+                                               Handle<mirror::DexCache> dex_cache,
+                                               const jit::OsrEntry* osr_entry) const {
   std::string method_name = PrettyMethod(method_idx, dex_file);
   MaybeRecordStat(MethodCompilationStat::kAttemptCompilation);
   CompilerDriver* compiler_driver = GetCompilerDriver();
@@ -762,6 +801,7 @@ CompiledMethod* OptimizingCompiler::TryCompile(const DexFile::CodeItem* code_ite
     // We may not get a method, for example if its class is erroneous.
     // TODO: Clean this up, the compiler driver should just pass the ArtMethod to compile.
     if (art_method != nullptr) {
+      graph->SetArtMethod(art_method);
       interpreter_metadata = art_method->GetQuickenedInfo();
     }
   }
@@ -772,7 +812,8 @@ CompiledMethod* OptimizingCompiler::TryCompile(const DexFile::CodeItem* code_ite
                         compiler_driver,
                         compilation_stats_.get(),
                         interpreter_metadata,
-                        dex_cache);
+                        dex_cache,
+                        osr_entry);
 
   VLOG(compiler) << "Building " << method_name;
 
@@ -786,6 +827,13 @@ CompiledMethod* OptimizingCompiler::TryCompile(const DexFile::CodeItem* code_ite
 
   bool can_allocate_registers = RegisterAllocator::CanAllocateRegistersFor(*graph, instruction_set);
 
+  if (osr_entry != nullptr && !(run_optimizations_ && can_allocate_registers)) {
+    // Baseline keeps the dex registers in the frame, and expects them as the method's
+    // parameters.
+    MaybeRecordStat(MethodCompilationStat::kNotCompiledOsr);
+    return nullptr;
+  }
+
   // `run_optimizations_` is set explicitly (either through a compiler filter
   // or the debuggable flag). If it is set, we can run baseline. Otherwise, we fall back
   // to Quick.
@@ -884,6 +932,27 @@ CompiledMethod* OptimizingCompiler::Compile(const DexFile::CodeItem* code_item,
   return method;
 }
 
+CompiledMethod* OptimizingCompiler::CompileOsr(const DexFile::CodeItem* code_item,
+                                               uint32_t access_flags,
+                                               InvokeType invoke_type,
+                                               uint16_t class_def_idx,
+                                               uint32_t method_idx,
+                                               jobject jclass_loader,
+                                               const DexFile& dex_file,
+                                               Handle<mirror::DexCache> dex_cache,
+                                               const jit::OsrEntry& osr_entry) const {
+  CompilerDriver* compiler_driver = GetCompilerDriver();
+  const VerifiedMethod* verified_method = compiler_driver->GetVerifiedMethod(&dex_file, method_idx);
+  DCHECK(!verified_method->HasRuntimeThrow());
+  if (!compiler_driver->IsMethodVerifiedWithoutFailures(method_idx, class_def_idx, dex_file)
+      && !CanHandleVerificationFailure(verified_method)) {
+    MaybeRecordStat(MethodCompilationStat::kNotCompiledClassNotVerified);
+    return nullptr;
+  }
+  return TryCompile(code_item, access_flags, invoke_type, class_def_idx,
+                    method_idx, jclass_loader, dex_file, dex_cache, &osr_entry);
+}
+
 Compiler* CreateOptimizingCompiler(CompilerDriver* driver) {
   return new OptimizingCompiler(driver);
 }
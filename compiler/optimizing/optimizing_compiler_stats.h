@@ -30,6 +30,13 @@ enum MethodCompilationStat {
   kCompiledBaseline,
   kCompiledOptimized,
   kInlinedInvoke,
+  kInlinedMonomorphicCall,
+  kInlinedPolymorphicCall,
+  kNotInlinedNoTarget,
+  kNotInlinedTooBig,
+  kNotInlinedColdCallSite,
+  kNotInlinedCodeGrowthBudget,
+  kNotInlinedOther,
   kInstructionSimplifications,
   kInstructionSimplificationsArch,
   kUnresolvedMethod,
@@ -43,6 +50,7 @@ enum MethodCompilationStat {
   kNotCompiledLargeMethodNoBranches,
   kNotCompiledMalformedOpcode,
   kNotCompiledNoCodegen,
+  kNotCompiledOsr,
   kNotCompiledPathological,
   kNotCompiledSpaceFilter,
   kNotCompiledUnhandledInstruction,
@@ -54,6 +62,12 @@ enum MethodCompilationStat {
   kRemovedCheckedCast,
   kRemovedDeadInstruction,
   kRemovedNullCheck,
+  kVectorizedLoop,
+  kPeeledLoop,
+  kUnrolledLoop,
+  kSchedulingCyclesSaved,
+  kSelectGenerated,
+  kInstructionSunk,
   kLastStat
 };
 
@@ -97,6 +111,13 @@ class OptimizingCompilerStats {
       case kCompiledBaseline : return "kCompiledBaseline";
       case kCompiledOptimized : return "kCompiledOptimized";
       case kInlinedInvoke : return "kInlinedInvoke";
+      case kInlinedMonomorphicCall : return "kInlinedMonomorphicCall";
+      case kInlinedPolymorphicCall : return "kInlinedPolymorphicCall";
+      case kNotInlinedNoTarget : return "kNotInlinedNoTarget";
+      case kNotInlinedTooBig : return "kNotInlinedTooBig";
+      case kNotInlinedColdCallSite : return "kNotInlinedColdCallSite";
+      case kNotInlinedCodeGrowthBudget : return "kNotInlinedCodeGrowthBudget";
+      case kNotInlinedOther : return "kNotInlinedOther";
       case kInstructionSimplifications: return "kInstructionSimplifications";
       case kInstructionSimplificationsArch: return "kInstructionSimplificationsArch";
       case kUnresolvedMethod : return "kUnresolvedMethod";
@@ -110,6 +131,7 @@ class OptimizingCompilerStats {
       case kNotCompiledLargeMethodNoBranches : return "kNotCompiledLargeMethodNoBranches";
       case kNotCompiledMalformedOpcode : return "kNotCompiledMalformedOpcode";
       case kNotCompiledNoCodegen : return "kNotCompiledNoCodegen";
+      case kNotCompiledOsr : return "kNotCompiledOsr";
       case kNotCompiledPathological : return "kNotCompiledPathological";
       case kNotCompiledSpaceFilter : return "kNotCompiledSpaceFilter";
       case kNotCompiledUnhandledInstruction : return "kNotCompiledUnhandledInstruction";
@@ -121,6 +143,12 @@ class OptimizingCompilerStats {
       case kRemovedCheckedCast: return "kRemovedCheckedCast";
       case kRemovedDeadInstruction: return "kRemovedDeadInstruction";
       case kRemovedNullCheck: return "kRemovedNullCheck";
+      case kVectorizedLoop: return "kVectorizedLoop";
+      case kPeeledLoop: return "kPeeledLoop";
+      case kUnrolledLoop: return "kUnrolledLoop";
+      case kSchedulingCyclesSaved: return "kSchedulingCyclesSaved";
+      case kSelectGenerated: return "kSelectGenerated";
+      case kInstructionSunk: return "kInstructionSunk";
 
       case kLastStat: break;  // Invalid to print out.
     }
@@ -0,0 +1,1513 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register_allocator_graph_color.h"
+
+#include <algorithm>
+#include <bitset>
+#include <limits>
+
+#include "code_generator.h"
+#include "register_allocation_resolver.h"
+#include "ssa_liveness_analysis.h"
+
+namespace art {
+
+// Highest number of registers of one kind on any supported instruction set.
+static constexpr size_t kMaxNumRegs = 32;
+
+// Number of coloring rounds after which a debug build assumes that splitting
+// the spilled intervals does not make progress.
+static constexpr size_t kMaxGraphColoringAttemptsDebug = 100;
+
+// Code in a loop is assumed to run this many times more often than the code
+// around the loop, when weighing spill costs and moves.
+static constexpr float kLoopFrequencyMultiplier = 10.0f;
+static constexpr size_t kMaxWeightedLoopDepth = 8;
+
+static constexpr size_t kDefaultNumberOfSpillSlots = 4;
+
+typedef std::bitset<kMaxNumRegs> RegisterBits;
+
+// Returns the key of the edge between the nodes with ids `a` and `b`.
+static std::pair<size_t, size_t> EdgeKey(size_t a, size_t b) {
+  return (a < b) ? std::make_pair(a, b) : std::make_pair(b, a);
+}
+
+// Estimates how often the code at `position` runs, from the loop depth of its block.
+static float FrequencyAt(const SsaLivenessAnalysis& liveness, size_t position) {
+  HBasicBlock* block = liveness.GetBlockFromPosition(position / 2);
+  float frequency = 1.0f;
+  size_t depth = 0;
+  for (HLoopInformationOutwardIterator it(*block);
+       !it.Done() && depth < kMaxWeightedLoopDepth;
+       it.Advance(), ++depth) {
+    frequency *= kLoopFrequencyMultiplier;
+  }
+  return frequency;
+}
+
+// Returns the cost of the loads and stores needed if `interval` is spilled:
+// one at its definition and one per use, weighted by how often they run.
+static float ComputeSpillCost(LiveInterval* interval, const SsaLivenessAnalysis& liveness) {
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+  float cost = 0.0f;
+  if (interval->IsParent() && interval->GetDefinedBy() != nullptr) {
+    cost += FrequencyAt(liveness, start);
+  }
+  for (UsePosition* use = interval->GetFirstUse();
+       use != nullptr && use->GetPosition() <= end;
+       use = use->GetNext()) {
+    if (use->GetPosition() > start) {
+      cost += FrequencyAt(liveness, use->GetPosition());
+    }
+  }
+  return cost;
+}
+
+// Appends to `windows` the ranges of lifetime positions where `interval` needs
+// a register: after its definition if that requires a register, and from the
+// end of the previous instruction to each register use, where a reload would
+// go. Ranges that overlap or touch are merged.
+static void ComputeRegisterWindows(LiveInterval* interval,
+                                   ArenaVector<std::pair<size_t, size_t>>* windows) {
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+  for (size_t use = interval->FirstRegisterUse();
+       use != kNoLifetime;
+       use = interval->FirstRegisterUseAfter(use == start ? use + 1 : use)) {
+    size_t window_start = (use == start) ? start : use - 1;
+    size_t window_end = std::min(use + 1, end);
+    if (!windows->empty() && window_start <= windows->back().second) {
+      windows->back().second = std::max(windows->back().second, window_end);
+    } else {
+      windows->push_back(std::make_pair(window_start, window_end));
+    }
+  }
+}
+
+// Returns whether `output`, the interval of an instruction, can take the register
+// of `input`, the piece of one of its inputs live at the instruction, because
+// the input dies there. This mirrors the reuse of input registers in linear scan.
+static bool CanShareRegisterWithInput(LiveInterval* output, LiveInterval* input) {
+  HInstruction* defined_by = output->GetDefinedBy();
+  if (defined_by == nullptr
+      || output->IsSplit()
+      || output->HasHighInterval()
+      || input->HasHighInterval()
+      || output->GetStart() != defined_by->GetLifetimePosition()) {
+    return false;
+  }
+  LocationSummary* locations = defined_by->GetLocations();
+  if (locations->OutputCanOverlapWithInputs() || !locations->Out().IsUnallocated()) {
+    return false;
+  }
+  size_t position = defined_by->GetLifetimePosition();
+  if (!input->CoversSlow(position) || input->CoversSlow(position + 1)) {
+    return false;
+  }
+  for (size_t i = 0, e = defined_by->InputCount(); i < e; ++i) {
+    if (locations->InAt(i).IsValid()
+        && defined_by->InputAt(i)->GetLiveInterval() == input->GetParent()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+class InterferenceNode;
+
+// A move between the values of two nodes, which goes away if both nodes get
+// the same register.
+struct CoalesceOpportunity : public ArenaObject<kArenaAllocRegisterAllocator> {
+  enum class Stage {
+    kWorklist,  // Waiting to be coalesced.
+    kActive,    // Not coalesced for now, as that could make the graph uncolorable.
+    kDefunct,   // Coalesced, frozen, constrained, or only a hint for the color of a node.
+  };
+
+  CoalesceOpportunity(InterferenceNode* a, InterferenceNode* b, float move_frequency)
+      : node_a(a), node_b(b), frequency(move_frequency), stage(Stage::kWorklist) {}
+
+  InterferenceNode* const node_a;
+  InterferenceNode* const node_b;
+  // How often the move would run.
+  const float frequency;
+  Stage stage;
+};
+
+enum class NodeStage {
+  kInitial,
+  kPrecolored,        // Has a fixed register, and is never pruned.
+  kSimplifyWorklist,  // Can be pruned.
+  kFreezeWorklist,    // Can be pruned once its moves are given up.
+  kSpillWorklist,     // May not get a register.
+  kPruned,            // On the stack of nodes to color.
+  kCoalesced,         // Merged into another node.
+};
+
+/**
+ * A node of the interference graph, for a live interval. Pairs of registers are
+ * represented by a single node for the low interval, colored with an even
+ * register whose successor goes to the high interval.
+ *
+ * Pre-colored nodes keep no edges. The registers of the pre-colored nodes a node
+ * interferes with are instead removed from the colors it can take.
+ */
+class InterferenceNode : public ArenaObject<kArenaAllocRegisterAllocator> {
+ public:
+  InterferenceNode(ArenaAllocator* allocator,
+                   LiveInterval* interval,
+                   size_t id,
+                   bool is_precolored)
+      : interval_(interval),
+        id_(id),
+        stage_(is_precolored ? NodeStage::kPrecolored : NodeStage::kInitial),
+        adjacent_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        coalesce_opportunities_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        degree_(0),
+        alias_(this),
+        color_(is_precolored ? interval->GetRegister() : kNoRegister),
+        requires_register_(false),
+        spill_cost_(0.0f) {}
+
+  LiveInterval* GetInterval() const { return interval_; }
+  size_t GetId() const { return id_; }
+
+  NodeStage GetStage() const { return stage_; }
+  void SetStage(NodeStage stage) { stage_ = stage; }
+  bool IsPrecolored() const { return stage_ == NodeStage::kPrecolored; }
+
+  bool IsPair() const { return interval_->HasHighInterval(); }
+  size_t GetWidth() const { return IsPair() ? 2u : 1u; }
+
+  // The registers occupied by this node, once it has a color.
+  RegisterBits GetRegisters() const {
+    DCHECK(HasColor());
+    RegisterBits registers;
+    registers.set(color_);
+    if (IsPair()) {
+      registers.set(IsPrecolored() ? interval_->GetHighInterval()->GetRegister() : color_ + 1);
+    }
+    return registers;
+  }
+
+  const ArenaVector<InterferenceNode*>& GetAdjacentNodes() const { return adjacent_nodes_; }
+  void AddAdjacentNode(InterferenceNode* node) { adjacent_nodes_.push_back(node); }
+
+  const ArenaVector<CoalesceOpportunity*>& GetCoalesceOpportunities() const {
+    return coalesce_opportunities_;
+  }
+  void AddCoalesceOpportunity(CoalesceOpportunity* opportunity) {
+    coalesce_opportunities_.push_back(opportunity);
+  }
+
+  // The registers taken by pre-colored nodes live at the same time as this one.
+  const RegisterBits& GetConflictingRegisters() const { return conflicting_registers_; }
+  void AddConflictingRegisters(const RegisterBits& registers) {
+    conflicting_registers_ |= registers;
+  }
+
+  size_t GetDegree() const { return degree_; }
+  void IncreaseDegree(size_t amount) { degree_ += amount; }
+  void DecreaseDegree(size_t amount) {
+    DCHECK_GE(degree_, amount);
+    degree_ -= amount;
+  }
+
+  InterferenceNode* GetAlias() {
+    InterferenceNode* alias = this;
+    while (alias->alias_ != alias) {
+      alias = alias->alias_;
+    }
+    return alias;
+  }
+
+  int GetColor() const { return color_; }
+  bool HasColor() const { return color_ != kNoRegister; }
+  void SetColor(int color) { color_ = color; }
+  void ClearColor() { color_ = kNoRegister; }
+
+  // Nodes that need a register for all their lifetime are never spilled. They
+  // take a register from a neighbor if they cannot be colored otherwise.
+  bool RequiresRegister() const { return requires_register_; }
+  void SetRequiresRegister() { requires_register_ = true; }
+
+  float GetSpillCost() const { return spill_cost_; }
+  void SetSpillCost(float cost) { spill_cost_ = cost; }
+
+  // Merge `other` into this node, which must not interfere with it.
+  void Coalesce(InterferenceNode* other) {
+    DCHECK_EQ(GetWidth(), other->GetWidth());
+    other->alias_ = this;
+    other->stage_ = NodeStage::kCoalesced;
+    conflicting_registers_ |= other->conflicting_registers_;
+    requires_register_ = requires_register_ || other->requires_register_;
+    spill_cost_ += other->spill_cost_;
+    coalesce_opportunities_.insert(coalesce_opportunities_.end(),
+                                   other->coalesce_opportunities_.begin(),
+                                   other->coalesce_opportunities_.end());
+  }
+
+ private:
+  LiveInterval* const interval_;
+  // Index of the node, ordering the nodes deterministically.
+  const size_t id_;
+  NodeStage stage_;
+  ArenaVector<InterferenceNode*> adjacent_nodes_;
+  ArenaVector<CoalesceOpportunity*> coalesce_opportunities_;
+  RegisterBits conflicting_registers_;
+  // The number of colors the nodes adjacent to this one, and not pruned yet, may take
+  // from it. See ColoringIteration::EdgeWeight.
+  size_t degree_;
+  InterferenceNode* alias_;
+  int color_;
+  bool requires_register_;
+  float spill_cost_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterferenceNode);
+};
+
+/**
+ * One round of graph coloring for a register kind: builds the interference graph
+ * of the given intervals, prunes it while coalescing moves, and colors the nodes
+ * in reverse pruning order. All the data of the round lives in its own arena.
+ */
+class ColoringIteration : public ValueObject {
+ public:
+  ColoringIteration(ArenaAllocator* allocator,
+                    CodeGenerator* codegen,
+                    const SsaLivenessAnalysis& liveness,
+                    bool processing_core_registers)
+      : allocator_(allocator),
+        codegen_(codegen),
+        liveness_(liveness),
+        number_of_registers_(processing_core_registers
+                                 ? codegen->GetNumberOfCoreRegisters()
+                                 : codegen->GetNumberOfFloatingPointRegisters()),
+        processing_core_registers_(processing_core_registers),
+        nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        precolored_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        physical_register_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        interval_nodes_(std::less<LiveInterval*>(),
+                        allocator->Adapter(kArenaAllocRegisterAllocator)),
+        edges_(std::less<std::pair<size_t, size_t>>(),
+               allocator->Adapter(kArenaAllocRegisterAllocator)),
+        coalesce_worklist_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        simplify_worklist_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        freeze_worklist_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        spill_worklist_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        pruned_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)) {
+    DCHECK_LE(number_of_registers_, kMaxNumRegs);
+    const bool* blocked = processing_core_registers
+        ? codegen->GetBlockedCoreRegisters()
+        : codegen->GetBlockedFloatingPointRegisters();
+    for (size_t reg = 0; reg < number_of_registers_; ++reg) {
+      if (blocked[reg]) {
+        blocked_registers_.set(reg);
+      }
+    }
+    physical_register_nodes_.resize(number_of_registers_, nullptr);
+  }
+
+  // Creates the nodes for `intervals`, the pre-colored nodes for the pieces with a
+  // fixed register and for the physical registers, and the edges between them.
+  void BuildInterferenceGraph(const ArenaVector<LiveInterval*>& intervals,
+                              const ArenaVector<LiveInterval*>& fixed_intervals,
+                              const ArenaVector<LiveInterval*>& physical_register_intervals);
+
+  // Records the moves that coloring two nodes alike would remove.
+  void FindCoalesceOpportunities();
+
+  // Removes the nodes from the graph one by one, coalescing the nodes of moves along
+  // the way, and pushes them on the stack of nodes to color.
+  void PruneInterferenceGraph();
+
+  // Colors the nodes requiring a register in linear order, then the others in reverse
+  // pruning order. Returns whether all of them got a register, in which case the
+  // registers are set on their intervals. Otherwise, the intervals of the nodes that
+  // did not are appended to `spilled_intervals`.
+  bool ColorInterferenceGraph(ArenaVector<LiveInterval*>* spilled_intervals);
+
+ private:
+  InterferenceNode* FindNode(LiveInterval* interval) const {
+    if (interval == nullptr) {
+      return nullptr;
+    }
+    auto it = interval_nodes_.find(interval);
+    return (it != interval_nodes_.end()) ? it->second : nullptr;
+  }
+
+  void AddInterference(InterferenceNode* a, InterferenceNode* b);
+  bool Interferes(InterferenceNode* a, InterferenceNode* b) const {
+    return edges_.find(EdgeKey(a->GetId(), b->GetId())) != edges_.end();
+  }
+
+  // Returns how many colors `from` takes from `to` when they interfere: a pair of
+  // registers takes two registers from a single register node, and any node takes
+  // at most one aligned pair from a pair node.
+  static size_t EdgeWeight(const InterferenceNode* from, const InterferenceNode* to) {
+    return to->IsPair() ? 1u : from->GetWidth();
+  }
+
+  // Returns whether `color` is valid for a node of the given width, with the
+  // registers in `taken` unavailable.
+  bool IsAvailable(int color, size_t width, const RegisterBits& taken) const {
+    if (width == 2) {
+      return (color % 2 == 0)
+          && (static_cast<size_t>(color) + 1 < number_of_registers_)
+          && !taken.test(color)
+          && !taken.test(color + 1);
+    }
+    return !taken.test(color);
+  }
+
+  // Returns the number of colors a node of the given width can take, excluding the
+  // registers blocked by the code generator and `conflicts`.
+  size_t ComputeCapacity(size_t width, const RegisterBits& conflicts) const;
+
+  bool IsLowDegree(InterferenceNode* node) const {
+    return node->GetDegree() < ComputeCapacity(node->GetWidth(), node->GetConflictingRegisters());
+  }
+
+  bool IsCalleeSaveRegister(int reg) const {
+    return processing_core_registers_
+        ? codegen_->IsCoreCalleeSaveRegister(reg)
+        : codegen_->IsFloatingPointCalleeSaveRegister(reg);
+  }
+
+  void CreateCoalesceOpportunity(InterferenceNode* a, InterferenceNode* b, size_t position);
+  bool IsMoveRelated(InterferenceNode* node) const;
+  void EnableCoalesceOpportunities(InterferenceNode* node);
+  void DecrementDegree(InterferenceNode* node, size_t amount);
+  void PushToSimplifyWorklistIfPossible(InterferenceNode* node);
+
+  void Simplify();
+  void Coalesce();
+  void Freeze();
+  void SelectSpill();
+  bool CanCoalesceConservatively(InterferenceNode* u, InterferenceNode* v) const;
+  void Combine(InterferenceNode* u, InterferenceNode* v);
+  void FreezeMoves(InterferenceNode* node);
+
+  // Returns the color to give `node`, or kNoRegister if all are taken.
+  int FindColor(InterferenceNode* node, const RegisterBits& taken) const;
+
+  // Pop the nodes at the front of `worklist` which moved to another stage.
+  static void DropStaleNodes(ArenaDeque<InterferenceNode*>* worklist, NodeStage stage) {
+    while (!worklist->empty() && worklist->front()->GetStage() != stage) {
+      worklist->pop_front();
+    }
+  }
+
+  ArenaAllocator* const allocator_;
+  CodeGenerator* const codegen_;
+  const SsaLivenessAnalysis& liveness_;
+  const size_t number_of_registers_;
+  const bool processing_core_registers_;
+  RegisterBits blocked_registers_;
+
+  ArenaVector<InterferenceNode*> nodes_;
+  ArenaVector<InterferenceNode*> precolored_nodes_;
+  ArenaVector<InterferenceNode*> physical_register_nodes_;
+  ArenaSafeMap<LiveInterval*, InterferenceNode*> interval_nodes_;
+  // Pairs of ids of the nodes that interfere, smallest id first.
+  ArenaSet<std::pair<size_t, size_t>> edges_;
+
+  // The worklists of iterated register coalescing. Nodes changing stage stay in
+  // the deques until they are popped, and are skipped then.
+  ArenaDeque<CoalesceOpportunity*> coalesce_worklist_;
+  ArenaDeque<InterferenceNode*> simplify_worklist_;
+  ArenaDeque<InterferenceNode*> freeze_worklist_;
+  ArenaVector<InterferenceNode*> spill_worklist_;
+  ArenaVector<InterferenceNode*> pruned_nodes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ColoringIteration);
+};
+
+void ColoringIteration::BuildInterferenceGraph(
+    const ArenaVector<LiveInterval*>& intervals,
+    const ArenaVector<LiveInterval*>& fixed_intervals,
+    const ArenaVector<LiveInterval*>& physical_register_intervals) {
+  size_t next_id = 0;
+  for (LiveInterval* interval : intervals) {
+    DCHECK(!interval->HasRegister());
+    InterferenceNode* node =
+        new (allocator_) InterferenceNode(allocator_, interval, next_id++, false);
+    node->SetSpillCost(ComputeSpillCost(interval, liveness_));
+    ArenaVector<std::pair<size_t, size_t>> windows(
+        allocator_->Adapter(kArenaAllocRegisterAllocator));
+    ComputeRegisterWindows(interval, &windows);
+    if (windows.size() == 1u
+        && windows[0].first == interval->GetStart()
+        && windows[0].second == interval->GetEnd()) {
+      node->SetRequiresRegister();
+    }
+    nodes_.push_back(node);
+    interval_nodes_.Put(interval, node);
+  }
+  for (LiveInterval* interval : fixed_intervals) {
+    InterferenceNode* node =
+        new (allocator_) InterferenceNode(allocator_, interval, next_id++, true);
+    precolored_nodes_.push_back(node);
+    interval_nodes_.Put(interval, node);
+  }
+  for (LiveInterval* interval : physical_register_intervals) {
+    if (interval != nullptr) {
+      InterferenceNode* node =
+          new (allocator_) InterferenceNode(allocator_, interval, next_id++, true);
+      precolored_nodes_.push_back(node);
+      physical_register_nodes_[interval->GetRegister()] = node;
+    }
+  }
+
+  // Sweep the live ranges of all nodes by increasing start. A range interferes
+  // with the ranges still live at its start.
+  typedef std::pair<LiveRange*, InterferenceNode*> NodeRange;
+  ArenaVector<NodeRange> ranges(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (const ArenaVector<InterferenceNode*>* node_list : { &nodes_, &precolored_nodes_ }) {
+    for (InterferenceNode* node : *node_list) {
+      for (LiveRange* range = node->GetInterval()->GetFirstRange();
+           range != nullptr;
+           range = range->GetNext()) {
+        ranges.push_back(std::make_pair(range, node));
+      }
+    }
+  }
+  std::sort(ranges.begin(), ranges.end(), [](const NodeRange& lhs, const NodeRange& rhs) {
+    return (lhs.first->GetStart() != rhs.first->GetStart())
+        ? lhs.first->GetStart() < rhs.first->GetStart()
+        : lhs.second->GetId() < rhs.second->GetId();
+  });
+
+  ArenaVector<NodeRange> live(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (const NodeRange& range : ranges) {
+    size_t start = range.first->GetStart();
+    live.erase(std::remove_if(live.begin(), live.end(), [start](const NodeRange& other) {
+                 return other.first->GetEnd() <= start;
+               }),
+               live.end());
+    for (const NodeRange& other : live) {
+      AddInterference(other.second, range.second);
+    }
+    live.push_back(range);
+  }
+}
+
+void ColoringIteration::AddInterference(InterferenceNode* a, InterferenceNode* b) {
+  if (a == b || (a->IsPrecolored() && b->IsPrecolored())) {
+    return;
+  }
+  if (a->IsPrecolored() || b->IsPrecolored()) {
+    InterferenceNode* precolored = a->IsPrecolored() ? a : b;
+    InterferenceNode* other = a->IsPrecolored() ? b : a;
+    other->AddConflictingRegisters(precolored->GetRegisters());
+    return;
+  }
+  if (CanShareRegisterWithInput(a->GetInterval(), b->GetInterval())
+      || CanShareRegisterWithInput(b->GetInterval(), a->GetInterval())) {
+    return;
+  }
+  if (edges_.insert(EdgeKey(a->GetId(), b->GetId())).second) {
+    a->AddAdjacentNode(b);
+    b->AddAdjacentNode(a);
+    a->IncreaseDegree(EdgeWeight(b, a));
+    b->IncreaseDegree(EdgeWeight(a, b));
+  }
+}
+
+size_t ColoringIteration::ComputeCapacity(size_t width, const RegisterBits& conflicts) const {
+  RegisterBits taken = blocked_registers_ | conflicts;
+  size_t capacity = 0;
+  for (size_t reg = 0; reg < number_of_registers_; reg += width) {
+    if (IsAvailable(reg, width, taken)) {
+      ++capacity;
+    }
+  }
+  return capacity;
+}
+
+void ColoringIteration::CreateCoalesceOpportunity(InterferenceNode* a,
+                                                  InterferenceNode* b,
+                                                  size_t position) {
+  if (a == nullptr || b == nullptr || a == b || (a->IsPrecolored() && b->IsPrecolored())) {
+    return;
+  }
+  CoalesceOpportunity* opportunity =
+      new (allocator_) CoalesceOpportunity(a, b, FrequencyAt(liveness_, position));
+  if (a->IsPrecolored()
+      || b->IsPrecolored()
+      || a->GetWidth() != b->GetWidth()
+      || a->RequiresRegister()
+      || b->RequiresRegister()) {
+    // The nodes are not merged: a pre-colored node has no edges to check, and a
+    // node that requires a register must stay small to always find one. The move
+    // still biases the color of the other node.
+    opportunity->stage = CoalesceOpportunity::Stage::kDefunct;
+  } else {
+    coalesce_worklist_.push_back(opportunity);
+  }
+  if (!a->IsPrecolored()) {
+    a->AddCoalesceOpportunity(opportunity);
+  }
+  if (!b->IsPrecolored()) {
+    b->AddCoalesceOpportunity(opportunity);
+  }
+}
+
+void ColoringIteration::FindCoalesceOpportunities() {
+  for (const ArenaVector<InterferenceNode*>* node_list : { &nodes_, &precolored_nodes_ }) {
+    for (InterferenceNode* node : *node_list) {
+      LiveInterval* interval = node->GetInterval();
+      // Moves between adjacent siblings.
+      LiveInterval* next_sibling = interval->GetNextSibling();
+      if (next_sibling != nullptr && next_sibling->GetStart() == interval->GetEnd()) {
+        CreateCoalesceOpportunity(node, FindNode(next_sibling), interval->GetEnd());
+      }
+      if (node->IsPrecolored()) {
+        continue;
+      }
+
+      // Moves at the definition of the value.
+      HInstruction* defined_by = interval->GetDefinedBy();
+      if (interval->IsParent() && defined_by != nullptr) {
+        if (defined_by->IsPhi()) {
+          if (!defined_by->AsPhi()->IsCatchPhi()) {
+            const ArenaVector<HBasicBlock*>& predecessors =
+                defined_by->GetBlock()->GetPredecessors();
+            for (size_t i = 0, e = defined_by->InputCount(); i < e; ++i) {
+              size_t position = predecessors[i]->GetLifetimeEnd() - 1;
+              LiveInterval* input = defined_by->InputAt(i)->GetLiveInterval();
+              CreateCoalesceOpportunity(node, FindNode(input->GetSiblingAt(position)), position);
+            }
+          }
+        } else {
+          size_t position = defined_by->GetLifetimePosition();
+          LocationSummary* locations = defined_by->GetLocations();
+          Location out = locations->Out();
+          LiveInterval* first_input = (defined_by->InputCount() != 0)
+              ? defined_by->InputAt(0)->GetLiveInterval()
+              : nullptr;
+          if (out.IsUnallocated()
+              && out.GetPolicy() == Location::kSameAsFirstInput
+              && first_input != nullptr) {
+            CreateCoalesceOpportunity(
+                node, FindNode(first_input->GetSiblingAt(position - 1)), position);
+          }
+          for (size_t i = 0, e = defined_by->InputCount(); i < e; ++i) {
+            LiveInterval* input = defined_by->InputAt(i)->GetLiveInterval();
+            if (input == nullptr) {
+              continue;
+            }
+            input = input->GetSiblingAt(position);
+            if (input != nullptr && CanShareRegisterWithInput(interval, input)) {
+              CreateCoalesceOpportunity(node, FindNode(input), position);
+            }
+          }
+        }
+      }
+
+      // Inputs expected in a fixed register.
+      size_t start = interval->GetStart();
+      size_t end = interval->GetEnd();
+      for (UsePosition* use = interval->GetFirstUse();
+           use != nullptr && use->GetPosition() <= end;
+           use = use->GetNext()) {
+        if (use->GetPosition() <= start || use->IsSynthesized() || use->GetUser()->IsPhi()) {
+          continue;
+        }
+        Location input = use->GetUser()->GetLocations()->InAt(use->GetInputIndex());
+        if (input.IsRegister() || input.IsFpuRegister()) {
+          CreateCoalesceOpportunity(
+              node, physical_register_nodes_[input.reg()], use->GetPosition());
+        } else if (input.IsPair()) {
+          CreateCoalesceOpportunity(
+              node, physical_register_nodes_[input.low()], use->GetPosition());
+        }
+      }
+    }
+  }
+
+  // Coalesce the most frequent moves first.
+  std::stable_sort(coalesce_worklist_.begin(),
+                   coalesce_worklist_.end(),
+                   [](const CoalesceOpportunity* lhs, const CoalesceOpportunity* rhs) {
+                     return lhs->frequency > rhs->frequency;
+                   });
+}
+
+bool ColoringIteration::IsMoveRelated(InterferenceNode* node) const {
+  for (CoalesceOpportunity* opportunity : node->GetCoalesceOpportunities()) {
+    if (opportunity->stage == CoalesceOpportunity::Stage::kWorklist
+        || opportunity->stage == CoalesceOpportunity::Stage::kActive) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ColoringIteration::EnableCoalesceOpportunities(InterferenceNode* node) {
+  for (CoalesceOpportunity* opportunity : node->GetCoalesceOpportunities()) {
+    if (opportunity->stage == CoalesceOpportunity::Stage::kActive) {
+      opportunity->stage = CoalesceOpportunity::Stage::kWorklist;
+      coalesce_worklist_.push_back(opportunity);
+    }
+  }
+}
+
+void ColoringIteration::DecrementDegree(InterferenceNode* node, size_t amount) {
+  bool was_high_degree = !IsLowDegree(node);
+  node->DecreaseDegree(amount);
+  if (was_high_degree && IsLowDegree(node)) {
+    // The node and its neighbors may now be coalesced conservatively.
+    EnableCoalesceOpportunities(node);
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      if (adjacent->GetStage() != NodeStage::kPruned
+          && adjacent->GetStage() != NodeStage::kCoalesced) {
+        EnableCoalesceOpportunities(adjacent);
+      }
+    }
+    if (node->GetStage() == NodeStage::kSpillWorklist) {
+      if (IsMoveRelated(node)) {
+        node->SetStage(NodeStage::kFreezeWorklist);
+        freeze_worklist_.push_back(node);
+      } else {
+        node->SetStage(NodeStage::kSimplifyWorklist);
+        simplify_worklist_.push_back(node);
+      }
+    }
+  }
+}
+
+void ColoringIteration::PushToSimplifyWorklistIfPossible(InterferenceNode* node) {
+  if (node->GetStage() == NodeStage::kFreezeWorklist
+      && !IsMoveRelated(node)
+      && IsLowDegree(node)) {
+    node->SetStage(NodeStage::kSimplifyWorklist);
+    simplify_worklist_.push_back(node);
+  }
+}
+
+void ColoringIteration::PruneInterferenceGraph() {
+  for (InterferenceNode* node : nodes_) {
+    if (!IsLowDegree(node)) {
+      node->SetStage(NodeStage::kSpillWorklist);
+      spill_worklist_.push_back(node);
+    } else if (IsMoveRelated(node)) {
+      node->SetStage(NodeStage::kFreezeWorklist);
+      freeze_worklist_.push_back(node);
+    } else {
+      node->SetStage(NodeStage::kSimplifyWorklist);
+      simplify_worklist_.push_back(node);
+    }
+  }
+
+  while (true) {
+    DropStaleNodes(&simplify_worklist_, NodeStage::kSimplifyWorklist);
+    DropStaleNodes(&freeze_worklist_, NodeStage::kFreezeWorklist);
+    while (!coalesce_worklist_.empty()
+           && coalesce_worklist_.front()->stage != CoalesceOpportunity::Stage::kWorklist) {
+      coalesce_worklist_.pop_front();
+    }
+    if (!simplify_worklist_.empty()) {
+      Simplify();
+    } else if (!coalesce_worklist_.empty()) {
+      Coalesce();
+    } else if (!freeze_worklist_.empty()) {
+      Freeze();
+    } else {
+      spill_worklist_.erase(
+          std::remove_if(spill_worklist_.begin(), spill_worklist_.end(), [](InterferenceNode* n) {
+            return n->GetStage() != NodeStage::kSpillWorklist;
+          }),
+          spill_worklist_.end());
+      if (spill_worklist_.empty()) {
+        break;
+      }
+      SelectSpill();
+    }
+  }
+}
+
+void ColoringIteration::Simplify() {
+  InterferenceNode* node = simplify_worklist_.front();
+  simplify_worklist_.pop_front();
+  node->SetStage(NodeStage::kPruned);
+  pruned_nodes_.push_back(node);
+  for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+    if (adjacent->GetStage() != NodeStage::kPruned
+        && adjacent->GetStage() != NodeStage::kCoalesced) {
+      DecrementDegree(adjacent, EdgeWeight(node, adjacent));
+    }
+  }
+}
+
+bool ColoringIteration::CanCoalesceConservatively(InterferenceNode* u,
+                                                  InterferenceNode* v) const {
+  // Briggs' test: the merged node can be pruned if it has fewer neighbors of
+  // high degree than colors. Neighbors of both nodes are counted twice, which
+  // only makes the test more conservative.
+  RegisterBits conflicts = u->GetConflictingRegisters() | v->GetConflictingRegisters();
+  size_t capacity = ComputeCapacity(u->GetWidth(), conflicts);
+  size_t high_degree_weight = 0;
+  for (InterferenceNode* node : { u, v }) {
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      if (adjacent->GetStage() != NodeStage::kPruned
+          && adjacent->GetStage() != NodeStage::kCoalesced
+          && !IsLowDegree(adjacent)) {
+        high_degree_weight += EdgeWeight(adjacent, u);
+      }
+    }
+  }
+  return high_degree_weight < capacity;
+}
+
+void ColoringIteration::Combine(InterferenceNode* u, InterferenceNode* v) {
+  u->Coalesce(v);
+  EnableCoalesceOpportunities(v);
+  for (InterferenceNode* adjacent : v->GetAdjacentNodes()) {
+    if (adjacent->GetStage() == NodeStage::kPruned
+        || adjacent->GetStage() == NodeStage::kCoalesced) {
+      continue;
+    }
+    if (edges_.insert(EdgeKey(adjacent->GetId(), u->GetId())).second) {
+      adjacent->AddAdjacentNode(u);
+      u->AddAdjacentNode(adjacent);
+      adjacent->IncreaseDegree(EdgeWeight(u, adjacent));
+      u->IncreaseDegree(EdgeWeight(adjacent, u));
+    }
+    DecrementDegree(adjacent, EdgeWeight(v, adjacent));
+  }
+  if (u->GetStage() == NodeStage::kFreezeWorklist && !IsLowDegree(u)) {
+    u->SetStage(NodeStage::kSpillWorklist);
+    spill_worklist_.push_back(u);
+  }
+}
+
+void ColoringIteration::Coalesce() {
+  CoalesceOpportunity* opportunity = coalesce_worklist_.front();
+  coalesce_worklist_.pop_front();
+  InterferenceNode* u = opportunity->node_a->GetAlias();
+  InterferenceNode* v = opportunity->node_b->GetAlias();
+  if (u->GetId() > v->GetId()) {
+    std::swap(u, v);
+  }
+  if (u == v) {
+    opportunity->stage = CoalesceOpportunity::Stage::kDefunct;
+    PushToSimplifyWorklistIfPossible(u);
+  } else if (Interferes(u, v)) {
+    opportunity->stage = CoalesceOpportunity::Stage::kDefunct;
+    PushToSimplifyWorklistIfPossible(u);
+    PushToSimplifyWorklistIfPossible(v);
+  } else if (CanCoalesceConservatively(u, v)) {
+    opportunity->stage = CoalesceOpportunity::Stage::kDefunct;
+    Combine(u, v);
+    PushToSimplifyWorklistIfPossible(u);
+  } else {
+    opportunity->stage = CoalesceOpportunity::Stage::kActive;
+  }
+}
+
+void ColoringIteration::FreezeMoves(InterferenceNode* node) {
+  for (CoalesceOpportunity* opportunity : node->GetCoalesceOpportunities()) {
+    if (opportunity->stage != CoalesceOpportunity::Stage::kWorklist
+        && opportunity->stage != CoalesceOpportunity::Stage::kActive) {
+      continue;
+    }
+    opportunity->stage = CoalesceOpportunity::Stage::kDefunct;
+    InterferenceNode* other = opportunity->node_a->GetAlias();
+    if (other == node->GetAlias()) {
+      other = opportunity->node_b->GetAlias();
+    }
+    PushToSimplifyWorklistIfPossible(other);
+  }
+}
+
+void ColoringIteration::Freeze() {
+  InterferenceNode* node = freeze_worklist_.front();
+  freeze_worklist_.pop_front();
+  node->SetStage(NodeStage::kSimplifyWorklist);
+  simplify_worklist_.push_back(node);
+  FreezeMoves(node);
+}
+
+void ColoringIteration::SelectSpill() {
+  // Pick the node with the lowest spill cost per interference. Nodes requiring
+  // a register are picked last: they may still get one when colored.
+  auto spill_weight = [](InterferenceNode* node) {
+    return node->RequiresRegister()
+        ? std::numeric_limits<float>::max()
+        : node->GetSpillCost() / (node->GetDegree() + 1);
+  };
+  auto it = std::min_element(spill_worklist_.begin(), spill_worklist_.end(),
+                             [&](InterferenceNode* lhs, InterferenceNode* rhs) {
+                               return spill_weight(lhs) < spill_weight(rhs);
+                             });
+  InterferenceNode* node = *it;
+  spill_worklist_.erase(it);
+  node->SetStage(NodeStage::kSimplifyWorklist);
+  simplify_worklist_.push_back(node);
+  FreezeMoves(node);
+}
+
+int ColoringIteration::FindColor(InterferenceNode* node, const RegisterBits& taken) const {
+  size_t width = node->GetWidth();
+
+  // Prefer the color of a node this one has a move with, to remove the move.
+  int best_color = kNoRegister;
+  float best_frequency = 0.0f;
+  for (CoalesceOpportunity* opportunity : node->GetCoalesceOpportunities()) {
+    InterferenceNode* other = opportunity->node_a->GetAlias();
+    if (other == node) {
+      other = opportunity->node_b->GetAlias();
+    }
+    if (other != node
+        && other->HasColor()
+        && IsAvailable(other->GetColor(), width, taken)
+        && (best_color == kNoRegister || opportunity->frequency > best_frequency)) {
+      best_color = other->GetColor();
+      best_frequency = opportunity->frequency;
+    }
+  }
+  if (best_color != kNoRegister) {
+    return best_color;
+  }
+
+  // Otherwise prefer caller-save registers, which the frame does not need to
+  // save. Nodes live across calls cannot take them anyway.
+  for (bool callee_save : { false, true }) {
+    for (size_t reg = 0; reg < number_of_registers_; reg += width) {
+      if (IsCalleeSaveRegister(reg) == callee_save && IsAvailable(reg, width, taken)) {
+        return reg;
+      }
+    }
+  }
+  return kNoRegister;
+}
+
+bool ColoringIteration::ColorInterferenceGraph(ArenaVector<LiveInterval*>* spilled_intervals) {
+  // Nodes requiring a register are not coalesced and cannot be spilled, so color them
+  // first, in linear order: they only cover the few positions around their register
+  // uses, and coloring such intervals by increasing start needs no more registers than
+  // are live at once. The locations of the instructions guarantee that these fit in the
+  // registers not blocked there, which is also what linear scan relies on.
+  auto required_begin = std::stable_partition(
+      pruned_nodes_.begin(), pruned_nodes_.end(), [](InterferenceNode* node) {
+        return !node->RequiresRegister();
+      });
+  std::stable_sort(required_begin, pruned_nodes_.end(),
+                   [](InterferenceNode* lhs, InterferenceNode* rhs) {
+                     return lhs->GetInterval()->GetStart() > rhs->GetInterval()->GetStart();
+                   });
+  while (!pruned_nodes_.empty()) {
+    InterferenceNode* node = pruned_nodes_.back();
+    pruned_nodes_.pop_back();
+    RegisterBits taken = blocked_registers_ | node->GetConflictingRegisters();
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      InterferenceNode* other = adjacent->GetAlias();
+      if (other->HasColor()) {
+        taken |= other->GetRegisters();
+      }
+    }
+    int color = FindColor(node, taken);
+    DCHECK(color != kNoRegister || !node->RequiresRegister())
+        << "No register available for interval starting at " << node->GetInterval()->GetStart();
+    if (color != kNoRegister) {
+      node->SetColor(color);
+    }
+  }
+
+  // Coalesced nodes take the color of the node they were merged into.
+  bool successful = true;
+  for (InterferenceNode* node : nodes_) {
+    if (!node->GetAlias()->HasColor()) {
+      spilled_intervals->push_back(node->GetInterval());
+      successful = false;
+    }
+  }
+  if (!successful) {
+    return false;
+  }
+
+  for (InterferenceNode* node : nodes_) {
+    int color = node->GetAlias()->GetColor();
+    LiveInterval* interval = node->GetInterval();
+    interval->SetRegister(color);
+    if (interval->HasHighInterval()) {
+      interval->GetHighInterval()->SetRegister(color + 1);
+    }
+  }
+  return true;
+}
+
+RegisterAllocatorGraphColor::RegisterAllocatorGraphColor(ArenaAllocator* allocator,
+                                                         CodeGenerator* codegen,
+                                                         const SsaLivenessAnalysis& liveness)
+    : RegisterAllocator(allocator, codegen, liveness),
+      core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      fixed_core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      fixed_fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      physical_core_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      physical_fp_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      temp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      int_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      long_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      float_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      double_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      catch_phi_spill_slots_(0),
+      safepoints_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      reserved_out_slots_(0),
+      max_safepoint_live_core_regs_(0),
+      max_safepoint_live_fp_regs_(0) {
+  temp_intervals_.reserve(4);
+  int_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  long_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  float_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  double_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+
+  static constexpr bool kIsBaseline = false;
+  codegen->SetupBlockedRegisters(kIsBaseline);
+  physical_core_register_intervals_.resize(codegen->GetNumberOfCoreRegisters(), nullptr);
+  physical_fp_register_intervals_.resize(codegen->GetNumberOfFloatingPointRegisters(), nullptr);
+  // Always reserve for the current method and the graph's max out registers.
+  // ArtMethod* takes 2 vregs for 64 bits.
+  reserved_out_slots_ = InstructionSetPointerSize(codegen->GetInstructionSet()) / kVRegSize +
+      codegen->GetGraph()->GetMaximumNumberOfOutVRegs();
+}
+
+void RegisterAllocatorGraphColor::AllocateRegisters() {
+  ProcessInstructions();
+  ColorIntervals(/* processing_core_registers */ true);
+  ColorIntervals(/* processing_core_registers */ false);
+  AllocateSpillSlots();
+  ComputeMaxSafepointLiveRegisters();
+
+  RegisterAllocationResolver(allocator_, codegen_, liveness_)
+      .Resolve(max_safepoint_live_core_regs_,
+               max_safepoint_live_fp_regs_,
+               reserved_out_slots_,
+               int_spill_slots_.size(),
+               long_spill_slots_.size(),
+               float_spill_slots_.size(),
+               double_spill_slots_.size(),
+               catch_phi_spill_slots_,
+               temp_intervals_);
+
+  if (kIsDebugBuild) {
+    Validate(/* log_fatal_on_failure */ true);
+  }
+}
+
+void RegisterAllocatorGraphColor::BlockRegister(Location location, size_t start, size_t end) {
+  int reg = location.reg();
+  DCHECK(location.IsRegister() || location.IsFpuRegister());
+  LiveInterval* interval = location.IsRegister()
+      ? physical_core_register_intervals_[reg]
+      : physical_fp_register_intervals_[reg];
+  Primitive::Type type = location.IsRegister()
+      ? Primitive::kPrimInt
+      : Primitive::kPrimFloat;
+  if (interval == nullptr) {
+    interval = LiveInterval::MakeFixedInterval(allocator_, reg, type);
+    if (location.IsRegister()) {
+      physical_core_register_intervals_[reg] = interval;
+    } else {
+      physical_fp_register_intervals_[reg] = interval;
+    }
+  }
+  DCHECK(interval->GetRegister() == reg);
+  interval->AddRange(start, end);
+}
+
+void RegisterAllocatorGraphColor::BlockRegisters(size_t start, size_t end, bool caller_save_only) {
+  for (size_t i = 0; i < codegen_->GetNumberOfCoreRegisters(); ++i) {
+    if (!caller_save_only || !codegen_->IsCoreCalleeSaveRegister(i)) {
+      BlockRegister(Location::RegisterLocation(i), start, end);
+    }
+  }
+  for (size_t i = 0; i < codegen_->GetNumberOfFloatingPointRegisters(); ++i) {
+    if (!caller_save_only || !codegen_->IsFloatingPointCalleeSaveRegister(i)) {
+      BlockRegister(Location::FpuRegisterLocation(i), start, end);
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::ProcessInstructions() {
+  // Iterate post-order, so that the ranges of the fixed intervals are added
+  // by decreasing positions.
+  for (HLinearPostOrderIterator it(*codegen_->GetGraph()); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HBackwardInstructionIterator back_it(block->GetInstructions()); !back_it.Done();
+         back_it.Advance()) {
+      ProcessInstruction(back_it.Current());
+    }
+    for (HInstructionIterator inst_it(block->GetPhis()); !inst_it.Done(); inst_it.Advance()) {
+      ProcessInstruction(inst_it.Current());
+    }
+
+    if (block->IsCatchBlock()) {
+      // By blocking all registers at the top of each catch block, we force
+      // intervals used after catch to spill.
+      size_t position = block->GetLifetimeStart();
+      BlockRegisters(position, position + 1);
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::ProcessInstruction(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t position = instruction->GetLifetimePosition();
+
+  if (locations == nullptr) return;
+
+  // Create synthesized intervals for temporaries.
+  for (size_t i = 0; i < locations->GetTempCount(); ++i) {
+    Location temp = locations->GetTemp(i);
+    if (temp.IsRegister() || temp.IsFpuRegister()) {
+      BlockRegister(temp, position, position + 1);
+      // Ensure that an explicit temporary register is marked as being allocated.
+      codegen_->AddAllocatedRegister(temp);
+    } else {
+      DCHECK(temp.IsUnallocated());
+      switch (temp.GetPolicy()) {
+        case Location::kRequiresRegister: {
+          LiveInterval* interval =
+              LiveInterval::MakeTempInterval(allocator_, Primitive::kPrimInt);
+          temp_intervals_.push_back(interval);
+          interval->AddTempUse(instruction, i);
+          core_intervals_.push_back(interval);
+          break;
+        }
+
+        case Location::kRequiresFpuRegister: {
+          LiveInterval* interval =
+              LiveInterval::MakeTempInterval(allocator_, Primitive::kPrimDouble);
+          temp_intervals_.push_back(interval);
+          interval->AddTempUse(instruction, i);
+          if (codegen_->NeedsTwoRegisters(Primitive::kPrimDouble)) {
+            // The high interval is colored along with the low one.
+            interval->AddHighInterval(/* is_temp */ true);
+            temp_intervals_.push_back(interval->GetHighInterval());
+          }
+          fp_intervals_.push_back(interval);
+          break;
+        }
+
+        default:
+          LOG(FATAL) << "Unexpected policy for temporary location "
+                     << temp.GetPolicy();
+      }
+    }
+  }
+
+  bool core_register = (instruction->GetType() != Primitive::kPrimDouble)
+      && (instruction->GetType() != Primitive::kPrimFloat);
+
+  if (locations->NeedsSafepoint()) {
+    if (codegen_->IsLeafMethod()) {
+      // A leaf method does not need its suspend check entry, which would only keep
+      // registers artificially live.
+      DCHECK(instruction->IsSuspendCheckEntry());
+      instruction->GetBlock()->RemoveInstruction(instruction);
+      return;
+    }
+    safepoints_.push_back(instruction);
+  }
+
+  if (locations->WillCall()) {
+    BlockRegisters(position, position + 1, /* caller_save_only */ true);
+  }
+
+  for (size_t i = 0; i < instruction->InputCount(); ++i) {
+    Location input = locations->InAt(i);
+    if (input.IsRegister() || input.IsFpuRegister()) {
+      BlockRegister(input, position, position + 1);
+    } else if (input.IsPair()) {
+      BlockRegister(input.ToLow(), position, position + 1);
+      BlockRegister(input.ToHigh(), position, position + 1);
+    }
+  }
+
+  LiveInterval* current = instruction->GetLiveInterval();
+  if (current == nullptr) return;
+
+  if (codegen_->NeedsTwoRegisters(current->GetType())) {
+    current->AddHighInterval();
+  }
+
+  for (size_t safepoint_index = safepoints_.size(); safepoint_index > 0; --safepoint_index) {
+    HInstruction* safepoint = safepoints_[safepoint_index - 1u];
+    size_t safepoint_position = safepoint->GetLifetimePosition();
+
+    // Test that safepoints are ordered in the optimal way.
+    DCHECK(safepoint_index == safepoints_.size() ||
+           safepoints_[safepoint_index]->GetLifetimePosition() < safepoint_position);
+
+    if (safepoint_position == current->GetStart()) {
+      // The safepoint is for this instruction, so the location of the instruction
+      // does not need to be saved.
+      DCHECK_EQ(safepoint_index, safepoints_.size());
+      DCHECK_EQ(safepoint, instruction);
+      continue;
+    } else if (current->IsDeadAt(safepoint_position)) {
+      break;
+    } else if (!current->Covers(safepoint_position)) {
+      // Hole in the interval.
+      continue;
+    }
+    current->AddSafepoint(safepoint);
+  }
+  current->ResetSearchCache();
+
+  // Some instructions define their output in fixed register/stack slot. The
+  // piece of the interval right after the definition is pre-colored with that
+  // register, the rest of the interval is colored like any other.
+  Location output = locations->Out();
+  if (output.IsUnallocated() && output.GetPolicy() == Location::kSameAsFirstInput) {
+    Location first = locations->InAt(0);
+    if (first.IsRegister() || first.IsFpuRegister()) {
+      current->SetFrom(position + 1);
+      current->SetRegister(first.reg());
+    } else if (first.IsPair()) {
+      current->SetFrom(position + 1);
+      current->SetRegister(first.low());
+      LiveInterval* high = current->GetHighInterval();
+      high->SetRegister(first.high());
+      high->SetFrom(position + 1);
+    }
+  } else if (output.IsRegister() || output.IsFpuRegister()) {
+    // Shift the interval's start by one to account for the blocked register.
+    current->SetFrom(position + 1);
+    current->SetRegister(output.reg());
+    BlockRegister(output, position, position + 1);
+  } else if (output.IsPair()) {
+    current->SetFrom(position + 1);
+    current->SetRegister(output.low());
+    LiveInterval* high = current->GetHighInterval();
+    high->SetRegister(output.high());
+    high->SetFrom(position + 1);
+    BlockRegister(output.ToLow(), position, position + 1);
+    BlockRegister(output.ToHigh(), position, position + 1);
+  } else if (output.IsStackSlot() || output.IsDoubleStackSlot()) {
+    current->SetSpillSlot(output.GetStackIndex());
+  } else {
+    DCHECK(output.IsUnallocated() || output.IsConstant());
+  }
+
+  if (instruction->IsPhi() && instruction->AsPhi()->IsCatchPhi()) {
+    AllocateSpillSlotForCatchPhi(instruction->AsPhi());
+  }
+
+  if (current->HasRegister()) {
+    ArenaVector<LiveInterval*>& fixed_intervals = core_register
+        ? fixed_core_intervals_
+        : fixed_fp_intervals_;
+    fixed_intervals.push_back(current);
+    if (!current->IsDeadAt(position + 2)) {
+      // The value only needs to be in the fixed register right after the instruction.
+      AddCandidate(Split(current, position + 2), core_register);
+    }
+  } else {
+    AddCandidate(current, core_register);
+  }
+}
+
+void RegisterAllocatorGraphColor::AddCandidate(LiveInterval* interval, bool core_register) {
+  ArenaVector<LiveInterval*>& intervals = core_register ? core_intervals_ : fp_intervals_;
+  LiveInterval* parent = interval->GetParent();
+  if (parent->HasSpillSlot() || parent->GetDefinedBy()->IsConstant()) {
+    // Split just before first register use.
+    size_t first_register_use = interval->FirstRegisterUse();
+    if (first_register_use != kNoLifetime) {
+      intervals.push_back(SplitBetween(interval, interval->GetStart(), first_register_use - 1));
+    } else {
+      // Nothing to do, we won't allocate a register for this value.
+    }
+  } else {
+    intervals.push_back(interval);
+  }
+}
+
+void RegisterAllocatorGraphColor::ColorIntervals(bool processing_core_registers) {
+  ArenaVector<LiveInterval*>& intervals = processing_core_registers
+      ? core_intervals_
+      : fp_intervals_;
+  const ArenaVector<LiveInterval*>& fixed_intervals = processing_core_registers
+      ? fixed_core_intervals_
+      : fixed_fp_intervals_;
+  const ArenaVector<LiveInterval*>& physical_register_intervals = processing_core_registers
+      ? physical_core_register_intervals_
+      : physical_fp_register_intervals_;
+
+  for (size_t attempt = 1; ; ++attempt) {
+    DCHECK_LE(attempt, kMaxGraphColoringAttemptsDebug)
+        << "Graph coloring register allocation does not make progress";
+    // The interference graph of each round is freed at the end of the round.
+    ArenaAllocator coloring_allocator(allocator_->GetArenaPool());
+    ColoringIteration iteration(&coloring_allocator,
+                                codegen_,
+                                liveness_,
+                                processing_core_registers);
+    iteration.BuildInterferenceGraph(intervals, fixed_intervals, physical_register_intervals);
+    iteration.FindCoalesceOpportunities();
+    iteration.PruneInterferenceGraph();
+    ArenaVector<LiveInterval*> spilled_intervals(
+        allocator_->Adapter(kArenaAllocRegisterAllocator));
+    if (iteration.ColorInterferenceGraph(&spilled_intervals)) {
+      break;
+    }
+
+    // Keep the intervals that got a color, and try again with the pieces of the
+    // spilled intervals around their register uses.
+    ArenaVector<LiveInterval*> next_intervals(allocator_->Adapter(kArenaAllocRegisterAllocator));
+    for (LiveInterval* interval : intervals) {
+      if (std::find(spilled_intervals.begin(), spilled_intervals.end(), interval)
+              == spilled_intervals.end()) {
+        next_intervals.push_back(interval);
+      }
+    }
+    for (LiveInterval* interval : spilled_intervals) {
+      DCHECK(!interval->IsTemp());
+      SplitAroundRegisterUses(interval, &next_intervals);
+    }
+    intervals.swap(next_intervals);
+  }
+
+  auto add_allocated_register = [&](int reg) {
+    codegen_->AddAllocatedRegister(processing_core_registers
+        ? Location::RegisterLocation(reg)
+        : Location::FpuRegisterLocation(reg));
+  };
+  const ArenaVector<LiveInterval*>& colored_intervals = intervals;
+  for (const ArenaVector<LiveInterval*>* colored : { &colored_intervals, &fixed_intervals }) {
+    for (LiveInterval* interval : *colored) {
+      add_allocated_register(interval->GetRegister());
+      if (interval->HasHighInterval()) {
+        add_allocated_register(interval->GetHighInterval()->GetRegister());
+      }
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::SplitAroundRegisterUses(LiveInterval* interval,
+                                                          ArenaVector<LiveInterval*>* intervals) {
+  ArenaVector<std::pair<size_t, size_t>> windows(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+  ComputeRegisterWindows(interval, &windows);
+  LiveInterval* current = interval;
+  for (const std::pair<size_t, size_t>& window : windows) {
+    if (window.first > current->GetStart()) {
+      current = Split(current, window.first);
+    }
+    DCHECK_LT(current->GetStart(), window.second);
+    intervals->push_back(current);
+    if (current->IsDeadAt(window.second)) {
+      break;
+    }
+    // The piece up to the next window stays in the stack slot of the value.
+    current = Split(current, window.second);
+  }
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlots() {
+  // The values are visited in linear order, as AllocateSpillSlotFor requires.
+  for (size_t i = 0; i < liveness_.GetNumberOfSsaValues(); ++i) {
+    LiveInterval* parent = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    for (LiveInterval* sibling = parent; sibling != nullptr; sibling = sibling->GetNextSibling()) {
+      if (!sibling->HasRegister()) {
+        AllocateSpillSlotFor(sibling);
+        break;
+      }
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlotFor(LiveInterval* interval) {
+  LiveInterval* parent = interval->GetParent();
+
+  // An instruction gets a spill slot for its entire lifetime. If the parent
+  // of this interval already has a spill slot, there is nothing to do.
+  if (parent->HasSpillSlot()) {
+    return;
+  }
+
+  HInstruction* defined_by = parent->GetDefinedBy();
+  DCHECK(!defined_by->IsPhi() || !defined_by->AsPhi()->IsCatchPhi());
+
+  if (defined_by->IsParameterValue()) {
+    // Parameters have their own stack slot.
+    parent->SetSpillSlot(codegen_->GetStackSlotOfParameter(defined_by->AsParameterValue()));
+    return;
+  }
+
+  if (defined_by->IsCurrentMethod()) {
+    parent->SetSpillSlot(0);
+    return;
+  }
+
+  if (defined_by->IsConstant()) {
+    // Constants don't need a spill slot.
+    return;
+  }
+
+  ArenaVector<size_t>* spill_slots = nullptr;
+  switch (interval->GetType()) {
+    case Primitive::kPrimDouble:
+      spill_slots = &double_spill_slots_;
+      break;
+    case Primitive::kPrimLong:
+      spill_slots = &long_spill_slots_;
+      break;
+    case Primitive::kPrimFloat:
+      spill_slots = &float_spill_slots_;
+      break;
+    case Primitive::kPrimNot:
+    case Primitive::kPrimInt:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimShort:
+      spill_slots = &int_spill_slots_;
+      break;
+    case Primitive::kPrimVoid:
+      LOG(FATAL) << "Unexpected type for interval " << interval->GetType();
+  }
+
+  // Find an available spill slot.
+  size_t slot = 0;
+  for (size_t e = spill_slots->size(); slot < e; ++slot) {
+    if ((*spill_slots)[slot] <= parent->GetStart()
+        && (slot == (e - 1) || (*spill_slots)[slot + 1] <= parent->GetStart())) {
+      break;
+    }
+  }
+
+  size_t end = interval->GetLastSibling()->GetEnd();
+  if (parent->NeedsTwoSpillSlots()) {
+    if (slot + 2u > spill_slots->size()) {
+      // We need a new spill slot.
+      spill_slots->resize(slot + 2u, end);
+    }
+    (*spill_slots)[slot] = end;
+    (*spill_slots)[slot + 1] = end;
+  } else {
+    if (slot == spill_slots->size()) {
+      // We need a new spill slot.
+      spill_slots->push_back(end);
+    } else {
+      (*spill_slots)[slot] = end;
+    }
+  }
+
+  // Note that the exact spill slot location will be computed when we resolve,
+  // that is when we know the number of spill slots for each type.
+  parent->SetSpillSlot(slot);
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlotForCatchPhi(HPhi* phi) {
+  LiveInterval* interval = phi->GetLiveInterval();
+
+  HInstruction* previous_phi = phi->GetPrevious();
+  DCHECK(previous_phi == nullptr ||
+         previous_phi->AsPhi()->GetRegNumber() <= phi->GetRegNumber())
+      << "Phis expected to be sorted by vreg number, so that equivalent phis are adjacent.";
+
+  if (phi->IsVRegEquivalentOf(previous_phi)) {
+    // This is an equivalent of the previous phi. We need to assign the same
+    // catch phi slot.
+    DCHECK(previous_phi->GetLiveInterval()->HasSpillSlot());
+    interval->SetSpillSlot(previous_phi->GetLiveInterval()->GetSpillSlot());
+  } else {
+    // Allocate a new spill slot for this catch phi.
+    interval->SetSpillSlot(catch_phi_spill_slots_);
+    catch_phi_spill_slots_ += interval->NeedsTwoSpillSlots() ? 2 : 1;
+  }
+}
+
+void RegisterAllocatorGraphColor::ComputeMaxSafepointLiveRegisters() {
+  ArenaVector<size_t> positions(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (HInstruction* safepoint : safepoints_) {
+    if (safepoint->GetLocations()->OnlyCallsOnSlowPath()) {
+      positions.push_back(safepoint->GetLifetimePosition());
+    }
+  }
+  if (positions.empty()) {
+    return;
+  }
+  std::reverse(positions.begin(), positions.end());
+
+  ArenaVector<size_t> live_core_regs(positions.size(), 0u,
+                                     allocator_->Adapter(kArenaAllocRegisterAllocator));
+  ArenaVector<size_t> live_fp_regs(positions.size(), 0u,
+                                   allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (size_t i = 0; i < liveness_.GetNumberOfSsaValues(); ++i) {
+    HInstruction* instruction = liveness_.GetInstructionFromSsaIndex(i);
+    for (LiveInterval* sibling = instruction->GetLiveInterval();
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (!sibling->HasRegister()) {
+        continue;
+      }
+      auto it = std::lower_bound(positions.begin(), positions.end(), sibling->GetStart());
+      for (; it != positions.end() && *it < sibling->GetEnd(); ++it) {
+        // The output of the safepoint itself does not need to be saved.
+        if (*it == instruction->GetLifetimePosition() || !sibling->CoversSlow(*it)) {
+          continue;
+        }
+        size_t index = it - positions.begin();
+        ArenaVector<size_t>& live_regs = sibling->IsFloatingPoint() ? live_fp_regs : live_core_regs;
+        live_regs[index] += sibling->HasHighInterval() ? 2u : 1u;
+      }
+    }
+  }
+  max_safepoint_live_core_regs_ = *std::max_element(live_core_regs.begin(), live_core_regs.end());
+  max_safepoint_live_fp_regs_ = *std::max_element(live_fp_regs.begin(), live_fp_regs.end());
+}
+
+bool RegisterAllocatorGraphColor::ValidateInternal(bool processing_core_registers,
+                                                   bool log_fatal_on_failure) const {
+  // To simplify unit testing, we eagerly create the array of intervals, and
+  // call the helper method.
+  ArenaVector<LiveInterval*> intervals(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (size_t i = 0; i < liveness_.GetNumberOfSsaValues(); ++i) {
+    LiveInterval* interval = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    if (interval != nullptr && interval->IsFloatingPoint() != processing_core_registers) {
+      intervals.push_back(interval);
+    }
+  }
+
+  const ArenaVector<LiveInterval*>& physical_register_intervals = processing_core_registers
+      ? physical_core_register_intervals_
+      : physical_fp_register_intervals_;
+  for (LiveInterval* fixed : physical_register_intervals) {
+    if (fixed != nullptr) {
+      intervals.push_back(fixed);
+    }
+  }
+
+  for (LiveInterval* temp : temp_intervals_) {
+    if (temp->IsFloatingPoint() != processing_core_registers) {
+      intervals.push_back(temp);
+    }
+  }
+
+  return ValidateIntervals(intervals, GetNumberOfSpillSlots(), reserved_out_slots_, *codegen_,
+                           allocator_, processing_core_registers, log_fatal_on_failure);
+}
+
+}  // namespace art
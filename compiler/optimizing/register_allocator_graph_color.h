@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+#define ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+
+#include "arch/instruction_set.h"
+#include "base/arena_containers.h"
+#include "base/macros.h"
+#include "primitive.h"
+#include "register_allocator.h"
+
+namespace art {
+
+class CodeGenerator;
+class HInstruction;
+class HPhi;
+class LiveInterval;
+class Location;
+class SsaLivenessAnalysis;
+
+/**
+ * A graph coloring register allocator on an `HGraph` with SSA form, following the
+ * iterated register coalescing of George and Appel.
+ *
+ * The live intervals of a register kind are the nodes of an interference graph,
+ * with an edge between two intervals live at the same position. Intervals with a
+ * fixed register, and the registers blocked at calls and fixed locations, are
+ * pre-colored. Nodes joined by a move (a phi input, an input reused as output, or
+ * two adjacent siblings) are coalesced when that keeps the graph colorable, so that
+ * they get the same register and the move goes away.
+ *
+ * An interval that cannot be colored is spilled: it is split around its register
+ * uses, the pieces in between live in the stack slot of the value, and the graph
+ * is colored again with the pieces that need a register. The pieces around a
+ * single use cannot be spilled further; they evict cheaper neighbors if needed.
+ */
+class RegisterAllocatorGraphColor : public RegisterAllocator {
+ public:
+  RegisterAllocatorGraphColor(ArenaAllocator* allocator,
+                              CodeGenerator* codegen,
+                              const SsaLivenessAnalysis& analysis);
+  ~RegisterAllocatorGraphColor() OVERRIDE {}
+
+  void AllocateRegisters() OVERRIDE;
+
+  bool Validate(bool log_fatal_on_failure) OVERRIDE {
+    return ValidateInternal(/* processing_core_registers */ true, log_fatal_on_failure)
+        && ValidateInternal(/* processing_core_registers */ false, log_fatal_on_failure);
+  }
+
+  size_t GetNumberOfSpillSlots() const {
+    return int_spill_slots_.size()
+        + long_spill_slots_.size()
+        + float_spill_slots_.size()
+        + double_spill_slots_.size()
+        + catch_phi_spill_slots_;
+  }
+
+ private:
+  // Collect the intervals to color, block the fixed registers and record the
+  // safepoints, walking the instructions backwards in linear order.
+  void ProcessInstructions();
+  void ProcessInstruction(HInstruction* instruction);
+
+  // Add `interval` to the intervals to color, after splitting off the part
+  // before its first register use if its value already lives in a stack slot
+  // or is a constant.
+  void AddCandidate(LiveInterval* interval, bool core_register);
+
+  // Update the interval for the register in `location` to cover [start, end).
+  void BlockRegister(Location location, size_t start, size_t end);
+  void BlockRegisters(size_t start, size_t end, bool caller_save_only = false);
+
+  // Color the intervals of one register kind, splitting the ones that get
+  // spilled until all the intervals left have a register.
+  void ColorIntervals(bool processing_core_registers);
+
+  // Split the spilled `interval` so that only the pieces around its register
+  // uses, appended to `intervals`, need a register.
+  void SplitAroundRegisterUses(LiveInterval* interval, ArenaVector<LiveInterval*>* intervals);
+
+  // Give a stack slot to the values that have a spilled piece.
+  void AllocateSpillSlots();
+
+  // Allocate a spill slot for the given interval. Should be called in linear
+  // order of interval starting positions.
+  void AllocateSpillSlotFor(LiveInterval* interval);
+
+  // Allocate a spill slot for the given catch phi. Will allocate the same slot
+  // for phis which share the same vreg. Must be called in reverse linear order
+  // of lifetime positions and ascending vreg numbers for correctness.
+  void AllocateSpillSlotForCatchPhi(HPhi* phi);
+
+  // Compute the maximum number of registers live at the safepoints that only
+  // call on the slow path, which the frame must be able to save.
+  void ComputeMaxSafepointLiveRegisters();
+
+  bool ValidateInternal(bool processing_core_registers, bool log_fatal_on_failure) const;
+
+  // Intervals to color, per register kind.
+  ArenaVector<LiveInterval*> core_intervals_;
+  ArenaVector<LiveInterval*> fp_intervals_;
+
+  // Pieces of intervals whose register is fixed by their definition.
+  ArenaVector<LiveInterval*> fixed_core_intervals_;
+  ArenaVector<LiveInterval*> fixed_fp_intervals_;
+
+  // Fixed intervals for physical registers. Such intervals cover the positions
+  // where an instruction requires a specific register.
+  ArenaVector<LiveInterval*> physical_core_register_intervals_;
+  ArenaVector<LiveInterval*> physical_fp_register_intervals_;
+
+  // Intervals for temporaries. Such intervals cover the positions
+  // where an instruction requires a temporary.
+  ArenaVector<LiveInterval*> temp_intervals_;
+
+  // The spill slots allocated for live intervals. We ensure spill slots
+  // are typed to avoid (1) doing moves and swaps between two different kinds
+  // of registers, and (2) swapping between a single stack slot and a double
+  // stack slot. This simplifies the parallel move resolver.
+  ArenaVector<size_t> int_spill_slots_;
+  ArenaVector<size_t> long_spill_slots_;
+  ArenaVector<size_t> float_spill_slots_;
+  ArenaVector<size_t> double_spill_slots_;
+
+  // Spill slots allocated to catch phis. This category is special-cased because
+  // (1) slots are allocated prior to coloring and in reverse linear order,
+  // (2) equivalent phis need to share slots despite having different types.
+  size_t catch_phi_spill_slots_;
+
+  // Instructions that need a safepoint, in reverse linear order.
+  ArenaVector<HInstruction*> safepoints_;
+
+  // Slots reserved for out arguments.
+  size_t reserved_out_slots_;
+
+  // The maximum live core and floating point registers at slow path safepoints.
+  size_t max_safepoint_live_core_regs_;
+  size_t max_safepoint_live_fp_regs_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorGraphColor);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
@@ -25,6 +25,7 @@
 #include "nodes.h"
 #include "optimizing_unit_test.h"
 #include "register_allocator.h"
+#include "register_allocator_linear_scan.h"
 #include "ssa_liveness_analysis.h"
 #include "ssa_phi_elimination.h"
 
@@ -35,7 +36,17 @@ namespace art {
 // Note: the register allocator tests rely on the fact that constants have live
 // intervals and registers get allocated to them.
 
-static bool Check(const uint16_t* data) {
+// Define a test for each register allocation strategy, running `test_name`
+// with the strategy as argument.
+#define TEST_ALL_STRATEGIES(test_name)                                \
+  TEST(RegisterAllocatorTest, test_name##_LinearScan) {               \
+    test_name(RegisterAllocator::kRegisterAllocatorLinearScan);       \
+  }                                                                   \
+  TEST(RegisterAllocatorTest, test_name##_GraphColor) {               \
+    test_name(RegisterAllocator::kRegisterAllocatorGraphColor);       \
+  }
+
+static bool Check(const uint16_t* data, RegisterAllocator::Strategy strategy) {
   ArenaPool pool;
   ArenaAllocator allocator(&pool);
   HGraph* graph = CreateGraph(&allocator);
@@ -48,9 +59,10 @@ static bool Check(const uint16_t* data) {
   x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
   SsaLivenessAnalysis liveness(graph, &codegen);
   liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
-  register_allocator.AllocateRegisters();
-  return register_allocator.Validate(false);
+  RegisterAllocator* register_allocator =
+      RegisterAllocator::Create(&allocator, &codegen, liveness, strategy);
+  register_allocator->AllocateRegisters();
+  return register_allocator->Validate(false);
 }
 
 /**
@@ -146,7 +158,7 @@ TEST(RegisterAllocatorTest, ValidateIntervals) {
   }
 }
 
-TEST(RegisterAllocatorTest, CFG1) {
+static void CFG1(RegisterAllocator::Strategy strategy) {
   /*
    * Test the following snippet:
    *  return 0;
@@ -163,10 +175,12 @@ TEST(RegisterAllocatorTest, CFG1) {
     Instruction::CONST_4 | 0 | 0,
     Instruction::RETURN);
 
-  ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, strategy));
 }
 
-TEST(RegisterAllocatorTest, Loop1) {
+TEST_ALL_STRATEGIES(CFG1)
+
+static void Loop1(RegisterAllocator::Strategy strategy) {
   /*
    * Test the following snippet:
    *  int a = 0;
@@ -202,10 +216,12 @@ TEST(RegisterAllocatorTest, Loop1) {
     Instruction::CONST_4 | 5 << 12 | 1 << 8,
     Instruction::RETURN | 1 << 8);
 
-  ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, strategy));
 }
 
-TEST(RegisterAllocatorTest, Loop2) {
+TEST_ALL_STRATEGIES(Loop1)
+
+static void Loop2(RegisterAllocator::Strategy strategy) {
   /*
    * Test the following snippet:
    *  int a = 0;
@@ -251,9 +267,11 @@ TEST(RegisterAllocatorTest, Loop2) {
     Instruction::ADD_INT, 1 << 8 | 0,
     Instruction::RETURN | 1 << 8);
 
-  ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, strategy));
 }
 
+TEST_ALL_STRATEGIES(Loop2)
+
 static HGraph* BuildSSAGraph(const uint16_t* data, ArenaAllocator* allocator) {
   HGraph* graph = CreateGraph(allocator);
   HGraphBuilder builder(graph);
@@ -263,7 +281,7 @@ static HGraph* BuildSSAGraph(const uint16_t* data, ArenaAllocator* allocator) {
   return graph;
 }
 
-TEST(RegisterAllocatorTest, Loop3) {
+static void Loop3(RegisterAllocator::Strategy strategy) {
   /*
    * Test the following snippet:
    *  int a = 0
@@ -308,9 +326,10 @@ TEST(RegisterAllocatorTest, Loop3) {
   x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
   SsaLivenessAnalysis liveness(graph, &codegen);
   liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
-  register_allocator.AllocateRegisters();
-  ASSERT_TRUE(register_allocator.Validate(false));
+  RegisterAllocator* register_allocator =
+      RegisterAllocator::Create(&allocator, &codegen, liveness, strategy);
+  register_allocator->AllocateRegisters();
+  ASSERT_TRUE(register_allocator->Validate(false));
 
   HBasicBlock* loop_header = graph->GetBlocks()[2];
   HPhi* phi = loop_header->GetFirstPhi()->AsPhi();
@@ -326,6 +345,59 @@ TEST(RegisterAllocatorTest, Loop3) {
   ASSERT_EQ(phi_interval->GetRegister(), ret->InputAt(0)->GetLiveInterval()->GetRegister());
 }
 
+TEST_ALL_STRATEGIES(Loop3)
+
+static void RegisterPressure(RegisterAllocator::Strategy strategy) {
+  /*
+   * Test the following snippet, where more values are live at once than
+   * there are core registers on x86, so some must be spilled and reloaded
+   * around their uses:
+   *  int v0 = -0, v1 = -1, ..., v7 = -7, v8 = -1, ..., v11 = -4;
+   *  return v0 + v1 + ... + v11;
+   */
+  const uint16_t data[] = N_REGISTERS_CODE_ITEM(12,
+    Instruction::CONST_4 | 0 << 12 | 0 << 8,
+    Instruction::CONST_4 | 1 << 12 | 1 << 8,
+    Instruction::CONST_4 | 2 << 12 | 2 << 8,
+    Instruction::CONST_4 | 3 << 12 | 3 << 8,
+    Instruction::CONST_4 | 4 << 12 | 4 << 8,
+    Instruction::CONST_4 | 5 << 12 | 5 << 8,
+    Instruction::CONST_4 | 6 << 12 | 6 << 8,
+    Instruction::CONST_4 | 7 << 12 | 7 << 8,
+    Instruction::CONST_4 | 1 << 12 | 8 << 8,
+    Instruction::CONST_4 | 2 << 12 | 9 << 8,
+    Instruction::CONST_4 | 3 << 12 | 10 << 8,
+    Instruction::CONST_4 | 4 << 12 | 11 << 8,
+    Instruction::NEG_INT | 0 << 12 | 0 << 8,
+    Instruction::NEG_INT | 1 << 12 | 1 << 8,
+    Instruction::NEG_INT | 2 << 12 | 2 << 8,
+    Instruction::NEG_INT | 3 << 12 | 3 << 8,
+    Instruction::NEG_INT | 4 << 12 | 4 << 8,
+    Instruction::NEG_INT | 5 << 12 | 5 << 8,
+    Instruction::NEG_INT | 6 << 12 | 6 << 8,
+    Instruction::NEG_INT | 7 << 12 | 7 << 8,
+    Instruction::NEG_INT | 8 << 12 | 8 << 8,
+    Instruction::NEG_INT | 9 << 12 | 9 << 8,
+    Instruction::NEG_INT | 10 << 12 | 10 << 8,
+    Instruction::NEG_INT | 11 << 12 | 11 << 8,
+    Instruction::ADD_INT_2ADDR | 1 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 2 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 3 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 4 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 5 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 6 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 7 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 8 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 9 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 10 << 12 | 0 << 8,
+    Instruction::ADD_INT_2ADDR | 11 << 12 | 0 << 8,
+    Instruction::RETURN | 0 << 8);
+
+  ASSERT_TRUE(Check(data, strategy));
+}
+
+TEST_ALL_STRATEGIES(RegisterPressure)
+
 TEST(RegisterAllocatorTest, FirstRegisterUse) {
   const uint16_t data[] = THREE_REGISTERS_CODE_ITEM(
     Instruction::CONST_4 | 0 | 0,
@@ -366,7 +438,7 @@ TEST(RegisterAllocatorTest, FirstRegisterUse) {
   ASSERT_EQ(new_interval->FirstRegisterUse(), last_xor->GetLifetimePosition());
 }
 
-TEST(RegisterAllocatorTest, DeadPhi) {
+static void DeadPhi(RegisterAllocator::Strategy strategy) {
   /* Test for a dead loop phi taking as back-edge input a phi that also has
    * this loop phi as input. Walking backwards in SsaDeadPhiElimination
    * does not solve the problem because the loop phi will be visited last.
@@ -397,11 +469,14 @@ TEST(RegisterAllocatorTest, DeadPhi) {
   x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
   SsaLivenessAnalysis liveness(graph, &codegen);
   liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
-  register_allocator.AllocateRegisters();
-  ASSERT_TRUE(register_allocator.Validate(false));
+  RegisterAllocator* register_allocator =
+      RegisterAllocator::Create(&allocator, &codegen, liveness, strategy);
+  register_allocator->AllocateRegisters();
+  ASSERT_TRUE(register_allocator->Validate(false));
 }
 
+TEST_ALL_STRATEGIES(DeadPhi)
+
 /**
  * Test that the TryAllocateFreeReg method works in the presence of inactive intervals
  * that share the same register. It should split the interval it is currently
@@ -421,7 +496,7 @@ TEST(RegisterAllocatorTest, FreeUntil) {
   x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
   SsaLivenessAnalysis liveness(graph, &codegen);
   liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+  RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
 
   // Add an artifical range to cover the temps that will be put in the unhandled list.
   LiveInterval* unhandled = graph->GetEntryBlock()->GetFirstInstruction()->GetLiveInterval();
@@ -551,7 +626,7 @@ TEST(RegisterAllocatorTest, PhiHint) {
     liveness.Analyze();
 
     // Check that the register allocator is deterministic.
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 0);
@@ -570,7 +645,7 @@ TEST(RegisterAllocatorTest, PhiHint) {
     // Set the phi to a specific register, and check that the inputs get allocated
     // the same register.
     phi->GetLocations()->UpdateOut(Location::RegisterLocation(2));
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 2);
@@ -589,7 +664,7 @@ TEST(RegisterAllocatorTest, PhiHint) {
     // Set input1 to a specific register, and check that the phi and other input get allocated
     // the same register.
     input1->GetLocations()->UpdateOut(Location::RegisterLocation(2));
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 2);
@@ -608,7 +683,7 @@ TEST(RegisterAllocatorTest, PhiHint) {
     // Set input2 to a specific register, and check that the phi and other input get allocated
     // the same register.
     input2->GetLocations()->UpdateOut(Location::RegisterLocation(2));
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 2);
@@ -617,6 +692,54 @@ TEST(RegisterAllocatorTest, PhiHint) {
   }
 }
 
+TEST(RegisterAllocatorTest, PhiCoalescing_GraphColor) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HPhi *phi;
+  HInstruction *input1, *input2;
+
+  {
+    HGraph* graph = BuildIfElseWithPhi(&allocator, &phi, &input1, &input2);
+    std::unique_ptr<const X86InstructionSetFeatures> features_x86(
+        X86InstructionSetFeatures::FromCppDefines());
+    x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+
+    // The phi does not interfere with its inputs, so they are coalesced and
+    // share a register.
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+    ASSERT_TRUE(register_allocator->Validate(false));
+
+    ASSERT_TRUE(phi->GetLiveInterval()->HasRegister());
+    ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), phi->GetLiveInterval()->GetRegister());
+    ASSERT_EQ(input2->GetLiveInterval()->GetRegister(), phi->GetLiveInterval()->GetRegister());
+  }
+
+  {
+    HGraph* graph = BuildIfElseWithPhi(&allocator, &phi, &input1, &input2);
+    std::unique_ptr<const X86InstructionSetFeatures> features_x86(
+        X86InstructionSetFeatures::FromCppDefines());
+    x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
+    SsaLivenessAnalysis liveness(graph, &codegen);
+    liveness.Analyze();
+
+    // Set the phi to a specific register, and check that the inputs are
+    // colored with it.
+    phi->GetLocations()->UpdateOut(Location::RegisterLocation(2));
+    RegisterAllocator* register_allocator = RegisterAllocator::Create(
+        &allocator, &codegen, liveness, RegisterAllocator::kRegisterAllocatorGraphColor);
+    register_allocator->AllocateRegisters();
+    ASSERT_TRUE(register_allocator->Validate(false));
+
+    ASSERT_EQ(input1->GetLiveInterval()->GetRegister(), 2);
+    ASSERT_EQ(input2->GetLiveInterval()->GetRegister(), 2);
+    ASSERT_EQ(phi->GetLiveInterval()->GetRegister(), 2);
+  }
+}
+
 static HGraph* BuildFieldReturn(ArenaAllocator* allocator,
                                 HInstruction** field,
                                 HInstruction** ret) {
@@ -667,7 +790,7 @@ TEST(RegisterAllocatorTest, ExpectedInRegisterHint) {
     SsaLivenessAnalysis liveness(graph, &codegen);
     liveness.Analyze();
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     // Sanity check that in normal conditions, the register should be hinted to 0 (EAX).
@@ -686,7 +809,7 @@ TEST(RegisterAllocatorTest, ExpectedInRegisterHint) {
     // Don't use SetInAt because we are overriding an already allocated location.
     ret->GetLocations()->inputs_[0] = Location::RegisterLocation(2);
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(field->GetLiveInterval()->GetRegister(), 2);
@@ -735,7 +858,7 @@ TEST(RegisterAllocatorTest, SameAsFirstInputHint) {
     SsaLivenessAnalysis liveness(graph, &codegen);
     liveness.Analyze();
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     // Sanity check that in normal conditions, the registers are the same.
@@ -757,7 +880,7 @@ TEST(RegisterAllocatorTest, SameAsFirstInputHint) {
     ASSERT_EQ(first_sub->GetLocations()->Out().GetPolicy(), Location::kSameAsFirstInput);
     ASSERT_EQ(second_sub->GetLocations()->Out().GetPolicy(), Location::kSameAsFirstInput);
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     ASSERT_EQ(first_sub->GetLiveInterval()->GetRegister(), 2);
@@ -804,7 +927,7 @@ TEST(RegisterAllocatorTest, ExpectedExactInRegisterAndSameOutputHint) {
     SsaLivenessAnalysis liveness(graph, &codegen);
     liveness.Analyze();
 
-    RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+    RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
     register_allocator.AllocateRegisters();
 
     // div on x86 requires its first input in eax and the output be the same as the first input.
@@ -901,7 +1024,7 @@ TEST(RegisterAllocatorTest, SpillInactive) {
     liveness.instructions_from_lifetime_position_.push_back(user);
   }
 
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+  RegisterAllocatorLinearScan register_allocator(&allocator, &codegen, liveness);
   register_allocator.unhandled_core_intervals_.push_back(fourth);
   register_allocator.unhandled_core_intervals_.push_back(third);
   register_allocator.unhandled_core_intervals_.push_back(second);
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler.h"
+
+#ifdef ART_ENABLE_CODEGEN_arm64
+#include "scheduler_arm64.h"
+#endif
+
+#ifdef ART_ENABLE_CODEGEN_x86_64
+#include "scheduler_x86_64.h"
+#endif
+
+namespace art {
+
+uint32_t SchedulingNode::ComputeEarliestCycle() const {
+  uint32_t earliest_cycle = 0;
+  for (SchedulingNode* predecessor : data_predecessors_) {
+    earliest_cycle =
+        std::max(earliest_cycle, predecessor->GetCycle() + predecessor->GetLatency());
+  }
+  for (SchedulingNode* predecessor : other_predecessors_) {
+    earliest_cycle = std::max(earliest_cycle, predecessor->GetCycle() + 1);
+  }
+  return earliest_cycle;
+}
+
+static bool CanThrowOrDeoptimize(const HInstruction* instruction) {
+  return instruction->CanThrow() || instruction->NeedsEnvironment();
+}
+
+// Returns whether the memory accesses of `earlier` and `later` must stay in
+// that order.
+static bool HasMemoryDependency(const HInstruction* earlier, const HInstruction* later) {
+  SideEffects earlier_effects = earlier->GetSideEffects();
+  SideEffects later_effects = later->GetSideEffects();
+  return later_effects.MayDependOn(earlier_effects) ||
+      earlier_effects.MayDependOn(later_effects) ||
+      (earlier_effects.DoesAnyWrite() && later_effects.DoesAnyWrite());
+}
+
+// Returns whether `earlier` and `later` must stay in that order for the state
+// observed when one of them throws to be the same.
+static bool HasExceptionDependency(const HInstruction* earlier, const HInstruction* later) {
+  if (CanThrowOrDeoptimize(earlier)) {
+    return CanThrowOrDeoptimize(later) || later->DoesAnyWrite();
+  }
+  return CanThrowOrDeoptimize(later) && earlier->DoesAnyWrite();
+}
+
+void SchedulingGraph::AddDependencies(SchedulingNode* node, HInstruction* instruction) {
+  for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
+    SchedulingNode* input_node = GetNode(instruction->InputAt(i));
+    if (input_node != nullptr && input_node != node) {
+      node->AddDataPredecessor(input_node);
+    }
+  }
+  for (HEnvironment* environment = instruction->GetEnvironment();
+       environment != nullptr;
+       environment = environment->GetParent()) {
+    for (size_t i = 0, e = environment->Size(); i < e; ++i) {
+      HInstruction* value = environment->GetInstructionAt(i);
+      SchedulingNode* value_node = (value != nullptr) ? GetNode(value) : nullptr;
+      if (value_node != nullptr && value_node != node) {
+        node->AddOtherPredecessor(value_node);
+      }
+    }
+  }
+  for (SchedulingNode* other : nodes_) {
+    if (other == node) {
+      continue;
+    }
+    for (HInstruction* other_instruction : { other->GetGluedInstruction(),
+                                             other->GetInstruction() }) {
+      if (other_instruction != nullptr &&
+          (HasMemoryDependency(other_instruction, instruction) ||
+           HasExceptionDependency(other_instruction, instruction))) {
+        node->AddOtherPredecessor(other);
+        break;
+      }
+    }
+  }
+}
+
+SchedulingNode* SchedulingGraph::AddNode(HInstruction* instruction,
+                                         HInstruction* glued_instruction,
+                                         uint32_t latency) {
+  SchedulingNode* node =
+      new (arena_) SchedulingNode(instruction, glued_instruction, latency, arena_);
+  nodes_.push_back(node);
+  nodes_map_.Put(instruction, node);
+  if (glued_instruction != nullptr) {
+    nodes_map_.Put(glued_instruction, node);
+    AddDependencies(node, glued_instruction);
+  }
+  AddDependencies(node, instruction);
+  return node;
+}
+
+bool SchedulingGraph::HasImmediateDataDependency(const HInstruction* instruction,
+                                                 const HInstruction* other) const {
+  SchedulingNode* node = GetNode(instruction);
+  SchedulingNode* other_node = GetNode(other);
+  return node != nullptr &&
+      other_node != nullptr &&
+      std::find(node->GetDataPredecessors().begin(),
+                node->GetDataPredecessors().end(),
+                other_node) != node->GetDataPredecessors().end();
+}
+
+bool SchedulingGraph::HasImmediateOtherDependency(const HInstruction* instruction,
+                                                  const HInstruction* other) const {
+  SchedulingNode* node = GetNode(instruction);
+  SchedulingNode* other_node = GetNode(other);
+  return node != nullptr &&
+      other_node != nullptr &&
+      std::find(node->GetOtherPredecessors().begin(),
+                node->GetOtherPredecessors().end(),
+                other_node) != node->GetOtherPredecessors().end();
+}
+
+// Returns whether `instruction` may call the runtime on the instruction sets
+// scheduled. The side effects of divisions, type conversions and comparisons
+// account for the runtime calls some other instruction sets make for them.
+static bool MayCallRuntime(const HInstruction* instruction) {
+  if (instruction->IsDiv() || instruction->IsTypeConversion() || instruction->IsCompare()) {
+    return false;
+  }
+  if (instruction->IsRem()) {
+    return Primitive::IsFloatingPointType(instruction->GetType());
+  }
+  return instruction->GetSideEffects().Includes(SideEffects::CanTriggerGC());
+}
+
+bool HScheduler::IsSchedulingBarrier(const HInstruction* instruction) {
+  return instruction->IsControlFlow() ||
+      // A GC, or the runtime, may walk the stack at these instructions.
+      instruction->IsSuspendCheck() ||
+      instruction->IsInvoke() ||
+      MayCallRuntime(instruction) ||
+      // These must stay first in their block.
+      instruction->IsParameterValue() ||
+      instruction->IsCurrentMethod() ||
+      instruction->IsLoadException() ||
+      instruction->IsClearException() ||
+      instruction->IsMonitorOperation() ||
+      instruction->IsMemoryBarrier() ||
+      instruction->GetSideEffects().DoesAllReadWrite();
+}
+
+// Returns whether the code generators need `instruction` right before the
+// next instruction: a null check done implicitly by the next instruction, or
+// a condition emitted with the branch using it.
+static bool IsGluedToNext(HInstruction* instruction) {
+  HInstruction* next = instruction->GetNext();
+  if (next == nullptr) {
+    return false;
+  }
+  if (instruction->IsNullCheck()) {
+    return next->CanDoImplicitNullCheckOn(instruction);
+  }
+  if (instruction->IsCondition()) {
+    return (next->IsIf() || next->IsDeoptimize()) &&
+        instruction->GetUses().HasOnlyOneUse() &&
+        instruction->GetUses().GetFirst()->GetUser() == next &&
+        instruction->GetEnvUses().IsEmpty();
+  }
+  return false;
+}
+
+uint32_t HScheduler::EstimateCycles(const ArenaVector<SchedulingNode*>& order) {
+  uint32_t cycle = 0;
+  uint32_t end = 0;
+  for (SchedulingNode* node : order) {
+    cycle = std::max(cycle, node->ComputeEarliestCycle());
+    node->SetCycle(cycle);
+    end = std::max(end, cycle + node->GetLatency());
+    ++cycle;
+  }
+  return std::max(cycle, end);
+}
+
+void HScheduler::ScheduleRegion(HInstruction* cursor) {
+  const ArenaVector<SchedulingNode*>& nodes = scheduling_graph_.GetNodes();
+  if (nodes.size() < 2) {
+    scheduling_graph_.Clear();
+    return;
+  }
+
+  // The predecessors of a node come before it, so the critical paths are
+  // final when visiting the nodes backwards.
+  for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+    SchedulingNode* node = *it;
+    for (SchedulingNode* predecessor : node->GetDataPredecessors()) {
+      predecessor->SetCriticalPath(std::max(
+          predecessor->GetCriticalPath(), predecessor->GetLatency() + node->GetCriticalPath()));
+    }
+    for (SchedulingNode* predecessor : node->GetOtherPredecessors()) {
+      predecessor->SetCriticalPath(
+          std::max(predecessor->GetCriticalPath(), 1 + node->GetCriticalPath()));
+    }
+  }
+  uint32_t original_cycles = EstimateCycles(nodes);
+
+  // Issue on every cycle the ready node that can start the soonest, the one
+  // with the longest critical path among those that can start, and otherwise
+  // the first one in the original order.
+  ArenaVector<SchedulingNode*> candidates(arena_->Adapter(kArenaAllocScheduler));
+  ArenaVector<SchedulingNode*> order(arena_->Adapter(kArenaAllocScheduler));
+  for (SchedulingNode* node : nodes) {
+    size_t predecessors = node->GetDataPredecessors().size() + node->GetOtherPredecessors().size();
+    node->SetUnscheduledPredecessors(predecessors);
+    if (predecessors == 0) {
+      candidates.push_back(node);
+    }
+  }
+  uint32_t cycle = 0;
+  while (!candidates.empty()) {
+    size_t best = 0;
+    uint32_t best_start = std::max(cycle, candidates[0]->ComputeEarliestCycle());
+    for (size_t i = 1; i < candidates.size(); ++i) {
+      uint32_t start = std::max(cycle, candidates[i]->ComputeEarliestCycle());
+      if (start < best_start ||
+          (start == best_start &&
+           candidates[i]->GetCriticalPath() > candidates[best]->GetCriticalPath())) {
+        best = i;
+        best_start = start;
+      }
+    }
+    SchedulingNode* node = candidates[best];
+    candidates.erase(candidates.begin() + best);
+    node->SetCycle(best_start);
+    cycle = best_start + 1;
+    order.push_back(node);
+    for (SchedulingNode* successor : node->GetSuccessors()) {
+      successor->DecrementUnscheduledPredecessors();
+      if (successor->GetUnscheduledPredecessors() == 0) {
+        candidates.push_back(successor);
+      }
+    }
+  }
+  DCHECK_EQ(order.size(), nodes.size());
+
+  uint32_t scheduled_cycles = EstimateCycles(order);
+  if (scheduled_cycles < original_cycles) {
+    for (SchedulingNode* node : order) {
+      if (node->GetGluedInstruction() != nullptr) {
+        node->GetGluedInstruction()->MoveBefore(cursor);
+      }
+      node->GetInstruction()->MoveBefore(cursor);
+    }
+    if (stats_ != nullptr) {
+      stats_->RecordStat(kSchedulingCyclesSaved, original_cycles - scheduled_cycles);
+    }
+  }
+  scheduling_graph_.Clear();
+}
+
+void HScheduler::Schedule(HBasicBlock* block) {
+  HInstruction* glued_instruction = nullptr;
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (IsSchedulingBarrier(instruction) ||
+        (IsGluedToNext(instruction) && IsSchedulingBarrier(instruction->GetNext()))) {
+      DCHECK(glued_instruction == nullptr);
+      ScheduleRegion(instruction);
+    } else if (IsGluedToNext(instruction)) {
+      DCHECK(glued_instruction == nullptr);
+      glued_instruction = instruction;
+    } else {
+      if (scheduling_graph_.Size() == kMaxSchedulingRegionSize) {
+        ScheduleRegion(glued_instruction != nullptr ? glued_instruction : instruction);
+      }
+      scheduling_graph_.AddNode(instruction,
+                                glued_instruction,
+                                latency_visitor_->CalculateLatency(instruction));
+      glued_instruction = nullptr;
+    }
+  }
+  // The last instruction of a block is a barrier.
+  DCHECK_EQ(scheduling_graph_.Size(), 0u);
+}
+
+void HScheduler::Schedule(HGraph* graph) {
+  for (HReversePostOrderIterator it(*graph); !it.Done(); it.Advance()) {
+    Schedule(it.Current());
+  }
+}
+
+void HInstructionScheduling::Run() {
+  ArenaAllocator* arena = graph_->GetArena();
+  switch (instruction_set_) {
+#ifdef ART_ENABLE_CODEGEN_arm64
+    case kArm64: {
+      arm64::SchedulingLatencyVisitorARM64 latency_visitor(graph_);
+      HScheduler scheduler(arena, &latency_visitor, stats_);
+      scheduler.Schedule(graph_);
+      break;
+    }
+#endif
+#ifdef ART_ENABLE_CODEGEN_x86_64
+    case kX86_64: {
+      x86_64::SchedulingLatencyVisitorX86_64 latency_visitor(graph_);
+      HScheduler scheduler(arena, &latency_visitor, stats_);
+      scheduler.Schedule(graph_);
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+}
+
+}  // namespace art
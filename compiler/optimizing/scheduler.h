@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SCHEDULER_H_
+#define ART_COMPILER_OPTIMIZING_SCHEDULER_H_
+
+#include "arch/instruction_set.h"
+#include "base/arena_containers.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * A node of the dependency graph of a scheduling region. It stands for an
+ * instruction, and for the instruction that may be glued before it: a null
+ * check done implicitly by the instruction, which must stay right before it.
+ */
+class SchedulingNode : public ArenaObject<kArenaAllocScheduler> {
+ public:
+  SchedulingNode(HInstruction* instruction,
+                 HInstruction* glued_instruction,
+                 uint32_t latency,
+                 ArenaAllocator* arena)
+      : instruction_(instruction),
+        glued_instruction_(glued_instruction),
+        latency_(latency),
+        critical_path_(latency),
+        cycle_(0),
+        unscheduled_predecessors_(0),
+        data_predecessors_(arena->Adapter(kArenaAllocScheduler)),
+        other_predecessors_(arena->Adapter(kArenaAllocScheduler)),
+        successors_(arena->Adapter(kArenaAllocScheduler)) {}
+
+  HInstruction* GetInstruction() const { return instruction_; }
+  HInstruction* GetGluedInstruction() const { return glued_instruction_; }
+
+  // The number of cycles after which the result of the instruction is
+  // available to the instructions using it.
+  uint32_t GetLatency() const { return latency_; }
+
+  // The number of cycles of the longest path of dependencies starting at this
+  // node, which the scheduler tries to start first.
+  uint32_t GetCriticalPath() const { return critical_path_; }
+  void SetCriticalPath(uint32_t critical_path) { critical_path_ = critical_path; }
+
+  uint32_t GetCycle() const { return cycle_; }
+  void SetCycle(uint32_t cycle) { cycle_ = cycle; }
+
+  // The nodes computing inputs of this node.
+  const ArenaVector<SchedulingNode*>& GetDataPredecessors() const { return data_predecessors_; }
+  // The nodes that must be scheduled before this one for other reasons: an
+  // environment use, memory or exception ordering.
+  const ArenaVector<SchedulingNode*>& GetOtherPredecessors() const { return other_predecessors_; }
+  const ArenaVector<SchedulingNode*>& GetSuccessors() const { return successors_; }
+
+  void AddDataPredecessor(SchedulingNode* predecessor) {
+    data_predecessors_.push_back(predecessor);
+    predecessor->successors_.push_back(this);
+  }
+
+  void AddOtherPredecessor(SchedulingNode* predecessor) {
+    other_predecessors_.push_back(predecessor);
+    predecessor->successors_.push_back(this);
+  }
+
+  size_t GetUnscheduledPredecessors() const { return unscheduled_predecessors_; }
+  void SetUnscheduledPredecessors(size_t count) { unscheduled_predecessors_ = count; }
+  void DecrementUnscheduledPredecessors() {
+    DCHECK_NE(unscheduled_predecessors_, 0u);
+    --unscheduled_predecessors_;
+  }
+
+  // Returns the first cycle at which the inputs of the node are available,
+  // given the cycles of its predecessors.
+  uint32_t ComputeEarliestCycle() const;
+
+ private:
+  HInstruction* const instruction_;
+  HInstruction* const glued_instruction_;
+  const uint32_t latency_;
+  uint32_t critical_path_;
+  uint32_t cycle_;
+  size_t unscheduled_predecessors_;
+  ArenaVector<SchedulingNode*> data_predecessors_;
+  ArenaVector<SchedulingNode*> other_predecessors_;
+  ArenaVector<SchedulingNode*> successors_;
+
+  DISALLOW_COPY_AND_ASSIGN(SchedulingNode);
+};
+
+/**
+ * The dependency graph of the instructions of a scheduling region, a sequence
+ * of instructions of a block between two scheduling barriers.
+ */
+class SchedulingGraph : public ValueObject {
+ public:
+  explicit SchedulingGraph(ArenaAllocator* arena)
+      : arena_(arena),
+        nodes_(arena->Adapter(kArenaAllocScheduler)),
+        nodes_map_(std::less<const HInstruction*>(), arena->Adapter(kArenaAllocScheduler)) {}
+
+  // Adds a node for `instruction`, and `glued_instruction` if not null, after
+  // the nodes already in the graph, with its dependencies on them.
+  SchedulingNode* AddNode(HInstruction* instruction,
+                          HInstruction* glued_instruction,
+                          uint32_t latency);
+
+  SchedulingNode* GetNode(const HInstruction* instruction) const {
+    auto it = nodes_map_.find(instruction);
+    return (it != nodes_map_.end()) ? it->second : nullptr;
+  }
+
+  // The nodes in the original order of their instructions.
+  const ArenaVector<SchedulingNode*>& GetNodes() const { return nodes_; }
+  size_t Size() const { return nodes_.size(); }
+
+  bool HasImmediateDataDependency(const HInstruction* instruction,
+                                  const HInstruction* other) const;
+  bool HasImmediateOtherDependency(const HInstruction* instruction,
+                                   const HInstruction* other) const;
+
+  void Clear() {
+    nodes_.clear();
+    nodes_map_.clear();
+  }
+
+ private:
+  void AddDependencies(SchedulingNode* node, HInstruction* instruction);
+
+  ArenaAllocator* const arena_;
+  ArenaVector<SchedulingNode*> nodes_;
+  ArenaSafeMap<const HInstruction*, SchedulingNode*> nodes_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(SchedulingGraph);
+};
+
+/**
+ * Computes the latencies of the instructions for the scheduler. This base
+ * visitor models a core where every result is available on the next cycle;
+ * instruction sets refine it.
+ */
+class SchedulingLatencyVisitor : public HGraphDelegateVisitor {
+ public:
+  static constexpr uint32_t kGenericInstructionLatency = 1;
+
+  explicit SchedulingLatencyVisitor(HGraph* graph)
+      : HGraphDelegateVisitor(graph), last_visited_latency_(kGenericInstructionLatency) {}
+
+  void VisitInstruction(HInstruction* instruction ATTRIBUTE_UNUSED) OVERRIDE {
+    last_visited_latency_ = kGenericInstructionLatency;
+  }
+
+  uint32_t CalculateLatency(HInstruction* instruction) {
+    instruction->Accept(this);
+    return last_visited_latency_;
+  }
+
+ protected:
+  uint32_t last_visited_latency_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SchedulingLatencyVisitor);
+};
+
+/**
+ * A list scheduler reordering the instructions of each block to start the
+ * long latency ones, and the chains of dependent instructions, first.
+ *
+ * The blocks are split into regions at scheduling barriers: control flow,
+ * instructions that may call the runtime or trigger a GC, and a few others
+ * that must keep their position. Each region is scheduled for a single-issue
+ * in-order core with the latencies of the given visitor, and only reordered if
+ * that saves cycles.
+ */
+class HScheduler : public ValueObject {
+ public:
+  HScheduler(ArenaAllocator* arena,
+             SchedulingLatencyVisitor* latency_visitor,
+             OptimizingCompilerStats* stats)
+      : arena_(arena),
+        latency_visitor_(latency_visitor),
+        stats_(stats),
+        scheduling_graph_(arena) {}
+
+  void Schedule(HGraph* graph);
+  void Schedule(HBasicBlock* block);
+
+  // Returns whether `instruction` must keep its position in its block.
+  static bool IsSchedulingBarrier(const HInstruction* instruction);
+
+  // Returns the number of cycles the modeled core takes to execute the nodes
+  // in the given order.
+  static uint32_t EstimateCycles(const ArenaVector<SchedulingNode*>& order);
+
+  // Regions are cut at this size, as building their dependencies is quadratic.
+  static constexpr size_t kMaxSchedulingRegionSize = 256;
+
+ private:
+  // Schedules the nodes of `scheduling_graph_`, whose instructions are right
+  // before `cursor`.
+  void ScheduleRegion(HInstruction* cursor);
+
+  ArenaAllocator* const arena_;
+  SchedulingLatencyVisitor* const latency_visitor_;
+  OptimizingCompilerStats* const stats_;
+  SchedulingGraph scheduling_graph_;
+
+  DISALLOW_COPY_AND_ASSIGN(HScheduler);
+};
+
+class HInstructionScheduling : public HOptimization {
+ public:
+  HInstructionScheduling(HGraph* graph,
+                         InstructionSet instruction_set,
+                         OptimizingCompilerStats* stats)
+      : HOptimization(graph, kInstructionSchedulingPassName, stats),
+        instruction_set_(instruction_set) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kInstructionSchedulingPassName = "scheduler";
+
+ private:
+  const InstructionSet instruction_set_;
+
+  DISALLOW_COPY_AND_ASSIGN(HInstructionScheduling);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SCHEDULER_H_
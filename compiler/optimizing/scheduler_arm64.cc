@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_arm64.h"
+
+namespace art {
+namespace arm64 {
+
+void SchedulingLatencyVisitorARM64::VisitBinaryOperation(HBinaryOperation* instr) {
+  // Comparisons of floating-point values run on the floating-point unit too.
+  last_visited_latency_ = Primitive::IsFloatingPointType(instr->GetLeft()->GetType())
+      ? kArm64FloatingPointOpLatency
+      : kArm64IntegerOpLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitMul(HMul* instr) {
+  switch (instr->GetResultType()) {
+    case Primitive::kPrimLong:
+      last_visited_latency_ = kArm64MulLongLatency;
+      break;
+    case Primitive::kPrimFloat:
+    case Primitive::kPrimDouble:
+      last_visited_latency_ = kArm64MulFloatingPointLatency;
+      break;
+    default:
+      last_visited_latency_ = kArm64MulIntegerLatency;
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorARM64::VisitDiv(HDiv* instr) {
+  switch (instr->GetResultType()) {
+    case Primitive::kPrimLong:
+      last_visited_latency_ = kArm64DivLongLatency;
+      break;
+    case Primitive::kPrimFloat:
+      last_visited_latency_ = kArm64DivFloatLatency;
+      break;
+    case Primitive::kPrimDouble:
+      last_visited_latency_ = kArm64DivDoubleLatency;
+      break;
+    default:
+      last_visited_latency_ = kArm64DivIntegerLatency;
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorARM64::VisitRem(HRem* instr) {
+  // Floating-point remainders are runtime calls, and scheduling barriers.
+  // Integer ones are a division followed by a multiply-subtract.
+  last_visited_latency_ = (instr->GetResultType() == Primitive::kPrimLong)
+      ? kArm64DivLongLatency + kArm64MulLongLatency
+      : kArm64DivIntegerLatency + kArm64MulIntegerLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitArrayGet(HArrayGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitArrayLength(HArrayLength* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitArraySet(HArraySet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64MemoryStoreLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitInstanceFieldGet(HInstanceFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitInstanceFieldSet(HInstanceFieldSet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64MemoryStoreLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitStaticFieldGet(HStaticFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitStaticFieldSet(HStaticFieldSet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64MemoryStoreLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitTypeConversion(HTypeConversion* instr) {
+  last_visited_latency_ = (Primitive::IsFloatingPointType(instr->GetResultType()) ||
+                           Primitive::IsFloatingPointType(instr->GetInputType()))
+      ? kArm64TypeConversionLatency
+      : kArm64IntegerOpLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitVecArrayOperation(HVecArrayOperation* instr) {
+  // The packed operands are loaded, combined, and stored back.
+  bool is_floating_point = Primitive::IsFloatingPointType(instr->GetPackedType());
+  uint32_t operation_latency;
+  switch (instr->GetOperationKind()) {
+    case VecOperationKind::kMul:
+      operation_latency =
+          is_floating_point ? kArm64MulFloatingPointLatency : kArm64MulIntegerLatency;
+      break;
+    case VecOperationKind::kDiv:
+      operation_latency = (instr->GetPackedType() == Primitive::kPrimDouble)
+          ? kArm64DivDoubleLatency
+          : kArm64DivFloatLatency;
+      break;
+    default:
+      operation_latency =
+          is_floating_point ? kArm64FloatingPointOpLatency : kArm64IntegerOpLatency;
+      break;
+  }
+  last_visited_latency_ = kArm64MemoryLoadLatency + operation_latency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitVecReduce(HVecReduce* instr) {
+  last_visited_latency_ = kArm64MemoryLoadLatency +
+      (Primitive::IsFloatingPointType(instr->GetPackedType())
+          ? kArm64FloatingPointOpLatency
+          : kArm64IntegerOpLatency);
+}
+
+}  // namespace arm64
+}  // namespace art
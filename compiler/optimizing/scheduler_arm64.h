@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SCHEDULER_ARM64_H_
+#define ART_COMPILER_OPTIMIZING_SCHEDULER_ARM64_H_
+
+#include "scheduler.h"
+
+namespace art {
+namespace arm64 {
+
+// Latencies of an in-order core like the Cortex-A53, in cycles.
+static constexpr uint32_t kArm64IntegerOpLatency = 2;
+static constexpr uint32_t kArm64MulIntegerLatency = 3;
+static constexpr uint32_t kArm64MulLongLatency = 5;
+static constexpr uint32_t kArm64DivIntegerLatency = 12;
+static constexpr uint32_t kArm64DivLongLatency = 20;
+static constexpr uint32_t kArm64FloatingPointOpLatency = 4;
+static constexpr uint32_t kArm64MulFloatingPointLatency = 5;
+static constexpr uint32_t kArm64DivFloatLatency = 15;
+static constexpr uint32_t kArm64DivDoubleLatency = 30;
+static constexpr uint32_t kArm64MemoryLoadLatency = 5;
+static constexpr uint32_t kArm64MemoryStoreLatency = 1;
+static constexpr uint32_t kArm64TypeConversionLatency = 5;
+
+class SchedulingLatencyVisitorARM64 : public SchedulingLatencyVisitor {
+ public:
+  explicit SchedulingLatencyVisitorARM64(HGraph* graph) : SchedulingLatencyVisitor(graph) {}
+
+  void VisitBinaryOperation(HBinaryOperation* instruction) OVERRIDE;
+  void VisitMul(HMul* instruction) OVERRIDE;
+  void VisitDiv(HDiv* instruction) OVERRIDE;
+  void VisitRem(HRem* instruction) OVERRIDE;
+  void VisitArrayGet(HArrayGet* instruction) OVERRIDE;
+  void VisitArrayLength(HArrayLength* instruction) OVERRIDE;
+  void VisitArraySet(HArraySet* instruction) OVERRIDE;
+  void VisitInstanceFieldGet(HInstanceFieldGet* instruction) OVERRIDE;
+  void VisitInstanceFieldSet(HInstanceFieldSet* instruction) OVERRIDE;
+  void VisitStaticFieldGet(HStaticFieldGet* instruction) OVERRIDE;
+  void VisitStaticFieldSet(HStaticFieldSet* instruction) OVERRIDE;
+  void VisitTypeConversion(HTypeConversion* instruction) OVERRIDE;
+  void VisitVecArrayOperation(HVecArrayOperation* instruction) OVERRIDE;
+  void VisitVecReduce(HVecReduce* instruction) OVERRIDE;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SchedulingLatencyVisitorARM64);
+};
+
+}  // namespace arm64
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SCHEDULER_ARM64_H_
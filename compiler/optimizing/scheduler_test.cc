@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/arena_allocator.h"
+#include "gtest/gtest.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+#include "scheduler.h"
+
+namespace art {
+
+static constexpr uint32_t kTestDivLatency = 10;
+static constexpr uint32_t kTestLoadLatency = 4;
+
+// A latency model with long latency divisions and loads.
+class TestSchedulingLatencyVisitor : public SchedulingLatencyVisitor {
+ public:
+  explicit TestSchedulingLatencyVisitor(HGraph* graph) : SchedulingLatencyVisitor(graph) {}
+
+  void VisitDiv(HDiv* instruction ATTRIBUTE_UNUSED) OVERRIDE {
+    last_visited_latency_ = kTestDivLatency;
+  }
+
+  void VisitArrayLength(HArrayLength* instruction ATTRIBUTE_UNUSED) OVERRIDE {
+    last_visited_latency_ = kTestLoadLatency;
+  }
+
+  void VisitInstanceFieldGet(HInstanceFieldGet* instruction ATTRIBUTE_UNUSED) OVERRIDE {
+    last_visited_latency_ = kTestLoadLatency;
+  }
+};
+
+/**
+ * Fixture class for the scheduler tests.
+ */
+class SchedulerTest : public testing::Test {
+ public:
+  SchedulerTest() : pool_(), allocator_(&pool_) {
+    graph_ = CreateGraph(&allocator_);
+  }
+
+  // Builds an entry block with the parameters, a block to populate ending
+  // with a return, and the exit block.
+  void BuildGraph() {
+    entry_ = new (&allocator_) HBasicBlock(graph_);
+    block_ = new (&allocator_) HBasicBlock(graph_);
+    exit_ = new (&allocator_) HBasicBlock(graph_);
+    graph_->AddBlock(entry_);
+    graph_->AddBlock(block_);
+    graph_->AddBlock(exit_);
+    graph_->SetEntryBlock(entry_);
+    graph_->SetExitBlock(exit_);
+    entry_->AddSuccessor(block_);
+    block_->AddSuccessor(exit_);
+
+    object_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 0, Primitive::kPrimNot);
+    int_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 1, Primitive::kPrimInt);
+    entry_->AddInstruction(object_);
+    entry_->AddInstruction(int_);
+    entry_->AddInstruction(new (&allocator_) HGoto());
+    block_->AddInstruction(new (&allocator_) HReturnVoid());
+    exit_->AddInstruction(new (&allocator_) HExit());
+  }
+
+  void Add(HInstruction* instruction) {
+    block_->InsertInstructionBefore(instruction, block_->GetLastInstruction());
+  }
+
+  HInstruction* NewFieldGet(size_t offset) {
+    return new (&allocator_) HInstanceFieldGet(object_, Primitive::kPrimInt, MemberOffset(offset),
+        false, kUnknownFieldIndex, graph_->GetDexFile(), dex_cache_, 0);
+  }
+
+  HInstruction* NewFieldSet(HInstruction* value, size_t offset) {
+    return new (&allocator_) HInstanceFieldSet(object_, value, Primitive::kPrimInt,
+        MemberOffset(offset), false, kUnknownFieldIndex, graph_->GetDexFile(), dex_cache_, 0);
+  }
+
+  ArenaPool pool_;
+  ArenaAllocator allocator_;
+  HGraph* graph_;
+  NullHandle<mirror::DexCache> dex_cache_;
+
+  HBasicBlock* entry_;
+  HBasicBlock* block_;
+  HBasicBlock* exit_;
+
+  HInstruction* object_;
+  HInstruction* int_;
+};
+
+TEST_F(SchedulerTest, DependencyGraph) {
+  BuildGraph();
+  HInstruction* get1 = NewFieldGet(10);
+  HInstruction* add = new (&allocator_) HAdd(Primitive::kPrimInt, get1, int_);
+  HInstruction* set = NewFieldSet(add, 20);
+  HInstruction* get2 = NewFieldGet(30);
+  HInstruction* div = new (&allocator_) HDiv(Primitive::kPrimInt, int_, get1, 0);
+  HInstruction* length = new (&allocator_) HArrayLength(object_, 0);
+  HInstruction* bounds_check = new (&allocator_) HBoundsCheck(int_, length, 0);
+  HInstruction* set_after_check = NewFieldSet(int_, 40);
+  for (HInstruction* instruction : { get1, add, set, get2, div, length, bounds_check,
+                                     set_after_check }) {
+    Add(instruction);
+  }
+
+  SchedulingGraph scheduling_graph(&allocator_);
+  for (HInstruction* instruction : { get1, add, set, get2, div, length, bounds_check,
+                                     set_after_check }) {
+    scheduling_graph.AddNode(instruction, nullptr, 1);
+  }
+
+  // Inputs.
+  ASSERT_TRUE(scheduling_graph.HasImmediateDataDependency(add, get1));
+  ASSERT_TRUE(scheduling_graph.HasImmediateDataDependency(set, add));
+  ASSERT_TRUE(scheduling_graph.HasImmediateDataDependency(div, get1));
+  ASSERT_FALSE(scheduling_graph.HasImmediateDataDependency(div, add));
+
+  // The store cannot move before the load, nor the load after it.
+  ASSERT_TRUE(scheduling_graph.HasImmediateOtherDependency(set, get1));
+  ASSERT_TRUE(scheduling_graph.HasImmediateOtherDependency(get2, set));
+  ASSERT_FALSE(scheduling_graph.HasImmediateOtherDependency(get2, get1));
+  ASSERT_FALSE(scheduling_graph.HasImmediateOtherDependency(div, set));
+
+  // Arrays do not change length, the store must stay after the check that may
+  // throw.
+  ASSERT_FALSE(scheduling_graph.HasImmediateOtherDependency(length, set));
+  ASSERT_TRUE(scheduling_graph.HasImmediateOtherDependency(set_after_check, bounds_check));
+}
+
+TEST_F(SchedulerTest, SchedulingBarriers) {
+  BuildGraph();
+  HInstruction* suspend_check = new (&allocator_) HSuspendCheck(0);
+  HInstruction* add = new (&allocator_) HAdd(Primitive::kPrimInt, int_, int_);
+  HInstruction* div = new (&allocator_) HDiv(Primitive::kPrimInt, int_, add, 0);
+  HInstruction* new_array = new (&allocator_) HNewArray(
+      int_, graph_->GetCurrentMethod(), 0, 0, graph_->GetDexFile(), kQuickAllocArray);
+
+  ASSERT_TRUE(HScheduler::IsSchedulingBarrier(suspend_check));
+  ASSERT_TRUE(HScheduler::IsSchedulingBarrier(object_));
+  ASSERT_TRUE(HScheduler::IsSchedulingBarrier(new_array));
+  ASSERT_TRUE(HScheduler::IsSchedulingBarrier(block_->GetLastInstruction()));
+  ASSERT_FALSE(HScheduler::IsSchedulingBarrier(add));
+  ASSERT_FALSE(HScheduler::IsSchedulingBarrier(div));
+}
+
+TEST_F(SchedulerTest, StartLongLatencyFirst) {
+  BuildGraph();
+  HInstruction* add1 = new (&allocator_) HAdd(Primitive::kPrimInt, int_, int_);
+  HInstruction* add2 = new (&allocator_) HAdd(Primitive::kPrimInt, add1, int_);
+  HInstruction* div = new (&allocator_) HDiv(Primitive::kPrimInt, int_, int_, 0);
+  HInstruction* add3 = new (&allocator_) HAdd(Primitive::kPrimInt, div, add2);
+  HInstruction* set = NewFieldSet(add3, 10);
+  for (HInstruction* instruction : { add1, add2, div, add3, set }) {
+    Add(instruction);
+  }
+
+  TestSchedulingLatencyVisitor latency_visitor(graph_);
+  HScheduler scheduler(&allocator_, &latency_visitor, nullptr);
+  scheduler.Schedule(block_);
+
+  // The division starts first, the additions run while it completes.
+  ASSERT_EQ(block_->GetFirstInstruction(), div);
+  ASSERT_EQ(div->GetNext(), add1);
+  ASSERT_EQ(add1->GetNext(), add2);
+  ASSERT_EQ(add2->GetNext(), add3);
+  ASSERT_EQ(add3->GetNext(), set);
+}
+
+TEST_F(SchedulerTest, KeepOrderWithoutGain) {
+  BuildGraph();
+  HInstruction* add1 = new (&allocator_) HAdd(Primitive::kPrimInt, int_, int_);
+  HInstruction* add2 = new (&allocator_) HAdd(Primitive::kPrimInt, int_, int_);
+  HInstruction* add3 = new (&allocator_) HAdd(Primitive::kPrimInt, add2, int_);
+  for (HInstruction* instruction : { add1, add2, add3 }) {
+    Add(instruction);
+  }
+
+  // Starting the longer chain first saves no cycle.
+  TestSchedulingLatencyVisitor latency_visitor(graph_);
+  HScheduler scheduler(&allocator_, &latency_visitor, nullptr);
+  scheduler.Schedule(block_);
+
+  ASSERT_EQ(block_->GetFirstInstruction(), add1);
+  ASSERT_EQ(add1->GetNext(), add2);
+  ASSERT_EQ(add2->GetNext(), add3);
+}
+
+TEST_F(SchedulerTest, GluedNullCheck) {
+  BuildGraph();
+  HInstruction* add = new (&allocator_) HAdd(Primitive::kPrimInt, int_, int_);
+  HInstruction* null_check = new (&allocator_) HNullCheck(object_, 0);
+  HInstruction* length = new (&allocator_) HArrayLength(null_check, 0);
+  HInstruction* div = new (&allocator_) HDiv(Primitive::kPrimInt, int_, add, 0);
+  HInstruction* sum = new (&allocator_) HAdd(Primitive::kPrimInt, length, div);
+  HInstruction* set = NewFieldSet(sum, 10);
+  for (HInstruction* instruction : { add, null_check, length, div, sum, set }) {
+    Add(instruction);
+  }
+
+  TestSchedulingLatencyVisitor latency_visitor(graph_);
+  HScheduler scheduler(&allocator_, &latency_visitor, nullptr);
+  scheduler.Schedule(block_);
+
+  // The division moves before the load of the length, whose implicit null
+  // check stays right before it.
+  ASSERT_EQ(block_->GetFirstInstruction(), add);
+  ASSERT_EQ(add->GetNext(), div);
+  ASSERT_EQ(div->GetNext(), null_check);
+  ASSERT_EQ(null_check->GetNext(), length);
+  ASSERT_EQ(length->GetNext(), sum);
+}
+
+}  // namespace art
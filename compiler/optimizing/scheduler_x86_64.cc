@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_x86_64.h"
+
+namespace art {
+namespace x86_64 {
+
+void SchedulingLatencyVisitorX86_64::VisitBinaryOperation(HBinaryOperation* instr) {
+  // Comparisons of floating-point values run on the floating-point unit too.
+  last_visited_latency_ = Primitive::IsFloatingPointType(instr->GetLeft()->GetType())
+      ? kX86_64FloatingPointOpLatency
+      : kX86_64IntegerOpLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitMul(HMul* instr) {
+  switch (instr->GetResultType()) {
+    case Primitive::kPrimLong:
+      last_visited_latency_ = kX86_64MulLongLatency;
+      break;
+    case Primitive::kPrimFloat:
+    case Primitive::kPrimDouble:
+      last_visited_latency_ = kX86_64MulFloatingPointLatency;
+      break;
+    default:
+      last_visited_latency_ = kX86_64MulIntegerLatency;
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitDiv(HDiv* instr) {
+  switch (instr->GetResultType()) {
+    case Primitive::kPrimLong:
+      last_visited_latency_ = kX86_64DivLongLatency;
+      break;
+    case Primitive::kPrimFloat:
+      last_visited_latency_ = kX86_64DivFloatLatency;
+      break;
+    case Primitive::kPrimDouble:
+      last_visited_latency_ = kX86_64DivDoubleLatency;
+      break;
+    default:
+      last_visited_latency_ = kX86_64DivIntegerLatency;
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitRem(HRem* instr) {
+  // Floating-point remainders are runtime calls, and scheduling barriers.
+  // Integer ones are a single division.
+  last_visited_latency_ = (instr->GetResultType() == Primitive::kPrimLong)
+      ? kX86_64DivLongLatency
+      : kX86_64DivIntegerLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArrayGet(HArrayGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kX86_64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArrayLength(HArrayLength* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kX86_64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArraySet(HArraySet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kX86_64MemoryStoreLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitInstanceFieldGet(HInstanceFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kX86_64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitInstanceFieldSet(HInstanceFieldSet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kX86_64MemoryStoreLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitStaticFieldGet(HStaticFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kX86_64MemoryLoadLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitStaticFieldSet(HStaticFieldSet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kX86_64MemoryStoreLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitTypeConversion(HTypeConversion* instr) {
+  last_visited_latency_ = (Primitive::IsFloatingPointType(instr->GetResultType()) ||
+                           Primitive::IsFloatingPointType(instr->GetInputType()))
+      ? kX86_64TypeConversionLatency
+      : kX86_64IntegerOpLatency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecArrayOperation(HVecArrayOperation* instr) {
+  // The packed operands are loaded, combined, and stored back.
+  bool is_floating_point = Primitive::IsFloatingPointType(instr->GetPackedType());
+  uint32_t operation_latency;
+  switch (instr->GetOperationKind()) {
+    case VecOperationKind::kMul:
+      operation_latency =
+          is_floating_point ? kX86_64MulFloatingPointLatency : kX86_64MulIntegerLatency;
+      break;
+    case VecOperationKind::kDiv:
+      operation_latency = (instr->GetPackedType() == Primitive::kPrimDouble)
+          ? kX86_64DivDoubleLatency
+          : kX86_64DivFloatLatency;
+      break;
+    default:
+      operation_latency =
+          is_floating_point ? kX86_64FloatingPointOpLatency : kX86_64IntegerOpLatency;
+      break;
+  }
+  last_visited_latency_ = kX86_64MemoryLoadLatency + operation_latency;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecReduce(HVecReduce* instr) {
+  last_visited_latency_ = kX86_64MemoryLoadLatency +
+      (Primitive::IsFloatingPointType(instr->GetPackedType())
+          ? kX86_64FloatingPointOpLatency
+          : kX86_64IntegerOpLatency);
+}
+
+}  // namespace x86_64
+}  // namespace art
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "select_generator.h"
+
+namespace art {
+
+// The maximum number of instructions, besides the Goto, that a branch may
+// contain. These instructions are executed on both paths once hoisted.
+static constexpr size_t kMaxInstructionsInBranch = 1u;
+
+// Returns true if `block` has `predecessor` as its single predecessor, ends
+// with a Goto, and only contains instructions that can be executed
+// unconditionally.
+static bool IsSimpleBlock(HBasicBlock* block, HBasicBlock* predecessor) {
+  if (block->GetSinglePredecessor() != predecessor || block->GetSuccessors().size() != 1u) {
+    return false;
+  }
+  size_t number_of_instructions = 0u;
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction->IsControlFlow()) {
+      return instruction->IsGoto();
+    } else if (!instruction->CanBeMoved()
+               || instruction->HasSideEffects()
+               || instruction->CanThrow()
+               || instruction->NeedsEnvironment()) {
+      return false;
+    } else if (++number_of_instructions > kMaxInstructionsInBranch) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// Returns the only Phi of `merge_block` whose inputs from `block1` and
+// `block2` differ, or nullptr if there is none or more than one.
+static HPhi* GetSingleChangedPhi(HBasicBlock* merge_block,
+                                 HBasicBlock* block1,
+                                 HBasicBlock* block2) {
+  size_t index1 = merge_block->GetPredecessorIndexOf(block1);
+  size_t index2 = merge_block->GetPredecessorIndexOf(block2);
+  HPhi* select_phi = nullptr;
+  for (HInstructionIterator it(merge_block->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    if (phi->InputAt(index1) != phi->InputAt(index2)) {
+      if (select_phi != nullptr) {
+        return nullptr;
+      }
+      select_phi = phi;
+    }
+  }
+  return select_phi;
+}
+
+void HSelectGenerator::TryGeneratingSelect(HBasicBlock* block) {
+  DCHECK(block->EndsWithIf());
+
+  // Find elements of the pattern.
+  HIf* if_instruction = block->GetLastInstruction()->AsIf();
+  HBasicBlock* true_block = if_instruction->IfTrueSuccessor();
+  HBasicBlock* false_block = if_instruction->IfFalseSuccessor();
+  if (true_block == false_block
+      || !IsSimpleBlock(true_block, block)
+      || !IsSimpleBlock(false_block, block)) {
+    return;
+  }
+  HBasicBlock* merge_block = true_block->GetSingleSuccessor();
+  if (merge_block != false_block->GetSingleSuccessor() || merge_block->IsLoopHeader()) {
+    return;
+  }
+  HPhi* phi = GetSingleChangedPhi(merge_block, true_block, false_block);
+  if (phi == nullptr) {
+    return;
+  }
+  size_t true_index = merge_block->GetPredecessorIndexOf(true_block);
+  size_t false_index = merge_block->GetPredecessorIndexOf(false_block);
+  HInstruction* true_value = phi->InputAt(true_index);
+  HInstruction* false_value = phi->InputAt(false_index);
+
+  // Hoist the instructions of both branches before the If. They only feed
+  // the Phi, and are cheap enough to be computed on both paths.
+  for (HBasicBlock* branch : { true_block, false_block }) {
+    while (!branch->GetFirstInstruction()->IsGoto()) {
+      branch->GetFirstInstruction()->MoveBefore(if_instruction);
+    }
+  }
+
+  // Create the Select and insert it in front of the If.
+  HSelect* select = new (graph_->GetArena()) HSelect(if_instruction->InputAt(0),
+                                                     true_value,
+                                                     false_value,
+                                                     if_instruction->GetDexPc());
+  if (phi->GetType() == Primitive::kPrimNot) {
+    select->SetReferenceTypeInfo(phi->GetReferenceTypeInfo());
+  }
+  block->InsertInstructionBefore(select, if_instruction);
+
+  // Make the Select the input of the Phi from the false branch, and remove
+  // the true branch, which removes its Phi input. If the merge block was only
+  // reached from the two branches, this also replaces the Phi with the Select.
+  phi->ReplaceInput(select, false_index);
+  bool only_two_predecessors = (merge_block->GetPredecessors().size() == 2u);
+  true_block->DisconnectAndDelete();
+  DCHECK_EQ(only_two_predecessors, phi->GetBlock() == nullptr);
+
+  // Merge the blocks now connected with Gotos. No dominance information needs
+  // updating: the merge block, if merged, was dominated by `block`.
+  DCHECK_EQ(block->GetSingleSuccessor(), false_block);
+  block->MergeWith(false_block);
+  if (only_two_predecessors) {
+    DCHECK_EQ(block->GetSingleSuccessor(), merge_block);
+    block->MergeWith(merge_block);
+  }
+
+  MaybeRecordStat(kSelectGenerated);
+}
+
+void HSelectGenerator::Run() {
+  // Iterate in post order so that the selects of nested branches are
+  // generated first, which may make the enclosing branches simple.
+  for (HPostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    if (block->EndsWithIf()) {
+      TryGeneratingSelect(block);
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This optimization recognizes branches whose only effect is to pick one of
+// two values, like `x = c ? a : b` or the min, max and clamp idioms, and
+// replaces them with an HSelect. Code generators lower HSelect to conditional
+// moves, which cannot be mispredicted.
+//
+// The pattern is an If whose successors both go to the same merge block, and
+// contain at most one cheap instruction besides their Goto. These instructions
+// are hoisted before the If. The merge block must have a single Phi whose
+// inputs differ between the two branches.
+
+// Example: Selecting the maximum of two values
+//     B1:
+//       i1   ParameterValue
+//       i2   ParameterValue
+//       z3   GreaterThan [ i1 i2 ]
+//       v4   If [ z3 ] then B2 else B3
+//     B2:
+//       v5   Goto B4
+//     B3:
+//       v6   Goto B4
+//     B4:
+//       i7   Phi [ i1 i2 ]
+//       v8   Return [ i7 ]
+// turns into
+//     B1:
+//       i1   ParameterValue
+//       i2   ParameterValue
+//       z3   GreaterThan [ i1 i2 ]
+//       i9   Select [ i2 i1 z3 ]
+//       v8   Return [ i9 ]
+//     B2, B3, B4: removed
+
+// Note: this optimization must be run after the boolean simplifier, which
+// turns the selection of the constants zero and one into the condition itself.
+
+#ifndef ART_COMPILER_OPTIMIZING_SELECT_GENERATOR_H_
+#define ART_COMPILER_OPTIMIZING_SELECT_GENERATOR_H_
+
+#include "optimization.h"
+
+namespace art {
+
+class HSelectGenerator : public HOptimization {
+ public:
+  HSelectGenerator(HGraph* graph, OptimizingCompilerStats* stats)
+    : HOptimization(graph, kSelectGeneratorPassName, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kSelectGeneratorPassName = "select_generator";
+
+ private:
+  void TryGeneratingSelect(HBasicBlock* block);
+
+  DISALLOW_COPY_AND_ASSIGN(HSelectGenerator);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SELECT_GENERATOR_H_
@@ -438,6 +438,44 @@ class X86Assembler FINAL : public Assembler {
   void orpd(XmmRegister dst, XmmRegister src);
   void orps(XmmRegister dst, XmmRegister src);
 
+  void movdqu(XmmRegister dst, const Address& src);
+  void movdqu(const Address& dst, XmmRegister src);
+
+  void addps(XmmRegister dst, XmmRegister src);
+  void subps(XmmRegister dst, XmmRegister src);
+  void mulps(XmmRegister dst, XmmRegister src);
+  void divps(XmmRegister dst, XmmRegister src);
+
+  void addpd(XmmRegister dst, XmmRegister src);
+  void subpd(XmmRegister dst, XmmRegister src);
+  void mulpd(XmmRegister dst, XmmRegister src);
+  void divpd(XmmRegister dst, XmmRegister src);
+
+  void paddb(XmmRegister dst, XmmRegister src);
+  void paddw(XmmRegister dst, XmmRegister src);
+  void paddd(XmmRegister dst, XmmRegister src);
+  void paddq(XmmRegister dst, XmmRegister src);
+
+  void psubb(XmmRegister dst, XmmRegister src);
+  void psubw(XmmRegister dst, XmmRegister src);
+  void psubd(XmmRegister dst, XmmRegister src);
+  void psubq(XmmRegister dst, XmmRegister src);
+
+  void pmullw(XmmRegister dst, XmmRegister src);
+  void pmulld(XmmRegister dst, XmmRegister src);  // SSE4.1
+
+  void pand(XmmRegister dst, XmmRegister src);
+  void por(XmmRegister dst, XmmRegister src);
+  void pxor(XmmRegister dst, XmmRegister src);
+
+  void pminsd(XmmRegister dst, XmmRegister src);  // SSE4.1
+  void pmaxsd(XmmRegister dst, XmmRegister src);  // SSE4.1
+
+  void punpcklbw(XmmRegister dst, XmmRegister src);
+  void punpcklwd(XmmRegister dst, XmmRegister src);
+
+  void pshufd(XmmRegister dst, XmmRegister src, const Immediate& imm);
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -576,9 +614,15 @@ class X86Assembler FINAL : public Assembler {
   void jmp(NearLabel* label);
 
   void repne_scasw();
+  void repe_cmpsb();
   void repe_cmpsw();
   void repe_cmpsl();
+  void rep_movsb();
   void rep_movsw();
+  void rep_movsl();
+  void rep_stosb();
+  void rep_stosw();
+  void rep_stosl();
 
   X86Assembler* lock();
   void cmpxchgl(const Address& address, Register reg);
@@ -131,6 +131,72 @@ TEST_F(AssemblerX86Test, punpckldq) {
   DriverStr(expected, "punpckldq");
 }
 
+TEST_F(AssemblerX86Test, Movdqu) {
+  GetAssembler()->movdqu(x86::XMM0, x86::Address(x86::EDI, x86::EBX, x86::TIMES_4, 12));
+  GetAssembler()->movdqu(x86::Address(x86::EDI, x86::ECX, x86::TIMES_8, 16), x86::XMM1);
+  const char* expected =
+    "movdqu 0xc(%EDI,%EBX,4), %xmm0\n"
+    "movdqu %xmm1, 0x10(%EDI,%ECX,8)\n";
+  DriverStr(expected, "movdqu");
+}
+
+TEST_F(AssemblerX86Test, PackedArithmetic) {
+  GetAssembler()->addps(x86::XMM0, x86::XMM1);
+  GetAssembler()->subps(x86::XMM0, x86::XMM1);
+  GetAssembler()->mulps(x86::XMM0, x86::XMM1);
+  GetAssembler()->divps(x86::XMM0, x86::XMM1);
+  GetAssembler()->addpd(x86::XMM0, x86::XMM1);
+  GetAssembler()->subpd(x86::XMM0, x86::XMM1);
+  GetAssembler()->mulpd(x86::XMM0, x86::XMM1);
+  GetAssembler()->divpd(x86::XMM0, x86::XMM1);
+  GetAssembler()->paddb(x86::XMM0, x86::XMM1);
+  GetAssembler()->paddw(x86::XMM0, x86::XMM1);
+  GetAssembler()->paddd(x86::XMM0, x86::XMM1);
+  GetAssembler()->paddq(x86::XMM0, x86::XMM1);
+  GetAssembler()->psubb(x86::XMM0, x86::XMM1);
+  GetAssembler()->psubw(x86::XMM0, x86::XMM1);
+  GetAssembler()->psubd(x86::XMM0, x86::XMM1);
+  GetAssembler()->psubq(x86::XMM0, x86::XMM1);
+  GetAssembler()->pmullw(x86::XMM0, x86::XMM1);
+  GetAssembler()->pmulld(x86::XMM0, x86::XMM1);
+  GetAssembler()->pand(x86::XMM0, x86::XMM1);
+  GetAssembler()->por(x86::XMM0, x86::XMM1);
+  GetAssembler()->pxor(x86::XMM0, x86::XMM1);
+  GetAssembler()->pminsd(x86::XMM0, x86::XMM1);
+  GetAssembler()->pmaxsd(x86::XMM0, x86::XMM1);
+  GetAssembler()->punpcklbw(x86::XMM0, x86::XMM1);
+  GetAssembler()->punpcklwd(x86::XMM0, x86::XMM1);
+  GetAssembler()->pshufd(x86::XMM2, x86::XMM3, CreateImmediate(0x4E));
+  const char* expected =
+    "addps %xmm1, %xmm0\n"
+    "subps %xmm1, %xmm0\n"
+    "mulps %xmm1, %xmm0\n"
+    "divps %xmm1, %xmm0\n"
+    "addpd %xmm1, %xmm0\n"
+    "subpd %xmm1, %xmm0\n"
+    "mulpd %xmm1, %xmm0\n"
+    "divpd %xmm1, %xmm0\n"
+    "paddb %xmm1, %xmm0\n"
+    "paddw %xmm1, %xmm0\n"
+    "paddd %xmm1, %xmm0\n"
+    "paddq %xmm1, %xmm0\n"
+    "psubb %xmm1, %xmm0\n"
+    "psubw %xmm1, %xmm0\n"
+    "psubd %xmm1, %xmm0\n"
+    "psubq %xmm1, %xmm0\n"
+    "pmullw %xmm1, %xmm0\n"
+    "pmulld %xmm1, %xmm0\n"
+    "pand %xmm1, %xmm0\n"
+    "por %xmm1, %xmm0\n"
+    "pxor %xmm1, %xmm0\n"
+    "pminsd %xmm1, %xmm0\n"
+    "pmaxsd %xmm1, %xmm0\n"
+    "punpcklbw %xmm1, %xmm0\n"
+    "punpcklwd %xmm1, %xmm0\n"
+    "pshufd $0x4e, %xmm3, %xmm2\n";
+  DriverStr(expected, "packed_arithmetic");
+}
+
 TEST_F(AssemblerX86Test, LoadLongConstant) {
   GetAssembler()->LoadLongConstant(x86::XMM0, 51);
   const char* expected =
@@ -210,6 +276,12 @@ TEST_F(AssemblerX86Test, Repnescasw) {
   DriverStr(expected, "Repnescasw");
 }
 
+TEST_F(AssemblerX86Test, Repecmpsb) {
+  GetAssembler()->repe_cmpsb();
+  const char* expected = "repe cmpsb\n";
+  DriverStr(expected, "Repecmpsb");
+}
+
 TEST_F(AssemblerX86Test, Repecmpsw) {
   GetAssembler()->repe_cmpsw();
   const char* expected = "repe cmpsw\n";
@@ -234,6 +306,29 @@ TEST_F(AssemblerX86Test, RepMovsw) {
   DriverStr(expected, "rep_movsw");
 }
 
+TEST_F(AssemblerX86Test, RepMovsb) {
+  GetAssembler()->rep_movsb();
+  const char* expected = "rep movsb\n";
+  DriverStr(expected, "rep_movsb");
+}
+
+TEST_F(AssemblerX86Test, RepMovsl) {
+  GetAssembler()->rep_movsl();
+  const char* expected = "rep movsl\n";
+  DriverStr(expected, "rep_movsl");
+}
+
+TEST_F(AssemblerX86Test, RepStos) {
+  GetAssembler()->rep_stosb();
+  GetAssembler()->rep_stosw();
+  GetAssembler()->rep_stosl();
+  const char* expected =
+    "rep stosb\n"
+    "rep stosw\n"
+    "rep stosl\n";
+  DriverStr(expected, "rep_stos");
+}
+
 TEST_F(AssemblerX86Test, Bsfl) {
   DriverStr(RepeatRR(&x86::X86Assembler::bsfl, "bsfl %{reg2}, %{reg1}"), "bsfl");
 }
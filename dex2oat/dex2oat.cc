@@ -294,12 +294,30 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --inline-max-code-units=<code-units-count>: the maximum code units that a method");
   UsageError("      can have to be considered for inlining. A zero value will disable inlining.");
+  UsageError("      Call sites in loops, with constant arguments or to hot methods allow");
+  UsageError("      proportionally more, cold call sites less.");
   UsageError("      Honored only by Optimizing. Has priority over the --compiler-filter option.");
   UsageError("      Intended for development/experimental use.");
   UsageError("      Example: --inline-max-code-units=%d",
              CompilerOptions::kDefaultInlineMaxCodeUnits);
   UsageError("      Default: %d", CompilerOptions::kDefaultInlineMaxCodeUnits);
   UsageError("");
+  UsageError("  --loop-unrolling-max-instructions=<instruction-count>: the maximum number of");
+  UsageError("      instructions that unrolling or peeling a loop may add to a method. A zero");
+  UsageError("      value will disable loop unrolling and peeling. Honored only by Optimizing.");
+  UsageError("      Has priority over the --compiler-filter option.");
+  UsageError("      Example: --loop-unrolling-max-instructions=%d",
+             CompilerOptions::kDefaultLoopUnrollingMaxInstructions);
+  UsageError("      Default: %d", CompilerOptions::kDefaultLoopUnrollingMaxInstructions);
+  UsageError("");
+  UsageError("  --graph-coloring-max-code-units=<code-units-count>: the maximum code units of");
+  UsageError("      a method whose registers are allocated by graph coloring. Larger methods use");
+  UsageError("      linear scan. A zero value will always use linear scan. Honored only by");
+  UsageError("      Optimizing.");
+  UsageError("      Example: --graph-coloring-max-code-units=%d",
+             CompilerOptions::kDefaultGraphColoringMaxCodeUnits);
+  UsageError("      Default: %d", CompilerOptions::kDefaultGraphColoringMaxCodeUnits);
+  UsageError("");
   UsageError("  --dump-timing: display a breakdown of where time was spent");
   UsageError("");
   UsageError("  --include-patch-information: Include patching information so the generated code");
@@ -324,6 +342,8 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("      Example: --runtime-arg -Xms256m");
   UsageError("");
   UsageError("  --profile-file=<filename>: specify profiler output file to use for compilation.");
+  UsageError("      A profile saved by the JIT (see -Xjitprofilefile) restricts compilation");
+  UsageError("      to the methods it lists, and provides receiver types for inlining.");
   UsageError("");
   UsageError("  --print-pass-names: print a list of pass names");
   UsageError("");
@@ -576,6 +596,9 @@ class Dex2Oat FINAL {
     int inline_depth_limit = kUnsetInlineDepthLimit;
     static constexpr int kUnsetInlineMaxCodeUnits = -1;
     int inline_max_code_units = kUnsetInlineMaxCodeUnits;
+    static constexpr int kUnsetLoopUnrollingMaxInstructions = -1;
+    int loop_unrolling_max_instructions = kUnsetLoopUnrollingMaxInstructions;
+    int graph_coloring_max_code_units = CompilerOptions::kDefaultGraphColoringMaxCodeUnits;
 
     // Profile file to use
     double top_k_profile_threshold = CompilerOptions::kDefaultTopKProfileThreshold;
@@ -722,6 +745,19 @@ class Dex2Oat FINAL {
     ParseUintOption(option, "--inline-max-code-units=", &parser_options->inline_max_code_units);
   }
 
+  void ParseLoopUnrollingMaxInstructions(const StringPiece& option,
+                                         ParserOptions* parser_options) {
+    ParseUintOption(option,
+                    "--loop-unrolling-max-instructions=",
+                    &parser_options->loop_unrolling_max_instructions);
+  }
+
+  void ParseGraphColoringMaxCodeUnits(const StringPiece& option, ParserOptions* parser_options) {
+    ParseUintOption(option,
+                    "--graph-coloring-max-code-units=",
+                    &parser_options->graph_coloring_max_code_units);
+  }
+
   void ParseDisablePasses(const StringPiece& option, ParserOptions* parser_options) {
     DCHECK(option.starts_with("--disable-passes="));
     const std::string disable_passes = option.substr(strlen("--disable-passes=")).data();
@@ -939,6 +975,14 @@ class Dex2Oat FINAL {
           ? CompilerOptions::kSpaceFilterInlineMaxCodeUnits
           : CompilerOptions::kDefaultInlineMaxCodeUnits;
     }
+    if (parser_options->loop_unrolling_max_instructions ==
+            ParserOptions::kUnsetLoopUnrollingMaxInstructions) {
+      parser_options->loop_unrolling_max_instructions =
+          (parser_options->compiler_filter == CompilerOptions::kSpace)
+          // Implementation of the space filter: do not grow loops.
+          ? CompilerOptions::kSpaceFilterLoopUnrollingMaxInstructions
+          : CompilerOptions::kDefaultLoopUnrollingMaxInstructions;
+    }
 
     // Checks are all explicit until we know the architecture.
     // Set the compilation target's implicit checks options.
@@ -969,6 +1013,8 @@ class Dex2Oat FINAL {
                                                 parser_options->num_dex_methods_threshold,
                                                 parser_options->inline_depth_limit,
                                                 parser_options->inline_max_code_units,
+                                                parser_options->loop_unrolling_max_instructions,
+                                                parser_options->graph_coloring_max_code_units,
                                                 parser_options->include_patch_information,
                                                 parser_options->top_k_profile_threshold,
                                                 parser_options->debuggable,
@@ -1125,6 +1171,10 @@ class Dex2Oat FINAL {
         ParseInlineDepthLimit(option, parser_options.get());
       } else if (option.starts_with("--inline-max-code-units=")) {
         ParseInlineMaxCodeUnits(option, parser_options.get());
+      } else if (option.starts_with("--loop-unrolling-max-instructions=")) {
+        ParseLoopUnrollingMaxInstructions(option, parser_options.get());
+      } else if (option.starts_with("--graph-coloring-max-code-units=")) {
+        ParseGraphColoringMaxCodeUnits(option, parser_options.get());
       } else if (option == "--host") {
         is_host_ = true;
       } else if (option == "--runtime-arg") {
@@ -87,6 +87,7 @@ LIBART_COMMON_SRC_FILES := \
   interpreter/interpreter_common.cc \
   interpreter/interpreter_goto_table_impl.cc \
   interpreter/interpreter_switch_impl.cc \
+  interpreter/mterp/mterp.cc \
   interpreter/unstarted_runtime.cc \
   java_vm_ext.cc \
   jdwp/jdwp_event.cc \
@@ -100,6 +101,9 @@ LIBART_COMMON_SRC_FILES := \
   jit/jit.cc \
   jit/jit_code_cache.cc \
   jit/jit_instrumentation.cc \
+  jit/offline_profiling_info.cc \
+  jit/osr_entry.cc \
+  jit/profile_saver.cc \
   jit/profiling_info.cc \
   lambda/art_lambda_method.cc \
   lambda/box_table.cc \
@@ -250,7 +254,8 @@ LIBART_TARGET_SRC_FILES_arm64 := \
   arch/arm64/quick_entrypoints_arm64.S \
   arch/arm64/thread_arm64.cc \
   monitor_pool.cc \
-  arch/arm64/fault_handler_arm64.cc
+  arch/arm64/fault_handler_arm64.cc \
+  interpreter/mterp/out/mterp_arm64.S
 
 LIBART_SRC_FILES_x86 := \
   arch/x86/context_x86.cc \
@@ -274,7 +279,8 @@ LIBART_SRC_FILES_x86_64 := \
   arch/x86_64/quick_entrypoints_x86_64.S \
   arch/x86_64/thread_x86_64.cc \
   monitor_pool.cc \
-  arch/x86/fault_handler_x86.cc
+  arch/x86/fault_handler_x86.cc \
+  interpreter/mterp/out/mterp_x86_64.S
 
 LIBART_TARGET_SRC_FILES_x86_64 := \
   $(LIBART_SRC_FILES_x86_64) \
@@ -319,11 +319,32 @@ void ArtMethod::Invoke(Thread* self, uint32_t* args, uint32_t args_size, JValue*
   self->PopManagedStackFragment(fragment);
 }
 
+bool ArtMethod::IsCriticalNativeMethod(const DexFile& dex_file,
+                                       const DexFile::ClassDef& class_def,
+                                       uint32_t method_idx,
+                                       uint32_t access_flags) {
+  constexpr uint32_t kRequiredFlags = kAccNative | kAccStatic;
+  if ((access_flags & (kRequiredFlags | kAccSynchronized | kAccDeclaredSynchronized)) !=
+      kRequiredFlags) {
+    return false;
+  }
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  const char* shorty = dex_file.GetMethodShorty(method_id);
+  if (strchr(shorty, 'L') != nullptr) {
+    return false;
+  }
+  return dex_file.IsMethodAnnotationPresent(class_def,
+                                            method_idx,
+                                            "Ldalvik/annotation/optimization/CriticalNative;",
+                                            DexFile::kDexVisibilityBuild);
+}
+
 void ArtMethod::RegisterNative(const void* native_method, bool is_fast) {
   CHECK(IsNative()) << PrettyMethod(this);
   CHECK(!IsFastNative()) << PrettyMethod(this);
   CHECK(native_method != nullptr) << PrettyMethod(this);
-  if (is_fast) {
+  // Critical natives never leave the runnable state, there is nothing to make faster.
+  if (is_fast && !IsCriticalNative()) {
     SetAccessFlags(GetAccessFlags() | kAccFastNative);
   }
   SetEntryPointFromJni(native_method);
@@ -390,6 +411,17 @@ const OatQuickMethodHeader* ArtMethod::GetOatQuickMethodHeader(uintptr_t pc) {
   }
 
   Runtime* runtime = Runtime::Current();
+
+  // The entrypoint of a method may not be its JIT code anymore (for example during a code
+  // cache collection), so look the pc up in the code cache first.
+  jit::Jit* jit = runtime->GetJit();
+  if (jit != nullptr) {
+    OatQuickMethodHeader* method_header = jit->GetCodeCache()->LookupMethodHeader(pc, this);
+    if (method_header != nullptr) {
+      return method_header;
+    }
+  }
+
   const void* code = runtime->GetInstrumentation()->GetQuickCodeFor(this, sizeof(void*));
   DCHECK(code != nullptr);
 
@@ -398,14 +430,9 @@ const OatQuickMethodHeader* ArtMethod::GetOatQuickMethodHeader(uintptr_t pc) {
     return nullptr;
   }
 
-  code = EntryPointToCodePointer(code);
-  OatQuickMethodHeader* method_header = reinterpret_cast<OatQuickMethodHeader*>(
-      reinterpret_cast<uintptr_t>(code) - sizeof(OatQuickMethodHeader));
-
   // TODO(ngeoffray): validate the pc. Note that unit tests can give unrelated pcs (for
   // example arch_test).
-  UNUSED(pc);
-  return method_header;
+  return OatQuickMethodHeader::FromCodePointer(EntryPointToCodePointer(code));
 }
 
 }  // namespace art
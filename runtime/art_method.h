@@ -150,6 +150,22 @@ class ArtMethod FINAL {
     return (GetAccessFlags() & mask) == mask;
   }
 
+  // A critical native is called like a plain C function: no JNIEnv*, no jclass, no local
+  // reference frame and no thread state transition. See IsCriticalNativeMethod().
+  bool IsCriticalNative() {
+    constexpr uint32_t mask = kAccCriticalNative | kAccNative;
+    return (GetAccessFlags() & mask) == mask;
+  }
+
+  // Returns whether the method `method_idx` of `class_def` qualifies as a critical native: a
+  // static, non-synchronized native method taking and returning only primitive values, and
+  // annotated with @dalvik.annotation.optimization.CriticalNative. Used by both the class linker
+  // and the compiler, which must agree on the calling convention of the native code.
+  static bool IsCriticalNativeMethod(const DexFile& dex_file,
+                                     const DexFile::ClassDef& class_def,
+                                     uint32_t method_idx,
+                                     uint32_t access_flags);
+
   bool IsAbstract() {
     return (GetAccessFlags() & kAccAbstract) != 0;
   }
@@ -433,6 +449,14 @@ class ArtMethod FINAL {
     return ++hotness_count_;
   }
 
+  uint16_t GetCounter() const {
+    return hotness_count_;
+  }
+
+  void ClearCounter() {
+    hotness_count_ = 0;
+  }
+
   const uint8_t* GetQuickenedInfo() SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Returns the method header for the compiled code containing 'pc'. Note that runtime
@@ -20,6 +20,7 @@
 
 #if defined(__cplusplus)
 #include "art_method.h"
+#include "dex_file.h"
 #include "gc/allocator/rosalloc.h"
 #include "lock_word.h"
 #include "mirror/class.h"
@@ -185,10 +186,26 @@ ADD_TEST_EQ(static_cast<uint32_t>(ACCESS_FLAGS_CLASS_IS_FINALIZABLE),
 #define MIRROR_ARRAY_LENGTH_OFFSET      MIRROR_OBJECT_HEADER_SIZE
 ADD_TEST_EQ(MIRROR_ARRAY_LENGTH_OFFSET, art::mirror::Array::LengthOffset().Int32Value())
 
+#define MIRROR_BOOLEAN_ARRAY_DATA_OFFSET (4 + MIRROR_OBJECT_HEADER_SIZE)
+ADD_TEST_EQ(MIRROR_BOOLEAN_ARRAY_DATA_OFFSET,
+            art::mirror::Array::DataOffset(sizeof(uint8_t)).Int32Value())
+
+#define MIRROR_BYTE_ARRAY_DATA_OFFSET   (4 + MIRROR_OBJECT_HEADER_SIZE)
+ADD_TEST_EQ(MIRROR_BYTE_ARRAY_DATA_OFFSET,
+            art::mirror::Array::DataOffset(sizeof(int8_t)).Int32Value())
+
 #define MIRROR_CHAR_ARRAY_DATA_OFFSET   (4 + MIRROR_OBJECT_HEADER_SIZE)
 ADD_TEST_EQ(MIRROR_CHAR_ARRAY_DATA_OFFSET,
             art::mirror::Array::DataOffset(sizeof(uint16_t)).Int32Value())
 
+#define MIRROR_SHORT_ARRAY_DATA_OFFSET  (4 + MIRROR_OBJECT_HEADER_SIZE)
+ADD_TEST_EQ(MIRROR_SHORT_ARRAY_DATA_OFFSET,
+            art::mirror::Array::DataOffset(sizeof(int16_t)).Int32Value())
+
+#define MIRROR_INT_ARRAY_DATA_OFFSET    (4 + MIRROR_OBJECT_HEADER_SIZE)
+ADD_TEST_EQ(MIRROR_INT_ARRAY_DATA_OFFSET,
+            art::mirror::Array::DataOffset(sizeof(int32_t)).Int32Value())
+
 #define MIRROR_OBJECT_ARRAY_DATA_OFFSET (4 + MIRROR_OBJECT_HEADER_SIZE)
 ADD_TEST_EQ(MIRROR_OBJECT_ARRAY_DATA_OFFSET,
     art::mirror::Array::DataOffset(
@@ -255,6 +272,22 @@ ADD_TEST_EQ(LOCK_WORD_READ_BARRIER_STATE_MASK_TOGGLED,
 #define LOCK_WORD_THIN_LOCK_COUNT_ONE 65536
 ADD_TEST_EQ(LOCK_WORD_THIN_LOCK_COUNT_ONE, static_cast<int32_t>(art::LockWord::kThinLockCountOne))
 
+// Offsets within ShadowFrame.
+#define SHADOWFRAME_NUMBER_OF_VREGS_OFFSET 0
+ADD_TEST_EQ(static_cast<size_t>(SHADOWFRAME_NUMBER_OF_VREGS_OFFSET),
+            art::ShadowFrame::NumberOfVRegsOffset())
+
+#define SHADOWFRAME_DEX_PC_OFFSET (3 * __SIZEOF_POINTER__)
+ADD_TEST_EQ(static_cast<size_t>(SHADOWFRAME_DEX_PC_OFFSET), art::ShadowFrame::DexPCOffset())
+
+#define SHADOWFRAME_VREGS_OFFSET (5 * __SIZEOF_POINTER__)
+ADD_TEST_EQ(static_cast<size_t>(SHADOWFRAME_VREGS_OFFSET), art::ShadowFrame::VRegsOffset())
+
+// Offset of the instructions within DexFile::CodeItem.
+#define CODEITEM_INSNS_OFFSET 16
+ADD_TEST_EQ(static_cast<size_t>(CODEITEM_INSNS_OFFSET),
+            OFFSETOF_MEMBER(art::DexFile::CodeItem, insns_))
+
 #define OBJECT_ALIGNMENT_MASK 7
 ADD_TEST_EQ(static_cast<size_t>(OBJECT_ALIGNMENT_MASK), art::kObjectAlignment - 1)
 
@@ -85,6 +85,10 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "GVN          ",
   "InductionVar ",
   "BCE          ",
+  "LSE          ",
+  "LoopOpt      ",
+  "Scheduler    ",
+  "CodeSinking  ",
   "SsaLiveness  ",
   "SsaPhiElim   ",
   "RefTypeProp  ",
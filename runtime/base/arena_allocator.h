@@ -97,6 +97,10 @@ enum ArenaAllocKind {
   kArenaAllocGvn,
   kArenaAllocInductionVarAnalysis,
   kArenaAllocBoundsCheckElimination,
+  kArenaAllocLSE,
+  kArenaAllocLoopOptimization,
+  kArenaAllocScheduler,
+  kArenaAllocCodeSinking,
   kArenaAllocSsaLiveness,
   kArenaAllocSsaPhiElimination,
   kArenaAllocReferenceTypePropagation,
@@ -81,6 +81,7 @@ enum LockLevel {
   kArenaPoolLock,
   kDexFileMethodInlinerLock,
   kDexFileToMethodInlinerMapLock,
+  kInternTableShardLock,
   kInternTableLock,
   kOatFileSecondaryLookupLock,
   kOatFileCountLock,
@@ -95,6 +96,7 @@ enum LockLevel {
   kAllocatedThreadIdsLock,
   kMonitorPoolLock,
   kMethodVerifiersLock,
+  kClassLoaderClassesLock,
   kClassLinkerClassesLock,
   kBreakpointLock,
   kMonitorLock,
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BASE_WORK_STEALING_DEQUE_H_
+#define ART_RUNTIME_BASE_WORK_STEALING_DEQUE_H_
+
+#include <memory>
+#include <vector>
+
+#include "atomic.h"
+#include "base/bit_utils.h"
+#include "base/logging.h"
+#include "base/macros.h"
+
+namespace art {
+
+// A Chase-Lev work stealing deque of pointers, with the memory orderings of "Correct and
+// Efficient Work-Stealing for Weak Memory Models" (Le et al., PPoPP 2013).
+//
+// Only the owner thread may Push and Pop, at the bottom of the deque. Any thread may Steal, from
+// the top of the deque. Pop and Steal return null when the deque is empty, and Steal also returns
+// null when it loses a race with another Steal or with the last Pop.
+//
+// The array grows when full. The arrays it replaces are kept until the deque is destroyed, since
+// a thief may still be reading from them.
+template <typename T>
+class WorkStealingDeque {
+ public:
+  static constexpr size_t kDefaultInitialCapacity = 64;
+
+  explicit WorkStealingDeque(size_t initial_capacity = kDefaultInitialCapacity)
+      : top_(0), bottom_(0) {
+    DCHECK(IsPowerOfTwo(initial_capacity));
+    arrays_.emplace_back(new Array(initial_capacity));
+    array_.StoreRelaxed(arrays_.back().get());
+  }
+
+  // Owner only.
+  void Push(T* value) {
+    const int64_t bottom = bottom_.LoadRelaxed();
+    const int64_t top = top_.LoadAcquire();
+    Array* array = array_.LoadRelaxed();
+    if (bottom - top > static_cast<int64_t>(array->Capacity()) - 1) {
+      array = Grow(array, top, bottom);
+    }
+    array->Put(bottom, value);
+    bottom_.StoreRelease(bottom + 1);
+  }
+
+  // Owner only.
+  T* Pop() {
+    const int64_t bottom = bottom_.LoadRelaxed() - 1;
+    Array* array = array_.LoadRelaxed();
+    bottom_.StoreRelaxed(bottom);
+    QuasiAtomic::ThreadFenceSequentiallyConsistent();
+    int64_t top = top_.LoadRelaxed();
+    if (top > bottom) {
+      // Empty.
+      bottom_.StoreRelaxed(bottom + 1);
+      return nullptr;
+    }
+    T* value = array->Get(bottom);
+    if (top == bottom) {
+      // Last element, race against the thieves for it.
+      if (!top_.CompareExchangeStrongSequentiallyConsistent(top, top + 1)) {
+        value = nullptr;
+      }
+      bottom_.StoreRelaxed(bottom + 1);
+    }
+    return value;
+  }
+
+  // Any thread.
+  T* Steal() {
+    const int64_t top = top_.LoadAcquire();
+    QuasiAtomic::ThreadFenceSequentiallyConsistent();
+    const int64_t bottom = bottom_.LoadAcquire();
+    if (top >= bottom) {
+      return nullptr;
+    }
+    Array* array = array_.LoadAcquire();
+    T* value = array->Get(top);
+    if (!top_.CompareExchangeStrongSequentiallyConsistent(top, top + 1)) {
+      return nullptr;
+    }
+    return value;
+  }
+
+  // Approximate when called by a thread other than the owner.
+  bool IsEmpty() const {
+    return bottom_.LoadRelaxed() <= top_.LoadRelaxed();
+  }
+
+ private:
+  class Array {
+   public:
+    explicit Array(size_t capacity)
+        : capacity_(capacity), slots_(new Atomic<T*>[capacity]) {}
+
+    size_t Capacity() const {
+      return capacity_;
+    }
+
+    T* Get(int64_t index) const {
+      return slots_[static_cast<size_t>(index) & (capacity_ - 1)].LoadRelaxed();
+    }
+
+    void Put(int64_t index, T* value) {
+      slots_[static_cast<size_t>(index) & (capacity_ - 1)].StoreRelaxed(value);
+    }
+
+   private:
+    const size_t capacity_;
+    std::unique_ptr<Atomic<T*>[]> slots_;
+
+    DISALLOW_COPY_AND_ASSIGN(Array);
+  };
+
+  Array* Grow(Array* array, int64_t top, int64_t bottom) {
+    arrays_.emplace_back(new Array(array->Capacity() * 2));
+    Array* new_array = arrays_.back().get();
+    for (int64_t i = top; i != bottom; ++i) {
+      new_array->Put(i, array->Get(i));
+    }
+    array_.StoreRelease(new_array);
+    return new_array;
+  }
+
+  Atomic<int64_t> top_;
+  Atomic<int64_t> bottom_;
+  Atomic<Array*> array_;
+  // All the arrays used so far, the last one being the current one. Only touched by the owner.
+  std::vector<std::unique_ptr<Array>> arrays_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BASE_WORK_STEALING_DEQUE_H_
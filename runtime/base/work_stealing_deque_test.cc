@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "work_stealing_deque.h"
+
+#include <pthread.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(WorkStealingDeque, PushPopSteal) {
+  // Start small to exercise the growth of the array.
+  WorkStealingDeque<int> deque(4);
+  std::vector<int> values(100);
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_TRUE(deque.Pop() == nullptr);
+  EXPECT_TRUE(deque.Steal() == nullptr);
+  for (int& value : values) {
+    deque.Push(&value);
+  }
+  EXPECT_FALSE(deque.IsEmpty());
+  // The owner pops the most recent value, thieves steal the oldest one.
+  EXPECT_EQ(&values[99], deque.Pop());
+  EXPECT_EQ(&values[0], deque.Steal());
+  EXPECT_EQ(&values[1], deque.Steal());
+  for (size_t i = 98; i >= 2; --i) {
+    EXPECT_EQ(&values[i], deque.Pop());
+  }
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_TRUE(deque.Pop() == nullptr);
+  EXPECT_TRUE(deque.Steal() == nullptr);
+}
+
+struct StealState {
+  WorkStealingDeque<int>* deque;
+  Atomic<bool>* done;
+  int64_t sum;
+};
+
+static void* StealCallback(void* arg) {
+  StealState* state = reinterpret_cast<StealState*>(arg);
+  while (true) {
+    // Read `done` before trying, so that the deque is known to be empty after a failed steal.
+    bool done = state->done->LoadSequentiallyConsistent();
+    int* value = state->deque->Steal();
+    if (value != nullptr) {
+      state->sum += *value;
+    } else if (done && state->deque->IsEmpty()) {
+      break;
+    }
+  }
+  return nullptr;
+}
+
+// Check that concurrent Pop and Steal take each value exactly once.
+TEST(WorkStealingDeque, ConcurrentSteal) {
+  static constexpr size_t kThieves = 4;
+  static constexpr int kValues = 100000;
+  WorkStealingDeque<int> deque(16);
+  Atomic<bool> done(false);
+  std::vector<int> values(kValues);
+  StealState states[kThieves];
+  pthread_t threads[kThieves];
+  for (size_t i = 0; i < kThieves; ++i) {
+    states[i] = { &deque, &done, 0 };
+    ASSERT_EQ(0, pthread_create(&threads[i], nullptr, StealCallback, &states[i]));
+  }
+  int64_t sum = 0;
+  for (int i = 0; i < kValues; ++i) {
+    values[i] = i;
+    deque.Push(&values[i]);
+    if (i % 3 == 0) {
+      int* value = deque.Pop();
+      if (value != nullptr) {
+        sum += *value;
+      }
+    }
+  }
+  // Pop only fails once the deque is empty.
+  int* value = nullptr;
+  while ((value = deque.Pop()) != nullptr) {
+    sum += *value;
+  }
+  done.StoreSequentiallyConsistent(true);
+  for (size_t i = 0; i < kThieves; ++i) {
+    ASSERT_EQ(0, pthread_join(threads[i], nullptr));
+    sum += states[i].sum;
+  }
+  EXPECT_EQ(static_cast<int64_t>(kValues) * (kValues - 1) / 2, sum);
+}
+
+}  // namespace art
@@ -1012,17 +1012,19 @@ void ClassLinker::VisitClassRoots(RootVisitor* visitor, VisitRootFlags flags) {
       }
     }
   } else if ((flags & kVisitRootFlagNewRoots) != 0) {
-    for (auto& root : new_class_roots_) {
-      mirror::Class* old_ref = root.Read<kWithoutReadBarrier>();
-      root.VisitRoot(visitor, RootInfo(kRootStickyClass));
-      mirror::Class* new_ref = root.Read<kWithoutReadBarrier>();
-      // Concurrent moving GC marked new roots through the to-space invariant.
-      CHECK_EQ(new_ref, old_ref);
+    // Each class table logs its new roots. Inserting a class holds the classes lock shared, so the
+    // logs are complete while we hold it exclusively.
+    boot_class_table_.VisitNewRoots(visitor);
+    for (const ClassLoaderData& data : class_loaders_) {
+      data.class_table->VisitNewRoots(visitor);
     }
   }
-  buffered_visitor.Flush();  // Flush before clearing new_class_roots_.
+  buffered_visitor.Flush();  // Flush before clearing the new class roots.
   if ((flags & kVisitRootFlagClearRootLog) != 0) {
-    new_class_roots_.clear();
+    boot_class_table_.ClearNewRoots();
+    for (const ClassLoaderData& data : class_loaders_) {
+      data.class_table->ClearNewRoots();
+    }
   }
   if ((flags & kVisitRootFlagStartLoggingNewRoots) != 0) {
     log_new_class_table_roots_ = true;
@@ -2277,6 +2279,13 @@ void ClassLinker::LoadMethod(Thread* self,
         access_flags |= kAccConstructor;
       }
     }
+  } else if (UNLIKELY((access_flags & kAccNative) != 0)) {
+    if (ArtMethod::IsCriticalNativeMethod(dex_file,
+                                          dex_file.GetClassDef(klass->GetDexClassDefIndex()),
+                                          dex_method_idx,
+                                          access_flags)) {
+      access_flags |= kAccCriticalNative;
+    }
   }
   dst->SetAccessFlags(access_flags);
 }
@@ -2621,9 +2630,16 @@ mirror::Class* ClassLinker::InsertClass(const char* descriptor, mirror::Class* k
     }
     LOG(INFO) << "Loaded class " << descriptor << source;
   }
-  WriterMutexLock mu(Thread::Current(), *Locks::classlinker_classes_lock_);
+  Thread* const self = Thread::Current();
   mirror::ClassLoader* const class_loader = klass->GetClassLoader();
-  ClassTable* const class_table = InsertClassTableForClassLoader(class_loader);
+  ClassTable* class_table = ClassTableForClassLoader(class_loader);
+  if (class_table == nullptr) {
+    WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    class_table = InsertClassTableForClassLoader(class_loader);
+  }
+  // The class table serializes the insertions in the same class loader. We only hold the classes
+  // lock shared, so that class loaders do not contend with each other.
+  ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
   mirror::Class* existing = class_table->Lookup(descriptor, hash);
   if (existing != nullptr) {
     return existing;
@@ -2638,13 +2654,17 @@ mirror::Class* ClassLinker::InsertClass(const char* descriptor, mirror::Class* k
     }
   }
   VerifyObject(klass);
-  class_table->InsertWithHash(klass, hash);
+  existing = class_table->TryInsert(descriptor, klass, hash);
+  if (existing != klass) {
+    // Another thread inserted the class concurrently.
+    return existing;
+  }
   if (class_loader != nullptr) {
     // This is necessary because we need to have the card dirtied for remembered sets.
     Runtime::Current()->GetHeap()->WriteBarrierEveryFieldOf(class_loader);
   }
   if (log_new_class_table_roots_) {
-    new_class_roots_.push_back(GcRoot<mirror::Class>(klass));
+    class_table->RecordNewRoot(klass);
   }
   return nullptr;
 }
@@ -2657,7 +2677,7 @@ void ClassLinker::UpdateClassVirtualMethods(mirror::Class* klass,
 }
 
 bool ClassLinker::RemoveClass(const char* descriptor, mirror::ClassLoader* class_loader) {
-  WriterMutexLock mu(Thread::Current(), *Locks::classlinker_classes_lock_);
+  ReaderMutexLock mu(Thread::Current(), *Locks::classlinker_classes_lock_);
   ClassTable* const class_table = ClassTableForClassLoader(class_loader);
   return class_table != nullptr && class_table->Remove(descriptor);
 }
@@ -2666,14 +2686,12 @@ mirror::Class* ClassLinker::LookupClass(Thread* self,
                                         const char* descriptor,
                                         size_t hash,
                                         mirror::ClassLoader* class_loader) {
-  {
-    ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
-    ClassTable* const class_table = ClassTableForClassLoader(class_loader);
-    if (class_table != nullptr) {
-      mirror::Class* result = class_table->Lookup(descriptor, hash);
-      if (result != nullptr) {
-        return result;
-      }
+  // The class tables are looked up without the classes lock, see ClassTable.
+  ClassTable* const class_table = ClassTableForClassLoader(class_loader);
+  if (class_table != nullptr) {
+    mirror::Class* result = class_table->Lookup(descriptor, hash);
+    if (result != nullptr) {
+      return result;
     }
   }
   if (class_loader != nullptr || !dex_cache_image_class_lookup_required_) {
@@ -2722,15 +2740,12 @@ void ClassLinker::MoveImageClassesToClassTable() {
         DCHECK(klass->GetClassLoader() == nullptr);
         const char* descriptor = klass->GetDescriptor(&temp);
         size_t hash = ComputeModifiedUtf8Hash(descriptor);
-        mirror::Class* existing = class_table->Lookup(descriptor, hash);
-        if (existing != nullptr) {
+        mirror::Class* existing = class_table->TryInsert(descriptor, klass, hash);
+        if (existing != klass) {
           CHECK_EQ(existing, klass) << PrettyClassAndClassLoader(existing) << " != "
               << PrettyClassAndClassLoader(klass);
-        } else {
-          class_table->Insert(klass);
-          if (log_new_class_table_roots_) {
-            new_class_roots_.push_back(GcRoot<mirror::Class>(klass));
-          }
+        } else if (log_new_class_table_roots_) {
+          class_table->RecordNewRoot(klass);
         }
       }
     }
@@ -3987,8 +4002,10 @@ ClassTable* ClassLinker::InsertClassTableForClassLoader(mirror::ClassLoader* cla
     ClassLoaderData data;
     data.weak_root = self->GetJniEnv()->vm->AddWeakGlobalRef(self, class_loader);
     data.class_table = class_table;
-    // Don't already have a class table, add it to the class loader.
+    // Don't already have a class table, add it to the class loader. Lookups read it without the
+    // classes lock, make sure they see it fully constructed.
     CHECK(class_loader->GetClassTable() == nullptr);
+    QuasiAtomic::ThreadFenceRelease();
     class_loader->SetClassTable(data.class_table);
     // Should have been set when we registered the dex file.
     data.allocator = class_loader->GetAllocator();
@@ -4064,9 +4081,11 @@ bool ClassLinker::LinkClass(Thread* self,
     FixupTemporaryDeclaringClass(klass.Get(), h_new_class.Get());
 
     {
-      WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
+      ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
       mirror::ClassLoader* const class_loader = h_new_class.Get()->GetClassLoader();
-      ClassTable* const table = InsertClassTableForClassLoader(class_loader);
+      // The temporary class was inserted in the table, which therefore exists.
+      ClassTable* const table = ClassTableForClassLoader(class_loader);
+      DCHECK(table != nullptr);
       mirror::Class* existing = table->UpdateClass(descriptor, h_new_class.Get(),
                                                    ComputeModifiedUtf8Hash(descriptor));
       if (class_loader != nullptr) {
@@ -4084,7 +4103,7 @@ bool ClassLinker::LinkClass(Thread* self,
         }
       }
       if (log_new_class_table_roots_) {
-        new_class_roots_.push_back(GcRoot<mirror::Class>(h_new_class.Get()));
+        table->RecordNewRoot(h_new_class.Get());
       }
     }
 
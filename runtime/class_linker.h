@@ -815,8 +815,9 @@ class ClassLinker {
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Returns null if not found.
+  // Does not require the classes lock, a class table lives as long as its class loader.
   ClassTable* ClassTableForClassLoader(mirror::ClassLoader* class_loader)
-      SHARED_REQUIRES(Locks::mutator_lock_, Locks::classlinker_classes_lock_);
+      SHARED_REQUIRES(Locks::mutator_lock_);
   // Insert a new class table if not found.
   ClassTable* InsertClassTableForClassLoader(mirror::ClassLoader* class_loader)
       SHARED_REQUIRES(Locks::mutator_lock_)
@@ -874,11 +875,9 @@ class ClassLinker {
   std::list<ClassLoaderData> class_loaders_
       GUARDED_BY(Locks::classlinker_classes_lock_);
 
-  // Boot class path table. Since the class loader for this is null.
-  ClassTable boot_class_table_ GUARDED_BY(Locks::classlinker_classes_lock_);
-
-  // New class roots, only used by CMS since the GC needs to mark these in the pause.
-  std::vector<GcRoot<mirror::Class>> new_class_roots_ GUARDED_BY(Locks::classlinker_classes_lock_);
+  // Boot class path table. Since the class loader for this is null. Like the class loader
+  // tables, it is synchronized by its own lock.
+  ClassTable boot_class_table_;
 
   // Do we need to search dex caches to find image classes?
   bool dex_cache_image_class_lookup_required_;
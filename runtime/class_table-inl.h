@@ -19,24 +19,36 @@
 
 #include "class_table.h"
 
+#include "base/mutex-inl.h"
+#include "thread.h"
+
 namespace art {
 
 template<class Visitor>
 void ClassTable::VisitRoots(Visitor& visitor) {
-  for (ClassSet& class_set : classes_) {
-    for (GcRoot<mirror::Class>& root : class_set) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  // Updating the roots of the published sets in place is fine for the concurrent lookups.
+  for (std::unique_ptr<ClassSet>& class_set : sealed_sets_) {
+    for (GcRoot<mirror::Class>& root : *class_set) {
       visitor.VisitRoot(root.AddressWithoutBarrier());
     }
   }
+  for (GcRoot<mirror::Class>& root : recent_classes_) {
+    visitor.VisitRoot(root.AddressWithoutBarrier());
+  }
 }
 
 template<class Visitor>
 void ClassTable::VisitRoots(const Visitor& visitor) {
-  for (ClassSet& class_set : classes_) {
-    for (GcRoot<mirror::Class>& root : class_set) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  for (std::unique_ptr<ClassSet>& class_set : sealed_sets_) {
+    for (GcRoot<mirror::Class>& root : *class_set) {
       visitor.VisitRoot(root.AddressWithoutBarrier());
     }
   }
+  for (GcRoot<mirror::Class>& root : recent_classes_) {
+    visitor.VisitRoot(root.AddressWithoutBarrier());
+  }
   for (GcRoot<mirror::Object>& root : dex_files_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
@@ -16,36 +16,73 @@
 
 #include "class_table.h"
 
+#include "base/mutex-inl.h"
 #include "mirror/class-inl.h"
+#include "thread.h"
 
 namespace art {
 
-ClassTable::ClassTable() {
+// Minimum number of recent classes before merging them into the published sets.
+static constexpr size_t kMinRecentClassesToMerge = 32;
+// Recent classes get merged once they are this fraction of the classes of the last published set.
+// A larger fraction means less copying, but more lookups taking the lock.
+static constexpr size_t kRecentClassesMergeDivisor = 4;
+
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      num_frozen_sets_(0),
+      recent_classes_(Runtime::Current()->GetHashTableMinLoadFactor(),
+                      Runtime::Current()->GetHashTableMaxLoadFactor()),
+      snapshot_(new Snapshot()),
+      active_lookups_(0),
+      has_retired_sets_(false) {
+}
+
+ClassTable::~ClassTable() {
+  delete snapshot_.LoadRelaxed();
+}
+
+ClassTable::ClassSet* ClassTable::NewClassSet() const {
   Runtime* const runtime = Runtime::Current();
-  classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
-                              runtime->GetHashTableMaxLoadFactor()));
+  return new ClassSet(runtime->GetHashTableMinLoadFactor(), runtime->GetHashTableMaxLoadFactor());
 }
 
 void ClassTable::FreezeSnapshot() {
-  classes_.push_back(ClassSet());
+  WriterMutexLock mu(Thread::Current(), lock_);
+  if (!recent_classes_.Empty()) {
+    MergeRecentClasses();
+  }
+  num_frozen_sets_ = sealed_sets_.size();
 }
 
 bool ClassTable::Contains(mirror::Class* klass) {
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.Find(GcRoot<mirror::Class>(klass));
-    if (it != class_set.end()) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  for (std::unique_ptr<ClassSet>& class_set : sealed_sets_) {
+    auto it = class_set->Find(GcRoot<mirror::Class>(klass));
+    if (it != class_set->end()) {
       return it->Read() == klass;
     }
   }
+  auto it = recent_classes_.Find(GcRoot<mirror::Class>(klass));
+  if (it != recent_classes_.end()) {
+    return it->Read() == klass;
+  }
   return false;
 }
 
 mirror::Class* ClassTable::UpdateClass(const char* descriptor, mirror::Class* klass, size_t hash) {
-  // Should only be updating latest table.
-  auto existing_it = classes_.back().FindWithHash(descriptor, hash);
-  if (kIsDebugBuild && existing_it == classes_.back().end()) {
-    for (const ClassSet& class_set : classes_) {
-      if (class_set.FindWithHash(descriptor, hash) != class_set.end()) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  // Should only be updating latest table: the recent classes, or the last published set if the
+  // classes were merged since the insertion.
+  ClassSet* class_set = &recent_classes_;
+  auto existing_it = class_set->FindWithHash(descriptor, hash);
+  if (existing_it == class_set->end() && sealed_sets_.size() > num_frozen_sets_) {
+    class_set = sealed_sets_.back().get();
+    existing_it = class_set->FindWithHash(descriptor, hash);
+  }
+  if (kIsDebugBuild && existing_it == class_set->end()) {
+    for (size_t i = 0; i < num_frozen_sets_; ++i) {
+      if (sealed_sets_[i]->FindWithHash(descriptor, hash) != sealed_sets_[i]->end()) {
         LOG(FATAL) << "Updating class found in frozen table " << descriptor;
       }
     }
@@ -58,63 +95,226 @@ mirror::Class* ClassTable::UpdateClass(const char* descriptor, mirror::Class* kl
   CHECK(!klass->IsTemp()) << descriptor;
   VerifyObject(klass);
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
-  // doesn't change.
+  // doesn't change, and concurrent lookups see either the old or the new class.
   *existing_it = GcRoot<mirror::Class>(klass);
   return existing;
 }
 
 bool ClassTable::Visit(ClassVisitor* visitor) {
-  for (ClassSet& class_set : classes_) {
-    for (GcRoot<mirror::Class>& root : class_set) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  for (std::unique_ptr<ClassSet>& class_set : sealed_sets_) {
+    for (GcRoot<mirror::Class>& root : *class_set) {
       if (!visitor->Visit(root.Read())) {
         return false;
       }
     }
   }
+  for (GcRoot<mirror::Class>& root : recent_classes_) {
+    if (!visitor->Visit(root.Read())) {
+      return false;
+    }
+  }
   return true;
 }
 
 size_t ClassTable::NumZygoteClasses() const {
+  ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].Size();
+  for (size_t i = 0; i < num_frozen_sets_; ++i) {
+    sum += sealed_sets_[i]->Size();
   }
   return sum;
 }
 
 size_t ClassTable::NumNonZygoteClasses() const {
-  return classes_.back().Size();
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  size_t sum = recent_classes_.Size();
+  for (size_t i = num_frozen_sets_; i < sealed_sets_.size(); ++i) {
+    sum += sealed_sets_[i]->Size();
+  }
+  return sum;
 }
 
 mirror::Class* ClassTable::Lookup(const char* descriptor, size_t hash) {
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.FindWithHash(descriptor, hash);
-    if (it != class_set.end()) {
-     return it->Read();
+  active_lookups_.FetchAndAddSequentiallyConsistent(1);
+  mirror::Class* const klass = LookupInSnapshot(descriptor, hash);
+  if (active_lookups_.FetchAndSubSequentiallyConsistent(1) == 1 &&
+      has_retired_sets_.LoadRelaxed()) {
+    // This was the last lookup in progress, which may have been reading replaced sets.
+    WriterMutexLock mu(Thread::Current(), lock_);
+    ReclaimRetiredSets();
+  }
+  return klass;
+}
+
+mirror::Class* ClassTable::LookupInSnapshot(const char* descriptor, size_t hash) {
+  const Snapshot* const snapshot = snapshot_.LoadSequentiallyConsistent();
+  for (const ClassSet* class_set : snapshot->class_sets) {
+    auto it = class_set->FindWithHash(descriptor, hash);
+    if (it != class_set->end()) {
+      return it->Read();
+    }
+  }
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  auto it = recent_classes_.FindWithHash(descriptor, hash);
+  if (it != recent_classes_.end()) {
+    return it->Read();
+  }
+  if (snapshot_.LoadRelaxed() != snapshot) {
+    // The class may have been merged into a set published after we read the snapshot.
+    return LookupLocked(descriptor, hash);
+  }
+  return nullptr;
+}
+
+mirror::Class* ClassTable::LookupLocked(const char* descriptor, size_t hash) {
+  for (std::unique_ptr<ClassSet>& class_set : sealed_sets_) {
+    auto it = class_set->FindWithHash(descriptor, hash);
+    if (it != class_set->end()) {
+      return it->Read();
     }
   }
+  auto it = recent_classes_.FindWithHash(descriptor, hash);
+  if (it != recent_classes_.end()) {
+    return it->Read();
+  }
   return nullptr;
 }
 
 void ClassTable::Insert(mirror::Class* klass) {
-  classes_.back().Insert(GcRoot<mirror::Class>(klass));
+  WriterMutexLock mu(Thread::Current(), lock_);
+  recent_classes_.Insert(GcRoot<mirror::Class>(klass));
+  MaybeMergeRecentClasses();
 }
 
 void ClassTable::InsertWithHash(mirror::Class* klass, size_t hash) {
-  classes_.back().InsertWithHash(GcRoot<mirror::Class>(klass), hash);
+  WriterMutexLock mu(Thread::Current(), lock_);
+  recent_classes_.InsertWithHash(GcRoot<mirror::Class>(klass), hash);
+  MaybeMergeRecentClasses();
+}
+
+mirror::Class* ClassTable::TryInsert(const char* descriptor, mirror::Class* klass, size_t hash) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  mirror::Class* const existing = LookupLocked(descriptor, hash);
+  if (existing != nullptr) {
+    return existing;
+  }
+  recent_classes_.InsertWithHash(GcRoot<mirror::Class>(klass), hash);
+  MaybeMergeRecentClasses();
+  return klass;
 }
 
 bool ClassTable::Remove(const char* descriptor) {
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.Find(descriptor);
-    if (it != class_set.end()) {
-      class_set.Erase(it);
+  WriterMutexLock mu(Thread::Current(), lock_);
+  auto it = recent_classes_.Find(descriptor);
+  if (it != recent_classes_.end()) {
+    recent_classes_.Erase(it);
+    return true;
+  }
+  for (size_t i = 0; i < sealed_sets_.size(); ++i) {
+    if (sealed_sets_[i]->Find(descriptor) != sealed_sets_[i]->end()) {
+      // Lookups may be searching the published set, remove the class from a copy of it.
+      ClassSet* const copy = new ClassSet(*sealed_sets_[i]);
+      copy->Erase(copy->Find(descriptor));
+      ReplaceSealedSet(i, copy);
       return true;
     }
   }
   return false;
 }
 
+void ClassTable::MaybeMergeRecentClasses() {
+  size_t last_set_size = 0;
+  if (sealed_sets_.size() > num_frozen_sets_) {
+    last_set_size = sealed_sets_.back()->Size();
+  }
+  const size_t threshold =
+      std::max(kMinRecentClassesToMerge, last_set_size / kRecentClassesMergeDivisor);
+  if (recent_classes_.Size() >= threshold) {
+    MergeRecentClasses();
+  }
+}
+
+void ClassTable::MergeRecentClasses() {
+  ClassSet* merged;
+  if (sealed_sets_.size() > num_frozen_sets_) {
+    // Copying the buckets does not need to hash the classes again.
+    merged = new ClassSet(*sealed_sets_.back());
+  } else {
+    merged = NewClassSet();
+  }
+  for (GcRoot<mirror::Class>& root : recent_classes_) {
+    merged->Insert(root);
+  }
+  if (sealed_sets_.size() > num_frozen_sets_) {
+    ReplaceSealedSet(sealed_sets_.size() - 1, merged);
+  } else {
+    sealed_sets_.emplace_back(merged);
+    PublishSnapshot();
+  }
+  // A lookup which read the previous snapshot sees that it changed, and searches the new sets
+  // with the lock held.
+  recent_classes_.Clear();
+}
+
+void ClassTable::ReplaceSealedSet(size_t index, ClassSet* class_set) {
+  retired_sets_.push_back(std::move(sealed_sets_[index]));
+  sealed_sets_[index].reset(class_set);
+  PublishSnapshot();
+}
+
+void ClassTable::PublishSnapshot() {
+  Snapshot* const snapshot = new Snapshot();
+  for (std::unique_ptr<ClassSet>& class_set : sealed_sets_) {
+    snapshot->class_sets.push_back(class_set.get());
+  }
+  retired_snapshots_.emplace_back(snapshot_.LoadRelaxed());
+  has_retired_sets_.StoreRelaxed(true);
+  // Release the contents of the new sets and snapshot to the lookups.
+  snapshot_.StoreSequentiallyConsistent(snapshot);
+  // Usually no lookup is in progress, and the replaced sets are freed right away.
+  ReclaimRetiredSets();
+}
+
+void ClassTable::ReclaimRetiredSets() {
+  if (retired_snapshots_.empty()) {
+    return;
+  }
+  // The snapshot was replaced before this check. A lookup not counted yet reads a later
+  // snapshot, since it counts itself before reading one.
+  if (active_lookups_.LoadSequentiallyConsistent() == 0) {
+    retired_sets_.clear();
+    retired_snapshots_.clear();
+    has_retired_sets_.StoreRelaxed(false);
+  }
+}
+
+size_t ClassTable::NumRetiredSnapshots() const {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  return retired_snapshots_.size();
+}
+
+void ClassTable::RecordNewRoot(mirror::Class* klass) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  new_roots_.push_back(GcRoot<mirror::Class>(klass));
+}
+
+void ClassTable::VisitNewRoots(RootVisitor* visitor) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  for (GcRoot<mirror::Class>& root : new_roots_) {
+    mirror::Class* old_ref = root.Read<kWithoutReadBarrier>();
+    root.VisitRoot(visitor, RootInfo(kRootStickyClass));
+    mirror::Class* new_ref = root.Read<kWithoutReadBarrier>();
+    // Concurrent moving GC marked new roots through the to-space invariant.
+    CHECK_EQ(new_ref, old_ref);
+  }
+}
+
+void ClassTable::ClearNewRoots() {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  new_roots_.clear();
+}
+
 std::size_t ClassTable::ClassDescriptorHashEquals::operator()(const GcRoot<mirror::Class>& root)
     const {
   std::string temp;
@@ -139,6 +339,7 @@ std::size_t ClassTable::ClassDescriptorHashEquals::operator()(const char* descri
 
 bool ClassTable::InsertDexFile(mirror::Object* dex_file) {
   DCHECK(dex_file != nullptr);
+  WriterMutexLock mu(Thread::Current(), lock_);
   for (GcRoot<mirror::Object>& root : dex_files_) {
     if (root.Read() == dex_file) {
       return false;
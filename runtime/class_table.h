@@ -17,10 +17,12 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "atomic.h"
 #include "base/allocator.h"
 #include "base/hash_set.h"
 #include "base/macros.h"
@@ -43,67 +45,100 @@ class ClassVisitor {
   virtual bool Visit(mirror::Class* klass) = 0;
 };
 
-// Each loader has a ClassTable
+// Each loader has a ClassTable, with its own lock so that class loaders do not contend with each
+// other when defining classes.
+//
+// Lookups usually take no lock: the table publishes immutable snapshots of its class sets, in the
+// RCU style, and lookups search the current snapshot. Only the classes inserted since the last
+// snapshot are in a mutable set, searched with the lock held. When that set grows large enough
+// relative to the published ones, it is merged into a copy of the latest published set and a new
+// snapshot is published. The replaced sets are freed once no lookup is in progress, see
+// ReclaimRetiredSets.
 class ClassTable {
  public:
   ClassTable();
+  ~ClassTable();
 
   // Used by image writer for checking.
   bool Contains(mirror::Class* klass)
-      REQUIRES(Locks::classlinker_classes_lock_)
+      REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Freeze the current class tables by allocating a new table and never updating or modifying the
   // existing table. This helps prevents dirty pages after caused by inserting after zygote fork.
   void FreezeSnapshot()
-      REQUIRES(Locks::classlinker_classes_lock_)
+      REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Returns the number of classes in previous snapshots.
-  size_t NumZygoteClasses() const SHARED_REQUIRES(Locks::classlinker_classes_lock_);
+  size_t NumZygoteClasses() const REQUIRES(!lock_);
 
   // Returns all off the classes in the lastest snapshot.
-  size_t NumNonZygoteClasses() const SHARED_REQUIRES(Locks::classlinker_classes_lock_);
+  size_t NumNonZygoteClasses() const REQUIRES(!lock_);
+
+  // Returns the number of replaced snapshots not freed yet, for testing.
+  size_t NumRetiredSnapshots() const REQUIRES(!lock_);
 
   // Update a class in the table with the new class. Returns the existing class which was replaced.
   mirror::Class* UpdateClass(const char* descriptor, mirror::Class* new_klass, size_t hash)
-      REQUIRES(Locks::classlinker_classes_lock_)
+      REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   // NO_THREAD_SAFETY_ANALYSIS for object marking requiring heap bitmap lock.
   template<class Visitor>
   void VisitRoots(Visitor& visitor)
       NO_THREAD_SAFETY_ANALYSIS
-      SHARED_REQUIRES(Locks::classlinker_classes_lock_, Locks::mutator_lock_);
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
   template<class Visitor>
   void VisitRoots(const Visitor& visitor)
       NO_THREAD_SAFETY_ANALYSIS
-      SHARED_REQUIRES(Locks::classlinker_classes_lock_, Locks::mutator_lock_);
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Return false if the callback told us to exit.
   bool Visit(ClassVisitor* visitor)
-      SHARED_REQUIRES(Locks::classlinker_classes_lock_, Locks::mutator_lock_);
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Does not take the lock of the table if the class is in the published snapshot.
   mirror::Class* Lookup(const char* descriptor, size_t hash)
-      SHARED_REQUIRES(Locks::classlinker_classes_lock_, Locks::mutator_lock_);
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
 
   void Insert(mirror::Class* klass)
-      REQUIRES(Locks::classlinker_classes_lock_)
+      REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
   void InsertWithHash(mirror::Class* klass, size_t hash)
-      REQUIRES(Locks::classlinker_classes_lock_)
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Insert `klass` unless the table already has a class with the same descriptor. Returns the
+  // class in the table for that descriptor, `klass` if it was inserted.
+  mirror::Class* TryInsert(const char* descriptor, mirror::Class* klass, size_t hash)
+      REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Returns true if the class was found and removed, false otherwise.
   bool Remove(const char* descriptor)
-      REQUIRES(Locks::classlinker_classes_lock_)
+      REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Return true if we inserted the dex file, false if it already exists.
   bool InsertDexFile(mirror::Object* dex_file)
-      REQUIRES(Locks::classlinker_classes_lock_)
+      REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Log of the classes inserted while the GC needs to mark them in its pause, see
+  // ClassLinker::VisitClassRoots.
+  void RecordNewRoot(mirror::Class* klass)
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  void VisitNewRoots(RootVisitor* visitor)
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  void ClearNewRoots() REQUIRES(!lock_);
+
  private:
   class ClassDescriptorHashEquals {
    public:
@@ -131,12 +166,71 @@ class ClassTable {
       ClassDescriptorHashEquals, TrackingAllocator<GcRoot<mirror::Class>, kAllocatorTagClassTable>>
       ClassSet;
 
-  // TODO: shard lock to have one per class loader.
-  // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(Locks::classlinker_classes_lock_);
+  // The sets searched by lookups without the lock. Never modified once published.
+  struct Snapshot {
+    std::vector<const ClassSet*> class_sets;
+  };
+
+  // Merge `recent_classes_` into the sealed sets if it got large enough.
+  void MaybeMergeRecentClasses() REQUIRES(lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+  void MergeRecentClasses() REQUIRES(lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Replace the sealed set at `index` with `class_set`, and publish the change.
+  void ReplaceSealedSet(size_t index, ClassSet* class_set) REQUIRES(lock_);
+
+  // Publish a new snapshot of `sealed_sets_` for the lookups.
+  void PublishSnapshot() REQUIRES(lock_);
+
+  // Free the replaced sets and snapshots if no lookup is in progress. Called after publishing a
+  // snapshot, and by the last of the concurrent lookups, so that the sets do not wait for a GC
+  // or another insertion to be freed.
+  void ReclaimRetiredSets() REQUIRES(lock_);
+
+  // Lookup, with `active_lookups_` counting the caller.
+  mirror::Class* LookupInSnapshot(const char* descriptor, size_t hash)
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  mirror::Class* LookupLocked(const char* descriptor, size_t hash)
+      REQUIRES(lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  ClassSet* NewClassSet() const;
+
+  // Guards all the fields but `snapshot_`. Ordered just before the class linker classes lock, so
+  // that the class linker may hold it while using the table.
+  mutable ReaderWriterMutex lock_;
+
+  // The published sets. We have a vector to help prevent dirty pages after the zygote forks by
+  // calling FreezeSnapshot: the first `num_frozen_sets_` sets are never copied, the last set, if
+  // not frozen, gets the recent classes merged into a copy of it.
+  std::vector<std::unique_ptr<ClassSet>> sealed_sets_ GUARDED_BY(lock_);
+  size_t num_frozen_sets_ GUARDED_BY(lock_);
+
+  // Classes inserted since the last merge.
+  ClassSet recent_classes_ GUARDED_BY(lock_);
+
+  // The snapshot currently published, owned by the table.
+  Atomic<const Snapshot*> snapshot_;
+
+  // Number of lookups which may be reading a snapshot. A lookup counts itself before reading the
+  // snapshot, and `snapshot_` is replaced before the count is checked, both sequentially
+  // consistent, so that a lookup counted too late to be seen reads the new snapshot.
+  AtomicInteger active_lookups_;
+
+  // Sets and snapshots replaced, and whether there are any, which lookups read without the lock.
+  std::vector<std::unique_ptr<ClassSet>> retired_sets_ GUARDED_BY(lock_);
+  std::vector<std::unique_ptr<const Snapshot>> retired_snapshots_ GUARDED_BY(lock_);
+  Atomic<bool> has_retired_sets_;
+
+  // Classes logged by RecordNewRoot.
+  std::vector<GcRoot<mirror::Class>> new_roots_ GUARDED_BY(lock_);
+
   // Dex files used by the class loader which may not be owned by the class loader. We keep these
   // live so that we do not have issues closing any of the dex files.
-  std::vector<GcRoot<mirror::Object>> dex_files_ GUARDED_BY(Locks::classlinker_classes_lock_);
+  std::vector<GcRoot<mirror::Object>> dex_files_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(ClassTable);
 };
 
 }  // namespace art
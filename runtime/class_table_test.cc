@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_table-inl.h"
+
+#include <string>
+#include <vector>
+
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change.h"
+#include "utf.h"
+
+namespace art {
+
+class CollectClassesVisitor : public ClassVisitor {
+ public:
+  explicit CollectClassesVisitor(std::vector<mirror::Class*>* classes) : classes_(classes) {}
+
+  bool Visit(mirror::Class* klass) OVERRIDE {
+    classes_->push_back(klass);
+    return true;
+  }
+
+ private:
+  std::vector<mirror::Class*>* const classes_;
+};
+
+class ClassTableTest : public CommonRuntimeTest {
+ protected:
+  // Returns the classes of the boot class path, which have distinct descriptors.
+  std::vector<mirror::Class*> GetBootClasses() SHARED_REQUIRES(Locks::mutator_lock_) {
+    std::vector<mirror::Class*> classes;
+    CollectClassesVisitor visitor(&classes);
+    class_linker_->VisitClasses(&visitor);
+    return classes;
+  }
+
+  static mirror::Class* Lookup(ClassTable* table, mirror::Class* klass)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    std::string temp;
+    const char* descriptor = klass->GetDescriptor(&temp);
+    return table->Lookup(descriptor, ComputeModifiedUtf8Hash(descriptor));
+  }
+};
+
+TEST_F(ClassTableTest, InsertAndLookup) {
+  ScopedObjectAccess soa(Thread::Current());
+  std::vector<mirror::Class*> classes = GetBootClasses();
+  // Enough classes for the recent classes to be merged into published sets several times.
+  ASSERT_GT(classes.size(), 256u);
+  ClassTable table;
+  for (size_t i = 0; i < classes.size(); ++i) {
+    ASSERT_TRUE(Lookup(&table, classes[i]) == nullptr);
+    table.Insert(classes[i]);
+    ASSERT_EQ(classes[i], Lookup(&table, classes[i]));
+  }
+  for (mirror::Class* klass : classes) {
+    ASSERT_EQ(klass, Lookup(&table, klass));
+  }
+  EXPECT_EQ(classes.size(), table.NumNonZygoteClasses());
+  EXPECT_EQ(0u, table.NumZygoteClasses());
+
+  std::vector<mirror::Class*> visited;
+  CollectClassesVisitor visitor(&visited);
+  table.Visit(&visitor);
+  EXPECT_EQ(classes.size(), visited.size());
+}
+
+TEST_F(ClassTableTest, ReclaimRetiredSnapshots) {
+  ScopedObjectAccess soa(Thread::Current());
+  std::vector<mirror::Class*> classes = GetBootClasses();
+  ASSERT_GT(classes.size(), 256u);
+  ClassTable table;
+  // No lookup is in progress when a snapshot is replaced, so the replaced sets are freed right
+  // away, without waiting for a GC.
+  for (size_t i = 0; i < classes.size(); ++i) {
+    table.Insert(classes[i]);
+    ASSERT_EQ(classes[i], Lookup(&table, classes[i]));
+    ASSERT_EQ(0u, table.NumRetiredSnapshots());
+  }
+  std::string temp;
+  EXPECT_TRUE(table.Remove(classes[0]->GetDescriptor(&temp)));
+  EXPECT_EQ(0u, table.NumRetiredSnapshots());
+}
+
+TEST_F(ClassTableTest, TryInsert) {
+  ScopedObjectAccess soa(Thread::Current());
+  std::vector<mirror::Class*> classes = GetBootClasses();
+  ASSERT_GT(classes.size(), 2u);
+  ClassTable table;
+  std::string temp;
+  const char* descriptor = classes[0]->GetDescriptor(&temp);
+  const size_t hash = ComputeModifiedUtf8Hash(descriptor);
+  EXPECT_EQ(classes[0], table.TryInsert(descriptor, classes[0], hash));
+  // A class with the same descriptor is not inserted, the existing one is returned.
+  EXPECT_EQ(classes[0], table.TryInsert(descriptor, classes[1], hash));
+  EXPECT_EQ(1u, table.NumNonZygoteClasses());
+  EXPECT_TRUE(table.Contains(classes[0]));
+  EXPECT_FALSE(table.Contains(classes[1]));
+}
+
+TEST_F(ClassTableTest, RemoveAndFreeze) {
+  ScopedObjectAccess soa(Thread::Current());
+  std::vector<mirror::Class*> classes = GetBootClasses();
+  ASSERT_GT(classes.size(), 256u);
+  ClassTable table;
+  const size_t num_frozen = classes.size() / 2;
+  for (size_t i = 0; i < num_frozen; ++i) {
+    table.Insert(classes[i]);
+  }
+  table.FreezeSnapshot();
+  for (size_t i = num_frozen; i < classes.size(); ++i) {
+    table.Insert(classes[i]);
+  }
+  EXPECT_EQ(num_frozen, table.NumZygoteClasses());
+  EXPECT_EQ(classes.size() - num_frozen, table.NumNonZygoteClasses());
+
+  // Remove classes from the frozen sets, the published sets and the recent classes.
+  std::string temp;
+  for (size_t i : { static_cast<size_t>(0), num_frozen, classes.size() - 1 }) {
+    EXPECT_TRUE(table.Remove(classes[i]->GetDescriptor(&temp)));
+    EXPECT_FALSE(table.Remove(classes[i]->GetDescriptor(&temp)));
+    EXPECT_TRUE(Lookup(&table, classes[i]) == nullptr);
+  }
+  for (size_t i = 1; i < classes.size() - 1; ++i) {
+    if (i != num_frozen) {
+      ASSERT_EQ(classes[i], Lookup(&table, classes[i]));
+    }
+  }
+  EXPECT_EQ(classes.size() - 3, table.NumZygoteClasses() + table.NumNonZygoteClasses());
+}
+
+}  // namespace art
@@ -181,6 +181,12 @@ class CheckJniAbortCatcher {
     return; \
   }
 
+#define TEST_DISABLED_WITHOUT_READ_BARRIER() \
+  if (!kUseReadBarrier) { \
+    printf("WARNING: TEST DISABLED WITHOUT READ BARRIER\n"); \
+    return; \
+  }
+
 #define TEST_DISABLED_FOR_MIPS() \
   if (kRuntimeISA == kMips) { \
     printf("WARNING: TEST DISABLED FOR MIPS\n"); \
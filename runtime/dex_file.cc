@@ -1295,6 +1295,29 @@ bool DexFile::IsMethodAnnotationPresent(ArtMethod* method, Handle<mirror::Class>
   return annotation_item != nullptr;
 }
 
+bool DexFile::IsMethodAnnotationPresent(const ClassDef& class_def,
+                                        uint32_t method_idx,
+                                        const char* descriptor,
+                                        uint32_t visibility) const {
+  const AnnotationsDirectoryItem* annotations_dir = GetAnnotationsDirectory(class_def);
+  if (annotations_dir == nullptr) {
+    return false;
+  }
+  const MethodAnnotationsItem* method_annotations = GetMethodAnnotations(annotations_dir);
+  if (method_annotations == nullptr) {
+    return false;
+  }
+  uint32_t method_count = annotations_dir->methods_size_;
+  for (uint32_t i = 0; i < method_count; ++i) {
+    if (method_annotations[i].method_idx_ == method_idx) {
+      const AnnotationSetItem* annotation_set = GetMethodAnnotationSetItem(method_annotations[i]);
+      return annotation_set != nullptr &&
+          SearchAnnotationSet(annotation_set, descriptor, visibility) != nullptr;
+    }
+  }
+  return false;
+}
+
 const DexFile::AnnotationSetItem* DexFile::FindAnnotationSetForClass(Handle<mirror::Class> klass)
     const {
   const AnnotationsDirectoryItem* annotations_dir = GetAnnotationsDirectory(*klass->GetClassDef());
@@ -952,6 +952,13 @@ class DexFile {
       SHARED_REQUIRES(Locks::mutator_lock_);
   bool IsMethodAnnotationPresent(ArtMethod* method, Handle<mirror::Class> annotation_class) const
       SHARED_REQUIRES(Locks::mutator_lock_);
+  // Looks for an annotation of the given type and visibility on a method directly in the dex
+  // file. Unlike the lookups above, this needs neither the method nor its class to be loaded,
+  // so the class linker and the compiler can use it for build-time annotations.
+  bool IsMethodAnnotationPresent(const ClassDef& class_def,
+                                 uint32_t method_idx,
+                                 const char* descriptor,
+                                 uint32_t visibility) const;
 
   const AnnotationSetItem* FindAnnotationSetForClass(Handle<mirror::Class> klass) const
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -1016,8 +1023,7 @@ class DexFile {
                                            const uint8_t** annotation) const
       SHARED_REQUIRES(Locks::mutator_lock_);
   const AnnotationItem* SearchAnnotationSet(const AnnotationSetItem* annotation_set,
-                                            const char* descriptor, uint32_t visibility) const
-      SHARED_REQUIRES(Locks::mutator_lock_);
+                                            const char* descriptor, uint32_t visibility) const;
   const uint8_t* SearchEncodedAnnotation(const uint8_t* annotation, const char* name) const
       SHARED_REQUIRES(Locks::mutator_lock_);
   bool SkipAnnotationValue(const uint8_t** annotation_ptr) const
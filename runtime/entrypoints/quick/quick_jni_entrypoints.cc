@@ -36,7 +36,8 @@ extern uint32_t JniMethodStart(Thread* self) {
   uint32_t saved_local_ref_cookie = env->local_ref_cookie;
   env->local_ref_cookie = env->locals.GetSegmentState();
   ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
-  if (!native_method->IsFastNative()) {
+  // Only the generic JNI stub gets here for critical natives, which stay runnable like fast ones.
+  if (!native_method->IsFastNative() && !native_method->IsCriticalNative()) {
     // When not fast JNI we transition out of runnable.
     self->TransitionFromRunnableToSuspended(kNative);
   }
@@ -51,7 +52,7 @@ extern uint32_t JniMethodStartSynchronized(jobject to_lock, Thread* self) {
 // TODO: NO_THREAD_SAFETY_ANALYSIS due to different control paths depending on fast JNI.
 static void GoToRunnable(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
   ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
-  bool is_fast = native_method->IsFastNative();
+  bool is_fast = native_method->IsFastNative() || native_method->IsCriticalNative();
   if (!is_fast) {
     self->TransitionFromSuspendedToRunnable();
   } else if (UNLIKELY(self->TestAllFlags())) {
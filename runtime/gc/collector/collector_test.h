@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_COLLECTOR_COLLECTOR_TEST_H_
+#define ART_RUNTIME_GC_COLLECTOR_COLLECTOR_TEST_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/stringprintf.h"
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string-inl.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+class CollectorTest : public CommonRuntimeTest {
+ protected:
+  static mirror::ObjectArray<mirror::Object>* AllocArray(Thread* self,
+                                                         mirror::Class* array_class,
+                                                         size_t length)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    mirror::ObjectArray<mirror::Object>* array =
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class, length);
+    CHECK(array != nullptr);
+    return array;
+  }
+
+  static mirror::String* AllocString(Thread* self, const std::string& value)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    mirror::String* string = mirror::String::AllocFromModifiedUtf8(self, value.c_str());
+    CHECK(string != nullptr);
+    return string;
+  }
+
+  // Allocates strings that die right away.
+  static void AllocGarbage(Thread* self, size_t count) SHARED_REQUIRES(Locks::mutator_lock_) {
+    for (size_t i = 0; i < count; ++i) {
+      AllocString(self, StringPrintf("garbage %zu", i));
+    }
+  }
+
+  // Runs an explicit full collection.
+  static void CollectFull(Thread* self) {
+    ScopedThreadSuspension sts(self, kNative);
+    Runtime::Current()->GetHeap()->CollectGarbage(false);
+  }
+
+  // A complete binary tree of object arrays. Node i holds its children 2i+1 and 2i+2, its name
+  // "node i" and element i % num_leaves of an array of strings shared by all the nodes. The
+  // nodes of the level four above the leaves are also roots, so that a collector reaches them,
+  // and what they reference, both from a handle and from their parent. The tree must be built
+  // after the other handle scopes of the test, and live as long as them.
+  class ObjectTree {
+   public:
+    ObjectTree(Thread* self, size_t depth, size_t num_leaves)
+        SHARED_REQUIRES(Locks::mutator_lock_)
+        : size_((1u << depth) - 1),
+          first_root_node_((1u << (depth - 4)) - 1),
+          num_root_nodes_(1u << (depth - 4)),
+          hs_(self),
+          root_scopes_(self) {
+      Handle<mirror::Class> array_class(hs_.NewHandle(
+          Runtime::Current()->GetClassLinker()->FindSystemClass(self, "[Ljava/lang/Object;")));
+      leaves_ = hs_.NewHandle(AllocArray(self, array_class.Get(), num_leaves));
+      for (size_t i = 0; i < num_leaves; ++i) {
+        leaves_->Set<false>(i, AllocString(self, StringPrintf("leaf %zu", i)));
+      }
+      // Allocate the nodes in a temporary array, link them, then only keep the roots.
+      MutableHandle<mirror::ObjectArray<mirror::Object>> nodes(
+          hs_.NewHandle(AllocArray(self, array_class.Get(), size_)));
+      for (size_t i = 0; i < size_; ++i) {
+        nodes->Set<false>(i, AllocArray(self, array_class.Get(), kNodeLength));
+        mirror::String* name = AllocString(self, StringPrintf("node %zu", i));
+        mirror::ObjectArray<mirror::Object>* node = nodes->Get(i)->AsObjectArray<mirror::Object>();
+        node->Set<false>(kName, name);
+        node->Set<false>(kLeaf, leaves_->Get(i % num_leaves));
+      }
+      for (size_t i = 0; 2 * i + 1 < size_; ++i) {
+        mirror::ObjectArray<mirror::Object>* node = nodes->Get(i)->AsObjectArray<mirror::Object>();
+        node->Set<false>(kLeft, nodes->Get(2 * i + 1));
+        node->Set<false>(kRight, nodes->Get(2 * i + 2));
+      }
+      root_ = hs_.NewHandle(nodes->Get(0));
+      for (size_t i = 0; i < num_root_nodes_; ++i) {
+        root_nodes_.push_back(root_scopes_.NewHandle(nodes->Get(first_root_node_ + i)));
+      }
+      nodes.Assign(nullptr);
+    }
+
+    size_t Size() const {
+      return size_;
+    }
+
+    mirror::ObjectArray<mirror::Object>* GetLeaves() const SHARED_REQUIRES(Locks::mutator_lock_) {
+      return leaves_.Get();
+    }
+
+    // Checks every node of the tree, and that the objects reachable from several places were
+    // not copied twice: the leaves must be the elements of the leaf array, and the root nodes
+    // the objects of their handles. Returns the number of nodes found.
+    size_t Check() const SHARED_REQUIRES(Locks::mutator_lock_) {
+      mirror::ObjectArray<mirror::Object>* leaves = leaves_.Get();
+      for (size_t i = 0; i < static_cast<size_t>(leaves->GetLength()); ++i) {
+        mirror::Object* leaf = leaves->Get(i);
+        EXPECT_TRUE(leaf != nullptr && leaf->IsString()) << i;
+        if (leaf != nullptr && leaf->IsString()) {
+          EXPECT_EQ(StringPrintf("leaf %zu", i), leaf->AsString()->ToModifiedUtf8());
+        }
+      }
+      size_t count = 0;
+      std::vector<std::pair<mirror::Object*, size_t>> work;
+      work.push_back(std::make_pair(root_.Get(), 0u));
+      while (!work.empty()) {
+        mirror::Object* obj = work.back().first;
+        const size_t i = work.back().second;
+        work.pop_back();
+        if (i >= size_) {
+          EXPECT_TRUE(obj == nullptr) << i;
+          continue;
+        }
+        ++count;
+        EXPECT_TRUE(obj != nullptr && obj->IsObjectArray()) << i;
+        if (obj == nullptr || !obj->IsObjectArray()) {
+          continue;
+        }
+        mirror::ObjectArray<mirror::Object>* node = obj->AsObjectArray<mirror::Object>();
+        mirror::Object* name = node->Get(kName);
+        EXPECT_TRUE(name != nullptr && name->IsString()) << i;
+        if (name != nullptr && name->IsString()) {
+          EXPECT_EQ(StringPrintf("node %zu", i), name->AsString()->ToModifiedUtf8());
+        }
+        EXPECT_EQ(leaves->Get(i % leaves->GetLength()), node->Get(kLeaf)) << i;
+        if (i >= first_root_node_ && i < first_root_node_ + num_root_nodes_) {
+          EXPECT_EQ(root_nodes_[i - first_root_node_].Get(), node) << i;
+        }
+        work.push_back(std::make_pair(node->Get(kLeft), 2 * i + 1));
+        work.push_back(std::make_pair(node->Get(kRight), 2 * i + 2));
+      }
+      return count;
+    }
+
+   private:
+    enum NodeField {
+      kLeft,
+      kRight,
+      kName,
+      kLeaf,
+      kNodeLength,
+    };
+
+    const size_t size_;
+    const size_t first_root_node_;
+    const size_t num_root_nodes_;
+    StackHandleScope<4> hs_;
+    StackHandleScopeCollection root_scopes_;
+    Handle<mirror::ObjectArray<mirror::Object>> leaves_;
+    Handle<mirror::Object> root_;
+    std::vector<MutableHandle<mirror::Object>> root_nodes_;
+  };
+};
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_COLLECTOR_COLLECTOR_TEST_H_
@@ -19,10 +19,12 @@
 #include "art_field-inl.h"
 #include "base/stl_util.h"
 #include "debugger.h"
+#include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "gc/reference_processor.h"
 #include "gc/space/image_space.h"
+#include "gc/space/region_space-inl.h"
 #include "gc/space/space.h"
 #include "intern_table.h"
 #include "mirror/class-inl.h"
@@ -30,13 +32,21 @@
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
 namespace gc {
 namespace collector {
 
-ConcurrentCopying::ConcurrentCopying(Heap* heap, const std::string& name_prefix)
+// Below this number of refs to process, marking is not worth spreading over several threads.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
+// Parallel marking tasks only share the refs of their mark stack above this size.
+static constexpr size_t kMinimumSharedMarkStackSize = 32;
+
+ConcurrentCopying::ConcurrentCopying(Heap* heap,
+                                     bool use_generational_cc,
+                                     const std::string& name_prefix)
     : GarbageCollector(heap,
                        name_prefix + (name_prefix.empty() ? "" : " ") +
                        "concurrent copying + mark sweep"),
@@ -44,13 +54,15 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap, const std::string& name_prefix)
       gc_mark_stack_(accounting::ObjectStack::Create("concurrent copying gc mark stack",
                                                      2 * MB, 2 * MB)),
       mark_stack_lock_("concurrent copying mark stack lock", kMarkSweepMarkStackLock),
+      num_active_marking_tasks_(0), num_waiting_marking_tasks_(0),
+      parallel_marking_cond_("concurrent copying parallel marking condition", mark_stack_lock_),
       thread_running_gc_(nullptr),
       is_marking_(false), is_active_(false), is_asserting_to_space_invariant_(false),
       heap_mark_bitmap_(nullptr), live_stack_freeze_size_(0), mark_stack_mode_(kMarkStackModeOff),
       weak_ref_access_enabled_(true),
       skipped_blocks_lock_("concurrent copying bytes blocks lock", kMarkSweepMarkStackLock),
       rb_table_(heap_->GetReadBarrierTable()),
-      force_evacuate_all_(false) {
+      force_evacuate_all_(false), use_generational_cc_(use_generational_cc), young_gen_(false) {
   static_assert(space::RegionSpace::kRegionSize == accounting::ReadBarrierTable::kRegionSize,
                 "The region space size and the read barrier table region size must match");
   cc_heap_bitmap_.reset(new accounting::HeapBitmap(heap));
@@ -164,6 +176,7 @@ void ConcurrentCopying::InitializePhase() {
   immune_region_.Reset();
   bytes_moved_.StoreRelaxed(0);
   objects_moved_.StoreRelaxed(0);
+  parallel_marking_stats_.clear();
   if (GetCurrentIteration()->GetGcCause() == kGcCauseExplicit ||
       GetCurrentIteration()->GetGcCause() == kGcCauseForNativeAlloc ||
       GetCurrentIteration()->GetClearSoftReferences()) {
@@ -172,8 +185,11 @@ void ConcurrentCopying::InitializePhase() {
     force_evacuate_all_ = false;
   }
   BindBitmaps();
+  if (use_generational_cc_) {
+    AgeCards();
+  }
   if (kVerboseMode) {
-    LOG(INFO) << "force_evacuate_all=" << force_evacuate_all_;
+    LOG(INFO) << "force_evacuate_all=" << force_evacuate_all_ << " young_gen=" << young_gen_;
     LOG(INFO) << "Immune region: " << immune_region_.Begin() << "-" << immune_region_.End();
     LOG(INFO) << "GC end of InitializePhase";
   }
@@ -230,15 +246,24 @@ class FlipCallback : public Closure {
     Thread* self = Thread::Current();
     CHECK(thread == self);
     Locks::mutator_lock_->AssertExclusiveHeld(self);
-    cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_);
+    cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_, cc->young_gen_);
     cc->SwapStacks();
     if (ConcurrentCopying::kEnableFromSpaceAccountingCheck) {
       cc->RecordLiveStackFreezeSize(self);
-      cc->from_space_num_objects_at_first_pause_ = cc->region_space_->GetObjectsAllocated();
-      cc->from_space_num_bytes_at_first_pause_ = cc->region_space_->GetBytesAllocated();
+      // The old regions of a young generation collection stay in the to-space.
+      cc->from_space_num_objects_at_first_pause_ =
+          cc->region_space_->GetObjectsAllocatedInFromSpace() +
+          cc->region_space_->GetObjectsAllocatedInUnevacFromSpace();
+      cc->from_space_num_bytes_at_first_pause_ =
+          cc->region_space_->GetBytesAllocatedInFromSpace() +
+          cc->region_space_->GetBytesAllocatedInUnevacFromSpace();
     }
     cc->is_marking_ = true;
     cc->mark_stack_mode_.StoreRelaxed(ConcurrentCopying::kMarkStackModeThreadLocal);
+    if (cc->young_gen_) {
+      TimingLogger::ScopedTiming split2("(Paused)PushOldObjectsOnCards", cc->GetTimings());
+      cc->PushOldObjectsOnCards();
+    }
     if (UNLIKELY(Runtime::Current()->IsActiveTransaction())) {
       CHECK(Runtime::Current()->IsAotCompiler());
       TimingLogger::ScopedTiming split2("(Paused)VisitTransactionRoots", cc->GetTimings());
@@ -288,6 +313,94 @@ void ConcurrentCopying::RecordLiveStackFreezeSize(Thread* self) {
   live_stack_freeze_size_ = heap_->GetLiveStack()->Size();
 }
 
+// Age the cards of the region space and the non-moving space. The cards dirtied since the last
+// collection become aged, the others are cleared. A young generation collection then scans the
+// objects on dirty or aged cards, the old objects modified since the last collection.
+void ConcurrentCopying::AgeCards() {
+  TimingLogger::ScopedTiming split("AgeCards", GetTimings());
+  accounting::CardTable* card_table = heap_->GetCardTable();
+  // The mutators keep dirtying cards concurrently, hence the atomic update.
+  card_table->ModifyCardsAtomic(region_space_->Begin(), region_space_->End(), AgeCardVisitor(),
+                                VoidFunctor());
+  space::MallocSpace* non_moving_space = heap_->GetNonMovingSpace();
+  card_table->ModifyCardsAtomic(non_moving_space->Begin(), non_moving_space->End(),
+                                AgeCardVisitor(), VoidFunctor());
+}
+
+// Used to push the old objects that may refer to young objects onto the mark stack.
+class ConcurrentCopyingOldObjectVisitor {
+ public:
+  explicit ConcurrentCopyingOldObjectVisitor(ConcurrentCopying* cc)
+      : collector_(cc) {}
+
+  void operator()(mirror::Object* obj) const SHARED_REQUIRES(Locks::mutator_lock_) {
+    collector_->PushOldObject(obj);
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+// Push the objects that a young generation collection must trace through although it does not
+// collect them, during the flip pause: the old objects on a dirty or aged card, and the
+// non-moving and large objects allocated since the last collection, which the card aging does
+// not cover. They are grayed before the mutators resume, as they may hold from-space refs.
+void ConcurrentCopying::PushOldObjectsOnCards() {
+  DCHECK(young_gen_);
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  accounting::CardTable* card_table = heap_->GetCardTable();
+  ConcurrentCopyingOldObjectVisitor visitor(this);
+  region_space_->VisitOldObjectsOnCards(card_table, accounting::CardTable::kCardDirty - 1,
+                                        visitor);
+  ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  space::MallocSpace* non_moving_space = heap_->GetNonMovingSpace();
+  card_table->Scan<false>(non_moving_space->GetLiveBitmap(),
+                          non_moving_space->Begin(),
+                          non_moving_space->End(),
+                          visitor,
+                          accounting::CardTable::kCardDirty - 1);
+  // The allocation stack was just swapped with the live stack.
+  accounting::ObjectStack* live_stack = heap_->GetLiveStack();
+  for (StackReference<mirror::Object>* it = live_stack->Begin(); it != live_stack->End(); ++it) {
+    mirror::Object* obj = it->AsMirrorPtr();
+    // Revoked thread-local allocation stacks may leave null entries.
+    if (obj != nullptr) {
+      visitor(obj);
+    }
+  }
+}
+
+inline void ConcurrentCopying::PushOldObject(mirror::Object* obj) {
+  DCHECK(!immune_region_.ContainsObject(obj));
+  if (region_space_->HasAddress(obj)) {
+    // Each old region object is visited once.
+    DCHECK(region_space_->IsInToSpace(obj)) << obj;
+  } else {
+    // Non-moving objects may be visited twice, from a card and from the live stack. Push them
+    // once, using their mark bit which ClearBlackPtrs() relies on.
+    accounting::ContinuousSpaceBitmap* mark_bitmap =
+        heap_mark_bitmap_->GetContinuousSpaceBitmap(obj);
+    if (mark_bitmap != nullptr) {
+      if (mark_bitmap->AtomicTestAndSet(obj)) {
+        return;
+      }
+    } else {
+      accounting::LargeObjectBitmap* los_bitmap = heap_mark_bitmap_->GetLargeObjectBitmap(obj);
+      CHECK(los_bitmap != nullptr) << "LOS bitmap covers the entire address range";
+      if (los_bitmap->AtomicTestAndSet(obj)) {
+        return;
+      }
+    }
+  }
+  if (kUseBakerReadBarrier) {
+    bool success = obj->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(),
+                                                    ReadBarrier::GrayPtr());
+    CHECK(success) << obj << " " << obj->GetReadBarrierPointer();
+  }
+  PushOntoMarkStack(obj);
+}
+
 // Used to visit objects in the immune spaces.
 class ConcurrentCopyingImmuneSpaceObjVisitor {
  public:
@@ -470,6 +583,14 @@ void ConcurrentCopying::MarkingPhase() {
   }
 
   CHECK(weak_ref_access_enabled_);
+  if (kVerboseMode || VLOG_IS_ON(gc)) {
+    for (size_t i = 0; i < parallel_marking_stats_.size(); ++i) {
+      const ParallelMarkingStats& stats = parallel_marking_stats_[i];
+      LOG(INFO) << "Parallel marking thread " << i << ": " << stats.objects_processed
+                << " objects, busy " << PrettyDuration(stats.busy_ns)
+                << " of " << PrettyDuration(stats.total_ns);
+    }
+  }
   if (kVerboseMode) {
     LOG(INFO) << "GC end of MarkingPhase";
   }
@@ -584,9 +705,9 @@ void ConcurrentCopying::PushOntoMarkStack(mirror::Object* to_ref) {
   CHECK(thread_running_gc_ != nullptr);
   MarkStackMode mark_stack_mode = mark_stack_mode_.LoadRelaxed();
   if (mark_stack_mode == kMarkStackModeThreadLocal) {
-    if (self == thread_running_gc_) {
-      // If GC-running thread, use the GC mark stack instead of a thread-local mark stack.
-      CHECK(self->GetThreadLocalMarkStack() == nullptr);
+    if (self == thread_running_gc_ && self->GetThreadLocalMarkStack() == nullptr) {
+      // If GC-running thread, use the GC mark stack instead of a thread-local mark stack, unless
+      // it is taking part in parallel marking.
       CHECK(!gc_mark_stack_->IsFull());
       gc_mark_stack_->PushBack(to_ref);
     } else {
@@ -595,24 +716,14 @@ void ConcurrentCopying::PushOntoMarkStack(mirror::Object* to_ref) {
       if (UNLIKELY(tl_mark_stack == nullptr || tl_mark_stack->IsFull())) {
         MutexLock mu(self, mark_stack_lock_);
         // Get a new thread local mark stack.
-        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack;
-        if (!pooled_mark_stacks_.empty()) {
-          // Use a pooled mark stack.
-          new_tl_mark_stack = pooled_mark_stacks_.back();
-          pooled_mark_stacks_.pop_back();
-        } else {
-          // None pooled. Create a new one.
-          new_tl_mark_stack =
-              accounting::AtomicStack<mirror::Object>::Create(
-                  "thread local mark stack", 4 * KB, 4 * KB);
-        }
-        DCHECK(new_tl_mark_stack != nullptr);
-        DCHECK(new_tl_mark_stack->IsEmpty());
+        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack = AllocateMarkStack();
         new_tl_mark_stack->PushBack(to_ref);
         self->SetThreadLocalMarkStack(new_tl_mark_stack);
         if (tl_mark_stack != nullptr) {
           // Store the old full stack into a vector.
           revoked_mark_stacks_.push_back(tl_mark_stack);
+          // Parallel marking tasks may be waiting for it.
+          parallel_marking_cond_.Signal(self);
         }
       } else {
         tl_mark_stack->PushBack(to_ref);
@@ -980,14 +1091,21 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   size_t count = 0;
   MarkStackMode mark_stack_mode = mark_stack_mode_.LoadRelaxed();
   if (mark_stack_mode == kMarkStackModeThreadLocal) {
-    // Process the thread-local mark stacks and the GC mark stack.
-    count += ProcessThreadLocalMarkStacks(false);
-    while (!gc_mark_stack_->IsEmpty()) {
-      mirror::Object* to_ref = gc_mark_stack_->PopBack();
-      ProcessMarkStackRef(to_ref);
-      ++count;
+    size_t thread_count = GetParallelMarkingThreadCount();
+    if (thread_count > 1) {
+      // Process the thread-local mark stacks and the GC mark stack with the GC threads.
+      RevokeThreadLocalMarkStacks(false);
+      count += ProcessMarkStackParallel(thread_count);
+    } else {
+      // Process the thread-local mark stacks and the GC mark stack.
+      count += ProcessThreadLocalMarkStacks(false);
+      while (!gc_mark_stack_->IsEmpty()) {
+        mirror::Object* to_ref = gc_mark_stack_->PopBack();
+        ProcessMarkStackRef(to_ref);
+        ++count;
+      }
+      gc_mark_stack_->Reset();
     }
-    gc_mark_stack_->Reset();
   } else if (mark_stack_mode == kMarkStackModeShared) {
     // Process the shared GC mark stack with a lock.
     {
@@ -1052,19 +1170,217 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
     }
     {
       MutexLock mu(Thread::Current(), mark_stack_lock_);
-      if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
-        // The pool has enough. Delete it.
-        delete mark_stack;
-      } else {
-        // Otherwise, put it into the pool for later reuse.
-        mark_stack->Reset();
-        pooled_mark_stacks_.push_back(mark_stack);
+      ReleaseMarkStack(mark_stack);
+    }
+  }
+  return count;
+}
+
+accounting::ObjectStack* ConcurrentCopying::AllocateMarkStack() {
+  accounting::AtomicStack<mirror::Object>* mark_stack;
+  if (!pooled_mark_stacks_.empty()) {
+    // Use a pooled mark stack.
+    mark_stack = pooled_mark_stacks_.back();
+    pooled_mark_stacks_.pop_back();
+  } else {
+    // None pooled. Create a new one.
+    mark_stack = accounting::AtomicStack<mirror::Object>::Create(
+        "thread local mark stack", 4 * KB, 4 * KB);
+  }
+  DCHECK(mark_stack != nullptr);
+  DCHECK(mark_stack->IsEmpty());
+  return mark_stack;
+}
+
+void ConcurrentCopying::ReleaseMarkStack(accounting::ObjectStack* mark_stack) {
+  if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
+    // The pool has enough. Delete it.
+    delete mark_stack;
+  } else {
+    // Otherwise, put it into the pool for later reuse.
+    mark_stack->Reset();
+    pooled_mark_stacks_.push_back(mark_stack);
+  }
+}
+
+size_t ConcurrentCopying::GetParallelMarkingThreadCount() const {
+  if (heap_->GetThreadPool() == nullptr) {
+    return 1;
+  }
+  return heap_->GetConcGCThreadCount() + 1;
+}
+
+// A task taking part in parallel marking. It processes the refs on the thread-local mark stack
+// of the thread running it, onto which Mark() pushes the refs it finds through
+// PushOntoMarkStack(). When it runs out of refs, it takes a stack shared by another task, or a
+// full stack revoked from a mutator. Forwarding pointers are installed with a CAS in Copy(), so
+// tasks racing to copy the same object are handled like racing mutators.
+class ConcurrentCopyingMarkStackTask : public Task {
+ public:
+  explicit ConcurrentCopyingMarkStackTask(ConcurrentCopying* collector)
+      : collector_(collector), objects_processed_(0), busy_ns_(0), total_ns_(0) {}
+
+  virtual void Run(Thread* self) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    const uint64_t start_time = NanoTime();
+    bool is_active = false;
+    while (collector_->GetParallelMarkingWork(self, &is_active)) {
+      const uint64_t busy_start_time = NanoTime();
+      // Re-read the thread-local mark stack each time, PushOntoMarkStack() replaces it when full.
+      accounting::ObjectStack* mark_stack;
+      while (!(mark_stack = self->GetThreadLocalMarkStack())->IsEmpty()) {
+        if (UNLIKELY(collector_->num_waiting_marking_tasks_.LoadRelaxed() != 0) &&
+            mark_stack->Size() >= kMinimumSharedMarkStackSize) {
+          collector_->ShareParallelMarkingWork(self, mark_stack);
+        }
+        collector_->ProcessMarkStackRef(mark_stack->PopBack());
+        ++objects_processed_;
+      }
+      busy_ns_ += NanoTime() - busy_start_time;
+    }
+    total_ns_ = NanoTime() - start_time;
+  }
+
+  size_t GetObjectsProcessed() const {
+    return objects_processed_;
+  }
+
+  uint64_t GetBusyNs() const {
+    return busy_ns_;
+  }
+
+  uint64_t GetTotalNs() const {
+    return total_ns_;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  size_t objects_processed_;
+  uint64_t busy_ns_;
+  uint64_t total_ns_;
+};
+
+size_t ConcurrentCopying::ProcessMarkStackParallel(size_t thread_count) {
+  TimingLogger::ScopedTiming split("ProcessMarkStackParallel", GetTimings());
+  Thread* self = Thread::Current();
+  size_t total_size = 0;
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    CHECK_EQ(num_active_marking_tasks_, 0u);
+    // Hand the refs on the GC mark stack over to the tasks, in stacks that have room to grow.
+    while (!gc_mark_stack_->IsEmpty()) {
+      accounting::ObjectStack* mark_stack = AllocateMarkStack();
+      const size_t count = std::min(gc_mark_stack_->Size(), mark_stack->Capacity() / 2);
+      for (StackReference<mirror::Object>* p = gc_mark_stack_->End() - count;
+           p != gc_mark_stack_->End(); ++p) {
+        mark_stack->PushBack(p->AsMirrorPtr());
       }
+      gc_mark_stack_->PopBackCount(count);
+      revoked_mark_stacks_.push_back(mark_stack);
+    }
+    gc_mark_stack_->Reset();
+    for (accounting::ObjectStack* mark_stack : revoked_mark_stacks_) {
+      total_size += mark_stack->Size();
+    }
+  }
+
+  std::vector<std::unique_ptr<ConcurrentCopyingMarkStackTask>> tasks;
+  if (total_size < kMinimumParallelMarkStackSize) {
+    // Not worth waking up the thread pool, process the refs on this thread.
+    tasks.emplace_back(new ConcurrentCopyingMarkStackTask(this));
+    tasks.back()->Run(self);
+  } else {
+    ThreadPool* thread_pool = heap_->GetThreadPool();
+    for (size_t i = 0; i < thread_count; ++i) {
+      tasks.emplace_back(new ConcurrentCopyingMarkStackTask(this));
+      thread_pool->AddTask(self, tasks.back().get());
     }
+    thread_pool->SetMaxActiveWorkers(thread_count - 1);
+    thread_pool->StartWorkers(self);
+    thread_pool->Wait(self, true, true);
+    thread_pool->StopWorkers(self);
+  }
+  CHECK(self->GetThreadLocalMarkStack() == nullptr);
+
+  size_t count = 0;
+  if (parallel_marking_stats_.size() < tasks.size()) {
+    parallel_marking_stats_.resize(tasks.size(), ParallelMarkingStats { 0u, 0u, 0u });
+  }
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    ParallelMarkingStats& stats = parallel_marking_stats_[i];
+    stats.objects_processed += tasks[i]->GetObjectsProcessed();
+    stats.busy_ns += tasks[i]->GetBusyNs();
+    stats.total_ns += tasks[i]->GetTotalNs();
+    count += tasks[i]->GetObjectsProcessed();
   }
   return count;
 }
 
+bool ConcurrentCopying::GetParallelMarkingWork(Thread* self, bool* is_active) {
+  bool is_waiting = false;
+  MutexLock mu(self, mark_stack_lock_);
+  while (true) {
+    if (!revoked_mark_stacks_.empty()) {
+      accounting::ObjectStack* old_mark_stack = self->GetThreadLocalMarkStack();
+      if (old_mark_stack != nullptr) {
+        DCHECK(old_mark_stack->IsEmpty());
+        ReleaseMarkStack(old_mark_stack);
+      }
+      self->SetThreadLocalMarkStack(revoked_mark_stacks_.back());
+      revoked_mark_stacks_.pop_back();
+      if (!*is_active) {
+        *is_active = true;
+        ++num_active_marking_tasks_;
+      }
+      if (is_waiting) {
+        num_waiting_marking_tasks_.FetchAndSubSequentiallyConsistent(1);
+      }
+      return true;
+    }
+    if (*is_active) {
+      *is_active = false;
+      --num_active_marking_tasks_;
+    }
+    if (num_active_marking_tasks_ == 0) {
+      // No task has refs left to process or to share: marking through the stacks is done.
+      // Checking this under the lock guarantees that no stack gets shared after. Wake up the
+      // waiting tasks so that they see it too.
+      accounting::ObjectStack* mark_stack = self->GetThreadLocalMarkStack();
+      if (mark_stack != nullptr) {
+        ReleaseMarkStack(mark_stack);
+        self->SetThreadLocalMarkStack(nullptr);
+      }
+      if (is_waiting) {
+        num_waiting_marking_tasks_.FetchAndSubSequentiallyConsistent(1);
+      }
+      parallel_marking_cond_.Broadcast(self);
+      return false;
+    }
+    if (!is_waiting) {
+      is_waiting = true;
+      num_waiting_marking_tasks_.FetchAndAddSequentiallyConsistent(1);
+    }
+    // Block until an active task shares some of its refs or the last one runs out. A task
+    // that never finds work does not spin, and only waits while some other task is running,
+    // which either shares a stack or wakes it up when done. The mutator lock is held shared,
+    // as when processing refs.
+    parallel_marking_cond_.WaitHoldingLocks(self);
+  }
+}
+
+void ConcurrentCopying::ShareParallelMarkingWork(Thread* self,
+                                                 accounting::ObjectStack* mark_stack) {
+  MutexLock mu(self, mark_stack_lock_);
+  accounting::ObjectStack* shared_mark_stack = AllocateMarkStack();
+  const size_t count = mark_stack->Size() / 2;
+  for (StackReference<mirror::Object>* p = mark_stack->End() - count;
+       p != mark_stack->End(); ++p) {
+    shared_mark_stack->PushBack(p->AsMirrorPtr());
+  }
+  mark_stack->PopBackCount(count);
+  revoked_mark_stacks_.push_back(shared_mark_stack);
+  parallel_marking_cond_.Signal(self);
+}
+
 void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
   if (kUseBakerReadBarrier) {
@@ -1209,6 +1525,10 @@ void ConcurrentCopying::Sweep(bool swap_bitmaps) {
     live_stack->Reset();
   }
   CheckEmptyMarkStack();
+  if (young_gen_) {
+    // The non-moving objects and the large objects are only collected by full collections.
+    return;
+  }
   TimingLogger::ScopedTiming split("Sweep", GetTimings());
   for (const auto& space : GetHeap()->GetContinuousSpaces()) {
     if (space->IsContinuousMemMapAllocSpace()) {
@@ -1348,8 +1668,13 @@ void ConcurrentCopying::ReclaimPhase() {
     ComputeUnevacFromSpaceLiveRatio();
   }
 
+  if (use_generational_cc_) {
+    TimingLogger::ScopedTiming split4("FillUnevacFromSpaceGaps", GetTimings());
+    FillUnevacFromSpaceGaps();
+  }
+
   {
-    TimingLogger::ScopedTiming split4("ClearFromSpace", GetTimings());
+    TimingLogger::ScopedTiming split5("ClearFromSpace", GetTimings());
     region_space_->ClearFromSpace();
   }
 
@@ -1359,7 +1684,11 @@ void ConcurrentCopying::ReclaimPhase() {
       ClearBlackPtrs();
     }
     Sweep(false);
-    SwapBitmaps();
+    if (!young_gen_) {
+      // A young generation collection only marks some of the non-moving objects, the live
+      // bitmaps stay as they are.
+      SwapBitmaps();
+    }
     heap_->UnBindBitmaps();
 
     // Remove bitmaps for the immune spaces.
@@ -1412,6 +1741,55 @@ void ConcurrentCopying::ComputeUnevacFromSpaceLiveRatio() {
                                          visitor);
 }
 
+// Used to fill the dead objects of an unevacuated region with dummy objects.
+class ConcurrentCopyingFillUnevacFromSpaceGapsVisitor {
+ public:
+  ConcurrentCopyingFillUnevacFromSpaceGapsVisitor(ConcurrentCopying* cc, uint8_t* begin)
+      : collector_(cc), pos_(begin) {}
+
+  void operator()(mirror::Object* obj) const SHARED_REQUIRES(Locks::mutator_lock_) {
+    FillUpTo(reinterpret_cast<uint8_t*>(obj));
+    size_t alloc_size = RoundUp(obj->SizeOf(), space::RegionSpace::kAlignment);
+    pos_ = reinterpret_cast<uint8_t*>(obj) + alloc_size;
+  }
+
+  void FillUpTo(uint8_t* end) const SHARED_REQUIRES(Locks::mutator_lock_) {
+    DCHECK_LE(pos_, end);
+    if (pos_ < end) {
+      collector_->FillWithDummyObject(reinterpret_cast<mirror::Object*>(pos_), end - pos_);
+    }
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  mutable uint8_t* pos_;
+};
+
+// Used to fill the dead objects of the unevacuated regions.
+class ConcurrentCopyingFillUnevacFromSpaceRegionVisitor {
+ public:
+  explicit ConcurrentCopyingFillUnevacFromSpaceRegionVisitor(ConcurrentCopying* cc)
+      : collector_(cc) {}
+
+  void operator()(uint8_t* begin, uint8_t* top) const SHARED_REQUIRES(Locks::mutator_lock_) {
+    ConcurrentCopyingFillUnevacFromSpaceGapsVisitor visitor(collector_, begin);
+    collector_->region_space_bitmap_->VisitMarkedRange(reinterpret_cast<uintptr_t>(begin),
+                                                       reinterpret_cast<uintptr_t>(top),
+                                                       visitor);
+    visitor.FillUpTo(top);
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+// Make the unevacuated regions walkable again, now that they may hold dead objects whose class
+// is about to be freed. The old regions are walked by the young generation collections.
+void ConcurrentCopying::FillUnevacFromSpaceGaps() {
+  ConcurrentCopyingFillUnevacFromSpaceRegionVisitor visitor(this);
+  region_space_->VisitUnevacFromSpaceRegions(visitor);
+}
+
 // Assert the to-space invariant.
 void ConcurrentCopying::AssertToSpaceInvariant(mirror::Object* obj, MemberOffset offset,
                                                mirror::Object* ref) {
@@ -1568,6 +1946,8 @@ void ConcurrentCopying::AssertToSpaceInvariantInNonMovingSpace(mirror::Object* o
       CHECK(cc_bitmap->Test(ref))
           << "Unmarked immune space ref. obj=" << obj << " ref=" << ref;
     }
+  } else if (young_gen_) {
+    // A young generation collection does not mark the non-moving objects.
   } else {
     accounting::ContinuousSpaceBitmap* mark_bitmap =
         heap_mark_bitmap_->GetContinuousSpaceBitmap(ref);
@@ -1911,6 +2291,11 @@ mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref) {
       } else {
         DCHECK(heap_->non_moving_space_->HasAddress(to_ref));
         DCHECK_EQ(bytes_allocated, non_moving_space_bytes_allocated);
+        if (young_gen_) {
+          // A young generation collection does not swap the bitmaps, so the mark bit does not
+          // make the object live. Set its live bit for the card scans of the next collections.
+          heap_->non_moving_space_->GetLiveBitmap()->AtomicTestAndSet(to_ref);
+        }
       }
       if (kUseBakerReadBarrier) {
         DCHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::GrayPtr());
@@ -1963,6 +2348,9 @@ mirror::Object* ConcurrentCopying::IsMarked(mirror::Object* from_ref) {
         // Newly marked.
         to_ref = nullptr;
       }
+    } else if (young_gen_) {
+      // A young generation collection does not collect the non-moving objects.
+      to_ref = from_ref;
     } else {
       // Non-immune non-moving space. Use the mark bitmap.
       accounting::ContinuousSpaceBitmap* mark_bitmap =
@@ -2079,6 +2467,10 @@ mirror::Object* ConcurrentCopying::Mark(mirror::Object* from_ref) {
         }
         PushOntoMarkStack(to_ref);
       }
+    } else if (young_gen_) {
+      // A young generation collection does not collect the non-moving objects. The ones that
+      // may refer to young objects were pushed at the pause.
+      to_ref = from_ref;
     } else {
       // Use the mark bitmap.
       accounting::ContinuousSpaceBitmap* mark_bitmap =
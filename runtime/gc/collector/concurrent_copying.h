@@ -58,8 +58,9 @@ class ConcurrentCopying : public GarbageCollector {
   static constexpr bool kEnableFromSpaceAccountingCheck = true;
   // Enable verbose mode.
   static constexpr bool kVerboseMode = true;
-
-  ConcurrentCopying(Heap* heap, const std::string& name_prefix = "");
+  // `use_generational_cc` enables the young generation collections, which only collect the
+  // objects allocated since the last collection.
+  ConcurrentCopying(Heap* heap, bool use_generational_cc, const std::string& name_prefix = "");
   ~ConcurrentCopying();
 
   virtual void RunPhases() OVERRIDE REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_);
@@ -72,7 +73,7 @@ class ConcurrentCopying : public GarbageCollector {
   void BindBitmaps() SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!Locks::heap_bitmap_lock_);
   virtual GcType GetGcType() const OVERRIDE {
-    return kGcTypePartial;
+    return young_gen_ ? kGcTypeSticky : kGcTypePartial;
   }
   virtual CollectorType GetCollectorType() const OVERRIDE {
     return kCollectorTypeCC;
@@ -85,6 +86,18 @@ class ConcurrentCopying : public GarbageCollector {
   space::RegionSpace* RegionSpace() {
     return region_space_;
   }
+  // Whether the next collection is a young generation collection. It evacuates the regions
+  // allocated since the last collection, tracing from the roots and from the old objects on
+  // dirty cards, and promotes the survivors to old regions. The old regions, the non-moving
+  // space and the large object space are not collected.
+  void SetYoungGen(bool young_gen) {
+    DCHECK(!is_active_);
+    DCHECK(!young_gen || use_generational_cc_);
+    young_gen_ = young_gen;
+  }
+  bool IsYoungGen() const {
+    return young_gen_;
+  }
   void AssertToSpaceInvariant(mirror::Object* obj, MemberOffset offset, mirror::Object* ref)
       SHARED_REQUIRES(Locks::mutator_lock_);
   void AssertToSpaceInvariant(GcRootSource* gc_root_source, mirror::Object* ref)
@@ -138,6 +151,21 @@ class ConcurrentCopying : public GarbageCollector {
       REQUIRES(!mark_stack_lock_);
   size_t ProcessThreadLocalMarkStacks(bool disable_weak_ref_access)
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Process the revoked thread-local mark stacks and the GC mark stack with `thread_count`
+  // threads, the GC-running thread included. Returns the number of refs processed.
+  size_t ProcessMarkStackParallel(size_t thread_count)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Give a mark stack to process to a parallel marking task running on `self`. Returns false
+  // once no task has refs left to process, blocking while other tasks may still share some.
+  // `is_active` tracks whether the task has work.
+  bool GetParallelMarkingWork(Thread* self, bool* is_active)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Hand half of `mark_stack` over to the parallel marking tasks waiting for work.
+  void ShareParallelMarkingWork(Thread* self, accounting::ObjectStack* mark_stack)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  size_t GetParallelMarkingThreadCount() const;
+  accounting::ObjectStack* AllocateMarkStack() REQUIRES(mark_stack_lock_);
+  void ReleaseMarkStack(accounting::ObjectStack* mark_stack) REQUIRES(mark_stack_lock_);
   void RevokeThreadLocalMarkStacks(bool disable_weak_ref_access)
       SHARED_REQUIRES(Locks::mutator_lock_);
   void SwitchToSharedMarkStackMode() SHARED_REQUIRES(Locks::mutator_lock_)
@@ -175,6 +203,11 @@ class ConcurrentCopying : public GarbageCollector {
   void SwapStacks() SHARED_REQUIRES(Locks::mutator_lock_);
   void RecordLiveStackFreezeSize(Thread* self);
   void ComputeUnevacFromSpaceLiveRatio();
+  void FillUnevacFromSpaceGaps() SHARED_REQUIRES(Locks::mutator_lock_);
+  void AgeCards() SHARED_REQUIRES(Locks::mutator_lock_);
+  void PushOldObjectsOnCards() REQUIRES(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  void PushOldObject(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
   void LogFromSpaceRefHolder(mirror::Object* obj, MemberOffset offset)
       SHARED_REQUIRES(Locks::mutator_lock_);
   void AssertToSpaceInvariantInNonMovingSpace(mirror::Object* obj, mirror::Object* ref)
@@ -193,6 +226,20 @@ class ConcurrentCopying : public GarbageCollector {
   static constexpr size_t kMarkStackPoolSize = 256;
   std::vector<accounting::ObjectStack*> pooled_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
+  // Number of parallel marking tasks that have refs to process, and number of those waiting for
+  // other tasks to share theirs.
+  size_t num_active_marking_tasks_ GUARDED_BY(mark_stack_lock_);
+  Atomic<size_t> num_waiting_marking_tasks_;
+  // Signaled when a stack is added to revoked_mark_stacks_, or when the last active parallel
+  // marking task runs out of refs, to wake up the tasks waiting for work.
+  ConditionVariable parallel_marking_cond_ GUARDED_BY(mark_stack_lock_);
+  // Per-thread statistics of the parallel marking of the current GC, for the GC log.
+  struct ParallelMarkingStats {
+    size_t objects_processed;
+    uint64_t busy_ns;
+    uint64_t total_ns;
+  };
+  std::vector<ParallelMarkingStats> parallel_marking_stats_;
   Thread* thread_running_gc_;
   bool is_marking_;                       // True while marking is ongoing.
   bool is_active_;                        // True while the collection is ongoing.
@@ -232,7 +279,9 @@ class ConcurrentCopying : public GarbageCollector {
   Atomic<size_t> to_space_objects_skipped_;
 
   accounting::ReadBarrierTable* rb_table_;
-  bool force_evacuate_all_;  // True if all regions are evacuated.
+  bool force_evacuate_all_;         // True if all regions are evacuated.
+  const bool use_generational_cc_;  // True if young generation collections are enabled.
+  bool young_gen_;                  // True if only the young generation is collected.
 
   friend class ConcurrentCopyingRefFieldsVisitor;
   friend class ConcurrentCopyingImmuneSpaceObjVisitor;
@@ -244,6 +293,10 @@ class ConcurrentCopying : public GarbageCollector {
   friend class FlipCallback;
   friend class ConcurrentCopyingComputeUnevacFromSpaceLiveRatioVisitor;
   friend class RevokeThreadLocalMarkStackCheckpoint;
+  friend class ConcurrentCopyingMarkStackTask;
+  friend class ConcurrentCopyingOldObjectVisitor;
+  friend class ConcurrentCopyingFillUnevacFromSpaceGapsVisitor;
+  friend class ConcurrentCopyingFillUnevacFromSpaceRegionVisitor;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(ConcurrentCopying);
 };
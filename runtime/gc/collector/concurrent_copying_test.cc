@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "concurrent_copying.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/stringprintf.h"
+#include "collector_test.h"
+#include "gc/heap.h"
+#include "gc/space/region_space.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+class ConcurrentCopyingTest : public CollectorTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    // The concurrent copying collector needs the read barrier.
+    if (kUseReadBarrier) {
+      options->push_back(std::make_pair("-Xgc:CC,generational_cc", nullptr));
+    }
+  }
+
+  // Runs a collection of type `gc_type`. Unlike an explicit collection, it does not evacuate all
+  // the regions, so the old regions that are mostly live stay in place.
+  static void Collect(Thread* self, GcType gc_type) {
+    ScopedThreadSuspension sts(self, kNative);
+    Heap* heap = Runtime::Current()->GetHeap();
+    ASSERT_EQ(gc_type, heap->CollectGarbageInternal(gc_type, kGcCauseBackground, false));
+  }
+
+  static bool IsOld(mirror::Object* obj) {
+    return Runtime::Current()->GetHeap()->region_space_->IsInOldRegion(obj);
+  }
+
+  // Checks that element i of `array` is a string equal to `expected[i]`, or null if it is empty.
+  static void CheckStrings(mirror::ObjectArray<mirror::Object>* array,
+                           const std::vector<std::string>& expected)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    ASSERT_EQ(static_cast<size_t>(array->GetLength()), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      mirror::Object* element = array->Get(i);
+      if (expected[i].empty()) {
+        EXPECT_TRUE(element == nullptr) << i;
+      } else {
+        ASSERT_TRUE(element != nullptr) << i;
+        ASSERT_TRUE(element->IsString()) << i;
+        EXPECT_EQ(expected[i], element->AsString()->ToModifiedUtf8()) << i;
+      }
+    }
+  }
+};
+
+// Young objects only reachable from old objects, through cards dirtied before a young
+// collection or aged by a previous one, must survive young and full collections.
+TEST_F(ConcurrentCopyingTest, OldToYoungReferences) {
+  TEST_DISABLED_WITHOUT_READ_BARRIER();
+  static constexpr size_t kLength = 1024;
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  StackHandleScope<2> hs(self);
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(self, "[Ljava/lang/Object;")));
+  Handle<mirror::ObjectArray<mirror::Object>> old_array(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kLength)));
+  ASSERT_TRUE(old_array.Get() != nullptr);
+  std::vector<std::string> expected(kLength);
+  std::vector<std::string> expected_inner(kLength);
+
+  Collect(self, kGcTypeFull);
+  ASSERT_TRUE(IsOld(old_array.Get()));
+
+  // Young strings in the even elements of the old array, collected by a young collection.
+  for (size_t i = 0; i < kLength; i += 2) {
+    expected[i] = StringPrintf("young %zu", i);
+    old_array->Set<false>(i, AllocString(self, expected[i]));
+  }
+  AllocGarbage(self, kLength);
+  Collect(self, kGcTypeSticky);
+  CheckStrings(old_array.Get(), expected);
+  EXPECT_TRUE(IsOld(old_array->Get(0)));
+
+  // Young strings in the odd elements, and a young array of young strings in the last one,
+  // on cards that the last collection aged.
+  for (size_t i = 1; i < kLength; i += 2) {
+    expected[i] = StringPrintf("second young %zu", i);
+    old_array->Set<false>(i, AllocString(self, expected[i]));
+  }
+  mirror::ObjectArray<mirror::Object>* inner =
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kLength);
+  ASSERT_TRUE(inner != nullptr);
+  old_array->Set<false>(kLength - 1, inner);
+  expected[kLength - 1].clear();
+  for (size_t i = 0; i < kLength; i += 3) {
+    expected_inner[i] = StringPrintf("inner %zu", i);
+    // The allocation may collect and move `inner`, read it again from the old array.
+    mirror::String* string = AllocString(self, expected_inner[i]);
+    old_array->Get(kLength - 1)->AsObjectArray<mirror::Object>()->Set<false>(i, string);
+  }
+  AllocGarbage(self, kLength);
+  Collect(self, kGcTypeSticky);
+  CheckStrings(old_array->Get(kLength - 1)->AsObjectArray<mirror::Object>(), expected_inner);
+  old_array->Set<false>(kLength - 1, nullptr);
+  CheckStrings(old_array.Get(), expected);
+
+  // Young strings replacing some of the old ones, collected by a full collection and then by a
+  // young collection.
+  for (size_t i = 0; i < kLength; i += 3) {
+    expected[i] = StringPrintf("third young %zu", i);
+    old_array->Set<false>(i, AllocString(self, expected[i]));
+  }
+  AllocGarbage(self, kLength);
+  Collect(self, kGcTypeFull);
+  CheckStrings(old_array.Get(), expected);
+  for (size_t i = 1; i < kLength; i += 3) {
+    expected[i] = StringPrintf("fourth young %zu", i);
+    old_array->Set<false>(i, AllocString(self, expected[i]));
+  }
+  AllocGarbage(self, kLength);
+  Collect(self, kGcTypeSticky);
+  CheckStrings(old_array.Get(), expected);
+}
+
+static constexpr size_t kGcThreads = 4;
+static constexpr size_t kChainLength = 50000;
+
+class ConcurrentCopyingParallelMarkingTest : public ConcurrentCopyingTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    if (kUseReadBarrier) {
+      options->push_back(std::make_pair("-Xgc:CC", nullptr));
+      options->push_back(std::make_pair(StringPrintf("-XX:ParallelGCThreads=%zu", kGcThreads),
+                                        nullptr));
+      options->push_back(std::make_pair(StringPrintf("-XX:ConcGCThreads=%zu", kGcThreads),
+                                        nullptr));
+    }
+  }
+};
+
+// A wide tree has the parallel marking tasks share their refs, a long chain leaves all of them
+// but one without work for most of the marking, and the objects reachable from several roots or
+// nodes have the tasks race to copy them. Every object must survive, and be copied only once.
+TEST_F(ConcurrentCopyingParallelMarkingTest, LargeGraph) {
+  TEST_DISABLED_WITHOUT_READ_BARRIER();
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  ASSERT_TRUE(Runtime::Current()->GetHeap()->GetThreadPool() != nullptr);
+  ASSERT_EQ(kGcThreads, Runtime::Current()->GetHeap()->GetConcGCThreadCount());
+  StackHandleScope<2> hs(self);
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(self, "[Ljava/lang/Object;")));
+  MutableHandle<mirror::ObjectArray<mirror::Object>> chain(
+      hs.NewHandle<mirror::ObjectArray<mirror::Object>>(nullptr));
+  ObjectTree tree(self, 15, 256);
+
+  // A chain of two-element arrays, each holding the next one and the leaves of the tree.
+  for (size_t i = 0; i < kChainLength; ++i) {
+    mirror::ObjectArray<mirror::Object>* link = AllocArray(self, array_class.Get(), 2);
+    link->Set<false>(0, chain.Get());
+    link->Set<false>(1, tree.GetLeaves());
+    chain.Assign(link);
+  }
+
+  for (size_t gc = 0; gc < 4; ++gc) {
+    AllocGarbage(self, 4 * KB);
+    Collect(self, kGcTypeFull);
+    EXPECT_EQ(tree.Size(), tree.Check());
+    size_t length = 0;
+    for (mirror::Object* link = chain.Get(); link != nullptr;
+         link = link->AsObjectArray<mirror::Object>()->Get(0)) {
+      ASSERT_EQ(tree.GetLeaves(), link->AsObjectArray<mirror::Object>()->Get(1)) << length;
+      ++length;
+    }
+    EXPECT_EQ(kChainLength, length);
+  }
+}
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
@@ -16,6 +16,8 @@
 
 #include "semi_space-inl.h"
 
+#include <sched.h>
+
 #include <climits>
 #include <functional>
 #include <numeric>
@@ -26,6 +28,7 @@
 #include "base/macros.h"
 #include "base/mutex-inl.h"
 #include "base/timing_logger.h"
+#include "base/work_stealing_deque.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/mod_union_table.h"
 #include "gc/accounting/remembered_set.h"
@@ -42,11 +45,13 @@
 #include "jni_internal.h"
 #include "mark_sweep-inl.h"
 #include "monitor.h"
+#include "mirror/array-inl.h"
 #include "mirror/reference-inl.h"
 #include "mirror/object-inl.h"
 #include "runtime.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 
 using ::art::mirror::Object;
 
@@ -58,6 +63,12 @@ static constexpr bool kProtectFromSpace = true;
 static constexpr bool kStoreStackTraces = false;
 static constexpr size_t kBytesPromotedThreshold = 4 * MB;
 static constexpr size_t kLargeObjectBytesAllocatedThreshold = 16 * MB;
+// Below this number of objects on the mark stack, copying is not worth spreading over several
+// threads.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
+// Size of the to-space buffers of the parallel copying tasks. Objects bigger than a quarter of a
+// buffer are allocated on their own.
+static constexpr size_t kCopyBufferSize = 32 * KB;
 
 void SemiSpace::BindBitmaps() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
@@ -107,6 +118,8 @@ SemiSpace::SemiSpace(Heap* heap, bool generational, const std::string& name_pref
       bytes_moved_(0U),
       objects_moved_(0U),
       saved_bytes_(0U),
+      parallel_copying_overhead_bytes_(0U),
+      num_active_copying_tasks_(0U),
       collector_name_(name_),
       swap_semi_spaces_(true) {
 }
@@ -149,6 +162,7 @@ void SemiSpace::InitializePhase() {
   saved_bytes_ = 0;
   bytes_moved_ = 0;
   objects_moved_ = 0;
+  parallel_copying_overhead_bytes_ = 0;
   self_ = Thread::Current();
   CHECK(from_space_->CanMoveObjects()) << "Attempting to move from " << *from_space_;
   // Set the initial bitmap.
@@ -255,7 +269,9 @@ void SemiSpace::MarkingPhase() {
   GetHeap()->RecordFreeRevoke();  // this is for the non-moving rosalloc space used by GSS.
   // Record freed memory.
   const int64_t from_bytes = from_space_->GetBytesAllocated();
-  const int64_t to_bytes = bytes_moved_;
+  // Count what the parallel copying tasks allocated beyond the moved objects, RecordFreeRevoke()
+  // above already took the free part of their thread-local runs back off.
+  const int64_t to_bytes = bytes_moved_ + parallel_copying_overhead_bytes_;
   const uint64_t from_objects = from_space_->GetObjectsAllocated();
   const uint64_t to_objects = objects_moved_;
   CHECK_LE(to_objects, from_objects);
@@ -739,6 +755,11 @@ void SemiSpace::ScanObject(Object* obj) {
 // Scan anything that's on the mark stack.
 void SemiSpace::ProcessMarkStack() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  const size_t thread_count = GetParallelCopyingThreadCount();
+  if (thread_count > 1 && mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+    ProcessMarkStackParallel(thread_count);
+    return;
+  }
   accounting::ContinuousSpaceBitmap* live_bitmap = nullptr;
   if (collect_from_space_only_) {
     // If a bump pointer space only collection (and the promotion is
@@ -762,6 +783,418 @@ void SemiSpace::ProcessMarkStack() {
   }
 }
 
+size_t SemiSpace::GetParallelCopyingThreadCount() const {
+  // The copying tasks carve their buffers out of the to-space with a CAS on its end, which only a
+  // bump pointer space without a live bitmap allows.
+  if (heap_->GetThreadPool() == nullptr ||
+      !to_space_->IsBumpPointerSpace() ||
+      to_space_live_bitmap_ != nullptr) {
+    return 1;
+  }
+  return heap_->GetParallelGCThreadCount() + 1;
+}
+
+class SemiSpaceCopyTask;
+
+class SemiSpaceParallelMarkObjectVisitor {
+ public:
+  explicit SemiSpaceParallelMarkObjectVisitor(SemiSpaceCopyTask* task) : task_(task) {
+  }
+
+  void operator()(Object* obj, MemberOffset offset, bool /* is_static */) const ALWAYS_INLINE
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+
+  void operator()(mirror::Class* klass, mirror::Reference* ref) const
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+
+  void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+      NO_THREAD_SAFETY_ANALYSIS {
+    if (!root->IsNull()) {
+      VisitRoot(root);
+    }
+  }
+
+  void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+      NO_THREAD_SAFETY_ANALYSIS;
+
+ private:
+  SemiSpaceCopyTask* const task_;
+};
+
+// A task taking part in parallel copying. It scans the objects of its work stealing deque, copies
+// the from-space objects they reference into its own to-space buffer, and steals objects from
+// the other tasks when it runs out.
+//
+// A thread claims a from-space object by CASing its lock word to a forwarding address of null,
+// copies it, then stores the real forwarding address. Threads finding the claim wait for the
+// forwarding address, so that each object is copied exactly once and no copy is wasted.
+class SemiSpaceCopyTask : public Task {
+ public:
+  SemiSpaceCopyTask(SemiSpace* collector,
+                    const std::vector<std::unique_ptr<SemiSpaceCopyTask>>* tasks,
+                    mirror::Class* int_array_class,
+                    mirror::Class* object_class)
+      : collector_(collector),
+        tasks_(tasks),
+        int_array_class_(int_array_class),
+        object_class_(object_class),
+        to_space_(collector->to_space_->AsBumpPointerSpace()),
+        self_(nullptr),
+        buffer_begin_(nullptr),
+        buffer_pos_(nullptr),
+        buffer_end_(nullptr),
+        buffer_objects_(0),
+        objects_moved_(0),
+        bytes_moved_(0),
+        bytes_promoted_(0),
+        saved_bytes_(0),
+        overhead_bytes_(0) {
+  }
+
+  // Only called by the thread running the task, or before the task is started.
+  void Push(Object* obj) {
+    deque_.Push(obj);
+  }
+
+  virtual void Run(Thread* self) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    self_ = self;
+    while (true) {
+      Object* obj = deque_.Pop();
+      if (obj == nullptr) {
+        obj = Steal();
+        if (obj == nullptr) {
+          break;
+        }
+      }
+      ScanObject(obj);
+    }
+    RetireBuffer();
+  }
+
+  template<bool kPoisonReferences>
+  void MarkObject(mirror::ObjectReference<kPoisonReferences, mirror::Object>* obj_ptr)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    Object* obj = obj_ptr->AsMirrorPtr();
+    if (obj == nullptr) {
+      return;
+    }
+    if (collector_->from_space_->HasAddress(obj)) {
+      obj_ptr->Assign(Forward(obj));
+    } else if (!collector_->collect_from_space_only_ &&
+               !collector_->immune_region_.ContainsObject(obj)) {
+      BitmapSetSlowPathVisitor visitor(collector_);
+      if (!collector_->mark_bitmap_->AtomicTestAndSet(obj, visitor)) {
+        // This object was not previously marked.
+        Push(obj);
+      }
+    }
+  }
+
+  template<bool kPoisonReferences>
+  void MarkObjectIfNotInToSpace(mirror::ObjectReference<kPoisonReferences, mirror::Object>* obj_ptr)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    if (!to_space_->HasAddress(obj_ptr->AsMirrorPtr())) {
+      MarkObject(obj_ptr);
+    }
+  }
+
+  void DelayReferenceReferent(mirror::Class* klass, mirror::Reference* ref)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    collector_->DelayReferenceReferent(klass, ref);
+  }
+
+  size_t GetObjectsMoved() const {
+    return objects_moved_;
+  }
+
+  size_t GetBytesMoved() const {
+    return bytes_moved_;
+  }
+
+  uint64_t GetBytesPromoted() const {
+    return bytes_promoted_;
+  }
+
+  size_t GetSavedBytes() const {
+    return saved_bytes_;
+  }
+
+  int64_t GetOverheadBytes() const {
+    return overhead_bytes_;
+  }
+
+ private:
+  void ScanObject(Object* obj) REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    DCHECK(!collector_->from_space_->HasAddress(obj)) << "Scanning object " << obj
+                                                      << " in from space";
+    if (collector_->collect_from_space_only_ && collector_->promo_dest_space_->HasAddress(obj)) {
+      // obj has just been promoted. Mark the live bitmap for it, see ProcessMarkStack().
+      bool was_live = collector_->promo_dest_space_->GetLiveBitmap()->AtomicTestAndSet(obj);
+      DCHECK(!was_live);
+    }
+    SemiSpaceParallelMarkObjectVisitor visitor(this);
+    obj->VisitReferences(visitor, visitor);
+  }
+
+  // Takes an object from the deque of another task. Returns null once no task has objects left,
+  // which is when no task is active: a task is active while its deque is not empty, or while it
+  // tries to steal so that it is not missed when it succeeds.
+  Object* Steal() {
+    Atomic<size_t>& num_active_tasks = collector_->num_active_copying_tasks_;
+    num_active_tasks.FetchAndSubSequentiallyConsistent(1);
+    while (num_active_tasks.LoadSequentiallyConsistent() != 0) {
+      for (const std::unique_ptr<SemiSpaceCopyTask>& task : *tasks_) {
+        if (task.get() == this || task->deque_.IsEmpty()) {
+          continue;
+        }
+        num_active_tasks.FetchAndAddSequentiallyConsistent(1);
+        Object* obj = task->deque_.Steal();
+        if (obj != nullptr) {
+          return obj;
+        }
+        num_active_tasks.FetchAndSubSequentiallyConsistent(1);
+      }
+      sched_yield();
+    }
+    return nullptr;
+  }
+
+  // Returns the forwarding address of obj, copying it first if no thread did.
+  Object* Forward(Object* obj) REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    const LockWord claimed_lock_word = LockWord::FromForwardingAddress(0U);
+    LockWord lock_word = obj->GetLockWord(false);
+    while (true) {
+      if (lock_word.GetState() == LockWord::kForwardingAddress) {
+        if (lock_word.ForwardingAddress() != 0U) {
+          return reinterpret_cast<Object*>(lock_word.ForwardingAddress());
+        }
+        // Another thread is copying the object, wait for its forwarding address.
+      } else if (obj->CasLockWordWeakRelaxed(lock_word, claimed_lock_word)) {
+        break;
+      }
+      lock_word = obj->GetLockWord(true);
+    }
+    Object* forward_address = Copy(obj, lock_word);
+    // Store the forwarding address after the copy, so that the threads waiting for it see a
+    // complete object.
+    obj->SetLockWord(
+        LockWord::FromForwardingAddress(reinterpret_cast<size_t>(forward_address)), true);
+    Push(forward_address);
+    return forward_address;
+  }
+
+  // The parallel version of SemiSpace::MarkNonForwardedObject().
+  Object* Copy(Object* obj, LockWord lock_word)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    const size_t object_size = obj->SizeOf();
+    size_t bytes_allocated = 0;
+    Object* forward_address = nullptr;
+    if (collector_->generational_ &&
+        reinterpret_cast<uint8_t*>(obj) < collector_->last_gc_to_space_end_) {
+      // If it's allocated before the last GC (older), pseudo-promote it to the main free list
+      // space.
+      space::ContinuousMemMapAllocSpace* promo_dest_space = collector_->promo_dest_space_;
+      forward_address = AllocInFreeListSpace(promo_dest_space, object_size, &bytes_allocated);
+      if (forward_address != nullptr) {
+        bytes_promoted_ += bytes_allocated;
+        // Dirty the card at the destination as it may contain references to the bump pointer
+        // space.
+        collector_->GetHeap()->WriteBarrierEveryFieldOf(forward_address);
+        if (!collector_->collect_from_space_only_) {
+          // The live bitmap marking is delayed to ScanObject() otherwise.
+          promo_dest_space->GetLiveBitmap()->AtomicTestAndSet(forward_address);
+          promo_dest_space->GetMarkBitmap()->AtomicTestAndSet(forward_address);
+        }
+      }
+    }
+    if (forward_address == nullptr) {
+      forward_address = AllocInToSpace(object_size, &bytes_allocated);
+    }
+    if (UNLIKELY(forward_address == nullptr)) {
+      space::ContinuousMemMapAllocSpace* fallback_space = collector_->fallback_space_;
+      forward_address = AllocInFreeListSpace(fallback_space, object_size, &bytes_allocated);
+      CHECK(forward_address != nullptr) << "Out of memory in the to-space and fallback space.";
+      accounting::ContinuousSpaceBitmap* bitmap = fallback_space->GetLiveBitmap();
+      if (bitmap != nullptr) {
+        bitmap->AtomicTestAndSet(forward_address);
+      }
+    }
+    ++objects_moved_;
+    bytes_moved_ += bytes_allocated;
+    saved_bytes_ +=
+        CopyAvoidingDirtyingPages(reinterpret_cast<void*>(forward_address), obj, object_size);
+    // The copy took the claimed lock word, restore the original one.
+    forward_address->SetLockWord(lock_word, false);
+    if (kUseBakerOrBrooksReadBarrier) {
+      obj->AssertReadBarrierPointer();
+      if (kUseBrooksReadBarrier) {
+        DCHECK_EQ(forward_address->GetReadBarrierPointer(), obj);
+        forward_address->SetReadBarrierPointer(forward_address);
+      }
+      forward_address->AssertReadBarrierPointer();
+    }
+    return forward_address;
+  }
+
+  // Thread-safe allocation in the promotion or fallback space. Small objects go to the rosalloc
+  // thread-local runs of the thread, which are counted in bulk like for mutators.
+  Object* AllocInFreeListSpace(space::ContinuousMemMapAllocSpace* space,
+                               size_t num_bytes,
+                               size_t* bytes_allocated)
+      REQUIRES(Locks::mutator_lock_) {
+    size_t bytes_tl_bulk_allocated = 0;
+    Object* ret = space->Alloc(self_, num_bytes, bytes_allocated, nullptr,
+                               &bytes_tl_bulk_allocated);
+    if (ret != nullptr) {
+      overhead_bytes_ += static_cast<int64_t>(bytes_tl_bulk_allocated) -
+          static_cast<int64_t>(*bytes_allocated);
+    }
+    return ret;
+  }
+
+  Object* AllocInToSpace(size_t object_size, size_t* bytes_allocated)
+      REQUIRES(Locks::mutator_lock_) {
+    const size_t num_bytes = RoundUp(object_size, space::BumpPointerSpace::kAlignment);
+    if (num_bytes <= static_cast<size_t>(buffer_end_ - buffer_pos_)) {
+      Object* ret = reinterpret_cast<Object*>(buffer_pos_);
+      buffer_pos_ += num_bytes;
+      ++buffer_objects_;
+      *bytes_allocated = num_bytes;
+      return ret;
+    }
+    if (num_bytes <= kCopyBufferSize / 4) {
+      uint8_t* buffer =
+          reinterpret_cast<uint8_t*>(to_space_->AllocNonvirtualWithoutAccounting(kCopyBufferSize));
+      if (buffer != nullptr) {
+        RetireBuffer();
+        buffer_begin_ = buffer;
+        buffer_pos_ = buffer + num_bytes;
+        buffer_end_ = buffer + kCopyBufferSize;
+        buffer_objects_ = 1;
+        *bytes_allocated = num_bytes;
+        return reinterpret_cast<Object*>(buffer);
+      }
+    }
+    // Big objects, or the to-space is almost full.
+    Object* ret = to_space_->AllocNonvirtual(num_bytes);
+    if (ret != nullptr) {
+      *bytes_allocated = num_bytes;
+    }
+    return ret;
+  }
+
+  // Accounts the current to-space buffer, filling its end with an object to keep the to-space
+  // walkable.
+  void RetireBuffer() REQUIRES(Locks::mutator_lock_) {
+    if (buffer_begin_ == nullptr) {
+      return;
+    }
+    const size_t unused_bytes = buffer_end_ - buffer_pos_;
+    if (unused_bytes != 0) {
+      FillWithFillerObject(reinterpret_cast<Object*>(buffer_pos_), unused_bytes);
+      ++buffer_objects_;
+      overhead_bytes_ += unused_bytes;
+    }
+    to_space_->RecordAlloc(buffer_objects_, kCopyBufferSize);
+    buffer_begin_ = nullptr;
+    buffer_pos_ = nullptr;
+    buffer_end_ = nullptr;
+    buffer_objects_ = 0;
+  }
+
+  // Like ConcurrentCopying::FillWithDummyObject(), an int array or a plain object when it is too
+  // small for one. The to-space is still zeroed.
+  void FillWithFillerObject(Object* filler, size_t byte_size) REQUIRES(Locks::mutator_lock_) {
+    DCHECK_ALIGNED(byte_size, space::BumpPointerSpace::kAlignment);
+    const size_t data_offset = mirror::Array::DataOffset(sizeof(int32_t)).SizeValue();
+    if (byte_size < data_offset) {
+      filler->SetClass(object_class_);
+    } else {
+      filler->SetClass(int_array_class_);
+      filler->AsArray()->SetLength((byte_size - data_offset) / sizeof(int32_t));
+    }
+    DCHECK_EQ(filler->SizeOf(), byte_size);
+  }
+
+  SemiSpace* const collector_;
+  const std::vector<std::unique_ptr<SemiSpaceCopyTask>>* const tasks_;
+  mirror::Class* const int_array_class_;
+  mirror::Class* const object_class_;
+  space::BumpPointerSpace* const to_space_;
+  Thread* self_;
+  WorkStealingDeque<Object> deque_;
+  // The to-space buffer of the task, [buffer_begin_, buffer_pos_) holds buffer_objects_ copies.
+  uint8_t* buffer_begin_;
+  uint8_t* buffer_pos_;
+  uint8_t* buffer_end_;
+  size_t buffer_objects_;
+  size_t objects_moved_;
+  size_t bytes_moved_;
+  uint64_t bytes_promoted_;
+  size_t saved_bytes_;
+  int64_t overhead_bytes_;
+};
+
+inline void SemiSpaceParallelMarkObjectVisitor::operator()(Object* obj,
+                                                           MemberOffset offset,
+                                                           bool /* is_static */) const {
+  // Object was already verified when we scanned it.
+  task_->MarkObject(obj->GetFieldObjectReferenceAddr<kVerifyNone>(offset));
+}
+
+inline void SemiSpaceParallelMarkObjectVisitor::operator()(mirror::Class* klass,
+                                                           mirror::Reference* ref) const {
+  task_->DelayReferenceReferent(klass, ref);
+}
+
+inline void SemiSpaceParallelMarkObjectVisitor::VisitRoot(
+    mirror::CompressedReference<mirror::Object>* root) const {
+  // We may visit the same root multiple times, so avoid marking things in the to-space since
+  // this is not handled by the GC.
+  task_->MarkObjectIfNotInToSpace(root);
+}
+
+void SemiSpace::ProcessMarkStackParallel(size_t thread_count) {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  // The filler objects ending the to-space buffers of the tasks are int arrays, or plain objects.
+  // Forward their classes now so that the fillers do not point to the from-space.
+  mirror::Class* int_array_class = mirror::IntArray::GetArrayClass();
+  DCHECK(!from_space_->HasAddress(int_array_class));
+  mirror::Class* object_class = int_array_class->GetSuperClass();
+  if (from_space_->HasAddress(object_class)) {
+    object_class = down_cast<mirror::Class*>(MarkObject(object_class));
+  }
+
+  std::vector<std::unique_ptr<SemiSpaceCopyTask>> tasks;
+  for (size_t i = 0; i < thread_count; ++i) {
+    tasks.emplace_back(new SemiSpaceCopyTask(this, &tasks, int_array_class, object_class));
+  }
+  // Deal the mark stack out to the tasks. They are not running yet, so this thread may push onto
+  // their deques.
+  for (size_t i = 0; !mark_stack_->IsEmpty(); ++i) {
+    tasks[i % thread_count]->Push(mark_stack_->PopBack());
+  }
+  num_active_copying_tasks_.StoreRelaxed(thread_count);
+  ThreadPool* thread_pool = GetHeap()->GetThreadPool();
+  for (const std::unique_ptr<SemiSpaceCopyTask>& task : tasks) {
+    thread_pool->AddTask(self_, task.get());
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self_);
+  thread_pool->Wait(self_, true, true);
+  thread_pool->StopWorkers(self_);
+  CHECK_EQ(num_active_copying_tasks_.LoadRelaxed(), 0U);
+
+  for (const std::unique_ptr<SemiSpaceCopyTask>& task : tasks) {
+    objects_moved_ += task->GetObjectsMoved();
+    bytes_moved_ += task->GetBytesMoved();
+    bytes_promoted_ += task->GetBytesPromoted();
+    saved_bytes_ += task->GetSavedBytes();
+    parallel_copying_overhead_bytes_ += task->GetOverheadBytes();
+  }
+  CHECK(mark_stack_->IsEmpty());
+}
+
 mirror::Object* SemiSpace::IsMarked(mirror::Object* obj) {
   // All immune objects are assumed marked.
   if (from_space_->HasAddress(obj)) {
@@ -191,6 +191,14 @@ class SemiSpace : public GarbageCollector {
   void ProcessMarkStack()
       REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
 
+  // Recursively blackens objects on the mark stack with `thread_count` GC threads, the GC-running
+  // thread included. Only used when copying into a bump pointer space.
+  void ProcessMarkStackParallel(size_t thread_count)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+
+  // Returns how many threads ProcessMarkStack() may use, 1 if it has to copy sequentially.
+  size_t GetParallelCopyingThreadCount() const;
+
   inline mirror::Object* GetForwardingAddressInFromSpace(mirror::Object* obj) const
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -258,6 +266,14 @@ class SemiSpace : public GarbageCollector {
   // How many bytes we avoided dirtying.
   size_t saved_bytes_;
 
+  // Bytes the parallel copying tasks allocated beyond the objects they moved: the free part of the
+  // rosalloc thread-local runs they promoted into, which revoking the runs gives back, and the
+  // filler objects at the end of their to-space buffers.
+  int64_t parallel_copying_overhead_bytes_;
+
+  // Number of parallel copying tasks that may still find objects to scan.
+  Atomic<size_t> num_active_copying_tasks_;
+
   // The name of the collector.
   std::string collector_name_;
 
@@ -271,6 +287,7 @@ class SemiSpace : public GarbageCollector {
 
  private:
   friend class BitmapSetSlowPathVisitor;
+  friend class SemiSpaceCopyTask;
   DISALLOW_IMPLICIT_CONSTRUCTORS(SemiSpace);
 };
 
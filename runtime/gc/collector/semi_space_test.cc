@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "semi_space.h"
+
+#include <utility>
+
+#include "base/stringprintf.h"
+#include "collector_test.h"
+#include "gc/heap.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+static constexpr size_t kGcThreads = 4;
+
+class SemiSpaceTest : public CollectorTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    // The semi-space collector does not support the read barrier.
+    if (!kUseReadBarrier) {
+      options->push_back(std::make_pair(StringPrintf("-Xgc:%s", GetCollectorName()), nullptr));
+      options->push_back(std::make_pair(StringPrintf("-XX:ParallelGCThreads=%zu", kGcThreads),
+                                        nullptr));
+    }
+  }
+
+  virtual const char* GetCollectorName() const {
+    return "SS";
+  }
+
+  // Checks a tree across collections. Its root nodes fill the mark stack enough for the
+  // collector to copy in parallel, and its leaves and the subtrees below the root nodes are
+  // reachable from several objects scanned by different tasks, which race to forward them.
+  void TestSharedObjects() {
+    ScopedObjectAccess soa(Thread::Current());
+    Thread* self = soa.Self();
+    Heap* heap = Runtime::Current()->GetHeap();
+    ASSERT_TRUE(heap->GetThreadPool() != nullptr);
+    ASSERT_EQ(kGcThreads, heap->GetParallelGCThreadCount());
+    ObjectTree tree(self, 14, 64);
+    for (size_t gc = 0; gc < 4; ++gc) {
+      AllocGarbage(self, tree.Size());
+      CollectFull(self);
+      EXPECT_EQ(tree.Size(), tree.Check());
+    }
+  }
+};
+
+// Also promotes the objects surviving a second collection to the main space, which the tasks
+// allocate in from their own thread-local runs.
+class GenerationalSemiSpaceTest : public SemiSpaceTest {
+ protected:
+  const char* GetCollectorName() const OVERRIDE {
+    return "GSS";
+  }
+};
+
+TEST_F(SemiSpaceTest, ParallelCopySharedObjects) {
+  TEST_DISABLED_FOR_READ_BARRIER();
+  TestSharedObjects();
+}
+
+TEST_F(GenerationalSemiSpaceTest, ParallelCopySharedObjects) {
+  TEST_DISABLED_FOR_READ_BARRIER();
+  TestSharedObjects();
+}
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
@@ -146,6 +146,7 @@ Heap::Heap(size_t initial_size,
            bool verify_pre_sweeping_rosalloc,
            bool verify_post_gc_rosalloc,
            bool gc_stress_mode,
+           bool use_generational_cc,
            bool use_homogeneous_space_compaction_for_oom,
            uint64_t min_interval_homogeneous_space_compaction_by_oom)
     : non_moving_space_(nullptr),
@@ -194,6 +195,7 @@ Heap::Heap(size_t initial_size,
       verify_pre_sweeping_rosalloc_(verify_pre_sweeping_rosalloc),
       verify_post_gc_rosalloc_(verify_post_gc_rosalloc),
       gc_stress_mode_(gc_stress_mode),
+      use_generational_cc_(use_generational_cc),
       /* For GC a lot mode, we limit the allocations stacks to be kGcAlotInterval allocations. This
        * causes a lot of GC since we do a GC for alloc whenever the stack is full. When heap
        * verification is enabled, we limit the size of allocation stacks to speed up their
@@ -602,7 +604,7 @@ Heap::Heap(size_t initial_size,
       garbage_collectors_.push_back(semi_space_collector_);
     }
     if (MayUseCollector(kCollectorTypeCC)) {
-      concurrent_copying_collector_ = new collector::ConcurrentCopying(this);
+      concurrent_copying_collector_ = new collector::ConcurrentCopying(this, use_generational_cc_);
       garbage_collectors_.push_back(concurrent_copying_collector_);
     }
     if (MayUseCollector(kCollectorTypeMC)) {
@@ -2652,6 +2654,9 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
         break;
       case kCollectorTypeCC:
         concurrent_copying_collector_->SetRegionSpace(region_space_);
+        // A sticky collection only collects the young generation.
+        concurrent_copying_collector_->SetYoungGen(
+            use_generational_cc_ && gc_type == collector::kGcTypeSticky);
         collector = concurrent_copying_collector_;
         break;
       case kCollectorTypeMC:
@@ -2665,7 +2670,8 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       temp_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
       CHECK(temp_space_->IsEmpty());
     }
-    gc_type = collector::kGcTypeFull;  // TODO: Not hard code this in.
+    gc_type = collector->GetGcType() == collector::kGcTypeSticky ?
+        collector::kGcTypeSticky : collector::kGcTypeFull;  // TODO: Not hard code this in.
   } else if (current_allocator_ == kAllocatorTypeRosAlloc ||
       current_allocator_ == kAllocatorTypeDlMalloc) {
     collector = FindCollectorByGcType(gc_type);
@@ -3477,6 +3483,20 @@ bool Heap::IsMovableObject(const mirror::Object* obj) const {
   return false;
 }
 
+bool Heap::CanPinObject(const mirror::Object* obj) const {
+  return region_space_ != nullptr && region_space_->HasAddress(obj);
+}
+
+void Heap::PinObject(mirror::Object* obj) {
+  DCHECK(CanPinObject(obj));
+  region_space_->PinRegion(obj);
+}
+
+void Heap::UnpinObject(mirror::Object* obj) {
+  DCHECK(CanPinObject(obj));
+  region_space_->UnpinRegion(obj);
+}
+
 void Heap::UpdateMaxNativeFootprint() {
   size_t native_size = native_bytes_allocated_.LoadRelaxed();
   // TODO: Tune the native heap utilization to be a value other than the java heap utilization.
@@ -3530,20 +3550,34 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   } else {
     collector::GcType non_sticky_gc_type =
         HasZygoteSpace() ? collector::kGcTypePartial : collector::kGcTypeFull;
-    // Find what the next non sticky collector will be.
-    collector::GarbageCollector* non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
-    // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
-    // do another sticky collection next.
-    // We also check that the bytes allocated aren't over the footprint limit in order to prevent a
-    // pathological case where dead objects which aren't reclaimed by sticky could get accumulated
-    // if the sticky GC throughput always remained >= the full/partial throughput.
-    if (current_gc_iteration_.GetEstimatedThroughput() * kStickyGcThroughputAdjustment >=
-        non_sticky_collector->GetEstimatedMeanThroughput() &&
-        non_sticky_collector->NumberOfIterations() > 0 &&
-        bytes_allocated <= max_allowed_footprint_) {
-      next_gc_type_ = collector::kGcTypeSticky;
+    if (collector_ran == concurrent_copying_collector_) {
+      // The young generation and full collections of the concurrent copying collector are run
+      // by the same collector, so their throughputs cannot be compared. Keep doing young
+      // collections as long as they leave the old generation enough room below the footprint
+      // computed by the last full collection, in which the garbage of the old generation
+      // accumulates.
+      if (bytes_allocated + adjusted_min_free <= max_allowed_footprint_) {
+        next_gc_type_ = collector::kGcTypeSticky;
+      } else {
+        next_gc_type_ = non_sticky_gc_type;
+      }
     } else {
-      next_gc_type_ = non_sticky_gc_type;
+      // Find what the next non sticky collector will be.
+      collector::GarbageCollector* non_sticky_collector =
+          FindCollectorByGcType(non_sticky_gc_type);
+      // If the throughput of the current sticky GC >= throughput of the non sticky collector,
+      // then do another sticky collection next.
+      // We also check that the bytes allocated aren't over the footprint limit in order to
+      // prevent a pathological case where dead objects which aren't reclaimed by sticky could get
+      // accumulated if the sticky GC throughput always remained >= the full/partial throughput.
+      if (current_gc_iteration_.GetEstimatedThroughput() * kStickyGcThroughputAdjustment >=
+          non_sticky_collector->GetEstimatedMeanThroughput() &&
+          non_sticky_collector->NumberOfIterations() > 0 &&
+          bytes_allocated <= max_allowed_footprint_) {
+        next_gc_type_ = collector::kGcTypeSticky;
+      } else {
+        next_gc_type_ = non_sticky_gc_type;
+      }
     }
     // If we have freed enough memory, shrink the heap back down.
     if (bytes_allocated + adjusted_max_free < max_allowed_footprint_) {
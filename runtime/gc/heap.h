@@ -68,6 +68,7 @@ namespace accounting {
 
 namespace collector {
   class ConcurrentCopying;
+  class ConcurrentCopyingTest;
   class GarbageCollector;
   class MarkCompact;
   class MarkSweep;
@@ -195,6 +196,7 @@ class Heap {
        bool verify_pre_sweeping_rosalloc,
        bool verify_post_gc_rosalloc,
        bool gc_stress_mode,
+       bool use_generational_cc,
        bool use_homogeneous_space_compaction,
        uint64_t min_interval_homogeneous_space_compaction_by_oom);
 
@@ -303,6 +305,14 @@ class Heap {
   // Returns true if there is any chance that the object (obj) will move.
   bool IsMovableObject(const mirror::Object* obj) const SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Returns true if PinObject can keep the object (obj) in place without holding back the
+  // moving of other objects. This is the case for the objects of the region space.
+  bool CanPinObject(const mirror::Object* obj) const;
+
+  // Pin and unpin the region of an object for which CanPinObject is true.
+  void PinObject(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_);
+  void UnpinObject(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Enables us to compacting GC until objects are released.
   void IncrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
   void DecrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
@@ -1162,6 +1172,10 @@ class Heap {
   bool verify_post_gc_rosalloc_;
   const bool gc_stress_mode_;
 
+  // Whether the concurrent copying collector does young generation collections, see
+  // ConcurrentCopying::SetYoungGen. Off unless -Xgc:generational_cc is given.
+  const bool use_generational_cc_;
+
   // RAII that temporarily disables the rosalloc verification during
   // the zygote fork.
   class ScopedDisableRosAllocVerification {
@@ -1329,6 +1343,7 @@ class Heap {
   friend class collector::GarbageCollector;
   friend class collector::MarkCompact;
   friend class collector::ConcurrentCopying;
+  friend class collector::ConcurrentCopyingTest;
   friend class collector::MarkSweep;
   friend class collector::SemiSpace;
   friend class ReferenceQueue;
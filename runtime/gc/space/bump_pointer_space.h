@@ -147,6 +147,12 @@ class BumpPointerSpace FINAL : public ContinuousMemMapAllocSpace {
 
   accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() OVERRIDE;
 
+  // Record objects / bytes allocated with AllocNonvirtualWithoutAccounting().
+  void RecordAlloc(int32_t objects, int32_t bytes) {
+    objects_allocated_.FetchAndAddSequentiallyConsistent(objects);
+    bytes_allocated_.FetchAndAddSequentiallyConsistent(bytes);
+  }
+
   // Record objects / bytes freed.
   void RecordFree(int32_t objects, int32_t bytes) {
     objects_allocated_.FetchAndSubSequentiallyConsistent(objects);
@@ -19,6 +19,8 @@
 
 #include "region_space.h"
 
+#include "gc/accounting/card_table-inl.h"
+
 namespace art {
 namespace gc {
 namespace space {
@@ -92,6 +94,8 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes, size_t* by
         Region* r = &regions_[i];
         if (r->IsFree()) {
           r->Unfree(time_);
+          // Evacuated objects survived a collection.
+          r->SetOld();
           ++num_non_free_regions_;
           obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
           CHECK(obj != nullptr);
@@ -299,12 +303,18 @@ mirror::Object* RegionSpace::AllocLarge(size_t num_bytes, size_t* bytes_allocate
       Region* first_reg = &regions_[left];
       DCHECK(first_reg->IsFree());
       first_reg->UnfreeLarge(time_);
+      if (kForEvac) {
+        first_reg->SetOld();
+      }
       ++num_non_free_regions_;
       first_reg->SetTop(first_reg->Begin() + num_bytes);
       for (size_t p = left + 1; p < right; ++p) {
         DCHECK_LT(p, num_regions_);
         DCHECK(regions_[p].IsFree());
         regions_[p].UnfreeLargeTail(time_);
+        if (kForEvac) {
+          regions_[p].SetOld();
+        }
         ++num_non_free_regions_;
       }
       *bytes_allocated = num_bytes;
@@ -321,6 +331,66 @@ mirror::Object* RegionSpace::AllocLarge(size_t num_bytes, size_t* bytes_allocate
   return nullptr;
 }
 
+template <typename Visitor>
+void RegionSpace::VisitOldObjectsOnCards(accounting::CardTable* card_table,
+                                         uint8_t minimum_age,
+                                         const Visitor& visitor) {
+  // Like WalkInternal(), this walks the objects of the regions without the region lock and
+  // relies on the mutators being suspended.
+  Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree() || !r->IsOld() || r->IsLargeTail()) {
+      continue;
+    }
+    DCHECK(r->IsInToSpace());
+    if (r->IsLarge()) {
+      mirror::Object* obj = reinterpret_cast<mirror::Object*>(r->Begin());
+      if (card_table->GetCard(obj) >= minimum_age) {
+        visitor(obj);
+      }
+      continue;
+    }
+    // The write barrier marks the card of the object header, so only the cards of the
+    // allocated part of the region matter. Skip the regions without such a card.
+    uint8_t* top = r->Top();
+    if (top == r->Begin()) {
+      continue;
+    }
+    const uint8_t* card = card_table->CardFromAddr(r->Begin());
+    const uint8_t* card_end = card_table->CardFromAddr(top - 1) + 1;
+    while (card < card_end && *card < minimum_age) {
+      ++card;
+    }
+    if (card == card_end) {
+      continue;
+    }
+    // There is no record of where objects start. Walk them from the region begin.
+    uint8_t* pos = r->Begin();
+    while (pos < top) {
+      mirror::Object* obj = reinterpret_cast<mirror::Object*>(pos);
+      if (obj->GetClass<kDefaultVerifyFlags, kWithoutReadBarrier>() == nullptr) {
+        break;
+      }
+      if (card_table->GetCard(obj) >= minimum_age) {
+        visitor(obj);
+      }
+      pos = reinterpret_cast<uint8_t*>(GetNextObject(obj));
+    }
+  }
+}
+
+template <typename Visitor>
+void RegionSpace::VisitUnevacFromSpaceRegions(const Visitor& visitor) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsInUnevacFromSpace() && !r->IsLargeTail()) {
+      visitor(r->Begin(), r->Top());
+    }
+  }
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -145,7 +145,8 @@ inline bool RegionSpace::Region::ShouldBeEvacuated() {
 
 // Determine which regions to evacuate and mark them as
 // from-space. Mark the rest as unevacuated from-space.
-void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all) {
+void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all,
+                               bool young_gen) {
   ++time_;
   if (kUseTableLookupReadBarrier) {
     DCHECK(rb_table->IsAllCleared());
@@ -154,6 +155,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
   MutexLock mu(Thread::Current(), region_lock_);
   size_t num_expected_large_tails = 0;
   bool prev_large_evacuated = false;
+  bool prev_large_old = false;
   for (size_t i = 0; i < num_regions_; ++i) {
     Region* r = &regions_[i];
     RegionState state = r->State();
@@ -164,8 +166,18 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = force_evacuate_all || r->ShouldBeEvacuated();
-        if (should_evacuate) {
+        // The old regions stay in the to-space during a young generation collection: their
+        // objects are neither moved nor marked, and are all considered live.
+        bool stays_in_to_space = young_gen && r->IsOld();
+        // The young generation is evacuated entirely, promoting its live objects to old regions.
+        // Pinned regions are never evacuated, they become unevacuated from-space.
+        bool should_evacuate = !stays_in_to_space && !r->IsPinned() &&
+            (force_evacuate_all || young_gen || r->ShouldBeEvacuated());
+        if (stays_in_to_space) {
+          if (kUseTableLookupReadBarrier) {
+            rb_table->Clear(r->Begin(), r->End());
+          }
+        } else if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
         } else {
@@ -175,13 +187,18 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
         if (UNLIKELY(state == RegionState::kRegionStateLarge &&
                      type == RegionType::kRegionTypeToSpace)) {
           prev_large_evacuated = should_evacuate;
+          prev_large_old = stays_in_to_space;
           num_expected_large_tails = RoundUp(r->BytesAllocated(), kRegionSize) / kRegionSize - 1;
           DCHECK_GT(num_expected_large_tails, 0U);
         }
       } else {
         DCHECK(state == RegionState::kRegionStateLargeTail &&
                type == RegionType::kRegionTypeToSpace);
-        if (prev_large_evacuated) {
+        if (prev_large_old) {
+          if (kUseTableLookupReadBarrier) {
+            rb_table->Clear(r->Begin(), r->End());
+          }
+        } else if (prev_large_evacuated) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
         } else {
@@ -413,7 +430,8 @@ void RegionSpace::Region::Dump(std::ostream& os) const {
      << " state=" << static_cast<uint>(state_) << " type=" << static_cast<uint>(type_)
      << " objects_allocated=" << objects_allocated_
      << " alloc_time=" << alloc_time_ << " live_bytes=" << live_bytes_
-     << " is_newly_allocated=" << is_newly_allocated_ << " is_a_tlab=" << is_a_tlab_ << " thread=" << thread_ << "\n";
+     << " is_newly_allocated=" << is_newly_allocated_ << " is_old=" << is_old_
+     << " is_a_tlab=" << is_a_tlab_ << " thread=" << thread_ << "\n";
 }
 
 }  // namespace space
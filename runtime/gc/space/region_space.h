@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
 #define ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
 
+#include "gc/accounting/card_table.h"
 #include "gc/accounting/read_barrier_table.h"
 #include "object_callbacks.h"
 #include "space.h"
@@ -159,6 +160,12 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     WalkInternal<true>(callback, arg);
   }
 
+  // Visit the objects of the old regions whose card is at least `minimum_age`. These are the
+  // objects that may refer to the young generation. Called with the mutators suspended.
+  template <typename Visitor>
+  void VisitOldObjectsOnCards(accounting::CardTable* card_table, uint8_t minimum_age,
+                              const Visitor& visitor) NO_THREAD_SAFETY_ANALYSIS;
+
   accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() OVERRIDE {
     return nullptr;
   }
@@ -194,6 +201,15 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     return false;
   }
 
+  // Whether `ref` survived a collection, see Region::SetOld().
+  bool IsInOldRegion(mirror::Object* ref) {
+    if (HasAddress(ref)) {
+      Region* r = RefToRegionUnlocked(ref);
+      return r->IsOld();
+    }
+    return false;
+  }
+
   RegionType GetRegionType(mirror::Object* ref) {
     if (HasAddress(ref)) {
       Region* r = RefToRegionUnlocked(ref);
@@ -202,7 +218,11 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     return RegionType::kRegionTypeNone;
   }
 
-  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all)
+  // Set the regions to collect as the from-space. A young generation collection (`young_gen`)
+  // evacuates the regions allocated since the last collection and leaves the old regions, which
+  // survived a collection, in the to-space.
+  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all,
+                    bool young_gen)
       REQUIRES(!region_lock_);
 
   size_t FromSpaceSize() REQUIRES(!region_lock_);
@@ -210,6 +230,22 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   size_t ToSpaceSize() REQUIRES(!region_lock_);
   void ClearFromSpace() REQUIRES(!region_lock_);
 
+  // Call `visitor(begin, top)` with the allocated range of each unevacuated from-space region,
+  // large tails excluded.
+  template <typename Visitor>
+  void VisitUnevacFromSpaceRegions(const Visitor& visitor) REQUIRES(!region_lock_);
+
+  // Keep the region of `ref` in place for a JNI critical section. A pinned region is not
+  // evacuated, its objects stay where they are like in an unevacuated region.
+  void PinRegion(mirror::Object* ref) REQUIRES(!region_lock_) {
+    MutexLock mu(Thread::Current(), region_lock_);
+    RefToRegionLocked(ref)->Pin();
+  }
+  void UnpinRegion(mirror::Object* ref) REQUIRES(!region_lock_) {
+    MutexLock mu(Thread::Current(), region_lock_);
+    RefToRegionLocked(ref)->Unpin();
+  }
+
   void AddLiveBytes(mirror::Object* ref, size_t alloc_size) {
     Region* reg = RefToRegionUnlocked(ref);
     reg->AddLiveBytes(alloc_size);
@@ -237,13 +273,15 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
           begin_(nullptr), top_(nullptr), end_(nullptr),
           state_(RegionState::kRegionStateAllocated), type_(RegionType::kRegionTypeToSpace),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {}
+          is_newly_allocated_(false), is_old_(false), is_a_tlab_(false), thread_(nullptr),
+          pin_count_(0) {}
 
     Region(size_t idx, uint8_t* begin, uint8_t* end)
         : idx_(idx), begin_(begin), top_(begin), end_(end),
           state_(RegionState::kRegionStateFree), type_(RegionType::kRegionTypeNone),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {
+          is_newly_allocated_(false), is_old_(false), is_a_tlab_(false), thread_(nullptr),
+          pin_count_(0) {
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
     }
@@ -273,6 +311,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       }
       madvise(begin_, end_ - begin_, MADV_DONTNEED);
       is_newly_allocated_ = false;
+      is_old_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
     }
@@ -317,6 +356,29 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       is_newly_allocated_ = true;
     }
 
+    // Old regions hold the objects that survived a collection: the regions evacuated to, and
+    // the unevacuated regions. The other regions are the young generation.
+    void SetOld() {
+      is_old_ = true;
+    }
+
+    bool IsOld() const {
+      return is_old_;
+    }
+
+    void Pin() {
+      ++pin_count_;
+    }
+
+    void Unpin() {
+      DCHECK_GT(pin_count_, 0U);
+      --pin_count_;
+    }
+
+    bool IsPinned() const {
+      return pin_count_ != 0U;
+    }
+
     // Non-large, non-large-tail allocated.
     bool IsAllocated() const {
       return state_ == RegionState::kRegionStateAllocated;
@@ -375,6 +437,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     void SetUnevacFromSpaceAsToSpace() {
       DCHECK(!IsFree() && IsInUnevacFromSpace());
       type_ = RegionType::kRegionTypeToSpace;
+      is_old_ = true;
     }
 
     ALWAYS_INLINE bool ShouldBeEvacuated();
@@ -477,8 +540,10 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     uint32_t alloc_time_;          // The allocation time of the region.
     size_t live_bytes_;            // The live bytes. Used to compute the live percent.
     bool is_newly_allocated_;      // True if it's allocated after the last collection.
+    bool is_old_;                  // True if it survived a collection (see SetOld()).
     bool is_a_tlab_;               // True if it's a tlab.
     Thread* thread_;               // The owning thread if it's a tlab.
+    uint32_t pin_count_;           // The number of JNI critical sections on its objects.
 
     friend class RegionSpace;
   };
@@ -40,15 +40,15 @@ inline bool IndirectReferenceTable::GetChecked(IndirectRef iref) const {
     AbortIfNoCheckJNI();
     return false;
   }
-  const int topIndex = segment_state_.parts.topIndex;
-  int idx = ExtractIndex(iref);
+  const uint32_t topIndex = segment_state_;
+  uint32_t idx = ExtractIndex(iref);
   if (UNLIKELY(idx >= topIndex)) {
     LOG(ERROR) << "JNI ERROR (app bug): accessed stale " << kind_ << " "
                << iref << " (index " << idx << " in a table of size " << topIndex << ")";
     AbortIfNoCheckJNI();
     return false;
   }
-  if (UNLIKELY(table_[idx].GetReference()->IsNull())) {
+  if (UNLIKELY(GetEntry(idx)->GetReference()->IsNull())) {
     LOG(ERROR) << "JNI ERROR (app bug): accessed deleted " << kind_ << " " << iref;
     AbortIfNoCheckJNI();
     return false;
@@ -78,7 +78,7 @@ inline mirror::Object* IndirectReferenceTable::Get(IndirectRef iref) const {
     return nullptr;
   }
   uint32_t idx = ExtractIndex(iref);
-  mirror::Object* obj = table_[idx].GetReference()->Read<kReadBarrierOption>();
+  mirror::Object* obj = GetEntry(idx)->GetReference()->Read<kReadBarrierOption>();
   VerifyObject(obj);
   return obj;
 }
@@ -89,7 +89,7 @@ inline void IndirectReferenceTable::Update(IndirectRef iref, mirror::Object* obj
     return;
   }
   uint32_t idx = ExtractIndex(iref);
-  table_[idx].SetReference(obj);
+  GetEntry(idx)->SetReference(obj);
 }
 
 }  // namespace art
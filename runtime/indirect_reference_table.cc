@@ -16,6 +16,7 @@
 
 #include "indirect_reference_table-inl.h"
 
+#include "base/stringprintf.h"
 #include "jni_internal.h"
 #include "nth_caller_visitor.h"
 #include "reference_table.h"
@@ -67,84 +68,99 @@ void IndirectReferenceTable::AbortIfNoCheckJNI() {
 }
 
 IndirectReferenceTable::IndirectReferenceTable(size_t initialCount,
-                                               size_t maxCount, IndirectRefKind desiredKind,
+                                               IndirectRefKind desiredKind,
                                                bool abort_on_error)
-    : kind_(desiredKind),
-      max_entries_(maxCount) {
+    : segment_state_(IRT_FIRST_SEGMENT),
+      first_hole_(kIRTNoHole),
+      chunks_(),
+      num_chunks_(0),
+      reserved_entries_(0),
+      first_chunk_shift_(WhichPowerOf2(RoundUpToPowerOfTwo(initialCount))),
+      kind_(desiredKind) {
   CHECK_GT(initialCount, 0U);
-  CHECK_LE(initialCount, maxCount);
+  CHECK_LE(initialCount, kIRTMaxEntries);
   CHECK_NE(desiredKind, kHandleScopeOrInvalid);
 
   std::string error_str;
-  const size_t table_bytes = maxCount * sizeof(IrtEntry);
-  table_mem_map_.reset(MemMap::MapAnonymous("indirect ref table", nullptr, table_bytes,
-                                            PROT_READ | PROT_WRITE, false, false, &error_str));
-  if (abort_on_error) {
-    CHECK(table_mem_map_.get() != nullptr) << error_str;
-    CHECK_EQ(table_mem_map_->Size(), table_bytes);
-    CHECK(table_mem_map_->Begin() != nullptr);
-  } else if (table_mem_map_.get() == nullptr ||
-             table_mem_map_->Size() != table_bytes ||
-             table_mem_map_->Begin() == nullptr) {
-    table_mem_map_.reset();
+  if (!AddChunk(&error_str)) {
+    CHECK(!abort_on_error) << error_str;
     LOG(ERROR) << error_str;
-    return;
   }
-  table_ = reinterpret_cast<IrtEntry*>(table_mem_map_->Begin());
-  segment_state_.all = IRT_FIRST_SEGMENT;
 }
 
 IndirectReferenceTable::~IndirectReferenceTable() {
 }
 
 bool IndirectReferenceTable::IsValid() const {
-  return table_mem_map_.get() != nullptr;
+  return num_chunks_ != 0;
 }
 
-IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
-  IRTSegmentState prevState;
-  prevState.all = cookie;
-  size_t topIndex = segment_state_.parts.topIndex;
+bool IndirectReferenceTable::AddChunk(std::string* error_msg) {
+  if (reserved_entries_ == kIRTMaxEntries) {
+    *error_msg = StringPrintf("max=%zu", kIRTMaxEntries);
+    return false;
+  }
+  DCHECK_LT(num_chunks_, kMaxChunks);
+  const size_t chunk_entries =
+      (num_chunks_ == 0) ? static_cast<size_t>(1) << first_chunk_shift_ : reserved_entries_;
+  const size_t chunk_bytes = chunk_entries * sizeof(IrtEntry);
+  std::unique_ptr<MemMap> chunk_map(MemMap::MapAnonymous("indirect ref table", nullptr,
+                                                         chunk_bytes, PROT_READ | PROT_WRITE,
+                                                         false, false, error_msg));
+  if (chunk_map.get() == nullptr ||
+      chunk_map->Size() != chunk_bytes ||
+      chunk_map->Begin() == nullptr) {
+    return false;
+  }
+  chunks_[num_chunks_] = reinterpret_cast<IrtEntry*>(chunk_map->Begin());
+  chunk_maps_[num_chunks_] = std::move(chunk_map);
+  ++num_chunks_;
+  reserved_entries_ += chunk_entries;
+  return true;
+}
 
+bool IndirectReferenceTable::EnsureFreeCapacity(size_t count, std::string* error_msg) {
+  const size_t top_index = segment_state_;
+  if (count > kIRTMaxEntries - top_index) {
+    *error_msg = StringPrintf("%zu entries requested, max=%zu", count, kIRTMaxEntries);
+    return false;
+  }
+  while (reserved_entries_ - top_index < count) {
+    if (!AddChunk(error_msg)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
   CHECK(obj != nullptr);
   VerifyObject(obj);
-  DCHECK(table_ != nullptr);
-  DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
+  DCHECK(IsValid());
 
-  if (topIndex == max_entries_) {
-    LOG(FATAL) << "JNI ERROR (app bug): " << kind_ << " table overflow "
-               << "(max=" << max_entries_ << ")\n"
-               << MutatorLockedDumpable<IndirectReferenceTable>(*this);
-  }
-
-  // We know there's enough room in the table.  Now we just need to find
-  // the right spot.  If there's a hole, find it and fill it; otherwise,
+  // If the current segment has a hole, fill the most recent one; otherwise,
   // add to the end of the list.
-  IndirectRef result;
-  int numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
   size_t index;
-  if (numHoles > 0) {
-    DCHECK_GT(topIndex, 1U);
-    // Find the first hole; likely to be near the end of the list.
-    IrtEntry* pScan = &table_[topIndex - 1];
-    DCHECK(!pScan->GetReference()->IsNull());
-    --pScan;
-    while (!pScan->GetReference()->IsNull()) {
-      DCHECK_GE(pScan, table_ + prevState.parts.topIndex);
-      --pScan;
-    }
-    index = pScan - table_;
-    segment_state_.parts.numHoles--;
+  if (first_hole_ != kIRTNoHole && first_hole_ >= cookie) {
+    index = first_hole_;
+    DCHECK_LT(index, segment_state_);
+    DCHECK(GetEntry(index)->GetReference()->IsNull());
+    first_hole_ = GetEntry(index)->GetNextHole();
   } else {
-    // Add to the end.
-    index = topIndex++;
-    segment_state_.parts.topIndex = topIndex;
+    index = segment_state_;
+    std::string error_msg;
+    if (UNLIKELY(index == reserved_entries_) && !AddChunk(&error_msg)) {
+      LOG(FATAL) << "JNI ERROR (app bug): " << kind_ << " table overflow "
+                 << "(" << error_msg << ")\n"
+                 << MutatorLockedDumpable<IndirectReferenceTable>(*this);
+    }
+    segment_state_ = index + 1;
   }
-  table_[index].Add(obj);
-  result = ToIndirectRef(index);
+  GetEntry(index)->Add(obj);
+  IndirectRef result = ToIndirectRef(index);
   if ((false)) {
-    LOG(INFO) << "+++ added at " << ExtractIndex(result) << " top=" << segment_state_.parts.topIndex
-              << " holes=" << segment_state_.parts.numHoles;
+    LOG(INFO) << "+++ added at " << ExtractIndex(result) << " top=" << segment_state_
+              << " first hole=" << first_hole_;
   }
 
   DCHECK(result != nullptr);
@@ -153,7 +169,7 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
 
 void IndirectReferenceTable::AssertEmpty() {
   for (size_t i = 0; i < Capacity(); ++i) {
-    if (!table_[i].GetReference()->IsNull()) {
+    if (!GetEntry(i)->GetReference()->IsNull()) {
       ScopedObjectAccess soa(Thread::Current());
       LOG(FATAL) << "Internal Error: non-empty local reference table\n"
                  << MutatorLockedDumpable<IndirectReferenceTable>(*this);
@@ -170,13 +186,10 @@ void IndirectReferenceTable::AssertEmpty() {
 // for explicit single removals.
 // Returns "false" if nothing was removed.
 bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
-  IRTSegmentState prevState;
-  prevState.all = cookie;
-  int topIndex = segment_state_.parts.topIndex;
-  int bottomIndex = prevState.parts.topIndex;
+  const uint32_t topIndex = segment_state_;
+  const uint32_t bottomIndex = cookie;
 
-  DCHECK(table_ != nullptr);
-  DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
+  DCHECK(IsValid());
 
   if (GetIndirectRefKind(iref) == kHandleScopeOrInvalid) {
     auto* self = Thread::Current();
@@ -193,7 +206,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
       return true;
     }
   }
-  const int idx = ExtractIndex(iref);
+  const uint32_t idx = ExtractIndex(iref);
   if (idx < bottomIndex) {
     // Wrong segment.
     LOG(WARNING) << "Attempt to remove index outside index area (" << idx
@@ -207,53 +220,36 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
     return false;
   }
 
-  if (idx == topIndex - 1) {
-    // Top-most entry.  Scan up and consume holes.
-
-    if (!CheckEntry("remove", iref, idx)) {
-      return false;
-    }
+  // We null out the entry to prevent somebody from deleting it twice and
+  // putting it twice on the free list.
+  IrtEntry* entry = GetEntry(idx);
+  if (entry->GetReference()->IsNull()) {
+    LOG(INFO) << "--- WEIRD: removing null entry " << idx;
+    return false;
+  }
+  if (!CheckEntry("remove", iref, idx)) {
+    return false;
+  }
+  *entry->GetReference() = GcRoot<mirror::Object>(nullptr);
 
-    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
-    int numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
-    if (numHoles != 0) {
-      while (--topIndex > bottomIndex && numHoles != 0) {
-        if ((false)) {
-          LOG(INFO) << "+++ checking for hole at " << topIndex - 1
-                    << " (cookie=" << cookie << ") val="
-                    << table_[topIndex - 1].GetReference()->Read<kWithoutReadBarrier>();
-        }
-        if (!table_[topIndex - 1].GetReference()->IsNull()) {
-          break;
-        }
-        if ((false)) {
-          LOG(INFO) << "+++ ate hole at " << (topIndex - 1);
-        }
-        numHoles--;
-      }
-      segment_state_.parts.numHoles = numHoles + prevState.parts.numHoles;
-      segment_state_.parts.topIndex = topIndex;
-    } else {
-      segment_state_.parts.topIndex = topIndex-1;
+  if (idx == topIndex - 1) {
+    // Top-most entry.  Scan down and consume the holes that are at the
+    // front of the free list.
+    uint32_t newTopIndex = idx;
+    while (newTopIndex > bottomIndex && first_hole_ == newTopIndex - 1) {
       if ((false)) {
-        LOG(INFO) << "+++ ate last entry " << topIndex - 1;
+        LOG(INFO) << "+++ ate hole at " << first_hole_;
       }
+      first_hole_ = GetEntry(first_hole_)->GetNextHole();
+      --newTopIndex;
     }
+    segment_state_ = newTopIndex;
   } else {
-    // Not the top-most entry.  This creates a hole.  We null out the entry to prevent somebody
-    // from deleting it twice and screwing up the hole count.
-    if (table_[idx].GetReference()->IsNull()) {
-      LOG(INFO) << "--- WEIRD: removing null entry " << idx;
-      return false;
-    }
-    if (!CheckEntry("remove", iref, idx)) {
-      return false;
-    }
-
-    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
-    segment_state_.parts.numHoles++;
+    // Not the top-most entry.  This creates a hole.
+    entry->SetNextHole(first_hole_);
+    first_hole_ = idx;
     if ((false)) {
-      LOG(INFO) << "+++ left hole at " << idx << ", holes=" << segment_state_.parts.numHoles;
+      LOG(INFO) << "+++ left hole at " << idx;
     }
   }
 
@@ -262,22 +258,27 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
 
 void IndirectReferenceTable::Trim() {
   const size_t top_index = Capacity();
-  auto* release_start = AlignUp(reinterpret_cast<uint8_t*>(&table_[top_index]), kPageSize);
+  // Release the end of the chunk holding the top, and all the chunks after it.
+  for (size_t chunk = ChunkOf(top_index); chunk < num_chunks_; ++chunk) {
+    IrtEntry* first_unused =
+        (ChunkBegin(chunk) < top_index) ? GetEntry(top_index) : chunks_[chunk];
+    auto* release_start = AlignUp(reinterpret_cast<uint8_t*>(first_unused), kPageSize);
 #ifndef MOE
-  uint8_t* release_end = table_mem_map_->End();
+    uint8_t* release_end = chunk_maps_[chunk]->End();
 #else
-  // On iOS arm64 - without AlignUp - 'release_end' could be less than 'release_start'
-  // causing the memset size to be huge. This is due to kPageSize being 16K on iOS/arm64.
-  // In other cases release_end seems to always be a multiple of 4K, thus skipping AlignUp
-  // did not cause issues.
-  uint8_t* release_end = AlignUp(table_mem_map_->End(), kPageSize);
-  // Make sure we zero
-  if (!kMadviseZeroes) {
-    moeRemapSpace(release_start, release_end - release_start, PROT_READ | PROT_WRITE,
-        MAP_PRIVATE | MAP_ANONYMOUS);
-  }
+    // On iOS arm64 - without AlignUp - 'release_end' could be less than 'release_start'
+    // causing the memset size to be huge. This is due to kPageSize being 16K on iOS/arm64.
+    // In other cases release_end seems to always be a multiple of 4K, thus skipping AlignUp
+    // did not cause issues.
+    uint8_t* release_end = AlignUp(chunk_maps_[chunk]->End(), kPageSize);
+    // Make sure we zero
+    if (!kMadviseZeroes) {
+      moeRemapSpace(release_start, release_end - release_start, PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS);
+    }
 #endif
-  madvise(release_start, release_end - release_start, MADV_DONTNEED);
+    madvise(release_start, release_end - release_start, MADV_DONTNEED);
+  }
 }
 
 void IndirectReferenceTable::VisitRoots(RootVisitor* visitor, const RootInfo& root_info) {
@@ -294,9 +295,9 @@ void IndirectReferenceTable::Dump(std::ostream& os) const {
   os << kind_ << " table dump:\n";
   ReferenceTable::Table entries;
   for (size_t i = 0; i < Capacity(); ++i) {
-    mirror::Object* obj = table_[i].GetReference()->Read<kWithoutReadBarrier>();
+    mirror::Object* obj = GetEntry(i)->GetReference()->Read<kWithoutReadBarrier>();
     if (obj != nullptr) {
-      obj = table_[i].GetReference()->Read();
+      obj = GetEntry(i)->GetReference()->Read();
       entries.push_back(GcRoot<mirror::Object>(obj));
     }
   }
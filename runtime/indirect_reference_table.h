@@ -20,11 +20,14 @@
 #include <stdint.h>
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 
+#include "base/bit_utils.h"
 #include "base/logging.h"
 #include "base/mutex.h"
 #include "gc_root.h"
+#include "globals.h"
 #include "object_callbacks.h"
 #include "offsets.h"
 #include "read_barrier_option.h"
@@ -71,13 +74,12 @@ class MemMap;
  *  - removing individual references
  *  - scanning the entire table straight through
  *
- * If there's more than one segment, we don't guarantee that the table
- * will fill completely before we fail due to lack of space.  We do ensure
- * that the current segment will pack tightly, which should satisfy JNI
- * requirements (e.g. EnsureLocalCapacity).
- *
- * To make everything fit nicely in 32-bit integers, the maximum size of
- * the table is capped at 64K.
+ * The table has no fixed maximum size.  It starts with room for the
+ * initial count of entries and grows by adding chunks of memory, each as
+ * large as the whole table before it.  Chunks are never moved or freed
+ * while the table is alive, so growing does not invalidate entries that
+ * another thread may be reading.  (Chunks are unrelated to segments: a
+ * segment may span several chunks.)
  *
  * Only SynchronizedGet is synchronized.
  */
@@ -86,12 +88,13 @@ class MemMap;
  * Indirect reference definition.  This must be interchangeable with JNI's
  * jobject, and it's convenient to let null be null, so we use void*.
  *
- * We need a 16-bit table index and a 2-bit reference type (global, local,
+ * We need a table index and a 2-bit reference type (global, local,
  * weak global).  Real object pointers will have zeroes in the low 2 or 3
  * bits (4- or 8-byte alignment), so it's useful to put the ref type
- * in the low bits and reserve zero as an invalid value.
+ * in the low bits and reserve zero as an invalid value.  The table index
+ * goes in the high bits.
  *
- * The remaining 14 bits can be used to detect stale indirect references.
+ * A few bits in between can be used to detect stale indirect references.
  * For example, if objects don't move, we can use a hash of the original
  * Object* to make sure the entry hasn't been re-used.  (If the Object*
  * we find there doesn't match because of heap movement, we could do a
@@ -138,18 +141,16 @@ static const uint32_t IRT_FIRST_SEGMENT = 0;
  * most-recently-added entry).  For JNI local references, the common
  * operations are adding a new entry and removing an entire table segment.
  *
- * If "alloc_entries_" is not equal to "max_entries_", the table may expand
- * when entries are added, which means the memory may move.  If you want
- * to keep pointers into "table" rather than offsets, you must use a
- * fixed-size table.
- *
  * If we delete entries from the middle of the list, we will be left with
- * "holes".  We track the number of holes so that, when adding new elements,
- * we can quickly decide to do a trivial append or go slot-hunting.
+ * "holes".  The holes are linked into a free list threaded through the
+ * entries themselves, the most recently created hole first, so that
+ * adding an element can reuse a hole without searching for it.
  *
- * When the top-most entry is removed, any holes immediately below it are
- * also removed.  Thus, deletion of an entry may reduce "topIndex" by more
- * than one.
+ * When the top-most entry is removed, the holes immediately below it are
+ * also removed, as long as they are at the front of the free list (which
+ * is the case when entries are deleted in the reverse order they were
+ * added).  Thus, deletion of an entry may reduce the top index by more
+ * than one, and the entry right below the top may be a hole.
  *
  * To get the desired behavior for JNI locals, we need to know the bottom
  * and top of the current "segment".  The top is managed internally, and
@@ -159,11 +160,12 @@ static const uint32_t IRT_FIRST_SEGMENT = 0;
  * becomes the new top index, and the value stored in the previous frame
  * becomes the new bottom.
  *
- * To avoid having to re-scan the table after a pop, we want to push the
- * number of holes in the table onto the stack.  Because of our 64K-entry
- * cap, we can combine the two into a single unsigned 32-bit value.
- * Instead of a "bottom" argument we take a "cookie", which includes the
- * bottom index and the count of holes below the bottom.
+ * The "cookie" that is pushed is just that top index.  Holes can only be
+ * created and filled in the current segment, so the holes of a segment
+ * are always in front of the holes of the segments below it in the free
+ * list.  Adding an element reuses the first hole if it is above the
+ * bottom of the current segment, and popping a segment drops the holes
+ * above the new top from the front of the list.
  *
  * Common alternative implementation: make IndirectRef a pointer to the
  * actual reference slot.  Instead of getting a table and doing a lookup,
@@ -175,28 +177,33 @@ static const uint32_t IRT_FIRST_SEGMENT = 0;
  * stale references aren't possible (though we may be able to get similar
  * benefits with other approaches).
  *
- * TODO: consider a "lastDeleteIndex" for quick hole-filling when an
- * add immediately follows a delete; must invalidate after segment pop
- * (which could increase the cost/complexity of method call/return).
- * Might be worth only using it for JNI globals.
- *
  * TODO: may want completely different add/remove algorithms for global
  * and local refs to improve performance.  A large circular buffer might
  * reduce the amortized cost of adding global references.
  *
  */
-union IRTSegmentState {
-  uint32_t          all;
-  struct {
-    uint32_t      topIndex:16;            /* index of first unused entry */
-    uint32_t      numHoles:16;            /* #of holes in entire table */
-  } parts;
-};
 
 // Try to choose kIRTPrevCount so that sizeof(IrtEntry) is a power of 2.
 // Contains multiple entries but only one active one, this helps us detect use after free errors
 // since the serial stored in the indirect ref wont match.
-static const size_t kIRTPrevCount = kIsDebugBuild ? 7 : 3;
+static const size_t kIRTPrevCount = kIsDebugBuild ? 6 : 2;
+
+// An IndirectRef holds the kind in its low bits, then the serial of the entry, then the index.
+static constexpr size_t kIRTKindBits = 2;
+static constexpr size_t kIRTSerialBits = 3;
+static_assert(kIRTPrevCount <= (1u << kIRTSerialBits), "Serial does not fit in an IndirectRef");
+static constexpr size_t kIRTIndexShift = kIRTKindBits + kIRTSerialBits;
+
+// The index must also fit in a cookie, which is a 32-bit value.
+static constexpr size_t kIRTIndexBits =
+    (kBitsPerIntPtrT - kIRTIndexShift < kBitsPerByte * sizeof(uint32_t) - 1)
+        ? kBitsPerIntPtrT - kIRTIndexShift
+        : kBitsPerByte * sizeof(uint32_t) - 1;
+static constexpr size_t kIRTMaxEntries = static_cast<size_t>(1) << kIRTIndexBits;
+
+// Marks the end of the free list of holes.
+static constexpr uint32_t kIRTNoHole = static_cast<uint32_t>(-1);
+
 class IrtEntry {
  public:
   void Add(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_) {
@@ -217,18 +224,28 @@ class IrtEntry {
     DCHECK_LT(serial_, kIRTPrevCount);
     references_[serial_] = GcRoot<mirror::Object>(obj);
   }
+  // Only meaningful while the entry is a hole: the index of the next hole in the free list.
+  uint32_t GetNextHole() const {
+    return next_hole_;
+  }
+  void SetNextHole(uint32_t index) {
+    next_hole_ = index;
+  }
 
  private:
   uint32_t serial_;
+  uint32_t next_hole_;
   GcRoot<mirror::Object> references_[kIRTPrevCount];
 };
-static_assert(sizeof(IrtEntry) == (1 + kIRTPrevCount) * sizeof(uint32_t),
+static_assert(sizeof(IrtEntry) == (2 + kIRTPrevCount) * sizeof(uint32_t),
               "Unexpected sizeof(IrtEntry)");
 
+class IndirectReferenceTable;
+
 class IrtIterator {
  public:
-  IrtIterator(IrtEntry* table, size_t i, size_t capacity) SHARED_REQUIRES(Locks::mutator_lock_)
-      : table_(table), i_(i), capacity_(capacity) {
+  IrtIterator(IndirectReferenceTable* table, size_t i) SHARED_REQUIRES(Locks::mutator_lock_)
+      : table_(table), i_(i) {
   }
 
   IrtIterator& operator++() SHARED_REQUIRES(Locks::mutator_lock_) {
@@ -236,19 +253,16 @@ class IrtIterator {
     return *this;
   }
 
-  GcRoot<mirror::Object>* operator*() {
-    // This does not have a read barrier as this is used to visit roots.
-    return table_[i_].GetReference();
-  }
+  // This does not have a read barrier as this is used to visit roots.
+  GcRoot<mirror::Object>* operator*();
 
   bool equals(const IrtIterator& rhs) const {
     return (i_ == rhs.i_ && table_ == rhs.table_);
   }
 
  private:
-  IrtEntry* const table_;
+  IndirectReferenceTable* const table_;
   size_t i_;
-  const size_t capacity_;
 };
 
 bool inline operator==(const IrtIterator& lhs, const IrtIterator& rhs) {
@@ -263,8 +277,7 @@ class IndirectReferenceTable {
  public:
   // WARNING: When using with abort_on_error = false, the object may be in a partially
   //          initialized state. Use IsValid() to check.
-  IndirectReferenceTable(size_t initialCount, size_t maxCount, IndirectRefKind kind,
-                         bool abort_on_error = true);
+  IndirectReferenceTable(size_t initialCount, IndirectRefKind kind, bool abort_on_error = true);
 
   ~IndirectReferenceTable();
 
@@ -273,8 +286,7 @@ class IndirectReferenceTable {
   /*
    * Add a new entry.  "obj" must be a valid non-nullptr object reference.
    *
-   * Returns nullptr if the table is full (max entries reached, or alloc
-   * failed during expansion).
+   * Aborts if the table cannot grow to make room for it.
    */
   IndirectRef Add(uint32_t cookie, mirror::Object* obj)
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -312,6 +324,14 @@ class IndirectReferenceTable {
    */
   bool Remove(uint32_t cookie, IndirectRef iref);
 
+  /*
+   * Make sure that "count" entries can be added to the current segment
+   * without growing the table.  Holes are not taken into account.
+   *
+   * Returns "false" and sets "error_msg" if the table cannot grow that much.
+   */
+  bool EnsureFreeCapacity(size_t count, std::string* error_msg);
+
   void AssertEmpty();
 
   void Dump(std::ostream& os) const SHARED_REQUIRES(Locks::mutator_lock_);
@@ -321,27 +341,31 @@ class IndirectReferenceTable {
    * so may be larger than the actual number of "live" entries.
    */
   size_t Capacity() const {
-    return segment_state_.parts.topIndex;
+    return segment_state_;
   }
 
   // Note IrtIterator does not have a read barrier as it's used to visit roots.
   IrtIterator begin() {
-    return IrtIterator(table_, 0, Capacity());
+    return IrtIterator(this, 0);
   }
 
   IrtIterator end() {
-    return IrtIterator(table_, Capacity(), Capacity());
+    return IrtIterator(this, Capacity());
   }
 
   void VisitRoots(RootVisitor* visitor, const RootInfo& root_info)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   uint32_t GetSegmentState() const {
-    return segment_state_.all;
+    return segment_state_;
   }
 
   void SetSegmentState(uint32_t new_state) {
-    segment_state_.all = new_state;
+    // Drop the holes of the segments being popped, they are at the front of the free list.
+    while (first_hole_ != kIRTNoHole && first_hole_ >= new_state) {
+      first_hole_ = GetEntry(first_hole_)->GetNextHole();
+    }
+    segment_state_ = new_state;
   }
 
   static Offset SegmentStateOffset() {
@@ -352,10 +376,14 @@ class IndirectReferenceTable {
   void Trim() SHARED_REQUIRES(Locks::mutator_lock_);
 
  private:
+  // The first chunk holds 2^first_chunk_shift_ entries, and each following chunk as many entries
+  // as all the chunks before it.
+  static constexpr size_t kMaxChunks = kIRTIndexBits + 1;
+
   // Extract the table index from an indirect reference.
   static uint32_t ExtractIndex(IndirectRef iref) {
     uintptr_t uref = reinterpret_cast<uintptr_t>(iref);
-    return (uref >> 2) & 0xffff;
+    return static_cast<uint32_t>(uref >> kIRTIndexShift);
   }
 
   /*
@@ -363,12 +391,30 @@ class IndirectReferenceTable {
    * implementations, so we shouldn't really be using it here.
    */
   IndirectRef ToIndirectRef(uint32_t tableIndex) const {
-    DCHECK_LT(tableIndex, 65536U);
-    uint32_t serialChunk = table_[tableIndex].GetSerial();
-    uintptr_t uref = (serialChunk << 20) | (tableIndex << 2) | kind_;
+    DCHECK_LT(tableIndex, kIRTMaxEntries);
+    uintptr_t serial = GetEntry(tableIndex)->GetSerial();
+    uintptr_t uref = (static_cast<uintptr_t>(tableIndex) << kIRTIndexShift) |
+        (serial << kIRTKindBits) | kind_;
     return reinterpret_cast<IndirectRef>(uref);
   }
 
+  // Index of the chunk holding entry "index", and index of the first entry of chunk "chunk".
+  size_t ChunkOf(size_t index) const {
+    return MinimumBitsToStore(index >> first_chunk_shift_);
+  }
+  size_t ChunkBegin(size_t chunk) const {
+    return (chunk == 0u) ? 0u : static_cast<size_t>(1) << (first_chunk_shift_ + chunk - 1);
+  }
+
+  IrtEntry* GetEntry(size_t index) const ALWAYS_INLINE {
+    DCHECK_LT(index, reserved_entries_);
+    size_t chunk = ChunkOf(index);
+    return &chunks_[chunk][index - ChunkBegin(chunk)];
+  }
+
+  // Map one more chunk, doubling the number of entries the table can hold.
+  bool AddChunk(std::string* error_msg);
+
   // Abort if check_jni is not enabled.
   static void AbortIfNoCheckJNI();
 
@@ -377,19 +423,30 @@ class IndirectReferenceTable {
   bool CheckEntry(const char*, IndirectRef, int) const;
 
   /* semi-public - read/write by jni down calls */
-  IRTSegmentState segment_state_;
-
-  // Mem map where we store the indirect refs.
-  std::unique_ptr<MemMap> table_mem_map_;
-  // bottom of the stack. Do not directly access the object references
-  // in this as they are roots. Use Get() that has a read barrier.
-  IrtEntry* table_;
+  // Index of the first unused entry.
+  uint32_t segment_state_;
+
+  // Index of the most recently created hole, or kIRTNoHole.
+  uint32_t first_hole_;
+
+  // Mem maps where we store the indirect refs, and their start. Do not directly access the
+  // object references in chunks_ as they are roots. Use Get() that has a read barrier.
+  std::unique_ptr<MemMap> chunk_maps_[kMaxChunks];
+  IrtEntry* chunks_[kMaxChunks];
+  size_t num_chunks_;
+  // Number of entries in all the chunks.
+  size_t reserved_entries_;
+  const size_t first_chunk_shift_;
   /* bit mask, ORed into all irefs */
   const IndirectRefKind kind_;
-  /* max #of entries allowed */
-  const size_t max_entries_;
+
+  friend class IrtIterator;
 };
 
+inline GcRoot<mirror::Object>* IrtIterator::operator*() {
+  return table_->GetEntry(i_)->GetReference();
+}
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_INDIRECT_REFERENCE_TABLE_H_
@@ -49,8 +49,7 @@ TEST_F(IndirectReferenceTableTest, BasicTest) {
 
   ScopedObjectAccess soa(Thread::Current());
   static const size_t kTableInitial = 10;
-  static const size_t kTableMax = 20;
-  IndirectReferenceTable irt(kTableInitial, kTableMax, kGlobal);
+  IndirectReferenceTable irt(kTableInitial, kGlobal);
 
   mirror::Class* c = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
   ASSERT_TRUE(c != nullptr);
@@ -254,4 +253,105 @@ TEST_F(IndirectReferenceTableTest, BasicTest) {
   CheckDump(&irt, 0, 0);
 }
 
+TEST_F(IndirectReferenceTableTest, Holes) {
+  // This will lead to error messages in the log.
+  ScopedLogSeverity sls(LogSeverity::FATAL);
+
+  ScopedObjectAccess soa(Thread::Current());
+  IndirectReferenceTable irt(10, kLocal);
+
+  mirror::Class* c = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(c != nullptr);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != nullptr);
+  mirror::Object* obj1 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj1 != nullptr);
+
+  const uint32_t cookie0 = IRT_FIRST_SEGMENT;
+
+  // Add four, remove #2 then #1, then the top: the holes are not the most recent
+  // first, so only the top goes away. The holes are filled by the next additions.
+  IndirectRef iref0 = irt.Add(cookie0, obj0);
+  IndirectRef iref1 = irt.Add(cookie0, obj1);
+  IndirectRef iref2 = irt.Add(cookie0, obj0);
+  IndirectRef iref3 = irt.Add(cookie0, obj1);
+  ASSERT_TRUE(irt.Remove(cookie0, iref2));
+  ASSERT_TRUE(irt.Remove(cookie0, iref1));
+  ASSERT_TRUE(irt.Remove(cookie0, iref3));
+  ASSERT_EQ(3U, irt.Capacity());
+  CheckDump(&irt, 1, 1);
+  iref1 = irt.Add(cookie0, obj1);
+  iref2 = irt.Add(cookie0, obj0);
+  ASSERT_EQ(3U, irt.Capacity()) << "holes not filled";
+  EXPECT_EQ(obj1, irt.Get(iref1));
+  EXPECT_EQ(obj0, irt.Get(iref2));
+
+  // Remove #1, then push a segment: additions to it do not fill the hole.
+  ASSERT_TRUE(irt.Remove(cookie0, iref1));
+  const uint32_t cookie1 = irt.GetSegmentState();
+  iref3 = irt.Add(cookie1, obj1);
+  IndirectRef iref4 = irt.Add(cookie1, obj0);
+  ASSERT_EQ(5U, irt.Capacity());
+  ASSERT_FALSE(irt.Remove(cookie1, iref0)) << "removed entry of previous segment";
+  ASSERT_TRUE(irt.Remove(cookie1, iref3));
+  CheckDump(&irt, 3, 1);
+
+  // Pop the segment. Its hole goes away with it and the hole of the
+  // previous segment is filled again.
+  irt.SetSegmentState(cookie1);
+  ASSERT_EQ(3U, irt.Capacity());
+  EXPECT_TRUE(irt.Get(iref4) == nullptr) << "popped lookup succeeded";
+  iref1 = irt.Add(cookie0, obj1);
+  ASSERT_EQ(3U, irt.Capacity()) << "hole not filled after pop";
+  iref3 = irt.Add(cookie0, obj1);
+  ASSERT_EQ(4U, irt.Capacity());
+  CheckDump(&irt, 4, 2);
+
+  // Remove in the opposite order of addition, the table should empty completely.
+  ASSERT_TRUE(irt.Remove(cookie0, iref0));
+  ASSERT_TRUE(irt.Remove(cookie0, iref1));
+  ASSERT_TRUE(irt.Remove(cookie0, iref2));
+  ASSERT_TRUE(irt.Remove(cookie0, iref3));
+  ASSERT_EQ(0U, irt.Capacity());
+  CheckDump(&irt, 0, 0);
+}
+
+TEST_F(IndirectReferenceTableTest, Growth) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableInitial = 10;
+  static const size_t kNumRefs = 1000;
+  IndirectReferenceTable irt(kTableInitial, kGlobal);
+
+  mirror::Class* c = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(c != nullptr);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != nullptr);
+  mirror::Object* obj1 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj1 != nullptr);
+
+  const uint32_t cookie = IRT_FIRST_SEGMENT;
+
+  // Way more than the initial count, the table grows several times.
+  std::vector<IndirectRef> refs;
+  for (size_t i = 0; i < kNumRefs; ++i) {
+    refs.push_back(irt.Add(cookie, (i % 2 == 0) ? obj0 : obj1));
+    ASSERT_TRUE(refs.back() != nullptr) << "Failed adding " << i;
+  }
+  ASSERT_EQ(kNumRefs, irt.Capacity());
+  CheckDump(&irt, kNumRefs, 2);
+  for (size_t i = 0; i < kNumRefs; ++i) {
+    EXPECT_EQ((i % 2 == 0) ? obj0 : obj1, irt.Get(refs[i])) << i;
+  }
+
+  std::string error_msg;
+  ASSERT_TRUE(irt.EnsureFreeCapacity(10 * kNumRefs, &error_msg)) << error_msg;
+  ASSERT_EQ(kNumRefs, irt.Capacity());
+
+  for (size_t i = kNumRefs; i != 0; --i) {
+    ASSERT_TRUE(irt.Remove(cookie, refs[i - 1])) << "failed removing " << (i - 1);
+  }
+  ASSERT_EQ(0U, irt.Capacity());
+  CheckDump(&irt, 0, 0);
+}
+
 }  // namespace art
@@ -18,8 +18,10 @@
 
 #include <memory>
 
+#include "base/mutex-inl.h"
 #include "gc_root-inl.h"
 #include "gc/collector/garbage_collector.h"
+#include "gc/heap.h"
 #include "gc/space/image_space.h"
 #include "gc/weak_root_state.h"
 #include "mirror/dex_cache-inl.h"
@@ -27,29 +29,69 @@
 #include "mirror/object-inl.h"
 #include "mirror/string-inl.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "utf.h"
 
 namespace art {
 
+// Below this number of weak interns, sweeping them is faster than waking up the thread pool.
+static constexpr size_t kMinWeakInternsForParallelSweep = 4 * KB;
+
+class InternTable::SweepWeaksTask : public Task {
+ public:
+  SweepWeaksTask(InternTable* intern_table, Shard* shard, IsMarkedVisitor* visitor)
+      : intern_table_(intern_table), shard_(shard), visitor_(visitor) {}
+
+  // The GC thread holds the mutator lock for the duration of the sweep.
+  virtual void Run(Thread* self) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    intern_table_->SweepWeaks(self, shard_, visitor_);
+  }
+
+ private:
+  InternTable* const intern_table_;
+  Shard* const shard_;
+  IsMarkedVisitor* const visitor_;
+};
+
+InternTable::Shard::Shard()
+    : lock("InternTable shard lock", kInternTableShardLock), log_new_roots(false) {
+}
+
 InternTable::InternTable()
-    : image_added_to_intern_table_(false), log_new_roots_(false),
+    : image_added_to_intern_table_(false),
       weak_intern_condition_("New intern condition", *Locks::intern_table_lock_),
       weak_root_state_(gc::kWeakRootStateNormal) {
 }
 
+InternTable::Shard* InternTable::GetShard(mirror::String* s) {
+  // Use the high bits of the Fibonacci hash of the string hash: the shard set uses the low bits,
+  // and the hashes of short strings do not have high bits.
+  const uint32_t hash = static_cast<uint32_t>(s->GetHashCode()) * 0x9e3779b9u;
+  return &shards_[hash >> (32 - kNumShardsBits)];
+}
+
 size_t InternTable::Size() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.Size() + weak_interns_.Size();
+  return StrongSize() + WeakSize();
 }
 
 size_t InternTable::StrongSize() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.Size();
+  Thread* const self = Thread::Current();
+  size_t size = image_interns_.Size();
+  for (const Shard& shard : shards_) {
+    ReaderMutexLock mu(self, shard.lock);
+    size += shard.strong_interns.Size();
+  }
+  return size;
 }
 
 size_t InternTable::WeakSize() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return weak_interns_.Size();
+  Thread* const self = Thread::Current();
+  size_t size = 0;
+  for (const Shard& shard : shards_) {
+    ReaderMutexLock mu(self, shard.lock);
+    size += shard.weak_interns.Size();
+  }
+  return size;
 }
 
 void InternTable::DumpForSigQuit(std::ostream& os) const {
@@ -57,97 +99,118 @@ void InternTable::DumpForSigQuit(std::ostream& os) const {
 }
 
 void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
   if ((flags & kVisitRootFlagAllRoots) != 0) {
-    strong_interns_.VisitRoots(visitor);
-  } else if ((flags & kVisitRootFlagNewRoots) != 0) {
-    for (auto& root : new_strong_intern_roots_) {
-      mirror::String* old_ref = root.Read<kWithoutReadBarrier>();
-      root.VisitRoot(visitor, RootInfo(kRootInternedString));
-      mirror::String* new_ref = root.Read<kWithoutReadBarrier>();
-      if (new_ref != old_ref) {
-        // The GC moved a root in the log. Need to search the strong interns and update the
-        // corresponding object. This is slow, but luckily for us, this may only happen with a
-        // concurrent moving GC.
-        strong_interns_.Remove(old_ref);
-        strong_interns_.Insert(new_ref);
+    image_interns_.VisitRoots(visitor);
+  }
+  Thread* const self = Thread::Current();
+  for (Shard& shard : shards_) {
+    WriterMutexLock mu(self, shard.lock);
+    if ((flags & kVisitRootFlagAllRoots) != 0) {
+      shard.strong_interns.VisitRoots(visitor);
+    } else if ((flags & kVisitRootFlagNewRoots) != 0) {
+      for (auto& root : shard.new_strong_intern_roots) {
+        mirror::String* old_ref = root.Read<kWithoutReadBarrier>();
+        root.VisitRoot(visitor, RootInfo(kRootInternedString));
+        mirror::String* new_ref = root.Read<kWithoutReadBarrier>();
+        if (new_ref != old_ref) {
+          // The GC moved a root in the log. Need to search the strong interns and update the
+          // corresponding object. This is slow, but luckily for us, this may only happen with a
+          // concurrent moving GC.
+          shard.strong_interns.Remove(old_ref);
+          shard.strong_interns.Insert(new_ref);
+        }
       }
     }
+    if ((flags & kVisitRootFlagClearRootLog) != 0) {
+      shard.new_strong_intern_roots.clear();
+    }
+    if ((flags & kVisitRootFlagStartLoggingNewRoots) != 0) {
+      shard.log_new_roots = true;
+    } else if ((flags & kVisitRootFlagStopLoggingNewRoots) != 0) {
+      shard.log_new_roots = false;
+    }
   }
-  if ((flags & kVisitRootFlagClearRootLog) != 0) {
-    new_strong_intern_roots_.clear();
-  }
-  if ((flags & kVisitRootFlagStartLoggingNewRoots) != 0) {
-    log_new_roots_ = true;
-  } else if ((flags & kVisitRootFlagStopLoggingNewRoots) != 0) {
-    log_new_roots_ = false;
-  }
-  // Note: we deliberately don't visit the weak_interns_ table and the immutable image roots.
+  // Note: we deliberately don't visit the weak_interns tables and the immutable image roots.
 }
 
-mirror::String* InternTable::LookupStrong(mirror::String* s) {
-  return strong_interns_.Find(s);
+mirror::String* InternTable::LookupStrong(Shard* shard, mirror::String* s) {
+  mirror::String* image = image_interns_.Find(s);
+  if (image != nullptr) {
+    return image;
+  }
+  return shard->strong_interns.Find(s);
 }
 
-mirror::String* InternTable::LookupWeak(mirror::String* s) {
-  return weak_interns_.Find(s);
+mirror::String* InternTable::LookupWeak(Shard* shard, mirror::String* s) {
+  return shard->weak_interns.Find(s);
 }
 
 void InternTable::SwapPostZygoteWithPreZygote() {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  weak_interns_.SwapPostZygoteWithPreZygote();
-  strong_interns_.SwapPostZygoteWithPreZygote();
+  Thread* const self = Thread::Current();
+  for (Shard& shard : shards_) {
+    WriterMutexLock mu(self, shard.lock);
+    shard.weak_interns.SwapPostZygoteWithPreZygote();
+    shard.strong_interns.SwapPostZygoteWithPreZygote();
+  }
 }
 
-mirror::String* InternTable::InsertStrong(mirror::String* s) {
+mirror::String* InternTable::InsertStrong(Shard* shard, mirror::String* s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
     runtime->RecordStrongStringInsertion(s);
   }
-  if (log_new_roots_) {
-    new_strong_intern_roots_.push_back(GcRoot<mirror::String>(s));
+  if (shard->log_new_roots) {
+    shard->new_strong_intern_roots.push_back(GcRoot<mirror::String>(s));
   }
-  strong_interns_.Insert(s);
+  shard->strong_interns.Insert(s);
   return s;
 }
 
-mirror::String* InternTable::InsertWeak(mirror::String* s) {
+mirror::String* InternTable::InsertWeak(Shard* shard, mirror::String* s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
     runtime->RecordWeakStringInsertion(s);
   }
-  weak_interns_.Insert(s);
+  shard->weak_interns.Insert(s);
   return s;
 }
 
-void InternTable::RemoveStrong(mirror::String* s) {
-  strong_interns_.Remove(s);
+void InternTable::RemoveStrong(Shard* shard, mirror::String* s) {
+  shard->strong_interns.Remove(s);
 }
 
-void InternTable::RemoveWeak(mirror::String* s) {
+void InternTable::RemoveWeak(Shard* shard, mirror::String* s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
     runtime->RecordWeakStringRemoval(s);
   }
-  weak_interns_.Remove(s);
+  shard->weak_interns.Remove(s);
 }
 
 // Insert/remove methods used to undo changes made during an aborted transaction.
 mirror::String* InternTable::InsertStrongFromTransaction(mirror::String* s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  return InsertStrong(s);
+  Shard* const shard = GetShard(s);
+  WriterMutexLock mu(Thread::Current(), shard->lock);
+  return InsertStrong(shard, s);
 }
 mirror::String* InternTable::InsertWeakFromTransaction(mirror::String* s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  return InsertWeak(s);
+  Shard* const shard = GetShard(s);
+  WriterMutexLock mu(Thread::Current(), shard->lock);
+  return InsertWeak(shard, s);
 }
 void InternTable::RemoveStrongFromTransaction(mirror::String* s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  RemoveStrong(s);
+  Shard* const shard = GetShard(s);
+  WriterMutexLock mu(Thread::Current(), shard->lock);
+  RemoveStrong(shard, s);
 }
 void InternTable::RemoveWeakFromTransaction(mirror::String* s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  RemoveWeak(s);
+  Shard* const shard = GetShard(s);
+  WriterMutexLock mu(Thread::Current(), shard->lock);
+  RemoveWeak(shard, s);
 }
 
 void InternTable::AddImageStringsToTable(gc::space::ImageSpace* image_space) {
@@ -163,15 +226,18 @@ void InternTable::AddImageStringsToTable(gc::space::ImageSpace* image_space) {
       // TODO: Delete this logic?
       mirror::Object* root = header->GetImageRoot(ImageHeader::kDexCaches);
       mirror::ObjectArray<mirror::DexCache>* dex_caches = root->AsObjectArray<mirror::DexCache>();
+      Thread* const self = Thread::Current();
       for (int32_t i = 0; i < dex_caches->GetLength(); ++i) {
         mirror::DexCache* dex_cache = dex_caches->Get(i);
         const size_t num_strings = dex_cache->NumStrings();
         for (size_t j = 0; j < num_strings; ++j) {
           mirror::String* image_string = dex_cache->GetResolvedString(j);
           if (image_string != nullptr) {
-            mirror::String* found = LookupStrong(image_string);
+            Shard* const shard = GetShard(image_string);
+            WriterMutexLock mu2(self, shard->lock);
+            mirror::String* found = LookupStrong(shard, image_string);
             if (found == nullptr) {
-              InsertStrong(image_string);
+              InsertStrong(shard, image_string);
             } else {
               DCHECK_EQ(found, image_string);
             }
@@ -218,16 +284,16 @@ void InternTable::BroadcastForNewInterns() {
   weak_intern_condition_.Broadcast(self);
 }
 
-void InternTable::WaitUntilAccessible(Thread* self) {
-  Locks::intern_table_lock_->ExclusiveUnlock(self);
+void InternTable::WaitUntilAccessible(Thread* self, Shard* shard) {
+  shard->lock.ExclusiveUnlock(self);
   {
     ScopedThreadSuspension sts(self, kWaitingWeakGcRootRead);
     MutexLock mu(self, *Locks::intern_table_lock_);
-    while (weak_root_state_ == gc::kWeakRootStateNoReadsOrWrites) {
+    while (weak_root_state_.LoadRelaxed() == gc::kWeakRootStateNoReadsOrWrites) {
       weak_intern_condition_.Wait(self);
     }
   }
-  Locks::intern_table_lock_->ExclusiveLock(self);
+  shard->lock.ExclusiveLock(self);
 }
 
 mirror::String* InternTable::Insert(mirror::String* s, bool is_strong, bool holding_locks) {
@@ -235,7 +301,17 @@ mirror::String* InternTable::Insert(mirror::String* s, bool is_strong, bool hold
     return nullptr;
   }
   Thread* const self = Thread::Current();
-  MutexLock mu(self, *Locks::intern_table_lock_);
+  Shard* const shard = GetShard(s);
+  {
+    // Most strings are already strong interns, find them holding the shard lock shared so that
+    // threads interning the same strings do not serialize.
+    ReaderMutexLock mu(self, shard->lock);
+    mirror::String* strong = LookupStrong(shard, s);
+    if (strong != nullptr) {
+      return strong;
+    }
+  }
+  WriterMutexLock mu(self, shard->lock);
   if (kDebugLocking && !holding_locks) {
     Locks::mutator_lock_->AssertSharedHeld(self);
     CHECK_EQ(2u, self->NumberOfHeldMutexes()) << "may only safely hold the mutator lock";
@@ -243,17 +319,19 @@ mirror::String* InternTable::Insert(mirror::String* s, bool is_strong, bool hold
   while (true) {
     if (holding_locks) {
       if (!kUseReadBarrier) {
-        CHECK_EQ(weak_root_state_, gc::kWeakRootStateNormal);
+        CHECK_EQ(weak_root_state_.LoadRelaxed(), gc::kWeakRootStateNormal);
       } else {
         CHECK(self->GetWeakRefAccessEnabled());
       }
     }
-    // Check the strong table for a match.
-    mirror::String* strong = LookupStrong(s);
+    // Check the strong table for a match, another thread may have inserted the string since we
+    // looked it up.
+    mirror::String* strong = LookupStrong(shard, s);
     if (strong != nullptr) {
       return strong;
     }
-    if ((!kUseReadBarrier && weak_root_state_ != gc::kWeakRootStateNoReadsOrWrites) ||
+    if ((!kUseReadBarrier &&
+         weak_root_state_.LoadRelaxed() != gc::kWeakRootStateNoReadsOrWrites) ||
         (kUseReadBarrier && self->GetWeakRefAccessEnabled())) {
       break;
     }
@@ -263,30 +341,30 @@ mirror::String* InternTable::Insert(mirror::String* s, bool is_strong, bool hold
     CHECK(!holding_locks);
     StackHandleScope<1> hs(self);
     auto h = hs.NewHandleWrapper(&s);
-    WaitUntilAccessible(self);
+    WaitUntilAccessible(self, shard);
   }
   if (!kUseReadBarrier) {
-    CHECK_EQ(weak_root_state_, gc::kWeakRootStateNormal);
+    CHECK_EQ(weak_root_state_.LoadRelaxed(), gc::kWeakRootStateNormal);
   } else {
     CHECK(self->GetWeakRefAccessEnabled());
   }
   // There is no match in the strong table, check the weak table.
-  mirror::String* weak = LookupWeak(s);
+  mirror::String* weak = LookupWeak(shard, s);
   if (weak != nullptr) {
     if (is_strong) {
       // A match was found in the weak table. Promote to the strong table.
-      RemoveWeak(weak);
-      return InsertStrong(weak);
+      RemoveWeak(shard, weak);
+      return InsertStrong(shard, weak);
     }
     return weak;
   }
   // Check the image for a match.
   mirror::String* image = LookupStringFromImage(s);
   if (image != nullptr) {
-    return is_strong ? InsertStrong(image) : InsertWeak(image);
+    return is_strong ? InsertStrong(shard, image) : InsertWeak(shard, image);
   }
   // No match in the strong table or the weak table. Insert into the strong / weak table.
-  return is_strong ? InsertStrong(s) : InsertWeak(s);
+  return is_strong ? InsertStrong(shard, s) : InsertWeak(shard, s);
 }
 
 mirror::String* InternTable::InternStrong(int32_t utf16_length, const char* utf8_data) {
@@ -314,13 +392,36 @@ mirror::String* InternTable::InternWeak(mirror::String* s) {
 }
 
 bool InternTable::ContainsWeak(mirror::String* s) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return LookupWeak(s) == s;
+  Shard* const shard = GetShard(s);
+  ReaderMutexLock mu(Thread::Current(), shard->lock);
+  return LookupWeak(shard, s) == s;
 }
 
 void InternTable::SweepInternTableWeaks(IsMarkedVisitor* visitor) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  weak_interns_.SweepWeaks(visitor);
+  Thread* const self = Thread::Current();
+  ThreadPool* const thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  // With read barriers, hashing the strings when erasing dead ones may mark them. Only the GC
+  // thread may mark at this point, since it processes its mark stack after sweeping.
+  if (kUseReadBarrier || thread_pool == nullptr || WeakSize() < kMinWeakInternsForParallelSweep) {
+    for (Shard& shard : shards_) {
+      SweepWeaks(self, &shard, visitor);
+    }
+    return;
+  }
+  std::vector<std::unique_ptr<SweepWeaksTask>> tasks;
+  for (Shard& shard : shards_) {
+    tasks.emplace_back(new SweepWeaksTask(this, &shard, visitor));
+    thread_pool->AddTask(self, tasks.back().get());
+  }
+  thread_pool->SetMaxActiveWorkers(thread_pool->GetThreadCount());
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+}
+
+void InternTable::SweepWeaks(Thread* self, Shard* shard, IsMarkedVisitor* visitor) {
+  WriterMutexLock mu(self, shard->lock);
+  shard->weak_interns.SweepWeaks(visitor);
 }
 
 void InternTable::AddImageInternTable(gc::space::ImageSpace* image_space) {
@@ -338,18 +439,24 @@ size_t InternTable::ReadFromMemory(const uint8_t* ptr) {
 }
 
 size_t InternTable::ReadFromMemoryLocked(const uint8_t* ptr) {
-  return strong_interns_.ReadIntoPreZygoteTable(ptr);
+  return image_interns_.ReadIntoPreZygoteTable(ptr);
 }
 
 size_t InternTable::WriteToMemory(uint8_t* ptr) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.WriteFromPostZygoteTable(ptr);
+  // The image has a single table. Merge the shards in shard order, so that computing the size and
+  // writing the table give the same layout.
+  Thread* const self = Thread::Current();
+  Table table;
+  for (Shard& shard : shards_) {
+    ReaderMutexLock mu(self, shard.lock);
+    shard.strong_interns.AddPostZygoteInternsTo(&table);
+  }
+  return table.WriteFromPostZygoteTable(ptr);
 }
 
 std::size_t InternTable::StringHashEquals::operator()(const GcRoot<mirror::String>& root) const {
-  if (kIsDebugBuild) {
-    Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
-  }
+  // Not asserting that the mutator lock is held: the heap thread pool hashes the strings when
+  // sweeping the weak interns, on behalf of the GC thread which holds it.
   return static_cast<size_t>(root.Read()->GetHashCode());
 }
 
@@ -372,6 +479,12 @@ size_t InternTable::Table::WriteFromPostZygoteTable(uint8_t* ptr) {
   return post_zygote_table_.WriteToMemory(ptr);
 }
 
+void InternTable::Table::AddPostZygoteInternsTo(Table* table) {
+  for (GcRoot<mirror::String>& intern : post_zygote_table_) {
+    table->post_zygote_table_.Insert(intern);
+  }
+}
+
 void InternTable::Table::Remove(mirror::String* s) {
   auto it = post_zygote_table_.Find(GcRoot<mirror::String>(s));
   if (it != post_zygote_table_.end()) {
@@ -384,7 +497,6 @@ void InternTable::Table::Remove(mirror::String* s) {
 }
 
 mirror::String* InternTable::Table::Find(mirror::String* s) {
-  Locks::intern_table_lock_->AssertHeld(Thread::Current());
   auto it = pre_zygote_table_.Find(GcRoot<mirror::String>(s));
   if (it != pre_zygote_table_.end()) {
     return it->Read();
@@ -453,7 +565,7 @@ void InternTable::ChangeWeakRootState(gc::WeakRootState new_state) {
 
 void InternTable::ChangeWeakRootStateLocked(gc::WeakRootState new_state) {
   CHECK(!kUseReadBarrier);
-  weak_root_state_ = new_state;
+  weak_root_state_.StoreRelaxed(new_state);
   if (new_state != gc::kWeakRootStateNoReadsOrWrites) {
     weak_intern_condition_.Broadcast(Thread::Current());
   }
@@ -51,6 +51,10 @@ class Transaction;
  * String.intern. Some code (XML parsers being a prime example) relies on being able to intern
  * arbitrarily many strings for the duration of a parse without permanently increasing the memory
  * footprint.
+ *
+ * Both tables are split in shards by string hash, each shard having its own lock, so that threads
+ * interning different strings rarely contend. Lookups only hold the lock of their shard shared.
+ * The strong interns read from the image never change, and are looked up without lock.
  */
 class InternTable {
  public:
@@ -78,23 +82,23 @@ class InternTable {
   mirror::String* InternWeak(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!Roles::uninterruptible_);
 
-  void SweepInternTableWeaks(IsMarkedVisitor* visitor) SHARED_REQUIRES(Locks::mutator_lock_)
-      REQUIRES(!Locks::intern_table_lock_);
+  // Sweep the weak interns. The shards are swept in parallel with the heap thread pool when
+  // there are enough weak interns.
+  void SweepInternTableWeaks(IsMarkedVisitor* visitor) SHARED_REQUIRES(Locks::mutator_lock_);
 
-  bool ContainsWeak(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_)
-      REQUIRES(!Locks::intern_table_lock_);
+  bool ContainsWeak(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Total number of interned strings.
-  size_t Size() const REQUIRES(!Locks::intern_table_lock_);
+  size_t Size() const;
   // Total number of weakly live interned strings.
-  size_t StrongSize() const REQUIRES(!Locks::intern_table_lock_);
+  size_t StrongSize() const;
   // Total number of strongly live interned strings.
-  size_t WeakSize() const REQUIRES(!Locks::intern_table_lock_);
+  size_t WeakSize() const;
 
   void VisitRoots(RootVisitor* visitor, VisitRootFlags flags)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!Locks::intern_table_lock_);
+      SHARED_REQUIRES(Locks::mutator_lock_);
 
-  void DumpForSigQuit(std::ostream& os) const REQUIRES(!Locks::intern_table_lock_);
+  void DumpForSigQuit(std::ostream& os) const;
 
   void BroadcastForNewInterns() SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -104,8 +108,7 @@ class InternTable {
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!Locks::intern_table_lock_);
 
   // Copy the post zygote tables to pre zygote to save memory by preventing dirty pages.
-  void SwapPostZygoteWithPreZygote()
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!Locks::intern_table_lock_);
+  void SwapPostZygoteWithPreZygote() SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Add an intern table which was serialized to the image.
   void AddImageInternTable(gc::space::ImageSpace* image_space)
@@ -116,10 +119,10 @@ class InternTable {
   size_t ReadFromMemory(const uint8_t* ptr) REQUIRES(!Locks::intern_table_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
-  // Write the post zygote intern table to a pointer. Only writes the strong interns since it is
-  // expected that there is no weak interns since this is called from the image writer.
-  size_t WriteToMemory(uint8_t* ptr) SHARED_REQUIRES(Locks::mutator_lock_)
-      REQUIRES(!Locks::intern_table_lock_);
+  // Write the post zygote intern tables of all shards to a pointer, as a single table. Only writes
+  // the strong interns since it is expected that there is no weak interns since this is called
+  // from the image writer.
+  size_t WriteToMemory(uint8_t* ptr) SHARED_REQUIRES(Locks::mutator_lock_);
 
   // Change the weak root state. May broadcast to waiters.
   void ChangeWeakRootState(gc::WeakRootState new_state)
@@ -143,37 +146,33 @@ class InternTable {
   };
 
   // Table which holds pre zygote and post zygote interned strings. There is one instance for
-  // weak interns and strong interns.
+  // weak interns and strong interns in each shard. Tables are not thread safe, the shard lock
+  // guards them.
   class Table {
    public:
     Table();
-    mirror::String* Find(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_)
-        REQUIRES(Locks::intern_table_lock_);
-    void Insert(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_)
-        REQUIRES(Locks::intern_table_lock_);
-    void Remove(mirror::String* s)
-        SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    void VisitRoots(RootVisitor* visitor)
-        SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    void SweepWeaks(IsMarkedVisitor* visitor)
-        SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    void SwapPostZygoteWithPreZygote() REQUIRES(Locks::intern_table_lock_);
-    size_t Size() const REQUIRES(Locks::intern_table_lock_);
+    mirror::String* Find(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_);
+    void Insert(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_);
+    void Remove(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_);
+    void VisitRoots(RootVisitor* visitor) SHARED_REQUIRES(Locks::mutator_lock_);
+    void SweepWeaks(IsMarkedVisitor* visitor) SHARED_REQUIRES(Locks::mutator_lock_);
+    void SwapPostZygoteWithPreZygote();
+    size_t Size() const;
     // Read pre zygote table is called from ReadFromMemory which happens during runtime creation
     // when we load the image intern table. Returns how many bytes were read.
-    size_t ReadIntoPreZygoteTable(const uint8_t* ptr)
-        REQUIRES(Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+    size_t ReadIntoPreZygoteTable(const uint8_t* ptr) SHARED_REQUIRES(Locks::mutator_lock_);
     // The image writer calls WritePostZygoteTable through WriteToMemory, it writes the interns in
     // the post zygote table. Returns how many bytes were written.
-    size_t WriteFromPostZygoteTable(uint8_t* ptr)
-        REQUIRES(Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+    size_t WriteFromPostZygoteTable(uint8_t* ptr) SHARED_REQUIRES(Locks::mutator_lock_);
+    // Insert the interns of the post zygote table in the post zygote table of `table`.
+    void AddPostZygoteInternsTo(Table* table) SHARED_REQUIRES(Locks::mutator_lock_);
 
    private:
     typedef HashSet<GcRoot<mirror::String>, GcRootEmptyFn, StringHashEquals, StringHashEquals,
         TrackingAllocator<GcRoot<mirror::String>, kAllocatorTagInternTable>> UnorderedSet;
 
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
-        SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+        SHARED_REQUIRES(Locks::mutator_lock_);
 
     // We call SwapPostZygoteWithPreZygote when we create the zygote to reduce private dirty pages
     // caused by modifying the zygote intern table hash table. The pre zygote table are the
@@ -183,28 +182,63 @@ class InternTable {
     UnorderedSet post_zygote_table_;
   };
 
+  // The strong and weak interns of the strings whose hash maps to the shard. Equal strings map to
+  // the same shard, so looking up a string in both tables and promoting it from weak to strong
+  // only needs the lock of its shard.
+  struct Shard {
+    Shard();
+
+    mutable ReaderWriterMutex lock;
+    // Since this contains (strong) roots, they need a read barrier to
+    // enable concurrent intern table (strong) root scan. Do not
+    // directly access the strings in it. Use functions that contain
+    // read barriers.
+    Table strong_interns GUARDED_BY(lock);
+    // Logged per shard, so that visiting the roots of a shard and starting to log its new roots
+    // is atomic with respect to the insertions in the shard.
+    bool log_new_roots GUARDED_BY(lock);
+    std::vector<GcRoot<mirror::String>> new_strong_intern_roots GUARDED_BY(lock);
+    // Since this contains (weak) roots, they need a read barrier. Do
+    // not directly access the strings in it. Use functions that contain
+    // read barriers.
+    Table weak_interns GUARDED_BY(lock);
+
+    DISALLOW_COPY_AND_ASSIGN(Shard);
+  };
+
+  // Sweeps the weak interns of a shard from the heap thread pool.
+  class SweepWeaksTask;
+
+  static constexpr size_t kNumShardsBits = 4;
+  static constexpr size_t kNumShards = 1u << kNumShardsBits;
+
+  Shard* GetShard(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Insert if non null, otherwise return null. Must be called holding the mutator lock.
   // If holding_locks is true, then we may also hold other locks. If holding_locks is true, then we
   // require GC is not running since it is not safe to wait while holding locks.
   mirror::String* Insert(mirror::String* s, bool is_strong, bool holding_locks)
-      REQUIRES(!Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+      SHARED_REQUIRES(Locks::mutator_lock_);
 
-  mirror::String* LookupStrong(mirror::String* s)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  mirror::String* LookupWeak(mirror::String* s)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  mirror::String* InsertStrong(mirror::String* s)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  mirror::String* InsertWeak(mirror::String* s)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  void RemoveStrong(mirror::String* s)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  void RemoveWeak(mirror::String* s)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+  mirror::String* LookupStrong(Shard* shard, mirror::String* s)
+      SHARED_REQUIRES(Locks::mutator_lock_, shard->lock);
+  mirror::String* LookupWeak(Shard* shard, mirror::String* s)
+      SHARED_REQUIRES(Locks::mutator_lock_, shard->lock);
+  mirror::String* InsertStrong(Shard* shard, mirror::String* s)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(shard->lock);
+  mirror::String* InsertWeak(Shard* shard, mirror::String* s)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(shard->lock);
+  void RemoveStrong(Shard* shard, mirror::String* s)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(shard->lock);
+  void RemoveWeak(Shard* shard, mirror::String* s)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(shard->lock);
+  void SweepWeaks(Thread* self, Shard* shard, IsMarkedVisitor* visitor)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!shard->lock);
 
-  // Transaction rollback access.
   mirror::String* LookupStringFromImage(mirror::String* s)
-      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Transaction rollback access.
   mirror::String* InsertStrongFromTransaction(mirror::String* s)
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
   mirror::String* InsertWeakFromTransaction(mirror::String* s)
@@ -221,26 +255,21 @@ class InternTable {
   void ChangeWeakRootStateLocked(gc::WeakRootState new_state)
       REQUIRES(Locks::intern_table_lock_);
 
-  // Wait until we can read weak roots.
-  void WaitUntilAccessible(Thread* self)
-      REQUIRES(Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
+  // Wait until we can read weak roots. Releases the shard lock while waiting.
+  void WaitUntilAccessible(Thread* self, Shard* shard)
+      REQUIRES(shard->lock, !Locks::intern_table_lock_) SHARED_REQUIRES(Locks::mutator_lock_);
 
-  bool image_added_to_intern_table_ GUARDED_BY(Locks::intern_table_lock_);
-  bool log_new_roots_ GUARDED_BY(Locks::intern_table_lock_);
+  // Only set while the runtime is created, before other threads intern strings.
+  bool image_added_to_intern_table_;
   ConditionVariable weak_intern_condition_ GUARDED_BY(Locks::intern_table_lock_);
-  // Since this contains (strong) roots, they need a read barrier to
-  // enable concurrent intern table (strong) root scan. Do not
-  // directly access the strings in it. Use functions that contain
-  // read barriers.
-  Table strong_interns_ GUARDED_BY(Locks::intern_table_lock_);
-  std::vector<GcRoot<mirror::String>> new_strong_intern_roots_
-      GUARDED_BY(Locks::intern_table_lock_);
-  // Since this contains (weak) roots, they need a read barrier. Do
-  // not directly access the strings in it. Use functions that contain
-  // read barriers.
-  Table weak_interns_ GUARDED_BY(Locks::intern_table_lock_);
-  // Weak root state, used for concurrent system weak processing and more.
-  gc::WeakRootState weak_root_state_ GUARDED_BY(Locks::intern_table_lock_);
+  // The strong interns read from the image. Only written while the runtime is created, they are
+  // looked up without lock.
+  Table image_interns_;
+  Shard shards_[kNumShards];
+  // Weak root state, used for concurrent system weak processing and more. Changed holding the
+  // intern table lock, which the threads waiting for weak root accesses wait on. Read holding a
+  // shard lock when interning.
+  Atomic<gc::WeakRootState> weak_root_state_;
 
   friend class Transaction;
   DISALLOW_COPY_AND_ASSIGN(InternTable);
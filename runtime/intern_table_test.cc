@@ -16,9 +16,13 @@
 
 #include "intern_table.h"
 
+#include <set>
+
+#include "base/stringprintf.h"
 #include "common_runtime_test.h"
 #include "mirror/object.h"
 #include "handle_scope-inl.h"
+#include "mirror/object_array-inl.h"
 #include "mirror/string.h"
 #include "scoped_thread_state_change.h"
 
@@ -120,6 +124,52 @@ TEST_F(InternTableTest, SweepInternTableWeaks) {
   EXPECT_EQ(3U, t.Size());
 }
 
+// Thread safe, since the shards may be swept in parallel.
+class KeepPredicate : public IsMarkedVisitor {
+ public:
+  explicit KeepPredicate(const std::set<const mirror::Object*>& kept) : kept_(kept) {}
+
+  mirror::Object* IsMarked(mirror::Object* s) OVERRIDE {
+    return kept_.find(s) != kept_.end() ? s : nullptr;
+  }
+
+ private:
+  const std::set<const mirror::Object*>& kept_;
+};
+
+TEST_F(InternTableTest, SweepInternTableWeaksInParallel) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable t;
+  // Enough weak interns for the shards to be swept by the heap thread pool.
+  static constexpr size_t kNumStrings = 8 * KB;
+  StackHandleScope<1> hs(soa.Self());
+  mirror::Class* array_class = class_linker_->FindSystemClass(soa.Self(), "[Ljava/lang/String;");
+  Handle<mirror::ObjectArray<mirror::String>> strings(hs.NewHandle(
+      mirror::ObjectArray<mirror::String>::Alloc(soa.Self(), array_class, kNumStrings)));
+  ASSERT_TRUE(strings.Get() != nullptr);
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    const std::string utf8 = StringPrintf("weak %zu", i);
+    mirror::String* s = mirror::String::AllocFromModifiedUtf8(soa.Self(), utf8.c_str());
+    strings->Set<false>(i, t.InternWeak(s));
+  }
+  EXPECT_EQ(kNumStrings, t.WeakSize());
+
+  std::set<const mirror::Object*> kept;
+  for (size_t i = 0; i < kNumStrings; i += 2) {
+    kept.insert(strings->Get(i));
+  }
+  KeepPredicate p(kept);
+  {
+    ReaderMutexLock mu(soa.Self(), *Locks::heap_bitmap_lock_);
+    t.SweepInternTableWeaks(&p);
+  }
+
+  EXPECT_EQ(kNumStrings / 2, t.WeakSize());
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    EXPECT_EQ(i % 2 == 0, t.ContainsWeak(strings->Get(i))) << i;
+  }
+}
+
 TEST_F(InternTableTest, ContainsWeak) {
   ScopedObjectAccess soa(Thread::Current());
   {
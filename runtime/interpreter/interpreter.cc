@@ -19,6 +19,7 @@
 #include <limits>
 
 #include "interpreter_common.h"
+#include "interpreter/mterp/mterp.h"
 #include "mirror/string-inl.h"
 #include "scoped_thread_state_change.h"
 #include "ScopedLocalRef.h"
@@ -34,7 +35,29 @@ static void InterpreterJni(Thread* self, ArtMethod* method, const StringPiece& s
   // TODO: The following enters JNI code using a typedef-ed function rather than the JNI compiler,
   //       it should be removed and JNI compiled stubs used instead.
   ScopedObjectAccessUnchecked soa(self);
-  if (method->IsStatic()) {
+  if (method->IsCriticalNative()) {
+    // Critical natives get neither JNIEnv* nor jclass, and are called while runnable.
+    if (shorty == "V") {
+      typedef void (fntype)();
+      fntype* const fn = reinterpret_cast<fntype*>(method->GetEntryPointFromJni());
+      fn();
+    } else if (shorty == "I") {
+      typedef jint (fntype)();
+      fntype* const fn = reinterpret_cast<fntype*>(method->GetEntryPointFromJni());
+      result->SetI(fn());
+    } else if (shorty == "II") {
+      typedef jint (fntype)(jint);
+      fntype* const fn = reinterpret_cast<fntype*>(method->GetEntryPointFromJni());
+      result->SetI(fn(args[0]));
+    } else if (shorty == "III") {
+      typedef jint (fntype)(jint, jint);
+      fntype* const fn = reinterpret_cast<fntype*>(method->GetEntryPointFromJni());
+      result->SetI(fn(args[0], args[1]));
+    } else {
+      LOG(FATAL) << "Do something with critical native method: " << PrettyMethod(method)
+          << " shorty: " << shorty;
+    }
+  } else if (method->IsStatic()) {
     if (shorty == "L") {
       typedef jobject (fntype)(JNIEnv*, jclass);
       fntype* const fn = reinterpret_cast<fntype*>(method->GetEntryPointFromJni());
@@ -224,18 +247,29 @@ static void InterpreterJni(Thread* self, ArtMethod* method, const StringPiece& s
 
 enum InterpreterImplKind {
   kSwitchImpl,            // Switch-based interpreter implementation.
-  kComputedGotoImplKind   // Computed-goto-based interpreter implementation.
+  kComputedGotoImplKind,  // Computed-goto-based interpreter implementation.
+  kMterpImplKind          // Assembly interpreter, with the switch-based one for the rest.
 };
 static std::ostream& operator<<(std::ostream& os, const InterpreterImplKind& rhs) {
-  os << ((rhs == kSwitchImpl) ? "Switch-based interpreter" : "Computed-goto-based interpreter");
+  switch (rhs) {
+    case kSwitchImpl:
+      os << "Switch-based interpreter";
+      break;
+    case kComputedGotoImplKind:
+      os << "Computed-goto-based interpreter";
+      break;
+    case kMterpImplKind:
+      os << "Asm interpreter";
+      break;
+  }
   return os;
 }
 
 #if !defined(__clang__)
-static constexpr InterpreterImplKind kInterpreterImplKind = kComputedGotoImplKind;
+static constexpr InterpreterImplKind kCppInterpreterImplKind = kComputedGotoImplKind;
 #else
 // Clang 3.4 fails to build the goto interpreter implementation.
-static constexpr InterpreterImplKind kInterpreterImplKind = kSwitchImpl;
+static constexpr InterpreterImplKind kCppInterpreterImplKind = kSwitchImpl;
 template<bool do_access_check, bool transaction_active>
 JValue ExecuteGotoImpl(Thread*, const DexFile::CodeItem*, ShadowFrame&, JValue) {
   LOG(FATAL) << "UNREACHABLE";
@@ -256,6 +290,11 @@ JValue ExecuteGotoImpl<false, true>(Thread* self, const DexFile::CodeItem* code_
                                     ShadowFrame& shadow_frame, JValue result_register);
 #endif
 
+// Mterp only exists for some instruction sets and is opt-in, the C++ implementation is the
+// default.
+static constexpr InterpreterImplKind kInterpreterImplKind =
+    kUseMterp ? kMterpImplKind : kCppInterpreterImplKind;
+
 static JValue Execute(Thread* self, const DexFile::CodeItem* code_item, ShadowFrame& shadow_frame,
                       JValue result_register)
     SHARED_REQUIRES(Locks::mutator_lock_);
@@ -266,14 +305,55 @@ static inline JValue Execute(Thread* self, const DexFile::CodeItem* code_item,
   DCHECK(!shadow_frame.GetMethod()->IsNative());
   shadow_frame.GetMethod()->GetDeclaringClass()->AssertInitializedOrInitializingInThread(self);
 
+  if (LIKELY(shadow_frame.GetDexPC() == 0)) {  // Entering the method, not deoptimizing.
+    if (kIsDebugBuild) {
+      self->AssertNoPendingException();
+    }
+    instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+    if (UNLIKELY(instrumentation->HasMethodEntryListeners())) {
+      instrumentation->MethodEnterEvent(self, shadow_frame.GetThisObject(code_item->ins_size_),
+                                        shadow_frame.GetMethod(), 0);
+    }
+  }
+
   bool transaction_active = Runtime::Current()->IsActiveTransaction();
   if (LIKELY(shadow_frame.GetMethod()->IsPreverified())) {
     // Enter the "without access check" interpreter.
-    if (kInterpreterImplKind == kSwitchImpl) {
+    if (kInterpreterImplKind == kMterpImplKind) {
+      if (transaction_active) {
+        // No Mterp variant - just use the switch interpreter.
+        return ExecuteSwitchImpl<false, true>(self, code_item, shadow_frame, result_register,
+                                              false);
+      } else if (UNLIKELY(!Runtime::Current()->IsStarted())) {
+        // The unstarted runtime intercepts invokes in the C++ interpreters only.
+        return ExecuteSwitchImpl<false, false>(self, code_item, shadow_frame, result_register,
+                                               false);
+      }
+      while (true) {
+        // Mterp does not notify all the instrumentation events.
+        if (MterpShouldSwitchInterpreters()) {
+          return ExecuteSwitchImpl<false, false>(self, code_item, shadow_frame, result_register,
+                                                 false);
+        }
+        bool returned = ExecuteMterpImpl(self, code_item, &shadow_frame, &result_register);
+        if (returned) {
+          return result_register;
+        }
+        // Mterp does not handle that instruction. Single-step it with the switch interpreter.
+        result_register = ExecuteSwitchImpl<false, false>(self, code_item, shadow_frame,
+                                                          result_register, true);
+        if (shadow_frame.GetDexPC() == DexFile::kDexNoIndex) {
+          // Single-stepped a return or an exception not handled locally. Return to caller.
+          return result_register;
+        }
+      }
+    } else if (kInterpreterImplKind == kSwitchImpl) {
       if (transaction_active) {
-        return ExecuteSwitchImpl<false, true>(self, code_item, shadow_frame, result_register);
+        return ExecuteSwitchImpl<false, true>(self, code_item, shadow_frame, result_register,
+                                              false);
       } else {
-        return ExecuteSwitchImpl<false, false>(self, code_item, shadow_frame, result_register);
+        return ExecuteSwitchImpl<false, false>(self, code_item, shadow_frame, result_register,
+                                               false);
       }
     } else {
       DCHECK_EQ(kInterpreterImplKind, kComputedGotoImplKind);
@@ -285,11 +365,22 @@ static inline JValue Execute(Thread* self, const DexFile::CodeItem* code_item,
     }
   } else {
     // Enter the "with access check" interpreter.
-    if (kInterpreterImplKind == kSwitchImpl) {
+    if (kInterpreterImplKind == kMterpImplKind) {
+      // Mterp only runs preverified methods, use the switch interpreter.
+      if (transaction_active) {
+        return ExecuteSwitchImpl<true, true>(self, code_item, shadow_frame, result_register,
+                                             false);
+      } else {
+        return ExecuteSwitchImpl<true, false>(self, code_item, shadow_frame, result_register,
+                                              false);
+      }
+    } else if (kInterpreterImplKind == kSwitchImpl) {
       if (transaction_active) {
-        return ExecuteSwitchImpl<true, true>(self, code_item, shadow_frame, result_register);
+        return ExecuteSwitchImpl<true, true>(self, code_item, shadow_frame, result_register,
+                                             false);
       } else {
-        return ExecuteSwitchImpl<true, false>(self, code_item, shadow_frame, result_register);
+        return ExecuteSwitchImpl<true, false>(self, code_item, shadow_frame, result_register,
+                                              false);
       }
     } else {
       DCHECK_EQ(kInterpreterImplKind, kComputedGotoImplKind);
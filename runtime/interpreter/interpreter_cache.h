@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+#define ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base/macros.h"
+
+namespace art {
+
+class Instruction;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+namespace interpreter {
+
+// A small direct-mapped cache of what the interpreter found the last time it executed
+// an iget/iput or an invoke-virtual/invoke-interface, indexed by the address of the
+// instruction. For fields and virtual methods, the value is the field offset or the
+// vtable index, which is what dex2dex would have quickened the instruction into. For
+// interface methods, it is the target ArtMethod for the receiver class of the entry,
+// a monomorphic inline cache.
+//
+// The dex code is shared between threads and may be mapped read only, so instead of
+// rewriting instructions into their -quick forms, each thread keeps its own cache and
+// needs no synchronization. Entries hold classes without reporting them to the GC, so
+// Thread::VisitRoots clears the cache whenever the GC looks at the roots of the thread.
+class InterpreterCache {
+ public:
+  static constexpr size_t kSize = 256;
+
+  InterpreterCache() {
+    Clear();
+  }
+
+  // Returns whether there is an entry for `inst` and `klass`, and its value if so.
+  // Fields and virtual methods use a null `klass`.
+  ALWAYS_INLINE bool Get(const Instruction* inst, mirror::Class* klass, size_t* value) const {
+    const Entry& entry = data_[IndexOf(inst)];
+    if (entry.inst == inst && entry.klass == klass) {
+      *value = entry.value;
+      return true;
+    }
+    return false;
+  }
+
+  ALWAYS_INLINE void Set(const Instruction* inst, mirror::Class* klass, size_t value) {
+    Entry& entry = data_[IndexOf(inst)];
+    entry.inst = inst;
+    entry.klass = klass;
+    entry.value = value;
+  }
+
+  void Clear() {
+    for (Entry& entry : data_) {
+      entry.inst = nullptr;
+      entry.klass = nullptr;
+      entry.value = 0;
+    }
+  }
+
+ private:
+  struct Entry {
+    const Instruction* inst;
+    mirror::Class* klass;
+    size_t value;
+  };
+
+  static size_t IndexOf(const Instruction* inst) {
+    // Instructions are aligned on code units.
+    return (reinterpret_cast<uintptr_t>(inst) >> 1) % kSize;
+  }
+
+  Entry data_[kSize];
+
+  DISALLOW_COPY_AND_ASSIGN(InterpreterCache);
+};
+
+}  // namespace interpreter
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
@@ -69,9 +69,13 @@ namespace interpreter {
 
 // External references to both interpreter implementations.
 
+// When `interpret_one_instruction` is true, ExecuteSwitchImpl executes a single instruction
+// for mterp and records the next dex pc in `shadow_frame`, or DexFile::kDexNoIndex if the method
+// returned or threw.
 template<bool do_access_check, bool transaction_active>
 extern JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
-                                ShadowFrame& shadow_frame, JValue result_register);
+                                ShadowFrame& shadow_frame, JValue result_register,
+                                bool interpret_one_instruction);
 
 template<bool do_access_check, bool transaction_active>
 extern JValue ExecuteGotoImpl(Thread* self, const DexFile::CodeItem* code_item,
@@ -599,6 +603,52 @@ static inline bool DoInvokeLambda(Thread* self, ShadowFrame& shadow_frame, const
                                               result);
 }
 
+// Returns the target of a verified invoke-virtual or invoke-interface from the interpreter
+// cache of `self`, or null if the cache has no entry for `inst` and the class of `receiver`.
+template<InvokeType type>
+static inline ArtMethod* FindMethodFromInterpreterCache(Thread* self, const Instruction* inst,
+                                                        Object* receiver)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  static_assert(type == kVirtual || type == kInterface, "Unexpected invoke type");
+  mirror::Class* klass = receiver->GetClass();
+  size_t value;
+  if (type == kVirtual) {
+    // Like invoke-virtual-quick, the vtable index does not depend on the receiver.
+    if (self->GetInterpreterCache()->Get(inst, nullptr, &value)) {
+      return klass->GetVTableEntry(value,
+                                   Runtime::Current()->GetClassLinker()->GetImagePointerSize());
+    }
+  } else {
+    // Monomorphic inline cache of the last receiver class.
+    if (self->GetInterpreterCache()->Get(inst, klass, &value)) {
+      return reinterpret_cast<ArtMethod*>(value);
+    }
+  }
+  return nullptr;
+}
+
+// Records what FindMethodFromInterpreterCache returns for `inst` from now on: the vtable
+// index of an invoke-virtual, or the target of an invoke-interface for the class of `receiver`.
+template<InvokeType type>
+static inline void UpdateInterpreterCache(Thread* self, const Instruction* inst, Object* receiver,
+                                          uint32_t method_idx, ArtMethod* referrer,
+                                          ArtMethod* called_method)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  static_assert(type == kVirtual || type == kInterface, "Unexpected invoke type");
+  if (type == kVirtual) {
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    ArtMethod* resolved_method = class_linker->GetResolvedMethod(method_idx, referrer);
+    DCHECK(resolved_method != nullptr);
+    DCHECK_EQ(receiver->GetClass()->GetVTableEntry(resolved_method->GetMethodIndex(),
+                                                   class_linker->GetImagePointerSize()),
+              called_method);
+    self->GetInterpreterCache()->Set(inst, nullptr, resolved_method->GetMethodIndex());
+  } else {
+    self->GetInterpreterCache()->Set(inst, receiver->GetClass(),
+                                     reinterpret_cast<size_t>(called_method));
+  }
+}
+
 // Handles invoke-XXX/range instructions (other than invoke-lambda[-range]).
 // Returns true on success, otherwise throws an exception and returns false.
 template<InvokeType type, bool is_range, bool do_access_check>
@@ -608,8 +658,20 @@ static inline bool DoInvoke(Thread* self, ShadowFrame& shadow_frame, const Instr
   const uint32_t vregC = (is_range) ? inst->VRegC_3rc() : inst->VRegC_35c();
   Object* receiver = (type == kStatic) ? nullptr : shadow_frame.GetVRegReference(vregC);
   ArtMethod* sf_method = shadow_frame.GetMethod();
-  ArtMethod* const called_method = FindMethodFromCode<type, do_access_check>(
-      method_idx, &receiver, sf_method, self);
+  ArtMethod* called_method = nullptr;
+  // Verified invoke-virtual and invoke-interface instructions that were executed before find
+  // their vtable index or their target for the receiver class in the interpreter cache.
+  constexpr bool use_cache = !do_access_check && (type == kVirtual || type == kInterface);
+  if (use_cache && LIKELY(receiver != nullptr)) {
+    called_method = FindMethodFromInterpreterCache<type>(self, inst, receiver);
+  }
+  if (called_method == nullptr) {
+    called_method = FindMethodFromCode<type, do_access_check>(method_idx, &receiver, sf_method,
+                                                              self);
+    if (use_cache && called_method != nullptr) {
+      UpdateInterpreterCache<type>(self, inst, receiver, method_idx, sf_method, called_method);
+    }
+  }
   // The shadow frame should already be pushed, so we don't need to update it.
   if (UNLIKELY(called_method == nullptr)) {
     CHECK(self->IsExceptionPending());
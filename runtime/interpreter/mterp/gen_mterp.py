@@ -0,0 +1,149 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2016 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates out/mterp_<arch>.S, the assembly interpreter for one architecture.
+
+The opcodes come from runtime/dex_instruction_list.h. The file config_<arch>
+gives the template of each opcode handled in assembly, with its parameters:
+
+  handler-size <bytes>     Size of the slot of each handler.
+  op <OPCODE> <template> [name=value ...]
+
+Templates are <arch>/<template>.S, where ${name} is replaced by the value of a
+parameter. A template may give default values with a line
+"%default name=value ...". The opcodes without an "op" line get the
+<arch>/fallback.S handler, which lets the C++ interpreter execute them.
+<arch>/header.S and <arch>/footer.S surround the handlers.
+
+Usage: gen_mterp.py <arch> [<arch> ...]
+"""
+
+import os
+import re
+import shlex
+import sys
+
+MTERP_DIR = os.path.dirname(os.path.abspath(__file__))
+INSTRUCTION_LIST = os.path.join(MTERP_DIR, "..", "..", "dex_instruction_list.h")
+
+PARAMETER_RE = re.compile(r"\$\{(\w+)\}")
+OPCODE_RE = re.compile(r"V\((0x[0-9A-Fa-f]+), (\w+),")
+
+
+def read_opcodes():
+  """Returns the list of the 256 opcode names, indexed by opcode."""
+  opcodes = [None] * 256
+  with open(INSTRUCTION_LIST) as f:
+    for match in OPCODE_RE.finditer(f.read()):
+      opcodes[int(match.group(1), 16)] = match.group(2)
+  if None in opcodes:
+    raise Exception("Missing opcode 0x%02x in %s" % (opcodes.index(None), INSTRUCTION_LIST))
+  return opcodes
+
+
+def parse_parameters(words, where):
+  parameters = {}
+  for word in words:
+    if "=" not in word:
+      raise Exception("%s: expected name=value, got '%s'" % (where, word))
+    name, value = word.split("=", 1)
+    parameters[name] = value
+  return parameters
+
+
+def read_config(arch):
+  handler_size = None
+  ops = {}
+  path = os.path.join(MTERP_DIR, "config_" + arch)
+  with open(path) as f:
+    for number, line in enumerate(f, 1):
+      where = "%s:%d" % (path, number)
+      words = shlex.split(line, comments=True)
+      if not words:
+        continue
+      if words[0] == "handler-size" and len(words) == 2:
+        handler_size = int(words[1])
+      elif words[0] == "op" and len(words) >= 3:
+        if words[1] in ops:
+          raise Exception("%s: duplicate opcode %s" % (where, words[1]))
+        ops[words[1]] = (words[2], parse_parameters(words[3:], where))
+      else:
+        raise Exception("%s: cannot parse '%s'" % (where, line.strip()))
+  if handler_size is None:
+    raise Exception("%s: missing handler-size" % path)
+  return handler_size, ops
+
+
+def expand_template(arch, template, parameters):
+  path = os.path.join(MTERP_DIR, arch, template + ".S")
+  values = {}
+  lines = []
+  with open(path) as f:
+    for line in f:
+      if line.startswith("%default "):
+        values.update(parse_parameters(shlex.split(line)[1:], path))
+      else:
+        lines.append(line)
+  values.update(parameters)
+
+  def replace(match):
+    if match.group(1) not in values:
+      raise Exception("%s: no value for ${%s}" % (path, match.group(1)))
+    return values[match.group(1)]
+  return PARAMETER_RE.sub(replace, "".join(lines))
+
+
+def generate(arch):
+  opcodes = read_opcodes()
+  handler_size, ops = read_config(arch)
+  unknown = set(ops) - set(opcodes)
+  if unknown:
+    raise Exception("config_%s: unknown opcodes %s" % (arch, ", ".join(sorted(unknown))))
+
+  out = []
+  out.append("/*\n"
+             " * This file was generated by gen_mterp.py from config_%s and the\n"
+             " * templates in %s/. Do not edit.\n"
+             " */\n\n" % (arch, arch))
+  out.append(expand_template(arch, "header", {"handler_size": str(handler_size)}))
+  for number, name in enumerate(opcodes):
+    template, parameters = ops.get(name, ("fallback", {}))
+    parameters = dict(parameters)
+    parameters["opcode"] = name
+    parameters["opnum"] = "0x%02x" % number
+    out.append("\n/* ------------------------------ */\n")
+    out.append("    .balign %d\n" % handler_size)
+    out.append(".L_op_%s: /* 0x%02x */\n" % (name.lower(), number))
+    out.append(expand_template(arch, template, parameters))
+  out.append("\n    .balign %d\n" % handler_size)
+  out.append(expand_template(arch, "footer", {}))
+
+  path = os.path.join(MTERP_DIR, "out", "mterp_%s.S" % arch)
+  with open(path, "w") as f:
+    f.write("".join(out))
+
+
+def main(args):
+  if not args:
+    sys.stderr.write(__doc__)
+    return 1
+  for arch in args:
+    generate(arch)
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter/mterp/mterp.h"
+
+#include "dex_instruction.h"
+#include "instrumentation.h"
+#include "jit/jit.h"
+#include "runtime.h"
+#include "stack.h"
+#include "thread-inl.h"
+
+namespace art {
+namespace interpreter {
+
+#if defined(__x86_64__) || defined(__aarch64__)
+
+// Bounds of the opcode handlers, defined in the generated assembly.
+extern "C" void artMterpInstructionStart();
+extern "C" void artMterpInstructionEnd();
+
+void CheckMterpAsmConstants() {
+  // Dispatch computes the address of a handler from the opcode. A handler
+  // larger than kMterpHandlerSize would shift all the following ones.
+  const uintptr_t interp_size = reinterpret_cast<uintptr_t>(artMterpInstructionEnd) -
+      reinterpret_cast<uintptr_t>(artMterpInstructionStart);
+  if (interp_size != kNumPackedOpcodes * kMterpHandlerSize) {
+    LOG(FATAL) << "Mterp interpreter size is " << interp_size << ", expected "
+               << kNumPackedOpcodes * kMterpHandlerSize << ". Check the handler sizes.";
+  }
+}
+
+#else
+
+void CheckMterpAsmConstants() {}
+
+#endif
+
+bool MterpShouldSwitchInterpreters() {
+  const instrumentation::Instrumentation* const instrumentation =
+      Runtime::Current()->GetInstrumentation();
+  return instrumentation->HasDexPcListeners() ||
+      instrumentation->HasMethodExitListeners() ||
+      instrumentation->HasMethodUnwindListeners() ||
+      instrumentation->HasFieldReadListeners() ||
+      instrumentation->HasFieldWriteListeners() ||
+      instrumentation->HasExceptionCaughtListeners();
+}
+
+// Called by mterp on a backward branch of `offset` code units, with the dex pc of the
+// branch in `shadow_frame`. Does what the C++ interpreters do on backward branches:
+// notify the instrumentation, try on-stack replacement and check for suspension.
+// Returns true if mterp must stop, with the dex pc of `shadow_frame` set to the
+// branch target for the C++ interpreter, or to DexFile::kDexNoIndex if on-stack
+// replacement completed the method with its result in `result`.
+extern "C" bool MterpBackwardBranch(Thread* self,
+                                    ShadowFrame* shadow_frame,
+                                    int32_t offset,
+                                    JValue* result)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtMethod* method = shadow_frame->GetMethod();
+  uint32_t dex_pc = shadow_frame->GetDexPC();
+  Runtime::Current()->GetInstrumentation()->BackwardBranch(self, method, offset);
+  if (jit::Jit::MaybeDoOnStackReplacement(self, method, dex_pc, offset, result)) {
+    shadow_frame->SetDexPC(DexFile::kDexNoIndex);
+    return true;
+  }
+  self->AllowThreadSuspension();
+  // The thread may have been suspended for installing instrumentation.
+  if (MterpShouldSwitchInterpreters()) {
+    shadow_frame->SetDexPC(dex_pc + offset);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace interpreter
+
+#if !defined(__x86_64__) && !defined(__aarch64__)
+
+extern "C" bool ExecuteMterpImpl(Thread* self ATTRIBUTE_UNUSED,
+                                 const DexFile::CodeItem* code_item ATTRIBUTE_UNUSED,
+                                 ShadowFrame* shadow_frame ATTRIBUTE_UNUSED,
+                                 JValue* result_register ATTRIBUTE_UNUSED) {
+  LOG(FATAL) << "Mterp is not supported on this instruction set";
+  UNREACHABLE();
+}
+
+#endif
+
+}  // namespace art
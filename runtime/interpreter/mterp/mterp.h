@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_MTERP_MTERP_H_
+#define ART_RUNTIME_INTERPRETER_MTERP_MTERP_H_
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "dex_file.h"
+#include "jvalue.h"
+
+namespace art {
+
+class ShadowFrame;
+class Thread;
+
+namespace interpreter {
+
+// Mterp, the assembly interpreter, is written for these instruction sets only.
+#if defined(__x86_64__) || defined(__aarch64__)
+static constexpr bool kMterpSupported = true;
+#else
+static constexpr bool kMterpSupported = false;
+#endif
+
+// Mterp handles about half of the opcodes in assembly and single-steps the others, invokes and
+// field accesses among them, with the C++ interpreter (see README.txt). It is only used when
+// built with ART_USE_MTERP.
+#ifdef ART_USE_MTERP
+static constexpr bool kUseMterp = kMterpSupported;
+#else
+static constexpr bool kUseMterp = false;
+#endif
+
+// Size in bytes of the handler of each opcode, which is where dispatch finds it.
+static constexpr size_t kMterpHandlerSize = 128;
+
+// Checks that each opcode handler of mterp fits in kMterpHandlerSize bytes.
+void CheckMterpAsmConstants();
+
+// Returns whether the current instrumentation needs the C++ interpreter. Mterp
+// notifies the method entry and backward branch listeners of the JIT, and leaves
+// invokes to the C++ interpreter, but it has no dex pc, field access, method exit
+// or exception events.
+bool MterpShouldSwitchInterpreters() SHARED_REQUIRES(Locks::mutator_lock_);
+
+}  // namespace interpreter
+
+// Interprets the method of `shadow_frame` from its dex pc. Returns true if the method
+// returned, with its result in `result_register`. Otherwise, the dex pc of
+// `shadow_frame` is the next instruction to execute with the C++ interpreter.
+extern "C" bool ExecuteMterpImpl(Thread* self,
+                                 const DexFile::CodeItem* code_item,
+                                 ShadowFrame* shadow_frame,
+                                 JValue* result_register)
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_MTERP_MTERP_H_
@@ -24,14 +24,23 @@
 #include "interpreter/interpreter.h"
 #include "jit_code_cache.h"
 #include "jit_instrumentation.h"
+#include "osr_entry.h"
 #include "runtime.h"
 #include "runtime_options.h"
+#include "stack.h"
 #include "thread_list.h"
 #include "utils.h"
 
 namespace art {
 namespace jit {
 
+#if defined(__x86_64__) || defined(__aarch64__)
+// Like art_quick_invoke_static_stub, but calls "code" instead of the entrypoint of "method".
+extern "C" void art_quick_osr_stub(ArtMethod* method, uint32_t* args, uint32_t args_size,
+                                   Thread* self, JValue* result, const char* shorty,
+                                   const void* code);
+#endif
+
 JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& options) {
   auto* jit_options = new JitOptions;
   jit_options->use_jit_ = options.GetOrDefault(RuntimeArgumentMap::UseJIT);
@@ -41,16 +50,19 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITCompileThreshold);
   jit_options->warmup_threshold_ =
       options.GetOrDefault(RuntimeArgumentMap::JITWarmupThreshold);
+  // The hotness counter of a method stops at the OSR threshold, which must not prevent it from
+  // reaching the compile threshold.
+  jit_options->osr_threshold_ = std::max<size_t>(
+      options.GetOrDefault(RuntimeArgumentMap::JITOsrThreshold),
+      jit_options->compile_threshold_);
   jit_options->dump_info_on_shutdown_ =
       options.Exists(RuntimeArgumentMap::DumpJITInfoOnShutdown);
+  jit_options->profile_file_ = options.GetOrDefault(RuntimeArgumentMap::JITProfileFile);
   return jit_options;
 }
 
 void Jit::DumpInfo(std::ostream& os) {
-  os << "Code cache size=" << PrettySize(code_cache_->CodeCacheSize())
-     << " data cache size=" << PrettySize(code_cache_->DataCacheSize())
-     << " num methods=" << code_cache_->NumMethods()
-     << "\n";
+  code_cache_->DumpInfo(os);
   cumulative_timings_.Dump(os);
 }
 
@@ -60,7 +72,8 @@ void Jit::AddTimingLogger(const TimingLogger& logger) {
 
 Jit::Jit()
     : jit_library_handle_(nullptr), jit_compiler_handle_(nullptr), jit_load_(nullptr),
-      jit_compile_method_(nullptr), dump_info_on_shutdown_(false),
+      jit_compile_method_(nullptr), jit_compile_osr_method_(nullptr),
+      dump_info_on_shutdown_(false),
       cumulative_timings_("JIT timings") {
 }
 
@@ -76,7 +89,8 @@ Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
   }
   LOG(INFO) << "JIT created with code_cache_capacity="
       << PrettySize(options->GetCodeCacheCapacity())
-      << " compile_threshold=" << options->GetCompileThreshold();
+      << " compile_threshold=" << options->GetCompileThreshold()
+      << " osr_threshold=" << options->GetOsrThreshold();
   return jit.release();
 }
 
@@ -110,6 +124,13 @@ bool Jit::LoadCompiler(std::string* error_msg) {
     *error_msg = "JIT couldn't find jit_compile_method entry point";
     return false;
   }
+  jit_compile_osr_method_ = reinterpret_cast<bool (*)(void*, ArtMethod*, OsrEntry*, Thread*)>(
+      dlsym(jit_library_handle_, "jit_compile_osr_method"));
+  if (jit_compile_osr_method_ == nullptr) {
+    dlclose(jit_library_handle_);
+    *error_msg = "JIT couldn't find jit_compile_osr_method entry point";
+    return false;
+  }
   CompilerCallbacks* callbacks = nullptr;
   VLOG(jit) << "Calling JitLoad interpreter_only="
       << Runtime::Current()->GetInstrumentation()->InterpretOnly();
@@ -138,6 +159,113 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self) {
   return jit_compile_method_(jit_compiler_handle_, method, self);
 }
 
+bool Jit::CompileOsrMethod(ArtMethod* method, uint32_t dex_pc, Thread* self) {
+  DCHECK(!method->IsRuntimeMethod());
+  if (Dbg::IsDebuggerActive()) {
+    return false;
+  }
+  if (code_cache_->HasOsrEntry(method)) {
+    // Already compiled for another loop header.
+    return false;
+  }
+  std::unique_ptr<OsrEntry> osr_entry(OsrEntry::Create(self, method, dex_pc));
+  if (osr_entry == nullptr) {
+    VLOG(jit) << "Cannot describe the frame of " << PrettyMethod(method)
+              << " at dex pc 0x" << std::hex << dex_pc;
+    return false;
+  }
+  if (!jit_compile_osr_method_(jit_compiler_handle_, method, osr_entry.get(), self)) {
+    return false;
+  }
+  // The code cache owns the entry now.
+  osr_entry.release();
+  return true;
+}
+
+bool Jit::MaybeDoOnStackReplacement(Thread* thread,
+                                    ArtMethod* method,
+                                    uint32_t dex_pc,
+                                    int32_t dex_pc_offset,
+                                    JValue* result) {
+  if (!kSupportsOsr) {
+    return false;
+  }
+  Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr || jit->GetInstrumentationCache() == nullptr) {
+    return false;
+  }
+  if (method->GetCounter() < jit->GetInstrumentationCache()->GetOsrMethodThreshold()) {
+    return false;
+  }
+  // The compiled code does not lock the method, and does not report method exits.
+  instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+  if (method->IsSynchronized() ||
+      Dbg::IsDebuggerActive() ||
+      instrumentation->InterpretOnly() ||
+      instrumentation->HasMethodExitListeners() ||
+      instrumentation->HasMethodUnwindListeners()) {
+    return false;
+  }
+  if (UNLIKELY(__builtin_frame_address(0) < thread->GetStackEnd())) {
+    // Let the interpreter throw the StackOverflowError.
+    return false;
+  }
+
+  const uint32_t loop_header_dex_pc = dex_pc + dex_pc_offset;
+  JitCodeCache* const code_cache = jit->GetCodeCache();
+  const OsrEntry* osr_entry = code_cache->LookupOsrEntry(method, loop_header_dex_pc);
+  if (osr_entry == nullptr) {
+    if (code_cache->NotifyOsrCompilationRequest(method, loop_header_dex_pc)) {
+      jit->GetInstrumentationCache()->AddOsrTask(thread, method, loop_header_dex_pc);
+    }
+    return false;
+  }
+
+#if defined(__x86_64__) || defined(__aarch64__)
+  // There must be no suspend point until we are in the compiled code: a code cache collection
+  // could otherwise miss that we are about to run it. See JitCodeCache::LookupOsrEntry.
+  VLOG(jit) << "Entering OSR code of " << PrettyMethod(method)
+            << " at dex pc 0x" << std::hex << loop_header_dex_pc;
+  const std::string shorty(osr_entry->GetShorty());
+  const void* const code = osr_entry->GetCode();
+  std::vector<uint32_t> args(osr_entry->GetArgumentsSize() / sizeof(uint32_t));
+  // The compiled code takes over the interpreter frame.
+  ShadowFrame* shadow_frame = thread->PopShadowFrame();
+  DCHECK_EQ(shadow_frame->GetMethod(), method);
+  osr_entry->FillArguments(*shadow_frame, args.data());
+
+  ManagedStack fragment;
+  thread->PushManagedStackFragment(&fragment);
+  (*art_quick_osr_stub)(method,
+                        args.data(),
+                        args.size() * sizeof(uint32_t),
+                        thread,
+                        result,
+                        shorty.c_str(),
+                        code);
+  if (UNLIKELY(thread->GetException() == Thread::GetDeoptimizationException())) {
+    // The compiled code asked to continue in the interpreter, see ArtMethod::Invoke.
+    thread->ClearException();
+    ShadowFrame* deoptimized_frame =
+        thread->PopStackedShadowFrame(StackedShadowFrameType::kDeoptimizationShadowFrame);
+    mirror::Throwable* pending_exception = nullptr;
+    thread->PopDeoptimizationContext(result, &pending_exception);
+    thread->SetTopOfStack(nullptr);
+    thread->SetTopOfShadowStack(deoptimized_frame);
+    if (pending_exception != nullptr) {
+      thread->SetException(pending_exception);
+    }
+    interpreter::EnterInterpreterFromDeoptimize(thread, deoptimized_frame, result);
+  }
+  thread->PopManagedStackFragment(fragment);
+  thread->PushShadowFrame(shadow_frame);
+  return true;
+#else
+  UNUSED(result);
+  return false;
+#endif
+}
+
 void Jit::CreateThreadPool() {
   CHECK(instrumentation_cache_.get() != nullptr);
   instrumentation_cache_->CreateThreadPool();
@@ -162,13 +290,16 @@ Jit::~Jit() {
   }
 }
 
-void Jit::CreateInstrumentationCache(size_t compile_threshold, size_t warmup_threshold) {
+void Jit::CreateInstrumentationCache(size_t compile_threshold,
+                                     size_t warmup_threshold,
+                                     size_t osr_threshold) {
   CHECK_GT(compile_threshold, 0U);
+  CHECK_GE(osr_threshold, compile_threshold);
   ScopedSuspendAll ssa(__FUNCTION__);
   // Add Jit interpreter instrumentation, tells the interpreter when to notify the jit to compile
   // something.
   instrumentation_cache_.reset(
-      new jit::JitInstrumentationCache(compile_threshold, warmup_threshold));
+      new jit::JitInstrumentationCache(compile_threshold, warmup_threshold, osr_threshold));
   Runtime::Current()->GetInstrumentation()->AddListener(
       new jit::JitInstrumentationListener(instrumentation_cache_.get()),
       instrumentation::Instrumentation::kMethodEntered |
@@ -17,8 +17,10 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <string>
 #include <unordered_map>
 
+#include "arch/instruction_set.h"
 #include "atomic.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -32,6 +34,7 @@ namespace art {
 
 class ArtMethod;
 class CompilerCallbacks;
+union JValue;
 struct RuntimeArgumentMap;
 
 namespace jit {
@@ -39,18 +42,27 @@ namespace jit {
 class JitCodeCache;
 class JitInstrumentationCache;
 class JitOptions;
+class OsrEntry;
 
 class Jit {
  public:
   static constexpr bool kStressMode = kIsDebugBuild;
   static constexpr size_t kDefaultCompileThreshold = kStressMode ? 2 : 1000;
   static constexpr size_t kDefaultWarmupThreshold = kDefaultCompileThreshold / 2;
+  static constexpr size_t kDefaultOsrThreshold = kDefaultCompileThreshold * 2;
+  // Whether we have a stub to enter on-stack replacement code on this instruction set.
+  static constexpr bool kSupportsOsr = (kRuntimeISA == kX86_64) || (kRuntimeISA == kArm64);
 
   virtual ~Jit();
   static Jit* Create(JitOptions* options, std::string* error_msg);
   bool CompileMethod(ArtMethod* method, Thread* self)
       SHARED_REQUIRES(Locks::mutator_lock_);
-  void CreateInstrumentationCache(size_t compile_threshold, size_t warmup_threshold);
+  // Compile the on-stack replacement version of "method" entered at the loop header "dex_pc".
+  bool CompileOsrMethod(ArtMethod* method, uint32_t dex_pc, Thread* self)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  void CreateInstrumentationCache(size_t compile_threshold,
+                                  size_t warmup_threshold,
+                                  size_t osr_threshold);
   void CreateThreadPool();
   CompilerCallbacks* GetCompilerCallbacks() {
     return compiler_callbacks_;
@@ -71,6 +83,18 @@ class Jit {
     return instrumentation_cache_.get();
   }
 
+  // Called by the interpreter on the backward branch at "dex_pc" to the loop header at
+  // "dex_pc + dex_pc_offset". If the method is hot and has on-stack replacement code for that
+  // loop, run the rest of the method in that code and return true, with its return value in
+  // "result". Otherwise request the compilation of that code once the method is hot enough,
+  // and return false for the interpreter to go on.
+  static bool MaybeDoOnStackReplacement(Thread* thread,
+                                        ArtMethod* method,
+                                        uint32_t dex_pc,
+                                        int32_t dex_pc_offset,
+                                        JValue* result)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
  private:
   Jit();
   bool LoadCompiler(std::string* error_msg);
@@ -81,6 +105,7 @@ class Jit {
   void* (*jit_load_)(CompilerCallbacks**);
   void (*jit_unload_)(void*);
   bool (*jit_compile_method_)(void*, ArtMethod*, Thread*);
+  bool (*jit_compile_osr_method_)(void*, ArtMethod*, OsrEntry*, Thread*);
 
   // Performance monitoring.
   bool dump_info_on_shutdown_;
@@ -102,12 +127,19 @@ class JitOptions {
   size_t GetWarmupThreshold() const {
     return warmup_threshold_;
   }
+  size_t GetOsrThreshold() const {
+    return osr_threshold_;
+  }
   size_t GetCodeCacheCapacity() const {
     return code_cache_capacity_;
   }
   bool DumpJitInfoOnShutdown() const {
     return dump_info_on_shutdown_;
   }
+  // File the profile of the application is saved to, or empty if it is not saved.
+  const std::string& GetProfileFile() const {
+    return profile_file_;
+  }
   bool UseJIT() const {
     return use_jit_;
   }
@@ -120,10 +152,12 @@ class JitOptions {
   size_t code_cache_capacity_;
   size_t compile_threshold_;
   size_t warmup_threshold_;
+  size_t osr_threshold_;
   bool dump_info_on_shutdown_;
+  std::string profile_file_;
 
   JitOptions() : use_jit_(false), code_cache_capacity_(0), compile_threshold_(0),
-      dump_info_on_shutdown_(false) { }
+      osr_threshold_(0), dump_info_on_shutdown_(false) { }
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -16,15 +16,34 @@
 
 #include "jit_code_cache.h"
 
+#include <limits>
 #include <sstream>
 
 #include "art_method-inl.h"
+#include "barrier.h"
+#include "base/stl_util.h"
+#include "base/time_utils.h"
+#include "entrypoints/runtime_asm_entrypoints.h"
+#include "gc/accounting/bitmap-inl.h"
+#include "gc/allocator/dlmalloc.h"
+#include "jit/osr_entry.h"
 #include "mem_map.h"
 #include "oat_file-inl.h"
+#include "oat_quick_method_header.h"
+#include "scoped_thread_state_change.h"
+#include "thread_list.h"
 
 namespace art {
 namespace jit {
 
+#define CHECKED_MPROTECT(memory, size, prot)                \
+  do {                                                      \
+    int rc = mprotect(memory, size, prot);                  \
+    if (UNLIKELY(rc != 0)) {                                \
+      PLOG(FATAL) << "Failed to mprotect jit code cache";   \
+    }                                                       \
+  } while (false)
+
 JitCodeCache* JitCodeCache::Create(size_t capacity, std::string* error_msg) {
   CHECK_GT(capacity, 0U);
   CHECK_LT(capacity, kMaxCapacity);
@@ -41,21 +60,111 @@ JitCodeCache* JitCodeCache::Create(size_t capacity, std::string* error_msg) {
   return new JitCodeCache(map);
 }
 
+static uint8_t* DataCacheDivider(MemMap* mem_map) {
+  // Data cache is 1 / 4 of the map. TODO: Make this variable?
+  return mem_map->Begin() + RoundUp(mem_map->Size() / 4, kPageSize);
+}
+
+static void* CreateMspace(uint8_t* begin, size_t capacity, const char* name) {
+  // The mspace owns the whole section from the start, MoreCore is only used to give back
+  // (and take again) pages at the end of the section when dlmalloc trims.
+  void* msp = create_mspace_with_base(begin, capacity, false /*locked*/);
+  CHECK(msp != nullptr) << "create_mspace_with_base failed for " << name;
+  // Do not allow morecore requests to succeed beyond the capacity of the section.
+  mspace_set_footprint_limit(msp, capacity);
+  return msp;
+}
+
 JitCodeCache::JitCodeCache(MemMap* mem_map)
-    : lock_("Jit code cache", kJitCodeCacheLock), num_methods_(0) {
+    : lock_("Jit code cache", kJitCodeCacheLock),
+      lock_cond_("Jit code cache variable", lock_),
+      collection_in_progress_(false),
+      mem_map_(mem_map),
+      code_mspace_(nullptr),
+      code_cache_begin_(DataCacheDivider(mem_map)),
+      code_cache_end_(mem_map->End()),
+      code_cache_limit_(mem_map->End()),
+      data_mspace_(nullptr),
+      data_cache_begin_(mem_map->Begin()),
+      data_cache_end_(DataCacheDivider(mem_map)),
+      data_cache_limit_(DataCacheDivider(mem_map)),
+      number_of_collections_(0),
+      number_of_evicted_methods_(0),
+      bytes_reclaimed_(0),
+      total_collection_time_ns_(0) {
   VLOG(jit) << "Created jit code cache size=" << PrettySize(mem_map->Size());
-  mem_map_.reset(mem_map);
-  uint8_t* divider = mem_map->Begin() + RoundUp(mem_map->Size() / 4, kPageSize);
-  // Data cache is 1 / 4 of the map. TODO: Make this variable?
-  // Put data at the start.
-  data_cache_ptr_ = mem_map->Begin();
-  data_cache_end_ = divider;
-  data_cache_begin_ = data_cache_ptr_;
-  mprotect(data_cache_ptr_, data_cache_end_ - data_cache_begin_, PROT_READ | PROT_WRITE);
-  // Code cache after.
-  code_cache_begin_ = divider;
-  code_cache_ptr_ = divider;
-  code_cache_end_ = mem_map->End();
+  // Put data at the start, code after.
+  CHECKED_MPROTECT(data_cache_begin_, data_cache_limit_ - data_cache_begin_,
+                   PROT_READ | PROT_WRITE);
+  data_mspace_ = CreateMspace(data_cache_begin_, data_cache_limit_ - data_cache_begin_,
+                              "jit data cache");
+  code_mspace_ = CreateMspace(code_cache_begin_, code_cache_limit_ - code_cache_begin_,
+                              "jit code cache");
+  live_bitmap_.reset(CodeCacheBitmap::Create("code-cache-bitmap",
+                                             reinterpret_cast<uintptr_t>(code_cache_begin_),
+                                             reinterpret_cast<uintptr_t>(code_cache_limit_)));
+  CHECK(live_bitmap_.get() != nullptr) << "could not create jit code cache bitmap";
+}
+
+JitCodeCache::~JitCodeCache() {
+  // The mspaces live in mem_map_, nothing to destroy besides the map itself.
+  STLDeleteValues(&osr_code_map_);
+}
+
+void* JitCodeCache::MoreCore(const void* mspace, intptr_t increment) {
+  // Called by dlmalloc with lock_ held, through one of the mspace calls below.
+  DCHECK(OwnsSpace(mspace));
+  const bool is_code = (mspace == code_mspace_);
+  uint8_t** end = is_code ? &code_cache_end_ : &data_cache_end_;
+  uint8_t* const begin = is_code ? code_cache_begin_ : data_cache_begin_;
+  const uint8_t* const limit = is_code ? code_cache_limit_ : data_cache_limit_;
+  uint8_t* const original_end = *end;
+  if (increment > 0) {
+    // Enforced by mspace_set_footprint_limit.
+    CHECK_LE(original_end + increment, limit);
+  } else if (increment < 0) {
+    CHECK_GE(original_end + increment, begin);
+    // Give the trimmed pages back to the kernel. They stay mapped so that a later
+    // morecore request can reuse them.
+    uint8_t* const new_end = original_end + increment;
+    uint8_t* const release_begin = AlignUp(new_end, kPageSize);
+    if (release_begin < original_end) {
+      madvise(release_begin, original_end - release_begin, MADV_DONTNEED);
+    }
+  }
+  *end = original_end + increment;
+  return original_end;
+}
+
+size_t JitCodeCache::AllocatedBytes(void* mspace) {
+  size_t bytes_allocated = 0;
+  mspace_inspect_all(mspace, DlmallocBytesAllocatedCallback, &bytes_allocated);
+  return bytes_allocated;
+}
+
+size_t JitCodeCache::CodeCacheSize() {
+  MutexLock mu(Thread::Current(), lock_);
+  return AllocatedBytes(code_mspace_);
+}
+
+size_t JitCodeCache::CodeCacheRemain() {
+  MutexLock mu(Thread::Current(), lock_);
+  return (code_cache_limit_ - code_cache_begin_) - AllocatedBytes(code_mspace_);
+}
+
+size_t JitCodeCache::DataCacheSize() {
+  MutexLock mu(Thread::Current(), lock_);
+  return AllocatedBytes(data_mspace_);
+}
+
+size_t JitCodeCache::DataCacheRemain() {
+  MutexLock mu(Thread::Current(), lock_);
+  return (data_cache_limit_ - data_cache_begin_) - AllocatedBytes(data_mspace_);
+}
+
+size_t JitCodeCache::NumMethods() {
+  MutexLock mu(Thread::Current(), lock_);
+  return method_code_map_.size();
 }
 
 bool JitCodeCache::ContainsMethod(ArtMethod* method) const {
@@ -63,7 +172,7 @@ bool JitCodeCache::ContainsMethod(ArtMethod* method) const {
 }
 
 bool JitCodeCache::ContainsCodePtr(const void* ptr) const {
-  return ptr >= code_cache_begin_ && ptr < code_cache_end_;
+  return ptr >= code_cache_begin_ && ptr < code_cache_limit_;
 }
 
 void JitCodeCache::FlushInstructionCache() {
@@ -72,35 +181,109 @@ void JitCodeCache::FlushInstructionCache() {
   // __clear_cache(reinterpret_cast<char*>(code_cache_begin_), static_cast<int>(CodeCacheSize()));
 }
 
-uint8_t* JitCodeCache::ReserveCode(Thread* self, size_t size) {
-  MutexLock mu(self, lock_);
-  if (size > CodeCacheRemain()) {
-    return nullptr;
+static uintptr_t FromCodeToAllocation(const void* code) {
+  return reinterpret_cast<uintptr_t>(code) -
+      RoundUp(sizeof(OatQuickMethodHeader), kJitCodeAlignment);
+}
+
+bool JitCodeCache::WaitForPotentialCollectionToComplete(Thread* self) {
+  bool in_collection = false;
+  while (collection_in_progress_) {
+    in_collection = true;
+    lock_cond_.Wait(self);
+  }
+  return in_collection;
+}
+
+uint8_t* JitCodeCache::CommitCode(Thread* self,
+                                  ArtMethod* method,
+                                  const uint8_t* mapping_table,
+                                  const uint8_t* vmap_table,
+                                  const uint8_t* gc_map,
+                                  size_t frame_size_in_bytes,
+                                  size_t core_spill_mask,
+                                  size_t fp_spill_mask,
+                                  const uint8_t* code,
+                                  size_t code_size,
+                                  OsrEntry* osr_entry) {
+  const size_t header_size = RoundUp(sizeof(OatQuickMethodHeader), kJitCodeAlignment);
+  const size_t total_size = header_size + code_size;
+  OatQuickMethodHeader* method_header = nullptr;
+  uint8_t* code_ptr = nullptr;
+  {
+    ScopedThreadSuspension sts(self, kSuspended);
+    MutexLock mu(self, lock_);
+    WaitForPotentialCollectionToComplete(self);
+    uint8_t* const memory = reinterpret_cast<uint8_t*>(
+        mspace_memalign(code_mspace_, kJitCodeAlignment, total_size));
+    if (memory == nullptr) {
+      return nullptr;
+    }
+    DCHECK_ALIGNED(memory, kJitCodeAlignment);
+    code_ptr = memory + header_size;
+    std::copy(code, code + code_size, code_ptr);
+    method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    new (method_header) OatQuickMethodHeader(
+        (mapping_table == nullptr) ? 0 : code_ptr - mapping_table,
+        (vmap_table == nullptr) ? 0 : code_ptr - vmap_table,
+        (gc_map == nullptr) ? 0 : code_ptr - gc_map,
+        frame_size_in_bytes,
+        core_spill_mask,
+        fp_spill_mask,
+        code_size);
+    __builtin___clear_cache(reinterpret_cast<char*>(code_ptr),
+                            reinterpret_cast<char*>(code_ptr + code_size));
+    method_code_map_.Put(code_ptr, method);
+    if (osr_entry != nullptr) {
+      // The single JIT thread checks for existing code before compiling, see
+      // Jit::CompileOsrMethod.
+      DCHECK(osr_code_map_.find(method) == osr_code_map_.end()) << PrettyMethod(method);
+      osr_entry->SetCode(method_header->GetEntryPoint());
+      osr_code_map_.Put(method, osr_entry);
+    } else {
+      // We have checked there was no collection in progress, so the entrypoint can be
+      // published while holding the lock.
+      method->SetEntryPointFromQuickCompiledCode(method_header->GetEntryPoint());
+    }
   }
-  ++num_methods_;  // TODO: This is hacky but works since each method has exactly one code region.
-  code_cache_ptr_ += size;
-  return code_cache_ptr_ - size;
+  return code_ptr;
 }
 
 uint8_t* JitCodeCache::ReserveData(Thread* self, size_t size) {
-  MutexLock mu(self, lock_);
   size = RoundUp(size, sizeof(void*));
-  if (size > DataCacheRemain()) {
-    return nullptr;
-  }
-  data_cache_ptr_ += size;
-  return data_cache_ptr_ - size;
+  MutexLock mu(self, lock_);
+  return reinterpret_cast<uint8_t*>(mspace_malloc(data_mspace_, size));
 }
 
 uint8_t* JitCodeCache::AddDataArray(Thread* self, const uint8_t* begin, const uint8_t* end) {
-  MutexLock mu(self, lock_);
-  const size_t size = RoundUp(end - begin, sizeof(void*));
-  if (size > DataCacheRemain()) {
+  uint8_t* result = ReserveData(self, end - begin);
+  if (result == nullptr) {
     return nullptr;  // Out of space in the data cache.
   }
-  std::copy(begin, end, data_cache_ptr_);
-  data_cache_ptr_ += size;
-  return data_cache_ptr_ - size;
+  std::copy(begin, end, result);
+  return result;
+}
+
+void JitCodeCache::FreeData(Thread* self, uint8_t* data) {
+  MutexLock mu(self, lock_);
+  mspace_free(data_mspace_, data);
+}
+
+void JitCodeCache::FreeCode(const void* code_ptr) {
+  const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+  const uint8_t* code = method_header->GetCode();
+  // The tables of the method were allocated by the compiler for this method only.
+  if (method_header->mapping_table_offset_ != 0) {
+    mspace_free(data_mspace_,
+                const_cast<uint8_t*>(code - method_header->mapping_table_offset_));
+  }
+  if (method_header->vmap_table_offset_ != 0) {
+    mspace_free(data_mspace_, const_cast<uint8_t*>(code - method_header->vmap_table_offset_));
+  }
+  if (method_header->gc_map_offset_ != 0) {
+    mspace_free(data_mspace_, const_cast<uint8_t*>(code - method_header->gc_map_offset_));
+  }
+  mspace_free(code_mspace_, reinterpret_cast<void*>(FromCodeToAllocation(code_ptr)));
 }
 
 const void* JitCodeCache::GetCodeFor(ArtMethod* method) {
@@ -109,8 +292,8 @@ const void* JitCodeCache::GetCodeFor(ArtMethod* method) {
     return code;
   }
   MutexLock mu(Thread::Current(), lock_);
-  auto it = method_code_map_.find(method);
-  if (it != method_code_map_.end()) {
+  auto it = saved_code_map_.find(method);
+  if (it != saved_code_map_.end()) {
     return it->second;
   }
   return nullptr;
@@ -121,11 +304,248 @@ void JitCodeCache::SaveCompiledCode(ArtMethod* method, const void* old_code_ptr)
   DCHECK(ContainsCodePtr(old_code_ptr)) << PrettyMethod(method) << " old_code_ptr="
       << old_code_ptr;
   MutexLock mu(Thread::Current(), lock_);
-  auto it = method_code_map_.find(method);
-  if (it != method_code_map_.end()) {
+  auto it = saved_code_map_.find(method);
+  if (it != saved_code_map_.end()) {
     return;
   }
-  method_code_map_.Put(method, old_code_ptr);
+  saved_code_map_.Put(method, old_code_ptr);
+}
+
+OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod* method) {
+  static_assert(kRuntimeISA != kThumb2, "kThumb2 cannot be a runtime ISA");
+  if (kRuntimeISA == kArm) {
+    // On Thumb-2, the pc is offset by one.
+    --pc;
+  }
+  if (!ContainsCodePtr(reinterpret_cast<const void*>(pc))) {
+    return nullptr;
+  }
+
+  MutexLock mu(Thread::Current(), lock_);
+  if (method_code_map_.empty()) {
+    return nullptr;
+  }
+  auto it = method_code_map_.lower_bound(reinterpret_cast<const void*>(pc));
+  if (it == method_code_map_.end() || it->first != reinterpret_cast<const void*>(pc)) {
+    // The pc is within the code of the method preceding the lower bound.
+    if (it == method_code_map_.begin()) {
+      return nullptr;
+    }
+    --it;
+  }
+
+  const void* code_ptr = it->first;
+  OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+  if (!method_header->Contains(pc)) {
+    return nullptr;
+  }
+  DCHECK_EQ(it->second, method)
+      << PrettyMethod(method) << " " << PrettyMethod(it->second) << " " << std::hex << pc;
+  return method_header;
+}
+
+const OsrEntry* JitCodeCache::LookupOsrEntry(ArtMethod* method, uint32_t dex_pc) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (collection_in_progress_) {
+    // The collection may already have walked our stack, and would not see the code we are
+    // about to enter.
+    return nullptr;
+  }
+  auto it = osr_code_map_.find(method);
+  if (it == osr_code_map_.end() || it->second->GetDexPc() != dex_pc) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+bool JitCodeCache::HasOsrEntry(ArtMethod* method) {
+  MutexLock mu(Thread::Current(), lock_);
+  return osr_code_map_.find(method) != osr_code_map_.end();
+}
+
+bool JitCodeCache::NotifyOsrCompilationRequest(ArtMethod* method, uint32_t dex_pc) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (osr_code_map_.find(method) != osr_code_map_.end()) {
+    return false;
+  }
+  return osr_requests_.insert(std::make_pair(method, dex_pc)).second;
+}
+
+class MarkCodeVisitor FINAL : public StackVisitor {
+ public:
+  MarkCodeVisitor(Thread* thread_in, JitCodeCache* code_cache_in)
+      : StackVisitor(thread_in, nullptr, StackVisitor::StackWalkKind::kSkipInlinedFrames),
+        code_cache_(code_cache_in),
+        bitmap_(code_cache_->GetLiveBitmap()) {}
+
+  bool VisitFrame() OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    const OatQuickMethodHeader* method_header = GetCurrentOatQuickMethodHeader();
+    if (method_header == nullptr) {
+      return true;
+    }
+    const void* code = method_header->GetCode();
+    if (code_cache_->ContainsCodePtr(code)) {
+      // Use the atomic set version, as multiple threads are executing this code.
+      bitmap_->AtomicTestAndSet(FromCodeToAllocation(code));
+    }
+    return true;
+  }
+
+ private:
+  JitCodeCache* const code_cache_;
+  CodeCacheBitmap* const bitmap_;
+};
+
+class MarkCodeClosure FINAL : public Closure {
+ public:
+  MarkCodeClosure(JitCodeCache* code_cache, Barrier* barrier)
+      : code_cache_(code_cache), barrier_(barrier) {}
+
+  void Run(Thread* thread) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    // Note: the current thread is not necessarily equal to thread since thread may be suspended.
+    DCHECK(thread == Thread::Current() || thread->IsSuspended());
+    MarkCodeVisitor visitor(thread, code_cache_);
+    visitor.WalkStack();
+    // If thread is a running mutator, then act on behalf of the code cache collector.
+    // See the code in ThreadList::RunCheckpoint.
+    if (thread->GetState() == kRunnable) {
+      barrier_->Pass(Thread::Current());
+    }
+  }
+
+ private:
+  JitCodeCache* const code_cache_;
+  Barrier* const barrier_;
+};
+
+void JitCodeCache::GarbageCollectCache(Thread* self) {
+  const uint64_t start_time = NanoTime();
+  size_t code_before = 0;
+  size_t data_before = 0;
+  // Wait for an existing collection, or let everyone know we are starting one.
+  {
+    ScopedThreadSuspension sts(self, kSuspended);
+    MutexLock mu(self, lock_);
+    if (WaitForPotentialCollectionToComplete(self)) {
+      // Another thread just made room, no need to collect again.
+      return;
+    }
+    collection_in_progress_ = true;
+    code_before = AllocatedBytes(code_mspace_);
+    data_before = AllocatedBytes(data_mspace_);
+  }
+
+  // Walk over all compiled methods and make their entrypoints go back to the interpreter, so
+  // that no new activation of the code can start while we look for the existing ones.
+  {
+    MutexLock mu(self, lock_);
+    live_bitmap_->Bitmap::Clear();
+    for (auto& it : method_code_map_) {
+      ArtMethod* method = it.second;
+      const void* entry_point =
+          OatQuickMethodHeader::FromCodePointer(it.first)->GetEntryPoint();
+      if (method->GetEntryPointFromQuickCompiledCode() == entry_point) {
+        method->SetEntryPointFromQuickCompiledCode(GetQuickToInterpreterBridge());
+      }
+    }
+    // Code saved for deoptimized methods is still needed to walk their stacks.
+    for (auto& it : saved_code_map_) {
+      const void* code_ptr = EntryPointToCodePointer(it.second);
+      live_bitmap_->Set(FromCodeToAllocation(code_ptr));
+    }
+  }
+
+  // Run a checkpoint on all threads to mark the JIT compiled code they are running.
+  {
+    Barrier barrier(0);
+    MarkCodeClosure closure(this, &barrier);
+    // Like the GC, run the checkpoint from a suspended state while holding the mutator lock
+    // to walk our own stack, then release it while waiting for the other threads.
+    ScopedThreadSuspension sts(self, kWaitingForCheckPointsToRun);
+    size_t threads_running_checkpoint = 0;
+    {
+      ReaderMutexLock mu(self, *Locks::mutator_lock_);
+      threads_running_checkpoint = Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+    }
+    if (threads_running_checkpoint != 0) {
+      barrier.Increment(self, threads_running_checkpoint);
+    }
+  }
+
+  // Free unused compiled code, and restore the entry point of used compiled code.
+  {
+    MutexLock mu(self, lock_);
+    size_t evicted = 0;
+    for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
+      const void* code_ptr = it->first;
+      ArtMethod* method = it->second;
+      const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+      auto osr_it = osr_code_map_.find(method);
+      const bool is_osr_code = (osr_it != osr_code_map_.end()) &&
+          (osr_it->second->GetCode() == method_header->GetEntryPoint());
+      if (live_bitmap_->Test(FromCodeToAllocation(code_ptr))) {
+        // Methods whose code is saved were deoptimized, and stay so.
+        if (!is_osr_code &&
+            saved_code_map_.find(method) == saved_code_map_.end() &&
+            method->GetEntryPointFromQuickCompiledCode() == GetQuickToInterpreterBridge()) {
+          method->SetEntryPointFromQuickCompiledCode(method_header->GetEntryPoint());
+        }
+        ++it;
+      } else {
+        if (is_osr_code) {
+          delete osr_it->second;
+          osr_code_map_.erase(osr_it);
+          osr_requests_.erase(osr_requests_.lower_bound(std::make_pair(method, 0u)),
+                              osr_requests_.upper_bound(
+                                  std::make_pair(method, std::numeric_limits<uint32_t>::max())));
+        } else if (method->GetEntryPointFromQuickCompiledCode() == GetQuickToInterpreterBridge()) {
+          // Let the interpreter count the method again before recompiling it.
+          method->ClearCounter();
+        }
+        DCHECK_NE(method->GetEntryPointFromQuickCompiledCode(), method_header->GetEntryPoint());
+        FreeCode(code_ptr);
+        it = method_code_map_.erase(it);
+        ++evicted;
+      }
+    }
+    // dlmalloc coalesced the freed chunks, give the pages that are now entirely unused
+    // back to the kernel.
+    size_t reclaimed = 0;
+    mspace_trim(code_mspace_, 0);
+    mspace_inspect_all(code_mspace_, DlmallocMadviseCallback, &reclaimed);
+    mspace_trim(data_mspace_, 0);
+    mspace_inspect_all(data_mspace_, DlmallocMadviseCallback, &reclaimed);
+
+    const size_t code_after = AllocatedBytes(code_mspace_);
+    const size_t data_after = AllocatedBytes(data_mspace_);
+    const uint64_t duration = NanoTime() - start_time;
+    ++number_of_collections_;
+    number_of_evicted_methods_ += evicted;
+    bytes_reclaimed_ += (code_before - code_after) + (data_before - data_after);
+    total_collection_time_ns_ += duration;
+    VLOG(jit) << "JIT code cache collection evicted " << evicted << " methods in "
+              << PrettyDuration(duration) << ", code cache "
+              << PrettySize(code_before) << " -> " << PrettySize(code_after)
+              << ", data cache " << PrettySize(data_before) << " -> " << PrettySize(data_after)
+              << ", released " << PrettySize(reclaimed);
+
+    collection_in_progress_ = false;
+    lock_cond_.Broadcast(self);
+  }
+}
+
+void JitCodeCache::DumpInfo(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  os << "Code cache size=" << PrettySize(AllocatedBytes(code_mspace_))
+     << " data cache size=" << PrettySize(AllocatedBytes(data_mspace_))
+     << " num methods=" << method_code_map_.size()
+     << " num osr methods=" << osr_code_map_.size()
+     << "\n"
+     << "Code cache collections=" << number_of_collections_
+     << " evicted methods=" << number_of_evicted_methods_
+     << " reclaimed=" << PrettySize(bytes_reclaimed_)
+     << " total collection time=" << PrettyDuration(total_collection_time_ns_)
+     << "\n";
 }
 
 }  // namespace jit
@@ -17,11 +17,14 @@
 #ifndef ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 #define ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 
+#include <set>
+
 #include "instrumentation.h"
 
 #include "atomic.h"
 #include "base/macros.h"
 #include "base/mutex.h"
+#include "gc/accounting/bitmap.h"
 #include "gc_root.h"
 #include "jni.h"
 #include "oat_file.h"
@@ -34,10 +37,17 @@ namespace art {
 class ArtMethod;
 class CompiledMethod;
 class CompilerCallbacks;
+class OatQuickMethodHeader;
 
 namespace jit {
 
 class JitInstrumentationCache;
+class OsrEntry;
+
+// Alignment of the allocations in the code cache. Large enough for the code alignment required
+// by any instruction set we compile for.
+static constexpr size_t kJitCodeAlignment = 16;
+using CodeCacheBitmap = gc::accounting::MemoryRangeBitmap<kJitCodeAlignment>;
 
 class JitCodeCache {
  public:
@@ -48,33 +58,22 @@ class JitCodeCache {
   // in the out arg error_msg.
   static JitCodeCache* Create(size_t capacity, std::string* error_msg);
 
-  const uint8_t* CodeCachePtr() const {
-    return code_cache_ptr_;
-  }
+  ~JitCodeCache();
 
-  size_t CodeCacheSize() const {
-    return code_cache_ptr_ - code_cache_begin_;
-  }
+  // Number of bytes allocated in the code cache.
+  size_t CodeCacheSize() REQUIRES(!lock_);
 
-  size_t CodeCacheRemain() const {
-    return code_cache_end_ - code_cache_ptr_;
-  }
+  // Number of bytes that can still be allocated in the code cache, ignoring fragmentation.
+  size_t CodeCacheRemain() REQUIRES(!lock_);
 
-  const uint8_t* DataCachePtr() const {
-    return data_cache_ptr_;
-  }
+  // Number of bytes allocated in the data cache.
+  size_t DataCacheSize() REQUIRES(!lock_);
 
-  size_t DataCacheSize() const {
-    return data_cache_ptr_ - data_cache_begin_;
-  }
+  // Number of bytes that can still be allocated in the data cache, ignoring fragmentation.
+  size_t DataCacheRemain() REQUIRES(!lock_);
 
-  size_t DataCacheRemain() const {
-    return data_cache_end_ - data_cache_ptr_;
-  }
-
-  size_t NumMethods() const {
-    return num_methods_;
-  }
+  // Number of compiled methods currently in the code cache.
+  size_t NumMethods() REQUIRES(!lock_);
 
   // Return true if the code cache contains the code pointer which si the entrypoint of the method.
   bool ContainsMethod(ArtMethod* method) const
@@ -83,8 +82,25 @@ class JitCodeCache {
   // Return true if the code cache contains a code ptr.
   bool ContainsCodePtr(const void* ptr) const;
 
-  // Reserve a region of code of size at least "size". Returns null if there is no more room.
-  uint8_t* ReserveCode(Thread* self, size_t size) REQUIRES(!lock_);
+  // Allocate a region for the method header and code of "method", copy the code into it and
+  // make it the entrypoint of the method. The tables passed in must have been allocated in the
+  // data cache. Returns the code pointer, or null if there is no more room.
+  // If "osr_entry" is not null, the code is the on-stack replacement version of the method
+  // described by it: the entrypoint of the method is left alone, and the code cache takes
+  // ownership of "osr_entry" on success.
+  uint8_t* CommitCode(Thread* self,
+                      ArtMethod* method,
+                      const uint8_t* mapping_table,
+                      const uint8_t* vmap_table,
+                      const uint8_t* gc_map,
+                      size_t frame_size_in_bytes,
+                      size_t core_spill_mask,
+                      size_t fp_spill_mask,
+                      const uint8_t* code,
+                      size_t code_size,
+                      OsrEntry* osr_entry = nullptr)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!lock_);
 
   // Reserve a region of data of size at least "size". Returns null if there is no more room.
   uint8_t* ReserveData(Thread* self, size_t size) REQUIRES(!lock_);
@@ -94,6 +110,9 @@ class JitCodeCache {
   uint8_t* AddDataArray(Thread* self, const uint8_t* begin, const uint8_t* end)
       REQUIRES(!lock_);
 
+  // Release a region returned by ReserveData or AddDataArray.
+  void FreeData(Thread* self, uint8_t* data) REQUIRES(!lock_);
+
   // Get code for a method, returns null if it is not in the jit cache.
   const void* GetCodeFor(ArtMethod* method)
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_);
@@ -103,31 +122,103 @@ class JitCodeCache {
   void SaveCompiledCode(ArtMethod* method, const void* old_code_ptr)
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_);
 
+  // Return the method header of the compiled code containing "pc", or null if "pc" is not
+  // in the code cache.
+  OatQuickMethodHeader* LookupMethodHeader(uintptr_t pc, ArtMethod* method)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Return the on-stack replacement entry of "method" for the loop header at "dex_pc", or null if
+  // there is none. The entry, and the code it describes, stay valid until the calling thread
+  // reaches a suspend point outside of that code.
+  const OsrEntry* LookupOsrEntry(ArtMethod* method, uint32_t dex_pc)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Whether "method" has on-stack replacement code, for any loop header.
+  bool HasOsrEntry(ArtMethod* method) REQUIRES(!lock_);
+
+  // Record that the on-stack replacement version of "method" for the loop header at "dex_pc" is
+  // being compiled. Returns false if it has already been requested, or if the method already has
+  // on-stack replacement code, in which case the caller should not compile it.
+  bool NotifyOsrCompilationRequest(ArtMethod* method, uint32_t dex_pc) REQUIRES(!lock_);
+
+  // Evict the compiled code of all methods that are not currently executing on any thread's
+  // stack, and release the freed pages to the kernel. Evicted methods go back to the
+  // interpreter and get recompiled once they are hot again.
+  void GarbageCollectCache(Thread* self)
+      SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Dump the code cache occupancy and collection statistics.
+  void DumpInfo(std::ostream& os) REQUIRES(!lock_);
+
+  CodeCacheBitmap* GetLiveBitmap() const {
+    return live_bitmap_.get();
+  }
+
+  // Called from the dlmalloc morecore hook to grow or shrink the footprint of one of our mspaces.
+  void* MoreCore(const void* mspace, intptr_t increment) NO_THREAD_SAFETY_ANALYSIS;
+
+  // Return true if "mspace" is one of the mspaces of the code cache.
+  bool OwnsSpace(const void* mspace) const {
+    return mspace == code_mspace_ || mspace == data_mspace_;
+  }
+
  private:
   // Takes ownership of code_mem_map.
   explicit JitCodeCache(MemMap* code_mem_map);
 
+  // Wait for a collection started by another thread to finish. Returns true if we had to wait.
+  bool WaitForPotentialCollectionToComplete(Thread* self) REQUIRES(lock_);
+
+  // Free the code region of "code_ptr" and the tables it references in the data cache.
+  void FreeCode(const void* code_ptr) REQUIRES(lock_);
+
+  // Number of bytes allocated in "mspace", including dlmalloc bookkeeping.
+  static size_t AllocatedBytes(void* mspace);
+
   // Unimplemented, TODO: Determine if it is necessary.
   void FlushInstructionCache();
 
   // Lock which guards.
   Mutex lock_;
+  // Condition to wait on during collection.
+  ConditionVariable lock_cond_ GUARDED_BY(lock_);
+  // Whether there is a code cache collection in progress.
+  bool collection_in_progress_ GUARDED_BY(lock_);
   // Mem map which holds code and data. We do this since we need to have 32 bit offsets from method
   // headers in code cache which point to things in the data cache. If the maps are more than 4GB
   // apart, having multiple maps wouldn't work.
   std::unique_ptr<MemMap> mem_map_;
-  // Code cache section.
-  uint8_t* code_cache_ptr_;
-  const uint8_t* code_cache_begin_;
-  const uint8_t* code_cache_end_;
-  // Data cache section.
-  uint8_t* data_cache_ptr_;
-  const uint8_t* data_cache_begin_;
-  const uint8_t* data_cache_end_;
-  size_t num_methods_;
+  // Code cache section, the mspace allocates in [code_cache_begin_, code_cache_end_).
+  void* code_mspace_;
+  uint8_t* const code_cache_begin_;
+  uint8_t* code_cache_end_;
+  const uint8_t* const code_cache_limit_;
+  // Data cache section, the mspace allocates in [data_cache_begin_, data_cache_end_).
+  void* data_mspace_;
+  uint8_t* const data_cache_begin_;
+  uint8_t* data_cache_end_;
+  const uint8_t* const data_cache_limit_;
+  // Bitmap for collecting code that is still executing, indexed by allocation start.
+  std::unique_ptr<CodeCacheBitmap> live_bitmap_;
+  // Holds the compiled code of every method in the code cache, keyed by code pointer so that
+  // we can find the method header containing a given pc.
+  SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(lock_);
   // This map holds code for methods if they were deoptimized by the instrumentation stubs. This is
   // required since we have to implement ClassLinker::GetQuickOatCodeFor for walking stacks.
-  SafeMap<ArtMethod*, const void*> method_code_map_ GUARDED_BY(lock_);
+  SafeMap<ArtMethod*, const void*> saved_code_map_ GUARDED_BY(lock_);
+  // On-stack replacement entries, one per method. Their code is also in method_code_map_.
+  SafeMap<ArtMethod*, OsrEntry*> osr_code_map_ GUARDED_BY(lock_);
+  // Loop headers for which an on-stack replacement version has been requested. Compiling for
+  // an inner loop header fails when it makes the outer loop irreducible, so every loop header of
+  // a method gets its chance. The requests of a method are dropped once its on-stack replacement
+  // code is evicted, so that it can be compiled again.
+  std::set<std::pair<ArtMethod*, uint32_t>> osr_requests_ GUARDED_BY(lock_);
+
+  // Collection statistics.
+  size_t number_of_collections_ GUARDED_BY(lock_);
+  size_t number_of_evicted_methods_ GUARDED_BY(lock_);
+  size_t bytes_reclaimed_ GUARDED_BY(lock_);
+  uint64_t total_collection_time_ns_ GUARDED_BY(lock_);
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCodeCache);
 };
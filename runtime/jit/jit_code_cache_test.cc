@@ -18,7 +18,9 @@
 
 #include "art_method-inl.h"
 #include "class_linker.h"
+#include "entrypoints/runtime_asm_entrypoints.h"
 #include "jit_code_cache.h"
+#include "oat_quick_method_header.h"
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
 
@@ -35,37 +37,51 @@ TEST_F(JitCodeCacheTest, TestCoverage) {
   std::unique_ptr<JitCodeCache> code_cache(
       JitCodeCache::Create(kSize, &error_msg));
   ASSERT_TRUE(code_cache.get() != nullptr) << error_msg;
-  ASSERT_TRUE(code_cache->CodeCachePtr() != nullptr);
-  ASSERT_EQ(code_cache->CodeCacheSize(), 0u);
+  // Only the bookkeeping of the allocators is in use.
+  const size_t initial_code_size = code_cache->CodeCacheSize();
+  const size_t initial_data_size = code_cache->DataCacheSize();
+  ASSERT_LT(initial_code_size, kPageSize);
   ASSERT_GT(code_cache->CodeCacheRemain(), 0u);
-  ASSERT_TRUE(code_cache->DataCachePtr() != nullptr);
-  ASSERT_EQ(code_cache->DataCacheSize(), 0u);
+  ASSERT_LT(initial_data_size, kPageSize);
   ASSERT_GT(code_cache->DataCacheRemain(), 0u);
-  ASSERT_EQ(code_cache->CodeCacheRemain() + code_cache->DataCacheRemain(), kSize);
+  ASSERT_EQ(code_cache->CodeCacheRemain() + code_cache->DataCacheRemain() +
+            initial_code_size + initial_data_size, kSize);
   ASSERT_EQ(code_cache->NumMethods(), 0u);
   ScopedObjectAccess soa(Thread::Current());
   StackHandleScope<1> hs(soa.Self());
-  uint8_t* const reserved_code = code_cache->ReserveCode(soa.Self(), 4 * KB);
-  ASSERT_TRUE(reserved_code != nullptr);
-  ASSERT_TRUE(code_cache->ContainsCodePtr(reserved_code));
-  ASSERT_EQ(code_cache->NumMethods(), 1u);
   Runtime* const runtime = Runtime::Current();
   ClassLinker* const class_linker = runtime->GetClassLinker();
   ArtMethod* method = &class_linker->AllocArtMethodArray(soa.Self(),
                                                          runtime->GetLinearAlloc(),
                                                          1)->At(0);
   ASSERT_FALSE(code_cache->ContainsMethod(method));
-  method->SetEntryPointFromQuickCompiledCode(reserved_code);
+  const uint8_t code_arr[4 * KB] = {};
+  uint8_t* const code_ptr = code_cache->CommitCode(soa.Self(), method, nullptr, nullptr, nullptr,
+                                                   0u, 0u, 0u, code_arr, sizeof(code_arr));
+  ASSERT_TRUE(code_ptr != nullptr);
+  ASSERT_TRUE(code_cache->ContainsCodePtr(code_ptr));
+  ASSERT_EQ(code_cache->NumMethods(), 1u);
+  ASSERT_GT(code_cache->CodeCacheSize(), initial_code_size + sizeof(code_arr));
   ASSERT_TRUE(code_cache->ContainsMethod(method));
-  ASSERT_EQ(code_cache->GetCodeFor(method), reserved_code);
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  ASSERT_EQ(code_cache->GetCodeFor(method), entry_point);
+  // Any pc within the code maps back to its method header.
+  const OatQuickMethodHeader* method_header =
+      code_cache->LookupMethodHeader(reinterpret_cast<uintptr_t>(entry_point) + 8, method);
+  ASSERT_TRUE(method_header != nullptr);
+  ASSERT_EQ(method_header->GetCode(), code_ptr);
+  ASSERT_EQ(method_header->code_size_, sizeof(code_arr));
   // Save the code and then change it.
-  code_cache->SaveCompiledCode(method, reserved_code);
+  code_cache->SaveCompiledCode(method, entry_point);
   method->SetEntryPointFromQuickCompiledCode(nullptr);
-  ASSERT_EQ(code_cache->GetCodeFor(method), reserved_code);
+  ASSERT_EQ(code_cache->GetCodeFor(method), entry_point);
   const uint8_t data_arr[] = {1, 2, 3, 4, 5};
   uint8_t* data_ptr = code_cache->AddDataArray(soa.Self(), data_arr, data_arr + sizeof(data_arr));
   ASSERT_TRUE(data_ptr != nullptr);
   ASSERT_EQ(memcmp(data_ptr, data_arr, sizeof(data_arr)), 0);
+  ASSERT_GT(code_cache->DataCacheSize(), initial_data_size);
+  code_cache->FreeData(soa.Self(), data_ptr);
+  ASSERT_EQ(code_cache->DataCacheSize(), initial_data_size);
 }
 
 TEST_F(JitCodeCacheTest, TestOverflow) {
@@ -74,19 +90,26 @@ TEST_F(JitCodeCacheTest, TestOverflow) {
   std::unique_ptr<JitCodeCache> code_cache(
       JitCodeCache::Create(kSize, &error_msg));
   ASSERT_TRUE(code_cache.get() != nullptr) << error_msg;
-  ASSERT_TRUE(code_cache->CodeCachePtr() != nullptr);
+  ScopedObjectAccess soa(Thread::Current());
+  Runtime* const runtime = Runtime::Current();
+  ArtMethod* method = &runtime->GetClassLinker()->AllocArtMethodArray(soa.Self(),
+                                                                      runtime->GetLinearAlloc(),
+                                                                      1)->At(0);
   size_t code_bytes = 0;
   size_t data_bytes = 0;
   constexpr size_t kCodeArrSize = 4 * KB;
   constexpr size_t kDataArrSize = 4 * KB;
+  uint8_t code_arr[kCodeArrSize];
+  std::fill_n(code_arr, arraysize(code_arr), 0);
   uint8_t data_arr[kDataArrSize];
   std::fill_n(data_arr, arraysize(data_arr), 53);
   // Add code and data until we are full.
   uint8_t* code_ptr = nullptr;
   uint8_t* data_ptr = nullptr;
   do {
-    code_ptr = code_cache->ReserveCode(Thread::Current(), kCodeArrSize);
-    data_ptr = code_cache->AddDataArray(Thread::Current(), data_arr, data_arr + kDataArrSize);
+    code_ptr = code_cache->CommitCode(soa.Self(), method, nullptr, nullptr, nullptr, 0u, 0u, 0u,
+                                      code_arr, kCodeArrSize);
+    data_ptr = code_cache->AddDataArray(soa.Self(), data_arr, data_arr + kDataArrSize);
     if (code_ptr != nullptr) {
       code_bytes += kCodeArrSize;
     }
@@ -100,6 +123,56 @@ TEST_F(JitCodeCacheTest, TestOverflow) {
   CHECK_GT(data_bytes, 0u);
   CHECK_LE(data_bytes, kSize);
   CHECK_GE(code_bytes + data_bytes, kSize * 4 / 5);
+  CHECK_EQ(code_cache->NumMethods(), code_bytes / kCodeArrSize);
+}
+
+TEST_F(JitCodeCacheTest, TestGarbageCollect) {
+  std::string error_msg;
+  constexpr size_t kSize = 1 * MB;
+  std::unique_ptr<JitCodeCache> code_cache(
+      JitCodeCache::Create(kSize, &error_msg));
+  ASSERT_TRUE(code_cache.get() != nullptr) << error_msg;
+  const size_t initial_code_size = code_cache->CodeCacheSize();
+  ScopedObjectAccess soa(Thread::Current());
+  Runtime* const runtime = Runtime::Current();
+  LengthPrefixedArray<ArtMethod>* methods =
+      runtime->GetClassLinker()->AllocArtMethodArray(soa.Self(), runtime->GetLinearAlloc(), 2);
+  ArtMethod* method = &methods->At(0);
+  ArtMethod* deoptimized_method = &methods->At(1);
+  constexpr size_t kCodeArrSize = 4 * KB;
+  uint8_t code_arr[kCodeArrSize];
+  std::fill_n(code_arr, arraysize(code_arr), 0);
+  // The code of a deoptimized method is still needed to walk its frames.
+  uint8_t* saved_code_ptr = code_cache->CommitCode(soa.Self(), deoptimized_method, nullptr,
+                                                   nullptr, nullptr, 0u, 0u, 0u, code_arr,
+                                                   kCodeArrSize);
+  ASSERT_TRUE(saved_code_ptr != nullptr);
+  const void* saved_entry_point = deoptimized_method->GetEntryPointFromQuickCompiledCode();
+  code_cache->SaveCompiledCode(deoptimized_method, saved_entry_point);
+  deoptimized_method->SetEntryPointFromQuickCompiledCode(GetQuickToInterpreterBridge());
+  // Fill the cache with code that no thread is running.
+  size_t code_count = 0;
+  while (code_cache->CommitCode(soa.Self(), method, nullptr, nullptr, nullptr, 0u, 0u, 0u,
+                                code_arr, kCodeArrSize) != nullptr) {
+    ++code_count;
+  }
+  ASSERT_GT(code_count, 0u);
+  ASSERT_EQ(code_cache->NumMethods(), code_count + 1);
+  ASSERT_TRUE(code_cache->ContainsMethod(method));
+
+  code_cache->GarbageCollectCache(soa.Self());
+  // Only the saved code is left, and the method is back to the interpreter.
+  EXPECT_EQ(code_cache->NumMethods(), 1u);
+  EXPECT_FALSE(code_cache->ContainsMethod(method));
+  EXPECT_EQ(method->GetEntryPointFromQuickCompiledCode(), GetQuickToInterpreterBridge());
+  EXPECT_EQ(code_cache->GetCodeFor(deoptimized_method), saved_entry_point);
+  EXPECT_EQ(deoptimized_method->GetEntryPointFromQuickCompiledCode(),
+            GetQuickToInterpreterBridge());
+  EXPECT_LT(code_cache->CodeCacheSize(), initial_code_size + 2 * kCodeArrSize);
+  // The freed room is available again.
+  EXPECT_TRUE(code_cache->CommitCode(soa.Self(), method, nullptr, nullptr, nullptr, 0u, 0u, 0u,
+                                     code_arr, kCodeArrSize) != nullptr);
+  EXPECT_TRUE(code_cache->ContainsMethod(method));
 }
 
 }  // namespace jit
@@ -26,7 +26,8 @@ namespace jit {
 
 class JitCompileTask FINAL : public Task {
  public:
-  explicit JitCompileTask(ArtMethod* method) : method_(method) {
+  explicit JitCompileTask(ArtMethod* method, uint32_t osr_dex_pc = DexFile::kDexNoIndex)
+      : method_(method), osr_dex_pc_(osr_dex_pc) {
     ScopedObjectAccess soa(Thread::Current());
     // Add a global ref to the class to prevent class unloading until compilation is done.
     klass_ = soa.Vm()->AddGlobalRef(soa.Self(), method_->GetDeclaringClass());
@@ -40,6 +41,14 @@ class JitCompileTask FINAL : public Task {
 
   void Run(Thread* self) OVERRIDE {
     ScopedObjectAccess soa(self);
+    if (osr_dex_pc_ != DexFile::kDexNoIndex) {
+      VLOG(jit) << "JitCompileTask compiling method " << PrettyMethod(method_)
+                << " for OSR at dex pc 0x" << std::hex << osr_dex_pc_;
+      if (!Runtime::Current()->GetJit()->CompileOsrMethod(method_, osr_dex_pc_, self)) {
+        VLOG(jit) << "Failed to compile method " << PrettyMethod(method_) << " for OSR";
+      }
+      return;
+    }
     VLOG(jit) << "JitCompileTask compiling method " << PrettyMethod(method_);
     if (!Runtime::Current()->GetJit()->CompileMethod(method_, self)) {
       VLOG(jit) << "Failed to compile method " << PrettyMethod(method_);
@@ -52,15 +61,18 @@ class JitCompileTask FINAL : public Task {
 
  private:
   ArtMethod* const method_;
+  const uint32_t osr_dex_pc_;
   jobject klass_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
 JitInstrumentationCache::JitInstrumentationCache(size_t hot_method_threshold,
-                                                 size_t warm_method_threshold)
+                                                 size_t warm_method_threshold,
+                                                 size_t osr_method_threshold)
     : hot_method_threshold_(hot_method_threshold),
-      warm_method_threshold_(warm_method_threshold) {
+      warm_method_threshold_(warm_method_threshold),
+      osr_method_threshold_(osr_method_threshold) {
 }
 
 void JitInstrumentationCache::CreateThreadPool() {
@@ -74,16 +86,18 @@ void JitInstrumentationCache::DeleteThreadPool() {
 
 void JitInstrumentationCache::AddSamples(Thread* self, ArtMethod* method, size_t) {
   ScopedObjectAccessUnchecked soa(self);
-  // Since we don't have on-stack replacement, some methods can remain in the interpreter longer
-  // than we want resulting in samples even after the method is compiled.
-  if (method->IsClassInitializer() || method->IsNative() ||
-      Runtime::Current()->GetJit()->GetCodeCache()->ContainsMethod(method)) {
+  if (method->IsClassInitializer() || method->IsNative()) {
     return;
   }
   if (thread_pool_.get() == nullptr) {
     DCHECK(Runtime::Current()->IsShuttingDown(self));
     return;
   }
+  // A method looping in the interpreter keeps sampling after it is compiled, until it reaches
+  // the OSR threshold. See Jit::MaybeDoOnStackReplacement.
+  if (method->GetCounter() >= osr_method_threshold_) {
+    return;
+  }
   uint16_t sample_count = method->IncrementCounter();
   if (sample_count == warm_method_threshold_) {
     ProfilingInfo* info = method->CreateProfilingInfo();
@@ -91,7 +105,8 @@ void JitInstrumentationCache::AddSamples(Thread* self, ArtMethod* method, size_t
       VLOG(jit) << "Start profiling " << PrettyMethod(method);
     }
   }
-  if (sample_count == hot_method_threshold_) {
+  if (sample_count == hot_method_threshold_ &&
+      !Runtime::Current()->GetJit()->GetCodeCache()->ContainsMethod(method)) {
     thread_pool_->AddTask(self, new JitCompileTask(
         method->GetInterfaceMethodIfProxy(sizeof(void*))));
     thread_pool_->StartWorkers(self);
@@ -118,6 +133,15 @@ void JitInstrumentationListener::InvokeVirtualOrInterface(Thread* thread,
   }
 }
 
+void JitInstrumentationCache::AddOsrTask(Thread* self, ArtMethod* method, uint32_t dex_pc) {
+  if (thread_pool_.get() == nullptr) {
+    DCHECK(Runtime::Current()->IsShuttingDown(self));
+    return;
+  }
+  thread_pool_->AddTask(self, new JitCompileTask(method, dex_pc));
+  thread_pool_->StartWorkers(self);
+}
+
 void JitInstrumentationCache::WaitForCompilationToFinish(Thread* self) {
   thread_pool_->Wait(self, false, false);
 }
@@ -45,9 +45,17 @@ namespace jit {
 // Keeps track of which methods are hot.
 class JitInstrumentationCache {
  public:
-  JitInstrumentationCache(size_t hot_method_threshold, size_t warm_method_threshold);
+  JitInstrumentationCache(size_t hot_method_threshold,
+                          size_t warm_method_threshold,
+                          size_t osr_method_threshold);
   void AddSamples(Thread* self, ArtMethod* method, size_t samples)
       SHARED_REQUIRES(Locks::mutator_lock_);
+  // Queue the compilation of `method` for on-stack replacement at the loop header `dex_pc`.
+  void AddOsrTask(Thread* self, ArtMethod* method, uint32_t dex_pc)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  size_t GetOsrMethodThreshold() const {
+    return osr_method_threshold_;
+  }
   void CreateThreadPool();
   void DeleteThreadPool();
   // Wait until there is no more pending compilation tasks.
@@ -56,6 +64,7 @@ class JitInstrumentationCache {
  private:
   size_t hot_method_threshold_;
   size_t warm_method_threshold_;
+  size_t osr_method_threshold_;
   std::unique_ptr<ThreadPool> thread_pool_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitInstrumentationCache);
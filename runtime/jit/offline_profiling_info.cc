@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "offline_profiling_info.h"
+
+#include <limits>
+#include <sstream>
+
+#include "base/logging.h"
+#include "base/scoped_flock.h"
+#include "base/stringprintf.h"
+#include "base/unix_file/fd_file.h"
+#include "dex_file.h"
+#include "os.h"
+#include "utils.h"
+
+namespace art {
+
+const uint8_t ProfileCompilationInfo::kProfileMagic[] = { 'p', 'r', 'o', '\0' };
+const uint8_t ProfileCompilationInfo::kProfileVersion[] = { '0', '0', '1', '\0' };
+
+std::string ProfileCompilationInfo::GetProfileDexFileKey(const std::string& dex_location) {
+  DCHECK(!dex_location.empty());
+  size_t last_sep_index = dex_location.find_last_of('/');
+  if (last_sep_index == std::string::npos) {
+    return dex_location;
+  }
+  DCHECK(last_sep_index < dex_location.size());
+  return dex_location.substr(last_sep_index + 1);
+}
+
+ProfileCompilationInfo::DexFileData* ProfileCompilationInfo::GetOrAddDexFileData(
+    const std::string& dex_location, uint32_t checksum) {
+  std::string key = GetProfileDexFileKey(dex_location);
+  auto it = info_.find(key);
+  if (it == info_.end()) {
+    it = info_.Put(key, DexFileData(checksum));
+  }
+  if (it->second.checksum != checksum) {
+    LOG(WARNING) << "Checksum mismatch for dex " << dex_location;
+    return nullptr;
+  }
+  return &it->second;
+}
+
+const ProfileCompilationInfo::DexFileData* ProfileCompilationInfo::FindDexFileData(
+    const DexFile& dex_file) const {
+  auto it = info_.find(GetProfileDexFileKey(dex_file.GetLocation()));
+  if (it == info_.end() || it->second.checksum != dex_file.GetLocationChecksum()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+bool ProfileCompilationInfo::AddMethod(const std::string& dex_location,
+                                       uint32_t checksum,
+                                       uint16_t method_idx) {
+  DexFileData* data = GetOrAddDexFileData(dex_location, checksum);
+  if (data == nullptr) {
+    return false;
+  }
+  data->method_set.insert(method_idx);
+  return true;
+}
+
+bool ProfileCompilationInfo::AddClass(const std::string& dex_location,
+                                      uint32_t checksum,
+                                      uint16_t type_idx) {
+  DexFileData* data = GetOrAddDexFileData(dex_location, checksum);
+  if (data == nullptr) {
+    return false;
+  }
+  data->class_set.insert(type_idx);
+  return true;
+}
+
+void ProfileCompilationInfo::MergeInlineCache(const std::set<uint16_t>& types,
+                                              bool is_new,
+                                              std::set<uint16_t>* cache) {
+  if (is_new) {
+    *cache = types;
+  } else if (cache->empty()) {
+    // Already megamorphic.
+    return;
+  } else if (types.empty()) {
+    cache->clear();
+  } else {
+    cache->insert(types.begin(), types.end());
+  }
+  if (cache->size() > kMaxNumberOfInlineCacheTypes) {
+    cache->clear();
+  }
+}
+
+bool ProfileCompilationInfo::AddInlineCache(const std::string& dex_location,
+                                            uint32_t checksum,
+                                            uint16_t method_idx,
+                                            uint32_t dex_pc,
+                                            const std::vector<uint16_t>& types) {
+  DexFileData* data = GetOrAddDexFileData(dex_location, checksum);
+  if (data == nullptr) {
+    return false;
+  }
+  auto key = std::make_pair(method_idx, dex_pc);
+  bool is_new = data->inline_caches.find(key) == data->inline_caches.end();
+  MergeInlineCache(std::set<uint16_t>(types.begin(), types.end()),
+                   is_new,
+                   &data->inline_caches[key]);
+  return true;
+}
+
+bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other) {
+  // Check the checksums first, so that a mismatch does not leave a half merged profile.
+  for (const auto& other_it : other.info_) {
+    auto info_it = info_.find(other_it.first);
+    if (info_it != info_.end() && info_it->second.checksum != other_it.second.checksum) {
+      LOG(WARNING) << "Checksum mismatch for dex " << other_it.first;
+      return false;
+    }
+  }
+  for (const auto& other_it : other.info_) {
+    const DexFileData& other_data = other_it.second;
+    auto info_it = info_.find(other_it.first);
+    if (info_it == info_.end()) {
+      info_it = info_.Put(other_it.first, DexFileData(other_data.checksum));
+    }
+    DexFileData* data = &info_it->second;
+    data->method_set.insert(other_data.method_set.begin(), other_data.method_set.end());
+    data->class_set.insert(other_data.class_set.begin(), other_data.class_set.end());
+    for (const auto& cache_it : other_data.inline_caches) {
+      bool is_new = data->inline_caches.find(cache_it.first) == data->inline_caches.end();
+      MergeInlineCache(cache_it.second, is_new, &data->inline_caches[cache_it.first]);
+    }
+  }
+  return true;
+}
+
+template <typename T>
+static void AddValue(std::vector<uint8_t>* buffer, T value) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+
+void ProfileCompilationInfo::Serialize(std::vector<uint8_t>* buffer) const {
+  buffer->insert(buffer->end(), kProfileMagic, kProfileMagic + sizeof(kProfileMagic));
+  buffer->insert(buffer->end(), kProfileVersion, kProfileVersion + sizeof(kProfileVersion));
+  DCHECK_LE(info_.size(), std::numeric_limits<uint16_t>::max());
+  AddValue<uint16_t>(buffer, info_.size());
+  for (const auto& it : info_) {
+    const std::string& dex_location = it.first;
+    const DexFileData& data = it.second;
+    DCHECK_LE(dex_location.size(), std::numeric_limits<uint16_t>::max());
+    AddValue<uint16_t>(buffer, dex_location.size());
+    AddValue<uint32_t>(buffer, data.checksum);
+    AddValue<uint32_t>(buffer, data.method_set.size());
+    AddValue<uint32_t>(buffer, data.class_set.size());
+    AddValue<uint32_t>(buffer, data.inline_caches.size());
+    buffer->insert(buffer->end(), dex_location.begin(), dex_location.end());
+    for (uint16_t method_idx : data.method_set) {
+      AddValue<uint16_t>(buffer, method_idx);
+    }
+    for (uint16_t type_idx : data.class_set) {
+      AddValue<uint16_t>(buffer, type_idx);
+    }
+    for (const auto& cache_it : data.inline_caches) {
+      AddValue<uint16_t>(buffer, cache_it.first.first);
+      AddValue<uint32_t>(buffer, cache_it.first.second);
+      DCHECK_LE(cache_it.second.size(), kMaxNumberOfInlineCacheTypes);
+      AddValue<uint8_t>(buffer, cache_it.second.size());
+      for (uint16_t type_idx : cache_it.second) {
+        AddValue<uint16_t>(buffer, type_idx);
+      }
+    }
+  }
+}
+
+// Reads values out of a serialized profile, failing on truncated data.
+class SafeProfileReader {
+ public:
+  SafeProfileReader(const uint8_t* data, size_t size) : current_(data), end_(data + size) {}
+
+  template <typename T>
+  bool Read(T* value) {
+    if (static_cast<size_t>(end_ - current_) < sizeof(T)) {
+      return false;
+    }
+    memcpy(value, current_, sizeof(T));
+    current_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadBytes(void* bytes, size_t count) {
+    if (static_cast<size_t>(end_ - current_) < count) {
+      return false;
+    }
+    memcpy(bytes, current_, count);
+    current_ += count;
+    return true;
+  }
+
+  bool Done() const {
+    return current_ == end_;
+  }
+
+ private:
+  const uint8_t* current_;
+  const uint8_t* const end_;
+};
+
+bool ProfileCompilationInfo::Deserialize(const uint8_t* data, size_t size) {
+  DCHECK(info_.empty());
+  SafeProfileReader reader(data, size);
+  uint8_t magic[sizeof(kProfileMagic)];
+  uint8_t version[sizeof(kProfileVersion)];
+  if (!reader.ReadBytes(magic, sizeof(magic)) ||
+      memcmp(magic, kProfileMagic, sizeof(magic)) != 0 ||
+      !reader.ReadBytes(version, sizeof(version)) ||
+      memcmp(version, kProfileVersion, sizeof(version)) != 0) {
+    return false;
+  }
+  uint16_t number_of_dex_files;
+  if (!reader.Read(&number_of_dex_files)) {
+    return false;
+  }
+  for (uint16_t i = 0; i < number_of_dex_files; ++i) {
+    uint16_t location_size;
+    uint32_t checksum;
+    uint32_t number_of_methods;
+    uint32_t number_of_classes;
+    uint32_t number_of_inline_caches;
+    if (!reader.Read(&location_size) ||
+        !reader.Read(&checksum) ||
+        !reader.Read(&number_of_methods) ||
+        !reader.Read(&number_of_classes) ||
+        !reader.Read(&number_of_inline_caches)) {
+      return false;
+    }
+    std::string dex_location(location_size, '\0');
+    if (location_size == 0 || !reader.ReadBytes(&dex_location[0], location_size)) {
+      return false;
+    }
+    DexFileData* dex_data = GetOrAddDexFileData(dex_location, checksum);
+    if (dex_data == nullptr) {
+      // The same dex file twice, with different checksums.
+      return false;
+    }
+    for (uint32_t j = 0; j < number_of_methods; ++j) {
+      uint16_t method_idx;
+      if (!reader.Read(&method_idx)) {
+        return false;
+      }
+      dex_data->method_set.insert(method_idx);
+    }
+    for (uint32_t j = 0; j < number_of_classes; ++j) {
+      uint16_t type_idx;
+      if (!reader.Read(&type_idx)) {
+        return false;
+      }
+      dex_data->class_set.insert(type_idx);
+    }
+    for (uint32_t j = 0; j < number_of_inline_caches; ++j) {
+      uint16_t method_idx;
+      uint32_t dex_pc;
+      uint8_t number_of_types;
+      if (!reader.Read(&method_idx) ||
+          !reader.Read(&dex_pc) ||
+          !reader.Read(&number_of_types) ||
+          number_of_types > kMaxNumberOfInlineCacheTypes) {
+        return false;
+      }
+      std::set<uint16_t>& types = dex_data->inline_caches[std::make_pair(method_idx, dex_pc)];
+      for (uint8_t k = 0; k < number_of_types; ++k) {
+        uint16_t type_idx;
+        if (!reader.Read(&type_idx)) {
+          return false;
+        }
+        types.insert(type_idx);
+      }
+    }
+  }
+  return reader.Done();
+}
+
+static bool ReadWholeFile(File* file, std::vector<uint8_t>* buffer) {
+  int64_t length = file->GetLength();
+  if (length < 0) {
+    return false;
+  }
+  buffer->resize(length);
+  return length == 0 || file->PreadFully(buffer->data(), length, 0);
+}
+
+bool ProfileCompilationInfo::Load(const std::string& filename) {
+  std::unique_ptr<File> file(OS::OpenFileForReading(filename.c_str()));
+  if (file.get() == nullptr) {
+    PLOG(WARNING) << "Couldn't open profile file " << filename;
+    return false;
+  }
+  std::vector<uint8_t> buffer;
+  if (!ReadWholeFile(file.get(), &buffer)) {
+    PLOG(WARNING) << "Couldn't read profile file " << filename;
+    return false;
+  }
+  if (!Deserialize(buffer.data(), buffer.size())) {
+    info_.clear();
+    return false;
+  }
+  return true;
+}
+
+bool ProfileCompilationInfo::MergeAndSave(const std::string& filename) const {
+  ScopedFlock flock;
+  std::string error;
+  if (!flock.Init(filename.c_str(), &error)) {
+    LOG(WARNING) << "Couldn't lock the profile file " << filename << ": " << error;
+    return false;
+  }
+  File* file = flock.GetFile();
+
+  ProfileCompilationInfo merged;
+  std::vector<uint8_t> buffer;
+  if (!ReadWholeFile(file, &buffer)) {
+    PLOG(WARNING) << "Couldn't read profile file " << filename;
+    return false;
+  }
+  if (!buffer.empty() && !merged.Deserialize(buffer.data(), buffer.size())) {
+    LOG(WARNING) << "Overwriting invalid profile file " << filename;
+    merged.info_.clear();
+  }
+  if (!merged.MergeWith(*this)) {
+    // The application was updated since the profile was written. Start over.
+    merged.info_.clear();
+    CHECK(merged.MergeWith(*this));
+  }
+
+  buffer.clear();
+  merged.Serialize(&buffer);
+  if (file->SetLength(0) != 0 ||
+      file->Write(reinterpret_cast<const char*>(buffer.data()), buffer.size(), 0) !=
+          static_cast<int64_t>(buffer.size()) ||
+      file->Flush() != 0) {
+    PLOG(WARNING) << "Couldn't write profile file " << filename;
+    return false;
+  }
+  VLOG(profiler) << "Saved profile to " << filename << ": " << merged.GetNumberOfMethods()
+                 << " methods, " << merged.GetNumberOfResolvedClasses() << " classes, "
+                 << buffer.size() << " bytes";
+  return true;
+}
+
+bool ProfileCompilationInfo::ContainsMethod(const MethodReference& method_ref) const {
+  const DexFileData* data = FindDexFileData(*method_ref.dex_file);
+  return data != nullptr &&
+      data->method_set.find(method_ref.dex_method_index) != data->method_set.end();
+}
+
+bool ProfileCompilationInfo::ContainsClass(const DexFile& dex_file, uint16_t type_idx) const {
+  const DexFileData* data = FindDexFileData(dex_file);
+  return data != nullptr && data->class_set.find(type_idx) != data->class_set.end();
+}
+
+const std::set<uint16_t>* ProfileCompilationInfo::GetInlineCacheTypes(
+    const MethodReference& method_ref, uint32_t dex_pc) const {
+  const DexFileData* data = FindDexFileData(*method_ref.dex_file);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  auto it = data->inline_caches.find(
+      std::make_pair(static_cast<uint16_t>(method_ref.dex_method_index), dex_pc));
+  return (it == data->inline_caches.end()) ? nullptr : &it->second;
+}
+
+size_t ProfileCompilationInfo::GetNumberOfMethods() const {
+  size_t total = 0;
+  for (const auto& it : info_) {
+    total += it.second.method_set.size();
+  }
+  return total;
+}
+
+size_t ProfileCompilationInfo::GetNumberOfResolvedClasses() const {
+  size_t total = 0;
+  for (const auto& it : info_) {
+    total += it.second.class_set.size();
+  }
+  return total;
+}
+
+bool ProfileCompilationInfo::Equals(const ProfileCompilationInfo& other) const {
+  return info_.Equals(other.info_);
+}
+
+std::string ProfileCompilationInfo::DumpInfo(const std::vector<const DexFile*>* dex_files) const {
+  std::ostringstream os;
+  if (info_.empty()) {
+    return "ProfileInfo: empty";
+  }
+  os << "ProfileInfo:";
+  for (const auto& it : info_) {
+    const std::string& location = it.first;
+    const DexFileData& data = it.second;
+    os << "\n" << location << " [checksum=" << std::hex << data.checksum << std::dec << "]";
+    const DexFile* dex_file = nullptr;
+    if (dex_files != nullptr) {
+      for (const DexFile* candidate : *dex_files) {
+        if (GetProfileDexFileKey(candidate->GetLocation()) == location &&
+            candidate->GetLocationChecksum() == data.checksum) {
+          dex_file = candidate;
+        }
+      }
+    }
+    os << "\n\tmethods: ";
+    for (uint16_t method_idx : data.method_set) {
+      if (dex_file != nullptr) {
+        os << "\n\t\t" << PrettyMethod(method_idx, *dex_file, true);
+      } else {
+        os << method_idx << ",";
+      }
+    }
+    os << "\n\tclasses: ";
+    for (uint16_t type_idx : data.class_set) {
+      os << type_idx << ",";
+    }
+    os << "\n\tinline caches: ";
+    for (const auto& cache_it : data.inline_caches) {
+      os << "\n\t\t" << cache_it.first.first << "@" << cache_it.first.second << ": ";
+      if (cache_it.second.empty()) {
+        os << "megamorphic";
+      }
+      for (uint16_t type_idx : cache_it.second) {
+        os << type_idx << ",";
+      }
+    }
+  }
+  return os.str();
+}
+
+}  // namespace art
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_OFFLINE_PROFILING_INFO_H_
+#define ART_RUNTIME_JIT_OFFLINE_PROFILING_INFO_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "method_reference.h"
+#include "safe_map.h"
+
+namespace art {
+
+class DexFile;
+
+/**
+ * Profile information collected by the JIT and saved to disk, so that it survives the
+ * process and can guide the ahead-of-time compilation of the application.
+ *
+ * For each dex file, identified by the base name of its location and its checksum, the
+ * profile records:
+ *   - the methods that got hot,
+ *   - the classes that got resolved,
+ *   - the receiver types of the profiled virtual and interface calls, as type indices in
+ *     the dex file of the calling method. A call site whose receiver types could not all
+ *     be recorded has an empty list of types, and is megamorphic.
+ *
+ * The file format is compact binary, with all values in the byte order of the host:
+ *
+ *   magic "pro\0", version "001\0"
+ *   uint16 number of dex files
+ *   for each dex file:
+ *     uint16 length of the dex location key
+ *     uint32 dex file checksum
+ *     uint32 number of methods, uint32 number of classes, uint32 number of inline caches
+ *     the dex location key, not null terminated
+ *     uint16 method index, for each method
+ *     uint16 type index, for each class
+ *     for each inline cache:
+ *       uint16 method index, uint32 dex pc, uint8 number of types, uint16 type index for each
+ */
+class ProfileCompilationInfo {
+ public:
+  static const uint8_t kProfileMagic[];
+  static const uint8_t kProfileVersion[];
+
+  // Maximum number of receiver types of a call site. Call sites with more types are megamorphic.
+  static constexpr size_t kMaxNumberOfInlineCacheTypes = 4;
+
+  // Add the hot method `method_idx` of the dex file at `dex_location`.
+  // Returns false if the profile has a different checksum for that dex file.
+  bool AddMethod(const std::string& dex_location, uint32_t checksum, uint16_t method_idx);
+
+  // Add the resolved class `type_idx` of the dex file at `dex_location`.
+  bool AddClass(const std::string& dex_location, uint32_t checksum, uint16_t type_idx);
+
+  // Add the receiver types seen at `dex_pc` in `method_idx`. An empty `types` marks the call
+  // site as megamorphic.
+  bool AddInlineCache(const std::string& dex_location,
+                      uint32_t checksum,
+                      uint16_t method_idx,
+                      uint32_t dex_pc,
+                      const std::vector<uint16_t>& types);
+
+  // Merge the data of `other` into this profile. Returns false, leaving this profile
+  // unchanged, if they do not agree on the checksum of a dex file.
+  bool MergeWith(const ProfileCompilationInfo& other);
+
+  // Load the profile from `filename`. Returns false if the file does not exist or is not
+  // a profile in this format.
+  bool Load(const std::string& filename);
+
+  // Merge this profile with the one already in `filename`, if any, and write the result
+  // back. The file is locked while doing so, as several processes may share it.
+  bool MergeAndSave(const std::string& filename) const;
+
+  // Serialize the profile, or parse a serialized profile into this empty profile.
+  void Serialize(std::vector<uint8_t>* buffer) const;
+  bool Deserialize(const uint8_t* data, size_t size);
+
+  bool ContainsMethod(const MethodReference& method_ref) const;
+  bool ContainsClass(const DexFile& dex_file, uint16_t type_idx) const;
+
+  // Returns the receiver types recorded at `dex_pc` in the method `method_ref`, or null if
+  // there are none. An empty result means that the call site is megamorphic.
+  const std::set<uint16_t>* GetInlineCacheTypes(const MethodReference& method_ref,
+                                                uint32_t dex_pc) const;
+
+  size_t GetNumberOfMethods() const;
+  size_t GetNumberOfResolvedClasses() const;
+
+  bool Equals(const ProfileCompilationInfo& other) const;
+
+  // Return a human readable representation of the profile. If `dex_files` is not null,
+  // methods are printed with their names when they belong to one of these dex files.
+  std::string DumpInfo(const std::vector<const DexFile*>* dex_files = nullptr) const;
+
+  // The key identifying the dex file at `dex_location` in a profile: its base name, which
+  // also tells apart the dex files of a multidex apk.
+  static std::string GetProfileDexFileKey(const std::string& dex_location);
+
+ private:
+  struct DexFileData {
+    explicit DexFileData(uint32_t location_checksum) : checksum(location_checksum) {}
+
+    bool operator==(const DexFileData& other) const {
+      return checksum == other.checksum &&
+          method_set == other.method_set &&
+          class_set == other.class_set &&
+          inline_caches == other.inline_caches;
+    }
+
+    uint32_t checksum;
+    std::set<uint16_t> method_set;
+    std::set<uint16_t> class_set;
+    // Receiver types, keyed by method index and dex pc of the call site.
+    std::map<std::pair<uint16_t, uint32_t>, std::set<uint16_t>> inline_caches;
+  };
+
+  // Return the data of the dex file at `dex_location`, creating it if needed, or null if the
+  // profile has a different checksum for it.
+  DexFileData* GetOrAddDexFileData(const std::string& dex_location, uint32_t checksum);
+
+  // Return the data of `dex_file`, or null if it is not in the profile.
+  const DexFileData* FindDexFileData(const DexFile& dex_file) const;
+
+  // Add `types` to the receiver types of `cache`, making it megamorphic when needed.
+  static void MergeInlineCache(const std::set<uint16_t>& types, bool is_new,
+                               std::set<uint16_t>* cache);
+
+  SafeMap<std::string, DexFileData> info_;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_OFFLINE_PROFILING_INFO_H_
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common_runtime_test.h"
+
+#include "dex_file.h"
+#include "offline_profiling_info.h"
+
+namespace art {
+
+class ProfileCompilationInfoTest : public CommonRuntimeTest {
+ protected:
+  static void AddMethods(ProfileCompilationInfo* info,
+                         const std::string& dex_location,
+                         uint32_t checksum,
+                         uint16_t start,
+                         uint16_t end) {
+    for (uint16_t i = start; i < end; ++i) {
+      ASSERT_TRUE(info->AddMethod(dex_location, checksum, i));
+    }
+  }
+};
+
+TEST_F(ProfileCompilationInfoTest, SaveAndLoad) {
+  ScratchFile profile;
+  ProfileCompilationInfo saved_info;
+  AddMethods(&saved_info, "/data/app/base.apk", 1, 0, 10);
+  AddMethods(&saved_info, "/data/app/base.apk!classes2.dex", 2, 5, 20);
+  ASSERT_TRUE(saved_info.AddClass("/data/app/base.apk", 1, 3));
+  ASSERT_TRUE(saved_info.AddInlineCache("/data/app/base.apk", 1, 4, 12, { 7, 8 }));
+  ASSERT_TRUE(saved_info.MergeAndSave(profile.GetFilename()));
+
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(profile.GetFilename()));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+  ASSERT_EQ(25u, loaded_info.GetNumberOfMethods());
+  ASSERT_EQ(1u, loaded_info.GetNumberOfResolvedClasses());
+}
+
+TEST_F(ProfileCompilationInfoTest, MergeWithSavedProfile) {
+  ScratchFile profile;
+  ProfileCompilationInfo first_info;
+  AddMethods(&first_info, "/data/app/base.apk", 1, 0, 10);
+  ASSERT_TRUE(first_info.MergeAndSave(profile.GetFilename()));
+
+  ProfileCompilationInfo second_info;
+  AddMethods(&second_info, "/data/app/base.apk", 1, 5, 15);
+  ASSERT_TRUE(second_info.MergeAndSave(profile.GetFilename()));
+
+  ProfileCompilationInfo expected_info;
+  ASSERT_TRUE(expected_info.MergeWith(first_info));
+  ASSERT_TRUE(expected_info.MergeWith(second_info));
+
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(profile.GetFilename()));
+  ASSERT_TRUE(loaded_info.Equals(expected_info));
+  ASSERT_EQ(15u, loaded_info.GetNumberOfMethods());
+}
+
+TEST_F(ProfileCompilationInfoTest, ChecksumMismatch) {
+  ProfileCompilationInfo info;
+  ASSERT_TRUE(info.AddMethod("/data/app/base.apk", 1, 0));
+  ASSERT_FALSE(info.AddMethod("/data/app/base.apk", 2, 1));
+
+  ProfileCompilationInfo other_info;
+  ASSERT_TRUE(other_info.AddMethod("/data/app/base.apk", 2, 1));
+  ASSERT_FALSE(info.MergeWith(other_info));
+  ASSERT_EQ(1u, info.GetNumberOfMethods());
+
+  // A profile of an older version of the application is replaced when saving.
+  ScratchFile profile;
+  ASSERT_TRUE(info.MergeAndSave(profile.GetFilename()));
+  ASSERT_TRUE(other_info.MergeAndSave(profile.GetFilename()));
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(profile.GetFilename()));
+  ASSERT_TRUE(loaded_info.Equals(other_info));
+}
+
+TEST_F(ProfileCompilationInfoTest, InvalidFile) {
+  ScratchFile profile;
+  const char garbage[] = "not a profile";
+  ASSERT_TRUE(profile.GetFile()->WriteFully(garbage, sizeof(garbage)));
+  ProfileCompilationInfo info;
+  ASSERT_FALSE(info.Load(profile.GetFilename()));
+  ASSERT_EQ(0u, info.GetNumberOfMethods());
+}
+
+TEST_F(ProfileCompilationInfoTest, InlineCaches) {
+  std::unique_ptr<const DexFile> dex_file(OpenTestDexFile("Main"));
+  const std::string& location = dex_file->GetLocation();
+  uint32_t checksum = dex_file->GetLocationChecksum();
+  ProfileCompilationInfo info;
+  ASSERT_TRUE(info.AddMethod(location, checksum, 0));
+  ASSERT_TRUE(info.AddInlineCache(location, checksum, 0, 3, { 1 }));
+  ASSERT_TRUE(info.AddInlineCache(location, checksum, 0, 3, { 2 }));
+  ASSERT_TRUE(info.AddInlineCache(location, checksum, 0, 8, { 1, 2, 3 }));
+  ASSERT_TRUE(info.AddInlineCache(location, checksum, 0, 8, { 4, 5 }));
+
+  MethodReference method_ref(dex_file.get(), 0);
+  ASSERT_TRUE(info.ContainsMethod(method_ref));
+  ASSERT_FALSE(info.ContainsMethod(MethodReference(dex_file.get(), 1)));
+
+  const std::set<uint16_t>* types = info.GetInlineCacheTypes(method_ref, 3);
+  ASSERT_TRUE(types != nullptr);
+  ASSERT_EQ(std::set<uint16_t>({ 1, 2 }), *types);
+
+  // Too many receiver types make the call site megamorphic.
+  types = info.GetInlineCacheTypes(method_ref, 8);
+  ASSERT_TRUE(types != nullptr);
+  ASSERT_TRUE(types->empty());
+
+  ASSERT_TRUE(info.GetInlineCacheTypes(method_ref, 12) == nullptr);
+}
+
+}  // namespace art
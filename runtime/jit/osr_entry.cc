@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "osr_entry.h"
+
+#include "art_method-inl.h"
+#include "handle_scope-inl.h"
+#include "mirror/dex_cache.h"
+#include "stack.h"
+#include "verifier/method_verifier.h"
+#include "verifier/reg_type.h"
+#include "verifier/register_line-inl.h"
+
+namespace art {
+namespace jit {
+
+// The compiled code receives its arguments as parameters of the graph, whose index is 8 bits.
+static constexpr size_t kMaximumNumberOfArgumentVRegs = 255;
+
+OsrEntry* OsrEntry::Create(Thread* self, ArtMethod* method, uint32_t dex_pc) {
+  const DexFile::CodeItem* code_item = method->GetCodeItem();
+  DCHECK(code_item != nullptr) << PrettyMethod(method);
+  DCHECK_LT(dex_pc, code_item->insns_size_in_code_units_);
+
+  StackHandleScope<2> hs(self);
+  Handle<mirror::DexCache> h_dex_cache(hs.NewHandle(method->GetDexCache()));
+  Handle<mirror::ClassLoader> h_class_loader(hs.NewHandle(method->GetClassLoader()));
+  verifier::MethodVerifier verifier(self, h_dex_cache->GetDexFile(), h_dex_cache,
+                                    h_class_loader, &method->GetClassDef(), code_item,
+                                    method->GetDexMethodIndex(), method,
+                                    method->GetAccessFlags(), true, true, true, true);
+  if (!verifier.Verify() || verifier.HasFailures()) {
+    return nullptr;
+  }
+  const verifier::RegisterLine* line = verifier.GetRegLine(dex_pc);
+  if (line == nullptr) {
+    // Not a loop header the verifier kept the registers of.
+    return nullptr;
+  }
+
+  std::unique_ptr<OsrEntry> entry(new OsrEntry(dex_pc));
+  entry->shorty_.push_back(method->GetShorty()[0]);
+  size_t argument_vregs = 0;
+  for (uint16_t reg = 0; reg < code_item->registers_size_; ++reg) {
+    const verifier::RegType& type = line->GetRegisterType(&verifier, reg);
+    if (type.IsConstantLo()) {
+      if (reg + 1u == code_item->registers_size_) {
+        return nullptr;
+      }
+      const verifier::RegType& high_type = line->GetRegisterType(&verifier, reg + 1);
+      if (!type.IsPreciseConstantLo() || !high_type.IsPreciseConstantHi()) {
+        return nullptr;
+      }
+      const verifier::ConstantType& low = *down_cast<const verifier::ConstantType*>(&type);
+      const verifier::ConstantType& high = *down_cast<const verifier::ConstantType*>(&high_type);
+      uint64_t value = (static_cast<uint64_t>(static_cast<uint32_t>(high.ConstantValueHi())) << 32)
+          | static_cast<uint32_t>(low.ConstantValueLo());
+      entry->constants_.push_back({reg, true, static_cast<int64_t>(value)});
+      ++reg;
+    } else if (type.IsConstant()) {
+      if (!type.IsPreciseConstant()) {
+        // One of several constants, which the compiler could not type without knowing the uses.
+        return nullptr;
+      }
+      const verifier::ConstantType& constant = *down_cast<const verifier::ConstantType*>(&type);
+      entry->constants_.push_back({reg, false, constant.ConstantValue()});
+    } else if (type.IsLongLo() || type.IsDoubleLo()) {
+      entry->shorty_.push_back(type.IsLongLo() ? 'J' : 'D');
+      entry->argument_vregs_.push_back(reg);
+      argument_vregs += 2;
+      ++reg;
+    } else if (type.IsFloat()) {
+      entry->shorty_.push_back('F');
+      entry->argument_vregs_.push_back(reg);
+      ++argument_vregs;
+    } else if (type.IsIntegralTypes()) {
+      entry->shorty_.push_back('I');
+      entry->argument_vregs_.push_back(reg);
+      ++argument_vregs;
+    } else if (type.IsUninitializedTypes()) {
+      // The compiled code cannot track the initialization of an object it did not allocate.
+      return nullptr;
+    } else if (type.IsNonZeroReferenceTypes()) {
+      entry->shorty_.push_back('L');
+      entry->argument_vregs_.push_back(reg);
+      ++argument_vregs;
+    } else {
+      // Undefined, conflict or stray high half: the value is dead at the loop header.
+      DCHECK(type.IsUndefined() || type.IsConflict() || type.IsHighHalf()) << type;
+    }
+  }
+  if (argument_vregs > kMaximumNumberOfArgumentVRegs) {
+    return nullptr;
+  }
+  return entry.release();
+}
+
+size_t OsrEntry::GetArgumentsSize() const {
+  size_t size = 0;
+  for (size_t i = 0; i < GetNumberOfArguments(); ++i) {
+    size += Primitive::Is64BitType(GetArgumentType(i)) ? 2 * sizeof(uint32_t) : sizeof(uint32_t);
+  }
+  return size;
+}
+
+void OsrEntry::FillArguments(const ShadowFrame& shadow_frame, uint32_t* args) const {
+  for (size_t i = 0; i < GetNumberOfArguments(); ++i) {
+    const uint16_t vreg = GetArgumentVReg(i);
+    switch (GetArgumentType(i)) {
+      case Primitive::kPrimNot:
+        *args++ = StackReference<mirror::Object>::FromMirrorPtr(
+            shadow_frame.GetVRegReference(vreg)).AsVRegValue();
+        break;
+      case Primitive::kPrimLong:
+      case Primitive::kPrimDouble:
+        // Low half first, like ArgArray::AppendWide.
+        *args++ = shadow_frame.GetVReg(vreg);
+        *args++ = shadow_frame.GetVReg(vreg + 1);
+        break;
+      default:
+        *args++ = shadow_frame.GetVReg(vreg);
+        break;
+    }
+  }
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_OSR_ENTRY_H_
+#define ART_RUNTIME_JIT_OSR_ENTRY_H_
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "primitive.h"
+
+namespace art {
+
+class ArtMethod;
+class ShadowFrame;
+class Thread;
+
+namespace jit {
+
+/**
+ * Describes how an interpreter frame looping at a given loop header is transferred
+ * to compiled code (on-stack replacement).
+ *
+ * The JIT compiles a special version of the method whose entry block jumps straight
+ * to the loop header. That code is called like a static method: the dex registers
+ * that are live at the loop header are its arguments, and the dex registers the
+ * verifier proved to hold a constant there are materialized by the compiled code.
+ * Dex registers that are undefined at the loop header are dropped.
+ */
+class OsrEntry {
+ public:
+  // Describe the frame of `method` at the loop header `dex_pc`. Returns null if the frame
+  // cannot be transferred at that point, for instance because a dex register holds one of
+  // several constants and the compiler could not type it.
+  static OsrEntry* Create(Thread* self, ArtMethod* method, uint32_t dex_pc)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  uint32_t GetDexPc() const {
+    return dex_pc_;
+  }
+
+  // The shorty of the compiled code: the return type of the method, followed by the type
+  // of each argument.
+  const char* GetShorty() const {
+    return shorty_.c_str();
+  }
+
+  size_t GetNumberOfArguments() const {
+    return argument_vregs_.size();
+  }
+
+  // Dex register holding argument `i`. Wide arguments are held in that register and the next.
+  uint16_t GetArgumentVReg(size_t i) const {
+    return argument_vregs_[i];
+  }
+
+  Primitive::Type GetArgumentType(size_t i) const {
+    return Primitive::GetType(shorty_[i + 1]);
+  }
+
+  size_t GetNumberOfConstants() const {
+    return constants_.size();
+  }
+
+  uint16_t GetConstantVReg(size_t i) const {
+    return constants_[i].vreg;
+  }
+
+  // Whether constant `i` is the low half of a wide constant held in its dex register and the next.
+  bool IsWideConstant(size_t i) const {
+    return constants_[i].is_wide;
+  }
+
+  int64_t GetConstantValue(size_t i) const {
+    return constants_[i].value;
+  }
+
+  // Size in bytes of the arguments of the compiled code.
+  size_t GetArgumentsSize() const;
+
+  // Copy the arguments of the compiled code from `shadow_frame`, in the layout expected by
+  // the invoke stubs.
+  void FillArguments(const ShadowFrame& shadow_frame, uint32_t* args) const
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Entry point of the compiled code, set once it has been committed to the code cache.
+  const void* GetCode() const {
+    return code_;
+  }
+
+  void SetCode(const void* code) {
+    code_ = code;
+  }
+
+ private:
+  struct Constant {
+    uint16_t vreg;
+    bool is_wide;
+    int64_t value;
+  };
+
+  explicit OsrEntry(uint32_t dex_pc) : dex_pc_(dex_pc), code_(nullptr) {}
+
+  const uint32_t dex_pc_;
+  std::string shorty_;
+  std::vector<uint16_t> argument_vregs_;
+  std::vector<Constant> constants_;
+  const void* code_;
+
+  DISALLOW_COPY_AND_ASSIGN(OsrEntry);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_OSR_ENTRY_H_
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "profile_saver.h"
+
+#include "art_method-inl.h"
+#include "class_linker.h"
+#include "class_table.h"
+#include "jit/jit_code_cache.h"
+#include "jit/profiling_info.h"
+#include "mirror/class-inl.h"
+#include "mirror/dex_cache.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+#include "thread.h"
+
+namespace art {
+namespace jit {
+
+// Delay before the first save, so that it does not compete with the start of the application.
+static constexpr uint64_t kInitialDelayMs = 10 * 1000;
+// Delay between two saves.
+static constexpr uint64_t kSavePeriodMs = 40 * 1000;
+
+ProfileSaver* ProfileSaver::instance_ = nullptr;
+pthread_t ProfileSaver::profiler_pthread_ = 0U;
+
+// Collects the profile of the classes defined by the application. Boot classes are
+// compiled ahead of time with the boot image, so their profile is not needed.
+class ProfileCollector : public ClassVisitor {
+ public:
+  ProfileCollector(JitCodeCache* code_cache,
+                   size_t hot_method_threshold,
+                   ProfileCompilationInfo* info)
+      : code_cache_(code_cache),
+        hot_method_threshold_(hot_method_threshold),
+        pointer_size_(Runtime::Current()->GetClassLinker()->GetImagePointerSize()),
+        info_(info) {}
+
+  bool Visit(mirror::Class* klass) OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    if (klass->GetClassLoader() == nullptr ||
+        !klass->IsResolved() ||
+        klass->IsErroneous() ||
+        klass->IsProxyClass() ||
+        klass->IsArrayClass() ||
+        klass->GetDexCache() == nullptr) {
+      return true;
+    }
+    const DexFile& dex_file = klass->GetDexFile();
+    info_->AddClass(dex_file.GetLocation(), dex_file.GetLocationChecksum(),
+                    klass->GetDexTypeIndex());
+    for (ArtMethod& method : klass->GetDirectMethods(pointer_size_)) {
+      VisitMethod(&method, dex_file);
+    }
+    for (ArtMethod& method : klass->GetVirtualMethods(pointer_size_)) {
+      VisitMethod(&method, dex_file);
+    }
+    return true;
+  }
+
+ private:
+  void VisitMethod(ArtMethod* method, const DexFile& dex_file)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    if (method->IsNative() || method->IsAbstract() || method->GetCounter() == 0) {
+      // Only methods that ran in the interpreter have a hotness counter and profiling info.
+      return;
+    }
+    const std::string& location = dex_file.GetLocation();
+    uint32_t checksum = dex_file.GetLocationChecksum();
+    uint32_t method_idx = method->GetDexMethodIndex();
+    if (method->GetCounter() >= hot_method_threshold_ || code_cache_->ContainsMethod(method)) {
+      info_->AddMethod(location, checksum, method_idx);
+    }
+
+    ProfilingInfo* profiling_info = method->GetProfilingInfo(sizeof(void*));
+    if (profiling_info == nullptr) {
+      return;
+    }
+    for (size_t i = 0; i < profiling_info->GetNumberOfInlineCaches(); ++i) {
+      const ProfilingInfo::InlineCache& cache = profiling_info->GetInlineCacheAt(i);
+      if (cache.IsUnitialized()) {
+        continue;
+      }
+      // A call site is recorded as megamorphic, with no type, if we cannot record all its types.
+      std::vector<uint16_t> types;
+      if (!cache.IsMegamorphic()) {
+        for (size_t j = 0; j < ProfilingInfo::InlineCache::kIndividualCacheSize; ++j) {
+          mirror::Class* cls = cache.GetTypeAt(j);
+          if (cls == nullptr) {
+            break;
+          }
+          uint32_t type_idx = FindTypeIndexIn(cls, dex_file);
+          if (type_idx == DexFile::kDexNoIndex) {
+            types.clear();
+            break;
+          }
+          types.push_back(type_idx);
+        }
+      }
+      info_->AddInlineCache(location, checksum, method_idx, cache.dex_pc, types);
+    }
+  }
+
+  static uint32_t FindTypeIndexIn(mirror::Class* cls, const DexFile& dex_file)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    if (cls->IsProxyClass() || cls->IsArrayClass() || cls->IsPrimitive()) {
+      return DexFile::kDexNoIndex;
+    }
+    if (&cls->GetDexFile() == &dex_file) {
+      return cls->GetDexTypeIndex();
+    }
+    return cls->FindTypeIndexInOtherDexFile(dex_file);
+  }
+
+  JitCodeCache* const code_cache_;
+  const size_t hot_method_threshold_;
+  const size_t pointer_size_;
+  ProfileCompilationInfo* const info_;
+};
+
+ProfileSaver::ProfileSaver(const std::string& output_filename,
+                           JitCodeCache* jit_code_cache,
+                           size_t hot_method_threshold)
+    : output_filename_(output_filename),
+      jit_code_cache_(jit_code_cache),
+      hot_method_threshold_(hot_method_threshold),
+      wait_lock_("ProfileSaver wait lock"),
+      period_condition_("ProfileSaver period condition", wait_lock_),
+      shutting_down_(false) {
+}
+
+bool ProfileSaver::ShuttingDown(Thread* self) {
+  MutexLock mu(self, wait_lock_);
+  return shutting_down_;
+}
+
+void ProfileSaver::Run() {
+  Thread* self = Thread::Current();
+  uint64_t delay_ms = kInitialDelayMs;
+  while (true) {
+    {
+      MutexLock mu(self, wait_lock_);
+      if (shutting_down_) {
+        break;
+      }
+      period_condition_.TimedWait(self, delay_ms, 0);
+    }
+    if (ShuttingDown(self)) {
+      break;
+    }
+    ProcessProfilingInfo();
+    delay_ms = kSavePeriodMs;
+  }
+  // Save what the application did since the last period.
+  ProcessProfilingInfo();
+}
+
+bool ProfileSaver::ProcessProfilingInfo() {
+  uint64_t start = NanoTime();
+  ProfileCompilationInfo info;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    ProfileCollector collector(jit_code_cache_, hot_method_threshold_, &info);
+    Runtime::Current()->GetClassLinker()->VisitClasses(&collector);
+  }
+  if (info.Equals(last_saved_info_)) {
+    VLOG(profiler) << "No new profile information to save";
+    return false;
+  }
+  if (!info.MergeAndSave(output_filename_)) {
+    return false;
+  }
+  last_saved_info_ = info;
+  VLOG(profiler) << "Profile saved in " << PrettyDuration(NanoTime() - start);
+  return true;
+}
+
+void* ProfileSaver::RunProfileSaverThread(void* arg) {
+  Runtime* runtime = Runtime::Current();
+  ProfileSaver* profile_saver = reinterpret_cast<ProfileSaver*>(arg);
+
+  CHECK(runtime->AttachCurrentThread("Profile Saver",
+                                     /* as_daemon */ true,
+                                     runtime->GetSystemThreadGroup(),
+                                     /* create_peer */ true));
+  profile_saver->Run();
+
+  runtime->DetachCurrentThread();
+  VLOG(profiler) << "Profile saver shutdown";
+  return nullptr;
+}
+
+void ProfileSaver::Start(const std::string& output_filename,
+                         JitCodeCache* jit_code_cache,
+                         size_t hot_method_threshold) {
+  DCHECK(!output_filename.empty());
+  DCHECK(jit_code_cache != nullptr);
+
+  MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+  if (instance_ != nullptr) {
+    // Don't start two profile saver threads.
+    return;
+  }
+
+  VLOG(profiler) << "Starting profile saver using output file: " << output_filename;
+  instance_ = new ProfileSaver(output_filename, jit_code_cache, hot_method_threshold);
+
+  // Create a new thread which does the saving.
+  CHECK_PTHREAD_CALL(
+      pthread_create,
+      (&profiler_pthread_, nullptr, &RunProfileSaverThread, reinterpret_cast<void*>(instance_)),
+      "Profile saver thread");
+}
+
+void ProfileSaver::Stop() {
+  Thread* self = Thread::Current();
+  ProfileSaver* profile_saver = nullptr;
+  pthread_t profiler_pthread = 0U;
+  {
+    MutexLock mu(self, *Locks::profiler_lock_);
+    if (instance_ == nullptr) {
+      return;
+    }
+    profile_saver = instance_;
+    profiler_pthread = profiler_pthread_;
+  }
+
+  // Wake up the saver thread if it is sleeping, it saves one last time before exiting.
+  {
+    MutexLock mu(self, profile_saver->wait_lock_);
+    profile_saver->shutting_down_ = true;
+    profile_saver->period_condition_.Signal(self);
+  }
+  CHECK_PTHREAD_CALL(pthread_join, (profiler_pthread, nullptr), "profile saver thread shutdown");
+
+  {
+    MutexLock mu(self, *Locks::profiler_lock_);
+    instance_ = nullptr;
+    profiler_pthread_ = 0U;
+  }
+  delete profile_saver;
+}
+
+bool ProfileSaver::IsStarted() {
+  MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+  return instance_ != nullptr;
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_PROFILE_SAVER_H_
+#define ART_RUNTIME_JIT_PROFILE_SAVER_H_
+
+#include <pthread.h>
+
+#include <string>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "offline_profiling_info.h"
+
+namespace art {
+
+class Thread;
+
+namespace jit {
+
+class JitCodeCache;
+
+// Background thread periodically saving the methods the JIT found hot, the classes the
+// application resolved and the receiver types of its virtual and interface calls to a
+// profile file, so that dex2oat can compile the application based on them.
+class ProfileSaver {
+ public:
+  // Start the profile saver thread, writing to `output_filename`. Methods whose hotness
+  // counter reached `hot_method_threshold` are considered hot.
+  static void Start(const std::string& output_filename,
+                    JitCodeCache* jit_code_cache,
+                    size_t hot_method_threshold)
+      REQUIRES(!Locks::profiler_lock_);
+
+  // Stop the profile saver thread, after it saved the profile one last time.
+  static void Stop() REQUIRES(!Locks::profiler_lock_);
+
+  static bool IsStarted() REQUIRES(!Locks::profiler_lock_);
+
+ private:
+  ProfileSaver(const std::string& output_filename,
+               JitCodeCache* jit_code_cache,
+               size_t hot_method_threshold);
+
+  // Entry point of the profile saver thread.
+  static void* RunProfileSaverThread(void* arg) REQUIRES(!Locks::profiler_lock_);
+
+  void Run() REQUIRES(!Locks::profiler_lock_, !wait_lock_);
+
+  // Collect the profile of the application and merge it into the profile file if it
+  // changed since the last time. Returns whether the file was written.
+  bool ProcessProfilingInfo();
+
+  bool ShuttingDown(Thread* self) REQUIRES(!wait_lock_);
+
+  // The only instance of the saver, and its thread.
+  static ProfileSaver* instance_ GUARDED_BY(Locks::profiler_lock_);
+  static pthread_t profiler_pthread_ GUARDED_BY(Locks::profiler_lock_);
+
+  const std::string output_filename_;
+  JitCodeCache* const jit_code_cache_;
+  const size_t hot_method_threshold_;
+
+  // The profile written by the last save, to skip saves that would not change the file.
+  ProfileCompilationInfo last_saved_info_;
+
+  // The saver thread waits on `period_condition_` between two saves. It is signaled on shutdown.
+  Mutex wait_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  ConditionVariable period_condition_ GUARDED_BY(wait_lock_);
+  bool shutting_down_ GUARDED_BY(wait_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(ProfileSaver);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_PROFILE_SAVER_H_
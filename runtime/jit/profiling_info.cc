@@ -78,15 +78,23 @@ ProfilingInfo* ProfilingInfo::Create(ArtMethod* method) {
   return new (data) ProfilingInfo(entries);
 }
 
-void ProfilingInfo::AddInvokeInfo(Thread* self, uint32_t dex_pc, mirror::Class* cls) {
-  InlineCache* cache = nullptr;
+mirror::Class* ProfilingInfo::InlineCache::GetTypeAt(size_t index) const {
+  DCHECK_LT(index, static_cast<size_t>(kIndividualCacheSize));
+  return classes_[index].Read();
+}
+
+const ProfilingInfo::InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) const {
   // TODO: binary search if array is too long.
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
     if (cache_[i].dex_pc == dex_pc) {
-      cache = &cache_[i];
-      break;
+      return &cache_[i];
     }
   }
+  return nullptr;
+}
+
+void ProfilingInfo::AddInvokeInfo(Thread* self, uint32_t dex_pc, mirror::Class* cls) {
+  InlineCache* cache = const_cast<InlineCache*>(GetInlineCache(dex_pc));
   DCHECK(cache != nullptr);
 
   ScopedObjectAccess soa(self);
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "base/macros.h"
+#include "base/mutex.h"
 #include "gc_root.h"
 
 namespace art {
@@ -36,23 +37,6 @@ class Class;
  */
 class ProfilingInfo {
  public:
-  static ProfilingInfo* Create(ArtMethod* method);
-
-  // Add information from an executed INVOKE instruction to the profile.
-  void AddInvokeInfo(Thread* self, uint32_t dex_pc, mirror::Class* cls);
-
-  // NO_THREAD_SAFETY_ANALYSIS since we don't know what the callback requires.
-  template<typename RootVisitorType>
-  void VisitRoots(RootVisitorType& visitor) NO_THREAD_SAFETY_ANALYSIS {
-    for (size_t i = 0; i < number_of_inline_caches_; ++i) {
-      InlineCache* cache = &cache_[i];
-      for (size_t j = 0; j < InlineCache::kIndividualCacheSize; ++j) {
-        visitor.VisitRootIfNonNull(cache->classes_[j].AddressWithoutBarrier());
-      }
-    }
-  }
-
- private:
   // Structure to store the classes seen at runtime for a specific instruction.
   // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
   struct InlineCache {
@@ -79,11 +63,49 @@ class ProfilingInfo {
       return !classes_[1].IsNull() && classes_[kIndividualCacheSize - 1].IsNull();
     }
 
+    // Returns the class at `index` in the cache, or null if the entry is empty.
+    mirror::Class* GetTypeAt(size_t index) const SHARED_REQUIRES(Locks::mutator_lock_);
+
+    mirror::Class* GetMonomorphicType() const SHARED_REQUIRES(Locks::mutator_lock_) {
+      DCHECK(IsMonomorphic());
+      return GetTypeAt(0);
+    }
+
     static constexpr uint16_t kIndividualCacheSize = 5;
     uint32_t dex_pc;
     GcRoot<mirror::Class> classes_[kIndividualCacheSize];
   };
 
+  static ProfilingInfo* Create(ArtMethod* method);
+
+  // Add information from an executed INVOKE instruction to the profile.
+  void AddInvokeInfo(Thread* self, uint32_t dex_pc, mirror::Class* cls);
+
+  // Returns the inline cache of the INVOKE instruction at `dex_pc`, or null if
+  // that instruction is not profiled.
+  const InlineCache* GetInlineCache(uint32_t dex_pc) const;
+
+  size_t GetNumberOfInlineCaches() const {
+    return number_of_inline_caches_;
+  }
+
+  const InlineCache& GetInlineCacheAt(size_t index) const {
+    DCHECK_LT(index, number_of_inline_caches_);
+    return cache_[index];
+  }
+
+  // NO_THREAD_SAFETY_ANALYSIS since we don't know what the callback requires.
+  template<typename RootVisitorType>
+  void VisitRoots(RootVisitorType& visitor) NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t i = 0; i < number_of_inline_caches_; ++i) {
+      InlineCache* cache = &cache_[i];
+      for (size_t j = 0; j < InlineCache::kIndividualCacheSize; ++j) {
+        visitor.VisitRootIfNonNull(cache->classes_[j].AddressWithoutBarrier());
+      }
+    }
+  }
+
+ private:
   explicit ProfilingInfo(const std::vector<uint32_t>& entries)
       : number_of_inline_caches_(entries.size()) {
     memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
@@ -1698,7 +1698,10 @@ class JNI {
     ScopedObjectAccess soa(env);
     mirror::String* s = soa.Decode<mirror::String*>(java_string);
     gc::Heap* heap = Runtime::Current()->GetHeap();
-    if (heap->IsMovableObject(s)) {
+    if (heap->CanPinObject(s)) {
+      // Hand out the chars of the string itself, its region stays in place until the release.
+      heap->PinObject(s);
+    } else if (heap->IsMovableObject(s)) {
       jchar* chars = new jchar[s->GetLength()];
       memcpy(chars, s->GetValue(), sizeof(jchar) * s->GetLength());
       if (is_copy != nullptr) {
@@ -1718,6 +1721,11 @@ class JNI {
     mirror::String* s = soa.Decode<mirror::String*>(java_string);
     if (chars != s->GetValue()) {
       delete[] chars;
+    } else {
+      gc::Heap* heap = Runtime::Current()->GetHeap();
+      if (heap->CanPinObject(s)) {
+        heap->UnpinObject(s);
+      }
     }
   }
 
@@ -1726,7 +1734,10 @@ class JNI {
     ScopedObjectAccess soa(env);
     mirror::String* s = soa.Decode<mirror::String*>(java_string);
     gc::Heap* heap = Runtime::Current()->GetHeap();
-    if (heap->IsMovableObject(s)) {
+    if (heap->CanPinObject(s)) {
+      // Only the region of the string is kept from moving, the GC goes on with the others.
+      heap->PinObject(s);
+    } else if (heap->IsMovableObject(s)) {
       StackHandleScope<1> hs(soa.Self());
       HandleWrapper<mirror::String> h(hs.NewHandleWrapper(&s));
       if (!kUseReadBarrier) {
@@ -1750,7 +1761,9 @@ class JNI {
     ScopedObjectAccess soa(env);
     gc::Heap* heap = Runtime::Current()->GetHeap();
     mirror::String* s = soa.Decode<mirror::String*>(java_string);
-    if (heap->IsMovableObject(s)) {
+    if (heap->CanPinObject(s)) {
+      heap->UnpinObject(s);
+    } else if (heap->IsMovableObject(s)) {
       if (!kUseReadBarrier) {
         heap->DecrementDisableMovingGC(soa.Self());
       } else {
@@ -1901,7 +1914,10 @@ class JNI {
       return nullptr;
     }
     gc::Heap* heap = Runtime::Current()->GetHeap();
-    if (heap->IsMovableObject(array)) {
+    if (heap->CanPinObject(array)) {
+      // Only the region of the array is kept from moving, the GC goes on with the others.
+      heap->PinObject(array);
+    } else if (heap->IsMovableObject(array)) {
       if (!kUseReadBarrier) {
         heap->IncrementDisableMovingGC(soa.Self());
       } else {
@@ -2339,18 +2355,17 @@ class JNI {
   static jint EnsureLocalCapacityInternal(ScopedObjectAccess& soa, jint desired_capacity,
                                           const char* caller)
       SHARED_REQUIRES(Locks::mutator_lock_) {
-    // TODO: we should try to expand the table if necessary.
-    if (desired_capacity < 0 || desired_capacity > static_cast<jint>(kLocalsMax)) {
+    if (desired_capacity < 0) {
       LOG(ERROR) << "Invalid capacity given to " << caller << ": " << desired_capacity;
       return JNI_ERR;
     }
-    // TODO: this isn't quite right, since "capacity" includes holes.
-    const size_t capacity = soa.Env()->locals.Capacity();
-    bool okay = (static_cast<jint>(kLocalsMax - capacity) >= desired_capacity);
-    if (!okay) {
+    std::string error_msg;
+    if (!soa.Env()->locals.EnsureFreeCapacity(static_cast<size_t>(desired_capacity), &error_msg)) {
+      LOG(ERROR) << "Failed to grow local reference table in " << caller << ": " << error_msg;
       soa.Self()->ThrowOutOfMemoryError(caller);
+      return JNI_ERR;
     }
-    return okay ? JNI_OK : JNI_ERR;
+    return JNI_OK;
   }
 
   template<typename JniT, typename ArtT>
@@ -2452,6 +2467,9 @@ class JNI {
     if (mode != JNI_COMMIT) {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
+      } else if (heap->CanPinObject(array)) {
+        // Non copy of a pinnable object means that we pinned it.
+        heap->UnpinObject(array);
       } else if (heap->IsMovableObject(array)) {
         // Non copy to a movable object must means that we had disabled the moving GC.
         if (!kUseReadBarrier) {
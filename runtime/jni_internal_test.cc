@@ -866,11 +866,16 @@ TEST_F(JniInternalTest, FromReflectedField_ToReflectedField) {
   ASSERT_NE(fid, nullptr);
   // Turn the fid into a java.lang.reflect.Field...
   jobject field = env_->ToReflectedField(c, fid, JNI_FALSE);
-  for (size_t i = 0; i <= kLocalsMax; ++i) {
-    // Regression test for b/18396311, ToReflectedField leaking local refs causing a local
-    // reference table overflows with 512 references to ArtField
+  // Regression test for b/18396311, ToReflectedField leaking local refs causing a local
+  // reference table overflows with 512 references to ArtField. The table now grows, so check
+  // that the top of a new frame, where holes of older frames are not reused, does not move.
+  ASSERT_EQ(JNI_OK, env_->PushLocalFrame(16));
+  const uint32_t local_ref_state = down_cast<JNIEnvExt*>(env_)->locals.GetSegmentState();
+  for (size_t i = 0; i <= 512; ++i) {
     env_->DeleteLocalRef(env_->ToReflectedField(c, fid, JNI_FALSE));
+    ASSERT_EQ(local_ref_state, down_cast<JNIEnvExt*>(env_)->locals.GetSegmentState());
   }
+  env_->PopLocalFrame(nullptr);
   ASSERT_NE(c, nullptr);
   ASSERT_TRUE(env_->IsInstanceOf(field, jlrField));
   // ...and back again.
@@ -897,11 +902,16 @@ TEST_F(JniInternalTest, FromReflectedMethod_ToReflectedMethod) {
   ASSERT_NE(mid, nullptr);
   // Turn the mid into a java.lang.reflect.Constructor...
   jobject method = env_->ToReflectedMethod(c, mid, JNI_FALSE);
-  for (size_t i = 0; i <= kLocalsMax; ++i) {
-    // Regression test for b/18396311, ToReflectedMethod leaking local refs causing a local
-    // reference table overflows with 512 references to ArtMethod
+  // Regression test for b/18396311, ToReflectedMethod leaking local refs causing a local
+  // reference table overflows with 512 references to ArtMethod. The table now grows, so check
+  // that the top of a new frame, where holes of older frames are not reused, does not move.
+  ASSERT_EQ(JNI_OK, env_->PushLocalFrame(16));
+  const uint32_t local_ref_state = down_cast<JNIEnvExt*>(env_)->locals.GetSegmentState();
+  for (size_t i = 0; i <= 512; ++i) {
     env_->DeleteLocalRef(env_->ToReflectedMethod(c, mid, JNI_FALSE));
+    ASSERT_EQ(local_ref_state, down_cast<JNIEnvExt*>(env_)->locals.GetSegmentState());
   }
+  env_->PopLocalFrame(nullptr);
   ASSERT_NE(method, nullptr);
   ASSERT_TRUE(env_->IsInstanceOf(method, jlrConstructor));
   // ...and back again.
@@ -1848,14 +1858,15 @@ TEST_F(JniInternalTest, PushLocalFrame_10395422) {
   ASSERT_EQ(JNI_OK, env_->PushLocalFrame(0));
   env_->PopLocalFrame(nullptr);
 
-  // The following two tests will print errors to the log.
+  // There is no upper limit, the local reference table grows as needed.
+  ASSERT_EQ(JNI_OK, env_->PushLocalFrame(8192));
+  env_->PopLocalFrame(nullptr);
+
+  // The following test will print errors to the log.
   ScopedLogSeverity sls(LogSeverity::FATAL);
 
   // Negative capacities are not allowed.
   ASSERT_EQ(JNI_ERR, env_->PushLocalFrame(-1));
-
-  // And it's okay to have an upper limit. Ours is currently 512.
-  ASSERT_EQ(JNI_ERR, env_->PushLocalFrame(8192));
 }
 
 TEST_F(JniInternalTest, PushLocalFrame_PopLocalFrame) {
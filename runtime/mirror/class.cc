@@ -947,6 +947,19 @@ ArtMethod* Class::GetDeclaredConstructor(
   return nullptr;
 }
 
+uint32_t Class::FindTypeIndexInOtherDexFile(const DexFile& dex_file) {
+  std::string temp;
+  const DexFile::StringId* string_id = dex_file.FindStringId(GetDescriptor(&temp));
+  if (string_id == nullptr) {
+    return DexFile::kDexNoIndex;
+  }
+  const DexFile::TypeId* type_id = dex_file.FindTypeId(dex_file.GetIndexForStringId(*string_id));
+  if (type_id == nullptr) {
+    return DexFile::kDexNoIndex;
+  }
+  return dex_file.GetIndexForTypeId(*type_id);
+}
+
 uint32_t Class::Depth() {
   uint32_t depth = 0;
   for (Class* klass = this; klass->GetSuperClass() != nullptr; klass = klass->GetSuperClass()) {
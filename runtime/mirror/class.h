@@ -1038,6 +1038,12 @@ class MANAGED Class FINAL : public Object {
     SetField32<false>(OFFSET_OF_OBJECT_MEMBER(Class, dex_type_idx_), type_idx);
   }
 
+  // Returns the index of the type of this class in `dex_file`, or DexFile::kDexNoIndex if
+  // `dex_file` has no such type. Note that the type of another dex file may resolve to a
+  // different class with the same descriptor.
+  uint32_t FindTypeIndexInOtherDexFile(const DexFile& dex_file)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   static Class* GetJavaLangClass() SHARED_REQUIRES(Locks::mutator_lock_) {
     DCHECK(HasJavaLangClass());
     return java_lang_Class_.Read();
@@ -29,8 +29,7 @@ template <VerifyObjectFlags kVerifyFlags, typename Visitor>
 inline void ClassLoader::VisitReferences(mirror::Class* klass, const Visitor& visitor) {
   // Visit instance fields first.
   VisitInstanceFieldsReferences(klass, visitor);
-  // Visit classes loaded after.
-  ReaderMutexLock mu(Thread::Current(), *Locks::classlinker_classes_lock_);
+  // Visit classes loaded after. The class table takes its own lock.
   ClassTable* const class_table = GetClassTable();
   if (class_table != nullptr) {
     class_table->VisitRoots(visitor);
@@ -39,6 +39,11 @@ class PACKED(4) OatQuickMethodHeader {
 
   ~OatQuickMethodHeader();
 
+  static OatQuickMethodHeader* FromCodePointer(const void* code_ptr) {
+    return reinterpret_cast<OatQuickMethodHeader*>(
+        reinterpret_cast<uintptr_t>(code_ptr) - sizeof(OatQuickMethodHeader));
+  }
+
   OatQuickMethodHeader& operator=(const OatQuickMethodHeader&) = default;
 
   uintptr_t NativeQuickPcOffset(const uintptr_t pc) const {
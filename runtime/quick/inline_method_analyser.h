@@ -75,6 +75,9 @@ enum InlineMethodOpcode : uint16_t {
   kIntrinsicUnsafePut,
   kIntrinsicSystemArrayCopyCharArray,
   kIntrinsicSystemArrayCopy,
+  kIntrinsicSystemArrayCopyPrimitiveArray,
+  kIntrinsicArraysFill,
+  kIntrinsicArraysEquals,
 
   kInlineOpNop,
   kInlineOpReturnArg,
@@ -78,7 +78,9 @@
 #include "instrumentation.h"
 #include "intern_table.h"
 #include "interpreter/interpreter.h"
+#include "interpreter/mterp/mterp.h"
 #include "jit/jit.h"
+#include "jit/profile_saver.h"
 #include "jni_internal.h"
 #include "linear_alloc.h"
 #include "lambda/box_table.h"
@@ -276,6 +278,7 @@ Runtime::Runtime()
       oat_file_manager_(nullptr),
       is_low_memory_mode_(false) {
   CheckAsmSupportOffsetsAndSizes();
+  interpreter::CheckMterpAsmConstants();
   std::fill(callee_save_methods_, callee_save_methods_ + arraysize(callee_save_methods_), 0u);
 }
 
@@ -326,6 +329,9 @@ Runtime::~Runtime() {
   if (profiler_started_) {
     BackgroundMethodSamplingProfiler::Shutdown();
   }
+  if (jit_.get() != nullptr) {
+    jit::ProfileSaver::Stop();
+  }
 
   // Make sure to let the GC complete if it is running.
   heap_->WaitForGcToComplete(gc::kGcCauseBackground, self);
@@ -1013,6 +1019,7 @@ bool Runtime::Init(const RuntimeOptions& raw_options, bool ignore_unrecognized)
                        xgc_option.verify_pre_sweeping_rosalloc_,
                        xgc_option.verify_post_gc_rosalloc_,
                        xgc_option.gcstress_,
+                       xgc_option.generational_cc_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs));
   ATRACE_END();
@@ -1873,8 +1880,14 @@ void Runtime::CreateJit() {
   if (jit_.get() != nullptr) {
     compiler_callbacks_ = jit_->GetCompilerCallbacks();
     jit_->CreateInstrumentationCache(jit_options_->GetCompileThreshold(),
-                                     jit_options_->GetWarmupThreshold());
+                                     jit_options_->GetWarmupThreshold(),
+                                     jit_options_->GetOsrThreshold());
     jit_->CreateThreadPool();
+    if (!jit_options_->GetProfileFile().empty()) {
+      jit::ProfileSaver::Start(jit_options_->GetProfileFile(),
+                               jit_->GetCodeCache(),
+                               jit_options_->GetCompileThreshold());
+    }
   } else {
     LOG(WARNING) << "Failed to create JIT " << error_msg;
   }
@@ -491,14 +491,10 @@ class Runtime {
                                  mirror::Object* value, bool is_volatile) const;
   void RecordWriteArray(mirror::Array* array, size_t index, uint64_t value) const
       SHARED_REQUIRES(Locks::mutator_lock_);
-  void RecordStrongStringInsertion(mirror::String* s) const
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordWeakStringInsertion(mirror::String* s) const
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordStrongStringRemoval(mirror::String* s) const
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordWeakStringRemoval(mirror::String* s) const
-      REQUIRES(Locks::intern_table_lock_);
+  void RecordStrongStringInsertion(mirror::String* s) const;
+  void RecordWeakStringInsertion(mirror::String* s) const;
+  void RecordStrongStringRemoval(mirror::String* s) const;
+  void RecordWeakStringRemoval(mirror::String* s) const;
 
   void SetFaultMessage(const std::string& message) REQUIRES(!fault_message_lock_);
   // Only read by the signal handler, NO_THREAD_SAFETY_ANALYSIS to prevent lock order violations
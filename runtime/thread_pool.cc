@@ -28,10 +28,17 @@ namespace art {
 
 static constexpr bool kMeasureWaitTime = false;
 
-ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name,
+ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool,
+                                   const std::string& name,
+                                   size_t index,
                                    size_t stack_size)
     : thread_pool_(thread_pool),
-      name_(name) {
+      name_(name),
+      index_(index),
+      inbox_lock_("thread pool worker inbox lock"),
+      inbox_size_(0),
+      // Any non zero seed works for xorshift.
+      random_state_(static_cast<uint32_t>(index) + 1) {
   // Add an inaccessible page to catch stack overflow.
   stack_size += kPageSize;
   std::string error_msg;
@@ -56,6 +63,8 @@ ThreadPoolWorker::~ThreadPoolWorker() {
 void ThreadPoolWorker::Run() {
   Thread* self = Thread::Current();
   Task* task = nullptr;
+  CHECK_PTHREAD_CALL(pthread_setspecific, (thread_pool_->worker_key_, this),
+                     "thread pool worker key");
   thread_pool_->creation_barier_.Wait(self);
   while ((task = thread_pool_->GetTask(self)) != nullptr) {
     task->Run(self);
@@ -73,12 +82,79 @@ void* ThreadPoolWorker::Callback(void* arg) {
   return nullptr;
 }
 
+void ThreadPoolWorker::AddToInbox(Thread* self, Task* task) {
+  MutexLock mu(self, inbox_lock_);
+  inbox_.push_back(task);
+  inbox_size_.StoreRelaxed(inbox_.size());
+}
+
+Task* ThreadPoolWorker::TakeFromInbox(Thread* self) {
+  if (inbox_size_.LoadRelaxed() == 0) {
+    return nullptr;
+  }
+  MutexLock mu(self, inbox_lock_);
+  if (inbox_.empty()) {
+    return nullptr;
+  }
+  Task* task = inbox_.front();
+  inbox_.pop_front();
+  inbox_size_.StoreRelaxed(inbox_.size());
+  return task;
+}
+
+uint32_t ThreadPoolWorker::NextRandom() {
+  random_state_ ^= random_state_ << 13;
+  random_state_ ^= random_state_ >> 17;
+  random_state_ ^= random_state_ << 5;
+  return random_state_;
+}
+
 void ThreadPool::AddTask(Thread* self, Task* task) {
+  // Count the task before publishing it, see GetTask.
+  task_count_.FetchAndAddSequentiallyConsistent(1);
+  ThreadPoolWorker* worker = GetCurrentWorker();
+  if (worker != nullptr) {
+    worker->deque_.Push(task);
+  } else if (threads_.empty()) {
+    MutexLock mu(self, task_queue_lock_);
+    tasks_.push_back(task);
+    return;
+  } else {
+    size_t index = next_worker_.FetchAndAddSequentiallyConsistent(1) % GetThreadCount();
+    threads_[index]->AddToInbox(self, task);
+  }
+  SignalWorkers(self);
+}
+
+void ThreadPool::AddTask(Thread* self, Task* task, size_t affinity) {
+  if (threads_.empty()) {
+    AddTask(self, task);
+    return;
+  }
+  task_count_.FetchAndAddSequentiallyConsistent(1);
+  ThreadPoolWorker* target = threads_[affinity % GetThreadCount()];
+  if (target == GetCurrentWorker()) {
+    target->deque_.Push(task);
+  } else {
+    target->AddToInbox(self, task);
+  }
+  SignalWorkers(self);
+}
+
+void ThreadPool::SignalWorkers(Thread* self) {
+  // Pairs with the increment of `sleeping_count_` and the load of `task_count_` in GetTask: either
+  // the worker sees the new task before waiting, or we see it waiting.
+  if (sleeping_count_.LoadSequentiallyConsistent() == 0) {
+    return;
+  }
   MutexLock mu(self, task_queue_lock_);
-  tasks_.push_back(task);
-  // If we have any waiters, signal one.
-  if (started_ && waiting_count_ != 0) {
-    task_queue_condition_.Signal(self);
+  if (started_.LoadRelaxed()) {
+    if (max_active_workers_.LoadRelaxed() < GetThreadCount()) {
+      // Inactive workers wait on the same condition, make sure an active one wakes up.
+      task_queue_condition_.Broadcast(self);
+    } else {
+      task_queue_condition_.Signal(self);
+    }
   }
 }
 
@@ -90,26 +166,35 @@ ThreadPool::ThreadPool(const char* name, size_t num_threads)
     started_(false),
     shutting_down_(false),
     waiting_count_(0),
+    sleeping_count_(0),
+    task_count_(0),
+    next_worker_(0),
     start_time_(0),
     total_wait_time_(0),
     // Add one since the caller of constructor waits on the barrier too.
     creation_barier_(num_threads + 1),
     max_active_workers_(num_threads) {
   Thread* self = Thread::Current();
+  CHECK_PTHREAD_CALL(pthread_key_create, (&worker_key_, nullptr), "thread pool worker key");
   while (GetThreadCount() < num_threads) {
     const std::string worker_name = StringPrintf("%s worker thread %zu", name_.c_str(),
                                                  GetThreadCount());
-    threads_.push_back(
-        new ThreadPoolWorker(this, worker_name, ThreadPoolWorker::kDefaultStackSize));
+    threads_.push_back(new ThreadPoolWorker(this,
+                                            worker_name,
+                                            GetThreadCount(),
+                                            ThreadPoolWorker::kDefaultStackSize));
   }
   // Wait for all of the threads to attach.
   creation_barier_.Wait(self);
 }
 
 void ThreadPool::SetMaxActiveWorkers(size_t threads) {
-  MutexLock mu(Thread::Current(), task_queue_lock_);
+  Thread* self = Thread::Current();
+  MutexLock mu(self, task_queue_lock_);
   CHECK_LE(threads, GetThreadCount());
-  max_active_workers_ = threads;
+  max_active_workers_.StoreRelaxed(threads);
+  // Workers becoming active may have tasks to run.
+  task_queue_condition_.Broadcast(self);
 }
 
 ThreadPool::~ThreadPool() {
@@ -124,11 +209,12 @@ ThreadPool::~ThreadPool() {
   }
   // Wait for the threads to finish.
   STLDeleteElements(&threads_);
+  CHECK_PTHREAD_CALL(pthread_key_delete, (worker_key_), "thread pool worker key");
 }
 
 void ThreadPool::StartWorkers(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  started_ = true;
+  started_.StoreSequentiallyConsistent(true);
   task_queue_condition_.Broadcast(self);
   start_time_ = NanoTime();
   total_wait_time_ = 0;
@@ -136,25 +222,40 @@ void ThreadPool::StartWorkers(Thread* self) {
 
 void ThreadPool::StopWorkers(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  started_ = false;
+  started_.StoreSequentiallyConsistent(false);
+}
+
+ThreadPoolWorker* ThreadPool::GetCurrentWorker() const {
+  return reinterpret_cast<ThreadPoolWorker*>(pthread_getspecific(worker_key_));
 }
 
 Task* ThreadPool::GetTask(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  while (!IsShuttingDown()) {
-    const size_t thread_count = GetThreadCount();
-    // Ensure that we don't use more threads than the maximum active workers.
-    const size_t active_threads = thread_count - waiting_count_;
-    // <= since self is considered an active worker.
-    if (active_threads <= max_active_workers_) {
-      Task* task = TryGetTaskLocked();
+  ThreadPoolWorker* const worker = GetCurrentWorker();
+  DCHECK(worker != nullptr);
+  while (true) {
+    if (IsActive(worker)) {
+      Task* task = TryGetTask(self, worker);
       if (task != nullptr) {
         return task;
       }
     }
 
+    MutexLock mu(self, task_queue_lock_);
+    if (IsShuttingDown()) {
+      break;
+    }
+    const bool active = IsActive(worker);
+    if (active) {
+      sleeping_count_.FetchAndAddSequentiallyConsistent(1);
+      // A task added after our last look, or one we failed to steal, is still counted.
+      if (started_.LoadSequentiallyConsistent() &&
+          task_count_.LoadSequentiallyConsistent() != 0) {
+        sleeping_count_.FetchAndSubSequentiallyConsistent(1);
+        continue;
+      }
+    }
     ++waiting_count_;
-    if (waiting_count_ == GetThreadCount() && tasks_.empty()) {
+    if (waiting_count_ == GetThreadCount() && task_count_.LoadSequentiallyConsistent() == 0) {
       // We may be done, lets broadcast to the completion condition.
       completion_condition_.Broadcast(self);
     }
@@ -165,6 +266,12 @@ Task* ThreadPool::GetTask(Thread* self) {
       total_wait_time_ += wait_end - std::max(wait_start, start_time_);
     }
     --waiting_count_;
+    if (active) {
+      sleeping_count_.FetchAndSubSequentiallyConsistent(1);
+    }
+    if (IsShuttingDown()) {
+      break;
+    }
   }
 
   // We are shutting down, return null to tell the worker thread to stop looping.
@@ -172,15 +279,69 @@ Task* ThreadPool::GetTask(Thread* self) {
 }
 
 Task* ThreadPool::TryGetTask(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  return TryGetTaskLocked();
+  return TryGetTask(self, GetCurrentWorker());
 }
 
-Task* ThreadPool::TryGetTaskLocked() {
-  if (started_ && !tasks_.empty()) {
-    Task* task = tasks_.front();
-    tasks_.pop_front();
-    return task;
+Task* ThreadPool::TryGetTask(Thread* self, ThreadPoolWorker* worker) {
+  if (!started_.LoadSequentiallyConsistent() || task_count_.LoadRelaxed() == 0) {
+    return nullptr;
+  }
+  Task* task = nullptr;
+  if (threads_.empty()) {
+    MutexLock mu(self, task_queue_lock_);
+    if (!tasks_.empty()) {
+      task = tasks_.front();
+      tasks_.pop_front();
+    }
+  } else {
+    if (worker != nullptr) {
+      task = worker->deque_.Pop();
+      if (task == nullptr) {
+        task = worker->TakeFromInbox(self);
+      }
+    }
+    if (task == nullptr) {
+      task = StealTask(self, worker);
+    }
+  }
+  if (task == nullptr) {
+    return nullptr;
+  }
+  if (!started_.LoadSequentiallyConsistent()) {
+    // StopWorkers raced with us, and the task may have been added after it returned. Put the task
+    // back, it is still counted.
+    if (worker != nullptr) {
+      worker->AddToInbox(self, task);
+    } else if (threads_.empty()) {
+      MutexLock mu(self, task_queue_lock_);
+      tasks_.push_front(task);
+    } else {
+      threads_[0]->AddToInbox(self, task);
+    }
+    return nullptr;
+  }
+  task_count_.FetchAndSubSequentiallyConsistent(1);
+  return task;
+}
+
+Task* ThreadPool::StealTask(Thread* self, ThreadPoolWorker* worker) {
+  const size_t thread_count = GetThreadCount();
+  // Start from a random victim, so that thieves do not all contend on the same worker.
+  const size_t start = (worker != nullptr)
+      ? worker->NextRandom() % thread_count
+      : next_worker_.FetchAndAddSequentiallyConsistent(1) % thread_count;
+  for (size_t i = 0; i != thread_count; ++i) {
+    ThreadPoolWorker* victim = threads_[(start + i) % thread_count];
+    if (victim == worker) {
+      continue;
+    }
+    Task* task = victim->deque_.Steal();
+    if (task == nullptr) {
+      task = victim->TakeFromInbox(self);
+    }
+    if (task != nullptr) {
+      return task;
+    }
   }
   return nullptr;
 }
@@ -195,7 +356,8 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
   }
   // Wait until each thread is waiting and the task list is empty.
   MutexLock mu(self, task_queue_lock_);
-  while (!shutting_down_ && (waiting_count_ != GetThreadCount() || !tasks_.empty())) {
+  while (!shutting_down_ &&
+         (waiting_count_ != GetThreadCount() || task_count_.LoadSequentiallyConsistent() != 0)) {
     if (!may_hold_locks) {
       completion_condition_.Wait(self);
     } else {
@@ -204,9 +366,8 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
   }
 }
 
-size_t ThreadPool::GetTaskCount(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  return tasks_.size();
+size_t ThreadPool::GetTaskCount(Thread* self ATTRIBUTE_UNUSED) {
+  return task_count_.LoadSequentiallyConsistent();
 }
 
 }  // namespace art
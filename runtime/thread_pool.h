@@ -17,11 +17,15 @@
 #ifndef ART_RUNTIME_THREAD_POOL_H_
 #define ART_RUNTIME_THREAD_POOL_H_
 
+#include <pthread.h>
+
 #include <deque>
 #include <vector>
 
+#include "atomic.h"
 #include "barrier.h"
 #include "base/mutex.h"
+#include "base/work_stealing_deque.h"
 #include "mem_map.h"
 
 namespace art {
@@ -48,6 +52,9 @@ class SelfDeletingTask : public Task {
   }
 };
 
+// A worker of a thread pool. Each worker has a work stealing deque for the tasks it adds itself,
+// and an inbox for the tasks added by other threads. It runs the tasks of its deque, then those of
+// its inbox, then steals from the other workers when it runs out of work.
 class ThreadPoolWorker {
  public:
   static const size_t kDefaultStackSize = 1 * MB;
@@ -60,17 +67,40 @@ class ThreadPoolWorker {
   virtual ~ThreadPoolWorker();
 
  protected:
-  ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name, size_t stack_size);
+  ThreadPoolWorker(ThreadPool* thread_pool,
+                   const std::string& name,
+                   size_t index,
+                   size_t stack_size);
   static void* Callback(void* arg) REQUIRES(!Locks::mutator_lock_);
   virtual void Run();
 
   ThreadPool* const thread_pool_;
   const std::string name_;
+  // Index of the worker in the thread pool.
+  const size_t index_;
   std::unique_ptr<MemMap> stack_;
   pthread_t pthread_;
 
  private:
   friend class ThreadPool;
+
+  void AddToInbox(Thread* self, Task* task) REQUIRES(!inbox_lock_);
+  Task* TakeFromInbox(Thread* self) REQUIRES(!inbox_lock_);
+
+  // Returns a pseudo random number, used to pick the workers to steal from. Only called by the
+  // worker itself.
+  uint32_t NextRandom();
+
+  // Tasks added by the worker itself. It pops them in LIFO order, other threads steal them in
+  // FIFO order.
+  WorkStealingDeque<Task> deque_;
+  // Tasks added by other threads, which cannot push to `deque_`.
+  Mutex inbox_lock_;
+  std::deque<Task*> inbox_ GUARDED_BY(inbox_lock_);
+  // Size of `inbox_`, to skip empty inboxes without taking the lock.
+  Atomic<size_t> inbox_size_;
+  uint32_t random_state_;
+
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolWorker);
 };
 
@@ -88,15 +118,21 @@ class ThreadPool {
   void StopWorkers(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Add a new task, the first available started worker will process it. Does not delete the task
-  // after running it, it is the caller's responsibility.
+  // after running it, it is the caller's responsibility. A task added by a worker of the pool goes
+  // to the deque of that worker, other tasks are spread over the workers.
   void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
 
+  // Add a new task to be preferably run by the worker `affinity` modulo the thread count. Other
+  // workers may still steal it.
+  void AddTask(Thread* self, Task* task, size_t affinity) REQUIRES(!task_queue_lock_);
+
   ThreadPool(const char* name, size_t num_threads);
   virtual ~ThreadPool();
 
   // Wait for all tasks currently on queue to get completed.
   void Wait(Thread* self, bool do_work, bool may_hold_locks) REQUIRES(!task_queue_lock_);
 
+  // Returns the number of tasks added and not taken by a thread yet.
   size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Returns the total amount of workers waited for tasks.
@@ -114,7 +150,7 @@ class ThreadPool {
 
   // Try to get a task, returning null if there is none available.
   Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
-  Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
+  Task* TryGetTask(Thread* self, ThreadPoolWorker* worker) REQUIRES(!task_queue_lock_);
 
   // Are we shutting down?
   bool IsShuttingDown() const REQUIRES(task_queue_lock_) {
@@ -125,22 +161,47 @@ class ThreadPool {
   Mutex task_queue_lock_;
   ConditionVariable task_queue_condition_ GUARDED_BY(task_queue_lock_);
   ConditionVariable completion_condition_ GUARDED_BY(task_queue_lock_);
-  volatile bool started_ GUARDED_BY(task_queue_lock_);
+  // Written with `task_queue_lock_` held, read without it by the workers looking for tasks.
+  Atomic<bool> started_;
   volatile bool shutting_down_ GUARDED_BY(task_queue_lock_);
   // How many worker threads are waiting on the condition.
   volatile size_t waiting_count_ GUARDED_BY(task_queue_lock_);
+  // How many of the waiting workers are active, and need a signal when a task is added.
+  Atomic<size_t> sleeping_count_;
+  // Number of tasks added and not taken yet. Incremented before a task is pushed, so that a worker
+  // about to wait sees it.
+  Atomic<size_t> task_count_;
+  // Tasks of a pool without worker, only run by the threads calling Wait.
   std::deque<Task*> tasks_ GUARDED_BY(task_queue_lock_);
   // TODO: make this immutable/const?
   std::vector<ThreadPoolWorker*> threads_;
+  // Key of the thread local pointing to the worker of this pool that the current thread is.
+  pthread_key_t worker_key_;
+  // Next worker to add a task from a thread outside of the pool to.
+  Atomic<size_t> next_worker_;
   // Work balance detection.
   uint64_t start_time_ GUARDED_BY(task_queue_lock_);
   uint64_t total_wait_time_;
   Barrier creation_barier_;
-  size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
+  // Written with `task_queue_lock_` held. Workers with a higher index do not run tasks.
+  Atomic<size_t> max_active_workers_;
 
  private:
   friend class ThreadPoolWorker;
-  friend class WorkStealingWorker;
+
+  // Returns the worker of this pool running on the current thread, or null.
+  ThreadPoolWorker* GetCurrentWorker() const;
+
+  bool IsActive(ThreadPoolWorker* worker) const {
+    return worker->index_ < max_active_workers_.LoadRelaxed();
+  }
+
+  // Steal a task from the deque or the inbox of a worker other than `worker`.
+  Task* StealTask(Thread* self, ThreadPoolWorker* worker) REQUIRES(!task_queue_lock_);
+
+  // Wake up a waiting worker, if any, after adding a task.
+  void SignalWorkers(Thread* self) REQUIRES(!task_queue_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
@@ -17,8 +17,10 @@
 #include "thread_pool.h"
 
 #include <string>
+#include <vector>
 
 #include "atomic.h"
+#include "base/time_utils.h"
 #include "common_runtime_test.h"
 #include "thread-inl.h"
 
@@ -136,4 +138,143 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.LoadSequentiallyConsistent());
 }
 
+// Check that tasks added with an affinity hint all run, whatever the hint.
+TEST_F(ThreadPoolTest, AffinityTest) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 16;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&count), i * 3);
+  }
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+  EXPECT_EQ(0u, thread_pool.GetTaskCount(self));
+}
+
+// Check that the thread calling Wait runs the tasks when no worker is active, as the GC does when
+// it uses all the threads of the pool but one, plus itself.
+TEST_F(ThreadPoolTest, NoActiveWorker) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Thread pool test thread pool", 1);
+  thread_pool.SetMaxActiveWorkers(0);
+  AtomicInteger count(0);
+  static const int depth = 8;
+  thread_pool.AddTask(self, new TreeTask(&thread_pool, &count, depth));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ((1 << depth) - 1, count.LoadSequentiallyConsistent());
+}
+
+// Marks its node of a complete binary tree as run, after adding the tasks of its two children.
+// Node n has children 2n and 2n + 1, the root is node 1.
+class NodeTask : public Task {
+ public:
+  NodeTask(ThreadPool* const thread_pool, AtomicInteger* runs, size_t num_nodes, size_t node)
+      : thread_pool_(thread_pool),
+        runs_(runs),
+        num_nodes_(num_nodes),
+        node_(node) {}
+
+  void Run(Thread* self) {
+    if (2 * node_ < num_nodes_) {
+      thread_pool_->AddTask(self, new NodeTask(thread_pool_, runs_, num_nodes_, 2 * node_));
+      thread_pool_->AddTask(self, new NodeTask(thread_pool_, runs_, num_nodes_, 2 * node_ + 1));
+    }
+    ++runs_[node_];
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+ private:
+  ThreadPool* const thread_pool_;
+  AtomicInteger* const runs_;
+  const size_t num_nodes_;
+  const size_t node_;
+};
+
+// Check that every task runs exactly once when the workers steal the tasks that the others add,
+// with tasks added both from outside the pool and by the workers themselves.
+TEST_F(ThreadPoolTest, StealingTest) {
+  Thread* self = Thread::Current();
+  static const size_t num_trees = 4;
+  static const size_t num_nodes = 1 << 8;
+  for (size_t threads : { 1, 2, 8 }) {
+    ThreadPool thread_pool("Thread pool test thread pool", threads);
+    std::vector<AtomicInteger> runs(num_trees * num_nodes);
+    for (size_t tree = 0; tree < num_trees; ++tree) {
+      thread_pool.AddTask(self, new NodeTask(&thread_pool, &runs[tree * num_nodes], num_nodes, 1));
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, true, false);
+    for (size_t i = 0; i < runs.size(); ++i) {
+      // Node 0 of each tree is unused.
+      EXPECT_EQ(i % num_nodes == 0 ? 0 : 1, runs[i].LoadSequentiallyConsistent())
+          << threads << " threads, node " << i;
+    }
+  }
+}
+
+class BusyTreeTask : public Task {
+ public:
+  BusyTreeTask(ThreadPool* const thread_pool, AtomicInteger* count, int depth)
+      : thread_pool_(thread_pool),
+        count_(count),
+        depth_(depth) {}
+
+  void Run(Thread* self) {
+    if (depth_ > 1) {
+      thread_pool_->AddTask(self, new BusyTreeTask(thread_pool_, count_, depth_ - 1));
+      thread_pool_->AddTask(self, new BusyTreeTask(thread_pool_, count_, depth_ - 1));
+    }
+    // Do a few microseconds of work, the size of small compilation or marking tasks.
+    volatile uint32_t value = depth_;
+    for (size_t i = 0; i < 1000; ++i) {
+      value = value * 1103515245u + 12345u;
+    }
+    ++*count_;
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+ private:
+  ThreadPool* const thread_pool_;
+  AtomicInteger* const count_;
+  const int depth_;
+};
+
+// Benchmark of many small tasks, which used to contend on the single task queue of the pool. Logs
+// the time taken by the same work for thread counts from 1 to 64, and the speedup over a single
+// thread. Too slow for the unit tests, run it with --gtest_also_run_disabled_tests.
+TEST_F(ThreadPoolTest, DISABLED_Scaling) {
+  Thread* self = Thread::Current();
+  static const int num_trees = 64;
+  static const int depth = 12;
+  uint64_t single_thread_ns = 0;
+  for (size_t threads = 1; threads <= 64; threads *= 2) {
+    ThreadPool thread_pool("Thread pool test thread pool", threads);
+    AtomicInteger count(0);
+    const uint64_t start = NanoTime();
+    // The workers add most of the tasks themselves.
+    for (int i = 0; i < num_trees; ++i) {
+      thread_pool.AddTask(self, new BusyTreeTask(&thread_pool, &count, depth));
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, false, false);
+    const uint64_t duration_ns = NanoTime() - start;
+    if (threads == 1) {
+      single_thread_ns = duration_ns;
+    }
+    LOG(INFO) << "Thread pool scaling: " << threads << " threads took "
+              << PrettyDuration(duration_ns) << ", speedup "
+              << static_cast<double>(single_thread_ns) / duration_ns;
+    EXPECT_EQ(num_trees * ((1 << depth) - 1), count.LoadSequentiallyConsistent());
+  }
+}
+
 }  // namespace art
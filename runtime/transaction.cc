@@ -186,7 +186,6 @@ void Transaction::RecordWeakStringRemoval(mirror::String* s) {
 }
 
 void Transaction::LogInternedString(const InternStringLog& log) {
-  Locks::intern_table_lock_->AssertExclusiveHeld(Thread::Current());
   MutexLock mu(Thread::Current(), log_lock_);
   intern_string_logs_.push_front(log);
 }
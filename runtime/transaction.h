@@ -83,16 +83,12 @@ class Transaction FINAL {
 
   // Record intern string table changes.
   void RecordStrongStringInsertion(mirror::String* s)
-      REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
   void RecordWeakStringInsertion(mirror::String* s)
-      REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
   void RecordStrongStringRemoval(mirror::String* s)
-      REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
   void RecordWeakStringRemoval(mirror::String* s)
-      REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
 
   // Abort transaction by undoing all recorded changes.
@@ -193,7 +189,6 @@ class Transaction FINAL {
   };
 
   void LogInternedString(const InternStringLog& log)
-      REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
 
   void UndoObjectModifications()
@@ -16,6 +16,8 @@
 
 #include "utf.h"
 
+#include <string.h>
+
 #include "base/logging.h"
 #include "mirror/array.h"
 #include "mirror/object-inl.h"
@@ -65,8 +67,46 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, const char* utf8_data_
   }
 }
 
+// Strings are mostly ASCII, and the chars in [1, 0x7f] take one byte each in modified
+// UTF-8. Four such chars are checked and narrowed at a time with 64-bit operations.
+static constexpr size_t kAsciiBlockChars = sizeof(uint64_t) / sizeof(uint16_t);
+
+static inline uint64_t LoadAsciiBlock(const uint16_t* chars) {
+  uint64_t block;
+  memcpy(&block, chars, sizeof(block));
+  return block;
+}
+
+// Returns whether all four chars of `block` are in [1, 0x7f]. Adding 0x7fff to a char
+// below 0x80 sets its top bit unless the char is zero, and cannot carry into the next one.
+static inline bool IsAsciiBlock(uint64_t block) {
+  return (block & UINT64_C(0xff80ff80ff80ff80)) == 0u &&
+      ((block + UINT64_C(0x7fff7fff7fff7fff)) & UINT64_C(0x8000800080008000)) ==
+          UINT64_C(0x8000800080008000);
+}
+
+// Writes the low bytes of the four chars of an ASCII block, keeping their order in memory.
+static inline void StoreAsciiBlock(char* utf8_out, uint64_t block) {
+  const uint32_t bytes = static_cast<uint32_t>((block & UINT64_C(0xff)) |
+                                               ((block >> 8) & UINT64_C(0xff00)) |
+                                               ((block >> 16) & UINT64_C(0xff0000)) |
+                                               ((block >> 24) & UINT64_C(0xff000000)));
+  memcpy(utf8_out, &bytes, sizeof(bytes));
+}
+
 void ConvertUtf16ToModifiedUtf8(char* utf8_out, const uint16_t* utf16_in, size_t char_count) {
-  while (char_count--) {
+  while (char_count != 0u) {
+    if (char_count >= kAsciiBlockChars) {
+      const uint64_t block = LoadAsciiBlock(utf16_in);
+      if (IsAsciiBlock(block)) {
+        StoreAsciiBlock(utf8_out, block);
+        utf8_out += kAsciiBlockChars;
+        utf16_in += kAsciiBlockChars;
+        char_count -= kAsciiBlockChars;
+        continue;
+      }
+    }
+    --char_count;
     const uint16_t ch = *utf16_in++;
     if (ch > 0 && ch <= 0x7f) {
       *utf8_out++ = ch;
@@ -161,7 +201,14 @@ int CompareModifiedUtf8ToUtf16AsCodePointValues(const char* utf8, const uint16_t
 
 size_t CountUtf8Bytes(const uint16_t* chars, size_t char_count) {
   size_t result = 0;
-  while (char_count--) {
+  while (char_count != 0u) {
+    if (char_count >= kAsciiBlockChars && IsAsciiBlock(LoadAsciiBlock(chars))) {
+      result += kAsciiBlockChars;
+      chars += kAsciiBlockChars;
+      char_count -= kAsciiBlockChars;
+      continue;
+    }
+    --char_count;
     const uint16_t ch = *chars++;
     if (ch > 0 && ch <= 0x7f) {
       ++result;
@@ -160,4 +160,41 @@ TEST_F(UtfTest, CountAndConvertUtf8Bytes_UnpairedSurrogate) {
   AssertConversion({ 'h', 0xdc00, 0xdc00, 'e' }, { 'h', 0xed, 0xb0, 0x80, 0xed, 0xb0, 0x80, 'e' });
 }
 
+TEST_F(UtfTest, CountAndConvertUtf8Bytes_AsciiBlocks) {
+  // Runs of ASCII are converted four chars at a time, check every position of the chars
+  // that are not in a block of their own: zero, two and three byte chars and surrogates.
+  const std::vector<std::pair<std::vector<uint16_t>, std::vector<uint8_t>>> specials = {
+    { { 0x0000 }, { 0xc0, 0x80 } },
+    { { 0x0080 }, { 0xc2, 0x80 } },
+    { { 0x0101 }, { 0xc4, 0x81 } },
+    { { 0xff01 }, { 0xef, 0xbc, 0x81 } },
+    { { 0xd801, 0xdc00 }, { 0xf0, 0x90, 0x90, 0x80 } },
+    { { 0xd801 }, { 0xed, 0xa0, 0x81 } },
+  };
+  for (const auto& special : specials) {
+    for (size_t length = 0; length != 12; ++length) {
+      for (size_t position = 0; position <= length; ++position) {
+        std::vector<uint16_t> input;
+        std::vector<uint8_t> expected;
+        for (size_t i = 0; i != length; ++i) {
+          if (i == position) {
+            input.insert(input.end(), special.first.begin(), special.first.end());
+            expected.insert(expected.end(), special.second.begin(), special.second.end());
+          }
+          input.push_back('a' + i);
+          expected.push_back('a' + i);
+        }
+        if (position == length) {
+          input.insert(input.end(), special.first.begin(), special.first.end());
+          expected.insert(expected.end(), special.second.begin(), special.second.end());
+        }
+        AssertConversion(input, expected);
+      }
+    }
+  }
+  // Only ASCII, including 0x7f, the largest one byte char.
+  AssertConversion({ 0x7f, 0x01, 'a', 'b', 'c', 'd', 'e', 0x7f, 0x7e },
+                   { 0x7f, 0x01, 'a', 'b', 'c', 'd', 'e', 0x7f, 0x7e });
+}
+
 }  // namespace art
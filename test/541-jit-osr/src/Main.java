@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Each method below is called once and spends its time in a single loop, which
+// the JIT can only speed up by replacing the interpreter frame with compiled code
+// while the loop runs. The results must not depend on where that happens.
+public class Main {
+  static final int ITERATIONS = 1000000;
+
+  public static void main(String[] args) {
+    System.out.println("int: " + intLoop());
+    System.out.println("long: " + longLoop());
+    System.out.println("float: " + floatLoop());
+    System.out.println("double: " + doubleLoop());
+    System.out.println("nested: " + nestedLoop());
+    System.out.println("reference: " + referenceLoop(new Counter()));
+    System.out.println("array: " + arrayLoop(new int[ITERATIONS]));
+    System.out.println("exception: " + exceptionLoop());
+  }
+
+  public static int intLoop() {
+    int sum = 0;
+    for (int i = 0; i < ITERATIONS; i++) {
+      sum += i;
+    }
+    return sum;
+  }
+
+  public static long longLoop() {
+    long sum = 0;
+    for (int i = 0; i < ITERATIONS; i++) {
+      sum += i;
+    }
+    return sum;
+  }
+
+  public static float floatLoop() {
+    float sum = 0.0f;
+    // `one` holds the same constant for the whole loop.
+    float one = 1.0f;
+    for (int i = 0; i < ITERATIONS; i++) {
+      sum += one;
+    }
+    return sum;
+  }
+
+  public static double doubleLoop() {
+    double sum = 0.0;
+    for (int i = 0; i < ITERATIONS; i++) {
+      sum += (double) i;
+    }
+    return sum;
+  }
+
+  public static int nestedLoop() {
+    int sum = 0;
+    for (int i = 0; i < 1000; i++) {
+      for (int j = 0; j < 1000; j++) {
+        sum += j % 10;
+      }
+    }
+    return sum;
+  }
+
+  public static int referenceLoop(Counter counter) {
+    for (int i = 0; i < ITERATIONS; i++) {
+      counter.increment();
+    }
+    return counter.value;
+  }
+
+  public static long arrayLoop(int[] array) {
+    for (int i = 0; i < array.length; i++) {
+      array[i] = i;
+    }
+    long sum = 0;
+    for (int i = 0; i < array.length; i++) {
+      sum += array[i];
+    }
+    return sum;
+  }
+
+  public static String exceptionLoop() {
+    int[] array = new int[ITERATIONS - 1];
+    int i = 0;
+    try {
+      for (i = 0; i < ITERATIONS; i++) {
+        array[i] = i;
+      }
+    } catch (ArrayIndexOutOfBoundsException e) {
+      return "caught at " + i;
+    }
+    return "not caught";
+  }
+
+  static class Counter {
+    int value;
+
+    void increment() {
+      value++;
+    }
+  }
+}
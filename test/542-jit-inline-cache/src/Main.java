@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+interface Shape {
+  int area();
+
+  // Returns whether this call was inlined into compiled code.
+  boolean isInlined();
+}
+
+abstract class Quad implements Shape {
+  Quad(int side) {
+    this.side = side;
+  }
+
+  public int area() {
+    return side * side;
+  }
+
+  public boolean isInlined() {
+    return Main.isCallerInlined();
+  }
+
+  int side;
+}
+
+class Square extends Quad {
+  Square(int side) {
+    super(side);
+  }
+}
+
+class Tile extends Quad {
+  Tile(int side) {
+    super(side);
+  }
+}
+
+class Dot implements Shape {
+  public int area() {
+    return 7;
+  }
+
+  public boolean isInlined() {
+    return Main.isCallerInlined();
+  }
+}
+
+// Never seen by the interpreter.
+class Circle implements Shape {
+  public int area() {
+    return 3;
+  }
+
+  public boolean isInlined() {
+    return Main.isCallerInlined();
+  }
+}
+
+// The calls to Shape below are interface calls whose receiver type cannot be known
+// statically. Once the JIT has compiled them using the types seen by the interpreter,
+// the results must not change, including when a new type shows up.
+public class Main {
+  static final int WARMUP = 10;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+
+    // One target for all the receivers.
+    Shape[] squares = new Shape[100];
+    for (int i = 0; i < squares.length; ++i) {
+      squares[i] = new Square(2);
+    }
+    // Two classes with the same target, and a third one with another target.
+    Shape[] mixed = new Shape[99];
+    for (int i = 0; i < mixed.length; ++i) {
+      mixed[i] = (i % 3 == 0) ? new Square(2) : ((i % 3 == 1) ? new Tile(3) : new Dot());
+    }
+
+    int expectedMonomorphic = sumMonomorphic(squares);
+    int expectedPolymorphic = sumPolymorphic(mixed);
+    for (int i = 0; i < WARMUP; ++i) {
+      sumMonomorphic(squares);
+      sumPolymorphic(mixed);
+      countInlinedMonomorphic(squares);
+      countInlinedPolymorphic(mixed);
+    }
+    boolean compiled = jitCompile("sumMonomorphic")
+        & jitCompile("sumPolymorphic")
+        & jitCompile("countInlinedMonomorphic")
+        & jitCompile("countInlinedPolymorphic");
+
+    assertEquals(expectedMonomorphic, sumMonomorphic(squares));
+    System.out.println("monomorphic: " + expectedMonomorphic);
+    assertEquals(expectedPolymorphic, sumPolymorphic(mixed));
+    System.out.println("polymorphic: " + expectedPolymorphic);
+    if (compiled) {
+      assertEquals(squares.length, countInlinedMonomorphic(squares));
+      assertEquals(mixed.length, countInlinedPolymorphic(mixed));
+    }
+
+    // A receiver type not seen by the interpreter fails the type checks and takes the
+    // interface call. The other receivers keep running the inlined code, in the same
+    // compiled code.
+    squares[0] = new Dot();
+    System.out.println("new receiver type: " + sumMonomorphic(squares));
+    if (compiled) {
+      assertEquals(squares.length - 1, countInlinedMonomorphic(squares));
+      Shape[] seen = new Shape[] { new Tile(1), new Dot(), new Square(1), new Tile(1) };
+      assertEquals(seen.length, countInlinedPolymorphic(seen));
+      Shape[] unseen = new Shape[] { new Square(1), new Circle(), new Tile(1) };
+      assertEquals(unseen.length - 1, countInlinedPolymorphic(unseen));
+    }
+  }
+
+  static boolean jitCompile(String name) throws Exception {
+    Method method = Main.class.getDeclaredMethod(name, Shape[].class);
+    return ensureJitCompiled(method);
+  }
+
+  static void assertEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected " + expected + ", got " + result);
+    }
+  }
+
+  static int sumMonomorphic(Shape[] shapes) {
+    int sum = 0;
+    for (Shape shape : shapes) {
+      sum += shape.area();
+    }
+    return sum;
+  }
+
+  static int sumPolymorphic(Shape[] shapes) {
+    int sum = 0;
+    for (Shape shape : shapes) {
+      sum += shape.area();
+    }
+    return sum;
+  }
+
+  static int countInlinedMonomorphic(Shape[] shapes) {
+    int count = 0;
+    for (Shape shape : shapes) {
+      if (shape.isInlined()) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  static int countInlinedPolymorphic(Shape[] shapes) {
+    int count = 0;
+    for (Shape shape : shapes) {
+      if (shape.isInlined()) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  static native boolean ensureJitCompiled(Method method);
+  static native boolean isCallerInlined();
+}
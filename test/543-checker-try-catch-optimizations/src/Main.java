@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  public static int abs(int a) {
+    return (a < 0) ? -a : a;
+  }
+
+  public static int divide(int a, int b) {
+    return a / b;
+  }
+
+  /// CHECK-START: int Main.inlineInTry(int) inliner (before)
+  /// CHECK-DAG:                      InvokeStaticOrDirect
+
+  /// CHECK-START: int Main.inlineInTry(int) inliner (after)
+  /// CHECK-NOT:                      InvokeStaticOrDirect
+
+  public static int inlineInTry(int a) {
+    try {
+      return abs(a) + divide(100, a);
+    } catch (ArithmeticException e) {
+      return -1;
+    }
+  }
+
+  /// CHECK-START: int Main.arrayLengthInTry(int[]) licm (before)
+  /// CHECK-DAG: <<NullCheck:l\d+>> NullCheck loop:{{B\d+}}
+  /// CHECK-DAG:                    ArrayLength [<<NullCheck>>] loop:{{B\d+}}
+
+  /// CHECK-START: int Main.arrayLengthInTry(int[]) licm (after)
+  /// CHECK-NOT:                    NullCheck loop:{{B\d+}}
+  /// CHECK-NOT:                    ArrayLength loop:{{B\d+}}
+
+  /// CHECK-START: int Main.arrayLengthInTry(int[]) licm (after)
+  /// CHECK-DAG: <<NullCheck:l\d+>> NullCheck loop:none
+  /// CHECK-DAG:                    ArrayLength [<<NullCheck>>] loop:none
+
+  public static int arrayLengthInTry(int[] array) {
+    int result = 0;
+    try {
+      for (int i = 0; i < array.length; ++i) {
+        result += array[i];
+      }
+    } catch (NullPointerException e) {
+      // The hoisted null check must still throw into this handler, with
+      // the value `result` has before the loop.
+      return result - 1;
+    }
+    return result;
+  }
+
+  /// CHECK-START: int Main.linearInTry(int[]) BCE (before)
+  /// CHECK-DAG: BoundsCheck
+
+  /// CHECK-START: int Main.linearInTry(int[]) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+
+  public static int linearInTry(int[] x) {
+    int result = 0;
+    try {
+      for (int i = 0; i < x.length; i++) {
+        result += x[i] / sDivisor;
+      }
+    } catch (ArithmeticException e) {
+      return -result;
+    }
+    return result;
+  }
+
+  /// CHECK-START: boolean Main.greaterThanInTry(int[], int) boolean_simplifier (before)
+  /// CHECK-DAG:     <<Const0:i\d+>>   IntConstant 0
+  /// CHECK-DAG:     <<Const1:i\d+>>   IntConstant 1
+  /// CHECK-DAG:     <<Cond:z\d+>>     GreaterThan
+  /// CHECK-DAG:                       If [<<Cond>>]
+  /// CHECK-DAG:     <<Phi:i\d+>>      Phi [<<Const0>>,<<Const1>>]
+  /// CHECK-DAG:                       Return [<<Phi>>]
+
+  /// CHECK-START: boolean Main.greaterThanInTry(int[], int) boolean_simplifier (after)
+  /// CHECK-DAG:     <<Cond:z\d+>>     GreaterThan
+  /// CHECK-DAG:                       Return [<<Cond>>]
+
+  public static boolean greaterThanInTry(int[] array, int y) {
+    try {
+      return (array[0] <= y) ? false : true;
+    } catch (ArrayIndexOutOfBoundsException e) {
+      return false;
+    }
+  }
+
+  public static int sDivisor = 1;
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static void assertEquals(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static void main(String[] args) {
+    assertEquals(25, inlineInTry(5));
+    assertEquals(-15, inlineInTry(-5));
+    assertEquals(-1, inlineInTry(0));
+
+    assertEquals(12, arrayLengthInTry(new int[] { 4, 8 }));
+    assertEquals(-1, arrayLengthInTry(null));
+
+    assertEquals(12, linearInTry(new int[] { 4, 8 }));
+    sDivisor = 0;
+    assertEquals(0, linearInTry(new int[] { 4, 8 }));
+    sDivisor = 1;
+
+    assertEquals(true, greaterThanInTry(new int[] { 2 }, 1));
+    assertEquals(false, greaterThanInTry(new int[] { 1 }, 1));
+    assertEquals(false, greaterThanInTry(new int[0], 1));
+  }
+}
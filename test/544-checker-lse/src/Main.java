@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Circle {
+  Circle(double radius) {
+    this.radius = radius;
+  }
+  public double getArea() {
+    return radius * radius * Math.PI;
+  }
+  private double radius;
+}
+
+class TestClass {
+  TestClass() {
+  }
+  TestClass(int i, int j) {
+    this.i = i;
+    this.j = j;
+  }
+  int i;
+  int j;
+  volatile int k;
+  TestClass next;
+}
+
+class Finalizable {
+  static final int VALUE = 0xbeef;
+  int i;
+
+  protected void finalize() {
+    if (i != VALUE) {
+      System.out.println("Where is the beef?");
+    }
+  }
+}
+
+public class Main {
+
+  /// CHECK-START: double Main.calcCircleArea(double) load_store_elimination (before)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: double Main.calcCircleArea(double) load_store_elimination (after)
+  /// CHECK-NOT: NewInstance
+  /// CHECK-NOT: InstanceFieldSet
+  /// CHECK-NOT: InstanceFieldGet
+
+  static double calcCircleArea(double radius) {
+    return new Circle(radius).getArea();
+  }
+
+  /// CHECK-START: int Main.test1(TestClass, TestClass) load_store_elimination (before)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test1(TestClass, TestClass) load_store_elimination (after)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldSet
+  /// CHECK-NOT: NullCheck
+  /// CHECK-NOT: InstanceFieldGet
+
+  // Different fields shouldn't alias.
+  static int test1(TestClass obj1, TestClass obj2) {
+    obj1.i = 1;
+    obj2.j = 2;
+    return obj1.i + obj2.j;
+  }
+
+  /// CHECK-START: int Main.test2(TestClass) load_store_elimination (before)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test2(TestClass) load_store_elimination (after)
+  /// CHECK: InstanceFieldSet
+  /// CHECK-NOT: InstanceFieldSet
+  /// CHECK-NOT: NullCheck
+  /// CHECK-NOT: InstanceFieldGet
+
+  // Redundant store of the same value.
+  static int test2(TestClass obj) {
+    obj.j = 1;
+    obj.j = 1;
+    return obj.j;
+  }
+
+  /// CHECK-START: int Main.test3(TestClass) load_store_elimination (before)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InvokeStaticOrDirect
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test3(TestClass) load_store_elimination (after)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InvokeStaticOrDirect
+  /// CHECK: InstanceFieldGet
+
+  // An invocation kills the values of the fields of non-singletons.
+  static int test3(TestClass obj) {
+    obj.i = 1;
+    $noinline$clobber(obj);
+    return obj.i;
+  }
+
+  /// CHECK-START: int Main.test4(TestClass, boolean) load_store_elimination (before)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+  /// CHECK: Return
+  /// CHECK: InstanceFieldSet
+
+  /// CHECK-START: int Main.test4(TestClass, boolean) load_store_elimination (after)
+  /// CHECK: InstanceFieldSet
+  /// CHECK-NOT: NullCheck
+  /// CHECK-NOT: InstanceFieldGet
+  /// CHECK: Return
+  /// CHECK: InstanceFieldSet
+
+  // Set and get the same field in the same block.
+  static int test4(TestClass obj, boolean b) {
+    if (b) {
+      obj.i = 1;
+      return obj.i;
+    }
+    obj.i = 2;
+    return 0;
+  }
+
+  /// CHECK-START: int Main.test5(TestClass, boolean) load_store_elimination (before)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test5(TestClass, boolean) load_store_elimination (after)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  // Different values flow into the load from the two branches.
+  static int test5(TestClass obj, boolean b) {
+    if (b) {
+      obj.i = 1;
+    } else {
+      obj.i = 2;
+    }
+    return obj.i;
+  }
+
+  /// CHECK-START: int Main.test6() load_store_elimination (before)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test6() load_store_elimination (after)
+  /// CHECK-NOT: NewInstance
+  /// CHECK-NOT: InstanceFieldSet
+  /// CHECK-NOT: InstanceFieldGet
+
+  // A non-escaping allocation: the default value of a field is forwarded,
+  // and the allocation goes away.
+  static int test6() {
+    TestClass obj = new TestClass();
+    obj.i = obj.j + 1;
+    return obj.i;
+  }
+
+  /// CHECK-START: int Main.test7(TestClass) load_store_elimination (before)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test7(TestClass) load_store_elimination (after)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  // The allocation escapes into the heap, so nothing is removed.
+  static int test7(TestClass obj) {
+    TestClass obj2 = new TestClass();
+    obj.next = obj2;
+    $noinline$clobber(obj);
+    return obj2.i;
+  }
+
+  /// CHECK-START: int Main.test8() load_store_elimination (before)
+  /// CHECK: NewInstance
+  /// CHECK: Phi
+  /// CHECK: InstanceFieldGet
+  /// CHECK: InstanceFieldSet
+
+  /// CHECK-START: int Main.test8() load_store_elimination (after)
+  /// CHECK: NewInstance
+  /// CHECK: Phi
+  /// CHECK: InstanceFieldGet
+  /// CHECK: InstanceFieldSet
+
+  // The field is stored into inside the loop, its value at the loop header is
+  // not known.
+  static int test8() {
+    TestClass obj = new TestClass();
+    int sum = 0;
+    for (int i = 0; i < 3; i++) {
+      sum += obj.i;
+      obj.i = i;
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.test9() load_store_elimination (before)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test9() load_store_elimination (after)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+  /// CHECK-NOT: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+  /// CHECK-NOT: InstanceFieldGet
+
+  // The volatile accesses stay. No other thread sees the singleton, so the
+  // store into and the load from its other field are still eliminated.
+  static int test9() {
+    TestClass obj = new TestClass();
+    obj.k = 1;
+    obj.i = 2;
+    return obj.i + obj.k;
+  }
+
+  /// CHECK-START: int Main.test10(TestClass) load_store_elimination (before)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+  /// CHECK: InstanceFieldGet
+  /// CHECK: InstanceFieldGet
+
+  /// CHECK-START: int Main.test10(TestClass) load_store_elimination (after)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: InstanceFieldGet
+  /// CHECK: InstanceFieldGet
+  /// CHECK-NOT: InstanceFieldGet
+
+  // The load before the volatile load is eliminated, the one after it is not:
+  // another thread may have written the field in between.
+  static int test10(TestClass obj) {
+    obj.i = 1;
+    int i = obj.i;
+    int k = obj.k;
+    return i + k + obj.i;
+  }
+
+  /// CHECK-START: int Main.test11(TestClass) load_store_elimination (after)
+  /// CHECK: InstanceFieldSet
+  /// CHECK: MonitorOperation
+  /// CHECK: InstanceFieldGet
+  /// CHECK: MonitorOperation
+
+  // The monitor operations kill the value of the field.
+  static int test11(TestClass obj) {
+    obj.i = 1;
+    synchronized (obj) {
+      return obj.i;
+    }
+  }
+
+  /// CHECK-START: void Main.testFinalizable() load_store_elimination (before)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+
+  /// CHECK-START: void Main.testFinalizable() load_store_elimination (after)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+
+  // The finalizer reads the field, neither the store nor the allocation can go.
+  static void testFinalizable() {
+    Finalizable finalizable = new Finalizable();
+    finalizable.i = Finalizable.VALUE;
+  }
+
+  /// CHECK-START: int Main.testTryCatch() load_store_elimination (after)
+  /// CHECK: NewInstance
+  /// CHECK: InstanceFieldSet
+
+  // The catch block may observe the object through the environment of the
+  // throwing instruction, so the allocation and its stores stay.
+  static int testTryCatch() {
+    TestClass obj = new TestClass(1, 2);
+    try {
+      return obj.i / $noinline$zero();
+    } catch (ArithmeticException e) {
+      return obj.j;
+    }
+  }
+
+  static void $noinline$clobber(TestClass obj) {
+    if (doThrow) { throw new Error(); }
+    obj.i = 42;
+    obj.next = null;
+  }
+
+  static int $noinline$zero() {
+    if (doThrow) { throw new Error(); }
+    return 0;
+  }
+
+  static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  static void assertDoubleEquals(double expected, double result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void main(String[] args) {
+    assertDoubleEquals(Math.PI * Math.PI * Math.PI, calcCircleArea(Math.PI));
+    assertIntEquals(3, test1(new TestClass(), new TestClass()));
+    assertIntEquals(1, test2(new TestClass()));
+    assertIntEquals(42, test3(new TestClass()));
+    assertIntEquals(1, test4(new TestClass(), true));
+    assertIntEquals(0, test4(new TestClass(), false));
+    assertIntEquals(1, test5(new TestClass(), true));
+    assertIntEquals(2, test5(new TestClass(), false));
+    assertIntEquals(1, test6());
+    assertIntEquals(0, test7(new TestClass()));
+    assertIntEquals(1, test8());
+    assertIntEquals(3, test9());
+    assertIntEquals(2, test10(new TestClass()));
+    assertIntEquals(1, test11(new TestClass()));
+    assertIntEquals(2, testTryCatch());
+
+    testFinalizable();
+    Runtime.getRuntime().gc();
+    System.runFinalization();
+  }
+
+  static boolean doThrow = false;
+}
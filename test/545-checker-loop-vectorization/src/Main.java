@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START-X86_64: void Main.addScalar(int[], int) loop_optimization (before)
+  /// CHECK-NOT: VecArrayOperation
+
+  /// CHECK-START-X86_64: void Main.addScalar(int[], int) loop_optimization (after)
+  /// CHECK:     VecArrayOperation kind:add packed_type:PrimInt
+  /// CHECK:     ArraySet
+
+  /// CHECK-START-ARM64: void Main.addScalar(int[], int) loop_optimization (after)
+  /// CHECK:     VecArrayOperation kind:add packed_type:PrimInt
+  /// CHECK:     ArraySet
+
+  // The vector loop runs first, the scalar loop does the remaining iterations.
+  static void addScalar(int[] a, int x) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += x;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.mulFloats(float[], float) loop_optimization (after)
+  /// CHECK:     VecArrayOperation kind:mul packed_type:PrimFloat
+  /// CHECK:     ArraySet
+
+  /// CHECK-START-ARM64: void Main.mulFloats(float[], float) loop_optimization (after)
+  /// CHECK:     VecArrayOperation kind:mul packed_type:PrimFloat
+  /// CHECK:     ArraySet
+
+  static void mulFloats(float[] a, float f) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = a[i] * f;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.subBytes(byte[]) loop_optimization (after)
+  /// CHECK:     VecArrayOperation kind:sub packed_type:PrimByte
+  /// CHECK:     ArraySet
+
+  /// CHECK-START-ARM64: void Main.subBytes(byte[]) loop_optimization (after)
+  /// CHECK:     VecArrayOperation kind:sub packed_type:PrimByte
+  /// CHECK:     ArraySet
+
+  // The narrow type conversion before the store is implied by the lanes.
+  static void subBytes(byte[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = (byte) (a[i] - 3);
+    }
+  }
+
+  /// CHECK-START-X86_64: int Main.sum(int[]) loop_optimization (after)
+  /// CHECK:     VecReduce kind:add
+  /// CHECK:     Add
+
+  /// CHECK-START-ARM64: int Main.sum(int[]) loop_optimization (after)
+  /// CHECK:     VecReduce kind:add
+  /// CHECK:     Add
+
+  static int sum(int[] a) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START-X86_64: long Main.xorLongs(long[]) loop_optimization (after)
+  /// CHECK:     VecReduce kind:xor
+  /// CHECK:     Xor
+
+  /// CHECK-START-ARM64: long Main.xorLongs(long[]) loop_optimization (after)
+  /// CHECK:     VecReduce kind:xor
+  /// CHECK:     Xor
+
+  static long xorLongs(long[] a) {
+    long result = 0;
+    for (int i = 0; i < a.length; i++) {
+      result ^= a[i];
+    }
+    return result;
+  }
+
+  /// CHECK-START-X86_64: void Main.mulBytes(byte[], byte[]) loop_optimization (after)
+  /// CHECK-NOT: VecArrayOperation
+
+  /// CHECK-START-ARM64: void Main.mulBytes(byte[], byte[]) loop_optimization (after)
+  /// CHECK:     VecArrayOperation kind:mul packed_type:PrimByte
+  /// CHECK:     ArraySet
+
+  // NEON multiplies bytes, SSE does not.
+  static void mulBytes(byte[] a, byte[] b) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = (byte) (a[i] * b[i]);
+    }
+  }
+
+  /// CHECK-START-ARM64: int Main.maxInts(int[]) loop_optimization (after)
+  /// CHECK:     VecReduce kind:max
+  /// CHECK:     InvokeStaticOrDirect intrinsic:MathMaxIntInt
+
+  static int maxInts(int[] a) {
+    int max = Integer.MIN_VALUE;
+    for (int i = 0; i < a.length; i++) {
+      max = Math.max(max, a[i]);
+    }
+    return max;
+  }
+
+  /// CHECK-START-X86_64: void Main.divInts(int[]) loop_optimization (after)
+  /// CHECK-NOT: VecArrayOperation
+
+  /// CHECK-START-ARM64: void Main.divInts(int[]) loop_optimization (after)
+  /// CHECK-NOT: VecArrayOperation
+
+  // There is no packed integer division.
+  static void divInts(int[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = a[i] / 3;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.shiftedStore(int[]) loop_optimization (after)
+  /// CHECK-NOT: VecArrayOperation
+
+  // The elements of an iteration depend on a previous iteration.
+  static void shiftedStore(int[] a) {
+    for (int i = 0; i < a.length - 1; i++) {
+      a[i + 1] = a[i] + 1;
+    }
+  }
+
+  /// CHECK-START-X86_64: double Main.sumDoubles(double[]) loop_optimization (after)
+  /// CHECK-NOT: VecReduce
+
+  // Reassociating the additions would change the rounding.
+  static double sumDoubles(double[] a) {
+    double sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  static void expectEquals(double expected, double result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void main(String[] args) {
+    // Cover lengths that are not a multiple of any vector length.
+    for (int n = 0; n < 37; n++) {
+      int[] ints = new int[n];
+      float[] floats = new float[n];
+      byte[] bytes = new byte[n];
+      long[] longs = new long[n];
+      double[] doubles = new double[n];
+      for (int i = 0; i < n; i++) {
+        ints[i] = i;
+        floats[i] = i;
+        bytes[i] = (byte) (i * 7);
+        longs[i] = 1L << i;
+        doubles[i] = 0.1 * i;
+      }
+
+      expectEquals(n * (n - 1) / 2, sum(ints));
+      expectEquals(n == 0 ? Integer.MIN_VALUE : n - 1, maxInts(ints));
+      addScalar(ints, 5);
+      for (int i = 0; i < n; i++) {
+        expectEquals(i + 5, ints[i]);
+      }
+
+      mulFloats(floats, 0.5f);
+      for (int i = 0; i < n; i++) {
+        expectEquals(i * 0.5f, floats[i]);
+      }
+
+      subBytes(bytes);
+      for (int i = 0; i < n; i++) {
+        expectEquals((byte) (i * 7 - 3), bytes[i]);
+      }
+
+      expectEquals((1L << n) - 1, xorLongs(longs));
+
+      byte[] factors = new byte[n];
+      for (int i = 0; i < n; i++) {
+        factors[i] = (byte) (i - 5);
+      }
+      mulBytes(factors, factors);
+      for (int i = 0; i < n; i++) {
+        expectEquals((byte) ((i - 5) * (i - 5)), factors[i]);
+      }
+
+      double expected = 0;
+      for (int i = 0; i < n; i++) {
+        expected += 0.1 * i;
+      }
+      expectEquals(expected, sumDoubles(doubles));
+
+      divInts(ints);
+      for (int i = 0; i < n; i++) {
+        expectEquals((i + 5) / 3, ints[i]);
+      }
+
+      shiftedStore(ints);
+      for (int i = 1; i < n; i++) {
+        expectEquals(((5 / 3) + i), ints[i]);
+      }
+    }
+  }
+}
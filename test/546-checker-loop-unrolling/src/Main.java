@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START: int Main.sumOfSquares(int) loop_optimization (before)
+  /// CHECK:     Mul
+  /// CHECK-NOT: Mul
+
+  /// CHECK-START: int Main.sumOfSquares(int) loop_optimization (after)
+  /// CHECK:     Mul
+  /// CHECK:     Mul
+  /// CHECK:     Mul
+  /// CHECK:     Mul
+  /// CHECK:     Mul
+  /// CHECK-NOT: Mul
+
+  // The unrolled loop runs four copies of the body per iteration, the
+  // original loop does the remaining iterations.
+  static int sumOfSquares(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += i * i;
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.sumOfSquaresOfTwo() loop_optimization (after)
+  /// CHECK:     Mul
+  /// CHECK:     Mul
+  /// CHECK:     Mul
+  /// CHECK-NOT: Mul
+
+  // The constant trip count limits the unrolling factor.
+  static int sumOfSquaresOfTwo() {
+    int sum = 0;
+    for (int i = 0; i < 2; i++) {
+      sum += i * i;
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.sumOfCalls(int) loop_optimization (after)
+  /// CHECK:     InvokeStaticOrDirect
+  /// CHECK-NOT: InvokeStaticOrDirect
+
+  // Loops with calls are left alone.
+  static int sumOfCalls(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += $noinline$square(i);
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.sumPlusLength(int[], int[]) loop_optimization (before)
+  /// CHECK-DAG: NullCheck   loop:{{B\d+}}
+  /// CHECK-DAG: ArrayLength loop:{{B\d+}}
+
+  /// CHECK-START: int Main.sumPlusLength(int[], int[]) loop_optimization (after)
+  /// CHECK-NOT: NullCheck   loop:{{B\d+}}
+  /// CHECK-NOT: ArrayLength loop:{{B\d+}}
+
+  // LICM cannot hoist the null check of `b`, the bounds check of `a[i]` may
+  // throw before it. The peeled first iteration takes it out of the loop.
+  static int sumPlusLength(int[] a, int[] b) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i] + b.length;
+    }
+    return sum;
+  }
+
+  static int $noinline$square(int i) {
+    if (doThrow) { throw new Error(); }
+    return i * i;
+  }
+
+  static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void main(String[] args) {
+    // Cover trip counts that are not a multiple of the unrolling factor.
+    for (int n = -1; n < 11; n++) {
+      int expected = 0;
+      for (int i = 0; i < n; i++) {
+        expected += i * i;
+      }
+      expectEquals(expected, sumOfSquares(n));
+      expectEquals(expected, sumOfCalls(n));
+
+      int[] a = new int[Math.max(n, 0)];
+      for (int i = 0; i < a.length; i++) {
+        a[i] = i;
+      }
+      expectEquals(n <= 0 ? 0 : n * (n - 1) / 2 + n * 3, sumPlusLength(a, new int[3]));
+    }
+    expectEquals(1, sumOfSquaresOfTwo());
+
+    // The null check is only done when the loop body is entered.
+    expectEquals(0, sumPlusLength(new int[0], null));
+    try {
+      sumPlusLength(new int[1], null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException e) {
+      // Expected.
+    }
+  }
+
+  static boolean doThrow = false;
+}
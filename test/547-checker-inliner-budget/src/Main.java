@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  // A callee too big for a call site with no known benefit, but small
+  // enough for a call site in a loop.
+  static int mix(int a, int b) {
+    a += b;
+    b ^= a;
+    a += b << 1;
+    b ^= a >>> 3;
+    a += b;
+    b ^= a << 2;
+    a += b;
+    b ^= a >>> 5;
+    return a ^ b;
+  }
+
+  /// CHECK-START: int Main.notInLoop(int, int) inliner (before)
+  /// CHECK:     InvokeStaticOrDirect
+
+  /// CHECK-START: int Main.notInLoop(int, int) inliner (after)
+  /// CHECK:     InvokeStaticOrDirect
+
+  static int notInLoop(int a, int b) {
+    return mix(a, b);
+  }
+
+  /// CHECK-START: int Main.inLoop(int, int) inliner (before)
+  /// CHECK:     InvokeStaticOrDirect
+
+  /// CHECK-START: int Main.inLoop(int, int) inliner (after)
+  /// CHECK-NOT: InvokeStaticOrDirect
+
+  static int inLoop(int a, int n) {
+    int result = a;
+    for (int i = 0; i < n; i++) {
+      result += mix(result, i);
+    }
+    return result;
+  }
+
+  public static void main(String[] args) {
+    assertIntEquals(80, notInLoop(3, 7));
+    assertIntEquals(-1737402903, inLoop(0, 100));
+  }
+
+  public static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+public class Main {
+
+  static boolean doThrow = false;
+
+  public static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void assertLongEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void assertFloatEquals(float expected, float result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void assertObjectEquals(Object expected, Object result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  /// CHECK-START: int Main.$noinline$max(int, int) select_generator (before)
+  /// CHECK:      <<A:i\d+>>   ParameterValue
+  /// CHECK:      <<B:i\d+>>   ParameterValue
+  /// CHECK:                   Phi [{{i\d+}},{{i\d+}}]
+
+  /// CHECK-START: int Main.$noinline$max(int, int) select_generator (after)
+  /// CHECK:      <<A:i\d+>>   ParameterValue
+  /// CHECK:      <<B:i\d+>>   ParameterValue
+  /// CHECK:      <<Cond:z\d+>> {{GreaterThan|LessThanOrEqual}} [<<A>>,<<B>>]
+  /// CHECK:      <<Sel:i\d+>> Select [{{i\d+}},{{i\d+}},<<Cond>>]
+  /// CHECK:                   Return [<<Sel>>]
+
+  /// CHECK-START: int Main.$noinline$max(int, int) select_generator (after)
+  /// CHECK-NOT:               Phi
+
+  /// CHECK-START-X86_64: int Main.$noinline$max(int, int) disassembly (after)
+  /// CHECK:                   cmov
+
+  /// CHECK-START-ARM64: int Main.$noinline$max(int, int) disassembly (after)
+  /// CHECK:                   csel
+
+  public static int $noinline$max(int a, int b) {
+    if (doThrow) { throw new Error(); }
+    return a > b ? a : b;
+  }
+
+  /// CHECK-START: long Main.$noinline$pickLong(boolean, long, long) select_generator (after)
+  /// CHECK:      <<Sel:j\d+>> Select
+  /// CHECK:                   Return [<<Sel>>]
+
+  /// CHECK-START: long Main.$noinline$pickLong(boolean, long, long) select_generator (after)
+  /// CHECK-NOT:               Phi
+
+  public static long $noinline$pickLong(boolean c, long x, long y) {
+    if (doThrow) { throw new Error(); }
+    return c ? x : y;
+  }
+
+  /// CHECK-START: float Main.$noinline$pickFloat(int, float, float) select_generator (after)
+  /// CHECK:      <<Sel:f\d+>> Select
+  /// CHECK:                   Return [<<Sel>>]
+
+  /// CHECK-START: float Main.$noinline$pickFloat(int, float, float) select_generator (after)
+  /// CHECK-NOT:               Phi
+
+  public static float $noinline$pickFloat(int a, float x, float y) {
+    if (doThrow) { throw new Error(); }
+    return a < 0 ? x : y;
+  }
+
+  /// CHECK-START: java.lang.Object Main.$noinline$pickObject(int, java.lang.Object, java.lang.Object) select_generator (after)
+  /// CHECK:      <<Sel:l\d+>> Select
+  /// CHECK:                   Return [<<Sel>>]
+
+  /// CHECK-START: java.lang.Object Main.$noinline$pickObject(int, java.lang.Object, java.lang.Object) select_generator (after)
+  /// CHECK-NOT:               Phi
+
+  public static Object $noinline$pickObject(int a, Object x, Object y) {
+    if (doThrow) { throw new Error(); }
+    return a == 0 ? x : y;
+  }
+
+  /// CHECK-START: int Main.$noinline$clamp(int, int, int) select_generator (after)
+  /// CHECK:                   Select
+  /// CHECK:                   Select
+
+  /// CHECK-START: int Main.$noinline$clamp(int, int, int) select_generator (after)
+  /// CHECK-NOT:               Phi
+
+  public static int $noinline$clamp(int x, int lo, int hi) {
+    if (doThrow) { throw new Error(); }
+    int y = x < lo ? lo : x;
+    return y > hi ? hi : y;
+  }
+
+  // The subtractions are hoisted above the condition, as they cannot throw.
+
+  /// CHECK-START: int Main.$noinline$absDiff(int, int) select_generator (after)
+  /// CHECK:      <<A:i\d+>>   ParameterValue
+  /// CHECK:      <<B:i\d+>>   ParameterValue
+  /// CHECK-DAG:  <<AB:i\d+>>  Sub [<<A>>,<<B>>]
+  /// CHECK-DAG:  <<BA:i\d+>>  Sub [<<B>>,<<A>>]
+  /// CHECK-DAG:  <<Sel:i\d+>> Select [{{i\d+}},{{i\d+}},{{z\d+}}]
+  /// CHECK-DAG:               Return [<<Sel>>]
+
+  /// CHECK-START: int Main.$noinline$absDiff(int, int) select_generator (after)
+  /// CHECK-NOT:               Phi
+
+  public static int $noinline$absDiff(int a, int b) {
+    if (doThrow) { throw new Error(); }
+    return a > b ? a - b : b - a;
+  }
+
+  // A division may throw and must not be hoisted above the condition.
+
+  /// CHECK-START: int Main.$noinline$safeDiv(int, int) select_generator (after)
+  /// CHECK:                   Phi
+
+  /// CHECK-START: int Main.$noinline$safeDiv(int, int) select_generator (after)
+  /// CHECK-NOT:               Select
+
+  public static int $noinline$safeDiv(int a, int b) {
+    if (doThrow) { throw new Error(); }
+    return b != 0 ? a / b : 0;
+  }
+
+  public static void main(String[] args) {
+    assertIntEquals(7, $noinline$max(7, 3));
+    assertIntEquals(7, $noinline$max(3, 7));
+    assertIntEquals(-1, $noinline$max(-1, Integer.MIN_VALUE));
+
+    assertLongEquals(1L << 40, $noinline$pickLong(true, 1L << 40, -1L));
+    assertLongEquals(-1L, $noinline$pickLong(false, 1L << 40, -1L));
+
+    assertFloatEquals(1.5f, $noinline$pickFloat(-1, 1.5f, 2.5f));
+    assertFloatEquals(2.5f, $noinline$pickFloat(1, 1.5f, 2.5f));
+
+    Object x = new Object();
+    Object y = new Object();
+    assertObjectEquals(x, $noinline$pickObject(0, x, y));
+    assertObjectEquals(y, $noinline$pickObject(1, x, y));
+    assertObjectEquals(null, $noinline$pickObject(1, x, null));
+
+    assertIntEquals(0, $noinline$clamp(-5, 0, 10));
+    assertIntEquals(10, $noinline$clamp(15, 0, 10));
+    assertIntEquals(5, $noinline$clamp(5, 0, 10));
+
+    assertIntEquals(4, $noinline$absDiff(7, 3));
+    assertIntEquals(4, $noinline$absDiff(3, 7));
+
+    assertIntEquals(3, $noinline$safeDiv(7, 2));
+    assertIntEquals(0, $noinline$safeDiv(7, 0));
+  }
+}
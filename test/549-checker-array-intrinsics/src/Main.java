@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import java.util.Arrays;
+
+public class Main {
+
+  static boolean doThrow = false;
+
+  public static void assertTrue(boolean condition) {
+    if (!condition) {
+      throw new Error("Assertion failed");
+    }
+  }
+
+  public static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$fillBytes(byte[], byte) intrinsics_recognition (after)
+  /// CHECK:                 InvokeStaticOrDirect intrinsic:ArraysFillByte
+
+  public static void $noinline$fillBytes(byte[] array, byte value) {
+    if (doThrow) { throw new Error(); }
+    Arrays.fill(array, value);
+  }
+
+  /// CHECK-START: void Main.$noinline$fillChars(char[], char) intrinsics_recognition (after)
+  /// CHECK:                 InvokeStaticOrDirect intrinsic:ArraysFillChar
+
+  public static void $noinline$fillChars(char[] array, char value) {
+    if (doThrow) { throw new Error(); }
+    Arrays.fill(array, value);
+  }
+
+  /// CHECK-START: void Main.$noinline$fillInts(int[], int) intrinsics_recognition (after)
+  /// CHECK:                 InvokeStaticOrDirect intrinsic:ArraysFillInt
+
+  public static void $noinline$fillInts(int[] array, int value) {
+    if (doThrow) { throw new Error(); }
+    Arrays.fill(array, value);
+  }
+
+  /// CHECK-START: void Main.$noinline$fillLongs(long[], long) intrinsics_recognition (after)
+  /// CHECK:                 InvokeStaticOrDirect intrinsic:ArraysFillLong
+
+  public static void $noinline$fillLongs(long[] array, long value) {
+    if (doThrow) { throw new Error(); }
+    Arrays.fill(array, value);
+  }
+
+  /// CHECK-START: boolean Main.$noinline$equalBytes(byte[], byte[]) intrinsics_recognition (after)
+  /// CHECK:                 InvokeStaticOrDirect intrinsic:ArraysEqualsByte
+
+  public static boolean $noinline$equalBytes(byte[] a, byte[] b) {
+    if (doThrow) { throw new Error(); }
+    return Arrays.equals(a, b);
+  }
+
+  /// CHECK-START: boolean Main.$noinline$equalShorts(short[], short[]) intrinsics_recognition (after)
+  /// CHECK:                 InvokeStaticOrDirect intrinsic:ArraysEqualsShort
+
+  public static boolean $noinline$equalShorts(short[] a, short[] b) {
+    if (doThrow) { throw new Error(); }
+    return Arrays.equals(a, b);
+  }
+
+  /// CHECK-START: boolean Main.$noinline$equalInts(int[], int[]) intrinsics_recognition (after)
+  /// CHECK:                 InvokeStaticOrDirect intrinsic:ArraysEqualsInt
+
+  public static boolean $noinline$equalInts(int[] a, int[] b) {
+    if (doThrow) { throw new Error(); }
+    return Arrays.equals(a, b);
+  }
+
+  /// CHECK-START: boolean Main.$noinline$equalLongs(long[], long[]) intrinsics_recognition (after)
+  /// CHECK:                 InvokeStaticOrDirect intrinsic:ArraysEqualsLong
+
+  public static boolean $noinline$equalLongs(long[] a, long[] b) {
+    if (doThrow) { throw new Error(); }
+    return Arrays.equals(a, b);
+  }
+
+  // The lengths cover the empty array, the tails shorter than a vector, and several vectors.
+  static final int[] LENGTHS = { 0, 1, 2, 3, 7, 8, 15, 16, 17, 31, 32, 33, 100 };
+
+  public static void testFill() {
+    for (int length : LENGTHS) {
+      byte[] bytes = new byte[length];
+      $noinline$fillBytes(bytes, (byte) -3);
+      for (byte b : bytes) {
+        assertIntEquals(-3, b);
+      }
+
+      char[] chars = new char[length];
+      $noinline$fillChars(chars, '\u1234');
+      for (char c : chars) {
+        assertIntEquals(0x1234, c);
+      }
+
+      int[] ints = new int[length];
+      $noinline$fillInts(ints, 0x12345678);
+      for (int i : ints) {
+        assertIntEquals(0x12345678, i);
+      }
+
+      long[] longs = new long[length];
+      $noinline$fillLongs(longs, 0x123456789abcdefL);
+      for (long l : longs) {
+        assertTrue(l == 0x123456789abcdefL);
+      }
+    }
+
+    try {
+      $noinline$fillInts(null, 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  public static void testEquals() {
+    for (int length : LENGTHS) {
+      byte[] bytes1 = new byte[length];
+      byte[] bytes2 = new byte[length];
+      short[] shorts1 = new short[length];
+      short[] shorts2 = new short[length];
+      int[] ints1 = new int[length];
+      int[] ints2 = new int[length];
+      long[] longs1 = new long[length];
+      long[] longs2 = new long[length];
+      for (int i = 0; i < length; i++) {
+        bytes1[i] = bytes2[i] = (byte) i;
+        shorts1[i] = shorts2[i] = (short) (i * 1000);
+        ints1[i] = ints2[i] = i * 100000;
+        longs1[i] = longs2[i] = i * 10000000000L;
+      }
+      assertTrue($noinline$equalBytes(bytes1, bytes2));
+      assertTrue($noinline$equalShorts(shorts1, shorts2));
+      assertTrue($noinline$equalInts(ints1, ints2));
+      assertTrue($noinline$equalLongs(longs1, longs2));
+
+      // A difference in any element, including the last one of a tail, is found.
+      for (int i = 0; i < length; i++) {
+        bytes2[i]++;
+        shorts2[i]++;
+        ints2[i]++;
+        longs2[i] += 1L << 40;
+        assertTrue(!$noinline$equalBytes(bytes1, bytes2));
+        assertTrue(!$noinline$equalShorts(shorts1, shorts2));
+        assertTrue(!$noinline$equalInts(ints1, ints2));
+        assertTrue(!$noinline$equalLongs(longs1, longs2));
+        bytes2[i]--;
+        shorts2[i]--;
+        ints2[i]--;
+        longs2[i] -= 1L << 40;
+      }
+
+      assertTrue(!$noinline$equalInts(ints1, new int[length + 1]));
+    }
+
+    int[] ints = new int[4];
+    assertTrue($noinline$equalInts(ints, ints));
+    assertTrue($noinline$equalInts(null, null));
+    assertTrue(!$noinline$equalInts(ints, null));
+    assertTrue(!$noinline$equalInts(null, ints));
+  }
+
+  public static void $noinline$copyBytes(byte[] src, int srcPos, byte[] dst, int dstPos, int n) {
+    if (doThrow) { throw new Error(); }
+    System.arraycopy(src, srcPos, dst, dstPos, n);
+  }
+
+  public static void $noinline$copyInts(int[] src, int srcPos, int[] dst, int dstPos, int n) {
+    if (doThrow) { throw new Error(); }
+    System.arraycopy(src, srcPos, dst, dstPos, n);
+  }
+
+  public static void $noinline$copyLongs(long[] src, int srcPos, long[] dst, int dstPos, int n) {
+    if (doThrow) { throw new Error(); }
+    System.arraycopy(src, srcPos, dst, dstPos, n);
+  }
+
+  public static void testArrayCopy() {
+    byte[] bytes = new byte[100];
+    int[] ints = new int[100];
+    long[] longs = new long[100];
+    for (int i = 0; i < 100; i++) {
+      bytes[i] = (byte) i;
+      ints[i] = i;
+      longs[i] = i + (1L << 40);
+    }
+    for (int length : LENGTHS) {
+      int pos = (100 - length) / 2;
+      byte[] bytesCopy = new byte[length + 1];
+      int[] intsCopy = new int[length + 1];
+      long[] longsCopy = new long[length + 1];
+      $noinline$copyBytes(bytes, pos, bytesCopy, 1, length);
+      $noinline$copyInts(ints, pos, intsCopy, 1, length);
+      $noinline$copyLongs(longs, pos, longsCopy, 1, length);
+      assertIntEquals(0, bytesCopy[0]);
+      assertIntEquals(0, intsCopy[0]);
+      assertTrue(longsCopy[0] == 0);
+      for (int i = 0; i < length; i++) {
+        assertIntEquals(pos + i, bytesCopy[i + 1]);
+        assertIntEquals(pos + i, intsCopy[i + 1]);
+        assertTrue(longsCopy[i + 1] == pos + i + (1L << 40));
+      }
+    }
+
+    // Copies within the same array may overlap.
+    $noinline$copyInts(ints, 0, ints, 1, 99);
+    assertIntEquals(0, ints[0]);
+    for (int i = 1; i < 100; i++) {
+      assertIntEquals(i - 1, ints[i]);
+    }
+
+    try {
+      $noinline$copyInts(ints, 90, new int[100], 0, 20);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    try {
+      $noinline$copyInts(ints, 0, new int[100], -1, 20);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    try {
+      $noinline$copyInts(ints, 0, new int[100], 0, -1);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    try {
+      $noinline$copyInts(null, 0, ints, 0, 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  public static void main(String[] args) {
+    testFill();
+    testEquals();
+    testArrayCopy();
+  }
+}
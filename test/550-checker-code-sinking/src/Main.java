@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import java.util.Arrays;
+
+public class Main {
+
+  /// CHECK-START: void Main.testArithmetic(int, int) code_sinking (before)
+  /// CHECK:                        Mul
+  /// CHECK:                        If
+  /// CHECK:                        Throw
+
+  /// CHECK-START: void Main.testArithmetic(int, int) code_sinking (after)
+  /// CHECK-NOT:                    Mul
+  /// CHECK:                        If
+  /// CHECK:      <<Mul:i\d+>>      Mul
+  /// CHECK:                        InvokeStaticOrDirect [<<Mul>>{{.*}}]
+  /// CHECK:                        Throw
+
+  public static void testArithmetic(int x, int y) {
+    int product = x * y;
+    if (x < 0) {
+      throw new Error(Integer.toString(product));
+    }
+  }
+
+  /// CHECK-START: void Main.testArrayStore(int) code_sinking (before)
+  /// CHECK:      <<Array:l\d+>>    NewArray
+  /// CHECK:                        ArraySet [<<Array>>,{{i\d+}},{{i\d+}}]
+  /// CHECK:                        If
+  /// CHECK:                        Throw
+
+  /// CHECK-START: void Main.testArrayStore(int) code_sinking (after)
+  /// CHECK-NOT:                    NewArray
+  /// CHECK:                        If
+  /// CHECK:      <<Array:l\d+>>    NewArray
+  /// CHECK:                        ArraySet [<<Array>>,{{i\d+}},{{i\d+}}]
+  /// CHECK:                        Throw
+
+  /// CHECK-START: void Main.testArrayStore(int) code_sinking (after)
+  /// CHECK-NOT:                    ArraySet
+  /// CHECK:                        If
+
+  public static void testArrayStore(int x) {
+    int[] array = new int[1];
+    array[0] = x;
+    if (doThrow) {
+      throw new Error(Arrays.toString(array));
+    }
+  }
+
+  /// CHECK-START: int Main.testUsedOnBothPaths(int, int) code_sinking (after)
+  /// CHECK:                        Mul
+  /// CHECK:                        If
+  /// CHECK:                        Throw
+
+  public static int testUsedOnBothPaths(int x, int y) {
+    int product = x * y;
+    if (x < 0) {
+      throw new Error(Integer.toString(product));
+    }
+    return product;
+  }
+
+  /// CHECK-START: void Main.testEscapingAllocation(int) code_sinking (after)
+  /// CHECK:                        NewArray
+  /// CHECK:                        StaticFieldSet
+  /// CHECK:                        If
+  /// CHECK:                        Throw
+
+  public static void testEscapingAllocation(int x) {
+    int[] array = new int[] { x };
+    escape = array;
+    if (doThrow) {
+      throw new Error(Arrays.toString(array));
+    }
+  }
+
+  public static void expectThrows(Runnable runnable, String message) {
+    try {
+      runnable.run();
+    } catch (Error e) {
+      if (!message.equals(e.getMessage())) {
+        throw new Error("Expected " + message + ", got " + e.getMessage());
+      }
+      return;
+    }
+    throw new Error("Expected an Error with " + message);
+  }
+
+  public static void main(String[] args) {
+    testArithmetic(2, 3);
+    testArrayStore(4);
+    testEscapingAllocation(5);
+    if (testUsedOnBothPaths(2, 3) != 6) {
+      throw new Error("testUsedOnBothPaths");
+    }
+    if (((int[]) escape)[0] != 5) {
+      throw new Error("testEscapingAllocation");
+    }
+
+    expectThrows(new Runnable() {
+      public void run() { testArithmetic(-2, 3); }
+    }, "-6");
+    expectThrows(new Runnable() {
+      public void run() { testUsedOnBothPaths(-4, 3); }
+    }, "-12");
+    doThrow = true;
+    expectThrows(new Runnable() {
+      public void run() { testArrayStore(4); }
+    }, "[4]");
+    expectThrows(new Runnable() {
+      public void run() { testEscapingAllocation(7); }
+    }, "[7]");
+  }
+
+  static boolean doThrow = false;
+  static Object escape;
+}
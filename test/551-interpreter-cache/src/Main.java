@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+interface Shape {
+  int sides();
+}
+
+class Base {
+  int value;
+  long wide;
+  Object ref;
+
+  int get() {
+    return 1;
+  }
+}
+
+class Derived extends Base implements Shape {
+  int extra;
+
+  int get() {
+    return 2;
+  }
+
+  public int sides() {
+    return 3;
+  }
+}
+
+class Square implements Shape {
+  public int sides() {
+    return 4;
+  }
+}
+
+class Line implements Shape {
+  public int sides() {
+    return 1;
+  }
+}
+
+public class Main {
+  public static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void assertLongEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void assertObjectEquals(Object expected, Object result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  // The same iget and iput instructions run on a Base and a Derived, which share the offsets.
+  static int fields(Base b, int v) {
+    b.value = v;
+    b.wide = (long) v << 32;
+    b.ref = b;
+    assertObjectEquals(b, b.ref);
+    assertLongEquals((long) v << 32, b.wide);
+    return b.value;
+  }
+
+  static int callVirtual(Base b) {
+    return b.get();
+  }
+
+  static int callInterface(Shape s) {
+    return s.sides();
+  }
+
+  public static void main(String[] args) {
+    Base base = new Base();
+    Derived derived = new Derived();
+    for (int i = 0; i < 100; i++) {
+      assertIntEquals(i, fields((i & 1) == 0 ? base : derived, i));
+    }
+    try {
+      fields(null, 0);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+
+    // The vtable index is cached, the target still depends on the receiver.
+    for (int i = 0; i < 100; i++) {
+      assertIntEquals((i & 1) == 0 ? 1 : 2, callVirtual((i & 1) == 0 ? base : derived));
+    }
+    try {
+      callVirtual(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+
+    // Monomorphic, then a change of receiver class at every call.
+    Shape[] shapes = { derived, new Square(), new Line() };
+    for (int i = 0; i < 50; i++) {
+      assertIntEquals(4, callInterface(shapes[1]));
+    }
+    for (int i = 0; i < 99; i++) {
+      Shape s = shapes[i % 3];
+      assertIntEquals(s == derived ? 3 : (s instanceof Square ? 4 : 1), callInterface(s));
+    }
+    try {
+      callInterface(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    System.out.println("passed");
+  }
+}
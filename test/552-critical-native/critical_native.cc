@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+namespace art {
+
+// Critical natives get neither a JNIEnv* nor a jclass, only their own arguments.
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_nativeConstant() {
+  return 42;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_nativeAdd(jint a, jint b) {
+  return static_cast<jint>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_Main_nativeAddLong(jlong a, jlong b) {
+  return a + b;
+}
+
+extern "C" JNIEXPORT jdouble JNICALL Java_Main_nativeMulDouble(jdouble a, jfloat b) {
+  return a * b;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_nativeIsOdd(jint a) {
+  return (a & 1) != 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jbyte JNICALL Java_Main_nativeToByte(jint a) {
+  return static_cast<jbyte>(a);
+}
+
+extern "C" JNIEXPORT jdouble JNICALL Java_Main_nativeSum(
+    jint i1, jlong l2, jfloat f3, jdouble d4, jint i5, jlong l6,
+    jfloat f7, jdouble d8, jint i9, jlong l10, jfloat f11, jdouble d12,
+    jint i13, jlong l14, jfloat f15, jdouble d16, jint i17, jlong l18) {
+  return i1 + l2 + f3 + d4 + i5 + l6 + f7 + d8 + i9 + l10 + f11 + d12 +
+      i13 + l14 + f15 + d16 + i17 + l18;
+}
+
+static jint registeredSub(jint a, jint b) {
+  return a - b;
+}
+
+static JNINativeMethod gMethods[] = {
+    { "registeredSub", "(II)I", reinterpret_cast<void*>(registeredSub) }
+};
+
+extern "C" JNIEXPORT void JNICALL Java_Main_registerCriticalNatives(JNIEnv* env, jclass klass) {
+  env->RegisterNatives(klass, gMethods, 1);
+}
+
+}  // namespace art
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.annotation.optimization.CriticalNative;
+
+public class Main {
+  public static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void assertLongEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void assertDoubleEquals(double expected, double result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  @CriticalNative
+  static native int nativeConstant();
+
+  @CriticalNative
+  static native int nativeAdd(int a, int b);
+
+  @CriticalNative
+  static native long nativeAddLong(long a, long b);
+
+  @CriticalNative
+  static native double nativeMulDouble(double a, float b);
+
+  @CriticalNative
+  static native boolean nativeIsOdd(int a);
+
+  @CriticalNative
+  static native byte nativeToByte(int a);
+
+  // More arguments than argument registers, so some are passed on the stack.
+  @CriticalNative
+  static native double nativeSum(int i1, long l2, float f3, double d4, int i5, long l6,
+                                 float f7, double d8, int i9, long l10, float f11, double d12,
+                                 int i13, long l14, float f15, double d16, int i17, long l18);
+
+  // Registered through RegisterNatives instead of being looked up.
+  @CriticalNative
+  static native int registeredSub(int a, int b);
+
+  // Has no native code, the lookup throws.
+  @CriticalNative
+  static native int missing();
+
+  static native void registerCriticalNatives();
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    registerCriticalNatives();
+
+    // Call each method more than once: the first call goes through the lookup stub.
+    for (int i = 0; i < 2; i++) {
+      assertIntEquals(42, nativeConstant());
+      assertIntEquals(3, nativeAdd(1, 2));
+      assertIntEquals(Integer.MIN_VALUE, nativeAdd(Integer.MAX_VALUE, 1));
+      assertLongEquals(0x100000000L, nativeAddLong(0xffffffffL, 1L));
+      assertDoubleEquals(3.0, nativeMulDouble(1.5, 2.0f));
+      assertIntEquals(1, nativeIsOdd(7) ? 1 : 0);
+      assertIntEquals(0, nativeIsOdd(8) ? 1 : 0);
+      assertIntEquals(-1, nativeToByte(0x1ff));
+      assertDoubleEquals(171.0, nativeSum(1, 2L, 3f, 4.0, 5, 6L, 7f, 8.0, 9, 10L, 11f, 12.0,
+                                          13, 14L, 15f, 16.0, 17, 18L));
+      assertIntEquals(-1, registeredSub(1, 2));
+      try {
+        missing();
+        throw new Error("Expected UnsatisfiedLinkError");
+      } catch (UnsatisfiedLinkError expected) {
+      }
+    }
+    System.out.println("passed");
+  }
+}
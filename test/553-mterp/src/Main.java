@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The loops run in mterp, which single-steps the invokes, field accesses, allocations,
+// switches, floating-point operations, monitors and exceptions with the C++ interpreter and
+// then resumes at the next instruction.
+public class Main {
+  int intField;
+  long longField;
+  static int staticField;
+
+  public static void assertIntEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void assertLongEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  static int identity(int x) {
+    return x;
+  }
+
+  static int invokes(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += (i * 3) ^ (i >> 1);
+      sum += identity(i);
+    }
+    return sum;
+  }
+
+  static long fields(int n) {
+    Main m = new Main();
+    for (int i = 0; i < n; i++) {
+      m.intField += i;
+      m.longField += (long) i * i;
+      staticField += 2;
+    }
+    return m.intField + m.longField + staticField;
+  }
+
+  static long floatingPoint(int n) {
+    double d = 0;
+    float f = 0;
+    for (int i = 0; i < n; i++) {
+      d += i * 0.5;
+      f += i;
+    }
+    return (long) (d * 2) + (long) f + (f > d ? 1 : 0);
+  }
+
+  static int conversions() {
+    return (int) 3.9 + (int) (long) -2.5f + (int) (double) 7;
+  }
+
+  static int switches(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      switch (i % 4) {
+        case 0: sum += 1; break;
+        case 1: sum += 10; break;
+        case 2: sum += 100; break;
+        default: sum += 1000; break;
+      }
+      switch (i) {
+        case 7: sum += 7000; break;
+        case 70: sum += 70000; break;
+        case 700: sum += 700000; break;
+      }
+    }
+    return sum;
+  }
+
+  // The division throws from the C++ interpreter, to a handler in the same method.
+  static int divisions(int[] divisors) {
+    int sum = 0;
+    for (int i = 0; i < divisors.length; i++) {
+      try {
+        sum += 100 / divisors[i];
+      } catch (ArithmeticException e) {
+        sum -= 1;
+      }
+    }
+    return sum;
+  }
+
+  // The array accesses throw from mterp.
+  static int outOfBounds(int[] array, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      try {
+        sum += array[i];
+      } catch (ArrayIndexOutOfBoundsException e) {
+        sum += 1000;
+      }
+    }
+    int[] none = null;
+    try {
+      sum += none[0];
+    } catch (NullPointerException e) {
+      sum += 1;
+    }
+    return sum;
+  }
+
+  static int thrower(int x) {
+    if (x == 3) {
+      throw new IllegalStateException();
+    }
+    return x;
+  }
+
+  static int exceptionsFromCallee(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      try {
+        sum += thrower(i);
+      } catch (IllegalStateException e) {
+        sum += 100;
+      }
+    }
+    return sum;
+  }
+
+  static int objects(int n) {
+    Object[] array = new Object[n];
+    for (int i = 0; i < n; i++) {
+      array[i] = (i % 3 == 0) ? (Object) "three" : (Object) Integer.valueOf(i);
+    }
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      Object o = array[i];
+      if (o instanceof String) {
+        sum += ((String) o).length();
+      } else {
+        sum += (Integer) o;
+      }
+    }
+    return sum;
+  }
+
+  static int monitors(int n) {
+    Object lock = new Object();
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      synchronized (lock) {
+        sum += i;
+      }
+    }
+    return sum;
+  }
+
+  static long longShifts(long x, int n) {
+    for (int i = 0; i < n; i++) {
+      x = (x << 3) ^ (x >>> 5) ^ (x >> 7) ^ i;
+    }
+    return x;
+  }
+
+  static long arrayData() {
+    int[] ints = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    long[] longs = { 1L << 40, -1L };
+    int sum = 0;
+    for (int i = 0; i < ints.length; i++) {
+      sum += ints[i];
+    }
+    return sum + longs[0] + longs[1];
+  }
+
+  static int compareLongs(long a, long b) {
+    return a < b ? -1 : (a == b ? 0 : 1);
+  }
+
+  static int fib(int n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+  }
+
+  public static void main(String[] args) {
+    assertIntEquals(2008496, invokes(1000));
+    assertLongEquals(333335000L, fields(1000));
+    assertLongEquals(9901L, floatingPoint(100));
+    assertIntEquals(8, conversions());
+    assertIntEquals(104775, switches(100));
+    assertIntEquals(149, divisions(new int[] { 1, 2, 0, 5, 0, -3, 7 }));
+    assertIntEquals(2007, outOfBounds(new int[] { 1, 2, 3 }, 5));
+    assertIntEquals(112, exceptionsFromCallee(6));
+    assertIntEquals(47, objects(10));
+    assertIntEquals(4950, monitors(100));
+    assertLongEquals(-1174339176505342208L, longShifts(0x123456789ABCDEF0L, 10));
+    assertLongEquals(1099511627811L, arrayData());
+    assertIntEquals(-1, compareLongs(1L, 2L));
+    assertIntEquals(0, compareLongs(-5L, -5L));
+    assertIntEquals(1, compareLongs(Long.MAX_VALUE, Long.MIN_VALUE));
+    assertIntEquals(6765, fib(20));
+    System.out.println("passed");
+  }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class Main {
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    Method unused = Main.class.getDeclaredMethod("unused", int.class);
+    Method onStack = Main.class.getDeclaredMethod("onStack", Method.class, Method.class);
+    if (ensureJitCompiled(unused) && ensureJitCompiled(onStack)) {
+      onStack(unused, onStack);
+      // Once its frame is gone, the code of onStack is evicted too.
+      collectJitCodeCache();
+      assertFalse(isJitCompiled(onStack), "onStack was not evicted");
+      // The room of the evicted code is available again.
+      assertTrue(ensureJitCompiled(unused), "unused could not be compiled again");
+    }
+    System.out.println("passed");
+  }
+
+  static int unused(int x) {
+    return x * 31 + 7;
+  }
+
+  static void onStack(Method unused, Method self) {
+    collectJitCodeCache();
+    assertFalse(isJitCompiled(unused), "unused was not evicted");
+    // Configurations that force the interpreter do not run the compiled code.
+    if (!isInterpreted()) {
+      assertTrue(isJitCompiled(self), "onStack was evicted while running");
+    }
+  }
+
+  static void assertTrue(boolean value, String message) {
+    if (!value) {
+      throw new Error(message);
+    }
+  }
+
+  static void assertFalse(boolean value, String message) {
+    assertTrue(!value, message);
+  }
+
+  static native boolean ensureJitCompiled(Method method);
+  static native boolean isJitCompiled(Method method);
+  static native void collectJitCodeCache();
+  static native boolean isInterpreted();
+}
@@ -16,8 +16,11 @@
 
 #include "jni.h"
 
+#include "art_method-inl.h"
 #include "base/logging.h"
 #include "dex_file-inl.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
 #include "mirror/class-inl.h"
 #include "nth_caller_visitor.h"
 #include "runtime.h"
@@ -116,4 +119,48 @@ extern "C" JNIEXPORT jboolean JNICALL Java_Main_compiledWithOptimizing(JNIEnv* e
   return JNI_TRUE;
 }
 
+// public static native boolean ensureJitCompiled(java.lang.reflect.Method method);
+// Compiles the method with the JIT, using the profiling info recorded so far. Returns
+// whether the method has JIT compiled code, which is never the case without a JIT.
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_ensureJitCompiled(JNIEnv* env,
+                                                                  jclass cls ATTRIBUTE_UNUSED,
+                                                                  jobject java_method) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return JNI_FALSE;
+  }
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = ArtMethod::FromReflectedMethod(soa, java_method);
+  jit->CompileMethod(method, soa.Self());
+  return jit->GetCodeCache()->ContainsMethod(method) ? JNI_TRUE : JNI_FALSE;
+}
+
+// public static native boolean isJitCompiled(java.lang.reflect.Method method);
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isJitCompiled(JNIEnv* env,
+                                                              jclass cls ATTRIBUTE_UNUSED,
+                                                              jobject java_method) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return JNI_FALSE;
+  }
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = ArtMethod::FromReflectedMethod(soa, java_method);
+  return jit->GetCodeCache()->ContainsMethod(method) ? JNI_TRUE : JNI_FALSE;
+}
+
+// public static native void collectJitCodeCache();
+// Evicts the JIT compiled code that no thread is running.
+
+extern "C" JNIEXPORT void JNICALL Java_Main_collectJitCodeCache(JNIEnv* env,
+                                                                jclass cls ATTRIBUTE_UNUSED) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(env);
+  jit->GetCodeCache()->GarbageCollectCache(soa.Self());
+}
+
 }  // namespace art
@@ -57,6 +57,17 @@ extern "C" JNIEXPORT void JNICALL Java_Main_assertIsInterpreted(JNIEnv* env, jcl
 }
 
 
+// public static native boolean isCallerInlined();
+// Whether the caller of the native method was inlined into compiled code.
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isCallerInlined(JNIEnv* env, jclass) {
+  ScopedObjectAccess soa(env);
+  NthCallerVisitor caller(soa.Self(), 1, false);
+  caller.WalkStack();
+  CHECK(caller.caller != nullptr);
+  return caller.IsInInlinedFrame() ? JNI_TRUE : JNI_FALSE;
+}
+
 // public static native boolean isManaged();
 
 extern "C" JNIEXPORT jboolean JNICALL Java_Main_isManaged(JNIEnv* env, jclass cls) {